@@ -566,6 +566,60 @@ LOCK TABLES `hasinput` WRITE;
 /*!40000 ALTER TABLE `hasinput` ENABLE KEYS */;
 UNLOCK TABLES;
 
+--
+-- Table structure for table `lazydatacube`
+--
+
+DROP TABLE IF EXISTS `lazydatacube`;
+/*!40101 SET @saved_cs_client     = @@character_set_client */;
+/*!40101 SET character_set_client = utf8 */;
+CREATE TABLE `lazydatacube` (
+  `iddatacube` int(10) unsigned NOT NULL,
+  `idinputcube` int(10) unsigned NOT NULL,
+  PRIMARY KEY (`iddatacube`),
+  KEY `idinputcube` (`idinputcube`),
+  CONSTRAINT `iddatacube_l` FOREIGN KEY (`iddatacube`) REFERENCES `datacube` (`iddatacube`) ON DELETE CASCADE ON UPDATE CASCADE,
+  CONSTRAINT `idinputcube_l` FOREIGN KEY (`idinputcube`) REFERENCES `datacube` (`iddatacube`) ON DELETE CASCADE ON UPDATE CASCADE
+) ENGINE=InnoDB DEFAULT CHARSET=latin1;
+/*!40101 SET character_set_client = @saved_cs_client */;
+
+--
+-- Dumping data for table `lazydatacube`
+--
+
+LOCK TABLES `lazydatacube` WRITE;
+/*!40000 ALTER TABLE `lazydatacube` DISABLE KEYS */;
+/*!40000 ALTER TABLE `lazydatacube` ENABLE KEYS */;
+UNLOCK TABLES;
+
+--
+-- Table structure for table `fragmentcache`
+--
+
+DROP TABLE IF EXISTS `fragmentcache`;
+/*!40101 SET @saved_cs_client     = @@character_set_client */;
+/*!40101 SET character_set_client = utf8 */;
+CREATE TABLE `fragmentcache` (
+  `idinputfragment` int(10) unsigned NOT NULL,
+  `querykey` char(64) NOT NULL,
+  `idoutputfragment` int(10) unsigned NOT NULL,
+  `creationdate` timestamp NOT NULL DEFAULT CURRENT_TIMESTAMP,
+  PRIMARY KEY (`idinputfragment`, `querykey`),
+  KEY `idoutputfragment` (`idoutputfragment`),
+  CONSTRAINT `idinputfragment_c` FOREIGN KEY (`idinputfragment`) REFERENCES `fragment` (`idfragment`) ON DELETE CASCADE ON UPDATE CASCADE,
+  CONSTRAINT `idoutputfragment_c` FOREIGN KEY (`idoutputfragment`) REFERENCES `fragment` (`idfragment`) ON DELETE CASCADE ON UPDATE CASCADE
+) ENGINE=InnoDB DEFAULT CHARSET=latin1;
+/*!40101 SET character_set_client = @saved_cs_client */;
+
+--
+-- Dumping data for table `fragmentcache`
+--
+
+LOCK TABLES `fragmentcache` WRITE;
+/*!40000 ALTER TABLE `fragmentcache` DISABLE KEYS */;
+/*!40000 ALTER TABLE `fragmentcache` ENABLE KEYS */;
+UNLOCK TABLES;
+
 --
 -- Table structure for table `partitioned`
 --
@@ -0,0 +1,61 @@
+--
+--    Ophidia Analytics Framework
+--    Copyright (C) 2012-2024 CMCC Foundation
+--
+--    This program is free software: you can redistribute it and/or modify
+--    it under the terms of the GNU General Public License as published by
+--    the Free Software Foundation, either version 3 of the License, or
+--    (at your option) any later version.
+--
+--    This program is distributed in the hope that it will be useful,
+--    but WITHOUT ANY WARRANTY; without even the implied warranty of
+--    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+--    GNU General Public License for more details.
+--
+--    You should have received a copy of the GNU General Public License
+--    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+--
+
+--
+-- Upgrade of an existing OphidiaDB to the schema of ophidiadb.sql
+-- Statements can be executed more than once and do not change existing data
+--
+
+/*!40101 SET @OLD_CHARACTER_SET_CLIENT=@@CHARACTER_SET_CLIENT */;
+/*!40101 SET NAMES utf8 */;
+
+--
+-- Table structure for table `lazydatacube`
+--
+
+/*!40101 SET @saved_cs_client     = @@character_set_client */;
+/*!40101 SET character_set_client = utf8 */;
+CREATE TABLE IF NOT EXISTS `lazydatacube` (
+  `iddatacube` int(10) unsigned NOT NULL,
+  `idinputcube` int(10) unsigned NOT NULL,
+  PRIMARY KEY (`iddatacube`),
+  KEY `idinputcube` (`idinputcube`),
+  CONSTRAINT `iddatacube_l` FOREIGN KEY (`iddatacube`) REFERENCES `datacube` (`iddatacube`) ON DELETE CASCADE ON UPDATE CASCADE,
+  CONSTRAINT `idinputcube_l` FOREIGN KEY (`idinputcube`) REFERENCES `datacube` (`iddatacube`) ON DELETE CASCADE ON UPDATE CASCADE
+) ENGINE=InnoDB DEFAULT CHARSET=latin1;
+/*!40101 SET character_set_client = @saved_cs_client */;
+
+--
+-- Table structure for table `fragmentcache`
+--
+
+/*!40101 SET @saved_cs_client     = @@character_set_client */;
+/*!40101 SET character_set_client = utf8 */;
+CREATE TABLE IF NOT EXISTS `fragmentcache` (
+  `idinputfragment` int(10) unsigned NOT NULL,
+  `querykey` char(64) NOT NULL,
+  `idoutputfragment` int(10) unsigned NOT NULL,
+  `creationdate` timestamp NOT NULL DEFAULT CURRENT_TIMESTAMP,
+  PRIMARY KEY (`idinputfragment`, `querykey`),
+  KEY `idoutputfragment` (`idoutputfragment`),
+  CONSTRAINT `idinputfragment_c` FOREIGN KEY (`idinputfragment`) REFERENCES `fragment` (`idfragment`) ON DELETE CASCADE ON UPDATE CASCADE,
+  CONSTRAINT `idoutputfragment_c` FOREIGN KEY (`idoutputfragment`) REFERENCES `fragment` (`idfragment`) ON DELETE CASCADE ON UPDATE CASCADE
+) ENGINE=InnoDB DEFAULT CHARSET=latin1;
+/*!40101 SET character_set_client = @saved_cs_client */;
+
+/*!40101 SET CHARACTER_SET_CLIENT=@OLD_CHARACTER_SET_CLIENT */;
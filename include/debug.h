@@ -50,6 +50,13 @@
 #define LOGGING_SERVER_PATH OPH_FRAMEWORK_IOSERVER_LOG_PATH
 #define LOGGING_SERVER_PATH_WITH_PREFIX OPH_FRAMEWORK_IOSERVER_LOG_PATH_WITH_PREFIX
 
+// Asynchronous logging: set the environment variable to "0" to write each message synchronously
+#define LOGGING_ASYNC_ENV "OPH_LOG_ASYNC"
+#define LOGGING_ASYNC_SLOTS 4096	// Size of the ring buffer (power of 2)
+#define LOGGING_ASYNC_MAX_FILES 16	// Log files kept open by the background thread
+#define LOGGING_ASYNC_INTERVAL 50	// Flush interval in ms
+#define LOGGING_ASYNC_RETRIES 8	// Attempts to queue a message in a full ring buffer before writing it synchronously
+
 #if defined(NDEBUG) && defined(__GNUC__)
 /* gcc's cpp has extensions; it allows for macros with a variable number of
    arguments. We use this extension here to preprocess pmesg away. */
@@ -64,6 +71,12 @@ void logging(int level, const char *source, long int line_number, int container_
 
 void logging_server(int level, const char *source, long int line_number, const char *server_type, const char *format, ...);
 
+/* Start a background thread writing the messages of logging() and logging_server() in batches; errors and
+   messages that cannot be queued are written synchronously */
+int logging_async_start();
+/* Write pending messages and stop the background thread */
+int logging_async_stop();
+
 void set_log_prefix(char *p);
 void set_log_backtrace(char **p);
 
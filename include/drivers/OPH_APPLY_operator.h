@@ -63,6 +63,8 @@
  * \param nthread Number of posix threads related to each MPI task
  * \param execute_error Flag set to 1 in case of error has to be handled in destroy
  * \param on_reduce Flag set to 1 in case the values of implicit dimension has to updated due to a reduction primitive
+ * \param lazy Flag set to 1 in case output fragments have to be created as views on input fragments instead of being materialized
+ * \param cache Flag set to 1 in case output fragments have to be copied from results of previous runs of the same query, when available
  */
 struct _OPH_APPLY_operator_handle {
 	ophidiadb oDB;
@@ -102,6 +104,8 @@ struct _OPH_APPLY_operator_handle {
 	unsigned int nthread;
 	short int execute_error;
 	char on_reduce;
+	char lazy;
+	char cache;
 };
 typedef struct _OPH_APPLY_operator_handle OPH_APPLY_operator_handle;
 
@@ -30,6 +30,7 @@
 #define OPH_EXPLORECUBE_GETSUBARRAY_PLUGIN "oph_get_subarray2('oph_%s','oph_%s',%s,'%s')"
 
 #define OPH_EXPLORECUBE_ISINSUBSET_PLUGIN "mysql.oph_is_in_subset(mysql.oph_id_to_index2(%s,%s),%lld,%lld,%lld)"
+#define OPH_EXPLORECUBE_BETWEEN_CLAUSE "%s BETWEEN %lld AND %lld"
 #define OPH_EXPLORECUBE_PLUGIN_COMPR "oph_get_subarray3('oph_%s', 'oph_%s', oph_uncompress('', '', %s), %s)"
 #define OPH_EXPLORECUBE_PLUGIN_COMPR2 "oph_dump('oph_%s', '', oph_get_subarray3('oph_%s', 'oph_%s', oph_uncompress('', '', %s), %s), '%s')"
 #define OPH_EXPLORECUBE_PLUGIN_COMPR3 "oph_dump('oph_%s', '', oph_uncompress('', '', %s), '%s')"
@@ -59,6 +59,7 @@
  * \param force Flag used to force file creation
  * \param misc Flag used to save file in export/misc folder
  * \param memory_size Maximum amount of memory available
+ * \param pipeline Flag set to fetch the rows of the next fragments while writing the previous ones
  * \param nc_file_path File name
  * \param is_zarr Flag set in case of Zarr output
  */
@@ -92,6 +93,7 @@ struct _OPH_EXPORTNC2_operator_handle {
 	char shuffle;
 	char deflate;
 	long long memory_size;
+	char pipeline;
 	char *nc_file_path;
 	char is_zarr;
 #ifdef OPH_ZARR
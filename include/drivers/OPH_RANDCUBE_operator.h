@@ -58,6 +58,7 @@
  * \param description Free description to be associated with output cube
  * \param id_job ID of the job related to the task
  * \param rand_algo Type of algorithm used for generating random values
+ * \param seed Seed of the random number generator (0 to choose it at run time)
  * \param execute_error Flag set to 1 in case of error has to be handled in destroy
  * \param policy Rule to select hosts where data will be distributed
  */
@@ -94,6 +95,7 @@ struct _OPH_RANDCUBE_operator_handle {
 	char *description;
 	int id_job;
 	char *rand_algo;
+	unsigned long long seed;
 	short int execute_error;
 	char policy;
 };
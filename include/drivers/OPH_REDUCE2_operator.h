@@ -56,6 +56,8 @@
  * \param ms Conventional value for missing values
  * \param nthread Number of pthreads related to each MPI task
  * \param execute_error Flag set to 1 in case of error has to be handled in destroy
+ * \param user_missing_value Flag set to 1 in case the missing value has been set by the user
+ * \param cache Flag set to 1 in case output fragments have to be copied from results of previous runs of the same reduction, when available
  */
 struct _OPH_REDUCE2_operator_handle {
 	ophidiadb oDB;
@@ -91,6 +93,7 @@ struct _OPH_REDUCE2_operator_handle {
 	unsigned int nthread;
 	short int execute_error;
 	char user_missing_value;
+	char cache;
 };
 typedef struct _OPH_REDUCE2_operator_handle OPH_REDUCE2_operator_handle;
 
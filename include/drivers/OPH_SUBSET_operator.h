@@ -26,6 +26,7 @@
 #include "oph_ioserver_library.h"
 
 #define OPH_SUBSET_ISINSUBSET_PLUGIN "mysql.oph_is_in_subset(mysql.oph_id_to_index2(%s,%s),%lld,%lld,%lld)"
+#define OPH_SUBSET_BETWEEN_CLAUSE "%s BETWEEN %lld AND %lld"
 #define OPH_SUBSET_PLUGIN_COMPR "oph_get_subarray3('oph_%s','oph_%s',oph_uncompress('','',%s),%s)"
 #define OPH_SUBSET_PLUGIN_COMPR2 "oph_compress('','',oph_get_subarray3(%s,oph_uncompress('','',%s),%s))"
 #define OPH_SUBSET_PLUGIN2 "oph_get_subarray3(%s,%s,%s)"
@@ -20,17 +20,30 @@ Retrieved from: http://en.literateprograms.org/Hash_table_(C)?oldid=19638
 
 typedef size_t hash_size;
 
+#define HASHTBL_MIN_SIZE	8
+#define HASHTBL_ARENA_SIZE	256
+
 struct hashnode_s {
 	char *key;
 	void *data;
-	struct hashnode_s *next;
+	hash_size hash;
 };
 
+/* Keys are copied into chunks released only when the table is destroyed */
+struct hashtbl_arena_s {
+	struct hashtbl_arena_s *next;
+	size_t used;
+	size_t size;
+	char buffer[];
+};
 
+/* Open addressing with linear probing: the number of slots is a power of 2 and at most half of them are used */
 typedef struct hashtbl {
 	hash_size size;
-	struct hashnode_s **nodes;
+	hash_size count;
+	struct hashnode_s *nodes;
 	hash_size (*hashfunc)(const char *);
+	struct hashtbl_arena_s *arena;
 } HASHTBL;
 
 
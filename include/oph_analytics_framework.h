@@ -28,4 +28,17 @@
  */
 int oph_af_execute_framework(char *task_string, int task_number, int task_rank);
 
+/**
+ * \brief Function to enable resident mode, used to execute several tasks in the same process: driver libraries, configuration parameters and connections to OphidiaDB and I/O servers are kept for next tasks
+ * \param resident Set to 1 to enable resident mode, 0 to disable it
+ * \return 0 if successfull, -1 otherwise
+ */
+int oph_af_set_resident_mode(char resident);
+
+/**
+ * \brief Function to release the resources kept in resident mode and disable it
+ * \return 0 if successfull, -1 otherwise
+ */
+int oph_af_release_resident_env();
+
 #endif				//__OPH_ANALYTICS_FRAMEWORK_H
@@ -36,6 +36,10 @@
 #define OPH_ANALYTICS_OPERATOR_TASK_REDUCE_FUNC		"task_reduce"
 #define OPH_ANALYTICS_OPERATOR_TASK_DESTROY_FUNC	"task_destroy"
 #define OPH_ANALYTICS_OPERATOR_ENV_UNSET_FUNC		"env_unset"
+#define OPH_ANALYTICS_OPERATOR_POOL_CLEAR_FUNC		"oph_ioserver_pool_clear"
+#define OPH_ANALYTICS_OPERATOR_ODB_POOL_CLEAR_FUNC	"oph_odb_pool_clear"
+#define OPH_ANALYTICS_OPERATOR_ODB_CACHE_BCAST_FUNC	"oph_odb_cache_bcast"
+#define OPH_ANALYTICS_OPERATOR_ODB_CACHE_CLEAR_FUNC	"oph_odb_cache_clear"
 
 //*************Error codes***************//
 
@@ -115,4 +119,23 @@ int oph_unset_env(oph_operator_struct * handle);
 //Close dynamic library (mandatory)
 int oph_exit_task();
 
+/**
+ * \brief Function to enable resident mode, used when the framework executes several tasks in the same process: driver libraries are loaded only once and kept open with their idle connections
+ * \param resident Set to 1 to enable resident mode, 0 to disable it
+ * \return 0 if successfull, N otherwise
+ */
+int oph_set_resident_mode(char resident);
+
+/**
+ * \brief Function to check if resident mode is enabled
+ * \return 1 if resident mode is enabled, 0 otherwise
+ */
+char oph_is_resident_mode();
+
+/**
+ * \brief Function to close idle connections and driver libraries kept open in resident mode
+ * \return 0 if successfull, N otherwise
+ */
+int oph_release_operator_libraries();
+
 #endif				//__OPH_ANALYTICS_OPERATOR_H
@@ -0,0 +1,99 @@
+/*
+    Ophidia Analytics Framework
+    Copyright (C) 2012-2024 CMCC Foundation
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __OPH_COORD_INDEX_H
+#define __OPH_COORD_INDEX_H
+
+#define OPH_COORD_INDEX_SUCCESS		0
+#define OPH_COORD_INDEX_ERROR		1
+#define OPH_COORD_INDEX_BOUND_ERROR	2
+
+/**
+ * \brief Types of the coordinate arrays
+ */
+typedef enum { OPH_COORD_INDEX_BYTE, OPH_COORD_INDEX_SHORT, OPH_COORD_INDEX_INT, OPH_COORD_INDEX_LONG, OPH_COORD_INDEX_FLOAT, OPH_COORD_INDEX_DOUBLE
+} oph_coord_index_type;
+
+/**
+ * \brief Value comparable with the coordinates of an index
+ * \param l Value used with indexes of type OPH_COORD_INDEX_LONG
+ * \param d Value used with indexes of the other types
+ */
+typedef union {
+	long long l;
+	double d;
+} oph_coord_index_value;
+
+/**
+ * \brief Structure used to look up the index of a coordinate given its value
+ * \param type Type of the original coordinate array
+ * \param values Coordinate values (NULL for indexes of type OPH_COORD_INDEX_LONG)
+ * \param long_values Coordinate values of indexes of type OPH_COORD_INDEX_LONG, kept as 64-bit integers (NULL otherwise)
+ * \param size Number of coordinate values
+ * \param order 1 if values are in ascending order (first value not greater than the last one), 0 otherwise
+ * \param monotonic 1 if values are sorted according to order, 0 otherwise
+ */
+typedef struct {
+	oph_coord_index_type type;
+	double *values;
+	long long *long_values;
+	int size;
+	char order;
+	char monotonic;
+} oph_coord_index;
+
+/**
+ * \brief Function to build the index of a coordinate array
+ * \param index Pointer to the index to be filled
+ * \param type Type of the coordinate array
+ * \param array Coordinate array
+ * \param size Number of coordinate values
+ * \return 0 if successfull, non-0 otherwise
+ */
+int oph_coord_index_init(oph_coord_index * index, oph_coord_index_type type, const void *array, int size);
+
+/**
+ * \brief Function to convert a subset filter in a value comparable with the coordinates, applying the arithmetic of the type of the index
+ * \param index Pointer to the index
+ * \param value Filter value
+ * \param want_start 0 for the end of an interval, non-0 otherwise
+ * \param offset Offset to be subtracted from the start (or added to the end) of the interval
+ * \param result Pointer to be filled with the converted value
+ * \return 0 if successfull, non-0 otherwise
+ */
+int oph_coord_index_parse_value(oph_coord_index * index, const char *value, int want_start, double offset, oph_coord_index_value * result);
+
+/**
+ * \brief Function to find the index of a coordinate given its value
+ * \param index Pointer to the index
+ * \param value Value converted with oph_coord_index_parse_value
+ * \param want_start 1 for the nearest point, -1 for the start of an interval, 0 for the end of an interval
+ * \param out_of_bound Set to non-0 to fail if the value is outside the coordinate range
+ * \param coord_index Pointer to be filled with the index of the coordinate
+ * \return 0 if successfull, OPH_COORD_INDEX_BOUND_ERROR if the value is outside the coordinate range, OPH_COORD_INDEX_ERROR otherwise
+ */
+int oph_coord_index_find(oph_coord_index * index, const oph_coord_index_value * value, int want_start, char out_of_bound, int *coord_index);
+
+/**
+ * \brief Function to release the resources allocated by oph_coord_index_init
+ * \param index Pointer to the index
+ * \return 0 if successfull, non-0 otherwise
+ */
+int oph_coord_index_free(oph_coord_index * index);
+
+#endif				//__OPH_COORD_INDEX_H
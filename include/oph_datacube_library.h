@@ -72,7 +72,7 @@ int oph_dc_setup_dbms_thread(oph_ioserver_handler ** server, char *server_type);
 int oph_dc_cleanup_dbms(oph_ioserver_handler * server);
 
 /**
- * \brief Function to connect to dbms_instance. It doesn't connect to a DB. WARNING: Call this function before any other function
+ * \brief Function to connect to dbms_instance. It doesn't connect to a DB. An idle connection to the same dbms_instance is reused, if available in the connection pool. WARNING: Call this function before any other function
  * \param server Pointer to I/O server structure
  * \param m Pointer to dbms_instance to connect to
  * \param flag Value for client_flag of connection, it may be 0 if the option is unused
@@ -100,7 +100,7 @@ int oph_dc_use_db_of_dbms(oph_ioserver_handler * server, oph_odb_dbms_instance *
 int oph_dc_check_connection_to_db(oph_ioserver_handler * server, oph_odb_dbms_instance * dbms, oph_odb_db_instance * db, unsigned long flag);
 
 /** 
- * \brief Function to disconnect from dbms_instance
+ * \brief Function to disconnect from dbms_instance. The connection is given back to the connection pool
  * \param server Pointer to I/O server structure
  * \param m Pointer to dbms_instance to disconnect from
  * \return 0 if successfull, -1 otherwise
@@ -253,7 +253,7 @@ int oph_dc_create_fragment_from_query_with_aggregation2(oph_ioserver_handler * s
  * \param last_id It will contain the ID of the last row inserted
  * \param exec_query  Pointer containing intermediate query (do not set this field)
  * \param exec_args   Pointer containing intermediate args (do not set this field)
- * \return 0 if successfull, N otherwise
+ * \return 0 if successfull, N otherwise. Rows are streamed from input server in case it is different from output server
  */
 int oph_dc_append_fragment_to_fragment(oph_ioserver_handler * input_server, oph_ioserver_handler * output_server, unsigned long long tot_rows, short int exec_flag, oph_odb_fragment * new_frag,
 				       oph_odb_fragment * old_frag, long long *first_id, long long *last_id, oph_ioserver_query ** exec_query, oph_ioserver_query_arg *** exec_args);
@@ -285,9 +285,11 @@ int oph_dc_copy_and_process_fragment2(int cubes_num, oph_ioserver_handler ** ser
  * \param data_type Type of data to be inserted INT, FLOAT, DOUBLE (default DOUBLE)
  * \param compressed If the data to insert is compressed (1) or not (0)
  * \param algorithm Type of algorithm used for random number generation
+ * \param seed Seed of the generator; values of a row only depend on the seed and on the row key
  * \return 0 if successfull, N otherwise
  */
-int oph_dc_populate_fragment_with_rand_data(oph_ioserver_handler * server, oph_odb_fragment * m, unsigned long long tuple_number, int array_length, char *data_type, int compressed, char *algorithm);
+int oph_dc_populate_fragment_with_rand_data(oph_ioserver_handler * server, oph_odb_fragment * m, unsigned long long tuple_number, int array_length, char *data_type, int compressed, char *algorithm,
+					    unsigned long long seed);
 
 /** 
  * \brief Function to run query to build a table with random values
@@ -319,6 +321,24 @@ int oph_dc_populate_fragment_with_rand_data2(oph_ioserver_handler * server, oph_
 int oph_dc_read_fragment_data(oph_ioserver_handler * server, oph_odb_fragment * frag, char *data_type, int compressed, char *id_clause, char *array_clause, char *where_clause, int limit,
 			      int raw_format, oph_ioserver_result ** frag_rows);
 
+/** 
+ * \brief Function to read a physical table with filtering parameters; rows are retrieved from I/O server while they are fetched, so the number of rows is unknown
+ * and the result set has to be scanned until a row with NULL values is returned. No other query can be executed with the same server until the result set is freed
+ * \param server Pointer to I/O server structure
+ * \param frag Pointer to fragment to read
+ * \param data_type Type of data to be inserted INT, FLOAT, DOUBLE (default DOUBLE)
+ * \param compressed If the data is compressed (1) or not (0)
+ * \param id_clause Clause used to read dimension IDs
+ * \param array_clause Clause used to subset the array
+ * \param where_clause Clause used to subset rows
+ * \param limit Number of rows to be shown
+ * \param raw_format If the data is retreived in raw format not human readable (1) or not (0) 
+ * \param frag_rows Pointer to result set to fill (it has to be freed with oph_ioserver_free_result)
+ * \return 0 if successfull, N otherwise
+ */
+int oph_dc_read_fragment_data_stream(oph_ioserver_handler * server, oph_odb_fragment * frag, char *data_type, int compressed, char *id_clause, char *array_clause, char *where_clause, int limit,
+				     int raw_format, oph_ioserver_result ** frag_rows);
+
 /** 
  * \brief Function to count the number of elements in the fragment
  * \param server Pointer to I/O server structure
@@ -379,6 +399,47 @@ int oph_dc_get_fragments_size_in_bytes(oph_ioserver_handler * server, oph_odb_db
  */
 int oph_dc_delete_fragment(oph_ioserver_handler * server, oph_odb_fragment * m);
 
+/** 
+ * \brief Function to delete the view related to a fragment of a lazy datacube
+ * \param server Pointer to I/O server structure
+ * \param m Pointer to fragment to delete
+ * \return 0 if successfull, N otherwise
+ */
+int oph_dc_delete_fragment_view(oph_ioserver_handler * server, oph_odb_fragment * m);
+
+/** 
+ * \brief Function to create a new fragment of a lazy datacube, i.e. a view applying the operation query to old_frag on the fly.
+ * Nothing is written on the I/O server: any query on the new fragment is composed by the I/O server with the operation, so that a chain of lazy datacubes is evaluated in a single pass over old data
+ * \param server Pointer to I/O server structure
+ * \param old_frag Pointer to input fragment
+ * \param new_frag_name Name of new fragment to create
+ * \param operation Composition of plugins to be applied to measure
+ * \param aggregate_number Number of elements to be aggregated (NULL is admitted)
+ * \return 0 if successfull, N otherwise
+ */
+int oph_dc_create_fragment_view_from_query(oph_ioserver_handler * server, oph_odb_fragment * old_frag, char *new_frag_name, char *operation, long long *aggregate_number);
+
+/**
+ * \brief Function to create a new fragment as a copy of a fragment stored in the same database of old_frag; used to reuse results already computed
+ * \param server Pointer to I/O server structure
+ * \param old_frag Pointer to input fragment
+ * \param new_frag_name Name of new fragment to create
+ * \param source_frag_name Name of the fragment to be copied
+ * \return 0 if successfull, N otherwise
+ */
+int oph_dc_create_fragment_from_copy(oph_ioserver_handler * server, oph_odb_fragment * old_frag, char *new_frag_name, const char *source_frag_name);
+
+/**
+ * \brief Function to build the key identifying the output fragments computed by an operator with a given query and parameters
+ * \param operator_name Name of the operator
+ * \param operation Normalized query applied to each fragment
+ * \param params Binary parameters bound to the query (NULL is admitted)
+ * \param params_size Size of params in bytes
+ * \param key Pointer to the key to be allocated (to be freed)
+ * \return 0 if successfull, N otherwise
+ */
+int oph_dc_build_cache_key(const char *operator_name, const char *operation, const char *params, unsigned long long params_size, char **key);
+
 /** 
  * \brief Function to create a new fragment from old_frag applying the operation query
  * \param server Pointer to I/O server structure
@@ -50,6 +50,9 @@
 #define OPH_DIM_LONG_FLAG		OPH_COMMON_LONG_FLAG
 
 #define OPH_DIM_BUFFER_LEN 		256
+#define OPH_DIM_HASH_SIZE		64
+// Set to "yes" to compare dimension values byte by byte even if their hashes match
+#define OPH_DIM_HASH_CONFIRM_ENV	"OPH_DIM_HASH_CONFIRM"
 #define OPH_DIM_PATH_LEN 		1000
 
 #define OPH_CONF_DIMDB_NAME		"DIMDB_NAME"
@@ -65,6 +68,18 @@
 #define OPH_DIM_DATA_FORMAT_CHECK	'%'
 #define OPH_DIM_DATA_DEFAULT		"1900-01-01 00:00:00"
 
+/**
+ * \brief Structure used to store a time dimension already converted into calendar fields
+ * \param size Number of values of the dimension
+ * \param base_time Base time of the dimension in seconds
+ * \param values Calendar fields of the values; years and months are not shifted as in oph_dim_get_time_value_of
+ */
+typedef struct {
+	unsigned int size;
+	long long base_time;
+	struct tm *values;
+} oph_dim_time_index;
+
 /**
  * \brief Function to read dimension info from configuration file
  * \param db Pointer to allocated db_instance structure
@@ -143,7 +158,7 @@ int oph_dim_retrieve_dimension(oph_odb_db_instance * db, char *dimension_table_n
  * \param dim_type Type of dimension to be inserted
  * \param dim_size Length of dimension to be inserted
  * \param dim_row Binary dimension array row to be added
- * \param dimension_id Id of last inserted dimension
+ * \param dimension_id Id of last inserted dimension (or of the stored dimension with the same values)
  * \return 0 if successfull, -1 otherwise
  */
 int oph_dim_insert_into_dimension_table(oph_odb_db_instance * db, char *dimension_table_name, char *dim_type, long long dim_size, char *dim_row, int *dimension_id);
@@ -180,7 +195,7 @@ int oph_dim_compare_dimension(oph_odb_db_instance * db, char *dimension_table_na
  * \param dimension_table_name Name of new dimension table
  * \param dim_type Type of dimension to be compared
  * \param dim_size Length of dimension to be compared
- * \param apply_clause Filtering clause on the array
+ * \param apply_clause Filtering clause on the array; if it is not set, the hashes of the values are compared when available
  * \param dim_row Binary dimension array row to be compared
  * \param dimension_id ID of the dimension to be found
  * \param match Flag indicating if the output of the comparison
@@ -284,6 +299,39 @@ int oph_dim_check_data_type(char *input_type, int *size);
  */
 int oph_dim_is_in_time_group_of(char *dim_row, unsigned int kk, oph_odb_dimension * dim, char concept_level_out, struct tm *tm_prev, int midnight, int evaluate_centroid, int *res);
 
+/**
+ * \brief Function to build the index of a time dimension: base time is parsed once and all the values are converted into calendar fields
+ * \param dim_row Dimension array
+ * \param size Number of values of the dimension
+ * \param dim Dimension metadata
+ * \param index Index to be filled; it has to be freed with oph_dim_time_index_free
+ * \return 0 if successfull, N otherwise
+ */
+int oph_dim_time_index_create(char *dim_row, unsigned int size, oph_odb_dimension * dim, oph_dim_time_index * index);
+
+/**
+ * \brief Function to evaluate the reduction group for time dimensions by means of an index; it is equivalent to oph_dim_is_in_time_group_of
+ * \param index Index of the time dimension
+ * \param dim_row Dimension array used to build the index
+ * \param kk Index of dimension value to be classified
+ * \param dim Dimension metadata
+ * \param concept_level_out Frequency to be obtained
+ * \param tm_prev Pointer to an element of target group (in/out param)
+ * \param midnight Flag related to mode for edge aggregation
+ * \param evaluate_centroid If 1 then dim_row[kk] will be replaced with the centroid of standard interval which the element belongs to
+ * \param res Output flag
+ * \return 0 if successfull, N otherwise
+ */
+int oph_dim_time_index_is_in_group_of(oph_dim_time_index * index, char *dim_row, unsigned int kk, oph_odb_dimension * dim, char concept_level_out, struct tm *tm_prev, int midnight,
+				      int evaluate_centroid, int *res);
+
+/**
+ * \brief Function to free the index of a time dimension
+ * \param index Index to be freed
+ * \return 0 if successfull, N otherwise
+ */
+int oph_dim_time_index_free(oph_dim_time_index * index);
+
 /**
  * \brief Function to evaluate the centroid using mean of original values
  * \param dim_row Dimension array
@@ -24,6 +24,7 @@
 #include "oph_common.h"
 #include "oph_datacube_library.h"
 #include "oph_ioserver_library.h"
+#include "oph_coord_index_library.h"
 
 #ifndef OPH_ESDM_PREFIX
 #define OPH_ESDM_PREFIX			"esdm://"
@@ -106,6 +107,10 @@ int oph_esdm_get_dim_array(int id_container, esdm_dataset_t * dataset, int dim_i
 int oph_esdm_index_by_value(int id_container, ESDM_var * measure, int dim_id, esdm_type_t dim_type, int dim_size, char *value, int want_start, double offset, int *valorder, int *coord_index,
 			    char out_of_bound);
 
+int oph_esdm_coord_index_init(int id_container, ESDM_var * measure, int dim_id, esdm_type_t dim_type, int dim_size, oph_coord_index * index);
+
+int oph_esdm_index_by_value2(int id_container, oph_coord_index * index, char *value, int want_start, double offset, int *valorder, int *coord_index, char out_of_bound);
+
 int oph_esdm_check_subset_string(char *curfilter, int i, ESDM_var * measure, int is_index, double offset, char out_of_bound);
 
 int oph_esdm_cache_to_buffer(short int tot_dim_number, unsigned int *counters, unsigned int *limits, unsigned int *products, char *binary_cache, char *binary_insert, size_t sizeof_var);
@@ -36,6 +36,7 @@
 #define OPH_FRAMEWORK_OPERATOR_XML_FILE_PATH_DESC               "%s/etc/operators_xml/%s"
 #define OPH_FRAMEWORK_PRIMITIVE_XML_FILE_PATH_DESC              "%s/etc/primitives_xml/%s"
 #define OPH_FRAMEWORK_HIERARCHY_XML_FILE_PATH_DESC              "%s/etc/hierarchies_xml/%s"
+#define OPH_FRAMEWORK_OPERATOR_XML_CACHE_FILE_PATH              OPH_FRAMEWORK_LOG_PATH_PREFIX"/oph_operators_xml.cache"
 #define OPH_FRAMEWORK_OPERATOR_DTD_PATH     	                OPH_ANALYTICS_LOCATION"/etc/ophidia_dtd/ophidiaoperator.dtd"
 #define OPH_FRAMEWORK_PRIMITIVE_DTD_PATH     	                OPH_ANALYTICS_LOCATION"/etc/ophidia_dtd/ophidiaprimitive.dtd"
 #define OPH_FRAMEWORK_HIERARCHY_DTD_PATH     	                OPH_ANALYTICS_LOCATION"/etc/ophidia_dtd/ophidiahierarchy.dtd"
@@ -54,6 +55,7 @@
 
 #define OPH_FRAMEWORK_JSON_GENERIC_PATH				"%s/%s.json"
 #define OPH_FRAMEWORK_JSON_PATH					"%s/sessions/%s/json/response/%s.json"
+#define OPH_FRAMEWORK_TRACE_PATH				"%s/sessions/%s/json/response/%s.trace.json"
 #define OPH_FRAMEWORK_MAP_FILES_PATH				"%s/sessions/%s/export/img"OPH_SUFFIX_DATA
 #define OPH_FRAMEWORK_MISCELLANEA_FILES_PATH			"%s/sessions/%s/export/misc"
 #define OPH_FRAMEWORK_HTML_FILES_PATH				"%s/sessions/%s/export/html"OPH_SUFFIX_DATA
@@ -73,4 +75,9 @@
 #define OPH_FRAMEWORK_IOSERVER_LOG_PATH				"log/server_%s.log"
 #define OPH_FRAMEWORK_IOSERVER_LOG_PATH_WITH_PREFIX		"%s/server_%s.log"
 
+#define OPH_FRAMEWORK_DAEMON_OPTION				"-d"
+#define OPH_FRAMEWORK_DAEMON_STOP				"stop"
+#define OPH_FRAMEWORK_DAEMON_BACKLOG				16
+#define OPH_FRAMEWORK_DAEMON_RETRY_DELAY			1
+
 #endif				//__OPH_FRAMEWORK_PATHS_H
@@ -40,6 +40,21 @@
 #define OPH_IDS_HYPHEN_CHAR	'-'
 #define OPH_IDS_SEMICOLON_CHAR	';'
 
+#define OPH_IDS_SET_CAPACITY	8
+
+//Interval of consecutive IDs
+typedef struct {
+	int first;
+	int last;
+} oph_ids_interval;
+
+//Set of IDs stored as a list of intervals, in the order they have been added
+typedef struct {
+	oph_ids_interval *intervals;
+	int size;
+	int capacity;
+} oph_ids_set;
+
 //Retreive ID in string at given position 
 int oph_ids_get_id_from_string(char *string, int position, int *id);
 
@@ -55,4 +70,28 @@ int oph_ids_remove_id_from_string(char **string, int removed_id);
 //Write ID string specifying first and last id
 int oph_ids_create_new_id_string(char **string, int string_len, int first_id, int last_id);
 
+//Initialize an empty ID set
+int oph_ids_set_init(oph_ids_set * set);
+
+//Release the intervals of an ID set
+int oph_ids_set_free(oph_ids_set * set);
+
+//Append the interval first_id-last_id to an ID set, merging it with the last interval when they are adjacent
+int oph_ids_set_add(oph_ids_set * set, int first_id, int last_id);
+
+//Parse an ID string like "1-120;200-350" into a new ID set
+int oph_ids_set_parse(const char *string, oph_ids_set * set);
+
+//Write the ID string of an ID set. string is allocated and has to be freed
+int oph_ids_set_to_string(oph_ids_set * set, char **string);
+
+//Count number of IDs in an ID set
+int oph_ids_set_count(oph_ids_set * set, int *count);
+
+//Build the union of two ID sets; result is sorted and has no overlapping intervals
+int oph_ids_set_union(oph_ids_set * set1, oph_ids_set * set2, oph_ids_set * result);
+
+//Build the ID set of number IDs starting at given position
+int oph_ids_set_subset(oph_ids_set * set, int position, int number, oph_ids_set * result);
+
 #endif				//__OPH_IDSTRING_H
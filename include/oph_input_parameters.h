@@ -141,6 +141,7 @@
 #define OPH_IN_PARAM_LINK					"link"
 #define OPH_IN_PARAM_BYTE_UNIT					"byte_unit"
 #define OPH_IN_PARAM_ALGORITHM					"algorithm"
+#define OPH_IN_PARAM_SEED					"seed"
 #define OPH_IN_PARAM_MEASURE_FILTER				"measure_filter"
 #define OPH_IN_PARAM_LEVEL_FILTER				"ntransform"
 #define OPH_IN_PARAM_SRC_FILTER					"src_filter"
@@ -178,10 +179,13 @@
 #define OPH_IN_PARAM_DEPTH					"depth"
 #define OPH_IN_PARAM_REALPATH					"realpath"
 #define OPH_IN_PARAM_ON_REDUCE					"on_reduce"
+#define OPH_IN_PARAM_LAZY					"lazy"
+#define OPH_IN_PARAM_CACHE					"cache"
 #define OPH_IN_PARAM_ACTION					"action"
 #define OPH_IN_PARAM_POLICY					"policy"
 #define OPH_IN_PARAM_SHUFFLE					"shuffle"
 #define OPH_IN_PARAM_DEFLATE					"deflate"
+#define OPH_IN_PARAM_PIPELINE					"pipeline"
 #define OPH_IN_PARAM_COMMAND				"command"
 
 #define OPH_IN_PARAM_INPUT					"input"
@@ -38,13 +38,26 @@
 #define OPH_IOSERVER_CLOSE_FUNC   "_%s_close"
 #define OPH_IOSERVER_CLEANUP_FUNC     "_%s_cleanup"
 #define OPH_IOSERVER_GET_RESULT_FUNC     "_%s_get_result"
+#define OPH_IOSERVER_GET_RESULT_STREAM_FUNC     "_%s_get_result_stream"
 #define OPH_IOSERVER_FETCH_ROW_FUNC     "_%s_fetch_row"
 #define OPH_IOSERVER_FREE_RESULT_FUNC     "_%s_free_result"
+#define OPH_IOSERVER_GET_QUERY_CACHE_STATS_FUNC     "_%s_get_query_cache_stats"
+#define OPH_IOSERVER_TRANSLATE_QUERY_FUNC     "_%s_translate_query"
+#define OPH_IOSERVER_SETUP_NATIVE_QUERY_FUNC     "_%s_setup_native_query"
 
 #define OPH_IOSERVER_SEPARATOR '_'
 
 #define OPH_IOSERVER_MYSQL_TYPE		"mysql_table"
 #define OPH_IOSERVER_OPHIDIAIO_TYPE	"ophidiaio_memory"
+#define OPH_IOSERVER_EMBEDDED_TYPE	"embedded_memory"
+
+#define OPH_IOSERVER_POOL_MAX_IDLE	256
+
+#define OPH_IOSERVER_TEMPLATE_MAX_SLOTS	64
+#define OPH_IOSERVER_TEMPLATE_CONV_LEN	16
+#define OPH_IOSERVER_TEMPLATE_NUM_LEN	64
+#define OPH_IOSERVER_TEMPLATE_SLOT_BEGIN	'\001'
+#define OPH_IOSERVER_TEMPLATE_SLOT_END	'\002'
 
 //*************Error codes***************//
 
@@ -86,6 +99,8 @@
  * \param dlh             Libtool handler to dynamic library
  * \param is_thread       Flag set to non-zero if handler is used within a thread
  * \param connection      Pointer to (void) structure for server connection
+ * \param pool_entry      Pointer to the connection pool entry in case the connection has been leased from the pool
+ * \param templates       Pointer to the list of query templates compiled for the handle
  */
 struct _oph_ioserver {
 	char *server_type;
@@ -94,6 +109,8 @@ struct _oph_ioserver {
 	void *dlh;
 	char is_thread;
 	void *connection;
+	void *pool_entry;
+	void *templates;
 };
 typedef struct _oph_ioserver oph_ioserver_handler;
 
@@ -217,12 +234,24 @@ extern int (*_SERVER_free_query) (oph_ioserver_handler * handle, oph_ioserver_qu
 //Get result set from storage server
 extern int (*_SERVER_get_result) (oph_ioserver_handler * handle, void *connection, oph_ioserver_result ** result);
 
+//Get result set from storage server retrieving rows one at a time
+extern int (*_SERVER_get_result_stream) (oph_ioserver_handler * handle, void *connection, oph_ioserver_result ** result);
+
 //Fetch next row from the result set
 extern int (*_SERVER_fetch_row) (oph_ioserver_handler * handle, oph_ioserver_result * result, oph_ioserver_row ** current_row);
 
 //Free result set in the storage server
 extern int (*_SERVER_free_result) (oph_ioserver_handler * handle, oph_ioserver_result * result);
 
+//Get usage counters of the cache of prepared statements
+extern int (*_SERVER_get_query_cache_stats) (oph_ioserver_handler * handle, unsigned long long *hits, unsigned long long *misses);
+
+//Translate a submission string into the native language of the server
+extern int (*_SERVER_translate_query) (oph_ioserver_handler * handle, const char *operation, char **translated);
+
+//Setup the query structure with an operation expressed in the native language of the server
+extern int (*_SERVER_setup_native_query) (oph_ioserver_handler * handle, void *connection, const char *operation, unsigned long long tot_run, oph_ioserver_query_arg ** args, oph_ioserver_query ** query);
+
 //*****************Internal Functions (used by data access library)***************//
 
 /**
@@ -300,6 +329,16 @@ int oph_ioserver_free_query(oph_ioserver_handler * handle, oph_ioserver_query *
  */
 int oph_ioserver_get_result(oph_ioserver_handler * handle, oph_ioserver_result ** result);
 
+/**
+ * \brief		Function to initialize a result set whose rows are retrieved from the server one at a time, while they are fetched. Memory used by the client does not depend on the size of the result set,
+ *			but the number of rows and the maximum width of the fields are unknown (they are set to 0) and the result set has to be scanned until a row with NULL values is returned.
+ *			No other query can be executed with the same handle until the result set is freed. Plugins not providing a streaming mode fall back on oph_ioserver_get_result.
+ * \param handle        Dynamic server plugin handle
+ * \param result	Pointer to the result set to retrieve
+ * \return		0 if successfull, non-0 otherwise
+ */
+int oph_ioserver_get_result_stream(oph_ioserver_handler * handle, oph_ioserver_result ** result);
+
 /**
  * \brief		Function to fetch the next row in the result set
  * \param handle        Dynamic server plugin handle
@@ -317,4 +356,59 @@ int oph_ioserver_fetch_row(oph_ioserver_handler * handle, oph_ioserver_result *
  */
 int oph_ioserver_free_result(oph_ioserver_handler * handle, oph_ioserver_result * result);
 
+/**
+ * \brief		Function to get the usage counters of the cache of prepared statements kept by the plugin for its connections. Counters are set to 0 for plugins without a cache.
+ * \param handle        Dynamic server plugin handle
+ * \param hits		Pointer to the number of queries that reused a prepared statement (can be NULL)
+ * \param misses	Pointer to the number of statements prepared (can be NULL)
+ * \return		0 if successfull, non-0 otherwise
+ */
+int oph_ioserver_get_query_cache_stats(oph_ioserver_handler * handle, unsigned long long *hits, unsigned long long *misses);
+
+/**
+ * \brief               Function to setup the query structure from a submission string template. The template is a printf-like format (conversions %s, %d, %ld, %lld, %u, %f, etc.) compiled once
+ *                      for each handle: slot values are bound on each call and, for plugins able to translate the template into their native language, the translated query is filled directly
+ *                      without building and parsing the submission string again. Values that could change the structure of the query fall back on oph_ioserver_setup_query.
+ * \param handle        Dynamic server plugin handle
+ * \param format        Submission string template (it should be a string literal, since it is also used as key of the template cache)
+ * \param tot_run       Total number of runs the given operation will be executed
+ * \param args          Null-terminated array of arguments to be binded to the query (can be NULL)
+ * \param query         Pointer to query to be built
+ * \param ...           Values of the template slots
+ * \return              0 if successfull, non-0 otherwise
+ */
+int oph_ioserver_setup_query_template(oph_ioserver_handler * handle, const char *format, unsigned long long tot_run, oph_ioserver_query_arg ** args, oph_ioserver_query ** query, ...);
+
+//*****************Connection pool***************//
+
+/**
+ * \brief               Function to lease a connection to data store server from the pool of idle connections. A new connection is established in case no idle connection is available for the same server type, host, port, user and flags; the default database has to be selected after the lease.
+ * \param handle        Dynamic server plugin handle
+ * \param conn_params   Struct with connection params to server
+ * \param hit           Pointer to flag set to 1 in case an idle connection has been reused (can be NULL)
+ * \return              0 if successfull, non-0 otherwise
+ */
+int oph_ioserver_pool_lease(oph_ioserver_handler * handle, oph_ioserver_params * conn_params, char *hit);
+
+/**
+ * \brief               Function to give back to the pool the connection leased by oph_ioserver_pool_lease. The connection is closed in case it was not leased from the pool or the pool is full.
+ * \param handle        Dynamic server plugin handle
+ * \return              0 if successfull, non-0 otherwise
+ */
+int oph_ioserver_pool_return(oph_ioserver_handler * handle);
+
+/**
+ * \brief               Function to close all the idle connections of the pool and release the related resources.
+ * \return              0 if successfull, non-0 otherwise
+ */
+int oph_ioserver_pool_clear();
+
+/**
+ * \brief               Function to get pool usage counters.
+ * \param hits          Pointer to the number of leases satisfied with an idle connection (can be NULL)
+ * \param misses        Pointer to the number of leases that required a new connection (can be NULL)
+ * \return              0 if successfull, non-0 otherwise
+ */
+int oph_ioserver_pool_get_stats(unsigned long long *hits, unsigned long long *misses);
+
 #endif				//__OPH_IOSERVER_H
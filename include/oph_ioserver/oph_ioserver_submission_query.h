@@ -30,6 +30,7 @@
 #define OPH_IOSERVER_SQ_PARAM_SEPARATOR ';'
 #define OPH_IOSERVER_SQ_MULTI_VALUE_SEPARATOR '|'
 #define OPH_IOSERVER_SQ_STRING_DELIMITER '\''
+#define OPH_IOSERVER_SQ_KEYWORD_CHAR '@'
 
 //*****************Query operation***************//
 
@@ -38,7 +39,12 @@
 #define OPH_IOSERVER_SQ_OP_CREATE_FRAG_SELECT_FILE "create_frag_select_file"
 #define OPH_IOSERVER_SQ_OP_CREATE_FRAG_SELECT_ESDM "create_frag_select_esdm"
 #define OPH_IOSERVER_SQ_OP_CREATE_FRAG "create_frag"
+#define OPH_IOSERVER_SQ_OP_CREATE_FRAG_LINK "create_frag_link"
+#define OPH_IOSERVER_SQ_OP_CREATE_SERVER "create_server"
+#define OPH_IOSERVER_SQ_OP_DROP_SERVER "drop_server"
 #define OPH_IOSERVER_SQ_OP_DROP_FRAG "drop_frag"
+#define OPH_IOSERVER_SQ_OP_CREATE_FRAG_VIEW "create_frag_view"
+#define OPH_IOSERVER_SQ_OP_DROP_FRAG_VIEW "drop_frag_view"
 #define OPH_IOSERVER_SQ_OP_CREATE_DB "create_database"
 #define OPH_IOSERVER_SQ_OP_DROP_DB "drop_database"
 #define OPH_IOSERVER_SQ_OP_INSERT "insert"
@@ -87,6 +93,11 @@
 #define OPH_IOSERVER_SQ_ARG_MEASURE_TYPE	"measure_type"
 #define OPH_IOSERVER_SQ_ARG_ARRAY_LEN 	"array_len"
 #define OPH_IOSERVER_SQ_ARG_ALGORITHM 	"algorithm"
+#define OPH_IOSERVER_SQ_ARG_SERVER		"server_name"
+#define OPH_IOSERVER_SQ_ARG_HOST		"host"
+#define OPH_IOSERVER_SQ_ARG_PORT		"port"
+#define OPH_IOSERVER_SQ_ARG_USER		"user"
+#define OPH_IOSERVER_SQ_ARG_PASSWORD	"password"
 
 //*****************Query values***************//
 
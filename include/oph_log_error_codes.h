@@ -164,6 +164,7 @@
 #define OPH_LOG_GENERIC_NAME_NOT_ALLOWED_ERROR                      "%s not allowed for new folders/containers\n"
 #define OPH_LOG_GENERIC_IOPLUGIN_SETUP_ERROR						"Unable to setup I/O server plugin %d\n"
 #define OPH_LOG_GENERIC_IOPLUGIN_CLEANUP_ERROR					"Unable to cleanup I/O server plugin %d\n"
+#define OPH_LOG_GENERIC_SCHEDULER_INIT_ERROR						"Unable to initialize fragment scheduler\n"
 #define OPH_LOG_GENERIC_IOPLUGIN_FETCH_ROW_ERROR					"Unable to fetch row from I/O server\n"
 #define OPH_LOG_GENERIC_INVALID_USERROLE_ERROR					"At least \"%s\" permission is needed for this particular operation\n"
 #define OPH_LOG_GENERIC_METADATA_COPY_ERROR					"Unable to copy metadata\n"
@@ -240,6 +241,9 @@
 #define OPH_LOG_OPH_APPLY_TUPLES_CONSTRAINT_FAILED 					OPH_LOG_GENERIC_TUPLES_CONSTRAINT_FAILED
 #define OPH_LOG_OPH_APPLY_METADATA_SET_ERROR						"Metadata are corrupted.\n"
 #define OPH_LOG_OPH_APPLY_TYPE_ERROR							"Unable to found data type '%s'"
+#define OPH_LOG_OPH_APPLY_LAZY_NOT_SUPPORTED						"Lazy output is not supported %s: datacube will be materialized\n"
+#define OPH_LOG_OPH_APPLY_LAZY_INSERT_ERROR						"Unable to record lazy datacube\n"
+#define OPH_LOG_OPH_APPLY_SCHEDULER_INIT_ERROR						OPH_LOG_GENERIC_SCHEDULER_INIT_ERROR
 
 /*OPH_AGGREGATE OPERATOR LOG ERRORS*/
 #define OPH_LOG_OPH_AGGREGATE_MEMORY_ERROR_HANDLE					OPH_LOG_GENERIC_MEMORY_ERROR_HANDLE
@@ -340,6 +344,7 @@
 #define OPH_LOG_OPH_AGGREGATE2_DATACUBE_PERMISSION_ERROR			OPH_LOG_GENERIC_DATACUBE_PERMISSION_ERROR
 #define OPH_LOG_OPH_AGGREGATE2_IOPLUGIN_SETUP_ERROR						OPH_LOG_GENERIC_IOPLUGIN_SETUP_ERROR
 #define OPH_LOG_OPH_AGGREGATE2_IOPLUGIN_CLEANUP_ERROR					OPH_LOG_GENERIC_IOPLUGIN_CLEANUP_ERROR
+#define OPH_LOG_OPH_AGGREGATE2_SCHEDULER_INIT_ERROR					OPH_LOG_GENERIC_SCHEDULER_INIT_ERROR
 
 /*OPH_CONTAINERSCHEMA OPERATOR LOG ERRORS*/
 #define OPH_LOG_OPH_CONTAINERSCHEMA_MEMORY_ERROR_HANDLE					OPH_LOG_GENERIC_MEMORY_ERROR_HANDLE
@@ -362,6 +367,7 @@
 #define OPH_LOG_OPH_DELETECONTAINER_NO_INPUT_CONTAINER 					"Unknown input %s container %s.\n"
 #define OPH_LOG_OPH_DELETECONTAINER_CONTAINER_NOT_EMPTY 				"Input container isn't empty. To remove re-run setting the 'force' flag\n"
 #define OPH_LOG_OPH_DELETECONTAINER_CONTAINER_DELETE_ERROR 				"Error while deleting input container.\n"
+#define OPH_LOG_OPH_DELETECONTAINER_LAZY_DATACUBE_ERROR 				"Datacubes of input container are the input of %d lazy datacubes stored in other containers: delete or materialize them first\n"
 #define OPH_LOG_OPH_DELETECONTAINER_NULL_OPERATOR_HANDLE 				OPH_LOG_GENERIC_NULL_OPERATOR_HANDLE
 #define OPH_LOG_OPH_DELETECONTAINER_DIM_LOAD	 						OPH_LOG_GENERIC_DIM_LOAD_ERROR
 #define OPH_LOG_OPH_DELETECONTAINER_DIM_CONNECT	 						OPH_LOG_GENERIC_DIM_CONNECT_ERROR
@@ -412,6 +418,7 @@
 #define OPH_LOG_OPH_DELETE_DATACUBE_PERMISSION_ERROR				OPH_LOG_GENERIC_DATACUBE_PERMISSION_ERROR
 #define OPH_LOG_OPH_DELETE_IOPLUGIN_SETUP_ERROR						OPH_LOG_GENERIC_IOPLUGIN_SETUP_ERROR
 #define OPH_LOG_OPH_DELETE_IOPLUGIN_CLEANUP_ERROR					OPH_LOG_GENERIC_IOPLUGIN_CLEANUP_ERROR
+#define OPH_LOG_OPH_DELETE_LAZY_DATACUBE_ERROR						"Datacube %s is the input of %d lazy datacubes: delete or materialize them first\n"
 
 /*OPH_DRILLDOWN OPERATOR LOG ERRORS*/
 #define OPH_LOG_OPH_DRILLDOWN_MEMORY_ERROR_HANDLE					OPH_LOG_GENERIC_MEMORY_ERROR_HANDLE
@@ -1170,6 +1177,7 @@
 #define OPH_LOG_OPH_REDUCE2_DATACUBE_PERMISSION_ERROR			OPH_LOG_GENERIC_DATACUBE_PERMISSION_ERROR
 #define OPH_LOG_OPH_REDUCE2_IOPLUGIN_SETUP_ERROR						OPH_LOG_GENERIC_IOPLUGIN_SETUP_ERROR
 #define OPH_LOG_OPH_REDUCE2_IOPLUGIN_CLEANUP_ERROR					OPH_LOG_GENERIC_IOPLUGIN_CLEANUP_ERROR
+#define OPH_LOG_OPH_REDUCE2_SCHEDULER_INIT_ERROR					OPH_LOG_GENERIC_SCHEDULER_INIT_ERROR
 
 /*OPH_ROLLUP OPERATOR LOG ERRORS*/
 #define OPH_LOG_OPH_ROLLUP_MEMORY_ERROR_HANDLE				OPH_LOG_GENERIC_MEMORY_ERROR_HANDLE
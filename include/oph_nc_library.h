@@ -23,6 +23,7 @@
 #include "oph_common.h"
 #include "oph_datacube_library.h"
 #include "oph_ioserver_library.h"
+#include "oph_coord_index_library.h"
 
 #define OPH_FILE_PREFIX		"file://"
 #define OPH_S3_PREFIX		"s3://"
@@ -323,6 +324,31 @@ int oph_nc_get_dim_array2(int id_container, int ncid, int dim_id, const char dim
  */
 int oph_nc_index_by_value(int id_container, int ncid, int dim_id, nc_type dim_type, int dim_size, char *value, int want_start, double offset, int *order, int *coord_index, char out_of_bound);
 
+/**
+ * \brief Read the values of a coordinated variable from a NetCDF file and index them
+ * \param id_container Id of output container (used by logging function)
+ * \param ncid Id of nc file
+ * \param dim_id Id of the dimension variable to be read
+ * \param dim_type Type of variable to be read (nc_type)
+ * \param dim_size Size of the dimension to consider
+ * \param index Index to be filled; it has to be released with oph_coord_index_free
+ * \return 0 if successfull
+ */
+int oph_nc_coord_index_init(int id_container, int ncid, int dim_id, nc_type dim_type, int dim_size, oph_coord_index * index);
+
+/**
+ * \brief Retrieve the index of a coordinated variable using its value from an index built with oph_nc_coord_index_init
+ * \param id_container Id of output container (used by logging function)
+ * \param index Index of the dimension values
+ * \param value String that contains the numeric value
+ * \param want_start 1 if the value I'm searching for is the start index, 0 otherwise
+ * \param offset Added to bounds of subset intervals to extend them
+ * \param order Return value containing 1 if the order of the dimension values is ascending, 0 otherwise
+ * \param coord_index Index of the first value greater than "value"
+ * \return 0 if successfull
+ */
+int oph_nc_index_by_value2(int id_container, oph_coord_index * index, char *value, int want_start, double offset, int *order, int *coord_index, char out_of_bound);
+
 /**
  * \brief Compare nc type with c type
  * \param id_container Id of output container (used by logging function)
@@ -27,5 +27,6 @@
 #include "ophidiadb/oph_odb_cube_library.h"
 #include "ophidiadb/oph_odb_metadata_library.h"
 #include "ophidiadb/oph_odb_user_library.h"
+#include "ophidiadb/oph_odb_cache_library.h"
 
 #endif				//__OPH_OPHIDIADB_MAIN_H
@@ -0,0 +1,46 @@
+/*
+    Ophidia Analytics Framework
+    Copyright (C) 2012-2024 CMCC Foundation
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __OPH_REORDER_H__
+#define __OPH_REORDER_H__
+
+#include <stddef.h>
+
+#define OPH_REORDER_SUCCESS		0
+#define OPH_REORDER_NULL_PARAM		1
+
+// Side (in elements) of the square tiles used to transpose blocks of data
+#define OPH_REORDER_BLOCK_SIZE		32
+
+/**
+ * \brief Function to reorder a multidimensional array read from a file (cache) into the layout of a fragment (buffer).
+ * Output elements are written contiguously following the row-major order of the dimensions, while input elements are located by means of the strides in products.
+ * Only the first dimension can start from a value different from 0 (counters[0]), as in case of the explicit dimension of a data cache.
+ * Dimensions adjacent in both layouts are merged, contiguous runs are copied with memcpy and transpositions are executed by cache-blocked kernels specialized for elements of 1, 2, 4 and 8 bytes.
+ * \param tot_dim_number Number of dimensions
+ * \param counters Array with the first index of each dimension; when the function returns, each counter is set to the related limit
+ * \param limits Array with the index following the last one of each dimension
+ * \param products Array with the strides (in elements) of the dimensions in the input array
+ * \param binary_cache Input array
+ * \param binary_insert Output array
+ * \param sizeof_var Size of an element in bytes
+ * \return 0 if successfull, N otherwise
+ */
+int oph_reorder_cache_to_buffer(short int tot_dim_number, unsigned int *counters, unsigned int *limits, unsigned int *products, char *binary_cache, char *binary_insert, size_t sizeof_var);
+
+#endif				/* __OPH_REORDER_H__ */
@@ -0,0 +1,93 @@
+/*
+    Ophidia Analytics Framework
+    Copyright (C) 2012-2024 CMCC Foundation
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __OPH_SCHEDULER_H__
+#define __OPH_SCHEDULER_H__
+
+#include <pthread.h>
+
+#define OPH_SCHED_SUCCESS		0
+#define OPH_SCHED_NULL_PARAM		1
+#define OPH_SCHED_MEMORY_ERROR		2
+#define OPH_SCHED_EMPTY			3
+
+/* Values of argument "schedule" */
+#define OPH_SCHED_STATIC		0	// Static linear block distribution of fragments
+#define OPH_SCHED_DYNAMIC		1	// Static distribution among processes, work stealing among threads
+
+/**
+ * \brief Structure used to store the items assigned to a thread
+ * \param item Array of item indexes
+ * \param head Index of next item to be extracted by the owner
+ * \param tail Index following the last available item (thieves extract from here)
+ * \param mutex Mutex used to access the deque
+ */
+typedef struct {
+	int *item;
+	int head;
+	int tail;
+	pthread_mutex_t mutex;
+} oph_sched_deque;
+
+/**
+ * \brief Structure used to schedule a list of items (usually fragments) among the threads of a process
+ * \param deque Array of deques, one for each thread
+ * \param thread_number Number of threads
+ * \param item_number Total number of items to be scheduled
+ * \param capacity Size of each deque
+ * \param steal Flag set in case idle threads can steal items from other threads
+ * \param steals Number of successful steals (for statistics)
+ * \param stat_mutex Mutex used to update statistics
+ */
+typedef struct {
+	oph_sched_deque *deque;
+	int thread_number;
+	int item_number;
+	int capacity;
+	char steal;
+	int steals;
+	pthread_mutex_t stat_mutex;
+} oph_sched;
+
+/**
+ * \brief Function to initialize a scheduler for a process. Items are initially split into contiguous blocks, one for each thread, as done by static distribution.
+ * \param sched Pointer to scheduler to be initialized
+ * \param item_number Number of items to be scheduled
+ * \param thread_number Number of threads that will extract items
+ * \param steal Set to 1 to enable work stealing among threads, 0 to keep the static distribution
+ * \return 0 if successfull, N otherwise
+ */
+int oph_sched_init(oph_sched * sched, int item_number, int thread_number, char steal);
+
+/**
+ * \brief Function to extract the next item to be processed by a thread. In case the deque of the thread is empty, new items are stolen from the most loaded thread.
+ * \param sched Pointer to scheduler
+ * \param thread_id Index of the calling thread
+ * \param item Pointer to the index of the extracted item
+ * \return 0 if an item has been extracted, OPH_SCHED_EMPTY if there are no more items, N otherwise
+ */
+int oph_sched_next(oph_sched * sched, int thread_id, int *item);
+
+/**
+ * \brief Function to release scheduler resources.
+ * \param sched Pointer to scheduler
+ * \return 0 if successfull, N otherwise
+ */
+int oph_sched_free(oph_sched * sched);
+
+#endif				/* __OPH_SCHEDULER_H__ */
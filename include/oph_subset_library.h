@@ -62,6 +62,15 @@ typedef struct {
 	unsigned int number;	// Number of intervals
 } oph_subset;			// List of subsets in the form <start>:<stride>:<max>
 
+typedef struct {
+	unsigned long long *start;
+	unsigned long long *end;
+	unsigned long long number;	// Number of intervals
+	unsigned long long size;	// Size of the dimension
+	unsigned long long block_size;	// Product of the sizes of quicker dimensions
+	unsigned char *bitmap;	// One bit for each index
+} oph_subset_filter;		// Compiled subset: sorted, disjoint and non-adjacent intervals of indexes
+
 // Initialization of struct oph_subset
 int oph_subset_init(oph_subset ** subset);
 
@@ -87,6 +96,21 @@ int oph_subset_id_is_in_subset2(unsigned long long id, oph_subset * subset, unsi
 unsigned long long oph_subset_id_to_index(unsigned long long id, unsigned long long *sizes, int n);
 unsigned long long oph_subset_id_to_index2(unsigned long long id, unsigned long long block_size, unsigned long long max);
 
+// Compile an oph_subset struct over a dimension of 'size' elements, whose ids are grouped in blocks of 'block_size' elements
+int oph_subset_filter_compile(oph_subset * subset, unsigned long long size, unsigned long long block_size, oph_subset_filter * filter);
+
+// Return 1 if an index/id is in a compiled subset
+int oph_subset_filter_index_is_in(oph_subset_filter * filter, unsigned long long index);
+int oph_subset_filter_id_is_in(oph_subset_filter * filter, unsigned long long id);
+
+// Translate a compiled subset into the ranges of ids [id_start[i], id_end[i]] within the first 'max_id' ids. Arrays have to be freed
+// OPH_SUBSET_LIB_DATA_ERR is returned, without allocating the arrays, when more than 'max_number' ranges would be needed
+int oph_subset_filter_id_ranges(oph_subset_filter * filter, unsigned long long max_id, unsigned long long max_number, unsigned long long **id_start, unsigned long long **id_end,
+				unsigned long long *number);
+
+// Freeing the struct oph_subset_filter
+int oph_subset_filter_free(oph_subset_filter * filter);
+
 // Translate values to index for subset string
 int oph_subset_value_to_index(const char *in_cond, char *data, unsigned long long data_size, char *data_type, double offset, char *out_cond, oph_subset ** out_subset);
 
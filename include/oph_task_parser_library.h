@@ -32,6 +32,9 @@
 #define OPH_TP_DTD_SCHEMA			OPH_FRAMEWORK_OPERATOR_DTD_PATH
 #define OPH_TP_XML_PATH_LENGTH			OPH_COMMON_BUFFER_LEN
 #define OPH_TP_XML_OPERATOR_FILE		OPH_FRAMEWORK_OPERATOR_XML_FILE_PATH_DESC
+#define OPH_TP_XML_CACHE_FILE			OPH_FRAMEWORK_OPERATOR_XML_CACHE_FILE_PATH
+#define OPH_TP_XML_CACHE_MAGIC			"OPHTPXC2"
+#define OPH_TP_XML_CACHE_MAX_STRING		1048576
 
 #define OPH_TP_XML_FILE_FORMAT			"%s_%s_%s.xml"
 #define OPH_TP_XML_FILE_EXTENSION		"xml"
@@ -73,9 +76,12 @@ int oph_tp_retrieve_function_xml_file(const char *function_name, const char *fun
 //Look for value of param in task string
 int oph_tp_find_param_in_task_string(const char *task_string, const char *param, char *value);
 
-//Load the operator parameters from task_string and XML into the hash table
+//Load the operator parameters from task_string and XML into the hash table; XML documents are parsed once and their arguments are cached in memory and in OPH_TP_XML_CACHE_FILE
 int oph_tp_task_params_parser(char *task_string, HASHTBL ** hashtbl);
 
+//Release the cache of operator arguments
+int oph_tp_clear_cache();
+
 //Split multiple values params into a value_list of size value_num
 int oph_tp_parse_multiple_value_param(char *values, char ***value_list, int *value_num);
 
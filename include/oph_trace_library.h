@@ -0,0 +1,114 @@
+/*
+    Ophidia Analytics Framework
+    Copyright (C) 2012-2024 CMCC Foundation
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __OPH_TRACE_H__
+#define __OPH_TRACE_H__
+
+#include <mpi.h>
+
+#define OPH_TRACE_SUCCESS		0
+#define OPH_TRACE_NULL_PARAM		1
+#define OPH_TRACE_MEMORY_ERROR		2
+#define OPH_TRACE_IO_ERROR		3
+#define OPH_TRACE_MPI_ERROR		4
+
+// Environment variable used to enable tracing: "1" saves the trace next to the JSON response of the task, any other value (except "0") is the path of the trace file
+#define OPH_TRACE_ENV			"OPH_TRACE"
+#define OPH_TRACE_ENV_DEFAULT		"1"
+
+#define OPH_TRACE_CATEGORY_PHASE	"phase"
+#define OPH_TRACE_CATEGORY_QUERY	"query"
+
+// Maximum size (in bytes) of the events recorded by a process for a task; further events are dropped
+#define OPH_TRACE_MAX_BUFFER		67108864
+#define OPH_TRACE_MIN_BUFFER		65536
+#define OPH_TRACE_EVENT_LEN		512
+
+/**
+ * \brief Structure used to measure a span
+ * \param start Start time in microseconds (0 if tracing is disabled)
+ */
+typedef struct {
+	double start;
+} oph_trace_span;
+
+/**
+ * \brief Optional attributes of a span (use -1 or NULL for missing values)
+ * \param fragment_id Identifier of the fragment
+ * \param host Host of the I/O server
+ * \param query Text of the query (only its hash is saved)
+ * \param rows Number of rows
+ * \param bytes Number of bytes moved
+ */
+typedef struct {
+	long long fragment_id;
+	const char *host;
+	const char *query;
+	long long rows;
+	long long bytes;
+} oph_trace_args;
+
+/**
+ * \brief Function to enable or disable tracing for the next task based on OPH_TRACE_ENV, as set for the first process. Events recorded for previous tasks are dropped. It is a collective call.
+ * \param comm MPI communicator
+ * \return 0 if successfull, N otherwise
+ */
+int oph_trace_init(MPI_Comm comm);
+
+/**
+ * \brief Function to check if tracing is enabled
+ * \return 1 if tracing is enabled, 0 otherwise
+ */
+char oph_trace_is_enabled();
+
+/**
+ * \brief Function to get the path of the trace file set by the user
+ * \return The path or NULL in case the trace has to be saved in the default location
+ */
+const char *oph_trace_get_path();
+
+/**
+ * \brief Function to start a span
+ * \param span Pointer to the span
+ */
+void oph_trace_begin(oph_trace_span * span);
+
+/**
+ * \brief Function to close a span and record it for the calling thread. It is thread-safe.
+ * \param span Pointer to the span
+ * \param category Category of the span (OPH_TRACE_CATEGORY_*)
+ * \param name Name of the span
+ * \param args Optional attributes of the span (can be NULL)
+ */
+void oph_trace_end(oph_trace_span * span, const char *category, const char *name, oph_trace_args * args);
+
+/**
+ * \brief Function to gather the events recorded by all the processes and save them in Chrome trace (Perfetto) JSON format. It is a collective call.
+ * \param filename Path of the trace file (only significant for the first process)
+ * \param comm MPI communicator
+ * \return 0 if successfull, N otherwise
+ */
+int oph_trace_write(const char *filename, MPI_Comm comm);
+
+/**
+ * \brief Function to drop recorded events
+ * \return 0 if successfull, N otherwise
+ */
+int oph_trace_free();
+
+#endif				/* __OPH_TRACE_H__ */
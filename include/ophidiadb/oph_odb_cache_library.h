@@ -0,0 +1,94 @@
+/*
+    Ophidia Analytics Framework
+    Copyright (C) 2012-2024 CMCC Foundation
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __OPH_ODB_CACHE_LIBRARY__
+#define __OPH_ODB_CACHE_LIBRARY__
+
+#include <stddef.h>
+#include <mpi.h>
+
+/* Project headers */
+#include "oph_ophidiadb_library.h"
+
+// Set to "no" to read metadata from OphidiaDB at each request
+#define OPH_ODB_CACHE_ENV "OPH_ODB_CACHE"
+#define OPH_ODB_CACHE_BUCKETS 256
+#define OPH_ODB_CACHE_ROOT 0
+#define OPH_ODB_CACHE_BCAST_MAX_SIZE 67108864
+
+/**
+ * \brief Types of the objects stored in the metadata cache
+ */
+typedef enum { OPH_ODB_CACHE_DATACUBE, OPH_ODB_CACHE_DATACUBE_ORDERED, OPH_ODB_CACHE_CUBEHASDIM, OPH_ODB_CACHE_DIMENSION, OPH_ODB_CACHE_DIMENSION_INSTANCE,
+	OPH_ODB_CACHE_FOLDER_PATH
+} oph_odb_cache_type;
+
+/**
+ * \brief Function to copy a fixed-size object from the metadata cache
+ * \param type Type of the object
+ * \param id Id of the object
+ * \param id_datacube Id of the datacube the object has been read for (0 if not relevant)
+ * \param data Pointer to the buffer to be filled
+ * \param size Size of the buffer; it has to match the size of the cached object
+ * \return 0 if the object is cached, OPH_ODB_NO_ROW_FOUND otherwise
+ */
+int oph_odb_cache_get(oph_odb_cache_type type, int id, int id_datacube, void *data, size_t size);
+
+/**
+ * \brief Function to copy a variable-size object from the metadata cache
+ * \param type Type of the object
+ * \param id Id of the object
+ * \param id_datacube Id of the datacube the object has been read for (0 if not relevant)
+ * \param data Pointer to be filled with a copy of the object (it has to be freed)
+ * \param size Pointer to be filled with the size of the object
+ * \return 0 if the object is cached, OPH_ODB_NO_ROW_FOUND otherwise
+ */
+int oph_odb_cache_get_alloc(oph_odb_cache_type type, int id, int id_datacube, char **data, size_t *size);
+
+/**
+ * \brief Function to store (or replace) an object in the metadata cache
+ * \param type Type of the object
+ * \param id Id of the object
+ * \param id_datacube Id of the datacube the object has been read for (0 if not relevant)
+ * \param data Pointer to the object
+ * \param size Size of the object
+ * \return 0 if successfull, non-0 otherwise
+ */
+int oph_odb_cache_put(oph_odb_cache_type type, int id, int id_datacube, const void *data, size_t size);
+
+/**
+ * \brief Function to drop all the cached objects; it has to be called whenever OphidiaDB is updated
+ * \return 0 if successfull, non-0 otherwise
+ */
+int oph_odb_cache_invalidate();
+
+/**
+ * \brief Function to release the metadata cache at the end of a task
+ * \return 0 if successfull, non-0 otherwise
+ */
+int oph_odb_cache_clear();
+
+/**
+ * \brief Collective function that sends the objects cached by the root process to the other processes of a communicator
+ * \param comm MPI communicator
+ * \param status Result of task initialization in the calling process: nothing is sent if it failed in any process
+ * \return 0 if successfull, non-0 otherwise
+ */
+int oph_odb_cache_bcast(MPI_Comm comm, int status);
+
+#endif				/* __OPH_ODB_CACHE_LIBRARY__ */
@@ -312,6 +312,15 @@ int oph_odb_cube_retrieve_datacube_measure(ophidiadb * oDB, int id_datacube, cha
  */
 int oph_odb_cube_insert_into_cubehasdim_table(ophidiadb * oDB, oph_odb_cubehasdim * cubedim, int *last_insertd_id);
 
+/**
+ * \brief Function that updates OphidiaDB adding multiple cubehasdim relations with a single statement. The identifiers of the relations are set
+ * \param oDB Pointer to OphidiaDB
+ * \param cubedim Array of relations to be added
+ * \param cubedim_num Number of relations
+ * \return 0 if successfull, -1 otherwise
+ */
+int oph_odb_cube_insert_into_cubehasdim_table2(ophidiadb * oDB, oph_odb_cubehasdim * cubedim, int cubedim_num);
+
 /**
  * \brief Function that updates OphidiaDB adding the new datacube and new partition relations
  * \param oDB Pointer to OphidiaDB
@@ -353,4 +362,41 @@ int oph_odb_cube_update_missingvalue(ophidiadb * oDB, int id_datacube, int idmis
 
 int oph_odb_cube_retrieve_missingvalue(ophidiadb * oDB, int id_datacube, int *idmissingvalue, char *measure);
 
+/**
+ * \brief Function to record that a datacube is lazy, i.e. its fragments are views computed on the fly from the fragments of the input datacube
+ * \param oDB Pointer to OphidiaDB
+ * \param id_datacube ID of the lazy datacube
+ * \param id_input ID of the input datacube
+ * \return 0 if successfull, -1 otherwise
+ */
+int oph_odb_cube_insert_into_lazydatacube_table(ophidiadb * oDB, int id_datacube, int id_input);
+
+/**
+ * \brief Function to check if a datacube is lazy
+ * \param oDB Pointer to OphidiaDB
+ * \param id_datacube ID of the datacube
+ * \param lazy Pointer to flag set to 1 in case the datacube is lazy, 0 otherwise
+ * \return 0 if successfull, -1 otherwise
+ */
+int oph_odb_cube_is_lazy(ophidiadb * oDB, int id_datacube, int *lazy);
+
+/**
+ * \brief Function to count the lazy datacubes that depend on a datacube or on the datacubes of a container (excluding those in the container itself)
+ * \param oDB Pointer to OphidiaDB
+ * \param id_datacube ID of the input datacube or 0 to count the dependencies of a container
+ * \param id_container ID of the container (used only if id_datacube is 0)
+ * \param number Pointer to the number of lazy datacubes
+ * \return 0 if successfull, -1 otherwise
+ */
+int oph_odb_cube_count_lazy_datacubes(ophidiadb * oDB, int id_datacube, int id_container, int *number);
+
+/**
+ * \brief Function to check if all the I/O servers storing a datacube can host lazy datacubes
+ * \param oDB Pointer to OphidiaDB
+ * \param id_datacube ID of the datacube
+ * \param supported Pointer to flag set to 1 in case lazy datacubes are supported, 0 otherwise
+ * \return 0 if successfull, -1 otherwise
+ */
+int oph_odb_cube_check_lazy_support(ophidiadb * oDB, int id_datacube, int *supported);
+
 #endif				/* __OPH_ODB_CUBE_H__ */
@@ -396,7 +396,7 @@ int oph_odb_stge_delete_from_dbinstance_table(ophidiadb * oDB, int id_db);
 int oph_odb_stge_insert_into_fragment_table(ophidiadb * oDB, oph_odb_fragment * fragment);
 
 /**
- * \brief Function that updates OphidiaDB adding multiple fragments specified
+ * \brief Function that updates OphidiaDB adding multiple fragments specified with multi-row statements executed in a single transaction. Fragments with id_datacube set to 0 are skipped
  * \param oDB Pointer to OphidiaDB
  * \param fragment Pointer to fragment to be added
  * \param frag_num Number of fragments to be added
@@ -404,6 +404,45 @@ int oph_odb_stge_insert_into_fragment_table(ophidiadb * oDB, oph_odb_fragment *
  */
 int oph_odb_stge_insert_into_fragment_table2(ophidiadb * oDB, oph_odb_fragment * fragment, int frag_num);
 
+/**
+ * \brief Function to retrieve the fragments previously computed by the same query on the fragments of a datacube (only outputs stored on the same db instance are returned)
+ * \param oDB Pointer to OphidiaDB
+ * \param id_datacube Id of the input datacube
+ * \param key Cache key of the query (see oph_dc_build_cache_key)
+ * \param frags Input fragment list
+ * \param cached Pointer to be filled with an array of frags->size cached fragment names (NULL entries on miss); it is left NULL if no fragment is cached
+ * \return 0 if successfull, -1 otherwise
+ */
+int oph_odb_stge_retrieve_cached_fragments(ophidiadb * oDB, int id_datacube, const char *key, oph_odb_fragment_list * frags, char ***cached);
+
+/**
+ * \brief Function to free the array filled by oph_odb_stge_retrieve_cached_fragments
+ * \param cached Array of cached fragment names
+ * \param size Length of the array
+ * \return 0 if successfull, -1 otherwise
+ */
+int oph_odb_stge_free_cached_fragments(char **cached, int size);
+
+/**
+ * \brief Function that records in OphidiaDB the output fragments computed by a query on a range of input fragments; entries are dropped along with either fragment
+ * \param oDB Pointer to OphidiaDB
+ * \param id_input_datacube Id of the input datacube
+ * \param id_output_datacube Id of the output datacube
+ * \param key Cache key of the query (see oph_dc_build_cache_key)
+ * \param first_index Relative index of the first fragment to be recorded
+ * \param last_index Relative index of the last fragment to be recorded
+ * \return 0 if successfull, -1 otherwise
+ */
+int oph_odb_stge_insert_into_fragmentcache_table(ophidiadb * oDB, int id_input_datacube, int id_output_datacube, const char *key, int first_index, int last_index);
+
+/**
+ * \brief Function to append a fragment to a batch, to be inserted into OphidiaDB with oph_odb_batch_execute (the batch is initialized if needed)
+ * \param batch Pointer to the batch
+ * \param fragment Pointer to fragment to be added
+ * \return 0 if successfull, -1 otherwise
+ */
+int oph_odb_stge_add_fragment_to_batch(oph_odb_batch * batch, oph_odb_fragment * fragment);
+
 /**
  * \brief Function to retrieve id of the container of a fragment
  * \param Pointer to OphidiaDB
@@ -483,6 +522,16 @@ int oph_odb_stge_get_number_of_datacube_for_dbs(ophidiadb * oDB, int db_num, int
  */
 int oph_odb_stge_insert_into_dbinstance_partitioned_tables(ophidiadb * oDB, oph_odb_db_instance * db, int id_datacube);
 
+/**
+ * \brief Function that updates OphidiaDB adding multiple db instances and the related partition relations in a single transaction. The identifiers of the db instances are set
+ * \param oDB Pointer to OphidiaDB
+ * \param db Array of db_instances
+ * \param db_num Number of db_instances
+ * \param id_datacube ID of related Datacube (0 if partition relations do not have to be added)
+ * \return 0 if successfull, -1 otherwise
+ */
+int oph_odb_stge_insert_into_dbinstance_partitioned_tables2(ophidiadb * oDB, oph_odb_db_instance * db, int db_num, int id_datacube);
+
 int oph_odb_stge_add_hostpartition(ophidiadb * oDB, const char *name, int id_user, char reserved, int hosts, int *id_hostpartition);
 int oph_odb_stge_add_all_hosts_to_partition(ophidiadb * oDB, int id_hostpartition, char reserved);
 int oph_odb_stge_add_some_hosts_to_partition(ophidiadb * oDB, int id_hostpartition, int host_number, char reserved, int *num_rows);
@@ -20,6 +20,7 @@
 #define __OPH_OPHIDIA_DB__
 
 /* Project headers */
+#include <stddef.h>
 #include <mysql.h>
 
 #include "oph_framework_paths.h"
@@ -50,6 +51,12 @@
 #define OPH_ODB_MAX_ATTEMPTS 5
 #define OPH_ODB_WAITING_TIME 2
 
+#define OPH_ODB_POOL_MAX_IDLE 16
+
+// Maximum size of a multi-row statement built by a batch (lower than the default max_allowed_packet of MySQL)
+#define OPH_ODB_BATCH_MAX_SIZE 1048576
+#define OPH_ODB_BATCH_MIN_SIZE 4096
+
 /**
  * \brief Structure that contain OphidiaDB parameters
  * \param name name of OphidiaDB
@@ -69,7 +76,27 @@ typedef struct {
 } ophidiadb;
 
 /**
- * \brief Function to read OphidiaDB info from configuration file
+ * \brief Structure used to collect rows to be inserted by means of multi-row statements
+ * \param statement Template of the statement, with a '%s' in place of the list of rows
+ * \param queries Statements already completed
+ * \param query_number Number of statements already completed
+ * \param rows Comma-separated list of rows of the statement under construction
+ * \param length Length of rows
+ * \param capacity Size of the memory allocated for rows
+ * \param row_number Total number of rows of the batch
+ */
+typedef struct {
+	const char *statement;
+	char **queries;
+	int query_number;
+	char *rows;
+	size_t length;
+	size_t capacity;
+	int row_number;
+} oph_odb_batch;
+
+/**
+ * \brief Function to read OphidiaDB info from configuration file. The file is parsed only once by each process, next calls get the cached values
  * \param ophidiadb Pointer to an allocated ophidiadb structure
  * \return 0 if successfull, -1 otherwise
  */
@@ -100,7 +127,7 @@ int oph_odb_free_ophidiadb(ophidiadb * oDB);
 int oph_odb_free_ophidiadb_thread(ophidiadb * oDB);
 
 /**
- * \brief Function to connect to the OphidiaDB. WARNING: Call this function before any other function or the system will crash
+ * \brief Function to connect to the OphidiaDB. An idle connection opened with the same parameters is reused, if available. WARNING: Call this function before any other function or the system will crash
  * \param structure containing OphidiaDB parameters
  * \return 0 if successfull, -1 otherwise
  */
@@ -114,12 +141,18 @@ int oph_odb_connect_to_ophidiadb(ophidiadb * oDB);
 int oph_odb_check_connection_to_ophidiadb(ophidiadb * oDB);
 
 /**
- * \brief Function to disconnect from the OphidiaDB
+ * \brief Function to disconnect from the OphidiaDB. The connection is kept idle to be reused by next connections (up to OPH_ODB_POOL_MAX_IDLE connections)
  * \param structure containig OphidiaDB parameters
  * \return 0 if successfull, -1 otherwise
  */
 int oph_odb_disconnect_from_ophidiadb(ophidiadb * oDB);
 
+/**
+ * \brief Function to close the idle connections to the OphidiaDB. Call it before mysql_library_end
+ * \return 0 if successfull, -1 otherwise
+ */
+int oph_odb_pool_clear();
+
 /**
  * \brief Function to query the OphidiaDB (retries the execution in case of lock-related issues)
  * \param structure containig OphidiaDB parameters
@@ -128,4 +161,65 @@ int oph_odb_disconnect_from_ophidiadb(ophidiadb * oDB);
  */
 int oph_odb_query_ophidiadb(ophidiadb * oDB, char *query);
 
+/**
+ * \brief Function to initialize a batch of rows
+ * \param batch Pointer to the batch
+ * \param statement Template of the multi-row statement, e.g. "INSERT INTO `table` (`a`, `b`) VALUES %s"
+ * \return 0 if successfull, N otherwise
+ */
+int oph_odb_batch_init(oph_odb_batch * batch, const char *statement);
+
+/**
+ * \brief Function to append a row to a batch. A new statement is started when the current one would exceed OPH_ODB_BATCH_MAX_SIZE
+ * \param batch Pointer to the batch
+ * \param format Format of the row, including the parentheses
+ * \return 0 if successfull, N otherwise
+ */
+int oph_odb_batch_add(oph_odb_batch * batch, const char *format, ...);
+
+/**
+ * \brief Function to run the statements of a batch within the current transaction. Rows are kept, so that the batch can be run again
+ * \param oDB Pointer to OphidiaDB
+ * \param batch Pointer to the batch
+ * \return 0 if successfull, N otherwise
+ */
+int oph_odb_batch_query(ophidiadb * oDB, oph_odb_batch * batch);
+
+/**
+ * \brief Function to run the statements of a batch within a single transaction, which is retried in case of lock-related issues
+ * \param oDB Pointer to OphidiaDB
+ * \param batch Pointer to the batch
+ * \return 0 if successfull, N otherwise
+ */
+int oph_odb_batch_execute(ophidiadb * oDB, oph_odb_batch * batch);
+
+/**
+ * \brief Function to free the memory allocated for a batch
+ * \param batch Pointer to the batch
+ * \return 0 if successfull, N otherwise
+ */
+int oph_odb_batch_free(oph_odb_batch * batch);
+
+/**
+ * \brief Function to start a transaction on OphidiaDB
+ * \param oDB Pointer to OphidiaDB
+ * \return 0 if successfull, N otherwise
+ */
+int oph_odb_start_transaction(ophidiadb * oDB);
+
+/**
+ * \brief Function to end a transaction on OphidiaDB
+ * \param oDB Pointer to OphidiaDB
+ * \param commit 1 to commit the transaction, 0 to roll it back
+ * \return 0 if successfull, N otherwise
+ */
+int oph_odb_end_transaction(ophidiadb * oDB, int commit);
+
+/**
+ * \brief Function to check if the last error of OphidiaDB is due to a lock, so that the transaction can be retried
+ * \param oDB Pointer to OphidiaDB
+ * \return 1 if the error is related to locks, 0 otherwise
+ */
+int oph_odb_is_lock_error(ophidiadb * oDB);
+
 #endif				/* __OPH_OPHIDIA_DB__ */
@@ -84,6 +84,7 @@
 #define MYSQL_QUERY_CUBE_UPDATE_OPHIDIADB_PART			"INSERT INTO `partitioned` (`iddbinstance`, `iddatacube`) VALUES (%d, %d)"
 
 #define MYSQL_QUERY_CUBE_UPDATE_OPHIDIADB_CUBEHASDIM		"INSERT INTO `cubehasdim` (`iddimensioninstance`, `iddatacube`, `explicit`, `level`) VALUES (%d, %d, %d, %d)"
+#define MYSQL_QUERY_CUBE_UPDATE_OPHIDIADB_CUBEHASDIM2		"INSERT INTO `cubehasdim` (`iddimensioninstance`, `iddatacube`, `explicit`, `level`) VALUES %s"
 #define MYSQL_QUERY_CUBE_UPDATE_LEVEL_OF_CUBEHASDIM			"UPDATE cubehasdim SET level = %d WHERE idcubehasdim = %d"
 
 #define MYSQL_QUERY_CUBE_DELETE_OPHIDIADB_CUBE			"DELETE FROM `datacube` where `iddatacube` = %d"
@@ -106,4 +107,10 @@
 #define MYSQL_QUERY_CUBE_UPDATE_OPHIDIADB_CUBE_MS		"UPDATE datacube SET idmissingvalue = %d WHERE iddatacube = %d;"
 #define MYSQL_QUERY_CUBE_RETRIEVE_OPHIDIADB_CUBE_MS		"SELECT idmissingvalue, measure FROM `datacube` WHERE iddatacube = %d;"
 
+#define MYSQL_QUERY_CUBE_UPDATE_OPHIDIADB_LAZY_CUBE		"INSERT INTO `lazydatacube` (`iddatacube`, `idinputcube`) VALUES (%d, %d);"
+#define MYSQL_QUERY_CUBE_CHECK_LAZY_CUBE			"SELECT COUNT(*) FROM `lazydatacube` WHERE iddatacube = %d;"
+#define MYSQL_QUERY_CUBE_COUNT_LAZY_CUBES			"SELECT COUNT(*) FROM `lazydatacube` WHERE idinputcube = %d;"
+#define MYSQL_QUERY_CUBE_COUNT_LAZY_CUBES_OF_CONTAINER		"SELECT COUNT(*) FROM `lazydatacube` INNER JOIN datacube AS i ON i.iddatacube = lazydatacube.idinputcube INNER JOIN datacube AS o ON o.iddatacube = lazydatacube.iddatacube WHERE i.idcontainer = %d AND o.idcontainer <> %d;"
+#define MYSQL_QUERY_CUBE_COUNT_LAZY_UNSUPPORTED_DBMS		"SELECT COUNT(*) FROM partitioned INNER JOIN dbinstance ON dbinstance.iddbinstance = partitioned.iddbinstance INNER JOIN dbmsinstance ON dbinstance.iddbmsinstance = dbmsinstance.iddbmsinstance WHERE iddatacube = %d AND dbmsinstance.ioservertype <> 'mysql_table';"
+
 #endif				/* __OPH_ODB_CUBE_QUERY_H__ */
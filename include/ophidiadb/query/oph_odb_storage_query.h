@@ -41,14 +41,19 @@
 #define MYSQL_QUERY_STGE_RETRIEVE_DB 				"SELECT dbmsinstance.iddbmsinstance, login, password, port, hostname, ioservertype, dbinstance.iddbinstance, dbname FROM dbmsinstance INNER JOIN host ON dbmsinstance.idhost=host.idhost INNER JOIN dbinstance on dbinstance.iddbmsinstance=dbmsinstance.iddbmsinstance WHERE dbinstance.iddbinstance = %d AND status = 'up';"
 #define MYSQL_QUERY_STGE_UPDATE_OPHIDIADB_FRAG 			"INSERT INTO `fragment` (`iddbinstance`, `iddatacube`, `fragrelativeindex`, `fragmentname`, `keystart`, `keyend`) VALUES (%d, %d, %d, '%s', %d, %d)"
 #define MYSQL_QUERY_STGE_UPDATE_OPHIDIADB_FRAG2 			"INSERT INTO `fragment` (`iddbinstance`, `iddatacube`, `fragrelativeindex`, `fragmentname`, `keystart`, `keyend`) VALUES %s"
+#define MYSQL_QUERY_STGE_RETRIEVE_CACHED_FRAG 			"SELECT fragmentcache.idinputfragment, output.fragmentname FROM fragmentcache INNER JOIN fragment AS input ON input.idfragment = fragmentcache.idinputfragment INNER JOIN fragment AS output ON output.idfragment = fragmentcache.idoutputfragment WHERE input.iddatacube = %d AND output.iddbinstance = input.iddbinstance AND fragmentcache.querykey = SHA2('%s', 256);"
+#define MYSQL_QUERY_STGE_UPDATE_OPHIDIADB_CACHED_FRAG 		"INSERT IGNORE INTO `fragmentcache` (`idinputfragment`, `querykey`, `idoutputfragment`) SELECT input.idfragment, SHA2('%s', 256), output.idfragment FROM fragment AS input INNER JOIN fragment AS output ON output.fragrelativeindex = input.fragrelativeindex WHERE input.iddatacube = %d AND output.iddatacube = %d AND input.fragrelativeindex >= %d AND input.fragrelativeindex <= %d;"
 #define MYSQL_QUERY_STGE_RETRIEVE_CONTAINER_FROM_FRAGMENT	 "SELECT idcontainer from fragment INNER JOIN datacube on datacube.iddatacube = fragment.iddatacube where fragmentname = '%s';"
 #define MYSQL_QUERY_STGE_UPDATE_OPHIDIADB_DB 			"INSERT INTO `dbinstance` (`iddbmsinstance`, `dbname`) VALUES (%d, '%s')"
+#define MYSQL_QUERY_STGE_UPDATE_OPHIDIADB_DB2 			"INSERT INTO `dbinstance` (`iddbmsinstance`, `dbname`) VALUES %s"
 #define MYSQL_QUERY_STGE_UPDATE_OPHIDIADB_PART 			"INSERT INTO `partitioned` (`iddbinstance`, `iddatacube`) VALUES (%d, %d)"
+#define MYSQL_QUERY_STGE_UPDATE_OPHIDIADB_PART2 			"INSERT INTO `partitioned` (`iddbinstance`, `iddatacube`) VALUES %s"
 
 #define MYSQL_QUERY_STGE_RETRIEVE_PARTITIONED_DB 		"SELECT iddbinstance from `partitioned` where iddatacube = %d"
 #define MYSQL_QUERY_STGE_RETRIEVE_PARTITIONED_DATACUBE 		"SELECT iddatacube from `partitioned` where iddbinstance = %d"
 #define MYSQL_STGE_FRAGMENT_RELATIVE_INDEX_COND1 		"fragrelativeindex = %d"
-#define MYSQL_STGE_FRAGMENT_RELATIVE_INDEX_COND2 		"fragrelativeindex >= %d AND fragrelativeindex <= %d"
+#define MYSQL_STGE_FRAGMENT_RELATIVE_INDEX_COND2 		"fragrelativeindex BETWEEN %d AND %d"
+#define MYSQL_STGE_FRAGMENT_RELATIVE_INDEX_COND3 		"fragrelativeindex IN (%s)"
 
 #define MYSQL_QUERY_STGE_RETRIEVE_HOSTPARTITION_FS      	"SELECT hostpartition.idhostpartition, COUNT(host.idhost) AS hosts, SUM(host.importcount) AS importcounts FROM hostpartition INNER JOIN hashost ON hostpartition.idhostpartition = hashost.idhostpartition INNER JOIN host ON host.idhost = hashost.idhost INNER JOIN dbmsinstance ON dbmsinstance.idhost = host.idhost WHERE status = 'up' AND ioservertype = '%s' AND (NOT reserved OR iduser = %d) GROUP BY hostpartition.idhostpartition HAVING hosts >= %d ORDER BY importcounts DESC, hosts LIMIT 1;"
 
@@ -61,6 +66,7 @@
 #define MYSQL_QUERY_STGE_RETRIEVE_FRAG_ID 			"SELECT idfragment from `fragment` where fragmentname = '%s'"
 
 #define MYSQL_QUERY_STGE_RETRIEVE_DB_ID 			"SELECT iddbinstance from `dbinstance` where dbname = '%s'"
+#define MYSQL_QUERY_STGE_RETRIEVE_DB_IDS 			"SELECT iddbinstance, dbname from `dbinstance` where dbname IN (%s)"
 
 #define MYSQL_QUERY_STGE_RETRIEVE_DATACUBEXDB_NUMBER 		"SELECT COUNT(*) FROM partitioned WHERE iddbinstance = %d;"
 #define MYSQL_QUERY_STGE_RETRIEVE_DATACUBEXDBS_NUMBER 		"SELECT COUNT(*) FROM partitioned WHERE iddbinstance IN (%s) GROUP BY iddbinstance;"
@@ -38,6 +38,13 @@
 #define OPH_DC_SQ_INSERT_SELECT_FRAG OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_OPERATION, OPH_IOSERVER_SQ_OP_INSERT_SELECT) OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FINAL_STATEMENT, OPH_IOSERVER_SQ_VAL_NO) OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FRAG, "%s") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FIELD, "id_dim|%s") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FIELD_ALIAS, "|measure") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FROM, "%s") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_WHERE, "%s")
 #define OPH_DC_SQ_INSERT_SELECT_FRAG_FINAL OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_OPERATION, OPH_IOSERVER_SQ_OP_INSERT_SELECT) OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FINAL_STATEMENT, OPH_IOSERVER_SQ_VAL_YES) OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FRAG, "%s") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FIELD, "id_dim|%s") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FIELD_ALIAS, "|measure") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FROM, "%s") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_WHERE, "%s")
 
+#define OPH_DC_SQ_INSERT_SELECT_FRAG2 OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_OPERATION, OPH_IOSERVER_SQ_OP_INSERT_SELECT) OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FINAL_STATEMENT, OPH_IOSERVER_SQ_VAL_YES) OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FRAG, "%s") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FIELD, "frag1.id_dim|%s") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FIELD_ALIAS, "id_dim|measure") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FROM, "%s") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FROM_ALIAS, "%s") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_WHERE, "%s")
+
+#define OPH_DC_SQ_CREATE_FRAG_LINK OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_OPERATION, OPH_IOSERVER_SQ_OP_CREATE_FRAG_LINK) OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FRAG, "%s") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_PATH, "%s/%s")
+#define OPH_DC_SQ_CREATE_SERVER OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_OPERATION, OPH_IOSERVER_SQ_OP_CREATE_SERVER) OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_SERVER, "%s") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_HOST, "%s") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_PORT, "%d") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_USER, "%s") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_PASSWORD, "%s") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_DB, "%s")
+#define OPH_DC_SQ_DROP_SERVER OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_OPERATION, OPH_IOSERVER_SQ_OP_DROP_SERVER) OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_SERVER, "%s")
+#define OPH_DC_SQ_CREATE_FRAG_COPY OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_OPERATION, OPH_IOSERVER_SQ_OP_CREATE_FRAG_SELECT) OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FRAG, "%s") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FIELD, "id_dim|measure") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FROM, "%s")
+
 #define OPH_DC_SQ_MULTI_INSERT_ROW "?|?|"
 #define OPH_DC_SQ_MULTI_INSERT_COMPRESSED_ROW "?|oph_compress('','',?)|"
 
@@ -96,6 +103,7 @@
 #define OPH_DC_SQ_COUNT_COMPRESSED_BIT_ELEMENTS_FRAG_ROW OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_OPERATION, OPH_IOSERVER_SQ_OP_SELECT) OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FIELD, "oph_bit_size('', '', oph_uncompress('','', measure))") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FROM, "%s") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_LIMIT, "0|1")
 
 #define OPH_DC_SQ_DELETE_FRAG OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_OPERATION, OPH_IOSERVER_SQ_OP_DROP_FRAG) OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FRAG, "%s")
+#define OPH_DC_SQ_DELETE_FRAG_VIEW OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_OPERATION, OPH_IOSERVER_SQ_OP_DROP_FRAG_VIEW) OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FRAG, "%s")
 
 #define OPH_DC_SQ_SIZE_ELEMENTS_FRAG OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_OPERATION, OPH_IOSERVER_SQ_OP_FUNCTION) OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FUNC, "oph_size") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_ARG, "%s")
 
@@ -115,6 +123,9 @@
 #define OPH_DC_SQ_APPLY_PLUGIN_GB2 OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_OPERATION, OPH_IOSERVER_SQ_OP_CREATE_FRAG_SELECT) OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FRAG, "%s") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FIELD, "oph_id3(%s,?,%lld)|%s") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FIELD_ALIAS, "%s|%s") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FROM, "%s") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_GROUP, "oph_id3(%s,?,%lld)")
 #define OPH_DC_SQ_APPLY_PLUGIN_WGB2 OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_OPERATION, OPH_IOSERVER_SQ_OP_CREATE_FRAG_SELECT) OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FRAG, "%s") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FIELD, "oph_id3(%s,?,%lld)|%s") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FIELD_ALIAS, "%s|%s") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FROM, "%s") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_WHERE, "%s") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_GROUP, "oph_id3(%s,?,%lld)")
 
+#define OPH_DC_SQ_APPLY_PLUGIN_VIEW OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_OPERATION, OPH_IOSERVER_SQ_OP_CREATE_FRAG_VIEW) OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FRAG, "%s") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FIELD, "%s|%s") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FIELD_ALIAS, "|%s") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FROM, "%s")
+#define OPH_DC_SQ_APPLY_PLUGIN_VIEW_G OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_OPERATION, OPH_IOSERVER_SQ_OP_CREATE_FRAG_VIEW) OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FRAG, "%s") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FIELD, "mysql.oph_id(%s,%lld)|%s") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FIELD_ALIAS, "%s|%s") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_FROM, "%s") OPH_IOSERVER_SQ_BLOCK(OPH_IOSERVER_SQ_ARG_GROUP, "mysql.oph_id(%s,%lld)")
+
 #define MYSQL_DC_CREATE_DB "CREATE DATABASE IF NOT EXISTS %s DEFAULT CHARACTER SET latin1 COLLATE latin1_swedish_ci"
 #define MYSQL_DC_DELETE_DB "DROP DATABASE IF EXISTS %s"
 #define MYSQL_DC_CREATE_FRAG "CREATE TABLE %s (id_dim integer, measure longblob) ENGINE=MyISAM DEFAULT CHARSET=latin1"
@@ -166,9 +177,13 @@
 #define MYSQL_DC_APPLY_PLUGIN_GB2 "CREATE TABLE %s (%s integer, %s longblob) ENGINE=MyISAM DEFAULT CHARSET=latin1 AS SELECT oph_id3(%s,?,%lld) AS %s, %s AS %s FROM %s GROUP BY oph_id3(%s,?,%lld)"
 #define MYSQL_DC_APPLY_PLUGIN_WGB2 "CREATE TABLE %s (%s integer, %s longblob) ENGINE=MyISAM DEFAULT CHARSET=latin1 AS SELECT oph_id3(%s,?,%lld) AS %s, %s AS %s FROM %s WHERE %s GROUP BY oph_id3(%s,?,%lld)"
 
+#define MYSQL_DC_APPLY_PLUGIN_VIEW "CREATE VIEW %s AS SELECT %s, %s AS %s FROM %s"
+#define MYSQL_DC_APPLY_PLUGIN_VIEW_G "CREATE VIEW %s AS SELECT mysql.oph_id(%s,%lld) AS %s, %s AS %s FROM %s GROUP BY mysql.oph_id(%s,%lld)"
+
 #define MYSQL_DC_SIZE_ELEMENTS_FRAG "SELECT oph_convert_l('OPH_LONG','',oph_aggregate_operator('OPH_LONG','OPH_LONG',oph_value_to_bin('','OPH_LONG',index_length+data_length),'OPH_SUM')) AS size FROM information_schema.TABLES WHERE table_name IN (%s);"
 
 #define MYSQL_DC_DELETE_FRAG "DROP TABLE IF EXISTS %s"
+#define MYSQL_DC_DELETE_FRAG_VIEW "DROP VIEW IF EXISTS %s"
 
 #define MYSQL_DC_MAX_ROW_LENGTH_FRAG "SELECT MAX(LENGTH(measure)) FROM %s"
 
@@ -19,8 +19,11 @@
 #ifndef __OPH_DIM_QUERY_H__
 #define __OPH_DIM_QUERY_H__
 
-#define MYSQL_DIM_CREATE_TABLE 							"CREATE TABLE %s (`iddimension` int(10) unsigned NOT NULL AUTO_INCREMENT, `dimension` longblob, PRIMARY KEY(`iddimension`))  ENGINE=MyISAM AUTO_INCREMENT=0 DEFAULT CHARSET=latin1;"
+#define MYSQL_DIM_CREATE_TABLE 							"CREATE TABLE %s (`iddimension` int(10) unsigned NOT NULL AUTO_INCREMENT, `dimension` longblob, `hash` char(64) DEFAULT NULL, PRIMARY KEY(`iddimension`), KEY `hash` (`hash`))  ENGINE=MyISAM AUTO_INCREMENT=0 DEFAULT CHARSET=latin1;"
 #define MYSQL_DIM_INSERT_TABLE 							"INSERT INTO %s (dimension) VALUES (?);"
+#define MYSQL_DIM_INSERT_TABLE_WITH_HASH 				"INSERT INTO %s (dimension, hash) VALUES (?, '%s');"
+#define MYSQL_DIM_FIND_DIMENSION_BY_HASH 				"SELECT iddimension FROM %s WHERE hash = '%s' LIMIT 1;"
+#define MYSQL_DIM_GET_DIMENSION_HASH 					"SELECT hash FROM %s WHERE iddimension = %d;"
 #define MYSQL_DIM_INSERT_TABLE_FROM_QUERY 				"INSERT INTO %s (dimension) SELECT (%s);"
 #define MYSQL_DIM_GET_DIMENSION 						"SELECT oph_compare('', '',%s, ?) FROM %s WHERE iddimension = %d;"
 #define MYSQL_DIM_CHECK_DIMENSION_TABLE 				"SELECT count(*) FROM information_schema.tables WHERE table_schema = '%s' AND table_name = '%s';"
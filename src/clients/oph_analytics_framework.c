@@ -22,6 +22,11 @@
 #include <stdlib.h>
 #include <mpi.h>
 #include <signal.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
 
 #include "taketime.h"
 #include "oph_analytics_framework.h"
@@ -34,6 +39,7 @@ int msglevel = LOG_WARNING_T;
 int oph_handle_signals();
 void oph_signal_handler(int sig);
 void oph_child_signal_handler(int sig);
+int oph_serve(char *socket_path, int size, int myrank);
 
 int main(int argc, char *argv[])
 {
@@ -49,23 +55,26 @@ int main(int argc, char *argv[])
 		fprintf(stdout, "%s", OPH_DISCLAIMER);
 	}
 
-	if (argc != 2) {
+	char *socket_path = NULL;
+	if ((argc == 3) && !strcmp(argv[1], OPH_FRAMEWORK_DAEMON_OPTION))
+		socket_path = argv[2];
+	else if (argc != 2) {
 		if (!myrank)
-			fprintf(stdout, "USAGE: ./oph_analytics_framework \"operator=value;param=value;...\"\n");
+			fprintf(stdout, "USAGE: ./oph_analytics_framework \"operator=value;param=value;...\"\n       ./oph_analytics_framework %s socket_path\n", OPH_FRAMEWORK_DAEMON_OPTION);
 		res = 0;
 	}
 
-	if (!strcmp(argv[1], "-v")) {
+	if ((argc == 2) && !strcmp(argv[1], "-v")) {
 		res = 0;
 	}
 
-	if (!strcmp(argv[1], "-x")) {
+	if ((argc == 2) && !strcmp(argv[1], "-x")) {
 		if (!myrank)
 			fprintf(stdout, "%s", OPH_WARRANTY);
 		res = 0;
 	}
 
-	if (!strcmp(argv[1], "-z")) {
+	if ((argc == 2) && !strcmp(argv[1], "-z")) {
 		if (!myrank)
 			fprintf(stdout, "%s", OPH_CONDITIONS);
 		res = 0;
@@ -86,6 +95,13 @@ int main(int argc, char *argv[])
 		msglevel = LOG_DEBUG_T;
 #endif
 
+		if (socket_path) {
+			if ((res = oph_serve(socket_path, size, myrank)))
+				pmesg(LOG_ERROR, __FILE__, __LINE__, "Framework server failed! ERROR: %d\n", res);
+			MPI_Finalize();
+			return 0;
+		}
+
 		if (!myrank)
 			gettimeofday(&start_time, NULL);
 
@@ -108,6 +124,170 @@ int main(int argc, char *argv[])
 	return 0;
 }
 
+//Read a task string from a client: it is terminated by a newline or by the end of the stream
+int _oph_serve_read(int fd, char **task_string, int *length)
+{
+	int size = OPH_COMMON_BUFFER_LEN, n;
+	char *buffer = (char *) malloc(size), *tmp;
+	if (!buffer)
+		return -1;
+
+	*length = 0;
+	while ((n = read(fd, buffer + *length, size - *length - 1)) > 0) {
+		*length += n;
+		buffer[*length] = 0;
+		if ((tmp = strchr(buffer, '\n'))) {
+			*length = tmp - buffer;
+			break;
+		}
+		if (*length + 1 >= size) {
+			size <<= 1;
+			if (!(tmp = (char *) realloc(buffer, size))) {
+				free(buffer);
+				return -1;
+			}
+			buffer = tmp;
+		}
+	}
+	if (n < 0) {
+		free(buffer);
+		return -1;
+	}
+	while (*length && (buffer[*length - 1] == '\r'))
+		(*length)--;
+	buffer[*length] = 0;
+	*task_string = buffer;
+
+	return 0;
+}
+
+int oph_serve(char *socket_path, int size, int myrank)
+{
+	int sfd = -1, cfd = -1, length = 0, res = 0;
+	char *task_string = NULL, reply[OPH_COMMON_BUFFER_LEN];
+	struct timeval start_time, end_time, total_time;
+
+	//Only the master process listens on the socket, tasks are broadcast to the other processes
+	if (!myrank) {
+		struct sockaddr_un addr;
+		memset(&addr, 0, sizeof(addr));
+		addr.sun_family = AF_UNIX;
+		if (strlen(socket_path) >= sizeof(addr.sun_path)) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Socket path '%s' is too long\n", socket_path);
+			res = -1;
+		} else {
+			snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", socket_path);
+			unlink(socket_path);
+			if (((sfd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0) || bind(sfd, (struct sockaddr *) &addr, sizeof(addr)) || chmod(socket_path, S_IRUSR | S_IWUSR)
+			    || listen(sfd, OPH_FRAMEWORK_DAEMON_BACKLOG)) {
+				pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to listen on socket '%s'\n", socket_path);
+				res = -1;
+			} else
+				pmesg(LOG_INFO, __FILE__, __LINE__, "Framework server listening on socket '%s'\n", socket_path);
+		}
+	}
+	MPI_Bcast(&res, 1, MPI_INT, 0, MPI_COMM_WORLD);
+	if (res) {
+		if (sfd >= 0)
+			close(sfd);
+		return res;
+	}
+
+	oph_af_set_resident_mode(1);
+
+	while (1) {
+
+		// Wait for next task; OPH_FRAMEWORK_DAEMON_STOP stops the server
+		if (!myrank) {
+			length = 0;
+			while (!length) {
+				if ((cfd = accept(sfd, NULL, NULL)) < 0) {
+					if (errno == EINTR)
+						continue;
+					if ((errno == ECONNABORTED) || (errno == EMFILE) || (errno == ENFILE) || (errno == ENOBUFS) || (errno == ENOMEM)) {
+						//Transient errors: wait before accepting new connections
+						pmesg(LOG_WARNING, __FILE__, __LINE__, "Unable to accept connections: %s\n", strerror(errno));
+						sleep(OPH_FRAMEWORK_DAEMON_RETRY_DELAY);
+						continue;
+					}
+					pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to accept connections: %s\n", strerror(errno));
+					break;
+				}
+				if (_oph_serve_read(cfd, &task_string, &length) || !length) {
+					pmesg(LOG_WARNING, __FILE__, __LINE__, "Unable to read task string\n");
+					if (task_string) {
+						free(task_string);
+						task_string = NULL;
+					}
+					close(cfd);
+					cfd = -1;
+					length = 0;
+				}
+			}
+			if (!length || !strcmp(task_string, OPH_FRAMEWORK_DAEMON_STOP))
+				length = 0;
+		}
+		MPI_Bcast(&length, 1, MPI_INT, 0, MPI_COMM_WORLD);
+		if (!length)
+			break;
+
+		// Space at the end of the buffer is used by the framework to append server-side arguments
+		if (myrank && !(task_string = (char *) malloc(length + OPH_COMMON_BUFFER_LEN))) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Error allocating memory\n");
+			MPI_Abort(MPI_COMM_WORLD, -1);
+		} else if (!myrank) {
+			char *tmp = (char *) realloc(task_string, length + OPH_COMMON_BUFFER_LEN);
+			if (!tmp) {
+				pmesg(LOG_ERROR, __FILE__, __LINE__, "Error allocating memory\n");
+				MPI_Abort(MPI_COMM_WORLD, -1);
+			}
+			task_string = tmp;
+		}
+		MPI_Bcast(task_string, length + 1, MPI_CHAR, 0, MPI_COMM_WORLD);
+
+		if (!myrank) {
+			gettimeofday(&start_time, NULL);
+			pmesg(LOG_INFO, __FILE__, __LINE__, "Task string:\n%s\n", task_string);
+		}
+
+		if ((res = oph_af_execute_framework(task_string, size, myrank)))
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Framework execution failed! ERROR: %d\n", res);
+
+		MPI_Barrier(MPI_COMM_WORLD);
+		if (!myrank) {
+			gettimeofday(&end_time, NULL);
+			timeval_subtract(&total_time, &end_time, &start_time);
+			pmesg(LOG_INFO, __FILE__, __LINE__, "Proc %d: Total execution:\t Time %d,%06d sec\n", myrank, (int) total_time.tv_sec, (int) total_time.tv_usec);
+
+			// Reply with the return code of the task
+			snprintf(reply, OPH_COMMON_BUFFER_LEN, "%d\n", res);
+			if (write(cfd, reply, strlen(reply)) < 0)
+				pmesg(LOG_WARNING, __FILE__, __LINE__, "Unable to send the return code to the client\n");
+			close(cfd);
+			cfd = -1;
+		}
+
+		free(task_string);
+		task_string = NULL;
+	}
+
+	if (!myrank) {
+		if (cfd >= 0) {
+			snprintf(reply, OPH_COMMON_BUFFER_LEN, "%d\n", 0);
+			if (write(cfd, reply, strlen(reply)) < 0)
+				pmesg(LOG_WARNING, __FILE__, __LINE__, "Unable to send the return code to the client\n");
+			close(cfd);
+		}
+		close(sfd);
+		unlink(socket_path);
+		pmesg(LOG_INFO, __FILE__, __LINE__, "Framework server stopped\n");
+	}
+	if (task_string)
+		free(task_string);
+
+	return oph_af_release_resident_env();
+}
+
 int oph_handle_signals(void)
 {
 	int rc;
@@ -0,0 +1,208 @@
+/*
+    Ophidia Analytics Framework
+    Copyright (C) 2012-2024 CMCC Foundation
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "hashtbl.h"
+
+#define OPH_HASHTBL_BENCHMARK_DEFAULT_RUNS	100000
+#define OPH_HASHTBL_BENCHMARK_KEY_LEN	64
+
+// Chained table with byte-sum hash previously implemented by hashtbl.c
+struct _reference_node {
+	char *key;
+	char *data;
+	struct _reference_node *next;
+};
+
+typedef struct {
+	size_t size;
+	struct _reference_node **nodes;
+} _reference_table;
+
+static size_t _reference_hash(const char *key)
+{
+	size_t hash = 0;
+	while (*key)
+		hash += (unsigned char) *key++;
+	return hash;
+}
+
+static _reference_table *_reference_create(size_t size)
+{
+	_reference_table *table = (_reference_table *) malloc(sizeof(_reference_table));
+	if (!table)
+		return NULL;
+	if (!(table->nodes = (struct _reference_node **) calloc(size, sizeof(struct _reference_node *)))) {
+		free(table);
+		return NULL;
+	}
+	table->size = size;
+	return table;
+}
+
+static int _reference_insert(_reference_table * table, const char *key, const char *data)
+{
+	size_t hash = _reference_hash(key) % table->size;
+	struct _reference_node *node;
+	for (node = table->nodes[hash]; node; node = node->next)
+		if (!strcmp(node->key, key))
+			return 0;
+	if (!(node = (struct _reference_node *) malloc(sizeof(struct _reference_node))))
+		return -1;
+	node->key = strdup(key);
+	node->data = strdup(data);
+	node->next = table->nodes[hash];
+	table->nodes[hash] = node;
+	return 0;
+}
+
+static char *_reference_get(_reference_table * table, const char *key)
+{
+	struct _reference_node *node;
+	for (node = table->nodes[_reference_hash(key) % table->size]; node; node = node->next)
+		if (!strcmp(node->key, key))
+			return node->data;
+	return NULL;
+}
+
+static void _reference_destroy(_reference_table * table)
+{
+	size_t n;
+	struct _reference_node *node, *next;
+	for (n = 0; n < table->size; ++n)
+		for (node = table->nodes[n]; node; node = next) {
+			next = node->next;
+			free(node->key);
+			free(node->data);
+			free(node);
+		}
+	free(table->nodes);
+	free(table);
+}
+
+static double _elapsed(struct timeval *start, struct timeval *end)
+{
+	return (end->tv_sec - start->tv_sec) + (end->tv_usec - start->tv_usec) / 1000000.0;
+}
+
+static void _usage(const char *name)
+{
+	fprintf(stderr, "Usage: %s [-r runs] [number_of_keys]\n", name);
+	fprintf(stderr,
+		"Build a table of task-string arguments, look up every argument and an unknown one, then destroy the table, as done for each task string and submission query; compare the current table with the chained one.\n");
+}
+
+int main(int argc, char **argv)
+{
+	const char *names[] = { "operator", "cube", "measure", "measure_type", "measure_filter", "sessionid", "workflowid", "markerid", "jobid", "taskindex", "lighttaskindex",
+		"username", "userrole", "ncores", "nthreads", "nhost", "ndbms", "ndb", "nfrag", "exec_mode", "schedule", "cwd", "cdd", "container", "description", "grid",
+		"subset_dims", "subset_filter", "subset_type", "time_filter", "offset", "src_path", "imp_dim", "imp_concept_level", "exp_dim", "exp_concept_level", "compressed",
+		"check_exp_dim", "missingvalue", "operation", "order", "query", "dim", "concept_level", "midnight", "output_path", "output_name", "export_metadata", "ioserver",
+		"partition", "id_dim", "fragment", "frag_key", "sequential_id", "array_length", "from", "where", "group", "limit"
+	};
+	int runs = OPH_HASHTBL_BENCHMARK_DEFAULT_RUNS, first = 1, number = sizeof(names) / sizeof(char *), i, r, mismatch = 0;
+
+	if ((argc > 2) && !strcmp(argv[1], "-r")) {
+		runs = (int) strtol(argv[2], NULL, 10);
+		first = 3;
+	}
+	if (argc > first)
+		number = (int) strtol(argv[first], NULL, 10);
+	if ((runs <= 0) || (number <= 0) || (argc > first + 1)) {
+		_usage(argv[0]);
+		return 1;
+	}
+
+	// Known argument names are used first, then synthetic names sharing the same prefix
+	char (*keys)[OPH_HASHTBL_BENCHMARK_KEY_LEN] = malloc(number * OPH_HASHTBL_BENCHMARK_KEY_LEN);
+	if (!keys) {
+		fprintf(stderr, "Error allocating memory\n");
+		return 1;
+	}
+	for (i = 0; i < number; ++i)
+		if (i < (int) (sizeof(names) / sizeof(char *)))
+			snprintf(keys[i], OPH_HASHTBL_BENCHMARK_KEY_LEN, "%s", names[i]);
+		else
+			snprintf(keys[i], OPH_HASHTBL_BENCHMARK_KEY_LEN, "measure_%d", i);
+
+	printf("%d keys, %d runs\n", number, runs);
+
+	struct timeval start, end;
+	double reference_time = 0.0, table_time = 0.0;
+	size_t found = 0, expected = 0;
+
+	gettimeofday(&start, NULL);
+	for (r = 0; r < runs; r++) {
+		_reference_table *table = _reference_create(number + 1);
+		if (!table)
+			break;
+		for (i = 0; i < number; ++i)
+			_reference_insert(table, keys[i], keys[i]);
+		for (i = 0; i < number; ++i)
+			if (_reference_get(table, keys[i]))
+				expected++;
+		if (_reference_get(table, "unknown"))
+			expected++;
+		_reference_destroy(table);
+	}
+	gettimeofday(&end, NULL);
+	reference_time = _elapsed(&start, &end);
+
+	gettimeofday(&start, NULL);
+	for (r = 0; r < runs; r++) {
+		HASHTBL *table = hashtbl_create(number + 1, NULL);
+		if (!table)
+			break;
+		for (i = 0; i < number; ++i)
+			hashtbl_insert(table, keys[i], keys[i]);
+		for (i = 0; i < number; ++i)
+			if (hashtbl_get(table, keys[i]))
+				found++;
+		if (hashtbl_get(table, "unknown"))
+			found++;
+		hashtbl_destroy(table);
+	}
+	gettimeofday(&end, NULL);
+	table_time = _elapsed(&start, &end);
+
+	// Check values and removals
+	HASHTBL *table = hashtbl_create(1, NULL);
+	if (table) {
+		for (i = 0; i < number; ++i)
+			hashtbl_insert(table, keys[i], keys[i]);
+		for (i = 0; i < number; i += 2)
+			hashtbl_remove(table, keys[i]);
+		for (i = 0; i < number; ++i) {
+			char *value = (char *) hashtbl_get(table, keys[i]);
+			if ((i % 2) ? (!value || strcmp(value, keys[i])) : (value != NULL))
+				mismatch = 1;
+		}
+		hashtbl_destroy(table);
+	} else
+		mismatch = 1;
+
+	printf("chained %.6f s, open addressing %.6f s, speedup %.2fx%s\n", reference_time, table_time, table_time > 0.0 ? reference_time / table_time : 0.0, (found != expected)
+	       || mismatch ? " [MISMATCH]" : "");
+
+	free(keys);
+	return 0;
+}
@@ -0,0 +1,149 @@
+/*
+    Ophidia Analytics Framework
+    Copyright (C) 2012-2024 CMCC Foundation
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "oph_reorder_library.h"
+#include "debug.h"
+
+#define OPH_REORDER_BENCHMARK_MAX_DIMS	8
+#define OPH_REORDER_BENCHMARK_DEFAULT_RUNS	5
+
+int msglevel = LOG_INFO;
+
+// Element-wise reordering previously used by NetCDF, FITS and ESDM libraries
+static void _reference_cache_to_buffer(short int tot_dim_number, short int curr_dim, unsigned int *counters, unsigned int *limits, unsigned int *products, long long *index, char *binary_cache,
+				       char *binary_insert, size_t sizeof_var)
+{
+	int i = 0;
+	long long addr = 0;
+
+	if (tot_dim_number > curr_dim) {
+		if (curr_dim != 0)
+			counters[curr_dim] = 0;
+		while (counters[curr_dim] < limits[curr_dim]) {
+			_reference_cache_to_buffer(tot_dim_number, curr_dim + 1, counters, limits, products, index, binary_cache, binary_insert, sizeof_var);
+			counters[curr_dim]++;
+		}
+		return;
+	}
+
+	for (i = 0; i < tot_dim_number; i++)
+		addr += counters[i] * products[i];
+	memcpy(binary_insert + (*index) * sizeof_var, binary_cache + addr * sizeof_var, sizeof_var);
+	(*index)++;
+}
+
+static double _elapsed(struct timeval *start, struct timeval *end)
+{
+	return (end->tv_sec - start->tv_sec) + (end->tv_usec - start->tv_usec) / 1000000.0;
+}
+
+static void _usage(const char *name)
+{
+	fprintf(stderr, "Usage: %s [-r runs] size_1 ... size_n\n", name);
+	fprintf(stderr, "Reorder an array of n dimensions stored in reverse order (the last dimension varies slowest in input) and compare the reordering kernels with the element-wise copy.\n");
+}
+
+int main(int argc, char **argv)
+{
+	int runs = OPH_REORDER_BENCHMARK_DEFAULT_RUNS, first = 1, i, r;
+	short int n = 0, d;
+	unsigned int sizes[OPH_REORDER_BENCHMARK_MAX_DIMS] = { 12, 45, 90, 180 };
+	unsigned int counters[OPH_REORDER_BENCHMARK_MAX_DIMS], limits[OPH_REORDER_BENCHMARK_MAX_DIMS], products[OPH_REORDER_BENCHMARK_MAX_DIMS];
+	size_t element_sizes[] = { 1, 2, 4, 8 }, total = 1, s;
+
+	if ((argc > 2) && !strcmp(argv[1], "-r")) {
+		runs = (int) strtol(argv[2], NULL, 10);
+		first = 3;
+	}
+	if (runs <= 0) {
+		_usage(argv[0]);
+		return 1;
+	}
+	for (i = first; i < argc; i++) {
+		if (n >= OPH_REORDER_BENCHMARK_MAX_DIMS || !(sizes[n] = (unsigned int) strtol(argv[i], NULL, 10))) {
+			_usage(argv[0]);
+			return 1;
+		}
+		n++;
+	}
+	if (!n)
+		n = 4;
+
+	// Input is stored with the dimensions in reverse order
+	for (d = 0; d < n; d++) {
+		products[d] = 1;
+		for (i = 0; i < d; i++)
+			products[d] *= sizes[i];
+		total *= sizes[d];
+	}
+
+	printf("Dimensions:");
+	for (d = 0; d < n; d++)
+		printf(" %u", sizes[d]);
+	printf(" (%zu elements, %d runs)\n", total, runs);
+
+	for (s = 0; s < sizeof(element_sizes) / sizeof(size_t); s++) {
+		size_t sizeof_var = element_sizes[s], b;
+		char *cache = (char *) malloc(total * sizeof_var), *expected = (char *) malloc(total * sizeof_var), *buffer = (char *) malloc(total * sizeof_var);
+		if (!cache || !expected || !buffer) {
+			fprintf(stderr, "Error allocating memory\n");
+			free(cache);
+			free(expected);
+			free(buffer);
+			return 1;
+		}
+		for (b = 0; b < total * sizeof_var; b++)
+			cache[b] = (char) (b * 31 + 7);
+
+		struct timeval start, end;
+		double reference_time = 0.0, kernel_time = 0.0;
+		long long index;
+		for (r = 0; r < runs; r++) {
+			for (d = 0; d < n; d++) {
+				counters[d] = 0;
+				limits[d] = sizes[d];
+			}
+			index = 0;
+			gettimeofday(&start, NULL);
+			_reference_cache_to_buffer(n, 0, counters, limits, products, &index, cache, expected, sizeof_var);
+			gettimeofday(&end, NULL);
+			reference_time += _elapsed(&start, &end);
+
+			for (d = 0; d < n; d++)
+				counters[d] = 0;
+			gettimeofday(&start, NULL);
+			oph_reorder_cache_to_buffer(n, counters, limits, products, cache, buffer, sizeof_var);
+			gettimeofday(&end, NULL);
+			kernel_time += _elapsed(&start, &end);
+		}
+
+		printf("%zu-byte elements: element-wise %.6f s, blocked %.6f s, speedup %.2fx%s\n", sizeof_var, reference_time / runs, kernel_time / runs,
+		       kernel_time > 0.0 ? reference_time / kernel_time : 0.0, memcmp(expected, buffer, total * sizeof_var) ? " [MISMATCH]" : "");
+
+		free(cache);
+		free(expected);
+		free(buffer);
+	}
+
+	return 0;
+}
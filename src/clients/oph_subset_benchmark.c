@@ -0,0 +1,159 @@
+/*
+    Ophidia Analytics Framework
+    Copyright (C) 2012-2024 CMCC Foundation
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "oph_subset_library.h"
+#include "debug.h"
+
+#define OPH_SUBSET_BENCHMARK_DEFAULT_RUNS	5
+#define OPH_SUBSET_BENCHMARK_FILTER_LEN	65536
+
+int msglevel = LOG_INFO;
+
+static double _elapsed(struct timeval *start, struct timeval *end)
+{
+	return (end->tv_sec - start->tv_sec) + (end->tv_usec - start->tv_usec) / 1000000.0;
+}
+
+static void _usage(const char *name)
+{
+	fprintf(stderr, "Usage: %s [-r runs] [size inner_size [subset]]\n", name);
+	fprintf(stderr,
+		"Test the membership of the ids of a dimension of 'size' elements, whose ids are grouped in blocks of 'inner_size' elements, and compare the compiled filter with the scan of subset blocks.\n");
+	fprintf(stderr, "Without a subset, a set of filters similar to the ones used for daily time series is evaluated.\n");
+}
+
+static int _benchmark(const char *cond, unsigned long long size, unsigned long long inner_size, int runs)
+{
+	oph_subset *subset = NULL;
+	oph_subset_filter filter;
+	if (oph_subset_init(&subset) || oph_subset_parse(cond, strlen(cond), subset, size)) {
+		fprintf(stderr, "Unable to parse subset '%.64s'\n", cond);
+		free(subset);
+		return 1;
+	}
+	unsigned long long sizes[2] = { inner_size, size }, max_id = size * inner_size, id, id_number = 0, *id_start = NULL, *id_end = NULL;
+	unsigned long long expected = 0, found = 0, intervals = 0;
+	int r, mismatch = 0;
+
+	struct timeval start, end;
+	double reference_time = 0.0, compile_time = 0.0, filter_time = 0.0;
+	for (r = 0; r < runs; r++) {
+		expected = found = 0;
+		gettimeofday(&start, NULL);
+		for (id = 1; id <= max_id; ++id)
+			if (oph_subset_index_is_in_subset(oph_subset_id_to_index(id, sizes, 2), subset))
+				expected++;
+		gettimeofday(&end, NULL);
+		reference_time += _elapsed(&start, &end);
+
+		gettimeofday(&start, NULL);
+		if (oph_subset_filter_compile(subset, size, inner_size, &filter)) {
+			fprintf(stderr, "Unable to compile subset\n");
+			oph_subset_free(subset);
+			return 1;
+		}
+		gettimeofday(&end, NULL);
+		compile_time += _elapsed(&start, &end);
+
+		gettimeofday(&start, NULL);
+		for (id = 1; id <= max_id; ++id)
+			if (oph_subset_filter_id_is_in(&filter, id))
+				found++;
+		gettimeofday(&end, NULL);
+		filter_time += _elapsed(&start, &end);
+
+		if (!r) {
+			intervals = filter.number;
+			for (id = 1; id <= max_id; ++id)
+				if (oph_subset_filter_id_is_in(&filter, id) != oph_subset_index_is_in_subset(oph_subset_id_to_index(id, sizes, 2), subset))
+					mismatch = 1;
+			oph_subset_filter_id_ranges(&filter, max_id, max_id, &id_start, &id_end, &id_number);
+			for (id = 0, expected = 0; id < id_number; ++id)
+				expected += id_end[id] - id_start[id] + 1;
+			if (expected != found)
+				mismatch = 1;
+			free(id_start);
+			free(id_end);
+		}
+		oph_subset_filter_free(&filter);
+	}
+
+	printf("%u blocks, %llu intervals, %llu id ranges, %llu ids selected: scan %.6f s, filter %.6f s (compile %.6f s), speedup %.2fx%s\n", subset->number, intervals, id_number, found,
+	       reference_time / runs, filter_time / runs, compile_time / runs, filter_time + compile_time > 0.0 ? reference_time / (filter_time + compile_time) : 0.0,
+	       mismatch ? " [MISMATCH]" : "");
+
+	oph_subset_free(subset);
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	int runs = OPH_SUBSET_BENCHMARK_DEFAULT_RUNS, first = 1, res = 0;
+	unsigned long long size = 36500, inner_size = 64, i;
+
+	if ((argc > 2) && !strcmp(argv[1], "-r")) {
+		runs = (int) strtol(argv[2], NULL, 10);
+		first = 3;
+	}
+	if ((runs <= 0) || (argc - first == 1) || (argc - first > 3)) {
+		_usage(argv[0]);
+		return 1;
+	}
+	if (argc - first >= 2) {
+		size = strtoull(argv[first], NULL, 10);
+		inner_size = strtoull(argv[first + 1], NULL, 10);
+		if (!size || !inner_size) {
+			_usage(argv[0]);
+			return 1;
+		}
+	}
+	printf("Dimension size %llu, inner size %llu (%llu ids, %d runs)\n", size, inner_size, size * inner_size, runs);
+
+	if (argc - first == 3)
+		return _benchmark(argv[first + 2], size, inner_size, runs);
+
+	char cond[OPH_SUBSET_BENCHMARK_FILTER_LEN];
+	int n;
+
+	// A single interval
+	snprintf(cond, OPH_SUBSET_BENCHMARK_FILTER_LEN, "%llu:%llu", size / 4, 3 * size / 4);
+	res |= _benchmark(cond, size, inner_size, runs);
+
+	// Every other element
+	snprintf(cond, OPH_SUBSET_BENCHMARK_FILTER_LEN, "1:2:%llu", size);
+	res |= _benchmark(cond, size, inner_size, runs);
+
+	// A season for each year (days from 152 to 243), as built by time filters
+	for (i = 0, n = 0; (i + 243 <= size) && (n < OPH_SUBSET_BENCHMARK_FILTER_LEN - 64); i += 365)
+		n += snprintf(cond + n, OPH_SUBSET_BENCHMARK_FILTER_LEN - n, "%s%llu:%llu", n ? "," : "", i + 152, i + 243);
+	if (n)
+		res |= _benchmark(cond, size, inner_size, runs);
+
+	// Overlapping intervals and single values
+	for (i = 1, n = 0; (i + 10 <= size) && (n < OPH_SUBSET_BENCHMARK_FILTER_LEN - 64); i += 97)
+		n += snprintf(cond + n, OPH_SUBSET_BENCHMARK_FILTER_LEN - n, "%s%llu:%llu,%llu", n ? "," : "", i, i + 10, i + 5);
+	if (n)
+		res |= _benchmark(cond, size, inner_size, runs);
+
+	return res;
+}
@@ -21,6 +21,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <pthread.h>
+#include <sched.h>
 
 #include "oph_common.h"
 
@@ -114,93 +116,256 @@ void pmesg(int level, const char *source, long int line_number, const char *form
 }
 #endif				/* NDEBUG && __GNUC__ */
 
-void logging(int level, const char *source, long int line_number, int container_id, const char *format, ...)
-{
-	int new_msglevel = msglevel % 10;
-	if (level > new_msglevel)
-		return;
+// Single consumer of the ring buffer: slots are reserved by producers without locks
+typedef struct {
+	unsigned long sequence;
+	char namefile[LOGGING_MAX_STRING];
+	char *text;
+} logging_slot;
 
+typedef struct {
 	char namefile[LOGGING_MAX_STRING];
-	if (prefix)
-		snprintf(namefile, LOGGING_MAX_STRING, LOGGING_PATH_WITH_PREFIX, prefix, container_id);
-	else
-		snprintf(namefile, LOGGING_MAX_STRING, LOGGING_PATH, container_id);
+	FILE *file;
+	unsigned long last_use;
+} logging_file;
+
+static logging_slot *logging_ring = NULL;
+static unsigned long logging_tail = 0;
+static unsigned long logging_head = 0;
+static unsigned long logging_flushed = 0;	// Messages written to the files by the background thread
+static unsigned long logging_overflows = 0;
+static int logging_writers = 0;
+static char logging_running = 0;
+static char logging_stop = 0;
+static pthread_t logging_flusher;
+static pthread_mutex_t logging_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t logging_cond = PTHREAD_COND_INITIALIZER;
+
+static void _logging_type(int level, char *log_type)
+{
+	switch (level) {
+		case LOG_ERROR:
+			sprintf(log_type, LOG_ERROR_MESSAGE);
+			break;
+		case LOG_INFO:
+			sprintf(log_type, LOG_INFO_MESSAGE);
+			break;
+		case LOG_WARNING:
+			sprintf(log_type, LOG_WARNING_MESSAGE);
+			break;
+		case LOG_DEBUG:
+			sprintf(log_type, LOG_DEBUG_MESSAGE);
+			break;
+		default:
+			sprintf(log_type, LOG_UNKNOWN_MESSAGE);
+			break;
+	}
+}
+
+static int _logging_write_sync(const char *namefile, const char *text)
+{
 	FILE *log_file;
-	if ((log_file = fopen(namefile, "a"))) {
-		va_list args;
-		char log_type[10];
+	if (!(log_file = fopen(namefile, "a")))
+		return 1;
+	fprintf(log_file, "%s", text);
+	fclose(log_file);
+	return 0;
+}
 
-		switch (level) {
-			case LOG_ERROR:
-				sprintf(log_type, LOG_ERROR_MESSAGE);
-				break;
-			case LOG_INFO:
-				sprintf(log_type, LOG_INFO_MESSAGE);
-				break;
-			case LOG_WARNING:
-				sprintf(log_type, LOG_WARNING_MESSAGE);
-				break;
-			case LOG_DEBUG:
-				sprintf(log_type, LOG_DEBUG_MESSAGE);
-				break;
-			default:
-				sprintf(log_type, LOG_UNKNOWN_MESSAGE);
+// Return 0 if the message has been queued, 1 if the ring buffer is full, 2 if the message could not be copied
+static int _logging_enqueue(const char *namefile, const char *text)
+{
+	logging_slot *slot;
+	unsigned long pos = __atomic_load_n(&logging_tail, __ATOMIC_RELAXED), sequence;
+	long diff;
+	for (;;) {
+		slot = logging_ring + (pos & (LOGGING_ASYNC_SLOTS - 1));
+		sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+		diff = (long) sequence - (long) pos;
+		if (!diff) {
+			if (__atomic_compare_exchange_n(&logging_tail, &pos, pos + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
 				break;
+		} else if (diff < 0)
+			return 1;
+		else
+			pos = __atomic_load_n(&logging_tail, __ATOMIC_RELAXED);
+	}
+	snprintf(slot->namefile, LOGGING_MAX_STRING, "%s", namefile);
+	// Empty slots are skipped by the background thread
+	slot->text = strdup(text);
+	int res = slot->text ? 0 : 2;
+	__atomic_store_n(&slot->sequence, pos + 1, __ATOMIC_RELEASE);
+	// Wake up the background thread when half of the ring buffer is busy
+	if (pos - __atomic_load_n(&logging_head, __ATOMIC_RELAXED) == LOGGING_ASYNC_SLOTS / 2)
+		pthread_cond_signal(&logging_cond);
+	return res;
+}
+
+static FILE *_logging_get_file(logging_file * files, const char *namefile, unsigned long now)
+{
+	int i, lru = 0;
+	for (i = 0; i < LOGGING_ASYNC_MAX_FILES; ++i) {
+		if (files[i].file && !strcmp(files[i].namefile, namefile)) {
+			files[i].last_use = now;
+			return files[i].file;
 		}
+		if (!files[i].file || (files[lru].file && (files[i].last_use < files[lru].last_use)))
+			lru = i;
+	}
+	// The least recently used file is closed when all the descriptors are busy
+	if (files[lru].file)
+		fclose(files[lru].file);
+	files[lru].file = fopen(namefile, "a");
+	snprintf(files[lru].namefile, LOGGING_MAX_STRING, "%s", namefile);
+	files[lru].last_use = now;
+	return files[lru].file;
+}
 
-		char log_line[MAX_LOG_LINE];
+// Write the queued messages; return the number of messages
+static unsigned long _logging_drain(logging_file * files)
+{
+	unsigned long n = 0;
+	int i;
+	logging_slot *slot;
+	FILE *log_file;
+	for (;; ++n) {
+		slot = logging_ring + (logging_head & (LOGGING_ASYNC_SLOTS - 1));
+		if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != logging_head + 1)
+			break;
+		if (slot->text) {
+			if ((log_file = _logging_get_file(files, slot->namefile, logging_head)))
+				fprintf(log_file, "%s", slot->text);
+			else
+				pmesg(LOG_ERROR, __FILE__, __LINE__, "Error in opening log file '%s'\n", slot->namefile);
+			free(slot->text);
+			slot->text = NULL;
+		}
+		__atomic_store_n(&slot->sequence, logging_head + LOGGING_ASYNC_SLOTS, __ATOMIC_RELEASE);
+		__atomic_store_n(&logging_head, logging_head + 1, __ATOMIC_RELAXED);
+	}
+	if (n)
+		for (i = 0; i < LOGGING_ASYNC_MAX_FILES; ++i)
+			if (files[i].file)
+				fflush(files[i].file);
+	__atomic_store_n(&logging_flushed, logging_head, __ATOMIC_RELEASE);
+	return n;
+}
+
+// Wait for the background thread to write the messages queued so far
+static void _logging_wait_drain()
+{
+	unsigned long target = __atomic_load_n(&logging_tail, __ATOMIC_SEQ_CST);
+	while ((long) (__atomic_load_n(&logging_flushed, __ATOMIC_ACQUIRE) - target) < 0) {
+		pthread_cond_signal(&logging_cond);
+		sched_yield();
+	}
+}
 
-		if (msglevel > 10) {
-			time_t t1 = time(NULL);
-			char s[CTIME_BUF];
-			ctime_r(&t1, s);
-			s[strlen(s) - 1] = 0;	// remove \n
-			snprintf(log_line, MAX_LOG_LINE, LOG_OUTPUT_FORMAT1, s, log_type, source, line_number);
-		} else {
-			snprintf(log_line, MAX_LOG_LINE, LOG_OUTPUT_FORMAT2, log_type, source, line_number);
+static void *_logging_flusher(void *arg)
+{
+	(void) arg;
+	logging_file files[LOGGING_ASYNC_MAX_FILES];
+	memset(files, 0, sizeof(files));
+
+	struct timespec deadline;
+	char stop = 0;
+	while (!stop) {
+		// Wait only when the ring buffer is empty
+		if (_logging_drain(files) && !__atomic_load_n(&logging_stop, __ATOMIC_RELAXED))
+			continue;
+		pthread_mutex_lock(&logging_lock);
+		if (!(stop = logging_stop)) {
+			clock_gettime(CLOCK_REALTIME, &deadline);
+			deadline.tv_nsec += LOGGING_ASYNC_INTERVAL * 1000000L;
+			deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+			deadline.tv_nsec %= 1000000000L;
+			pthread_cond_timedwait(&logging_cond, &logging_lock, &deadline);
 		}
+		pthread_mutex_unlock(&logging_lock);
+	}
+	// Producers have been stopped before setting the flag
+	_logging_drain(files);
+
+	int i;
+	for (i = 0; i < LOGGING_ASYNC_MAX_FILES; ++i)
+		if (files[i].file)
+			fclose(files[i].file);
+	return NULL;
+}
+
+static void _logging(int level, const char *source, long int line_number, const char *namefile, const char *format, va_list args)
+{
+	char log_type[10];
+	_logging_type(level, log_type);
+
+	char log_line[MAX_LOG_LINE], text[MAX_LOG_LINE];
 
-		fprintf(log_file, "%s", log_line);
-		if (backtrace) {
+	if (msglevel > 10) {
+		time_t t1 = time(NULL);
+		char s[CTIME_BUF];
+		ctime_r(&t1, s);
+		s[strlen(s) - 1] = 0;	// remove \n
+		snprintf(log_line, MAX_LOG_LINE, LOG_OUTPUT_FORMAT1, s, log_type, source, line_number);
+	} else {
+		snprintf(log_line, MAX_LOG_LINE, LOG_OUTPUT_FORMAT2, log_type, source, line_number);
+	}
+
+	int header = snprintf(text, MAX_LOG_LINE, "%s", log_line);
+	if (backtrace) {
 #if defined(OPH_TIME_DEBUG_1) || defined(OPH_TIME_DEBUG_2)
-			int length = 2 + (*backtrace ? strlen(*backtrace) : 0) + strlen(log_line);
-			char tmp[length];
-			snprintf(tmp, length, "%s%s", *backtrace ? *backtrace : "", log_line);
-			if (*backtrace)
-				free(*backtrace);
-			*backtrace = strdup(tmp);
+		int length = 2 + (*backtrace ? strlen(*backtrace) : 0) + strlen(log_line);
+		char tmp[length];
+		snprintf(tmp, length, "%s%s", *backtrace ? *backtrace : "", log_line);
+		if (*backtrace)
+			free(*backtrace);
+		*backtrace = strdup(tmp);
 #endif
-		}
+	}
 
-		va_start(args, format);
-		vsnprintf(log_line, MAX_LOG_LINE, format, args);
-		va_end(args);
+	vsnprintf(log_line, MAX_LOG_LINE, format, args);
 
-		fprintf(log_file, "%s", log_line);
-		if (backtrace) {
+	if (header < MAX_LOG_LINE)
+		snprintf(text + header, MAX_LOG_LINE - header, "%s", log_line);
+	if (backtrace) {
 #if defined(OPH_TIME_DEBUG_1) || defined(OPH_TIME_DEBUG_2)
-			int length = 2 + (*backtrace ? strlen(*backtrace) : 0) + strlen(log_line);
+		int length = 2 + (*backtrace ? strlen(*backtrace) : 0) + strlen(log_line);
+		char tmp[length];
+		snprintf(tmp, length, "%s%s", *backtrace ? *backtrace : "", log_line);
+		if (*backtrace)
+			free(*backtrace);
+		*backtrace = strdup(tmp);
+#else
+		if (!*backtrace && (level == LOG_ERROR)) {
+			int length = 4 + strlen(log_line);
 			char tmp[length];
-			snprintf(tmp, length, "%s%s", *backtrace ? *backtrace : "", log_line);
-			if (*backtrace)
-				free(*backtrace);
+			snprintf(tmp, length, ": %s", log_line);
 			*backtrace = strdup(tmp);
-#else
-			if (!*backtrace && (level == LOG_ERROR)) {
-				int length = 4 + strlen(log_line);
-				char tmp[length];
-				snprintf(tmp, length, ": %s", log_line);
-				*backtrace = strdup(tmp);
-			}
-#endif
 		}
+#endif
+	}
 
-		fclose(log_file);
-	} else
+	// Errors are written synchronously to survive a crash, as well as messages that cannot be queued
+	__atomic_add_fetch(&logging_writers, 1, __ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&logging_running, __ATOMIC_SEQ_CST)) {
+		if (level != LOG_ERROR) {
+			int res, retries = 0;
+			while (((res = _logging_enqueue(namefile, text)) == 1) && (retries++ < LOGGING_ASYNC_RETRIES))
+				sched_yield();
+			if (!res) {
+				__atomic_sub_fetch(&logging_writers, 1, __ATOMIC_SEQ_CST);
+				return;
+			}
+			__atomic_add_fetch(&logging_overflows, 1, __ATOMIC_RELAXED);
+		}
+		// Messages queued before this one are written first
+		_logging_wait_drain();
+	}
+	__atomic_sub_fetch(&logging_writers, 1, __ATOMIC_SEQ_CST);
+	if (_logging_write_sync(namefile, text))
 		pmesg(LOG_ERROR, source, line_number, "Error in opening log file '%s'\n", namefile);
 }
 
-void logging_server(int level, const char *source, long int line_number, const char *server_type, const char *format, ...)
+void logging(int level, const char *source, long int line_number, int container_id, const char *format, ...)
 {
 	int new_msglevel = msglevel % 10;
 	if (level > new_msglevel)
@@ -208,82 +373,80 @@ void logging_server(int level, const char *source, long int line_number, const c
 
 	char namefile[LOGGING_MAX_STRING];
 	if (prefix)
-		snprintf(namefile, LOGGING_MAX_STRING, LOGGING_SERVER_PATH_WITH_PREFIX, prefix, server_type);
+		snprintf(namefile, LOGGING_MAX_STRING, LOGGING_PATH_WITH_PREFIX, prefix, container_id);
 	else
-		snprintf(namefile, LOGGING_MAX_STRING, LOGGING_SERVER_PATH, server_type);
-	FILE *log_file;
-	if ((log_file = fopen(namefile, "a"))) {
-		va_list args;
-		char log_type[10];
+		snprintf(namefile, LOGGING_MAX_STRING, LOGGING_PATH, container_id);
 
-		switch (level) {
-			case LOG_ERROR:
-				sprintf(log_type, LOG_ERROR_MESSAGE);
-				break;
-			case LOG_INFO:
-				sprintf(log_type, LOG_INFO_MESSAGE);
-				break;
-			case LOG_WARNING:
-				sprintf(log_type, LOG_WARNING_MESSAGE);
-				break;
-			case LOG_DEBUG:
-				sprintf(log_type, LOG_DEBUG_MESSAGE);
-				break;
-			default:
-				sprintf(log_type, LOG_UNKNOWN_MESSAGE);
-				break;
-		}
+	va_list args;
+	va_start(args, format);
+	_logging(level, source, line_number, namefile, format, args);
+	va_end(args);
+}
 
-		char log_line[MAX_LOG_LINE];
+void logging_server(int level, const char *source, long int line_number, const char *server_type, const char *format, ...)
+{
+	int new_msglevel = msglevel % 10;
+	if (level > new_msglevel)
+		return;
 
-		if (msglevel > 10) {
-			time_t t1 = time(NULL);
-			char s[CTIME_BUF];
-			ctime_r(&t1, s);
-			s[strlen(s) - 1] = 0;	// remove \n
-			snprintf(log_line, MAX_LOG_LINE, LOG_OUTPUT_FORMAT1, s, log_type, source, line_number);
-		} else {
-			snprintf(log_line, MAX_LOG_LINE, LOG_OUTPUT_FORMAT2, log_type, source, line_number);
-		}
+	char namefile[LOGGING_MAX_STRING];
+	if (prefix)
+		snprintf(namefile, LOGGING_MAX_STRING, LOGGING_SERVER_PATH_WITH_PREFIX, prefix, server_type);
+	else
+		snprintf(namefile, LOGGING_MAX_STRING, LOGGING_SERVER_PATH, server_type);
 
-		fprintf(log_file, "%s", log_line);
-		if (backtrace) {
-#if defined(OPH_TIME_DEBUG_1) || defined(OPH_TIME_DEBUG_2)
-			int length = 2 + (*backtrace ? strlen(*backtrace) : 0) + strlen(log_line);
-			char tmp[length];
-			snprintf(tmp, length, "%s%s", *backtrace ? *backtrace : "", log_line);
-			if (*backtrace)
-				free(*backtrace);
-			*backtrace = strdup(tmp);
-#endif
-		}
+	va_list args;
+	va_start(args, format);
+	_logging(level, source, line_number, namefile, format, args);
+	va_end(args);
+}
 
-		va_start(args, format);
-		vsnprintf(log_line, MAX_LOG_LINE, format, args);
-		va_end(args);
+int logging_async_start()
+{
+	if (logging_running)
+		return 0;
+	const char *value = getenv(LOGGING_ASYNC_ENV);
+	if (value && !strcmp(value, "0"))
+		return 0;
+
+	unsigned long i;
+	if (!logging_ring && !(logging_ring = (logging_slot *) calloc(LOGGING_ASYNC_SLOTS, sizeof(logging_slot)))) {
+		pmesg(LOG_WARNING, __FILE__, __LINE__, "Unable to allocate the logging buffer: messages will be written synchronously\n");
+		return 1;
+	}
+	for (i = 0; i < LOGGING_ASYNC_SLOTS; ++i)
+		logging_ring[i].sequence = i;
+	logging_head = logging_tail = logging_flushed = logging_overflows = 0;
+	logging_stop = 0;
+
+	if (pthread_create(&logging_flusher, NULL, _logging_flusher, NULL)) {
+		pmesg(LOG_WARNING, __FILE__, __LINE__, "Unable to start the logging thread: messages will be written synchronously\n");
+		return 1;
+	}
+	__atomic_store_n(&logging_running, 1, __ATOMIC_RELEASE);
 
-		fprintf(log_file, "%s", log_line);
-		if (backtrace) {
-#if defined(OPH_TIME_DEBUG_1) || defined(OPH_TIME_DEBUG_2)
-			int length = 2 + (*backtrace ? strlen(*backtrace) : 0) + strlen(log_line);
-			char tmp[length];
-			snprintf(tmp, length, "%s%s", *backtrace ? *backtrace : "", log_line);
-			if (*backtrace)
-				free(*backtrace);
-			*backtrace = strdup(tmp);
-#else
-			if (!*backtrace && (level == LOG_ERROR)) {
-				int length = 4 + strlen(log_line);
-				char tmp[length];
-				snprintf(tmp, length, ": %s", log_line);
-				*backtrace = strdup(tmp);
-			}
-#endif
-		}
+	return 0;
+}
 
-		fclose(log_file);
-	} else
-		pmesg(LOG_ERROR, source, line_number, "Error in opening log file '%s'\n", namefile);
+int logging_async_stop()
+{
+	if (!logging_running)
+		return 0;
+
+	// Wait for the messages being queued before the last drain
+	__atomic_store_n(&logging_running, 0, __ATOMIC_SEQ_CST);
+	while (__atomic_load_n(&logging_writers, __ATOMIC_SEQ_CST))
+		sched_yield();
+	pthread_mutex_lock(&logging_lock);
+	__atomic_store_n(&logging_stop, 1, __ATOMIC_RELAXED);
+	pthread_cond_signal(&logging_cond);
+	pthread_mutex_unlock(&logging_lock);
+	pthread_join(logging_flusher, NULL);
+
+	if (logging_overflows)
+		pmesg(LOG_DEBUG, __FILE__, __LINE__, "%lu log messages have been written synchronously as they could not be queued\n", logging_overflows);
+
+	return 0;
 }
 
 void set_log_prefix(char *p)
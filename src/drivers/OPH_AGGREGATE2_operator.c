@@ -43,6 +43,7 @@
 #include "oph_framework_paths.h"
 #include "oph_datacube_library.h"
 #include "oph_driver_procedure_library.h"
+#include "oph_scheduler_library.h"
 
 #include <pthread.h>
 
@@ -55,6 +56,7 @@ struct _thread_struct {
 	oph_odb_fragment_list *frags;
 	oph_odb_db_instance_list *dbs;
 	oph_odb_dbms_instance_list *dbmss;
+	oph_sched *sched;
 	char *_ms;
 };
 typedef struct _thread_struct thread_struct;
@@ -64,35 +66,25 @@ void *exec_thread(void *ts)
 
 	OPH_AGGREGATE2_operator_handle *oper_handle = ((thread_struct *) ts)->oper_handle;
 	int l = ((thread_struct *) ts)->current_thread;
-	int num_threads = ((thread_struct *) ts)->total_threads;
 	int proc_rank = ((thread_struct *) ts)->proc_rank;
 	int counters = ((thread_struct *) ts)->counters;
 
-	int i = 0, k;
+	int k;
 
 	int id_datacube_out = oper_handle->id_output_datacube;
 	int compressed = oper_handle->compressed;
 
 	oph_odb_fragment_list *frags = ((thread_struct *) ts)->frags;
-	oph_odb_db_instance_list *dbs = ((thread_struct *) ts)->dbs;
 	oph_odb_dbms_instance_list *dbmss = ((thread_struct *) ts)->dbmss;
+	oph_sched *sched = ((thread_struct *) ts)->sched;
 
 	char *_ms = ((thread_struct *) ts)->_ms;
 
 	int res = OPH_ANALYTICS_OPERATOR_SUCCESS;
 
-	int fragxthread = (int) floor((double) (frags->size / num_threads));
-	int remainder = (int) frags->size % num_threads;
-	//Compute starting number of fragments inserted by other threads
-	unsigned int current_frag_count = l * fragxthread + (l < remainder ? l : remainder);
-
-	//Update number of fragments to be inserted
-	if (l < remainder)
-		fragxthread += 1;
-
 	char operation[OPH_COMMON_BUFFER_LEN];
 	char frag_name_out[OPH_ODB_STGE_FRAG_NAME_SIZE];
-	int n, frag_count = 0, tuplexfragment, size;
+	int n, tuplexfragment, size;
 	long long size_;
 
 	oph_ioserver_handler *server = NULL;
@@ -102,113 +94,91 @@ void *exec_thread(void *ts)
 		mysql_thread_end();
 		res = OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
 	}
-	int first_dbms, first_db, first_frag = current_frag_count;
+	oph_odb_db_instance *db = NULL;
 
-	for (first_db = 0; first_db < dbs->size && res == OPH_ANALYTICS_OPERATOR_SUCCESS; first_db++) {
-		//Find db associated to fragment
-		if (frags->value[current_frag_count].id_db == dbs->value[first_db].id_db)
-			break;
-	}
-	for (first_dbms = 0; first_dbms < dbmss->size && res == OPH_ANALYTICS_OPERATOR_SUCCESS; first_dbms++) {
-		//Find dbms associated to db
-		if (dbs->value[first_db].id_dbms == dbmss->value[first_dbms].id_dbms)
-			break;
-	}
+	//For each fragment assigned to (or stolen by) the thread
+	while ((res == OPH_ANALYTICS_OPERATOR_SUCCESS) && !oph_sched_next(sched, l, &k)) {
 
-	//For each DBMS
-	for (i = first_dbms; (i < dbmss->size) && (frag_count < fragxthread) && (res == OPH_ANALYTICS_OPERATOR_SUCCESS); i++) {
+		//Switch DBMS only when the fragment is stored elsewhere
+		if (frags->value[k].db_instance != db) {
+			if (db)
+				oph_dc_disconnect_from_dbms(server, db->dbms_instance);
+			db = frags->value[k].db_instance;
 
-		if (oph_dc_connect_to_dbms(server, &(dbmss->value[i]), 0)) {
-			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to connect to DBMS. Check access parameters.\n");
-			logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_AGGREGATE2_DBMS_CONNECTION_ERROR, (dbmss->value[i]).id_dbms);
-			oph_dc_disconnect_from_dbms(server, &(dbmss->value[i]));
-			oph_dc_cleanup_dbms(server);
-			mysql_thread_end();
-			res = OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
-			break;
-		}
-
-
-		if (oph_dc_use_db_of_dbms(server, &(dbmss->value[i]), &(dbs->value[i]))) {
-			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to use the DB. Check access parameters.\n");
-			logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_AGGREGATE2_DB_SELECTION_ERROR, (dbs->value[i]).db_name);
-			res = OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
-			break;
-		}
-		//For each fragment
-		for (k = first_frag; (k < frags->size) && (frag_count < fragxthread) && (res == OPH_ANALYTICS_OPERATOR_SUCCESS); k++) {
-			//Check Fragment - DB Association
-			if (frags->value[k].db_instance != &(dbs->value[i]))
-				continue;
-
-			tuplexfragment = frags->value[k].key_end - frags->value[k].key_start + 1;	// Under the assumption that IDs are consecutive without any holes
-
-			size = oper_handle->size * oper_handle->block_size;
-			if (frags->value[k].key_end && !counters) {
-				if (tuplexfragment < size) {
-					pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_LOG_OPH_AGGREGATE2_TUPLES_CONSTRAINT_FAILED, size, tuplexfragment);
-					logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_AGGREGATE2_TUPLES_CONSTRAINT_FAILED, size, tuplexfragment);
-					res = OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
-					break;
-				} else if (tuplexfragment % size) {
-					pmesg(LOG_ERROR, __FILE__, __LINE__, "This dimension cannot be aggregated; try to merge fragments before aggregation\n");
-					logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_AGGREGATE2_TUPLES_CONSTRAINT_FAILED2);
-					res = OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
-					break;
-				}
+			if (oph_dc_connect_to_dbms(server, db->dbms_instance, 0)) {
+				pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to connect to DBMS. Check access parameters.\n");
+				logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_AGGREGATE2_DBMS_CONNECTION_ERROR, db->dbms_instance->id_dbms);
+				res = OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
+				break;
 			}
-			size = oper_handle->size;
 
-			if (oph_dc_generate_fragment_name(NULL, id_datacube_out, proc_rank, (current_frag_count + frag_count + 1), &frag_name_out)) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Size of frag name exceed limit.\n");
-				logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_AGGREGATE2_STRING_BUFFER_OVERFLOW, "fragment name", frag_name_out);
-				res = OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
+			if (oph_dc_use_db_of_dbms(server, db->dbms_instance, db)) {
+				pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to use the DB. Check access parameters.\n");
+				logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_AGGREGATE2_DB_SELECTION_ERROR, db->db_name);
+				res = OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
 				break;
 			}
-			//AGGREGATE2 mysql plugin
-			if (compressed)
-				n = snprintf(operation, OPH_COMMON_BUFFER_LEN, OPH_AGGREGATE2_PLUGIN_COMPR, oper_handle->measure_type,
-					     oper_handle->measure_type, MYSQL_FRAG_MEASURE, oper_handle->operation, _ms);
-			else
-				n = snprintf(operation, OPH_COMMON_BUFFER_LEN, OPH_AGGREGATE2_PLUGIN, oper_handle->measure_type,
-					     oper_handle->measure_type, MYSQL_FRAG_MEASURE, oper_handle->operation, _ms);
-			if (n >= OPH_COMMON_BUFFER_LEN) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "MySQL operation name exceed limit.\n");
-				logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_AGGREGATE2_STRING_BUFFER_OVERFLOW, "MySQL operation name", operation);
+		}
+
+		tuplexfragment = frags->value[k].key_end - frags->value[k].key_start + 1;	// Under the assumption that IDs are consecutive without any holes
+
+		size = oper_handle->size * oper_handle->block_size;
+		if (frags->value[k].key_end && !counters) {
+			if (tuplexfragment < size) {
+				pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_LOG_OPH_AGGREGATE2_TUPLES_CONSTRAINT_FAILED, size, tuplexfragment);
+				logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_AGGREGATE2_TUPLES_CONSTRAINT_FAILED, size, tuplexfragment);
 				res = OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
 				break;
-			}
-			//AGGREGATE2 fragment
-			size_ = oper_handle->size;
-			if (oph_dc_create_fragment_from_query_with_aggregation2
-			    (server, &(frags->value[k]), frag_name_out, operation, 0, &size_, 0, &(oper_handle->block_size), oper_handle->sizes, oper_handle->size_num * sizeof(long long))) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to insert new fragment.\n");
-				logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_AGGREGATE2_NEW_FRAG_ERROR, frag_name_out);
-				res = OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
+			} else if (tuplexfragment % size) {
+				pmesg(LOG_ERROR, __FILE__, __LINE__, "This dimension cannot be aggregated; try to merge fragments before aggregation\n");
+				logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_AGGREGATE2_TUPLES_CONSTRAINT_FAILED2);
+				res = OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
 				break;
 			}
-			//Change fragment fields
-			frags->value[k].id_datacube = id_datacube_out;
-			strncpy(frags->value[k].fragment_name, frag_name_out, OPH_ODB_STGE_FRAG_NAME_SIZE);
-			frags->value[k].fragment_name[OPH_ODB_STGE_FRAG_NAME_SIZE] = 0;
-			if (frags->value[k].key_end) {
-				frags->value[k].key_start = 1 + (frags->value[k].key_start - 1) / size;
-				frags->value[k].key_end = 1 + (frags->value[k].key_end - 1) / size;
-			}
-			frag_count++;
 		}
+		size = oper_handle->size;
 
-		oph_dc_disconnect_from_dbms(server, &(dbmss->value[i]));
-
-		if (res != OPH_ANALYTICS_OPERATOR_SUCCESS) {
-			oph_dc_cleanup_dbms(server);
-			mysql_thread_end();
+		if (oph_dc_generate_fragment_name(NULL, id_datacube_out, proc_rank, k + 1, &frag_name_out)) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Size of frag name exceed limit.\n");
+			logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_AGGREGATE2_STRING_BUFFER_OVERFLOW, "fragment name", frag_name_out);
+			res = OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
+			break;
+		}
+		//AGGREGATE2 mysql plugin
+		if (compressed)
+			n = snprintf(operation, OPH_COMMON_BUFFER_LEN, OPH_AGGREGATE2_PLUGIN_COMPR, oper_handle->measure_type,
+				     oper_handle->measure_type, MYSQL_FRAG_MEASURE, oper_handle->operation, _ms);
+		else
+			n = snprintf(operation, OPH_COMMON_BUFFER_LEN, OPH_AGGREGATE2_PLUGIN, oper_handle->measure_type,
+				     oper_handle->measure_type, MYSQL_FRAG_MEASURE, oper_handle->operation, _ms);
+		if (n >= OPH_COMMON_BUFFER_LEN) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "MySQL operation name exceed limit.\n");
+			logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_AGGREGATE2_STRING_BUFFER_OVERFLOW, "MySQL operation name", operation);
+			res = OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
+			break;
+		}
+		//AGGREGATE2 fragment
+		size_ = oper_handle->size;
+		if (oph_dc_create_fragment_from_query_with_aggregation2
+		    (server, &(frags->value[k]), frag_name_out, operation, 0, &size_, 0, &(oper_handle->block_size), oper_handle->sizes, oper_handle->size_num * sizeof(long long))) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to insert new fragment.\n");
+			logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_AGGREGATE2_NEW_FRAG_ERROR, frag_name_out);
+			res = OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
+			break;
+		}
+		//Change fragment fields
+		frags->value[k].id_datacube = id_datacube_out;
+		strncpy(frags->value[k].fragment_name, frag_name_out, OPH_ODB_STGE_FRAG_NAME_SIZE);
+		frags->value[k].fragment_name[OPH_ODB_STGE_FRAG_NAME_SIZE] = 0;
+		if (frags->value[k].key_end) {
+			frags->value[k].key_start = 1 + (frags->value[k].key_start - 1) / size;
+			frags->value[k].key_end = 1 + (frags->value[k].key_end - 1) / size;
 		}
-		//Update fragment counter
-		first_frag = current_frag_count + frag_count;
 	}
 
-	if (res == OPH_ANALYTICS_OPERATOR_SUCCESS) {
+	if (server) {
+		if (db)
+			oph_dc_disconnect_from_dbms(server, db->dbms_instance);
 		oph_dc_cleanup_dbms(server);
 		mysql_thread_end();
 	}
@@ -1025,12 +995,31 @@ int task_init(oph_operator_struct * handle)
 					}
 					char *dim_row2 = (char *) malloc(cubedims[l].size * size);
 
+					oph_dim_time_index time_index;
+					if (oph_dim_time_index_create(dim_row, cubedims[l].size, dim + l, &time_index)) {
+						pmesg(LOG_ERROR, __FILE__, __LINE__, "Error in evaluating reduction groups.\n");
+						logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_AGGREGATE2_operator_handle *) handle->operator_handle)->id_input_container,
+							OPH_LOG_OPH_AGGREGATE2_DIM_CHECK_ERROR);
+						if (dim_row)
+							free(dim_row);
+						if (dim_row2)
+							free(dim_row2);
+						oph_dim_disconnect_from_dbms(db->dbms_instance);
+						oph_dim_unload_dim_dbinstance(db);
+						free(cubedims);
+						if (stored_dims)
+							free(stored_dims);
+						if (stored_dim_insts)
+							free(stored_dim_insts);
+						goto __OPH_EXIT_1;
+					}
+
 					struct tm tm_prev;
 					memset(&tm_prev, 0, sizeof(struct tm));
 					tm_prev.tm_year = -1;
 					for (prev_kk = kk = 0; kk < cubedims[l].size; ++kk) {
-						if (oph_dim_is_in_time_group_of
-						    (dim_row, kk, dim + l, concept_level_out, &tm_prev, ((OPH_AGGREGATE2_operator_handle *) handle->operator_handle)->midnight, 0, &flag)) {
+						if (oph_dim_time_index_is_in_group_of
+						    (&time_index, dim_row, kk, dim + l, concept_level_out, &tm_prev, ((OPH_AGGREGATE2_operator_handle *) handle->operator_handle)->midnight, 0, &flag)) {
 							pmesg(LOG_ERROR, __FILE__, __LINE__, "Error in evaluating reduction groups.\n");
 							logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_AGGREGATE2_operator_handle *) handle->operator_handle)->id_input_container,
 								OPH_LOG_OPH_AGGREGATE2_DIM_CHECK_ERROR);
@@ -1038,6 +1027,7 @@ int task_init(oph_operator_struct * handle)
 								free(dim_row);
 							if (dim_row2)
 								free(dim_row2);
+							oph_dim_time_index_free(&time_index);
 							oph_dim_disconnect_from_dbms(db->dbms_instance);
 							oph_dim_unload_dim_dbinstance(db);
 							free(cubedims);
@@ -1058,6 +1048,7 @@ int task_init(oph_operator_struct * handle)
 										free(dim_row);
 									if (dim_row2)
 										free(dim_row2);
+									oph_dim_time_index_free(&time_index);
 									oph_dim_disconnect_from_dbms(db->dbms_instance);
 									oph_dim_unload_dim_dbinstance(db);
 									free(cubedims);
@@ -1077,6 +1068,7 @@ int task_init(oph_operator_struct * handle)
 							sizes[new_size]++;
 						value[new_size] = new_size;
 					}
+					oph_dim_time_index_free(&time_index);
 					if (oph_dim_update_value(dim_row, dim[l].dimension_type, prev_kk, kk - 1)) {
 						pmesg(LOG_ERROR, __FILE__, __LINE__, "Error in evaluating reduction groups.\n");
 						logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_AGGREGATE2_operator_handle *) handle->operator_handle)->id_input_container,
@@ -1341,17 +1333,15 @@ int task_init(oph_operator_struct * handle)
 			goto __OPH_EXIT_1;
 		}
 		//Write new cube - dimension relation rows
-		for (l = 0; l < number_of_dimensions; l++) {
-			//Change iddatacube in cubehasdim
+		//Change iddatacube in cubehasdim
+		for (l = 0; l < number_of_dimensions; l++)
 			cubedims[l].id_datacube = ((OPH_AGGREGATE2_operator_handle *) handle->operator_handle)->id_output_datacube;
-
-			if (oph_odb_cube_insert_into_cubehasdim_table(oDB, &(cubedims[l]), &last_insertd_id)) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to insert datacube - dimension relations.\n");
-				logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_AGGREGATE2_operator_handle *) handle->operator_handle)->id_input_container,
-					OPH_LOG_OPH_AGGREGATE2_CUBEHASDIM_INSERT_ERROR);
-				free(cubedims);
-				goto __OPH_EXIT_1;
-			}
+		if (oph_odb_cube_insert_into_cubehasdim_table2(oDB, cubedims, number_of_dimensions)) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to insert datacube - dimension relations.\n");
+			logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_AGGREGATE2_operator_handle *) handle->operator_handle)->id_input_container,
+				OPH_LOG_OPH_AGGREGATE2_CUBEHASDIM_INSERT_ERROR);
+			free(cubedims);
+			goto __OPH_EXIT_1;
 		}
 		free(cubedims);
 
@@ -1640,6 +1630,18 @@ int task_execute(oph_operator_struct * handle)
 		return OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
 	}
 
+	oph_sched sched;
+	if (oph_sched_init(&sched, frags.size, num_threads, oper_handle->schedule_algo == OPH_SCHED_DYNAMIC)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_LOG_OPH_AGGREGATE2_SCHEDULER_INIT_ERROR);
+		logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_AGGREGATE2_SCHEDULER_INIT_ERROR);
+		oph_odb_stge_free_fragment_list(&frags);
+		oph_odb_stge_free_db_list(&dbs);
+		oph_odb_stge_free_dbms_list(&dbmss);
+		oph_odb_free_ophidiadb_thread(&oDB_slave);
+		mysql_thread_end();
+		return OPH_ANALYTICS_OPERATOR_MEMORY_ERR;
+	}
+
 	pthread_t threads[num_threads];
 	pthread_attr_t attr;
 	pthread_attr_init(&attr);
@@ -1657,6 +1659,7 @@ int task_execute(oph_operator_struct * handle)
 		ts[l].frags = &frags;
 		ts[l].dbs = &dbs;
 		ts[l].dbmss = &dbmss;
+		ts[l].sched = &sched;
 		ts[l]._ms = _ms;
 
 		rc = pthread_create(&threads[l], &attr, exec_thread, (void *) &(ts[l]));
@@ -1678,6 +1681,7 @@ int task_execute(oph_operator_struct * handle)
 		}
 	}
 
+	oph_sched_free(&sched);
 	oph_odb_stge_free_db_list(&dbs);
 	oph_odb_stge_free_dbms_list(&dbmss);
 
@@ -45,6 +45,7 @@
 #include "oph_log_error_codes.h"
 #include "oph_datacube_library.h"
 #include "oph_driver_procedure_library.h"
+#include "oph_scheduler_library.h"
 
 #include <pthread.h>
 
@@ -86,6 +87,8 @@ struct _thread_struct {
 	oph_odb_fragment_list *frags;
 	oph_odb_db_instance_list *dbs;
 	oph_odb_dbms_instance_list *dbmss;
+	oph_sched *sched;
+	char **cached;
 };
 typedef struct _thread_struct thread_struct;
 
@@ -94,30 +97,21 @@ void *exec_thread(void *ts)
 
 	OPH_APPLY_operator_handle *oper_handle = ((thread_struct *) ts)->oper_handle;
 	int l = ((thread_struct *) ts)->current_thread;
-	int num_threads = ((thread_struct *) ts)->total_threads;
 	int proc_rank = ((thread_struct *) ts)->proc_rank;
 
 	int id_datacube_out = oper_handle->id_output_datacube;
 	char *array_operation = oper_handle->array_operation;
 
 	oph_odb_fragment_list *frags = ((thread_struct *) ts)->frags;
-	oph_odb_db_instance_list *dbs = ((thread_struct *) ts)->dbs;
 	oph_odb_dbms_instance_list *dbmss = ((thread_struct *) ts)->dbmss;
+	oph_sched *sched = ((thread_struct *) ts)->sched;
+	char **cached = ((thread_struct *) ts)->cached;
 
-	int i, k;
+	int k;
 	int res = OPH_ANALYTICS_OPERATOR_SUCCESS;
 
-	int fragxthread = (int) floor((double) (frags->size / num_threads));
-	int remainder = (int) frags->size % num_threads;
-	//Compute starting number of fragments inserted by other threads
-	unsigned int current_frag_count = l * fragxthread + (l < remainder ? l : remainder);
-
-	//Update number of fragments to be inserted
-	if (l < remainder)
-		fragxthread += 1;
-
 	char frag_name_out[OPH_ODB_STGE_FRAG_NAME_SIZE];
-	int frag_count = 0, first = 1, tuplexfragment;
+	int tuplexfragment;
 	int size = oper_handle->expl_size;
 	long long size_;
 
@@ -128,136 +122,122 @@ void *exec_thread(void *ts)
 		mysql_thread_end();
 		res = OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
 	}
-	int first_dbms, first_db, first_frag = current_frag_count;
+	oph_odb_db_instance *db = NULL;
 
-	for (first_db = 0; first_db < dbs->size && res == OPH_ANALYTICS_OPERATOR_SUCCESS; first_db++) {
-		//Find db associated to fragment
-		if (frags->value[current_frag_count].id_db == dbs->value[first_db].id_db)
-			break;
-	}
-	for (first_dbms = 0; first_dbms < dbmss->size && res == OPH_ANALYTICS_OPERATOR_SUCCESS; first_dbms++) {
-		//Find dbms associated to db
-		if (dbs->value[first_db].id_dbms == dbmss->value[first_dbms].id_dbms)
-			break;
-	}
+	//For each fragment assigned to (or stolen by) the thread
+	while ((res == OPH_ANALYTICS_OPERATOR_SUCCESS) && !oph_sched_next(sched, l, &k)) {
 
-	//For each DBMS
-	for (i = first_dbms; (i < dbmss->size) && (frag_count < fragxthread) && (res == OPH_ANALYTICS_OPERATOR_SUCCESS); i++) {
+		//Switch DBMS only when the fragment is stored elsewhere
+		if (frags->value[k].db_instance != db) {
+			if (db)
+				oph_dc_disconnect_from_dbms(server, db->dbms_instance);
+			db = frags->value[k].db_instance;
 
-		if (oph_dc_connect_to_dbms(server, &(dbmss->value[i]), 0)) {
-			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to connect to DBMS. Check access parameters.\n");
-			logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_APPLY_DBMS_CONNECTION_ERROR, (dbmss->value[i]).id_dbms);
-			oph_dc_disconnect_from_dbms(server, &(dbmss->value[i]));
-			oph_dc_cleanup_dbms(server);
-			mysql_thread_end();
-			res = OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
-			break;
-		}
+			if (oph_dc_connect_to_dbms(server, db->dbms_instance, 0)) {
+				pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to connect to DBMS. Check access parameters.\n");
+				logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_APPLY_DBMS_CONNECTION_ERROR, db->dbms_instance->id_dbms);
+				res = OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
+				break;
+			}
 
-		if (oph_dc_use_db_of_dbms(server, &(dbmss->value[i]), &(dbs->value[i]))) {
-			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to use the DB. Check access parameters.\n");
-			logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_APPLY_DB_SELECTION_ERROR, (dbs->value[i]).db_name);
-			res = OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
-			break;
+			if (oph_dc_use_db_of_dbms(server, db->dbms_instance, db)) {
+				pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to use the DB. Check access parameters.\n");
+				logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_APPLY_DB_SELECTION_ERROR, db->db_name);
+				res = OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
+				break;
+			}
 		}
-		//For each fragment
-		for (k = first_frag; (k < frags->size) && (frag_count < fragxthread) && (res == OPH_ANALYTICS_OPERATOR_SUCCESS); k++) {
-			//Check Fragment - DB Association
-			if (frags->value[k].db_instance != &(dbs->value[i]))
-				continue;
 
-			if (oper_handle->expl_size_update) {
-				tuplexfragment = frags->value[k].key_end - frags->value[k].key_start + 1;	// Under the assumption that IDs are consecutive without any holes
-				if (frags->value[k].key_end && ((tuplexfragment < size) || (tuplexfragment % size))) {
-					pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_LOG_OPH_APPLY_TUPLES_CONSTRAINT_FAILED, size, tuplexfragment);
-					logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_APPLY_TUPLES_CONSTRAINT_FAILED, size, tuplexfragment);
-					res = OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
-					break;
-				}
+		if (oper_handle->expl_size_update) {
+			tuplexfragment = frags->value[k].key_end - frags->value[k].key_start + 1;	// Under the assumption that IDs are consecutive without any holes
+			if (frags->value[k].key_end && ((tuplexfragment < size) || (tuplexfragment % size))) {
+				pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_LOG_OPH_APPLY_TUPLES_CONSTRAINT_FAILED, size, tuplexfragment);
+				logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_APPLY_TUPLES_CONSTRAINT_FAILED, size, tuplexfragment);
+				res = OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
+				break;
 			}
+		}
 
-			if (oph_dc_generate_fragment_name(NULL, id_datacube_out, proc_rank, (current_frag_count + frag_count + 1), &frag_name_out)) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Size of frag  name exceed limit.\n");
-				logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_APPLY_STRING_BUFFER_OVERFLOW, "fragment name", frag_name_out);
+		if (oph_dc_generate_fragment_name(NULL, id_datacube_out, proc_rank, k + 1, &frag_name_out)) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Size of frag  name exceed limit.\n");
+			logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_APPLY_STRING_BUFFER_OVERFLOW, "fragment name", frag_name_out);
+			res = OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
+			break;
+		}
+		//Apply operation to fragment
+		size_ = size;
+		if (cached && cached[k] && !oph_dc_create_fragment_from_copy(server, &(frags->value[k]), frag_name_out, cached[k]))
+			pmesg(LOG_DEBUG, __FILE__, __LINE__, "Fragment %s copied from cached fragment %s\n", frag_name_out, cached[k]);
+		else if (oper_handle->num_reference_to_dim && oper_handle->array_values && oper_handle->array_length) {
+			if (oph_dc_create_fragment_from_query_with_params
+			    (server, &(frags->value[k]), frag_name_out, array_operation, 0,
+			     oper_handle->expl_size_update ? &size_ : 0, 0, oper_handle->array_values, oper_handle->array_length, oper_handle->num_reference_to_dim)) {
+				pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to insert new fragment.\n");
+				logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_APPLY_NEW_FRAG_ERROR, frag_name_out);
 				res = OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
 				break;
 			}
-			//Apply operation to fragment
-			size_ = size;
-			if (oper_handle->num_reference_to_dim && oper_handle->array_values && oper_handle->array_length) {
-				if (oph_dc_create_fragment_from_query_with_params
-				    (server, &(frags->value[k]), frag_name_out, array_operation, 0,
-				     oper_handle->expl_size_update ? &size_ : 0, 0, oper_handle->array_values, oper_handle->array_length, oper_handle->num_reference_to_dim)) {
-					pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to insert new fragment.\n");
-					logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_APPLY_NEW_FRAG_ERROR, frag_name_out);
-					res = OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
-					break;
-				}
-			} else if (oph_dc_create_fragment_from_query(server, &(frags->value[k]), frag_name_out, array_operation, 0, oper_handle->expl_size_update ? &size_ : 0, 0)) {
+		} else if (oper_handle->lazy) {
+			if (oph_dc_create_fragment_view_from_query(server, &(frags->value[k]), frag_name_out, array_operation, oper_handle->expl_size_update ? &size_ : 0)) {
 				pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to insert new fragment.\n");
 				logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_APPLY_NEW_FRAG_ERROR, frag_name_out);
 				res = OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
 				break;
 			}
-			//Change fragment fields
-			frags->value[k].id_datacube = id_datacube_out;
-			strncpy(frags->value[k].fragment_name, frag_name_out, OPH_ODB_STGE_FRAG_NAME_SIZE);
-			frags->value[k].fragment_name[OPH_ODB_STGE_FRAG_NAME_SIZE] = 0;
-			if (oper_handle->expl_size_update && frags->value[k].key_end) {
-				frags->value[k].key_start = 1 + (frags->value[k].key_start - 1) / size;
-				frags->value[k].key_end = 1 + (frags->value[k].key_end - 1) / size;
+		} else if (oph_dc_create_fragment_from_query(server, &(frags->value[k]), frag_name_out, array_operation, 0, oper_handle->expl_size_update ? &size_ : 0, 0)) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to insert new fragment.\n");
+			logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_APPLY_NEW_FRAG_ERROR, frag_name_out);
+			res = OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
+			break;
+		}
+		//Change fragment fields
+		frags->value[k].id_datacube = id_datacube_out;
+		strncpy(frags->value[k].fragment_name, frag_name_out, OPH_ODB_STGE_FRAG_NAME_SIZE);
+		frags->value[k].fragment_name[OPH_ODB_STGE_FRAG_NAME_SIZE] = 0;
+		if (oper_handle->expl_size_update && frags->value[k].key_end) {
+			frags->value[k].key_start = 1 + (frags->value[k].key_start - 1) / size;
+			frags->value[k].key_end = 1 + (frags->value[k].key_end - 1) / size;
+		}
+		// Extract the number of elements of resulting array - Executed only for the 1st fragment of master process
+		if (!proc_rank && !k) {
+			long long old_impl_size = oper_handle->impl_size, new_impl_size = 0;
+			if (oph_dc_get_number_of_elements_in_fragment_row(server, &(frags->value[k]), oper_handle->measure_type, oper_handle->compressed, &new_impl_size) || !new_impl_size) {
+				pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to extract the number of element of resulting rows.\n");
+				logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_APPLY_FRAGMENT_READ_ERROR);
+				res = OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
+				break;
+			}
+			if (new_impl_size != old_impl_size) {
+				oper_handle->impl_size_update = 1;
+				oper_handle->impl_size = (int) new_impl_size;
 			}
-			// Extract the number of elements of resulting array - Executed only by 1st thread of master process
-			if (!proc_rank && !l && first) {
-				long long old_impl_size = oper_handle->impl_size, new_impl_size = 0;
-				if (oph_dc_get_number_of_elements_in_fragment_row(server, &(frags->value[k]), oper_handle->measure_type, oper_handle->compressed, &new_impl_size) || !new_impl_size) {
-					pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to extract the number of element of resulting rows.\n");
-					logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_APPLY_FRAGMENT_READ_ERROR);
-					res = OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
-					break;
-				}
-				if (new_impl_size != old_impl_size) {
-					oper_handle->impl_size_update = 1;
-					oper_handle->impl_size = (int) new_impl_size;
-				}
 
-				long long new_expl_size = 0;
-				if (oph_dc_get_total_number_of_rows_in_fragment(server, &(frags->value[k]), oper_handle->measure_type, &new_expl_size) || !new_expl_size) {
-					pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to extract the number of rows of resulting fragment.\n");
-					logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_APPLY_FRAGMENT_READ_ERROR);
-					res = OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
-					break;
-				}
-				if (oper_handle->expl_size_update) {
-					if (new_expl_size != 1) {
-						pmesg(LOG_ERROR, __FILE__, __LINE__, "Indexes of fragments are corrupted.\n");
-						logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_APPLY_FRAGMENT_INDEX_ERROR);
-						res = OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
-						break;
-					}
-				} else if (oper_handle->expl_size < new_expl_size) {
-					pmesg(LOG_ERROR, __FILE__, __LINE__, "Metadata are corrupted: expl_size %lld is greater than the expected value %d\n", new_expl_size, oper_handle->expl_size);
-					logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_APPLY_METADATA_SET_ERROR);
+			long long new_expl_size = 0;
+			if (oph_dc_get_total_number_of_rows_in_fragment(server, &(frags->value[k]), oper_handle->measure_type, &new_expl_size) || !new_expl_size) {
+				pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to extract the number of rows of resulting fragment.\n");
+				logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_APPLY_FRAGMENT_READ_ERROR);
+				res = OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
+				break;
+			}
+			if (oper_handle->expl_size_update) {
+				if (new_expl_size != 1) {
+					pmesg(LOG_ERROR, __FILE__, __LINE__, "Indexes of fragments are corrupted.\n");
+					logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_APPLY_FRAGMENT_INDEX_ERROR);
 					res = OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
 					break;
 				}
-
-				first = 0;
+			} else if (oper_handle->expl_size < new_expl_size) {
+				pmesg(LOG_ERROR, __FILE__, __LINE__, "Metadata are corrupted: expl_size %lld is greater than the expected value %d\n", new_expl_size, oper_handle->expl_size);
+				logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_APPLY_METADATA_SET_ERROR);
+				res = OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
+				break;
 			}
-			frag_count++;
 		}
-
-		oph_dc_disconnect_from_dbms(server, &(dbmss->value[i]));
-
-		if (res != OPH_ANALYTICS_OPERATOR_SUCCESS) {
-			oph_dc_cleanup_dbms(server);
-			mysql_thread_end();
-		}
-		//Update fragment counter
-		first_frag = current_frag_count + frag_count;
 	}
 
-	if (res == OPH_ANALYTICS_OPERATOR_SUCCESS) {
+	if (server) {
+		if (db)
+			oph_dc_disconnect_from_dbms(server, db->dbms_instance);
 		oph_dc_cleanup_dbms(server);
 		mysql_thread_end();
 	}
@@ -990,6 +970,8 @@ int env_set(HASHTBL * task_tbl, oph_operator_struct * handle)
 	((OPH_APPLY_operator_handle *) handle->operator_handle)->description = NULL;
 	((OPH_APPLY_operator_handle *) handle->operator_handle)->execute_error = 0;
 	((OPH_APPLY_operator_handle *) handle->operator_handle)->on_reduce = 0;
+	((OPH_APPLY_operator_handle *) handle->operator_handle)->lazy = 0;
+	((OPH_APPLY_operator_handle *) handle->operator_handle)->cache = 0;
 
 	//3 - Fill struct with the correct data
 	char *datacube_in;
@@ -1279,6 +1261,24 @@ int env_set(HASHTBL * task_tbl, oph_operator_struct * handle)
 		return OPH_ANALYTICS_OPERATOR_MEMORY_ERR;
 	}
 
+	value = hashtbl_get(task_tbl, OPH_IN_PARAM_LAZY);
+	if (!value) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Missing input parameter %s\n", OPH_IN_PARAM_LAZY);
+		logging(LOG_ERROR, __FILE__, __LINE__, OPH_GENERIC_CONTAINER_ID, OPH_LOG_OPH_APPLY_MISSING_INPUT_PARAMETER, OPH_IN_PARAM_LAZY);
+		return OPH_ANALYTICS_OPERATOR_INVALID_PARAM;
+	}
+	if (!strncasecmp(value, OPH_COMMON_YES_VALUE, OPH_TP_TASKLEN))
+		((OPH_APPLY_operator_handle *) handle->operator_handle)->lazy = 1;
+
+	value = hashtbl_get(task_tbl, OPH_IN_PARAM_CACHE);
+	if (!value) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Missing input parameter %s\n", OPH_IN_PARAM_CACHE);
+		logging(LOG_ERROR, __FILE__, __LINE__, OPH_GENERIC_CONTAINER_ID, OPH_LOG_OPH_APPLY_MISSING_INPUT_PARAMETER, OPH_IN_PARAM_CACHE);
+		return OPH_ANALYTICS_OPERATOR_INVALID_PARAM;
+	}
+	if (!strncasecmp(value, OPH_COMMON_YES_VALUE, OPH_TP_TASKLEN))
+		((OPH_APPLY_operator_handle *) handle->operator_handle)->cache = 1;
+
 	return OPH_ANALYTICS_OPERATOR_SUCCESS;
 }
 
@@ -1291,11 +1291,11 @@ int task_init(oph_operator_struct * handle)
 		return OPH_ANALYTICS_OPERATOR_NULL_OPERATOR_HANDLE;
 	}
 	//For error checking
-	int pointer, stream_max_size = 9 + OPH_ODB_CUBE_FRAG_REL_INDEX_SET_SIZE + 6 * sizeof(int) + sizeof(long long) + OPH_ODB_CUBE_MEASURE_TYPE_SIZE;
+	int pointer, stream_max_size = 10 + OPH_ODB_CUBE_FRAG_REL_INDEX_SET_SIZE + 7 * sizeof(int) + sizeof(long long) + OPH_ODB_CUBE_MEASURE_TYPE_SIZE;
 	char stream[stream_max_size];
 	memset(stream, 0, sizeof(stream));
 	*stream = 0;
-	char *id_string[7], *array_length, *data_type;
+	char *id_string[8], *array_length, *data_type;
 	pointer = 0;
 	id_string[0] = stream + pointer;
 	pointer += 1 + OPH_ODB_CUBE_FRAG_REL_INDEX_SET_SIZE;
@@ -1311,6 +1311,8 @@ int task_init(oph_operator_struct * handle)
 	pointer += 1 + sizeof(int);
 	id_string[6] = stream + pointer;
 	pointer += 1 + sizeof(int);
+	id_string[7] = stream + pointer;
+	pointer += 1 + sizeof(int);
 	array_length = stream + pointer;
 	pointer += 1 + sizeof(long long);
 	data_type = stream + pointer;
@@ -1389,6 +1391,25 @@ int task_init(oph_operator_struct * handle)
 			((OPH_APPLY_operator_handle *) handle->operator_handle)->array_operation = array_operation = strdup(tmp);
 		}
 
+		// Lazy output is available only on MySQL I/O servers, since views cannot include the values of dimensions
+		if (((OPH_APPLY_operator_handle *) handle->operator_handle)->lazy) {
+			int supported = 0;
+			if (oph_odb_cube_check_lazy_support(oDB, datacube_id, &supported)) {
+				oph_odb_cube_free_datacube(&cube);
+				pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to check I/O servers storing the datacube\n");
+				logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_APPLY_operator_handle *) handle->operator_handle)->id_input_container, OPH_LOG_OPH_APPLY_DATACUBE_READ_ERROR);
+				if (old_measure)
+					free(old_measure);
+				goto __OPH_EXIT_1;
+			}
+			if (!supported || ((OPH_APPLY_operator_handle *) handle->operator_handle)->num_reference_to_dim) {
+				pmesg(LOG_WARNING, __FILE__, __LINE__, OPH_LOG_OPH_APPLY_LAZY_NOT_SUPPORTED, supported ? "for queries on dimension values" : "by I/O servers");
+				logging(LOG_WARNING, __FILE__, __LINE__, ((OPH_APPLY_operator_handle *) handle->operator_handle)->id_input_container, OPH_LOG_OPH_APPLY_LAZY_NOT_SUPPORTED,
+					supported ? "for queries on dimension values" : "by I/O servers");
+				((OPH_APPLY_operator_handle *) handle->operator_handle)->lazy = 0;
+			}
+		}
+
 		if (((OPH_APPLY_operator_handle *) handle->operator_handle)->compressed < 0)
 			((OPH_APPLY_operator_handle *) handle->operator_handle)->compressed = cube.compressed;
 		cube.compressed = ((OPH_APPLY_operator_handle *) handle->operator_handle)->compressed;
@@ -1684,6 +1705,14 @@ int task_init(oph_operator_struct * handle)
 		}
 		free(new_task.id_inputcube);
 
+		// Lazy datacubes are recorded to prevent the deletion of their input
+		if (((OPH_APPLY_operator_handle *) handle->operator_handle)->lazy
+		    && oph_odb_cube_insert_into_lazydatacube_table(oDB, ((OPH_APPLY_operator_handle *) handle->operator_handle)->id_output_datacube, ((OPH_APPLY_operator_handle *) handle->operator_handle)->id_input_datacube)) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to record lazy datacube\n");
+			logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_APPLY_operator_handle *) handle->operator_handle)->id_input_container, OPH_LOG_OPH_APPLY_LAZY_INSERT_ERROR);
+			goto __OPH_EXIT_1;
+		}
+
 		strncpy(id_string[0], ((OPH_APPLY_operator_handle *) handle->operator_handle)->fragment_ids, OPH_ODB_CUBE_FRAG_REL_INDEX_SET_SIZE);
 		memcpy(id_string[1], &((OPH_APPLY_operator_handle *) handle->operator_handle)->id_output_datacube, sizeof(int));
 		memcpy(id_string[2], &((OPH_APPLY_operator_handle *) handle->operator_handle)->compressed, sizeof(int));
@@ -1691,6 +1720,8 @@ int task_init(oph_operator_struct * handle)
 		memcpy(id_string[4], &((OPH_APPLY_operator_handle *) handle->operator_handle)->expl_size, sizeof(int));
 		memcpy(id_string[5], &((OPH_APPLY_operator_handle *) handle->operator_handle)->num_reference_to_dim, sizeof(int));
 		memcpy(id_string[6], &((OPH_APPLY_operator_handle *) handle->operator_handle)->array_operation_length, sizeof(int));
+		int lazy = ((OPH_APPLY_operator_handle *) handle->operator_handle)->lazy;
+		memcpy(id_string[7], &lazy, sizeof(int));
 		memcpy(array_length, &((OPH_APPLY_operator_handle *) handle->operator_handle)->array_length, sizeof(long long));
 
 		strncpy(data_type, ((OPH_APPLY_operator_handle *) handle->operator_handle)->measure_type, OPH_ODB_CUBE_MEASURE_TYPE_SIZE);
@@ -1725,6 +1756,7 @@ int task_init(oph_operator_struct * handle)
 		((OPH_APPLY_operator_handle *) handle->operator_handle)->expl_size = *((int *) id_string[4]);
 		((OPH_APPLY_operator_handle *) handle->operator_handle)->num_reference_to_dim = *((int *) id_string[5]);
 		((OPH_APPLY_operator_handle *) handle->operator_handle)->array_operation_length = *((int *) id_string[6]);
+		((OPH_APPLY_operator_handle *) handle->operator_handle)->lazy = *((int *) id_string[7]) ? 1 : 0;
 		((OPH_APPLY_operator_handle *) handle->operator_handle)->array_length = *((long long *) array_length);
 	}
 	// Broadcast the query
@@ -1867,6 +1899,39 @@ int task_execute(oph_operator_struct * handle)
 		mysql_thread_end();
 		return OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
 	}
+	//Look for the results of previous runs of the same query (cache errors are not fatal)
+	char *cache_key = NULL, **cached = NULL;
+	int first_index = 0, last_index = 0;
+	if (oper_handle->cache && !oper_handle->lazy && frags.size) {
+		first_index = last_index = frags.value[0].frag_relative_index;
+		for (l = 1; l < frags.size; l++) {
+			if (frags.value[l].frag_relative_index < first_index)
+				first_index = frags.value[l].frag_relative_index;
+			if (frags.value[l].frag_relative_index > last_index)
+				last_index = frags.value[l].frag_relative_index;
+		}
+		if (oph_dc_build_cache_key
+		    ("OPH_APPLY", oper_handle->array_operation, oper_handle->num_reference_to_dim ? oper_handle->array_values : NULL,
+		     oper_handle->num_reference_to_dim ? oper_handle->array_length : 0, &cache_key))
+			pmesg(LOG_WARNING, __FILE__, __LINE__, "Unable to build cache key: results will not be cached\n");
+		else if (oph_odb_stge_retrieve_cached_fragments(&oDB_slave, oper_handle->id_input_datacube, cache_key, &frags, &cached))
+			pmesg(LOG_WARNING, __FILE__, __LINE__, "Unable to retrieve cached fragments: all fragments will be computed\n");
+	}
+
+	oph_sched sched;
+	if (oph_sched_init(&sched, frags.size, num_threads, oper_handle->schedule_algo == OPH_SCHED_DYNAMIC)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_LOG_OPH_APPLY_SCHEDULER_INIT_ERROR);
+		logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_APPLY_SCHEDULER_INIT_ERROR);
+		oph_odb_stge_free_cached_fragments(cached, frags.size);
+		if (cache_key)
+			free(cache_key);
+		oph_odb_stge_free_fragment_list(&frags);
+		oph_odb_stge_free_db_list(&dbs);
+		oph_odb_stge_free_dbms_list(&dbmss);
+		oph_odb_free_ophidiadb_thread(&oDB_slave);
+		mysql_thread_end();
+		return OPH_ANALYTICS_OPERATOR_MEMORY_ERR;
+	}
 
 	pthread_t threads[num_threads];
 	pthread_attr_t attr;
@@ -1884,6 +1949,8 @@ int task_execute(oph_operator_struct * handle)
 		ts[l].frags = &frags;
 		ts[l].dbs = &dbs;
 		ts[l].dbmss = &dbmss;
+		ts[l].sched = &sched;
+		ts[l].cached = cached;
 
 		rc = pthread_create(&threads[l], &attr, exec_thread, (void *) &(ts[l]));
 		if (rc) {
@@ -1904,20 +1971,36 @@ int task_execute(oph_operator_struct * handle)
 		}
 	}
 
+	oph_sched_free(&sched);
 	oph_odb_stge_free_db_list(&dbs);
 	oph_odb_stge_free_dbms_list(&dbmss);
+	oph_odb_stge_free_cached_fragments(cached, frags.size);
 
 	//Insert new fragment
 	if (oph_odb_stge_insert_into_fragment_table2(&oDB_slave, frags.value, frags.size)) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to update fragment table.\n");
 		logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, "Unable to update fragment table.\n");
 		oper_handle->execute_error = 1;
+		if (cache_key)
+			free(cache_key);
 		oph_odb_stge_free_fragment_list(&frags);
 		oph_odb_free_ophidiadb_thread(&oDB_slave);
 		mysql_thread_end();
 		return OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
 	}
 
+	for (l = 0; l < num_threads; l++)
+		if (res[l] != OPH_ANALYTICS_OPERATOR_SUCCESS)
+			break;
+
+	//Record new fragments as results of the query
+	if (cache_key) {
+		if ((l == num_threads)
+		    && oph_odb_stge_insert_into_fragmentcache_table(&oDB_slave, oper_handle->id_input_datacube, oper_handle->id_output_datacube, cache_key, first_index, last_index))
+			pmesg(LOG_WARNING, __FILE__, __LINE__, "Unable to update fragment cache\n");
+		free(cache_key);
+	}
+
 	oph_odb_stge_free_fragment_list(&frags);
 	oph_odb_free_ophidiadb_thread(&oDB_slave);
 	mysql_thread_end();
@@ -1948,7 +2031,7 @@ int task_reduce(oph_operator_struct * handle)
 		int datacube_id = ((OPH_APPLY_operator_handle *) handle->operator_handle)->id_input_datacube;
 
 		oph_odb_cubehasdim *cubedims = NULL;
-		int l, number_of_dimensions = 0, last_insertd_id = 0, first = -1, reduced_impl_dim = -1, reduced_expl_dim = -1;
+		int l, number_of_dimensions = 0, first = -1, reduced_impl_dim = -1, reduced_expl_dim = -1;
 		int size = ((OPH_APPLY_operator_handle *) handle->operator_handle)->impl_size, residual_size = ((OPH_APPLY_operator_handle *) handle->operator_handle)->expl_size;
 
 		//Read old cube - dimension relation rows
@@ -2243,15 +2326,14 @@ int task_reduce(oph_operator_struct * handle)
 		oph_dim_disconnect_from_dbms(db->dbms_instance);
 		oph_dim_unload_dim_dbinstance(db);
 
-		for (l = 0; l < number_of_dimensions; l++) {
-			//Change iddatacube in cubehasdim
+		//Change iddatacube in cubehasdim
+		for (l = 0; l < number_of_dimensions; l++)
 			cubedims[l].id_datacube = ((OPH_APPLY_operator_handle *) handle->operator_handle)->id_output_datacube;
-			if (oph_odb_cube_insert_into_cubehasdim_table(oDB, &(cubedims[l]), &last_insertd_id)) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to insert datacube - dimension relations.\n");
-				logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_APPLY_operator_handle *) handle->operator_handle)->id_input_container, OPH_LOG_OPH_APPLY_CUBEHASDIM_INSERT_ERROR);
-				free(cubedims);
-				return OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
-			}
+		if (oph_odb_cube_insert_into_cubehasdim_table2(oDB, cubedims, number_of_dimensions)) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to insert datacube - dimension relations.\n");
+			logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_APPLY_operator_handle *) handle->operator_handle)->id_input_container, OPH_LOG_OPH_APPLY_CUBEHASDIM_INSERT_ERROR);
+			free(cubedims);
+			return OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
 		}
 		free(cubedims);
 
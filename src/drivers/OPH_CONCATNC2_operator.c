@@ -1743,15 +1743,13 @@ int task_init(oph_operator_struct * handle)
 		oph_odb_cube_free_datacube(&cube);
 
 		//Write new cube - dimension relation rows
-		for (l = 0; l < number_of_dimensions; l++) {
-			//Change iddatacube in cubehasdim
+		//Change iddatacube in cubehasdim
+		for (l = 0; l < number_of_dimensions; l++)
 			cubedims[l].id_datacube = ((OPH_CONCATNC2_operator_handle *) handle->operator_handle)->id_output_datacube;
-
-			if (oph_odb_cube_insert_into_cubehasdim_table(oDB, &(cubedims[l]), &last_insertd_id)) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to insert datacube - dimension relations.\n");
-				logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_CONCATNC2_operator_handle *) handle->operator_handle)->id_input_container, OPH_LOG_OPH_CONCATNC_CUBEHASDIM_INSERT_ERROR);
-				goto __OPH_EXIT_1;
-			}
+		if (oph_odb_cube_insert_into_cubehasdim_table2(oDB, cubedims, number_of_dimensions)) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to insert datacube - dimension relations.\n");
+			logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_CONCATNC2_operator_handle *) handle->operator_handle)->id_input_container, OPH_LOG_OPH_CONCATNC_CUBEHASDIM_INSERT_ERROR);
+			goto __OPH_EXIT_1;
 		}
 
 		free(cubedims);
@@ -1579,15 +1579,13 @@ int task_init(oph_operator_struct * handle)
 		oph_odb_cube_free_datacube(&cube);
 
 		//Write new cube - dimension relation rows
-		for (l = 0; l < number_of_dimensions; l++) {
-			//Change iddatacube in cubehasdim
+		//Change iddatacube in cubehasdim
+		for (l = 0; l < number_of_dimensions; l++)
 			cubedims[l].id_datacube = ((OPH_CONCATNC_operator_handle *) handle->operator_handle)->id_output_datacube;
-
-			if (oph_odb_cube_insert_into_cubehasdim_table(oDB, &(cubedims[l]), &last_insertd_id)) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to insert datacube - dimension relations.\n");
-				logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_CONCATNC_operator_handle *) handle->operator_handle)->id_input_container, OPH_LOG_OPH_CONCATNC_CUBEHASDIM_INSERT_ERROR);
-				goto __OPH_EXIT_1;
-			}
+		if (oph_odb_cube_insert_into_cubehasdim_table2(oDB, cubedims, number_of_dimensions)) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to insert datacube - dimension relations.\n");
+			logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_CONCATNC_operator_handle *) handle->operator_handle)->id_input_container, OPH_LOG_OPH_CONCATNC_CUBEHASDIM_INSERT_ERROR);
+			goto __OPH_EXIT_1;
 		}
 
 		free(cubedims);
@@ -1874,6 +1872,8 @@ int task_execute(oph_operator_struct * handle)
 
 	char frag_name_out[OPH_ODB_STGE_FRAG_NAME_SIZE];
 	int result = OPH_ANALYTICS_OPERATOR_SUCCESS, frag_count = 0;
+	oph_odb_batch frag_batch;
+	oph_odb_batch_init(&frag_batch, MYSQL_QUERY_STGE_UPDATE_OPHIDIADB_FRAG2);
 	oph_odb_fragment tmp_frag;
 	char fragment_name[OPH_ODB_STGE_FRAG_NAME_SIZE];
 
@@ -1938,8 +1938,8 @@ int task_execute(oph_operator_struct * handle)
 					result = OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
 					break;
 				}
-				//Insert new fragment
-				if (oph_odb_stge_insert_into_fragment_table(&oDB_slave, &tmp_frag)) {
+				//Collect new fragment
+				if (oph_odb_stge_add_fragment_to_batch(&frag_batch, &tmp_frag)) {
 					pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to update fragment table.\n");
 					logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_CONCATNC_FRAGMENT_INSERT_ERROR, frag_name_out);
 					result = OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
@@ -1950,6 +1950,14 @@ int task_execute(oph_operator_struct * handle)
 		}
 		oph_dc_disconnect_from_dbms(oper_handle->server, &(dbmss.value[i]));
 	}
+	//Insert all new fragments
+	if ((result == OPH_ANALYTICS_OPERATOR_SUCCESS) && oph_odb_batch_execute(&oDB_slave, &frag_batch)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to update fragment table.\n");
+		logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, "Unable to update fragment table.\n");
+		result = OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
+	}
+	oph_odb_batch_free(&frag_batch);
+
 	if (oph_dc_cleanup_dbms(oper_handle->server)) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to finalize IO server.\n");
 		logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_CONCATNC_IOPLUGIN_CLEANUP_ERROR, (dbmss.value[0]).id_dbms);
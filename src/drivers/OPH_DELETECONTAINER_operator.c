@@ -289,6 +289,13 @@ int task_execute(oph_operator_struct * handle)
 	if (oph_odb_fs_check_if_container_empty(oDB, id_container)) {
 		//If input container is not empty, check if it can be emptied out
 		if (oper_handle->force) {
+			//Check if datacubes are the input of lazy datacubes stored in other containers
+			int lazy_number = 0;
+			if (oph_odb_cube_count_lazy_datacubes(oDB, 0, id_container, &lazy_number) || lazy_number) {
+				pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_LOG_OPH_DELETECONTAINER_LAZY_DATACUBE_ERROR, lazy_number);
+				logging(LOG_ERROR, __FILE__, __LINE__, id_container, OPH_LOG_OPH_DELETECONTAINER_LAZY_DATACUBE_ERROR, lazy_number);
+				return OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
+			}
 			//Get list of id of datacubes belonging to the container
 			MYSQL_RES *info_list = NULL;
 			int num_rows = 0;
@@ -152,6 +152,7 @@ int env_set(HASHTBL * task_tbl, oph_operator_struct * handle)
 		char *uri = NULL;
 		int folder_id = 0;
 		int permission = 0;
+		int lazy_number = 0;
 		if (oph_pid_parse_pid(datacube_name, &id_datacube_in[1], &id_datacube_in[0], &uri)) {
 			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to parse the PID string\n");
 			logging(LOG_ERROR, __FILE__, __LINE__, id_datacube_in[1], OPH_LOG_OPH_DELETE_PID_ERROR, datacube_name);
@@ -178,6 +179,12 @@ int env_set(HASHTBL * task_tbl, oph_operator_struct * handle)
 			logging(LOG_ERROR, __FILE__, __LINE__, id_datacube_in[1], OPH_LOG_OPH_DELETE_DATACUBE_PERMISSION_ERROR, username);
 			id_datacube_in[0] = 0;
 			id_datacube_in[1] = 0;
+		} else if ((oph_odb_cube_count_lazy_datacubes(oDB, id_datacube_in[0], 0, &lazy_number)) || lazy_number) {
+			//Check if datacube is the input of lazy datacubes
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Datacube is the input of %d lazy datacubes\n", lazy_number);
+			logging(LOG_ERROR, __FILE__, __LINE__, id_datacube_in[1], OPH_LOG_OPH_DELETE_LAZY_DATACUBE_ERROR, datacube_name, lazy_number);
+			id_datacube_in[0] = 0;
+			id_datacube_in[1] = 0;
 		}
 		if (uri)
 			free(uri);
@@ -576,16 +576,14 @@ int task_init(oph_operator_struct * handle)
 			oph_dim_unload_dim_dbinstance(db);
 		}
 		//Write new cube - dimension relation rows
-		for (l = 0; l < number_of_dimensions; l++) {
-			//Change iddatacube in cubehasdim
+		//Change iddatacube in cubehasdim
+		for (l = 0; l < number_of_dimensions; l++)
 			cubedims[l].id_datacube = ((OPH_DRILLDOWN_operator_handle *) handle->operator_handle)->id_output_datacube;
-
-			if (oph_odb_cube_insert_into_cubehasdim_table(oDB, &(cubedims[l]), &last_insertd_id)) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to insert datacube - dimension relations.\n");
-				logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_DRILLDOWN_operator_handle *) handle->operator_handle)->id_input_container, OPH_LOG_OPH_DRILLDOWN_CUBEHASDIM_INSERT_ERROR);
-				free(cubedims);
-				goto __OPH_EXIT_1;
-			}
+		if (oph_odb_cube_insert_into_cubehasdim_table2(oDB, cubedims, number_of_dimensions)) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to insert datacube - dimension relations.\n");
+			logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_DRILLDOWN_operator_handle *) handle->operator_handle)->id_input_container, OPH_LOG_OPH_DRILLDOWN_CUBEHASDIM_INSERT_ERROR);
+			free(cubedims);
+			goto __OPH_EXIT_1;
 		}
 		free(cubedims);
 
@@ -788,6 +786,8 @@ int task_execute(oph_operator_struct * handle)
 	char operation[OPH_COMMON_BUFFER_LEN];
 	char frag_name_out[OPH_ODB_STGE_FRAG_NAME_SIZE];
 	int n, result = OPH_ANALYTICS_OPERATOR_SUCCESS, frag_count = 0;
+	oph_odb_batch frag_batch;
+	oph_odb_batch_init(&frag_batch, MYSQL_QUERY_STGE_UPDATE_OPHIDIADB_FRAG2);
 
 	if (oph_dc_setup_dbms(&(((OPH_DRILLDOWN_operator_handle *) handle->operator_handle)->server), (dbmss.value[0]).io_server_type)) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to initialize IO server.\n");
@@ -861,8 +861,8 @@ int task_execute(oph_operator_struct * handle)
 				frags.value[k].key_start = (frags.value[k].key_start - 1) * ((OPH_DRILLDOWN_operator_handle *) handle->operator_handle)->outer_size + 1;
 				frags.value[k].key_end = (frags.value[k].key_end) * ((OPH_DRILLDOWN_operator_handle *) handle->operator_handle)->outer_size;
 
-				//Insert new fragment
-				if (oph_odb_stge_insert_into_fragment_table(&oDB_slave, &(frags.value[k]))) {
+				//Collect new fragment
+				if (oph_odb_stge_add_fragment_to_batch(&frag_batch, &(frags.value[k]))) {
 					pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to update fragment table.\n");
 					logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_DRILLDOWN_operator_handle *) handle->operator_handle)->id_input_container,
 						OPH_LOG_OPH_DRILLDOWN_FRAGMENT_INSERT_ERROR, frag_name_out);
@@ -874,6 +874,14 @@ int task_execute(oph_operator_struct * handle)
 		}
 		oph_dc_disconnect_from_dbms(((OPH_DRILLDOWN_operator_handle *) handle->operator_handle)->server, &(dbmss.value[i]));
 	}
+	//Insert all new fragments
+	if ((result == OPH_ANALYTICS_OPERATOR_SUCCESS) && oph_odb_batch_execute(&oDB_slave, &frag_batch)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to update fragment table.\n");
+		logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_DRILLDOWN_operator_handle *) handle->operator_handle)->id_input_container, "Unable to update fragment table.\n");
+		result = OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
+	}
+	oph_odb_batch_free(&frag_batch);
+
 	if (oph_dc_cleanup_dbms(((OPH_DRILLDOWN_operator_handle *) handle->operator_handle)->server)) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to finalize IO server.\n");
 		logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_DRILLDOWN_operator_handle *) handle->operator_handle)->id_input_container, OPH_LOG_OPH_DRILLDOWN_IOPLUGIN_CLEANUP_ERROR,
@@ -629,6 +629,12 @@ int task_execute(oph_operator_struct * handle)
 	snprintf(label_dimension_table_name, OPH_COMMON_BUFFER_LEN, OPH_DIM_TABLE_LABEL_MACRO, oper_handle->id_input_container);
 	int n, compressed = 0, non_empty_set = 1;
 
+	// Number of tuples, used to translate subsets into ranges of ids
+	unsigned long long max_id = 1;
+	for (l = 0; l < number_of_dimensions; ++l)
+		if (cubedims[l].explicit_dim && cubedims[l].size)
+			max_id *= cubedims[l].size;
+
 	for (d = 0; d < oper_handle->number_of_dim; ++d)	// Loop on dimensions set as input
 	{
 		first_explicit = 1;
@@ -887,14 +893,34 @@ int task_execute(oph_operator_struct * handle)
 				// WHERE clause building
 				char where_clause[OPH_TP_TASKLEN];
 				*where_clause = '\0';
-				for (i = 0; i < (int) subset_struct[d]->number; ++i)	// loop on subsets
-				{
-					if (i)
-						strcat(where_clause, " OR ");
-					snprintf(temp, OPH_COMMON_BUFFER_LEN, OPH_EXPLORECUBE_ISINSUBSET_PLUGIN, MYSQL_FRAG_ID, size_string, subset_struct[d]->start[i], subset_struct[d]->stride[i],
-						 subset_struct[d]->end[i]);
-					strncat(where_clause, temp, OPH_TP_TASKLEN - strlen(where_clause) - 1);
+				// Ranges of ids are preferred to the plugin, unless they require more conditions
+				oph_subset_filter filter;
+				unsigned long long *id_start = NULL, *id_end = NULL, id_number = 0, r;
+				if (!oph_subset_filter_compile(subset_struct[d], dim_size[d][dim_number[d] - 1], block_size, &filter)) {
+					oph_subset_filter_id_ranges(&filter, max_id, subset_struct[d]->number, &id_start, &id_end, &id_number);
+					oph_subset_filter_free(&filter);
+				}
+				if (id_number) {
+					for (r = 0; r < id_number; ++r) {
+						if (r)
+							strcat(where_clause, " OR ");
+						snprintf(temp, OPH_COMMON_BUFFER_LEN, OPH_EXPLORECUBE_BETWEEN_CLAUSE, MYSQL_FRAG_ID, id_start[r], id_end[r]);
+						strncat(where_clause, temp, OPH_TP_TASKLEN - strlen(where_clause) - 1);
+					}
+				} else {
+					for (i = 0; i < (int) subset_struct[d]->number; ++i)	// loop on subsets
+					{
+						if (i)
+							strcat(where_clause, " OR ");
+						snprintf(temp, OPH_COMMON_BUFFER_LEN, OPH_EXPLORECUBE_ISINSUBSET_PLUGIN, MYSQL_FRAG_ID, size_string, subset_struct[d]->start[i], subset_struct[d]->stride[i],
+							 subset_struct[d]->end[i]);
+						strncat(where_clause, temp, OPH_TP_TASKLEN - strlen(where_clause) - 1);
+					}
 				}
+				if (id_start)
+					free(id_start);
+				if (id_end)
+					free(id_end);
 				if (oper_handle->task[d]) {
 					free((char *) oper_handle->task[d]);
 					oper_handle->task[d] = NULL;
@@ -1036,12 +1062,31 @@ int task_execute(oph_operator_struct * handle)
 				return OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
 			}
 		}
+		oph_subset_filter filters[oper_handle->number_of_dim];
+		memset(filters, 0, sizeof(filters));
+		for (d = 0; d < oper_handle->number_of_dim; ++d)
+			if (explicited[d] && oph_subset_filter_compile(subset_struct[d], dim_size[d][dim_number[d] - 1], block_size[d], &filters[d])) {
+				pmesg(LOG_ERROR, __FILE__, __LINE__, "Cannot compile subset filters.\n");
+				logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_EXPLORECUBE_MEMORY_ERROR_STRUCT, "subset filter");
+				for (d = 0; d < oper_handle->number_of_dim; ++d)
+					oph_subset_filter_free(&filters[d]);
+				oph_subset_vector_free(subset_struct, oper_handle->number_of_dim);
+				oph_odb_cube_free_datacube(&cube);
+				free(fragment_ids);
+				free(cubedims);
+				oph_odb_stge_free_fragment_list2(&frags);
+				oph_dim_disconnect_from_dbms(db->dbms_instance);
+				oph_dim_unload_dim_dbinstance(db);
+				if (keys)
+					free(keys);
+				return OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
+			}
 		for (i = 0; i < frags.size;) {
 			if (id <= frags.value[i].key_end) {
 				is_in_subset = 0;
 				for (d = 0; d < oper_handle->number_of_dim; ++d)
 					if (explicited[d]) {
-						is_in_subset = oph_subset_index_is_in_subset(oph_subset_id_to_index(id, &(dim_size[d][0]), dim_number[d]), subset_struct[d]);
+						is_in_subset = oph_subset_filter_id_is_in(&filters[d], id);
 						if (!is_in_subset)
 							break;
 					}
@@ -1070,6 +1115,8 @@ int task_execute(oph_operator_struct * handle)
 			} else
 				i++;
 		}
+		for (d = 0; d < oper_handle->number_of_dim; ++d)
+			oph_subset_filter_free(&filters[d]);
 		//Check if key_start and key_end are correct. If not set to zero
 		for (i = 0; i < frags.size; i++) {
 			if (keys[i] < keys[i + frags.size]) {
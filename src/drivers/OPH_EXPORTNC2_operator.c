@@ -24,7 +24,9 @@
 #include <mpi.h>
 
 #include <unistd.h>
+#include <pthread.h>
 #include <sys/stat.h>
+#include <sys/time.h>
 #include <sys/types.h>
 
 #include "drivers/OPH_EXPORTNC2_operator.h"
@@ -68,6 +70,302 @@ int oph_get_next_count(size_t * id, unsigned int *sizemax, int n)
 	return _oph_get_next_count(id, sizemax, n - 1, n);
 }
 
+struct _oph_exportnc2_pipeline {
+	OPH_EXPORTNC2_operator_handle *oper_handle;
+	oph_odb_fragment_list *frags;
+	oph_odb_db_instance_list *dbs;
+	oph_odb_dbms_instance_list *dbmss;
+	long long block_size;
+	long long buffer_size;
+	char *buffer[2];
+	long long *run_rows[2];
+	int *run_fragment[2];
+	int runs[2];
+	char ready[2];
+	char done;
+	char stop;
+	int res;
+	int fill;
+	int current;
+	int run;
+	long long offset;
+	double fetch_time;
+	pthread_t thread;
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+};
+typedef struct _oph_exportnc2_pipeline oph_exportnc2_pipeline;
+
+double _oph_exportnc2_elapsed(struct timeval *start)
+{
+	struct timeval end;
+	gettimeofday(&end, NULL);
+	return (end.tv_sec - start->tv_sec) + (end.tv_usec - start->tv_usec) / 1000000.0;
+}
+
+int _oph_exportnc2_put_vara(int ncid, int varid, nc_type type_nc, size_t * start, size_t * count, char *data, double *write_time)
+{
+	int retval = NC_EBADTYPE;
+	struct timeval stage_start;
+
+	gettimeofday(&stage_start, NULL);
+	switch (type_nc) {
+		case NC_BYTE:
+		case NC_CHAR:
+			retval = nc_put_vara_uchar(ncid, varid, start, count, (unsigned char *) data);
+			break;
+		case NC_SHORT:
+			retval = nc_put_vara_short(ncid, varid, start, count, (short *) data);
+			break;
+		case NC_INT:
+			retval = nc_put_vara_int(ncid, varid, start, count, (int *) data);
+			break;
+		case NC_INT64:
+			retval = nc_put_vara_longlong(ncid, varid, start, count, (long long *) data);
+			break;
+		case NC_FLOAT:
+			retval = nc_put_vara_float(ncid, varid, start, count, (float *) data);
+			break;
+		case NC_DOUBLE:
+			retval = nc_put_vara_double(ncid, varid, start, count, (double *) data);
+			break;
+	}
+	*write_time += _oph_exportnc2_elapsed(&stage_start);
+
+	return retval;
+}
+
+//Hand the buffer filled by the reader over to the writer and wait for the other one to be released
+int _oph_exportnc2_pipeline_flush(oph_exportnc2_pipeline * pipe, long long *length, double *wait_time)
+{
+	int res = OPH_ANALYTICS_OPERATOR_SUCCESS;
+	struct timeval wait_start;
+
+	gettimeofday(&wait_start, NULL);
+	pthread_mutex_lock(&pipe->mutex);
+	pipe->ready[pipe->fill] = 1;
+	pthread_cond_broadcast(&pipe->cond);
+	pipe->fill = !pipe->fill;
+	while (pipe->ready[pipe->fill] && !pipe->stop)
+		pthread_cond_wait(&pipe->cond, &pipe->mutex);
+	if (pipe->stop)
+		res = OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
+	pipe->runs[pipe->fill] = 0;
+	pthread_mutex_unlock(&pipe->mutex);
+	*wait_time += _oph_exportnc2_elapsed(&wait_start);
+
+	*length = 0;
+	return res;
+}
+
+//Reader of the pipelined export: fragments are scanned in the same order used by the writer and their rows are copied alternately in the two halves of the memory buffer
+static void *_oph_exportnc2_fetch_thread(void *p)
+{
+	oph_exportnc2_pipeline *pipe = (oph_exportnc2_pipeline *) p;
+	OPH_EXPORTNC2_operator_handle *oper_handle = pipe->oper_handle;
+	oph_odb_fragment_list *frags = pipe->frags;
+	oph_odb_db_instance_list *dbs = pipe->dbs;
+	oph_odb_dbms_instance_list *dbmss = pipe->dbmss;
+
+	int i, j, k, res = OPH_ANALYTICS_OPERATOR_SUCCESS;
+	long long length = 0;
+	double wait_time = 0.0;
+	struct timeval fetch_start;
+	oph_ioserver_result *frag_rows = NULL;
+	oph_ioserver_row *curr_row = NULL;
+
+	gettimeofday(&fetch_start, NULL);
+
+	oph_ioserver_handler *server = NULL;
+	if (oph_dc_setup_dbms_thread(&(server), (dbmss->value[0]).io_server_type)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to initialize IO server.\n");
+		logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_EXPORTNC_IOPLUGIN_SETUP_ERROR, (dbmss->value[0]).id_dbms);
+		res = OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
+	}
+	//For each DBMS
+	for (i = 0; (res == OPH_ANALYTICS_OPERATOR_SUCCESS) && (i < dbmss->size); i++) {
+		if (oph_dc_connect_to_dbms(server, &(dbmss->value[i]), 0)) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to connect to DBMS. Check access parameters.\n");
+			logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_EXPORTNC_DBMS_CONNECTION_ERROR, (dbmss->value[i]).id_dbms);
+			res = OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
+		}
+		//For each DB
+		for (j = 0; (res == OPH_ANALYTICS_OPERATOR_SUCCESS) && (j < dbs->size); j++) {
+			//Check DB - DBMS Association
+			if (dbs->value[j].dbms_instance != &(dbmss->value[i]))
+				continue;
+
+			if (oph_dc_use_db_of_dbms(server, &(dbmss->value[i]), &(dbs->value[j]))) {
+				pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to use the DB. Check access parameters.\n");
+				logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_EXPORTNC_DB_SELECTION_ERROR, (dbs->value[j]).db_name);
+				res = OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
+				break;
+			}
+			//For each fragment
+			for (k = 0; (res == OPH_ANALYTICS_OPERATOR_SUCCESS) && (k < frags->size); k++) {
+				//Check Fragment - DB Association
+				if (frags->value[k].db_instance != &(dbs->value[j]))
+					continue;
+
+				if (oph_dc_read_fragment_data_stream(server, &(frags->value[k]), oper_handle->measure_type, oper_handle->compressed, NULL, NULL, NULL, 0, 1, &frag_rows)) {
+					pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to read fragment.\n");
+					logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_EXPORTNC_READ_FRAG_ERROR, (frags->value[k]).fragment_name);
+					res = OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
+				} else if (frag_rows->num_fields != 2) {
+					pmesg(LOG_ERROR, __FILE__, __LINE__, "Not enough fields found by query\n");
+					logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_EXPORTNC_MISSING_FIELDS);
+					res = OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
+				}
+
+				while (res == OPH_ANALYTICS_OPERATOR_SUCCESS) {
+					if (oph_ioserver_fetch_row(server, frag_rows, &curr_row)) {
+						pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to fetch row\n");
+						res = OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
+						break;
+					}
+					if (!curr_row->row)
+						break;
+
+					if ((length + pipe->block_size > pipe->buffer_size) && (res = _oph_exportnc2_pipeline_flush(pipe, &length, &wait_time)))
+						break;
+
+					//Rows of the same fragment are contiguous in the buffer
+					if (!pipe->runs[pipe->fill] || (pipe->run_fragment[pipe->fill][pipe->runs[pipe->fill] - 1] != k)) {
+						pipe->run_fragment[pipe->fill][pipe->runs[pipe->fill]] = k;
+						pipe->run_rows[pipe->fill][pipe->runs[pipe->fill]] = 0;
+						pipe->runs[pipe->fill]++;
+					}
+					memcpy(pipe->buffer[pipe->fill] + length, curr_row->row[1], pipe->block_size);
+					pipe->run_rows[pipe->fill][pipe->runs[pipe->fill] - 1]++;
+					length += pipe->block_size;
+				}
+
+				oph_ioserver_free_result(server, frag_rows);
+				frag_rows = NULL;
+			}
+		}
+		oph_dc_disconnect_from_dbms(server, &(dbmss->value[i]));
+	}
+
+	if (server) {
+		oph_dc_cleanup_dbms(server);
+		mysql_thread_end();
+	}
+
+	pthread_mutex_lock(&pipe->mutex);
+	if (length && (res == OPH_ANALYTICS_OPERATOR_SUCCESS))
+		pipe->ready[pipe->fill] = 1;
+	pipe->res = res;
+	pipe->done = 1;
+	pipe->fetch_time = _oph_exportnc2_elapsed(&fetch_start) - wait_time;
+	pthread_cond_broadcast(&pipe->cond);
+	pthread_mutex_unlock(&pipe->mutex);
+
+	int *ret_val = (int *) malloc(sizeof(int));
+	*ret_val = res;
+	pthread_exit((void *) ret_val);
+}
+
+int _oph_exportnc2_pipeline_start(oph_exportnc2_pipeline * pipe, OPH_EXPORTNC2_operator_handle * oper_handle, oph_odb_fragment_list * frags, oph_odb_db_instance_list * dbs,
+				  oph_odb_dbms_instance_list * dbmss, char *memory_buffer, long long memory_size, long long block_size)
+{
+	int b;
+
+	memset(pipe, 0, sizeof(oph_exportnc2_pipeline));
+	pipe->oper_handle = oper_handle;
+	pipe->frags = frags;
+	pipe->dbs = dbs;
+	pipe->dbmss = dbmss;
+	pipe->block_size = block_size;
+	pipe->buffer_size = memory_size / 2;
+	for (b = 0; b < 2; b++) {
+		pipe->buffer[b] = memory_buffer + b * pipe->buffer_size;
+		//Each fragment is stored in at most one run of rows per buffer
+		pipe->run_rows[b] = (long long *) malloc(frags->size * sizeof(long long));
+		pipe->run_fragment[b] = (int *) malloc(frags->size * sizeof(int));
+		if (!pipe->run_rows[b] || !pipe->run_fragment[b]) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Error allocating memory\n");
+			for (b = 0; b < 2; b++) {
+				free(pipe->run_rows[b]);
+				free(pipe->run_fragment[b]);
+			}
+			return OPH_ANALYTICS_OPERATOR_MEMORY_ERR;
+		}
+	}
+
+	pthread_mutex_init(&pipe->mutex, NULL);
+	pthread_cond_init(&pipe->cond, NULL);
+	if (pthread_create(&pipe->thread, NULL, _oph_exportnc2_fetch_thread, (void *) pipe)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to create the reader thread\n");
+		pthread_mutex_destroy(&pipe->mutex);
+		pthread_cond_destroy(&pipe->cond);
+		for (b = 0; b < 2; b++) {
+			free(pipe->run_rows[b]);
+			free(pipe->run_fragment[b]);
+		}
+		return OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
+	}
+
+	return OPH_ANALYTICS_OPERATOR_SUCCESS;
+}
+
+//Return the next run of rows of the k-th fragment (0 at the end of the fragment or -1 in case of errors); the previous run is released
+long long _oph_exportnc2_pipeline_next(oph_exportnc2_pipeline * pipe, int k, char **data)
+{
+	long long rows = 0;
+
+	pthread_mutex_lock(&pipe->mutex);
+	if (pipe->ready[pipe->current] && (pipe->run >= pipe->runs[pipe->current])) {
+		pipe->ready[pipe->current] = 0;
+		pipe->current = !pipe->current;
+		pipe->run = 0;
+		pipe->offset = 0;
+		pthread_cond_broadcast(&pipe->cond);
+	}
+	while (!pipe->ready[pipe->current] && !pipe->done)
+		pthread_cond_wait(&pipe->cond, &pipe->mutex);
+	if (pipe->ready[pipe->current]) {
+		if (pipe->run_fragment[pipe->current][pipe->run] == k) {
+			rows = pipe->run_rows[pipe->current][pipe->run];
+			*data = pipe->buffer[pipe->current] + pipe->offset;
+			pipe->offset += rows * pipe->block_size;
+			pipe->run++;
+		}
+	} else if (pipe->res)
+		rows = -1;
+	pthread_mutex_unlock(&pipe->mutex);
+
+	return rows;
+}
+
+//Stop the reader and release the pipeline; it returns the exit status of the reader
+int _oph_exportnc2_pipeline_stop(oph_exportnc2_pipeline * pipe, double *fetch_time)
+{
+	int b, res = OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
+	void *ret_val = NULL;
+
+	pthread_mutex_lock(&pipe->mutex);
+	pipe->stop = 1;
+	pthread_cond_broadcast(&pipe->cond);
+	pthread_mutex_unlock(&pipe->mutex);
+
+	if (!pthread_join(pipe->thread, &ret_val) && ret_val) {
+		res = *((int *) ret_val);
+		free(ret_val);
+	}
+	if (fetch_time)
+		*fetch_time = pipe->fetch_time;
+
+	pthread_mutex_destroy(&pipe->mutex);
+	pthread_cond_destroy(&pipe->cond);
+	for (b = 0; b < 2; b++) {
+		free(pipe->run_rows[b]);
+		free(pipe->run_fragment[b]);
+	}
+
+	return res;
+}
+
 int env_set(HASHTBL * task_tbl, oph_operator_struct * handle)
 {
 	if (!handle) {
@@ -119,6 +417,7 @@ int env_set(HASHTBL * task_tbl, oph_operator_struct * handle)
 	((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->shuffle = 0;
 	((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->deflate = 0;
 	((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->memory_size = 0;
+	((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->pipeline = 0;
 	((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->nc_file_path = NULL;
 	((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->is_zarr = 0;
 
@@ -533,6 +832,15 @@ int env_set(HASHTBL * task_tbl, oph_operator_struct * handle)
 	}
 	((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->deflate = (char) strtol(value, NULL, 10);
 
+	value = hashtbl_get(task_tbl, OPH_IN_PARAM_PIPELINE);
+	if (!value) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Missing input parameter %s\n", OPH_IN_PARAM_PIPELINE);
+		logging(LOG_ERROR, __FILE__, __LINE__, OPH_GENERIC_CONTAINER_ID, OPH_LOG_OPH_EXPORTNC_MISSING_INPUT_PARAMETER, OPH_IN_PARAM_PIPELINE);
+		return OPH_ANALYTICS_OPERATOR_INVALID_PARAM;
+	}
+	if (!strcmp(value, OPH_COMMON_YES_VALUE))
+		((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->pipeline = 1;
+
 	if (oph_pid_get_memory_size(&(((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->memory_size))) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to read OphidiaDB configuration\n");
 		logging(LOG_ERROR, __FILE__, __LINE__, OPH_GENERIC_CONTAINER_ID, OPH_LOG_OPH_EXPORTNC_OPHIDIADB_CONFIGURATION_FILE);
@@ -1645,9 +1953,43 @@ int task_execute(oph_operator_struct * handle)
 					goto __OPH_EXIT_2;
 			}
 		}
+		// Rows of the next fragments are fetched by a reader thread while the previous ones are written
+		oph_exportnc2_pipeline pipe;
+		char pipelined = 0;
+		long long run_rows = 0, run_row;
+		char *run_data = NULL;
+		double fetch_time = 0.0, write_time = 0.0;
+		struct timeval export_start, stage_start;
+
+		gettimeofday(&export_start, NULL);
+		if (((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->pipeline && frags.size) {
+			if (!memory_size_mb || (block_size > memory_size_mb / 2)) {
+				pmesg(LOG_WARNING, __FILE__, __LINE__, "Memory buffer is too small to export in pipelined mode\n");
+				logging(LOG_WARNING, __FILE__, __LINE__, ((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->id_input_container, "Memory buffer is too small to export in pipelined mode\n");
+			} else if (_oph_exportnc2_pipeline_start
+				   (&pipe, ((OPH_EXPORTNC2_operator_handle *) handle->operator_handle), &frags, &dbs, &dbmss, memory_buffer, memory_size_mb, block_size)) {
+				pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to start the reader thread\n");
+				logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->id_input_container, "Unable to start the reader thread\n");
+				oph_odb_stge_free_fragment_list(&frags);
+				oph_odb_stge_free_db_list(&dbs);
+				oph_odb_stge_free_dbms_list(&dbmss);
+				nc_close(ncid);
+				for (l = 0; l < num_of_dims; l++) {
+					if (dim_rows[l]) {
+						free(dim_rows[l]);
+						dim_rows[l] = NULL;
+					}
+				}
+				free(dim_rows);
+				free(memory_buffer);
+				result = OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
+				goto __OPH_EXIT_2;
+			} else
+				pipelined = 1;
+		}
 		//For each DBMS
 		for (i = 0; i < dbmss.size; i++) {
-			if (oph_dc_connect_to_dbms(((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->server, &(dbmss.value[i]), 0)) {
+			if (!pipelined && oph_dc_connect_to_dbms(((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->server, &(dbmss.value[i]), 0)) {
 				pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to connect to DBMS. Check access parameters.\n");
 				logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->id_input_container, OPH_LOG_OPH_EXPORTNC_DBMS_CONNECTION_ERROR,
 					(dbmss.value[i]).id_dbms);
@@ -1675,7 +2017,7 @@ int task_execute(oph_operator_struct * handle)
 				if (dbs.value[j].dbms_instance != &(dbmss.value[i]))
 					continue;
 
-				if (oph_dc_use_db_of_dbms(((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->server, &(dbmss.value[i]), &(dbs.value[j]))) {
+				if (!pipelined && oph_dc_use_db_of_dbms(((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->server, &(dbmss.value[i]), &(dbs.value[j]))) {
 					pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to use the DB. Check access parameters.\n");
 					logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->id_input_container, OPH_LOG_OPH_EXPORTNC_DB_SELECTION_ERROR,
 						(dbs.value[j]).db_name);
@@ -1759,6 +2101,7 @@ int task_execute(oph_operator_struct * handle)
 						retval = 1;
 						count_dim[0] = dim_val_num[m];
 						start_dim[0] = dim_start[m];
+						gettimeofday(&stage_start, NULL);
 						switch (dims[m].dimtype) {
 							case NC_BYTE:
 							case NC_CHAR:
@@ -1784,6 +2127,8 @@ int task_execute(oph_operator_struct * handle)
 								pmesg(LOG_ERROR, __FILE__, __LINE__, "Variable type not supported\n");
 								logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->id_input_container,
 									OPH_LOG_OPH_EXPORTNC_VAR_TYPE_NOT_SUPPORTED, dims[m].dimtype);
+								if (pipelined)
+									_oph_exportnc2_pipeline_stop(&pipe, NULL);
 								oph_dc_disconnect_from_dbms(((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->server,
 											    frags.value[k].db_instance->dbms_instance);
 								oph_dc_cleanup_dbms(((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->server);
@@ -1803,10 +2148,13 @@ int task_execute(oph_operator_struct * handle)
 								result = OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
 								goto __OPH_EXIT_2;
 						}
+						write_time += _oph_exportnc2_elapsed(&stage_start);
 						if (retval) {
 							pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to write variable values: %s\n", nc_strerror(retval));
 							logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->id_input_container,
 								OPH_LOG_OPH_EXPORTNC_VAR_WRITE_ERROR, nc_strerror(retval));
+							if (pipelined)
+								_oph_exportnc2_pipeline_stop(&pipe, NULL);
 							oph_dc_disconnect_from_dbms(((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->server, frags.value[k].db_instance->dbms_instance);
 							oph_dc_cleanup_dbms(((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->server);
 							oph_odb_stge_free_fragment_list(&frags);
@@ -1827,7 +2175,72 @@ int task_execute(oph_operator_struct * handle)
 						}
 					}
 
-					if (oph_dc_read_fragment_data
+					if (pipelined) {
+						for (inc = 0; inc < nexp; inc++) {
+							start[inc] = dim_start[inc];
+							count[inc] = 1;
+						}
+						for (; inc < num_of_dims; inc++) {
+							start[inc] = 0;
+							count[inc] = dims[inc].dimsize;
+						}
+
+						// Each run is a sequence of contiguous rows of the fragment, written with the same policy used for the memory buffer
+						current_length = 0;
+						retval = 0;
+						while (!retval && ((run_rows = _oph_exportnc2_pipeline_next(&pipe, k, &run_data)) > 0)) {
+							for (run_row = 0; run_row < run_rows; run_row++) {
+								if (!current_length)
+									raw_data = run_data + run_row * block_size;
+								else
+									oph_get_next_count(count, dim_sizes, nexp);
+								current_length++;
+								if (nexp && (count[nexp - 1] < (size_t) dims[nexp - 1].dimsize) && (run_row < run_rows - 1))
+									continue;
+
+								if ((retval = _oph_exportnc2_put_vara(ncid, varid, type_nc, start, count, raw_data, &write_time)))
+									break;
+
+								for (inc = 0; inc < nexp; inc++)
+									count[inc] = 1;
+								for (iii = 0; iii < current_length; ++iii)
+									oph_nc_get_next_nc_id(start, dim_sizes, nexp);
+								current_length = 0;
+							}
+						}
+						if (retval || (run_rows < 0)) {
+							if (retval) {
+								pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to write variable values: %s\n", nc_strerror(retval));
+								logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->id_input_container,
+									OPH_LOG_OPH_EXPORTNC_VAR_WRITE_ERROR, nc_strerror(retval));
+							} else {
+								pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to read fragment.\n");
+								logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->id_input_container,
+									OPH_LOG_OPH_EXPORTNC_READ_FRAG_ERROR, (frags.value[k]).fragment_name);
+							}
+							_oph_exportnc2_pipeline_stop(&pipe, NULL);
+							oph_dc_cleanup_dbms(((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->server);
+							oph_odb_stge_free_fragment_list(&frags);
+							oph_odb_stge_free_db_list(&dbs);
+							oph_odb_stge_free_dbms_list(&dbmss);
+							nc_close(ncid);
+							for (l = 0; l < num_of_dims; l++) {
+								if (dim_rows[l]) {
+									free(dim_rows[l]);
+									dim_rows[l] = NULL;
+								}
+							}
+							free(dim_rows);
+							free(memory_buffer);
+							result = retval ? OPH_ANALYTICS_OPERATOR_UTILITY_ERROR : OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
+							goto __OPH_EXIT_2;
+						}
+						frag_count++;
+						continue;
+					}
+
+					gettimeofday(&stage_start, NULL);
+					if (oph_dc_read_fragment_data_stream
 					    (((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->server, &(frags.value[k]), data_type, compressed, NULL, NULL, NULL, 0, 1, &frag_rows)) {
 						pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to read fragment.\n");
 						logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->id_input_container,
@@ -1852,12 +2265,8 @@ int task_execute(oph_operator_struct * handle)
 						goto __OPH_EXIT_2;
 					}
 
-					if (frag_rows->num_rows < 1) {
-						oph_ioserver_free_result(((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->server, frag_rows);
-						frag_count++;
-						continue;
-					}
-
+					//Rows are streamed, so empty fragments are detected while fetching
+					fetch_time += _oph_exportnc2_elapsed(&stage_start);
 					if (frag_rows->num_fields != 2) {
 						pmesg(LOG_ERROR, __FILE__, __LINE__, "Not enough fields found by query\n");
 						logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->id_input_container,
@@ -1896,6 +2305,7 @@ int task_execute(oph_operator_struct * handle)
 					fetch = 1;
 
 					do {
+						gettimeofday(&stage_start, NULL);
 						if (fetch && oph_ioserver_fetch_row(((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->server, frag_rows, &curr_row)) {
 							pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to fetch row\n");
 							oph_ioserver_free_result(((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->server, frag_rows);
@@ -1917,6 +2327,7 @@ int task_execute(oph_operator_struct * handle)
 							result = OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
 							goto __OPH_EXIT_2;
 						}
+						fetch_time += _oph_exportnc2_elapsed(&stage_start);
 						if (curr_row->row)
 							current_length++;
 						else if (fetch)
@@ -1939,6 +2350,7 @@ int task_execute(oph_operator_struct * handle)
 							raw_data = curr_row->row[1];
 
 						retval = 1;
+						gettimeofday(&stage_start, NULL);
 						switch (type_nc) {
 							case NC_BYTE:
 							case NC_CHAR:
@@ -1983,6 +2395,7 @@ int task_execute(oph_operator_struct * handle)
 								result = OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
 								goto __OPH_EXIT_2;
 						}
+						write_time += _oph_exportnc2_elapsed(&stage_start);
 						if (retval) {
 							pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to write variable values: %s\n", nc_strerror(retval));
 							logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->id_input_container,
@@ -2022,7 +2435,28 @@ int task_execute(oph_operator_struct * handle)
 					frag_count++;
 				}
 			}
-			oph_dc_disconnect_from_dbms(((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->server, &(dbmss.value[i]));
+			if (!pipelined)
+				oph_dc_disconnect_from_dbms(((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->server, &(dbmss.value[i]));
+		}
+
+		if (pipelined && _oph_exportnc2_pipeline_stop(&pipe, &fetch_time)) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to read fragments.\n");
+			logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->id_input_container, "Unable to read fragments.\n");
+			oph_dc_cleanup_dbms(((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->server);
+			oph_odb_stge_free_fragment_list(&frags);
+			oph_odb_stge_free_db_list(&dbs);
+			oph_odb_stge_free_dbms_list(&dbmss);
+			nc_close(ncid);
+			for (l = 0; l < num_of_dims; l++) {
+				if (dim_rows[l]) {
+					free(dim_rows[l]);
+					dim_rows[l] = NULL;
+				}
+			}
+			free(dim_rows);
+			free(memory_buffer);
+			result = OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
+			goto __OPH_EXIT_2;
 		}
 
 		if (memory_buffer)
@@ -2046,10 +2480,26 @@ int task_execute(oph_operator_struct * handle)
 
 		nc_close(ncid);
 
+		// The slowest process determines the time spent in each stage
+		double stage_times[3] = { fetch_time, write_time, _oph_exportnc2_elapsed(&export_start) }, max_stage_times[3] = { 0.0, 0.0, 0.0 };
+		MPI_Reduce(stage_times, max_stage_times, 3, MPI_DOUBLE, MPI_MAX, 0, scomm);
+
 		if (!handle->proc_rank) {
 
 			char jsonbuf[OPH_COMMON_BUFFER_LEN];
 
+			pmesg(LOG_DEBUG, __FILE__, __LINE__, "Data exported in %f s: %f s spent fetching rows and %f s writing them\n", max_stage_times[2], max_stage_times[0], max_stage_times[1]);
+			if (oph_json_is_objkey_printable(((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->objkeys, ((OPH_EXPORTNC2_operator_handle *) handle->operator_handle)->objkeys_num, OPH_JSON_OBJKEY_EXPORTNC2)) {
+				snprintf(jsonbuf, OPH_COMMON_BUFFER_LEN, "Fetch: %.3f s, Write: %.3f s, Total: %.3f s (%s)", max_stage_times[0], max_stage_times[1], max_stage_times[2],
+					 pipelined ? "pipelined" : "serial");
+				if (oph_json_add_text(handle->operator_json, OPH_JSON_OBJKEY_EXPORTNC2, "Export Time", jsonbuf)) {
+					pmesg(LOG_ERROR, __FILE__, __LINE__, "ADD TEXT error\n");
+					logging(LOG_WARNING, __FILE__, __LINE__, OPH_GENERIC_CONTAINER_ID, "ADD TEXT error\n");
+					result = OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
+					goto __OPH_EXIT_2;
+				}
+			}
+
 			if (!strncmp(file, OPH_ESDM_PREFIX, 7)) {
 
 				// ADD OUTPUT PID TO JSON AS TEXT
@@ -2754,17 +2754,16 @@ int task_init(oph_operator_struct * handle)
 		}
 		oph_odb_cube_free_datacube(&cube);
 
-		for (i = 0; i < measure->ndims; i++) {
+		for (i = 0; i < measure->ndims; i++)
 			cubedim[i].id_datacube = id_datacube_out;
-			if (oph_odb_cube_insert_into_cubehasdim_table(oDB, &(cubedim[i]), &last_insertd_id)) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to insert new datacube - dimension relations.\n");
-				logging(LOG_ERROR, __FILE__, __LINE__, id_container_out, OPH_LOG_OPH_IMPORTESDM_CUBEHASDIM_INSERT_ERROR);
-				free(dims);
-				free(cubedim);
-				free(dim_inst);
-				free(dimvar_ids);
-				goto __OPH_EXIT_1;
-			}
+		if (oph_odb_cube_insert_into_cubehasdim_table2(oDB, cubedim, measure->ndims)) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to insert new datacube - dimension relations.\n");
+			logging(LOG_ERROR, __FILE__, __LINE__, id_container_out, OPH_LOG_OPH_IMPORTESDM_CUBEHASDIM_INSERT_ERROR);
+			free(dims);
+			free(cubedim);
+			free(dim_inst);
+			free(dimvar_ids);
+			goto __OPH_EXIT_1;
 		}
 		free(dims);
 		free(cubedim);
@@ -3543,7 +3542,7 @@ int task_init(oph_operator_struct * handle)
 			goto __OPH_EXIT_1;
 		}
 
-		oph_odb_db_instance db;
+		oph_odb_db_instance db, new_dbs[dbmss_length];
 		oph_odb_dbms_instance dbms;
 		char db_name[OPH_ODB_STGE_DB_NAME_SIZE];
 
@@ -3555,6 +3554,9 @@ int task_init(oph_operator_struct * handle)
 				logging(LOG_ERROR, __FILE__, __LINE__, id_container_out, OPH_LOG_OPH_IMPORTESDM_DBMS_ERROR, db.id_dbms);
 				free(id_dbmss);
 				free(id_hosts);
+				//Register the instances already created, so that they are deleted with the cube
+				if (j)
+					oph_odb_stge_insert_into_dbinstance_partitioned_tables2(oDB, new_dbs, j, id_datacube_out);
 				goto __OPH_EXIT_1;
 			}
 			db.dbms_instance = &dbms;
@@ -3575,6 +3577,8 @@ int task_init(oph_operator_struct * handle)
 				oph_dc_disconnect_from_dbms(((OPH_IMPORTESDM_operator_handle *) handle->operator_handle)->server, &(dbms));
 				free(id_dbmss);
 				free(id_hosts);
+				if (j)
+					oph_odb_stge_insert_into_dbinstance_partitioned_tables2(oDB, new_dbs, j, id_datacube_out);
 				goto __OPH_EXIT_1;
 			}
 
@@ -3584,6 +3588,8 @@ int task_init(oph_operator_struct * handle)
 				free(id_dbmss);
 				free(id_hosts);
 				oph_dc_disconnect_from_dbms(((OPH_IMPORTESDM_operator_handle *) handle->operator_handle)->server, &(dbms));
+				if (j)
+					oph_odb_stge_insert_into_dbinstance_partitioned_tables2(oDB, new_dbs, j, id_datacube_out);
 				goto __OPH_EXIT_1;
 			}
 			strcpy(db.db_name, db_name);
@@ -3593,21 +3599,22 @@ int task_init(oph_operator_struct * handle)
 				free(id_dbmss);
 				free(id_hosts);
 				oph_dc_disconnect_from_dbms(((OPH_IMPORTESDM_operator_handle *) handle->operator_handle)->server, &(dbms));
+				if (j)
+					oph_odb_stge_insert_into_dbinstance_partitioned_tables2(oDB, new_dbs, j, id_datacube_out);
 				goto __OPH_EXIT_1;
 			}
-			//Insert new database instance and partitions
-			if (oph_odb_stge_insert_into_dbinstance_partitioned_tables(oDB, &db, id_datacube_out)) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to update dbinstance table\n");
-				logging(LOG_ERROR, __FILE__, __LINE__, id_container_out, OPH_LOG_OPH_IMPORTESDM_DB_INSERT_ERROR, db.db_name);
-				free(id_dbmss);
-				free(id_hosts);
-				oph_dc_disconnect_from_dbms(((OPH_IMPORTESDM_operator_handle *) handle->operator_handle)->server, &(dbms));
-				goto __OPH_EXIT_1;
-			}
+			//Collect new database instance
+			new_dbs[j] = db;
 			oph_dc_disconnect_from_dbms(((OPH_IMPORTESDM_operator_handle *) handle->operator_handle)->server, &(dbms));
 		}
 		free(id_dbmss);
 		free(id_hosts);
+		//Insert new database instances and partitions
+		if (oph_odb_stge_insert_into_dbinstance_partitioned_tables2(oDB, new_dbs, dbmss_length, id_datacube_out)) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to update dbinstance table\n");
+			logging(LOG_ERROR, __FILE__, __LINE__, id_container_out, OPH_LOG_OPH_IMPORTESDM_DB_INSERT_ERROR, new_dbs[0].db_name);
+			goto __OPH_EXIT_1;
+		}
 	  /********************************
 	   *  DB INSTANCE CREATION - END  *
 	   ********************************/
@@ -3836,6 +3843,8 @@ int task_execute(oph_operator_struct * handle)
 
 	int frag_to_insert = 0;
 	int frag_count = 0;
+	oph_odb_batch frag_batch;
+	oph_odb_batch_init(&frag_batch, MYSQL_QUERY_STGE_UPDATE_OPHIDIADB_FRAG2);
 
 	if (!oper_handle->server) {
 		if (oph_dc_setup_dbms(&(oper_handle->server), dbmss.value[0].io_server_type)) {
@@ -3843,6 +3852,7 @@ int task_execute(oph_operator_struct * handle)
 			logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_IMPORTESDM_IOPLUGIN_SETUP_ERROR, dbmss.value[0].id_dbms);
 			oph_odb_stge_free_db_list(&dbs);
 			oph_odb_stge_free_dbms_list(&dbmss);
+			oph_odb_batch_free(&frag_batch);
 			oph_odb_free_ophidiadb(&oDB_slave);
 			return OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
 		}
@@ -3856,6 +3866,7 @@ int task_execute(oph_operator_struct * handle)
 			oph_dc_disconnect_from_dbms(oper_handle->server, &(dbmss.value[i]));
 			oph_odb_stge_free_db_list(&dbs);
 			oph_odb_stge_free_dbms_list(&dbmss);
+			oph_odb_batch_free(&frag_batch);
 			oph_odb_free_ophidiadb(&oDB_slave);
 			return OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
 		}
@@ -3871,6 +3882,7 @@ int task_execute(oph_operator_struct * handle)
 				oph_dc_disconnect_from_dbms(oper_handle->server, &(dbmss.value[i]));
 				oph_odb_stge_free_db_list(&dbs);
 				oph_odb_stge_free_dbms_list(&dbmss);
+				oph_odb_batch_free(&frag_batch);
 				oph_odb_free_ophidiadb(&oDB_slave);
 				return OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
 			}
@@ -3894,6 +3906,7 @@ int task_execute(oph_operator_struct * handle)
 					oph_dc_disconnect_from_dbms(oper_handle->server, &(dbmss.value[i]));
 					oph_odb_stge_free_db_list(&dbs);
 					oph_odb_stge_free_dbms_list(&dbmss);
+					oph_odb_batch_free(&frag_batch);
 					oph_odb_free_ophidiadb(&oDB_slave);
 					return OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
 				}
@@ -3905,6 +3918,7 @@ int task_execute(oph_operator_struct * handle)
 					oph_dc_disconnect_from_dbms(oper_handle->server, &(dbmss.value[i]));
 					oph_odb_stge_free_db_list(&dbs);
 					oph_odb_stge_free_dbms_list(&dbmss);
+					oph_odb_batch_free(&frag_batch);
 					oph_odb_free_ophidiadb(&oDB_slave);
 					return OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
 				}
@@ -3917,16 +3931,18 @@ int task_execute(oph_operator_struct * handle)
 					oph_dc_disconnect_from_dbms(oper_handle->server, &(dbmss.value[i]));
 					oph_odb_stge_free_db_list(&dbs);
 					oph_odb_stge_free_dbms_list(&dbmss);
+					oph_odb_batch_free(&frag_batch);
 					oph_odb_free_ophidiadb(&oDB_slave);
 					return OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
 				}
-				//Insert new fragment
-				if (oph_odb_stge_insert_into_fragment_table(&oDB_slave, &new_frag)) {
+				//Collect new fragment
+				if (oph_odb_stge_add_fragment_to_batch(&frag_batch, &new_frag)) {
 					pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to update fragment table.\n");
 					logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_IMPORTESDM_FRAGMENT_INSERT_ERROR, new_frag.fragment_name);
 					oph_dc_disconnect_from_dbms(oper_handle->server, &(dbmss.value[i]));
 					oph_odb_stge_free_db_list(&dbs);
 					oph_odb_stge_free_dbms_list(&dbmss);
+					oph_odb_batch_free(&frag_batch);
 					oph_odb_free_ophidiadb(&oDB_slave);
 					return OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
 				}
@@ -3939,6 +3955,18 @@ int task_execute(oph_operator_struct * handle)
 		oph_dc_disconnect_from_dbms(oper_handle->server, &(dbmss.value[i]));
 
 	}
+	//Insert all new fragments
+	if (oph_odb_batch_execute(&oDB_slave, &frag_batch)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to update fragment table.\n");
+		logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, "Unable to update fragment table.\n");
+		oph_odb_batch_free(&frag_batch);
+		oph_odb_stge_free_db_list(&dbs);
+		oph_odb_stge_free_dbms_list(&dbmss);
+		oph_odb_free_ophidiadb(&oDB_slave);
+		return OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
+	}
+	oph_odb_batch_free(&frag_batch);
+
 	oph_odb_stge_free_db_list(&dbs);
 	oph_odb_stge_free_dbms_list(&dbmss);
 	oph_odb_free_ophidiadb(&oDB_slave);
@@ -3457,17 +3457,16 @@ int task_init(oph_operator_struct * handle)
 		}
 		oph_odb_cube_free_datacube(&cube);
 
-		for (i = 0; i < measure->ndims; i++) {
+		for (i = 0; i < measure->ndims; i++)
 			cubedim[i].id_datacube = id_datacube_out;
-			if (oph_odb_cube_insert_into_cubehasdim_table(oDB, &(cubedim[i]), &last_insertd_id)) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to insert new datacube - dimension relations.\n");
-				logging(LOG_ERROR, __FILE__, __LINE__, id_container_out, OPH_LOG_OPH_IMPORTNC_CUBEHASDIM_INSERT_ERROR);
-				free(dims);
-				free(cubedim);
-				free(dim_inst);
-				free(dimvar_ids);
-				goto __OPH_EXIT_1;
-			}
+		if (oph_odb_cube_insert_into_cubehasdim_table2(oDB, cubedim, measure->ndims)) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to insert new datacube - dimension relations.\n");
+			logging(LOG_ERROR, __FILE__, __LINE__, id_container_out, OPH_LOG_OPH_IMPORTNC_CUBEHASDIM_INSERT_ERROR);
+			free(dims);
+			free(cubedim);
+			free(dim_inst);
+			free(dimvar_ids);
+			goto __OPH_EXIT_1;
 		}
 		free(dims);
 		free(cubedim);
@@ -4279,7 +4278,7 @@ int task_init(oph_operator_struct * handle)
 			goto __OPH_EXIT_1;
 		}
 
-		oph_odb_db_instance db;
+		oph_odb_db_instance db, new_dbs[dbmss_length];
 		oph_odb_dbms_instance dbms;
 		char db_name[OPH_ODB_STGE_DB_NAME_SIZE];
 
@@ -4292,6 +4291,9 @@ int task_init(oph_operator_struct * handle)
 				logging(LOG_ERROR, __FILE__, __LINE__, id_container_out, OPH_LOG_OPH_IMPORTNC_DBMS_ERROR, db.id_dbms);
 				free(id_dbmss);
 				free(id_hosts);
+				//Register the instances already created, so that they are deleted with the cube
+				if (j)
+					oph_odb_stge_insert_into_dbinstance_partitioned_tables2(oDB, new_dbs, j, id_datacube_out);
 				goto __OPH_EXIT_1;
 			}
 			db.dbms_instance = &dbms;
@@ -4312,6 +4314,8 @@ int task_init(oph_operator_struct * handle)
 				oph_dc_disconnect_from_dbms(((OPH_IMPORTNCS_operator_handle *) handle->operator_handle)->server, &(dbms));
 				free(id_dbmss);
 				free(id_hosts);
+				if (j)
+					oph_odb_stge_insert_into_dbinstance_partitioned_tables2(oDB, new_dbs, j, id_datacube_out);
 				goto __OPH_EXIT_1;
 			}
 
@@ -4321,6 +4325,8 @@ int task_init(oph_operator_struct * handle)
 				free(id_dbmss);
 				free(id_hosts);
 				oph_dc_disconnect_from_dbms(((OPH_IMPORTNCS_operator_handle *) handle->operator_handle)->server, &(dbms));
+				if (j)
+					oph_odb_stge_insert_into_dbinstance_partitioned_tables2(oDB, new_dbs, j, id_datacube_out);
 				goto __OPH_EXIT_1;
 			}
 			strcpy(db.db_name, db_name);
@@ -4330,21 +4336,22 @@ int task_init(oph_operator_struct * handle)
 				free(id_dbmss);
 				free(id_hosts);
 				oph_dc_disconnect_from_dbms(((OPH_IMPORTNCS_operator_handle *) handle->operator_handle)->server, &(dbms));
+				if (j)
+					oph_odb_stge_insert_into_dbinstance_partitioned_tables2(oDB, new_dbs, j, id_datacube_out);
 				goto __OPH_EXIT_1;
 			}
-			//Insert new database instance and partitions
-			if (oph_odb_stge_insert_into_dbinstance_partitioned_tables(oDB, &db, id_datacube_out)) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to update dbinstance table\n");
-				logging(LOG_ERROR, __FILE__, __LINE__, id_container_out, OPH_LOG_OPH_IMPORTNC_DB_INSERT_ERROR, db.db_name);
-				free(id_dbmss);
-				free(id_hosts);
-				oph_dc_disconnect_from_dbms(((OPH_IMPORTNCS_operator_handle *) handle->operator_handle)->server, &(dbms));
-				goto __OPH_EXIT_1;
-			}
+			//Collect new database instance
+			new_dbs[j] = db;
 			oph_dc_disconnect_from_dbms(((OPH_IMPORTNCS_operator_handle *) handle->operator_handle)->server, &(dbms));
 		}
 		free(id_dbmss);
 		free(id_hosts);
+		//Insert new database instances and partitions
+		if (oph_odb_stge_insert_into_dbinstance_partitioned_tables2(oDB, new_dbs, dbmss_length, id_datacube_out)) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to update dbinstance table\n");
+			logging(LOG_ERROR, __FILE__, __LINE__, id_container_out, OPH_LOG_OPH_IMPORTNC_DB_INSERT_ERROR, new_dbs[0].db_name);
+			goto __OPH_EXIT_1;
+		}
 	  /********************************
 	   *  DB INSTANCE CREATION - END  *
 	   ********************************/
@@ -692,18 +692,16 @@ int task_init(oph_operator_struct * handle)
 			oph_dim_unload_dim_dbinstance(db);
 		}
 		//Write new cube - dimension relation rows
-		for (l = 0; l < number_of_dimensions; l++) {
-			//Change iddatacube in cubehasdim
+		//Change iddatacube in cubehasdim
+		for (l = 0; l < number_of_dimensions; l++)
 			cubedims[l].id_datacube = ((OPH_INTERCUBE2_operator_handle *) handle->operator_handle)->id_output_datacube;
-
-			if (oph_odb_cube_insert_into_cubehasdim_table(oDB, &(cubedims[l]), &last_insertd_id)) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to insert new datacube - dimension relations.\n");
-				logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_INTERCUBE2_operator_handle *) handle->operator_handle)->id_input_container, OPH_LOG_OPH_INTERCUBE_CUBEHASDIM_INSERT_ERROR);
-				free(cubedims);
-				if (old_measure)
-					free(old_measure);
-				goto __OPH_EXIT_1;
-			}
+		if (oph_odb_cube_insert_into_cubehasdim_table2(oDB, cubedims, number_of_dimensions)) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to insert new datacube - dimension relations.\n");
+			logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_INTERCUBE2_operator_handle *) handle->operator_handle)->id_input_container, OPH_LOG_OPH_INTERCUBE_CUBEHASDIM_INSERT_ERROR);
+			free(cubedims);
+			if (old_measure)
+				free(old_measure);
+			goto __OPH_EXIT_1;
 		}
 		free(cubedims);
 
@@ -1018,6 +1016,8 @@ int task_execute(oph_operator_struct * handle)
 	char operation[OPH_COMMON_BUFFER_LEN];
 	char frag_name_out[OPH_ODB_STGE_FRAG_NAME_SIZE];
 	int n, result = OPH_ANALYTICS_OPERATOR_SUCCESS, frag_count = 0;
+	oph_odb_batch frag_batch;
+	oph_odb_batch_init(&frag_batch, MYSQL_QUERY_STGE_UPDATE_OPHIDIADB_FRAG2);
 	unsigned long long tot_rows;
 
 	char _ms[OPH_COMMON_MAX_DOUBLE_LENGHT];
@@ -1212,7 +1212,7 @@ int task_execute(oph_operator_struct * handle)
 					frags[0].value[k].fragment_name[OPH_ODB_STGE_FRAG_NAME_SIZE] = 0;
 
 					// Insert new fragment in OphDB
-					if (oph_odb_stge_insert_into_fragment_table(&oDB_slave, &(frags[0].value[k]))) {
+					if (oph_odb_stge_add_fragment_to_batch(&frag_batch, &(frags[0].value[k]))) {
 						pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to update fragment table.\n");
 						logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_INTERCUBE_FRAGMENT_INSERT_ERROR, frag_name_out);
 						result = OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
@@ -1277,8 +1277,8 @@ int task_execute(oph_operator_struct * handle)
 					strncpy(frags[0].value[k].fragment_name, 1 + strchr(frag_name_out, '.'), OPH_ODB_STGE_FRAG_NAME_SIZE);
 					frags[0].value[k].fragment_name[OPH_ODB_STGE_FRAG_NAME_SIZE] = 0;
 
-					//Insert new fragment
-					if (oph_odb_stge_insert_into_fragment_table(&oDB_slave, &(frags[0].value[k]))) {
+					//Collect new fragment
+					if (oph_odb_stge_add_fragment_to_batch(&frag_batch, &(frags[0].value[k]))) {
 						pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to update fragment table.\n");
 						logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_INTERCUBE_FRAGMENT_INSERT_ERROR, frag_name_out);
 						result = OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
@@ -1301,6 +1301,14 @@ int task_execute(oph_operator_struct * handle)
 				oph_dc_disconnect_from_dbms(second_server[l], &(dbmss[l].value[i2[l]]));
 	}
 
+	//Insert all new fragments
+	if ((result == OPH_ANALYTICS_OPERATOR_SUCCESS) && oph_odb_batch_execute(&oDB_slave, &frag_batch)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to update fragment table.\n");
+		logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, "Unable to update fragment table.\n");
+		result = OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
+	}
+	oph_odb_batch_free(&frag_batch);
+
 	if (oph_dc_cleanup_dbms(first_server)) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to finalize IO server.\n");
 		logging(LOG_ERROR, __FILE__, __LINE__, oper_handle->id_input_container, OPH_LOG_OPH_INTERCUBE_IOPLUGIN_CLEANUP_ERROR, (dbmss[0].value[0]).id_dbms);
@@ -771,16 +771,14 @@ int task_init(oph_operator_struct * handle)
 			oph_dim_unload_dim_dbinstance(db);
 		}
 		//Write new cube - dimension relation rows
-		for (l = 0; l < number_of_dimensions; l++) {
-			//Change iddatacube in cubehasdim
+		//Change iddatacube in cubehasdim
+		for (l = 0; l < number_of_dimensions; l++)
 			cubedims[l].id_datacube = ((OPH_MERGE_operator_handle *) handle->operator_handle)->id_output_datacube;
-
-			if (oph_odb_cube_insert_into_cubehasdim_table(oDB, &(cubedims[l]), &last_insertd_id)) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to insert new datacube - dimension relations.\n");
-				logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_MERGE_operator_handle *) handle->operator_handle)->id_input_container, OPH_LOG_OPH_MERGE_CUBEHASDIM_INSERT_ERROR);
-				free(cubedims);
-				goto __OPH_EXIT_1;
-			}
+		if (oph_odb_cube_insert_into_cubehasdim_table2(oDB, cubedims, number_of_dimensions)) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to insert new datacube - dimension relations.\n");
+			logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_MERGE_operator_handle *) handle->operator_handle)->id_input_container, OPH_LOG_OPH_MERGE_CUBEHASDIM_INSERT_ERROR);
+			free(cubedims);
+			goto __OPH_EXIT_1;
 		}
 		free(cubedims);
 
@@ -1089,6 +1087,8 @@ int task_execute(oph_operator_struct * handle)
 
 	int frag_count = 0;
 	int new_input_frag_count = 0;
+	oph_odb_batch frag_batch;
+	oph_odb_batch_init(&frag_batch, MYSQL_QUERY_STGE_UPDATE_OPHIDIADB_FRAG2);
 
 	long long first_id, last_id;
 	int new_frag_flag = 0;
@@ -1103,6 +1103,7 @@ int task_execute(oph_operator_struct * handle)
 		oph_odb_stge_free_fragment_list(&frags_in);
 		oph_odb_stge_free_db_list(&dbs_in);
 		oph_odb_stge_free_dbms_list(&dbmss_in);
+		oph_odb_batch_free(&frag_batch);
 		oph_odb_free_ophidiadb(&oDB_slave);
 		return OPH_ANALYTICS_OPERATOR_MEMORY_ERR;
 	}
@@ -1141,6 +1142,7 @@ int task_execute(oph_operator_struct * handle)
 		oph_odb_stge_free_fragment_list(&frags_in);
 		oph_odb_stge_free_db_list(&dbs_in);
 		oph_odb_stge_free_dbms_list(&dbmss_in);
+		oph_odb_batch_free(&frag_batch);
 		oph_odb_free_ophidiadb(&oDB_slave);
 		free(tot_rows);
 		return OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
@@ -1154,6 +1156,7 @@ int task_execute(oph_operator_struct * handle)
 		oph_odb_stge_free_fragment_list(&frags_in);
 		oph_odb_stge_free_db_list(&dbs_in);
 		oph_odb_stge_free_dbms_list(&dbmss_in);
+		oph_odb_batch_free(&frag_batch);
 		oph_odb_free_ophidiadb(&oDB_slave);
 		free(tot_rows);
 		return OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
@@ -1181,6 +1184,7 @@ int task_execute(oph_operator_struct * handle)
 			oph_odb_stge_free_fragment_list(&frags_in);
 			oph_odb_stge_free_db_list(&dbs_in);
 			oph_odb_stge_free_dbms_list(&dbmss_in);
+			oph_odb_batch_free(&frag_batch);
 			oph_odb_free_ophidiadb(&oDB_slave);
 			free(tot_rows);
 			//Delete intra append data structures
@@ -1216,6 +1220,7 @@ int task_execute(oph_operator_struct * handle)
 				oph_odb_stge_free_fragment_list(&frags_in);
 				oph_odb_stge_free_db_list(&dbs_in);
 				oph_odb_stge_free_dbms_list(&dbmss_in);
+				oph_odb_batch_free(&frag_batch);
 				oph_odb_free_ophidiadb(&oDB_slave);
 				free(tot_rows);
 				//Delete intra append data structures
@@ -1277,6 +1282,7 @@ int task_execute(oph_operator_struct * handle)
 						oph_odb_stge_free_fragment_list(&frags_in);
 						oph_odb_stge_free_db_list(&dbs_in);
 						oph_odb_stge_free_dbms_list(&dbmss_in);
+						oph_odb_batch_free(&frag_batch);
 						oph_odb_free_ophidiadb(&oDB_slave);
 						free(tot_rows);
 						//Delete intra append data structures
@@ -1306,6 +1312,7 @@ int task_execute(oph_operator_struct * handle)
 						oph_odb_stge_free_fragment_list(&frags_in);
 						oph_odb_stge_free_db_list(&dbs_in);
 						oph_odb_stge_free_dbms_list(&dbmss_in);
+						oph_odb_batch_free(&frag_batch);
 						oph_odb_free_ophidiadb(&oDB_slave);
 						free(tot_rows);
 						//Delete intra append data structures
@@ -1340,6 +1347,7 @@ int task_execute(oph_operator_struct * handle)
 						oph_odb_stge_free_fragment_list(&frags_in);
 						oph_odb_stge_free_db_list(&dbs_in);
 						oph_odb_stge_free_dbms_list(&dbmss_in);
+						oph_odb_batch_free(&frag_batch);
 						oph_odb_free_ophidiadb(&oDB_slave);
 						free(tot_rows);
 						//Delete intra append data structures
@@ -1371,6 +1379,7 @@ int task_execute(oph_operator_struct * handle)
 						oph_odb_stge_free_fragment_list(&frags_in);
 						oph_odb_stge_free_db_list(&dbs_in);
 						oph_odb_stge_free_dbms_list(&dbmss_in);
+						oph_odb_batch_free(&frag_batch);
 						oph_odb_free_ophidiadb(&oDB_slave);
 						free(tot_rows);
 						//Delete intra append data structures
@@ -1416,6 +1425,7 @@ int task_execute(oph_operator_struct * handle)
 					oph_odb_stge_free_fragment_list(&frags_in);
 					oph_odb_stge_free_db_list(&dbs_in);
 					oph_odb_stge_free_dbms_list(&dbmss_in);
+					oph_odb_batch_free(&frag_batch);
 					oph_odb_free_ophidiadb(&oDB_slave);
 					free(tot_rows);
 					return OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
@@ -1432,8 +1442,8 @@ int task_execute(oph_operator_struct * handle)
 
 					new_frag.key_end = last_id;
 
-					//Insert new fragment
-					if (oph_odb_stge_insert_into_fragment_table(&oDB_slave, &new_frag)) {
+					//Collect new fragment
+					if (oph_odb_stge_add_fragment_to_batch(&frag_batch, &new_frag)) {
 						pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to update fragment table.\n");
 						logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_MERGE_operator_handle *) handle->operator_handle)->id_input_container,
 							OPH_LOG_OPH_MERGE_FRAGMENT_INSERT_ERROR, new_frag.fragment_name);
@@ -1444,6 +1454,7 @@ int task_execute(oph_operator_struct * handle)
 						oph_odb_stge_free_fragment_list(&frags_in);
 						oph_odb_stge_free_db_list(&dbs_in);
 						oph_odb_stge_free_dbms_list(&dbmss_in);
+						oph_odb_batch_free(&frag_batch);
 						oph_odb_free_ophidiadb(&oDB_slave);
 						free(tot_rows);
 						//Delete intra append data structures
@@ -1485,6 +1496,20 @@ int task_execute(oph_operator_struct * handle)
 			(dbmss_in.value[0]).id_dbms);
 	}
 
+	//Insert all new fragments
+	if (oph_odb_batch_execute(&oDB_slave, &frag_batch)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to update fragment table.\n");
+		logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_MERGE_operator_handle *) handle->operator_handle)->id_input_container, "Unable to update fragment table.\n");
+		oph_odb_batch_free(&frag_batch);
+		oph_odb_free_ophidiadb(&oDB_slave);
+		oph_odb_stge_free_fragment_list(&frags_in);
+		oph_odb_stge_free_db_list(&dbs_in);
+		oph_odb_stge_free_dbms_list(&dbmss_in);
+		free(tot_rows);
+		return OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
+	}
+	oph_odb_batch_free(&frag_batch);
+
 	oph_odb_free_ophidiadb(&oDB_slave);
 	oph_odb_stge_free_fragment_list(&frags_in);
 	oph_odb_stge_free_db_list(&dbs_in);
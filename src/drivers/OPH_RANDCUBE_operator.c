@@ -26,6 +26,9 @@
 #include <mpi.h>
 #include <math.h>
 #include <strings.h>
+#include <errno.h>
+#include <limits.h>
+#include <sys/time.h>
 
 #include "oph_analytics_operator_library.h"
 
@@ -89,6 +92,7 @@ int env_set(HASHTBL * task_tbl, oph_operator_struct * handle)
 	((OPH_RANDCUBE_operator_handle *) handle->operator_handle)->description = NULL;
 	((OPH_RANDCUBE_operator_handle *) handle->operator_handle)->execute_error = 0;
 	((OPH_RANDCUBE_operator_handle *) handle->operator_handle)->rand_algo = NULL;
+	((OPH_RANDCUBE_operator_handle *) handle->operator_handle)->seed = 0;
 	((OPH_RANDCUBE_operator_handle *) handle->operator_handle)->policy = 0;
 
 	//3 - Fill struct with the correct data
@@ -509,6 +513,23 @@ int env_set(HASHTBL * task_tbl, oph_operator_struct * handle)
 		return OPH_ANALYTICS_OPERATOR_MEMORY_ERR;
 	}
 
+	value = hashtbl_get(task_tbl, OPH_IN_PARAM_SEED);
+	if (!value) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Missing input parameter %s\n", OPH_IN_PARAM_SEED);
+		logging(LOG_ERROR, __FILE__, __LINE__, OPH_GENERIC_CONTAINER_ID, OPH_LOG_OPH_RANDCUBE_MISSING_INPUT_PARAMETER, container_name, OPH_IN_PARAM_SEED);
+		return OPH_ANALYTICS_OPERATOR_INVALID_PARAM;
+	}
+	//The seed is declared as int in the XML descriptor
+	char *end = NULL;
+	errno = 0;
+	long seed = strtol(value, &end, 10);
+	if (errno || !end || *end || (seed < 0) || (seed > INT_MAX)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_LOG_OPH_RANDCUBE_INVALID_INPUT_PARAMETER, OPH_IN_PARAM_SEED);
+		logging(LOG_ERROR, __FILE__, __LINE__, OPH_GENERIC_CONTAINER_ID, "[CONTAINER: %s] " OPH_LOG_OPH_RANDCUBE_INVALID_INPUT_PARAMETER, container_name, OPH_IN_PARAM_SEED);
+		return OPH_ANALYTICS_OPERATOR_INVALID_PARAM;
+	}
+	((OPH_RANDCUBE_operator_handle *) handle->operator_handle)->seed = (unsigned long long) seed;
+
 	value = hashtbl_get(task_tbl, OPH_IN_PARAM_POLICY);
 	if (!value) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Missing input parameter %s\n", OPH_IN_PARAM_POLICY);
@@ -1123,15 +1144,14 @@ int task_init(oph_operator_struct * handle)
 				cubedim[i].explicit_dim = 1;
 				cubedim[i].level = i + 1;
 			}
-
-			if (oph_odb_cube_insert_into_cubehasdim_table(oDB, &(cubedim[i]), &last_insertd_id)) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to insert new datacube - dimension relations.\n");
-				logging(LOG_ERROR, __FILE__, __LINE__, id_container_out, OPH_LOG_OPH_RANDCUBE_CUBEHASDIM_INSERT_ERROR);
-				free(dims);
-				free(dim_inst);
-				free(cubedim);
-				goto __OPH_EXIT_1;
-			}
+		}
+		if (oph_odb_cube_insert_into_cubehasdim_table2(oDB, cubedim, num_of_input_dim)) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to insert new datacube - dimension relations.\n");
+			logging(LOG_ERROR, __FILE__, __LINE__, id_container_out, OPH_LOG_OPH_RANDCUBE_CUBEHASDIM_INSERT_ERROR);
+			free(dims);
+			free(dim_inst);
+			free(cubedim);
+			goto __OPH_EXIT_1;
 		}
 		free(dims);
 		free(cubedim);
@@ -1159,7 +1179,7 @@ int task_init(oph_operator_struct * handle)
 			goto __OPH_EXIT_1;
 		}
 
-		oph_odb_db_instance db;
+		oph_odb_db_instance db, new_dbs[dbmss_length];
 		oph_odb_dbms_instance dbms;
 		char db_name[OPH_ODB_STGE_DB_NAME_SIZE];
 
@@ -1171,6 +1191,9 @@ int task_init(oph_operator_struct * handle)
 				logging(LOG_ERROR, __FILE__, __LINE__, id_container_out, OPH_LOG_OPH_RANDCUBE_DBMS_ERROR, db.id_dbms);
 				free(id_dbmss);
 				free(id_hosts);
+				//Register the instances already created, so that they are deleted with the cube
+				if (j)
+					oph_odb_stge_insert_into_dbinstance_partitioned_tables2(oDB, new_dbs, j, id_datacube_out);
 				goto __OPH_EXIT_1;
 			}
 			db.dbms_instance = &dbms;
@@ -1191,6 +1214,8 @@ int task_init(oph_operator_struct * handle)
 				oph_dc_disconnect_from_dbms(((OPH_RANDCUBE_operator_handle *) handle->operator_handle)->server, &(dbms));
 				free(id_dbmss);
 				free(id_hosts);
+				if (j)
+					oph_odb_stge_insert_into_dbinstance_partitioned_tables2(oDB, new_dbs, j, id_datacube_out);
 				goto __OPH_EXIT_1;
 			}
 
@@ -1200,6 +1225,8 @@ int task_init(oph_operator_struct * handle)
 				free(id_dbmss);
 				free(id_hosts);
 				oph_dc_disconnect_from_dbms(((OPH_RANDCUBE_operator_handle *) handle->operator_handle)->server, &(dbms));
+				if (j)
+					oph_odb_stge_insert_into_dbinstance_partitioned_tables2(oDB, new_dbs, j, id_datacube_out);
 				goto __OPH_EXIT_1;
 			}
 			strcpy(db.db_name, db_name);
@@ -1209,21 +1236,22 @@ int task_init(oph_operator_struct * handle)
 				free(id_dbmss);
 				free(id_hosts);
 				oph_dc_disconnect_from_dbms(((OPH_RANDCUBE_operator_handle *) handle->operator_handle)->server, &(dbms));
+				if (j)
+					oph_odb_stge_insert_into_dbinstance_partitioned_tables2(oDB, new_dbs, j, id_datacube_out);
 				goto __OPH_EXIT_1;
 			}
-			//Insert new database instance and partitions
-			if (oph_odb_stge_insert_into_dbinstance_partitioned_tables(oDB, &db, id_datacube_out)) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to update dbinstance table\n");
-				logging(LOG_ERROR, __FILE__, __LINE__, id_container_out, OPH_LOG_OPH_RANDCUBE_DB_INSERT_ERROR, db.db_name);
-				free(id_dbmss);
-				free(id_hosts);
-				oph_dc_disconnect_from_dbms(((OPH_RANDCUBE_operator_handle *) handle->operator_handle)->server, &(dbms));
-				goto __OPH_EXIT_1;
-			}
+			//Collect new database instance
+			new_dbs[j] = db;
 			oph_dc_disconnect_from_dbms(((OPH_RANDCUBE_operator_handle *) handle->operator_handle)->server, &(dbms));
 		}
 		free(id_dbmss);
 		free(id_hosts);
+		//Insert new database instances and partitions
+		if (oph_odb_stge_insert_into_dbinstance_partitioned_tables2(oDB, new_dbs, dbmss_length, id_datacube_out)) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to update dbinstance table\n");
+			logging(LOG_ERROR, __FILE__, __LINE__, id_container_out, OPH_LOG_OPH_RANDCUBE_DB_INSERT_ERROR, new_dbs[0].db_name);
+			goto __OPH_EXIT_1;
+		}
 	  /********************************
 	   *  DB INSTANCE CREATION - END  *
 	   ********************************/
@@ -1264,6 +1292,14 @@ int task_init(oph_operator_struct * handle)
 	//Broadcast to all other processes the result         
 	MPI_Bcast(id_datacube, 4, MPI_INT, 0, MPI_COMM_WORLD);
 
+	//The same seed has to be used by all the processes
+	if (!handle->proc_rank && !((OPH_RANDCUBE_operator_handle *) handle->operator_handle)->seed) {
+		struct timeval time;
+		gettimeofday(&time, NULL);
+		((OPH_RANDCUBE_operator_handle *) handle->operator_handle)->seed = time.tv_sec * 1000000ULL + time.tv_usec;
+	}
+	MPI_Bcast(&((OPH_RANDCUBE_operator_handle *) handle->operator_handle)->seed, 1, MPI_UNSIGNED_LONG_LONG, 0, MPI_COMM_WORLD);
+
 	//Check if sequential part has been completed
 	if (!id_datacube[0] || !id_datacube[1]) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Master procedure or broadcasting has failed\n");
@@ -1461,7 +1497,8 @@ int task_execute(oph_operator_struct * handle)
 					if (oph_dc_populate_fragment_with_rand_data
 					    (((OPH_RANDCUBE_operator_handle *) handle->operator_handle)->server, &new_frag,
 					     ((OPH_RANDCUBE_operator_handle *) handle->operator_handle)->tuplexfrag_number, ((OPH_RANDCUBE_operator_handle *) handle->operator_handle)->array_length,
-					     ((OPH_RANDCUBE_operator_handle *) handle->operator_handle)->measure_type, 1, ((OPH_RANDCUBE_operator_handle *) handle->operator_handle)->rand_algo)) {
+					     ((OPH_RANDCUBE_operator_handle *) handle->operator_handle)->measure_type, 1, ((OPH_RANDCUBE_operator_handle *) handle->operator_handle)->rand_algo,
+					     ((OPH_RANDCUBE_operator_handle *) handle->operator_handle)->seed)) {
 						pmesg(LOG_ERROR, __FILE__, __LINE__, "Error while populating fragment with compressed data.\n");
 						logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_RANDCUBE_operator_handle *) handle->operator_handle)->id_input_container,
 							OPH_LOG_OPH_RANDCUBE_FRAG_POPULATE_ERROR, new_frag.fragment_name, "compressed");
@@ -1472,7 +1509,8 @@ int task_execute(oph_operator_struct * handle)
 					if (oph_dc_populate_fragment_with_rand_data
 					    (((OPH_RANDCUBE_operator_handle *) handle->operator_handle)->server, &new_frag,
 					     ((OPH_RANDCUBE_operator_handle *) handle->operator_handle)->tuplexfrag_number, ((OPH_RANDCUBE_operator_handle *) handle->operator_handle)->array_length,
-					     ((OPH_RANDCUBE_operator_handle *) handle->operator_handle)->measure_type, 0, ((OPH_RANDCUBE_operator_handle *) handle->operator_handle)->rand_algo)) {
+					     ((OPH_RANDCUBE_operator_handle *) handle->operator_handle)->measure_type, 0, ((OPH_RANDCUBE_operator_handle *) handle->operator_handle)->rand_algo,
+					     ((OPH_RANDCUBE_operator_handle *) handle->operator_handle)->seed)) {
 						pmesg(LOG_ERROR, __FILE__, __LINE__, "Error while populating fragment with uncompressed data.\n");
 						logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_RANDCUBE_operator_handle *) handle->operator_handle)->id_input_container,
 							OPH_LOG_OPH_RANDCUBE_FRAG_POPULATE_ERROR, new_frag.fragment_name, "uncompressed");
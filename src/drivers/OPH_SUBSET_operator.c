@@ -779,6 +779,12 @@ int task_init(oph_operator_struct * handle)
 
 		int n, compressed = 0;
 
+		// Number of tuples, used to translate subsets into ranges of ids
+		unsigned long long max_id = 1;
+		for (l = 0; l < number_of_dimensions; ++l)
+			if (cubedims[l].explicit_dim && cubedims[l].size)
+				max_id *= cubedims[l].size;
+
 		for (d = 0; d < ((OPH_SUBSET_operator_handle *) handle->operator_handle)->number_of_dim; ++d)	// Loop on dimensions set as input
 		{
 			first_explicit = 1;
@@ -1062,14 +1068,34 @@ int task_init(oph_operator_struct * handle)
 				// WHERE clause building
 				char where_clause[OPH_TP_TASKLEN];
 				*where_clause = '\0';
-				for (i = 0; i < (int) subset_struct[d]->number; ++i)	// loop on subsets
-				{
-					if (i)
-						strcat(where_clause, " OR ");
-					snprintf(temp, OPH_COMMON_BUFFER_LEN, OPH_SUBSET_ISINSUBSET_PLUGIN, MYSQL_FRAG_ID, size_string, subset_struct[d]->start[i], subset_struct[d]->stride[i],
-						 subset_struct[d]->end[i]);
-					strncat(where_clause, temp, OPH_TP_TASKLEN - strlen(where_clause) - 1);
+				// Ranges of ids are preferred to the plugin, unless they require more conditions
+				oph_subset_filter filter;
+				unsigned long long *id_start = NULL, *id_end = NULL, id_number = 0, r;
+				if (!oph_subset_filter_compile(subset_struct[d], dim_size[d][dim_number[d] - 1], block_size, &filter)) {
+					oph_subset_filter_id_ranges(&filter, max_id, subset_struct[d]->number, &id_start, &id_end, &id_number);
+					oph_subset_filter_free(&filter);
+				}
+				if (id_number) {
+					for (r = 0; r < id_number; ++r) {
+						if (r)
+							strcat(where_clause, " OR ");
+						snprintf(temp, OPH_COMMON_BUFFER_LEN, OPH_SUBSET_BETWEEN_CLAUSE, MYSQL_FRAG_ID, id_start[r], id_end[r]);
+						strncat(where_clause, temp, OPH_TP_TASKLEN - strlen(where_clause) - 1);
+					}
+				} else {
+					for (i = 0; i < (int) subset_struct[d]->number; ++i)	// loop on subsets
+					{
+						if (i)
+							strcat(where_clause, " OR ");
+						snprintf(temp, OPH_COMMON_BUFFER_LEN, OPH_SUBSET_ISINSUBSET_PLUGIN, MYSQL_FRAG_ID, size_string, subset_struct[d]->start[i], subset_struct[d]->stride[i],
+							 subset_struct[d]->end[i]);
+						strncat(where_clause, temp, OPH_TP_TASKLEN - strlen(where_clause) - 1);
+					}
 				}
+				if (id_start)
+					free(id_start);
+				if (id_end)
+					free(id_end);
 				if (((OPH_SUBSET_operator_handle *) handle->operator_handle)->task[d]) {
 					free((char *) ((OPH_SUBSET_operator_handle *) handle->operator_handle)->task[d]);
 					((OPH_SUBSET_operator_handle *) handle->operator_handle)->task[d] = NULL;
@@ -1185,12 +1211,28 @@ int task_init(oph_operator_struct * handle)
 					goto __OPH_EXIT_1;
 				}
 			}
+			oph_subset_filter filters[((OPH_SUBSET_operator_handle *) handle->operator_handle)->number_of_dim];
+			memset(filters, 0, sizeof(filters));
+			for (d = 0; d < ((OPH_SUBSET_operator_handle *) handle->operator_handle)->number_of_dim; ++d)
+				if (((OPH_SUBSET_operator_handle *) handle->operator_handle)->explicited[d] && oph_subset_filter_compile(subset_struct[d], dim_size[d][dim_number[d] - 1], block_size[d], &filters[d])) {
+					pmesg(LOG_ERROR, __FILE__, __LINE__, "Cannot compile subset filters.\n");
+					logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_SUBSET_operator_handle *) handle->operator_handle)->id_input_container, OPH_LOG_OPH_SUBSET_MEMORY_ERROR_STRUCT, "subset filter");
+					for (d = 0; d < ((OPH_SUBSET_operator_handle *) handle->operator_handle)->number_of_dim; ++d)
+						oph_subset_filter_free(&filters[d]);
+					oph_subset_vector_free(subset_struct, ((OPH_SUBSET_operator_handle *) handle->operator_handle)->number_of_dim);
+					oph_odb_cube_free_datacube(&cube);
+					free(cubedims);
+					oph_odb_stge_free_fragment_list2(&frags);
+					oph_dim_disconnect_from_dbms(db->dbms_instance);
+					oph_dim_unload_dim_dbinstance(db);
+					goto __OPH_EXIT_1;
+				}
 			for (i = 0; i < frags.size;) {
 				if (id <= frags.value[i].key_end) {
 					is_in_subset = 0;
 					for (d = 0; d < ((OPH_SUBSET_operator_handle *) handle->operator_handle)->number_of_dim; ++d)
 						if (((OPH_SUBSET_operator_handle *) handle->operator_handle)->explicited[d]) {
-							is_in_subset = oph_subset_index_is_in_subset(oph_subset_id_to_index(id, &(dim_size[d][0]), dim_number[d]), subset_struct[d]);
+							is_in_subset = oph_subset_filter_id_is_in(&filters[d], id);
 							if (!is_in_subset)
 								break;
 						}
@@ -1219,6 +1261,8 @@ int task_init(oph_operator_struct * handle)
 				} else
 					i++;
 			}
+			for (d = 0; d < ((OPH_SUBSET_operator_handle *) handle->operator_handle)->number_of_dim; ++d)
+				oph_subset_filter_free(&filters[d]);
 			//Check if key_start and key_end are correct. If not set to zero
 			for (i = 0; i < frags.size; i++) {
 				if (keys[i] < keys[i + frags.size]) {
@@ -1808,16 +1852,14 @@ int task_init(oph_operator_struct * handle)
 		oph_subset_vector_free(subset_struct, ((OPH_SUBSET_operator_handle *) handle->operator_handle)->number_of_dim);
 
 		//Write new cube - dimension relation rows
-		for (l = 0; l < number_of_dimensions; l++) {
-			//Change iddatacube in cubehasdim
+		//Change iddatacube in cubehasdim
+		for (l = 0; l < number_of_dimensions; l++)
 			cubedims[l].id_datacube = ((OPH_SUBSET_operator_handle *) handle->operator_handle)->id_output_datacube;
-
-			if (oph_odb_cube_insert_into_cubehasdim_table(oDB, &(cubedims[l]), &last_insertd_id)) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to retrieve datacube - dimension relations.\n");
-				logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_SUBSET_operator_handle *) handle->operator_handle)->id_input_container, OPH_LOG_OPH_SUBSET_CUBEHASDIM_INSERT_ERROR);
-				free(cubedims);
-				goto __OPH_EXIT_1;
-			}
+		if (oph_odb_cube_insert_into_cubehasdim_table2(oDB, cubedims, number_of_dimensions)) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to retrieve datacube - dimension relations.\n");
+			logging(LOG_ERROR, __FILE__, __LINE__, ((OPH_SUBSET_operator_handle *) handle->operator_handle)->id_input_container, OPH_LOG_OPH_SUBSET_CUBEHASDIM_INSERT_ERROR);
+			free(cubedims);
+			goto __OPH_EXIT_1;
 		}
 		free(cubedims);
 
@@ -18,22 +18,91 @@ Retrieved from: http://en.literateprograms.org/Hash_table_(C)?oldid=19638
 #include <string.h>
 #include <stdio.h>
 
-static char *mystrdup(const char *s)
+/* 64-bit FNV-1a */
+static hash_size def_hashfunc(const char *key)
 {
-	char *b;
-	if(!(b=malloc(strlen(s)+1))) return NULL;
-	strcpy(b, s);
-	return b;
+	unsigned long long hash=14695981039346656037ULL;
+
+	while(*key) {
+		hash^=(unsigned char)*key++;
+		hash*=1099511628211ULL;
+	}
+
+	return (hash_size)(hash^(hash>>32));
 }
 
+static hash_size round_size(hash_size size)
+{
+	hash_size n=HASHTBL_MIN_SIZE;
+	while(n<size) n<<=1;
+	return n;
+}
 
-static hash_size def_hashfunc(const char *key)
+static char *arena_strdup(HASHTBL *hashtbl, const char *s)
 {
-	hash_size hash=0;
-	
-	while(*key) hash+=(unsigned char)*key++;
+	size_t len=strlen(s)+1;
+	struct hashtbl_arena_s *arena=hashtbl->arena;
+
+	if(!arena || arena->used+len>arena->size) {
+		size_t size=arena ? 2*arena->size : HASHTBL_ARENA_SIZE;
+		if(size<len) size=len;
+		if(!(arena=malloc(sizeof(struct hashtbl_arena_s)+size))) return NULL;
+		arena->used=0;
+		arena->size=size;
+		arena->next=hashtbl->arena;
+		hashtbl->arena=arena;
+	}
+	memcpy(arena->buffer+arena->used, s, len);
+	arena->used+=len;
+	return arena->buffer+arena->used-len;
+}
+
+/* Return the slot of the key or the empty slot where it should be inserted */
+static hash_size find_slot(HASHTBL *hashtbl, const char *key, hash_size hash)
+{
+	hash_size mask=hashtbl->size-1, n=hash&mask;
 
-	return hash;
+	while(hashtbl->nodes[n].key) {
+		if(hashtbl->nodes[n].hash==hash && !strcmp(hashtbl->nodes[n].key, key)) break;
+		n=(n+1)&mask;
+	}
+	return n;
+}
+
+/* Backward shift deletion: following nodes are moved so that no probe sequence is broken */
+static void remove_slot(HASHTBL *hashtbl, hash_size n)
+{
+	hash_size mask=hashtbl->size-1, next=(n+1)&mask;
+
+	while(hashtbl->nodes[next].key) {
+		hash_size home=hashtbl->nodes[next].hash&mask;
+		if(((next-home)&mask) >= ((next-n)&mask)) {
+			hashtbl->nodes[n]=hashtbl->nodes[next];
+			n=next;
+		}
+		next=(next+1)&mask;
+	}
+	hashtbl->nodes[n].key=NULL;
+	hashtbl->nodes[n].data=NULL;
+	hashtbl->count--;
+}
+
+static int rehash(HASHTBL *hashtbl, hash_size size)
+{
+	struct hashnode_s *nodes=hashtbl->nodes;
+	hash_size n, oldsize=hashtbl->size;
+
+	if(!(hashtbl->nodes=calloc(size, sizeof(struct hashnode_s)))) {
+		hashtbl->nodes=nodes;
+		return -1;
+	}
+	hashtbl->size=size;
+
+	for(n=0; n<oldsize; ++n)
+		if(nodes[n].key) hashtbl->nodes[find_slot(hashtbl, nodes[n].key, nodes[n].hash)]=nodes[n];
+
+	free(nodes);
+	return 0;
 }
 
 
@@ -44,12 +113,14 @@ HASHTBL *hashtbl_create(hash_size size, hash_size (*hashfunc)(const char *))
 
 	if(!(hashtbl=malloc(sizeof(HASHTBL)))) return NULL;
 
-	if(!(hashtbl->nodes=calloc(size, sizeof(struct hashnode_s*)))) {
+	hashtbl->size=round_size(2*size);
+	if(!(hashtbl->nodes=calloc(hashtbl->size, sizeof(struct hashnode_s)))) {
 		free(hashtbl);
 		return NULL;
 	}
 
-	hashtbl->size=size;
+	hashtbl->count=0;
+	hashtbl->arena=NULL;
 
 	if(hashfunc) hashtbl->hashfunc=hashfunc;
 	else hashtbl->hashfunc=def_hashfunc;
@@ -61,17 +132,13 @@ HASHTBL *hashtbl_create(hash_size size, hash_size (*hashfunc)(const char *))
 void hashtbl_destroy(HASHTBL *hashtbl)
 {
 	hash_size n;
-	struct hashnode_s *node, *oldnode;
-	
-	for(n=0; n<hashtbl->size; ++n) {
-		node=hashtbl->nodes[n];
-		while(node) {
-			free(node->key);
-			free(node->data);  // added 
-			oldnode=node;
-			node=node->next;
-			free(oldnode);
-		}
+	struct hashtbl_arena_s *arena, *next;
+
+	for(n=0; n<hashtbl->size; ++n)
+		if(hashtbl->nodes[n].key) free(hashtbl->nodes[n].data);
+	for(arena=hashtbl->arena; arena; arena=next) {
+		next=arena->next;
+		free(arena);
 	}
 	free(hashtbl->nodes);
 	free(hashtbl);
@@ -80,35 +147,29 @@ void hashtbl_destroy(HASHTBL *hashtbl)
 
 int hashtbl_insert(HASHTBL *hashtbl, const char *key, void *data)
 {
-	struct hashnode_s *node;
-	hash_size hash=hashtbl->hashfunc(key)%hashtbl->size;
-
-
-	node=hashtbl->nodes[hash];
-	while(node) {
-		if(!strcmp(node->key, key)) {
-			//node->data=data; removed old
-			
-			// this new code does nothing is the key already exists
-			fprintf(stderr,"Key already existing: [key=%s] [data=%s] [skip add element]\n",(char*)node->key,(char*)node->data); // added 
-			return 0;
-		}
-		node=node->next;
+	hash_size hash=hashtbl->hashfunc(key), n=find_slot(hashtbl, key, hash);
+
+	if(hashtbl->nodes[n].key) {
+		// this new code does nothing is the key already exists
+		fprintf(stderr,"Key already existing: [key=%s] [data=%s] [skip add element]\n",(char*)hashtbl->nodes[n].key,(char*)hashtbl->nodes[n].data); // added
+		return 0;
 	}
 
+	if(2*(hashtbl->count+1)>hashtbl->size) {
+		if(rehash(hashtbl, 2*hashtbl->size)) return -1;
+		n=find_slot(hashtbl, key, hash);
+	}
 
-	if(!(node=malloc(sizeof(struct hashnode_s)))) return -1;
-	if(!(node->key=mystrdup(key))) {
-		free(node);
+	char *copy;
+	if(!(copy=malloc(strlen((char*)data)+1))) return -1;
+	strcpy(copy, (char*)data);
+	if(!(hashtbl->nodes[n].key=arena_strdup(hashtbl, key))) {
+		free(copy);
 		return -1;
 	}
-	//node->data=data;
-       	node->data = (char *) malloc (strlen ((char*) data) + 1); //added
-	sprintf(node->data,"%s",(char*)data); // added 
-
-	node->next=hashtbl->nodes[hash];
-	hashtbl->nodes[hash]=node;
-
+	hashtbl->nodes[n].data=copy;
+	hashtbl->nodes[n].hash=hash;
+	hashtbl->count++;
 
 	return 0;
 }
@@ -116,104 +177,61 @@ int hashtbl_insert(HASHTBL *hashtbl, const char *key, void *data)
 
 int hashtbl_remove(HASHTBL *hashtbl, const char *key)
 {
-	struct hashnode_s *node, *prevnode=NULL;
-	hash_size hash=hashtbl->hashfunc(key)%hashtbl->size;
-
-	node=hashtbl->nodes[hash];
-	while(node) {
-		if(!strcmp(node->key, key)) {
-			free(node->key);
-			free(node->data); // added
-			if(prevnode) prevnode->next=node->next;
-			else hashtbl->nodes[hash]=node->next;
-			free(node);
-			return 0;
-		}
-		prevnode=node;
-		node=node->next;
-	}
+	hash_size n=find_slot(hashtbl, key, hashtbl->hashfunc(key));
+
+	if(!hashtbl->nodes[n].key) return -1;
 
-	return -1;
+	free(hashtbl->nodes[n].data);
+	remove_slot(hashtbl, n);
+
+	return 0;
 }
 
 
 void *hashtbl_get(HASHTBL *hashtbl, const char *key)
 {
-	struct hashnode_s *node;
-	hash_size hash=hashtbl->hashfunc(key)%hashtbl->size;
-	node=hashtbl->nodes[hash];
-	while(node) {
-		if(!strcmp(node->key, key)) return node->data;
-		node=node->next;
-	}
-	return NULL;
+	hash_size n=find_slot(hashtbl, key, hashtbl->hashfunc(key));
+	return hashtbl->nodes[n].key ? hashtbl->nodes[n].data : NULL;
 }
 
 int hashtbl_is_empty(HASHTBL *hashtbl)
 {
-	hash_size n;
-	for(n=0; n<hashtbl->size; ++n) if (hashtbl->nodes[n]) return 0;
-	return 1;
+	return !hashtbl->count;
 }
 
 void *hashtbl_pop(HASHTBL *hashtbl)
 {
 	hash_size n;
-	struct hashnode_s *node;
+	void *data;
 	for(n=0; n<hashtbl->size; ++n)
-	{
-		node = hashtbl->nodes[n];
-		if (hashtbl->nodes[n])
-		{
-			free(node->key);
-			hashtbl->nodes[n]=node->next;
-			return node->data;
+		if(hashtbl->nodes[n].key) {
+			data=hashtbl->nodes[n].data;
+			remove_slot(hashtbl, n);
+			return data;
 		}
-	}
 	return NULL;
 }
 
 char *hashtbl_pop_key(HASHTBL *hashtbl)
 {
 	hash_size n;
-	struct hashnode_s *node;
+	char *key;
 	for(n=0; n<hashtbl->size; ++n)
-	{
-		node = hashtbl->nodes[n];
-		if (hashtbl->nodes[n])
-		{
-			free(node->data); // added
-			hashtbl->nodes[n]=node->next;
-			return node->key;
+		if(hashtbl->nodes[n].key) {
+			// keys belong to the arena, so a copy is returned
+			if(!(key=strdup(hashtbl->nodes[n].key))) return NULL;
+			free(hashtbl->nodes[n].data);
+			remove_slot(hashtbl, n);
+			return key;
 		}
-	}
 	return NULL;
 }
 
 int hashtbl_resize(HASHTBL *hashtbl, hash_size size)
 {
-	HASHTBL newtbl;
-	hash_size n;
-	struct hashnode_s *node,*next;
-
-	newtbl.size=size;
-	newtbl.hashfunc=hashtbl->hashfunc;
-
-	if(!(newtbl.nodes=calloc(size, sizeof(struct hashnode_s*)))) return -1;
+	size=round_size(size);
+	while(2*hashtbl->count>size) size<<=1;
+	if(size==hashtbl->size) return 0;
 
-	for(n=0; n<hashtbl->size; ++n) {
-		for(node=hashtbl->nodes[n]; node; node=next) {
-			next = node->next;
-			hashtbl_insert(&newtbl, node->key, node->data);
-			hashtbl_remove(hashtbl, node->key);
-			
-		}
-	}
-
-	free(hashtbl->nodes);
-	hashtbl->size=newtbl.size;
-	hashtbl->nodes=newtbl.nodes;
-
-	return 0;
+	return rehash(hashtbl, size);
 }
-
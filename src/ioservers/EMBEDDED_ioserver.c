@@ -0,0 +1,4669 @@
+/*
+    Ophidia Analytics Framework
+    Copyright (C) 2012-2024 CMCC Foundation
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#define _GNU_SOURCE
+#include "EMBEDDED_ioserver.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <errno.h>
+#include <math.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <dlfcn.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "debug.h"
+#include "oph_ioserver_plugins_log_error_codes.h"
+#include "oph_ioserver_submission_query.h"
+#include "oph_ioserver_parser_library.h"
+#include "hashtbl.h"
+
+#define UNUSED(x) {(void)(x);}
+
+//Internal return codes
+#define EMBEDDED_IO_NOT_FOUND 1
+#define EMBEDDED_IO_STOP 2
+
+#define EMBEDDED_IO_LOG(handle, ...) { pmesg(LOG_ERROR, __FILE__, __LINE__, __VA_ARGS__); logging_server(LOG_ERROR, __FILE__, __LINE__, (handle)->server_type, __VA_ARGS__); }
+
+#define EMBEDDED_IO_IS_TEXT(value) (((value)->type == EMBEDDED_IO_VALUE_STRING) || ((value)->type == EMBEDDED_IO_VALUE_DECIMAL))
+#define EMBEDDED_IO_COLUMN_TYPE(table, column) ((table)->types ? (table)->types[column] : 0)
+#define EMBEDDED_IO_WRITE_BUFFER 1048576
+#define EMBEDDED_IO_MIN_ROWS 64
+
+static pthread_mutex_t _embedded_lock = PTHREAD_MUTEX_INITIALIZER;
+static int _embedded_users = 0;
+static char _embedded_root[EMBEDDED_IO_PATH_LEN] = { '\0' };
+static char _embedded_plugin_dir[EMBEDDED_IO_PATH_LEN] = { '\0' };
+static size_t _embedded_cache_limit = 0;
+static _embedded_table *_embedded_cache_head = NULL, *_embedded_cache_tail = NULL;
+static _embedded_primitive *_embedded_primitives = NULL;
+static int _embedded_num_primitives = 0;
+
+/*
+ * Values
+ */
+
+static void _embedded_value_free(_embedded_value * value)
+{
+	if (value->owned && value->s)
+		free(value->s);
+	memset(value, 0, sizeof(_embedded_value));
+}
+
+//Make a private copy of a borrowed string
+static int _embedded_value_own(_embedded_value * value)
+{
+	if (!EMBEDDED_IO_IS_TEXT(value) || value->owned)
+		return EMBEDDED_IO_SUCCESS;
+	char *s = (char *) malloc(value->length + 1);
+	if (!s)
+		return EMBEDDED_IO_MEMORY_ERROR;
+	if (value->length)
+		memcpy(s, value->s, value->length);
+	s[value->length] = 0;
+	value->s = s;
+	value->owned = 1;
+	return EMBEDDED_IO_SUCCESS;
+}
+
+static void _embedded_value_set_int(_embedded_value * value, long long l)
+{
+	memset(value, 0, sizeof(_embedded_value));
+	value->type = EMBEDDED_IO_VALUE_INT;
+	value->l = l;
+}
+
+static void _embedded_value_set_real(_embedded_value * value, double d)
+{
+	memset(value, 0, sizeof(_embedded_value));
+	value->type = EMBEDDED_IO_VALUE_REAL;
+	value->d = d;
+}
+
+static void _embedded_value_text(const _embedded_value * value, char *buffer)
+{
+	unsigned long length = value->length < EMBEDDED_IO_NUM_LEN ? value->length : EMBEDDED_IO_NUM_LEN - 1;
+	if (length)
+		memcpy(buffer, value->s, length);
+	buffer[length] = 0;
+}
+
+static double _embedded_value_to_double(const _embedded_value * value)
+{
+	char buffer[EMBEDDED_IO_NUM_LEN];
+	switch (value->type) {
+		case EMBEDDED_IO_VALUE_INT:
+			return (double) value->l;
+		case EMBEDDED_IO_VALUE_REAL:
+			return value->d;
+		case EMBEDDED_IO_VALUE_DECIMAL:
+		case EMBEDDED_IO_VALUE_STRING:
+			_embedded_value_text(value, buffer);
+			return strtod(buffer, NULL);
+		default:
+			return 0;
+	}
+}
+
+static long long _embedded_value_to_long(const _embedded_value * value)
+{
+	char buffer[EMBEDDED_IO_NUM_LEN];
+	double d;
+	switch (value->type) {
+		case EMBEDDED_IO_VALUE_INT:
+			return value->l;
+		case EMBEDDED_IO_VALUE_REAL:
+			return (long long) llround(value->d);
+		case EMBEDDED_IO_VALUE_DECIMAL:
+		case EMBEDDED_IO_VALUE_STRING:
+			_embedded_value_text(value, buffer);
+			if (!strpbrk(buffer, ".eE"))
+				return strtoll(buffer, NULL, 10);
+			d = strtod(buffer, NULL);
+			return (long long) llround(d);
+		default:
+			return 0;
+	}
+}
+
+//Text representation of a numeric value (the shortest one that can be read back without loss)
+static int _embedded_value_format(const _embedded_value * value, char *buffer)
+{
+	if (value->type == EMBEDDED_IO_VALUE_INT)
+		return snprintf(buffer, EMBEDDED_IO_NUM_LEN, "%lld", value->l);
+	int n = snprintf(buffer, EMBEDDED_IO_NUM_LEN, "%.15g", value->d);
+	if (strtod(buffer, NULL) != value->d)
+		n = snprintf(buffer, EMBEDDED_IO_NUM_LEN, "%.17g", value->d);
+	return n;
+}
+
+//Convert a value to the type of a column (0 for any type)
+static int _embedded_value_convert(_embedded_value * value, char type)
+{
+	if (!type || (value->type == EMBEDDED_IO_VALUE_NULL) || (value->type == type))
+		return EMBEDDED_IO_SUCCESS;
+
+	switch (type) {
+		case EMBEDDED_IO_VALUE_INT:{
+				long long l = _embedded_value_to_long(value);
+				_embedded_value_free(value);
+				_embedded_value_set_int(value, l);
+				break;
+			}
+		case EMBEDDED_IO_VALUE_REAL:{
+				double d = _embedded_value_to_double(value);
+				_embedded_value_free(value);
+				_embedded_value_set_real(value, d);
+				break;
+			}
+		default:
+			if (EMBEDDED_IO_IS_TEXT(value))
+				value->type = type;
+			else {
+				char buffer[EMBEDDED_IO_NUM_LEN];
+				int n = _embedded_value_format(value, buffer);
+				char *s = strndup(buffer, n);
+				if (!s)
+					return EMBEDDED_IO_MEMORY_ERROR;
+				_embedded_value_free(value);
+				value->type = type;
+				value->owned = 1;
+				value->s = s;
+				value->length = n;
+			}
+	}
+
+	return EMBEDDED_IO_SUCCESS;
+}
+
+//Compare two values that are not NULL
+static int _embedded_value_compare(const _embedded_value * a, const _embedded_value * b)
+{
+	if ((a->type == EMBEDDED_IO_VALUE_STRING) && (b->type == EMBEDDED_IO_VALUE_STRING)) {
+		int res = 0;
+		unsigned long length = a->length < b->length ? a->length : b->length;
+		if (length)
+			res = memcmp(a->s, b->s, length);
+		if (!res)
+			res = a->length < b->length ? -1 : a->length > b->length;
+		return res;
+	}
+	if ((a->type == EMBEDDED_IO_VALUE_INT) && (b->type == EMBEDDED_IO_VALUE_INT))
+		return a->l < b->l ? -1 : a->l > b->l;
+	double x = _embedded_value_to_double(a), y = _embedded_value_to_double(b);
+	return x < y ? -1 : x > y;
+}
+
+//Compare two values for sorting and grouping: NULL values come first
+static int _embedded_value_sort_compare(const _embedded_value * a, const _embedded_value * b)
+{
+	if (a->type == EMBEDDED_IO_VALUE_NULL)
+		return b->type == EMBEDDED_IO_VALUE_NULL ? 0 : -1;
+	if (b->type == EMBEDDED_IO_VALUE_NULL)
+		return 1;
+	return _embedded_value_compare(a, b);
+}
+
+//Truth value: -1 for NULL
+static int _embedded_value_truth(const _embedded_value * value)
+{
+	switch (value->type) {
+		case EMBEDDED_IO_VALUE_NULL:
+			return -1;
+		case EMBEDDED_IO_VALUE_INT:
+			return value->l != 0;
+		case EMBEDDED_IO_VALUE_REAL:
+			return value->d != 0;
+		default:
+			return _embedded_value_to_double(value) != 0;
+	}
+}
+
+//Case-insensitive pattern matching with '%', '_' and '\' as escape character
+static int _embedded_like(const char *s, unsigned long slen, const char *p, unsigned long plen)
+{
+	unsigned long i = 0, j = 0, star_s = 0;
+	long star_p = -1;
+
+	while (i < slen) {
+		if ((j < plen) && (p[j] == '%')) {
+			star_p = ++j;
+			star_s = i;
+			continue;
+		}
+		if (j < plen) {
+			char c = p[j], any = 0;
+			unsigned long step = 1;
+			if ((c == '\\') && (j + 1 < plen)) {
+				c = p[j + 1];
+				step = 2;
+			} else if (c == '_')
+				any = 1;
+			if (any || (tolower((unsigned char) c) == tolower((unsigned char) s[i]))) {
+				i++;
+				j += step;
+				continue;
+			}
+		}
+		if (star_p < 0)
+			return 0;
+		j = star_p;
+		i = ++star_s;
+	}
+	while ((j < plen) && (p[j] == '%'))
+		j++;
+
+	return j == plen;
+}
+
+static char _embedded_column_type(const char *type)
+{
+	if (!strncasecmp(type, "long", 4) || !strncasecmp(type, "int", 3) || !strncasecmp(type, "bigint", 6) || !strncasecmp(type, "smallint", 8) || !strncasecmp(type, "tinyint", 7))
+		return EMBEDDED_IO_VALUE_INT;
+	if (!strncasecmp(type, "double", 6) || !strncasecmp(type, "float", 5) || !strncasecmp(type, "real", 4))
+		return EMBEDDED_IO_VALUE_REAL;
+	if (!strncasecmp(type, "decimal", 7))
+		return EMBEDDED_IO_VALUE_DECIMAL;
+	return EMBEDDED_IO_VALUE_STRING;
+}
+
+/*
+ * Fragments
+ */
+
+static int _embedded_valid_name(const char *name)
+{
+	return name && *name && !strchr(name, '/') && strcmp(name, ".") && strcmp(name, "..");
+}
+
+//Path of a database (name is NULL) or of a fragment
+static int _embedded_path(char *path, const char *db, const char *name)
+{
+	if (!_embedded_valid_name(db) || (name && !_embedded_valid_name(name)))
+		return EMBEDDED_IO_ERROR;
+	int n = name ? snprintf(path, EMBEDDED_IO_PATH_LEN, "%s/%s/%s", _embedded_root, db, name) : snprintf(path, EMBEDDED_IO_PATH_LEN, "%s/%s", _embedded_root, db);
+	return n < EMBEDDED_IO_PATH_LEN ? EMBEDDED_IO_SUCCESS : EMBEDDED_IO_ERROR;
+}
+
+static void _embedded_table_free(_embedded_table * table)
+{
+	unsigned long long i;
+	unsigned int j;
+
+	if (!table)
+		return;
+	if (table->cells) {
+		for (i = 0; i < table->num_rows * table->num_columns; i++)
+			_embedded_value_free(table->cells + i);
+		free(table->cells);
+	}
+	if (table->map)
+		munmap(table->map, table->map_size);
+	if (table->columns) {
+		for (j = 0; j < table->num_columns; j++)
+			if (table->columns[j])
+				free(table->columns[j]);
+		free(table->columns);
+	}
+	if (table->types)
+		free(table->types);
+	if (table->db)
+		free(table->db);
+	if (table->name)
+		free(table->name);
+	pthread_rwlock_destroy(&table->lock);
+	free(table);
+}
+
+static _embedded_table *_embedded_table_new(const char *db, const char *name, unsigned int num_columns)
+{
+	_embedded_table *table = (_embedded_table *) calloc(1, sizeof(_embedded_table));
+	if (!table)
+		return NULL;
+	pthread_rwlock_init(&table->lock, NULL);
+	table->num_columns = num_columns;
+	if (!(table->db = strdup(db)) || !(table->name = strdup(name)) || !(table->columns = (char **) calloc(num_columns + 1, sizeof(char *)))
+	    || !(table->types = (char *) calloc(num_columns + 1, sizeof(char)))) {
+		_embedded_table_free(table);
+		return NULL;
+	}
+	return table;
+}
+
+//Write the fragment into a temporary file and move it in place of the old version
+//Call it with a reference and a read lock on the fragment, but without _embedded_lock: the lock is only taken to replace the file
+//Each thread uses its own temporary file, so the same version can be saved concurrently
+static int _embedded_table_save(oph_ioserver_handler * handle, _embedded_table * table)
+{
+	char path[EMBEDDED_IO_PATH_LEN], tmp[EMBEDDED_IO_PATH_LEN + EMBEDDED_IO_NUM_LEN];
+	if (_embedded_path(path, table->db, table->name)) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_STORAGE_ERROR, table->name, "invalid name");
+		return EMBEDDED_IO_ERROR;
+	}
+	snprintf(tmp, sizeof(tmp), EMBEDDED_IO_FILE_TMP, path, (int) getpid(), (unsigned long) pthread_self());
+
+	FILE *file = fopen(tmp, "w");
+	if (!file) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_STORAGE_ERROR, tmp, strerror(errno));
+		return EMBEDDED_IO_ERROR;
+	}
+	char *buffer = (char *) malloc(EMBEDDED_IO_WRITE_BUFFER);
+	if (buffer)
+		setvbuf(file, buffer, _IOFBF, EMBEDDED_IO_WRITE_BUFFER);
+
+	//Values are written in native byte order: the header allows to detect files written by other architectures
+	uint32_t byte_order = EMBEDDED_IO_FILE_BYTE_ORDER, version = EMBEDDED_IO_FILE_VERSION, num_columns = table->num_columns, length32;
+	uint64_t num_rows = table->num_rows, length64;
+	unsigned long long i;
+	unsigned int j;
+	int64_t l;
+	uint8_t type;
+	int error = (fwrite(EMBEDDED_IO_FILE_MAGIC, 1, EMBEDDED_IO_FILE_MAGIC_LEN, file) != EMBEDDED_IO_FILE_MAGIC_LEN) || (fwrite(&byte_order, sizeof(uint32_t), 1, file) != 1)
+	    || (fwrite(&version, sizeof(uint32_t), 1, file) != 1) || (fwrite(&num_columns, sizeof(uint32_t), 1, file) != 1) || (fwrite(&num_rows, sizeof(uint64_t), 1, file) != 1);
+
+	for (j = 0; !error && (j < table->num_columns); j++) {
+		length32 = strlen(table->columns[j]);
+		type = EMBEDDED_IO_COLUMN_TYPE(table, j);
+		error = (fwrite(&length32, sizeof(uint32_t), 1, file) != 1) || (fwrite(table->columns[j], 1, length32, file) != length32) || (fwrite(&type, sizeof(uint8_t), 1, file) != 1);
+	}
+
+	_embedded_value *cell;
+	for (i = 0; !error && (i < table->num_rows * table->num_columns); i++) {
+		cell = table->cells + i;
+		type = cell->type;
+		if (fwrite(&type, sizeof(uint8_t), 1, file) != 1) {
+			error = 1;
+			break;
+		}
+		switch (cell->type) {
+			case EMBEDDED_IO_VALUE_INT:
+				l = cell->l;
+				error = fwrite(&l, sizeof(int64_t), 1, file) != 1;
+				break;
+			case EMBEDDED_IO_VALUE_REAL:
+				error = fwrite(&cell->d, sizeof(double), 1, file) != 1;
+				break;
+			case EMBEDDED_IO_VALUE_DECIMAL:
+			case EMBEDDED_IO_VALUE_STRING:
+				length64 = cell->length;
+				error = (fwrite(&length64, sizeof(uint64_t), 1, file) != 1) || (cell->length && (fwrite(cell->s, 1, cell->length, file) != cell->length)) || (fputc(0, file) == EOF);
+				break;
+			default:
+				break;
+		}
+	}
+
+	if (fclose(file))
+		error = 1;
+	if (buffer)
+		free(buffer);
+
+	//The fragment could have been dropped in the meantime
+	pthread_mutex_lock(&_embedded_lock);
+	if (table->dropped) {
+		pthread_mutex_unlock(&_embedded_lock);
+		unlink(tmp);
+		return EMBEDDED_IO_SUCCESS;
+	}
+	if (error || rename(tmp, path)) {
+		pthread_mutex_unlock(&_embedded_lock);
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_STORAGE_ERROR, path, strerror(errno));
+		unlink(tmp);
+		return EMBEDDED_IO_ERROR;
+	}
+
+	struct stat st;
+	if (!stat(path, &st)) {
+		table->ino = st.st_ino;
+		table->mtime = st.st_mtime;
+		table->size = st.st_size;
+	}
+	table->dirty = 0;
+	pthread_mutex_unlock(&_embedded_lock);
+
+	return EMBEDDED_IO_SUCCESS;
+}
+
+static int _embedded_read(const char **p, const char *end, void *data, size_t size)
+{
+	if ((size_t) (end - *p) < size)
+		return EMBEDDED_IO_ERROR;
+	memcpy(data, *p, size);
+	*p += size;
+	return EMBEDDED_IO_SUCCESS;
+}
+
+//Map a fragment file in memory: strings are not copied
+static int _embedded_table_load(oph_ioserver_handler * handle, const char *db, const char *name, const char *path, _embedded_table ** table)
+{
+	*table = NULL;
+
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		if (errno == ENOENT)
+			return EMBEDDED_IO_NOT_FOUND;
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_STORAGE_ERROR, path, strerror(errno));
+		return EMBEDDED_IO_ERROR;
+	}
+	struct stat st;
+	if (fstat(fd, &st)) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_STORAGE_ERROR, path, strerror(errno));
+		close(fd);
+		return EMBEDDED_IO_ERROR;
+	}
+	size_t size = st.st_size;
+	if (size < EMBEDDED_IO_FILE_MAGIC_LEN + 3 * sizeof(uint32_t) + sizeof(uint64_t)) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_STORAGE_ERROR, path, "file is corrupted");
+		close(fd);
+		return EMBEDDED_IO_ERROR;
+	}
+	//Private mapping: result rows can be changed by the caller without affecting the file
+	void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_STORAGE_ERROR, path, strerror(errno));
+		return EMBEDDED_IO_ERROR;
+	}
+
+	const char *p = (const char *) map + EMBEDDED_IO_FILE_MAGIC_LEN, *end = (const char *) map + size;
+	uint32_t byte_order = 0, version = 0, num_columns = 0, length32;
+	uint64_t num_rows = 0, length64;
+	int64_t l;
+	uint8_t type;
+	unsigned long long i;
+	unsigned int j;
+	_embedded_table *t = NULL;
+	if (memcmp(map, EMBEDDED_IO_FILE_MAGIC, EMBEDDED_IO_FILE_MAGIC_LEN) || _embedded_read(&p, end, &byte_order, sizeof(uint32_t)) || _embedded_read(&p, end, &version, sizeof(uint32_t))
+	    || (byte_order != EMBEDDED_IO_FILE_BYTE_ORDER) || (version != EMBEDDED_IO_FILE_VERSION)) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_STORAGE_ERROR, path, byte_order == EMBEDDED_IO_FILE_BYTE_ORDER ? "unsupported file version" : "unsupported file format or byte order");
+		munmap(map, size);
+		return EMBEDDED_IO_ERROR;
+	}
+	int error = _embedded_read(&p, end, &num_columns, sizeof(uint32_t)) || _embedded_read(&p, end, &num_rows, sizeof(uint64_t)) || !num_columns || (num_rows > size / num_columns);
+
+	if (!error && !(t = _embedded_table_new(db, name, num_columns))) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+		munmap(map, size);
+		return EMBEDDED_IO_MEMORY_ERROR;
+	}
+	if (t) {
+		t->map = map;
+		t->map_size = size;
+	}
+
+	for (j = 0; !error && (j < num_columns); j++) {
+		if (_embedded_read(&p, end, &length32, sizeof(uint32_t)) || ((size_t) (end - p) < (size_t) length32 + 1))
+			error = 1;
+		else if (!(t->columns[j] = strndup(p, length32)))
+			error = -1;
+		else {
+			p += length32;
+			t->types[j] = *p++;
+		}
+	}
+
+	if (!error && num_rows && !(t->cells = (_embedded_value *) calloc(num_rows * num_columns, sizeof(_embedded_value))))
+		error = -1;
+	if (!error)
+		t->max_rows = num_rows;
+	_embedded_value *cell;
+	for (i = 0; !error && (i < num_rows * num_columns); i++) {
+		cell = t->cells + i;
+		if (_embedded_read(&p, end, &type, sizeof(uint8_t))) {
+			error = 1;
+			break;
+		}
+		cell->type = type;
+		switch (type) {
+			case EMBEDDED_IO_VALUE_NULL:
+				break;
+			case EMBEDDED_IO_VALUE_INT:
+				error = _embedded_read(&p, end, &l, sizeof(int64_t));
+				cell->l = l;
+				break;
+			case EMBEDDED_IO_VALUE_REAL:
+				error = _embedded_read(&p, end, &cell->d, sizeof(double));
+				break;
+			case EMBEDDED_IO_VALUE_DECIMAL:
+			case EMBEDDED_IO_VALUE_STRING:
+				if (_embedded_read(&p, end, &length64, sizeof(uint64_t)) || (length64 >= (uint64_t) (end - p)) || p[length64]) {
+					error = 1;
+					break;
+				}
+				cell->s = (char *) p;
+				cell->length = length64;
+				p += length64 + 1;
+				break;
+			default:
+				error = 1;
+		}
+		if (!error)
+			t->num_rows = (i + 1) / num_columns;
+	}
+
+	if (error) {
+		if (error < 0) {
+			EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+		} else {
+			EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_STORAGE_ERROR, path, "file is corrupted");
+		}
+		if (t)
+			_embedded_table_free(t);
+		else
+			munmap(map, size);
+		return EMBEDDED_IO_ERROR;
+	}
+
+	t->ino = st.st_ino;
+	t->mtime = st.st_mtime;
+	t->size = st.st_size;
+	t->mem_size = t->max_rows * t->num_columns * sizeof(_embedded_value) + t->map_size;
+	*table = t;
+
+	return EMBEDDED_IO_SUCCESS;
+}
+
+//Move a row of values at the end of the fragment; call it with the write lock held
+static int _embedded_table_append(_embedded_table * table, _embedded_value * values)
+{
+	unsigned int j;
+
+	if (table->num_rows == table->max_rows) {
+		unsigned long long max_rows = table->max_rows ? 2 * table->max_rows : EMBEDDED_IO_MIN_ROWS;
+		_embedded_value *cells = (_embedded_value *) realloc(table->cells, max_rows * table->num_columns * sizeof(_embedded_value));
+		if (!cells)
+			return EMBEDDED_IO_MEMORY_ERROR;
+		table->cells = cells;
+		table->mem_size += (max_rows - table->max_rows) * table->num_columns * sizeof(_embedded_value);
+		table->max_rows = max_rows;
+	}
+
+	_embedded_value *row = table->cells + table->num_rows * table->num_columns;
+	for (j = 0; j < table->num_columns; j++) {
+		if (_embedded_value_convert(values + j, EMBEDDED_IO_COLUMN_TYPE(table, j)) || _embedded_value_own(values + j)) {
+			while (j--)
+				_embedded_value_free(row + j);
+			return EMBEDDED_IO_MEMORY_ERROR;
+		}
+		row[j] = values[j];
+		memset(values + j, 0, sizeof(_embedded_value));
+		if (EMBEDDED_IO_IS_TEXT(row + j))
+			table->mem_size += row[j].length + 1;
+	}
+	table->num_rows++;
+	table->dirty = 1;
+
+	return EMBEDDED_IO_SUCCESS;
+}
+
+//Virtual fragment listing the primitives
+static int _embedded_function_table(_embedded_table ** table)
+{
+	char columns[] = EMBEDDED_IO_FUNC_TABLE_COLUMNS, *save_pointer = NULL, *column;
+	unsigned int j = 0;
+	int i;
+
+	_embedded_table *t = _embedded_table_new("mysql", "func", 4);
+	if (!t)
+		return EMBEDDED_IO_MEMORY_ERROR;
+	for (column = strtok_r(columns, "|", &save_pointer); column && (j < t->num_columns); column = strtok_r(NULL, "|", &save_pointer), j++) {
+		if (!(t->columns[j] = strdup(column))) {
+			_embedded_table_free(t);
+			return EMBEDDED_IO_MEMORY_ERROR;
+		}
+		t->types[j] = j == 1 ? EMBEDDED_IO_VALUE_INT : EMBEDDED_IO_VALUE_STRING;
+	}
+	if (_embedded_num_primitives && !(t->cells = (_embedded_value *) calloc(_embedded_num_primitives * t->num_columns, sizeof(_embedded_value)))) {
+		_embedded_table_free(t);
+		return EMBEDDED_IO_MEMORY_ERROR;
+	}
+	for (i = 0; i < _embedded_num_primitives; i++) {
+		_embedded_value *row = t->cells + i * t->num_columns;
+		row[0].type = row[2].type = row[3].type = EMBEDDED_IO_VALUE_STRING;
+		row[0].s = _embedded_primitives[i].name;
+		row[0].length = strlen(row[0].s);
+		_embedded_value_set_int(row + 1, _embedded_primitives[i].ret);
+		row[2].s = _embedded_primitives[i].dl;
+		row[2].length = strlen(row[2].s);
+		row[3].s = _embedded_primitives[i].type;
+		row[3].length = strlen(row[3].s);
+	}
+	t->num_rows = t->max_rows = _embedded_num_primitives;
+	//Not cached: it is freed when released
+	t->refcount = 1;
+	t->dropped = 1;
+	*table = t;
+
+	return EMBEDDED_IO_SUCCESS;
+}
+
+/*
+ * Cache of fragments (LRU list); call these functions with _embedded_lock held
+ */
+
+static _embedded_table *_embedded_cache_find(const char *db, const char *name)
+{
+	_embedded_table *table;
+	for (table = _embedded_cache_head; table; table = table->next)
+		if (!strcmp(table->name, name) && !strcmp(table->db, db))
+			return table;
+	return NULL;
+}
+
+static void _embedded_cache_link(_embedded_table * table)
+{
+	table->prev = NULL;
+	table->next = _embedded_cache_head;
+	if (_embedded_cache_head)
+		_embedded_cache_head->prev = table;
+	else
+		_embedded_cache_tail = table;
+	_embedded_cache_head = table;
+}
+
+static void _embedded_cache_unlink(_embedded_table * table)
+{
+	if (table->prev)
+		table->prev->next = table->next;
+	else
+		_embedded_cache_head = table->next;
+	if (table->next)
+		table->next->prev = table->prev;
+	else
+		_embedded_cache_tail = table->prev;
+	table->prev = table->next = NULL;
+}
+
+//Take a reference to a fragment to be saved after _embedded_lock is released; fragments already being saved are skipped
+static void _embedded_cache_pin(_embedded_table * table, _embedded_table ** pinned, int *num_pinned)
+{
+	if (table->saving)
+		return;
+	table->saving = 1;
+	table->refcount++;
+	pinned[(*num_pinned)++] = table;
+}
+
+//Save the fragments pinned by _embedded_cache_pin and release them; call it without _embedded_lock
+static int _embedded_cache_save(oph_ioserver_handler * handle, _embedded_table ** pinned, int num_pinned)
+{
+	int i, res = EMBEDDED_IO_SUCCESS;
+
+	for (i = 0; i < num_pinned; i++) {
+		pthread_rwlock_rdlock(&pinned[i]->lock);
+		if (pinned[i]->dirty && _embedded_table_save(handle, pinned[i]))
+			res = EMBEDDED_IO_ERROR;
+		pthread_rwlock_unlock(&pinned[i]->lock);
+	}
+
+	pthread_mutex_lock(&_embedded_lock);
+	for (i = 0; i < num_pinned; i++) {
+		pinned[i]->saving = 0;
+		if (!--pinned[i]->refcount && pinned[i]->dropped)
+			_embedded_table_free(pinned[i]);
+	}
+	pthread_mutex_unlock(&_embedded_lock);
+
+	return res;
+}
+
+//Evict the least recently used fragments until the cache fits its size limit
+//Changed fragments are not evicted: when pinned is not NULL, they are added to it to be saved by the caller
+static void _embedded_cache_trim(oph_ioserver_handler * handle, _embedded_table ** pinned, int *num_pinned)
+{
+	_embedded_table *table, *prev;
+	size_t size = 0;
+	int count = 0;
+
+	for (table = _embedded_cache_head; table; table = table->next, count++) {
+		//Fragments being written are accounted when they are released
+		if (pthread_rwlock_tryrdlock(&table->lock))
+			continue;
+		size += table->mem_size;
+		pthread_rwlock_unlock(&table->lock);
+	}
+	pmesg(LOG_DEBUG, __FILE__, __LINE__, OPH_IOSERVER_LOG_EMBEDDED_CACHE_STATS, count, size);
+
+	for (table = _embedded_cache_tail; table && (size > _embedded_cache_limit); table = prev) {
+		prev = table->prev;
+		if (table->refcount)
+			continue;
+		size -= table->mem_size < size ? table->mem_size : size;
+		if (table->dirty) {
+			if (pinned && (*num_pinned < count))
+				_embedded_cache_pin(table, pinned, num_pinned);
+			continue;
+		}
+		_embedded_cache_unlink(table);
+		_embedded_table_free(table);
+	}
+}
+
+//Take a reference to a fragment, loading it if needed
+static int _embedded_cache_acquire(oph_ioserver_handler * handle, const char *db, const char *name, char must_exist, _embedded_table ** table)
+{
+	char path[EMBEDDED_IO_PATH_LEN];
+	*table = NULL;
+	if (!db) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_NO_DB);
+		return EMBEDDED_IO_ERROR;
+	}
+	if (_embedded_path(path, db, name)) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_STORAGE_ERROR, name, "invalid name");
+		return EMBEDDED_IO_ERROR;
+	}
+
+	pthread_mutex_lock(&_embedded_lock);
+	_embedded_table *t = _embedded_cache_find(db, name);
+	if (t && !t->refcount && !t->dirty) {
+		//Drop the cached version if the file has been changed by another process
+		struct stat st;
+		if (stat(path, &st) || (st.st_ino != t->ino) || (st.st_mtime != t->mtime) || (st.st_size != t->size)) {
+			_embedded_cache_unlink(t);
+			_embedded_table_free(t);
+			t = NULL;
+		}
+	}
+	if (!t) {
+		int res = _embedded_table_load(handle, db, name, path, &t);
+		if (res) {
+			pthread_mutex_unlock(&_embedded_lock);
+			if (res != EMBEDDED_IO_NOT_FOUND)
+				return EMBEDDED_IO_ERROR;
+			if (!must_exist)
+				return EMBEDDED_IO_SUCCESS;
+			EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_TABLE_NOT_FOUND, name);
+			return EMBEDDED_IO_ERROR;
+		}
+	} else
+		_embedded_cache_unlink(t);
+	_embedded_cache_link(t);
+	t->refcount++;
+	pthread_mutex_unlock(&_embedded_lock);
+
+	*table = t;
+
+	return EMBEDDED_IO_SUCCESS;
+}
+
+//Release a reference to a fragment; call it with no lock held on the fragment
+static void _embedded_cache_release(oph_ioserver_handler * handle, _embedded_table * table)
+{
+	if (!table)
+		return;
+	_embedded_table **pinned = NULL;
+	int num_pinned = 0;
+
+	pthread_mutex_lock(&_embedded_lock);
+	if (!--table->refcount) {
+		if (table->dropped)
+			_embedded_table_free(table);
+		else {
+			//Changed fragments to be evicted are saved once the lock is released; they are kept in memory if the list cannot be allocated
+			int count = 0;
+			_embedded_table *t;
+			for (t = _embedded_cache_head; t; t = t->next)
+				count++;
+			pinned = (_embedded_table **) malloc(count * sizeof(_embedded_table *));
+			_embedded_cache_trim(handle, pinned, &num_pinned);
+		}
+	}
+	pthread_mutex_unlock(&_embedded_lock);
+
+	if (num_pinned) {
+		//Files are written without blocking the other users of the cache, then saved fragments can be evicted
+		_embedded_cache_save(handle, pinned, num_pinned);
+		pthread_mutex_lock(&_embedded_lock);
+		_embedded_cache_trim(handle, NULL, NULL);
+		pthread_mutex_unlock(&_embedded_lock);
+	}
+	if (pinned)
+		free(pinned);
+}
+
+//Save a fragment if it has been changed in memory; fragments no longer cached have already been saved
+static int _embedded_cache_commit(oph_ioserver_handler * handle, const char *db, const char *name)
+{
+	pthread_mutex_lock(&_embedded_lock);
+	_embedded_table *table = _embedded_cache_find(db, name);
+	if (!table || !table->dirty) {
+		pthread_mutex_unlock(&_embedded_lock);
+		return EMBEDDED_IO_SUCCESS;
+	}
+	table->refcount++;
+	pthread_mutex_unlock(&_embedded_lock);
+
+	int res = EMBEDDED_IO_SUCCESS;
+	pthread_rwlock_rdlock(&table->lock);
+	pthread_mutex_lock(&_embedded_lock);
+	char dirty = table->dirty;
+	pthread_mutex_unlock(&_embedded_lock);
+	if (dirty)
+		res = _embedded_table_save(handle, table);
+	pthread_rwlock_unlock(&table->lock);
+	_embedded_cache_release(handle, table);
+
+	return res;
+}
+
+//Create an empty fragment and take a reference to it
+static int _embedded_cache_create(oph_ioserver_handler * handle, const char *db, const char *name, unsigned int num_columns, char **columns, const char *types, _embedded_table ** table)
+{
+	char path[EMBEDDED_IO_PATH_LEN];
+	struct stat st;
+	unsigned int j;
+
+	*table = NULL;
+	if (!db) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_NO_DB);
+		return EMBEDDED_IO_ERROR;
+	}
+	if (_embedded_path(path, db, NULL) || stat(path, &st) || !S_ISDIR(st.st_mode)) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_USE_DB_ERROR, db);
+		return EMBEDDED_IO_ERROR;
+	}
+	if (_embedded_path(path, db, name)) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_STORAGE_ERROR, name, "invalid name");
+		return EMBEDDED_IO_ERROR;
+	}
+
+	_embedded_table *t = _embedded_table_new(db, name, num_columns);
+	if (!t) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+		return EMBEDDED_IO_MEMORY_ERROR;
+	}
+	for (j = 0; j < num_columns; j++) {
+		if (!(t->columns[j] = strdup(columns[j]))) {
+			EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+			_embedded_table_free(t);
+			return EMBEDDED_IO_MEMORY_ERROR;
+		}
+		t->types[j] = types ? types[j] : 0;
+	}
+
+	pthread_mutex_lock(&_embedded_lock);
+	if (_embedded_cache_find(db, name) || !access(path, F_OK)) {
+		pthread_mutex_unlock(&_embedded_lock);
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_TABLE_EXISTS, name);
+		_embedded_table_free(t);
+		return EMBEDDED_IO_ERROR;
+	}
+	t->dirty = 1;
+	t->refcount = 1;
+	_embedded_cache_link(t);
+	pthread_mutex_unlock(&_embedded_lock);
+
+	*table = t;
+
+	return EMBEDDED_IO_SUCCESS;
+}
+
+//Drop a fragment; fragments still in use are freed when they are released
+static int _embedded_cache_drop(oph_ioserver_handler * handle, const char *db, const char *name)
+{
+	char path[EMBEDDED_IO_PATH_LEN];
+	if (!db) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_NO_DB);
+		return EMBEDDED_IO_ERROR;
+	}
+	if (_embedded_path(path, db, name)) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_STORAGE_ERROR, name, "invalid name");
+		return EMBEDDED_IO_ERROR;
+	}
+
+	pthread_mutex_lock(&_embedded_lock);
+	_embedded_table *t = _embedded_cache_find(db, name);
+	if (t) {
+		_embedded_cache_unlink(t);
+		if (t->refcount)
+			t->dropped = 1;
+		else
+			_embedded_table_free(t);
+	}
+	if (unlink(path) && (errno != ENOENT)) {
+		pthread_mutex_unlock(&_embedded_lock);
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_STORAGE_ERROR, path, strerror(errno));
+		return EMBEDDED_IO_ERROR;
+	}
+	pthread_mutex_unlock(&_embedded_lock);
+
+	return EMBEDDED_IO_SUCCESS;
+}
+
+static int _embedded_database_create(oph_ioserver_handler * handle, const char *db)
+{
+	char path[EMBEDDED_IO_PATH_LEN];
+	if (_embedded_path(path, db, NULL)) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_STORAGE_ERROR, db ? db : "", "invalid name");
+		return EMBEDDED_IO_ERROR;
+	}
+	if (mkdir(path, 0755) && (errno != EEXIST)) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_STORAGE_ERROR, path, strerror(errno));
+		return EMBEDDED_IO_ERROR;
+	}
+	return EMBEDDED_IO_SUCCESS;
+}
+
+static int _embedded_database_drop(oph_ioserver_handler * handle, const char *db)
+{
+	char path[EMBEDDED_IO_PATH_LEN], file_path[EMBEDDED_IO_PATH_LEN];
+	if (_embedded_path(path, db, NULL)) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_STORAGE_ERROR, db ? db : "", "invalid name");
+		return EMBEDDED_IO_ERROR;
+	}
+
+	_embedded_table *table, *next;
+	struct dirent *entry;
+	DIR *dir;
+	int res = EMBEDDED_IO_SUCCESS;
+
+	pthread_mutex_lock(&_embedded_lock);
+	for (table = _embedded_cache_head; table; table = next) {
+		next = table->next;
+		if (strcmp(table->db, db))
+			continue;
+		_embedded_cache_unlink(table);
+		if (table->refcount)
+			table->dropped = 1;
+		else
+			_embedded_table_free(table);
+	}
+	if ((dir = opendir(path))) {
+		while ((entry = readdir(dir))) {
+			if (!strcmp(entry->d_name, ".") || !strcmp(entry->d_name, ".."))
+				continue;
+			snprintf(file_path, EMBEDDED_IO_PATH_LEN, "%s/%s", path, entry->d_name);
+			unlink(file_path);
+		}
+		closedir(dir);
+	}
+	if (rmdir(path) && (errno != ENOENT)) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_STORAGE_ERROR, path, strerror(errno));
+		res = EMBEDDED_IO_ERROR;
+	}
+	pthread_mutex_unlock(&_embedded_lock);
+
+	return res;
+}
+
+//Save the fragments changed in memory
+static int _embedded_cache_flush(oph_ioserver_handler * handle)
+{
+	_embedded_table *table, **pinned = NULL;
+	int count = 0, num_pinned = 0, res = EMBEDDED_IO_SUCCESS;
+
+	pthread_mutex_lock(&_embedded_lock);
+	for (table = _embedded_cache_head; table; table = table->next)
+		if (table->dirty)
+			count++;
+	if (count && !(pinned = (_embedded_table **) malloc(count * sizeof(_embedded_table *)))) {
+		pthread_mutex_unlock(&_embedded_lock);
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+		return EMBEDDED_IO_MEMORY_ERROR;
+	}
+	for (table = _embedded_cache_head; table; table = table->next)
+		if (table->dirty)
+			_embedded_cache_pin(table, pinned, &num_pinned);
+	pthread_mutex_unlock(&_embedded_lock);
+
+	if (num_pinned)
+		res = _embedded_cache_save(handle, pinned, num_pinned);
+	if (pinned)
+		free(pinned);
+
+	return res;
+}
+
+/*
+ * Primitives
+ */
+
+//Read the list of primitives (name, return type, library and type as in mysql.func)
+static int _embedded_primitives_load(oph_ioserver_handler * handle, const char *file_name)
+{
+	FILE *file = fopen(file_name, "r");
+	if (!file) {
+		pmesg(LOG_WARNING, __FILE__, __LINE__, "Unable to open '%s': no primitive will be available\n", file_name);
+		logging_server(LOG_WARNING, __FILE__, __LINE__, handle->server_type, "Unable to open '%s': no primitive will be available\n", file_name);
+		return EMBEDDED_IO_SUCCESS;
+	}
+
+	char line[2 * EMBEDDED_IO_PATH_LEN], *p, *save_pointer, *name, *ret, *dl, *type;
+	size_t length;
+	_embedded_primitive *primitives, *primitive;
+
+	while (fgets(line, sizeof(line), file)) {
+		for (p = line; isspace((unsigned char) *p); p++);
+		if (!*p || (*p == '#'))
+			continue;
+		for (length = strlen(p); length && isspace((unsigned char) p[length - 1]); length--)
+			p[length - 1] = 0;
+		if (!strncmp(p, EMBEDDED_IO_PLUGIN_DIR, strlen(EMBEDDED_IO_PLUGIN_DIR))) {
+			snprintf(_embedded_plugin_dir, EMBEDDED_IO_PATH_LEN, "%s", p + strlen(EMBEDDED_IO_PLUGIN_DIR));
+			continue;
+		}
+		save_pointer = NULL;
+		name = strtok_r(p, " \t", &save_pointer);
+		ret = strtok_r(NULL, " \t", &save_pointer);
+		dl = strtok_r(NULL, " \t", &save_pointer);
+		type = strtok_r(NULL, " \t", &save_pointer);
+		if (!name || !ret || !dl) {
+			pmesg(LOG_WARNING, __FILE__, __LINE__, "Bad line in '%s': %s\n", file_name, p);
+			logging_server(LOG_WARNING, __FILE__, __LINE__, handle->server_type, "Bad line in '%s': %s\n", file_name, p);
+			continue;
+		}
+		if (!(primitives = (_embedded_primitive *) realloc(_embedded_primitives, (_embedded_num_primitives + 1) * sizeof(_embedded_primitive)))) {
+			EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+			fclose(file);
+			return EMBEDDED_IO_MEMORY_ERROR;
+		}
+		_embedded_primitives = primitives;
+		primitive = _embedded_primitives + _embedded_num_primitives;
+		memset(primitive, 0, sizeof(_embedded_primitive));
+		primitive->ret = (int) strtol(ret, NULL, 10);
+		primitive->aggregate = type && !strcasecmp(type, EMBEDDED_IO_FUNC_TYPE_AGGREGATE);
+		if (!(primitive->name = strdup(name)) || !(primitive->dl = strdup(dl)) || !(primitive->type = strdup(type ? type : "function"))) {
+			EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+			if (primitive->name)
+				free(primitive->name);
+			if (primitive->dl)
+				free(primitive->dl);
+			fclose(file);
+			return EMBEDDED_IO_MEMORY_ERROR;
+		}
+		_embedded_num_primitives++;
+	}
+	fclose(file);
+
+	pmesg(LOG_DEBUG, __FILE__, __LINE__, "Loaded %d primitives from '%s'\n", _embedded_num_primitives, file_name);
+
+	return EMBEDDED_IO_SUCCESS;
+}
+
+static void _embedded_primitives_free()
+{
+	int i;
+	for (i = 0; i < _embedded_num_primitives; i++) {
+		if (_embedded_primitives[i].dlh)
+			dlclose(_embedded_primitives[i].dlh);
+		free(_embedded_primitives[i].name);
+		free(_embedded_primitives[i].dl);
+		free(_embedded_primitives[i].type);
+	}
+	if (_embedded_primitives)
+		free(_embedded_primitives);
+	_embedded_primitives = NULL;
+	_embedded_num_primitives = 0;
+}
+
+static _embedded_primitive *_embedded_primitive_find(const char *name)
+{
+	int i;
+	for (i = 0; i < _embedded_num_primitives; i++)
+		if (!strcasecmp(_embedded_primitives[i].name, name))
+			return _embedded_primitives + i;
+	return NULL;
+}
+
+//Load the library of a primitive the first time it is used
+static int _embedded_primitive_load(oph_ioserver_handler * handle, _embedded_primitive * primitive)
+{
+	char path[EMBEDDED_IO_PATH_LEN], symbol[EMBEDDED_IO_PATH_LEN];
+	int res;
+
+	pthread_mutex_lock(&_embedded_lock);
+	if (!primitive->loaded) {
+		if (strchr(primitive->dl, '/') || !*_embedded_plugin_dir)
+			snprintf(path, EMBEDDED_IO_PATH_LEN, "%s", primitive->dl);
+		else
+			snprintf(path, EMBEDDED_IO_PATH_LEN, "%s/%s", _embedded_plugin_dir, primitive->dl);
+		primitive->loaded = -1;
+		if (!(primitive->dlh = dlopen(path, RTLD_NOW | RTLD_LOCAL))) {
+			EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_PRIMITIVE_ERROR, primitive->name, dlerror());
+		} else {
+			primitive->func = dlsym(primitive->dlh, primitive->name);
+			snprintf(symbol, EMBEDDED_IO_PATH_LEN, "%s_init", primitive->name);
+			primitive->init = (my_bool(*)(UDF_INIT *, UDF_ARGS *, char *)) dlsym(primitive->dlh, symbol);
+			snprintf(symbol, EMBEDDED_IO_PATH_LEN, "%s_deinit", primitive->name);
+			primitive->deinit = (void (*)(UDF_INIT *)) dlsym(primitive->dlh, symbol);
+			if (primitive->aggregate) {
+				snprintf(symbol, EMBEDDED_IO_PATH_LEN, "%s_clear", primitive->name);
+				primitive->clear = (void (*)(UDF_INIT *, char *, char *)) dlsym(primitive->dlh, symbol);
+				snprintf(symbol, EMBEDDED_IO_PATH_LEN, "%s_add", primitive->name);
+				primitive->add = (void (*)(UDF_INIT *, UDF_ARGS *, char *, char *)) dlsym(primitive->dlh, symbol);
+			}
+			if (!primitive->func || (primitive->aggregate && (!primitive->clear || !primitive->add))) {
+				EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_PRIMITIVE_ERROR, primitive->name, "missing symbols");
+				dlclose(primitive->dlh);
+				primitive->dlh = NULL;
+			} else
+				primitive->loaded = 1;
+		}
+	}
+	res = primitive->loaded > 0 ? EMBEDDED_IO_SUCCESS : EMBEDDED_IO_ERROR;
+	pthread_mutex_unlock(&_embedded_lock);
+
+	return res;
+}
+
+/*
+ * Expressions
+ */
+
+static _embedded_expr *_embedded_expr_new(_embedded_expr_kind kind)
+{
+	_embedded_expr *expr = (_embedded_expr *) calloc(1, sizeof(_embedded_expr));
+	if (!expr)
+		return NULL;
+	expr->kind = kind;
+	expr->param = expr->table = expr->column = -1;
+	expr->is_const = 1;
+	return expr;
+}
+
+static void _embedded_expr_free(_embedded_expr * expr)
+{
+	int i;
+
+	if (!expr)
+		return;
+	if (expr->args) {
+		for (i = 0; i < expr->num_args; i++)
+			_embedded_expr_free(expr->args[i]);
+		free(expr->args);
+	}
+	if (expr->text)
+		free(expr->text);
+	if (expr->name)
+		free(expr->name);
+	if (expr->qualifier)
+		free(expr->qualifier);
+	if (expr->kind == EMBEDDED_IO_EXPR_LITERAL)
+		_embedded_value_free(&expr->value);
+	if (expr->udf_args.arg_type)
+		free(expr->udf_args.arg_type);
+	if (expr->udf_args.args)
+		free(expr->udf_args.args);
+	if (expr->udf_args.lengths)
+		free(expr->udf_args.lengths);
+	if (expr->udf_args.maybe_null)
+		free(expr->udf_args.maybe_null);
+	if (expr->udf_args.attributes)
+		free(expr->udf_args.attributes);
+	if (expr->udf_args.attribute_lengths)
+		free(expr->udf_args.attribute_lengths);
+	if (expr->udf_l)
+		free(expr->udf_l);
+	if (expr->udf_d)
+		free(expr->udf_d);
+	if (expr->udf_buf)
+		free(expr->udf_buf);
+	if (expr->result)
+		free(expr->result);
+	free(expr);
+}
+
+/**
+ * \brief           State of the parser of an expression
+ * \param handle    Dynamic server plugin handle
+ * \param statement Statement the placeholders are registered in
+ * \param source    Text of the expression
+ * \param p         Position of the lexer
+ * \param token     Current token
+ * \param start     Beginning of the current token
+ * \param length    Length of the current token
+ * \param last_end  End of the previous token
+ * \param error     Flag set when an error has been reported
+ */
+typedef struct {
+	oph_ioserver_handler *handle;
+	_embedded_statement *statement;
+	const char *source;
+	const char *p;
+	_embedded_token token;
+	const char *start;
+	size_t length;
+	const char *last_end;
+	char error;
+} _embedded_parser;
+
+static int _embedded_is_keyword(_embedded_parser * parser, const char *keyword)
+{
+	return (parser->length == strlen(keyword)) && !strncasecmp(parser->start, keyword, parser->length);
+}
+
+static void _embedded_next(_embedded_parser * parser)
+{
+	const char *p = parser->p;
+
+	parser->last_end = parser->start + parser->length;
+	while (isspace((unsigned char) *p))
+		p++;
+	parser->start = p;
+
+	if (!*p)
+		parser->token = EMBEDDED_IO_TOKEN_END;
+	else if (isalpha((unsigned char) *p) || (*p == '_') || (*p == '$')) {
+		while (isalnum((unsigned char) *p) || (*p == '_') || (*p == '$'))
+			p++;
+		parser->length = p - parser->start;
+		parser->token = EMBEDDED_IO_TOKEN_IDENT;
+		if (_embedded_is_keyword(parser, "AND"))
+			parser->token = EMBEDDED_IO_TOKEN_AND;
+		else if (_embedded_is_keyword(parser, "OR"))
+			parser->token = EMBEDDED_IO_TOKEN_OR;
+		else if (_embedded_is_keyword(parser, "NOT"))
+			parser->token = EMBEDDED_IO_TOKEN_NOT;
+		else if (_embedded_is_keyword(parser, "BETWEEN"))
+			parser->token = EMBEDDED_IO_TOKEN_BETWEEN;
+		else if (_embedded_is_keyword(parser, "IN"))
+			parser->token = EMBEDDED_IO_TOKEN_IN;
+		else if (_embedded_is_keyword(parser, "LIKE"))
+			parser->token = EMBEDDED_IO_TOKEN_LIKE;
+		else if (_embedded_is_keyword(parser, "IS"))
+			parser->token = EMBEDDED_IO_TOKEN_IS;
+		else if (_embedded_is_keyword(parser, "NULL"))
+			parser->token = EMBEDDED_IO_TOKEN_NULL;
+		else if (_embedded_is_keyword(parser, "DIV"))
+			parser->token = EMBEDDED_IO_TOKEN_DIV;
+		else if (_embedded_is_keyword(parser, "MOD"))
+			parser->token = EMBEDDED_IO_TOKEN_PERCENT;
+	} else if (isdigit((unsigned char) *p) || ((*p == '.') && isdigit((unsigned char) p[1]))) {
+		parser->token = EMBEDDED_IO_TOKEN_INT;
+		while (isdigit((unsigned char) *p))
+			p++;
+		if (*p == '.') {
+			parser->token = EMBEDDED_IO_TOKEN_DECIMAL;
+			for (p++; isdigit((unsigned char) *p); p++);
+		}
+		if (((*p == 'e') || (*p == 'E')) && (isdigit((unsigned char) p[1]) || (((p[1] == '+') || (p[1] == '-')) && isdigit((unsigned char) p[2])))) {
+			parser->token = EMBEDDED_IO_TOKEN_REAL;
+			for (p += 2; isdigit((unsigned char) *p); p++);
+		}
+	} else if ((*p == '\'') || (*p == '"')) {
+		char quote = *p++;
+		parser->token = EMBEDDED_IO_TOKEN_ERROR;
+		while (*p) {
+			if ((*p == '\\') && p[1])
+				p += 2;
+			else if (*p == quote) {
+				if (p[1] != quote) {
+					p++;
+					parser->token = EMBEDDED_IO_TOKEN_STRING;
+					break;
+				}
+				p += 2;
+			} else
+				p++;
+		}
+	} else {
+		switch (*p++) {
+			case '?':
+				parser->token = EMBEDDED_IO_TOKEN_PARAM;
+				break;
+			case '(':
+				parser->token = EMBEDDED_IO_TOKEN_LPAREN;
+				break;
+			case ')':
+				parser->token = EMBEDDED_IO_TOKEN_RPAREN;
+				break;
+			case ',':
+				parser->token = EMBEDDED_IO_TOKEN_COMMA;
+				break;
+			case '.':
+				parser->token = EMBEDDED_IO_TOKEN_DOT;
+				break;
+			case '+':
+				parser->token = EMBEDDED_IO_TOKEN_PLUS;
+				break;
+			case '-':
+				parser->token = EMBEDDED_IO_TOKEN_MINUS;
+				break;
+			case '*':
+				parser->token = EMBEDDED_IO_TOKEN_STAR;
+				break;
+			case '/':
+				parser->token = EMBEDDED_IO_TOKEN_SLASH;
+				break;
+			case '%':
+				parser->token = EMBEDDED_IO_TOKEN_PERCENT;
+				break;
+			case '=':
+				parser->token = EMBEDDED_IO_TOKEN_EQ;
+				break;
+			case '<':
+				if (*p == '=') {
+					p++;
+					parser->token = EMBEDDED_IO_TOKEN_LE;
+				} else if (*p == '>') {
+					p++;
+					parser->token = EMBEDDED_IO_TOKEN_NE;
+				} else
+					parser->token = EMBEDDED_IO_TOKEN_LT;
+				break;
+			case '>':
+				if (*p == '=') {
+					p++;
+					parser->token = EMBEDDED_IO_TOKEN_GE;
+				} else
+					parser->token = EMBEDDED_IO_TOKEN_GT;
+				break;
+			case '!':
+				if (*p == '=') {
+					p++;
+					parser->token = EMBEDDED_IO_TOKEN_NE;
+				} else
+					parser->token = EMBEDDED_IO_TOKEN_NOT;
+				break;
+			case '&':
+				parser->token = *p == '&' ? EMBEDDED_IO_TOKEN_AND : EMBEDDED_IO_TOKEN_ERROR;
+				if (*p == '&')
+					p++;
+				break;
+			case '|':
+				parser->token = *p == '|' ? EMBEDDED_IO_TOKEN_OR : EMBEDDED_IO_TOKEN_ERROR;
+				if (*p == '|')
+					p++;
+				break;
+			default:
+				parser->token = EMBEDDED_IO_TOKEN_ERROR;
+		}
+	}
+
+	parser->length = p - parser->start;
+	parser->p = p;
+}
+
+static void _embedded_syntax_error(_embedded_parser * parser)
+{
+	if (!parser->error) {
+		EMBEDDED_IO_LOG(parser->handle, OPH_IOSERVER_LOG_EMBEDDED_SYNTAX_ERROR, parser->source, parser->start);
+	}
+	parser->error = 1;
+}
+
+static void _embedded_memory_error(_embedded_parser * parser)
+{
+	if (!parser->error) {
+		EMBEDDED_IO_LOG(parser->handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+	}
+	parser->error = 1;
+}
+
+//Build a node ending at the previous token; children are freed on error
+static _embedded_expr *_embedded_expr_build(_embedded_parser * parser, _embedded_expr_kind kind, int op, _embedded_expr ** args, int num_args, const char *begin)
+{
+	int i;
+	_embedded_expr *expr = _embedded_expr_new(kind);
+	if (expr && num_args && !(expr->args = (_embedded_expr **) malloc(num_args * sizeof(_embedded_expr *)))) {
+		free(expr);
+		expr = NULL;
+	}
+	if (!expr) {
+		for (i = 0; i < num_args; i++)
+			_embedded_expr_free(args[i]);
+		_embedded_memory_error(parser);
+		return NULL;
+	}
+	expr->op = op;
+	expr->num_args = num_args;
+	for (i = 0; i < num_args; i++) {
+		expr->args[i] = args[i];
+		if (!args[i]->is_const)
+			expr->is_const = 0;
+		if (args[i]->has_aggregate)
+			expr->has_aggregate = 1;
+	}
+	if (!(expr->text = strndup(begin, parser->last_end > begin ? parser->last_end - begin : 0))) {
+		_embedded_expr_free(expr);
+		_embedded_memory_error(parser);
+		return NULL;
+	}
+	return expr;
+}
+
+//Remove quotes and escape sequences from a string literal ('\%' and '\_' are kept for LIKE)
+static int _embedded_unquote(const char *s, size_t length, _embedded_value * value)
+{
+	char quote = *s, *d = (char *) malloc(length), *o = d;
+	const char *p, *end = s + length - 1;
+	if (!d)
+		return EMBEDDED_IO_MEMORY_ERROR;
+	for (p = s + 1; p < end; p++) {
+		if ((*p == '\\') && (p + 1 < end)) {
+			switch (*++p) {
+				case 'n':
+					*o++ = '\n';
+					break;
+				case 't':
+					*o++ = '\t';
+					break;
+				case 'r':
+					*o++ = '\r';
+					break;
+				case '0':
+					*o++ = '\0';
+					break;
+				case 'Z':
+					*o++ = '\032';
+					break;
+				case '%':
+				case '_':
+					*o++ = '\\';
+					*o++ = *p;
+					break;
+				default:
+					*o++ = *p;
+			}
+		} else if ((*p == quote) && (p + 1 < end) && (p[1] == quote)) {
+			*o++ = quote;
+			p++;
+		} else
+			*o++ = *p;
+	}
+	*o = 0;
+	memset(value, 0, sizeof(_embedded_value));
+	value->type = EMBEDDED_IO_VALUE_STRING;
+	value->owned = 1;
+	value->s = d;
+	value->length = o - d;
+	return EMBEDDED_IO_SUCCESS;
+}
+
+static _embedded_expr *_embedded_parse_or(_embedded_parser * parser);
+
+static _embedded_expr *_embedded_parse_call(_embedded_parser * parser, char *name, const char *begin)
+{
+	_embedded_expr **args = NULL, **tmp, *arg, *expr;
+	int num_args = 0, i;
+
+	//Skip '('
+	_embedded_next(parser);
+	if (parser->token != EMBEDDED_IO_TOKEN_RPAREN) {
+		for (;;) {
+			if (!(arg = _embedded_parse_or(parser)))
+				break;
+			if (!(tmp = (_embedded_expr **) realloc(args, (num_args + 1) * sizeof(_embedded_expr *)))) {
+				_embedded_expr_free(arg);
+				_embedded_memory_error(parser);
+				break;
+			}
+			args = tmp;
+			args[num_args++] = arg;
+			if (parser->token != EMBEDDED_IO_TOKEN_COMMA)
+				break;
+			_embedded_next(parser);
+		}
+		if (!parser->error && (parser->token != EMBEDDED_IO_TOKEN_RPAREN))
+			_embedded_syntax_error(parser);
+	}
+	if (parser->error) {
+		for (i = 0; i < num_args; i++)
+			_embedded_expr_free(args[i]);
+		if (args)
+			free(args);
+		free(name);
+		return NULL;
+	}
+	_embedded_next(parser);
+
+	expr = _embedded_expr_build(parser, EMBEDDED_IO_EXPR_FUNC, 0, args, num_args, begin);
+	if (args)
+		free(args);
+	if (!expr) {
+		free(name);
+		return NULL;
+	}
+	expr->name = name;
+	expr->is_const = 0;
+
+	if (!(expr->primitive = _embedded_primitive_find(name))) {
+		EMBEDDED_IO_LOG(parser->handle, OPH_IOSERVER_LOG_EMBEDDED_UNKNOWN_PRIMITIVE, name);
+		parser->error = 1;
+		_embedded_expr_free(expr);
+		return NULL;
+	}
+	if (expr->primitive->aggregate) {
+		if (expr->has_aggregate) {
+			EMBEDDED_IO_LOG(parser->handle, OPH_IOSERVER_LOG_EMBEDDED_PRIMITIVE_ERROR, name, "nested aggregate primitives are not allowed");
+			parser->error = 1;
+			_embedded_expr_free(expr);
+			return NULL;
+		}
+		expr->has_aggregate = 1;
+	}
+	if (_embedded_primitive_load(parser->handle, expr->primitive)) {
+		parser->error = 1;
+		_embedded_expr_free(expr);
+		return NULL;
+	}
+
+	return expr;
+}
+
+static _embedded_expr *_embedded_parse_primary(_embedded_parser * parser)
+{
+	const char *begin = parser->start;
+	_embedded_expr *expr = NULL, **params;
+	char *name, *qualifier = NULL;
+
+	switch (parser->token) {
+		case EMBEDDED_IO_TOKEN_INT:
+		case EMBEDDED_IO_TOKEN_DECIMAL:
+		case EMBEDDED_IO_TOKEN_REAL:
+			_embedded_next(parser);
+			if (!(expr = _embedded_expr_build(parser, EMBEDDED_IO_EXPR_LITERAL, 0, NULL, 0, begin)))
+				return NULL;
+			if (*expr->text == '.' || strchr(expr->text, '.') || strpbrk(expr->text, "eE")) {
+				if (strpbrk(expr->text, "eE"))
+					_embedded_value_set_real(&expr->value, strtod(expr->text, NULL));
+				else if (!(expr->value.s = strdup(expr->text))) {
+					_embedded_expr_free(expr);
+					_embedded_memory_error(parser);
+					return NULL;
+				} else {
+					expr->value.type = EMBEDDED_IO_VALUE_DECIMAL;
+					expr->value.owned = 1;
+					expr->value.length = strlen(expr->value.s);
+				}
+			} else
+				_embedded_value_set_int(&expr->value, strtoll(expr->text, NULL, 10));
+			return expr;
+		case EMBEDDED_IO_TOKEN_STRING:
+			_embedded_next(parser);
+			if (!(expr = _embedded_expr_build(parser, EMBEDDED_IO_EXPR_LITERAL, 0, NULL, 0, begin)))
+				return NULL;
+			if (_embedded_unquote(expr->text, strlen(expr->text), &expr->value)) {
+				_embedded_expr_free(expr);
+				_embedded_memory_error(parser);
+				return NULL;
+			}
+			return expr;
+		case EMBEDDED_IO_TOKEN_NULL:
+			_embedded_next(parser);
+			return _embedded_expr_build(parser, EMBEDDED_IO_EXPR_LITERAL, 0, NULL, 0, begin);
+		case EMBEDDED_IO_TOKEN_PARAM:
+			_embedded_next(parser);
+			if (!(expr = _embedded_expr_build(parser, EMBEDDED_IO_EXPR_PARAM, 0, NULL, 0, begin)))
+				return NULL;
+			if (!(params = (_embedded_expr **) realloc(parser->statement->params, (parser->statement->num_params + 1) * sizeof(_embedded_expr *)))) {
+				_embedded_expr_free(expr);
+				_embedded_memory_error(parser);
+				return NULL;
+			}
+			parser->statement->params = params;
+			expr->param = parser->statement->num_params;
+			params[parser->statement->num_params++] = expr;
+			return expr;
+		case EMBEDDED_IO_TOKEN_LPAREN:
+			_embedded_next(parser);
+			if (!(expr = _embedded_parse_or(parser)))
+				return NULL;
+			if (parser->token != EMBEDDED_IO_TOKEN_RPAREN) {
+				_embedded_syntax_error(parser);
+				_embedded_expr_free(expr);
+				return NULL;
+			}
+			_embedded_next(parser);
+			return expr;
+		case EMBEDDED_IO_TOKEN_IDENT:
+			if (_embedded_is_keyword(parser, "TRUE") || _embedded_is_keyword(parser, "FALSE")) {
+				int value = _embedded_is_keyword(parser, "TRUE");
+				_embedded_next(parser);
+				if ((expr = _embedded_expr_build(parser, EMBEDDED_IO_EXPR_LITERAL, 0, NULL, 0, begin)))
+					_embedded_value_set_int(&expr->value, value);
+				return expr;
+			}
+			if (!(name = strndup(parser->start, parser->length))) {
+				_embedded_memory_error(parser);
+				return NULL;
+			}
+			_embedded_next(parser);
+			if (parser->token == EMBEDDED_IO_TOKEN_DOT) {
+				_embedded_next(parser);
+				if (parser->token != EMBEDDED_IO_TOKEN_IDENT) {
+					_embedded_syntax_error(parser);
+					free(name);
+					return NULL;
+				}
+				qualifier = name;
+				if (!(name = strndup(parser->start, parser->length))) {
+					free(qualifier);
+					_embedded_memory_error(parser);
+					return NULL;
+				}
+				_embedded_next(parser);
+			}
+			if (parser->token == EMBEDDED_IO_TOKEN_LPAREN) {
+				//The database of the primitives (mysql) is implicit
+				if (qualifier)
+					free(qualifier);
+				return _embedded_parse_call(parser, name, begin);
+			}
+			if (!(expr = _embedded_expr_build(parser, EMBEDDED_IO_EXPR_COLUMN, 0, NULL, 0, begin))) {
+				free(name);
+				if (qualifier)
+					free(qualifier);
+				return NULL;
+			}
+			expr->name = name;
+			expr->qualifier = qualifier;
+			expr->is_const = 0;
+			return expr;
+		default:
+			_embedded_syntax_error(parser);
+			return NULL;
+	}
+}
+
+static _embedded_expr *_embedded_parse_unary(_embedded_parser * parser)
+{
+	const char *begin = parser->start;
+	_embedded_expr *expr;
+
+	if (parser->token == EMBEDDED_IO_TOKEN_PLUS) {
+		_embedded_next(parser);
+		return _embedded_parse_unary(parser);
+	}
+	if (parser->token != EMBEDDED_IO_TOKEN_MINUS)
+		return _embedded_parse_primary(parser);
+
+	_embedded_next(parser);
+	if (!(expr = _embedded_parse_unary(parser)))
+		return NULL;
+	//Fold negative numbers
+	if ((expr->kind == EMBEDDED_IO_EXPR_LITERAL) && ((expr->value.type == EMBEDDED_IO_VALUE_INT) || (expr->value.type == EMBEDDED_IO_VALUE_REAL))) {
+		char *text = strndup(begin, parser->last_end - begin);
+		if (!text) {
+			_embedded_expr_free(expr);
+			_embedded_memory_error(parser);
+			return NULL;
+		}
+		free(expr->text);
+		expr->text = text;
+		if (expr->value.type == EMBEDDED_IO_VALUE_INT)
+			expr->value.l = -expr->value.l;
+		else
+			expr->value.d = -expr->value.d;
+		return expr;
+	}
+	return _embedded_expr_build(parser, EMBEDDED_IO_EXPR_UNARY, EMBEDDED_IO_TOKEN_MINUS, &expr, 1, begin);
+}
+
+static _embedded_expr *_embedded_parse_multiplicative(_embedded_parser * parser)
+{
+	const char *begin = parser->start;
+	_embedded_expr *args[2];
+	int op;
+
+	args[0] = _embedded_parse_unary(parser);
+	while (args[0] && ((parser->token == EMBEDDED_IO_TOKEN_STAR) || (parser->token == EMBEDDED_IO_TOKEN_SLASH) || (parser->token == EMBEDDED_IO_TOKEN_PERCENT)
+			   || (parser->token == EMBEDDED_IO_TOKEN_DIV))) {
+		op = parser->token;
+		_embedded_next(parser);
+		if (!(args[1] = _embedded_parse_unary(parser))) {
+			_embedded_expr_free(args[0]);
+			return NULL;
+		}
+		args[0] = _embedded_expr_build(parser, EMBEDDED_IO_EXPR_BINARY, op, args, 2, begin);
+	}
+	return args[0];
+}
+
+static _embedded_expr *_embedded_parse_additive(_embedded_parser * parser)
+{
+	const char *begin = parser->start;
+	_embedded_expr *args[2];
+	int op;
+
+	args[0] = _embedded_parse_multiplicative(parser);
+	while (args[0] && ((parser->token == EMBEDDED_IO_TOKEN_PLUS) || (parser->token == EMBEDDED_IO_TOKEN_MINUS))) {
+		op = parser->token;
+		_embedded_next(parser);
+		if (!(args[1] = _embedded_parse_multiplicative(parser))) {
+			_embedded_expr_free(args[0]);
+			return NULL;
+		}
+		args[0] = _embedded_expr_build(parser, EMBEDDED_IO_EXPR_BINARY, op, args, 2, begin);
+	}
+	return args[0];
+}
+
+static _embedded_expr *_embedded_parse_predicate(_embedded_parser * parser)
+{
+	const char *begin = parser->start;
+	_embedded_expr *left, *args[3], **list, **tmp;
+	int negate = 0, op, num = 0, i;
+
+	if (!(left = _embedded_parse_additive(parser)))
+		return NULL;
+
+	if (parser->token == EMBEDDED_IO_TOKEN_IS) {
+		_embedded_next(parser);
+		if (parser->token == EMBEDDED_IO_TOKEN_NOT) {
+			negate = 1;
+			_embedded_next(parser);
+		}
+		if (parser->token != EMBEDDED_IO_TOKEN_NULL) {
+			_embedded_syntax_error(parser);
+			_embedded_expr_free(left);
+			return NULL;
+		}
+		_embedded_next(parser);
+		return _embedded_expr_build(parser, EMBEDDED_IO_EXPR_IS_NULL, negate, &left, 1, begin);
+	}
+
+	if (parser->token == EMBEDDED_IO_TOKEN_NOT) {
+		negate = 1;
+		_embedded_next(parser);
+		if ((parser->token != EMBEDDED_IO_TOKEN_BETWEEN) && (parser->token != EMBEDDED_IO_TOKEN_IN) && (parser->token != EMBEDDED_IO_TOKEN_LIKE)) {
+			_embedded_syntax_error(parser);
+			_embedded_expr_free(left);
+			return NULL;
+		}
+	}
+
+	switch (parser->token) {
+		case EMBEDDED_IO_TOKEN_BETWEEN:
+			_embedded_next(parser);
+			args[0] = left;
+			if (!(args[1] = _embedded_parse_additive(parser))) {
+				_embedded_expr_free(left);
+				return NULL;
+			}
+			if (parser->token != EMBEDDED_IO_TOKEN_AND) {
+				_embedded_syntax_error(parser);
+				_embedded_expr_free(args[0]);
+				_embedded_expr_free(args[1]);
+				return NULL;
+			}
+			_embedded_next(parser);
+			if (!(args[2] = _embedded_parse_additive(parser))) {
+				_embedded_expr_free(args[0]);
+				_embedded_expr_free(args[1]);
+				return NULL;
+			}
+			return _embedded_expr_build(parser, EMBEDDED_IO_EXPR_BETWEEN, negate, args, 3, begin);
+		case EMBEDDED_IO_TOKEN_IN:
+			_embedded_next(parser);
+			if (parser->token != EMBEDDED_IO_TOKEN_LPAREN) {
+				_embedded_syntax_error(parser);
+				_embedded_expr_free(left);
+				return NULL;
+			}
+			if (!(list = (_embedded_expr **) malloc(sizeof(_embedded_expr *)))) {
+				_embedded_memory_error(parser);
+				_embedded_expr_free(left);
+				return NULL;
+			}
+			list[num++] = left;
+			do {
+				_embedded_next(parser);
+				if (!(args[0] = _embedded_parse_or(parser)))
+					break;
+				if (!(tmp = (_embedded_expr **) realloc(list, (num + 1) * sizeof(_embedded_expr *)))) {
+					_embedded_expr_free(args[0]);
+					_embedded_memory_error(parser);
+					break;
+				}
+				list = tmp;
+				list[num++] = args[0];
+			} while (parser->token == EMBEDDED_IO_TOKEN_COMMA);
+			if (!parser->error && (parser->token != EMBEDDED_IO_TOKEN_RPAREN))
+				_embedded_syntax_error(parser);
+			if (parser->error) {
+				for (i = 0; i < num; i++)
+					_embedded_expr_free(list[i]);
+				free(list);
+				return NULL;
+			}
+			_embedded_next(parser);
+			args[0] = _embedded_expr_build(parser, EMBEDDED_IO_EXPR_IN, negate, list, num, begin);
+			free(list);
+			return args[0];
+		case EMBEDDED_IO_TOKEN_LIKE:
+			_embedded_next(parser);
+			args[0] = left;
+			if (!(args[1] = _embedded_parse_additive(parser))) {
+				_embedded_expr_free(left);
+				return NULL;
+			}
+			return _embedded_expr_build(parser, EMBEDDED_IO_EXPR_LIKE, negate, args, 2, begin);
+		case EMBEDDED_IO_TOKEN_EQ:
+		case EMBEDDED_IO_TOKEN_NE:
+		case EMBEDDED_IO_TOKEN_LT:
+		case EMBEDDED_IO_TOKEN_LE:
+		case EMBEDDED_IO_TOKEN_GT:
+		case EMBEDDED_IO_TOKEN_GE:
+			op = parser->token;
+			_embedded_next(parser);
+			args[0] = left;
+			if (!(args[1] = _embedded_parse_additive(parser))) {
+				_embedded_expr_free(left);
+				return NULL;
+			}
+			return _embedded_expr_build(parser, EMBEDDED_IO_EXPR_BINARY, op, args, 2, begin);
+		default:
+			return left;
+	}
+}
+
+static _embedded_expr *_embedded_parse_not(_embedded_parser * parser)
+{
+	const char *begin = parser->start;
+	_embedded_expr *expr;
+
+	if (parser->token != EMBEDDED_IO_TOKEN_NOT)
+		return _embedded_parse_predicate(parser);
+	_embedded_next(parser);
+	if (!(expr = _embedded_parse_not(parser)))
+		return NULL;
+	return _embedded_expr_build(parser, EMBEDDED_IO_EXPR_UNARY, EMBEDDED_IO_TOKEN_NOT, &expr, 1, begin);
+}
+
+static _embedded_expr *_embedded_parse_and(_embedded_parser * parser)
+{
+	const char *begin = parser->start;
+	_embedded_expr *args[2];
+
+	args[0] = _embedded_parse_not(parser);
+	while (args[0] && (parser->token == EMBEDDED_IO_TOKEN_AND)) {
+		_embedded_next(parser);
+		if (!(args[1] = _embedded_parse_not(parser))) {
+			_embedded_expr_free(args[0]);
+			return NULL;
+		}
+		args[0] = _embedded_expr_build(parser, EMBEDDED_IO_EXPR_BINARY, EMBEDDED_IO_TOKEN_AND, args, 2, begin);
+	}
+	return args[0];
+}
+
+static _embedded_expr *_embedded_parse_or(_embedded_parser * parser)
+{
+	const char *begin = parser->start;
+	_embedded_expr *args[2];
+
+	args[0] = _embedded_parse_and(parser);
+	while (args[0] && (parser->token == EMBEDDED_IO_TOKEN_OR)) {
+		_embedded_next(parser);
+		if (!(args[1] = _embedded_parse_and(parser))) {
+			_embedded_expr_free(args[0]);
+			return NULL;
+		}
+		args[0] = _embedded_expr_build(parser, EMBEDDED_IO_EXPR_BINARY, EMBEDDED_IO_TOKEN_OR, args, 2, begin);
+	}
+	return args[0];
+}
+
+//Parse an expression of the submission query; placeholders are registered in the statement
+static int _embedded_parse_expr(oph_ioserver_handler * handle, _embedded_statement * statement, const char *source, _embedded_expr ** expr)
+{
+	_embedded_parser parser;
+
+	memset(&parser, 0, sizeof(_embedded_parser));
+	parser.handle = handle;
+	parser.statement = statement;
+	parser.source = parser.p = parser.start = source;
+	_embedded_next(&parser);
+
+	if ((*expr = _embedded_parse_or(&parser)) && (parser.token != EMBEDDED_IO_TOKEN_END)) {
+		_embedded_syntax_error(&parser);
+		_embedded_expr_free(*expr);
+		*expr = NULL;
+	}
+	if (!*expr && !parser.error)
+		_embedded_syntax_error(&parser);
+
+	return *expr ? EMBEDDED_IO_SUCCESS : EMBEDDED_IO_ERROR;
+}
+
+//Parse a comma-separated list of expressions (as in GROUP BY and ORDER BY clauses)
+static int _embedded_parse_list(oph_ioserver_handler * handle, _embedded_statement * statement, const char *source, _embedded_expr *** list, int *num)
+{
+	_embedded_parser parser;
+	_embedded_expr *expr, **tmp;
+
+	*list = NULL;
+	*num = 0;
+	memset(&parser, 0, sizeof(_embedded_parser));
+	parser.handle = handle;
+	parser.statement = statement;
+	parser.source = parser.p = parser.start = source;
+	_embedded_next(&parser);
+	if (parser.token == EMBEDDED_IO_TOKEN_END)
+		return EMBEDDED_IO_SUCCESS;
+
+	for (;;) {
+		if (!(expr = _embedded_parse_or(&parser)))
+			break;
+		if (!(tmp = (_embedded_expr **) realloc(*list, (*num + 1) * sizeof(_embedded_expr *)))) {
+			_embedded_expr_free(expr);
+			_embedded_memory_error(&parser);
+			break;
+		}
+		*list = tmp;
+		(*list)[(*num)++] = expr;
+		if (parser.token != EMBEDDED_IO_TOKEN_COMMA)
+			break;
+		_embedded_next(&parser);
+	}
+	if (!parser.error && (parser.token != EMBEDDED_IO_TOKEN_END))
+		_embedded_syntax_error(&parser);
+
+	return parser.error ? EMBEDDED_IO_ERROR : EMBEDDED_IO_SUCCESS;
+}
+
+/*
+ * Statements
+ */
+
+static void _embedded_statement_free(_embedded_statement * statement)
+{
+	int i;
+
+	if (!statement)
+		return;
+	if (statement->changed_db)
+		free(statement->changed_db);
+	if (statement->fields) {
+		for (i = 0; i < statement->num_fields; i++)
+			_embedded_expr_free(statement->fields[i]);
+		free(statement->fields);
+	}
+	if (statement->aliases) {
+		for (i = 0; i < statement->num_fields; i++)
+			if (statement->aliases[i])
+				free(statement->aliases[i]);
+		free(statement->aliases);
+	}
+	if (statement->columns) {
+		for (i = 0; i < statement->num_columns; i++)
+			if (statement->columns[i])
+				free(statement->columns[i]);
+		free(statement->columns);
+	}
+	if (statement->types)
+		free(statement->types);
+	for (i = 0; i < statement->num_from; i++) {
+		if (statement->from_db && statement->from_db[i])
+			free(statement->from_db[i]);
+		if (statement->from && statement->from[i])
+			free(statement->from[i]);
+		if (statement->from_alias && statement->from_alias[i])
+			free(statement->from_alias[i]);
+	}
+	if (statement->from_db)
+		free(statement->from_db);
+	if (statement->from)
+		free(statement->from);
+	if (statement->from_alias)
+		free(statement->from_alias);
+	_embedded_expr_free(statement->where);
+	if (statement->group) {
+		for (i = 0; i < statement->num_group; i++)
+			_embedded_expr_free(statement->group[i]);
+		free(statement->group);
+	}
+	if (statement->order) {
+		for (i = 0; i < statement->num_order; i++)
+			_embedded_expr_free(statement->order[i]);
+		free(statement->order);
+	}
+	if (statement->params)
+		free(statement->params);
+	if (statement->func_args) {
+		for (i = 0; i < statement->num_func_args; i++)
+			if (statement->func_args[i])
+				free(statement->func_args[i]);
+		free(statement->func_args);
+	}
+	if (statement->db)
+		free(statement->db);
+	if (statement->name)
+		free(statement->name);
+	free(statement);
+}
+
+//Split a multi-value argument; only the list has to be freed
+static int _embedded_split(oph_ioserver_handler * handle, char *value, char ***list, int *num)
+{
+	*list = NULL;
+	*num = 0;
+	if (oph_ioserver_parse_multivalue_arg(handle->server_type, value, list, num)) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_BAD_MULTI_ARG, value);
+		if (*list)
+			free(*list);
+		*list = NULL;
+		return EMBEDDED_IO_ERROR;
+	}
+	return EMBEDDED_IO_SUCCESS;
+}
+
+//Split a "db.name" reference; db is NULL for the default database
+static int _embedded_split_name(const char *reference, char **db, char **name)
+{
+	const char *dot = strchr(reference, '.');
+	*db = NULL;
+	if (dot && !(*db = strndup(reference, dot - reference)))
+		return EMBEDDED_IO_MEMORY_ERROR;
+	if (!(*name = strdup(dot ? dot + 1 : reference))) {
+		if (*db)
+			free(*db);
+		*db = NULL;
+		return EMBEDDED_IO_MEMORY_ERROR;
+	}
+	return EMBEDDED_IO_SUCCESS;
+}
+
+static int _embedded_build_target(oph_ioserver_handler * handle, HASHTBL * hashtbl, const char *argument, _embedded_statement * statement)
+{
+	char *query_arg = hashtbl_get(hashtbl, argument);
+	if (!query_arg || !*query_arg) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MISSING_ARG, argument);
+		return EMBEDDED_IO_ERROR;
+	}
+	if (_embedded_split_name(query_arg, &statement->db, &statement->name)) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+		return EMBEDDED_IO_MEMORY_ERROR;
+	}
+	return EMBEDDED_IO_SUCCESS;
+}
+
+static int _embedded_build_fields(oph_ioserver_handler * handle, HASHTBL * hashtbl, _embedded_statement * statement)
+{
+	char **list = NULL, **alias_list = NULL, columns[] = EMBEDDED_IO_FUNC_TABLE_COLUMNS;
+	int num = 0, alias_num = 0, i, res = EMBEDDED_IO_SUCCESS;
+
+	char *query_arg = hashtbl_get(hashtbl, OPH_IOSERVER_SQ_ARG_FIELD);
+	if (!query_arg) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MISSING_ARG, OPH_IOSERVER_SQ_ARG_FIELD);
+		return EMBEDDED_IO_ERROR;
+	}
+	//Fields of the virtual table of primitives
+	if (*query_arg == OPH_IOSERVER_SQ_KEYWORD_CHAR) {
+		if (strcasecmp(query_arg, OPH_IOSERVER_SQ_KW_FUNCTION_FIELDS)) {
+			EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_UNKNOWN_KEYWORD, query_arg);
+			return EMBEDDED_IO_ERROR;
+		}
+		query_arg = columns;
+		for (i = 0; query_arg[i]; i++)
+			if (query_arg[i] == OPH_IOSERVER_SQ_MULTI_VALUE_SEPARATOR)
+				query_arg[i] = ',';
+		if (_embedded_parse_list(handle, statement, query_arg, &statement->fields, &statement->num_fields))
+			return EMBEDDED_IO_ERROR;
+	} else {
+		if (_embedded_split(handle, query_arg, &list, &num))
+			return EMBEDDED_IO_ERROR;
+		if (!(statement->fields = (_embedded_expr **) calloc(num, sizeof(_embedded_expr *)))) {
+			EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+			free(list);
+			return EMBEDDED_IO_MEMORY_ERROR;
+		}
+		for (i = 0; i < num; i++) {
+			if (_embedded_parse_expr(handle, statement, list[i], statement->fields + i)) {
+				res = EMBEDDED_IO_ERROR;
+				break;
+			}
+			statement->num_fields++;
+			if (statement->fields[i]->has_aggregate)
+				statement->has_aggregate = 1;
+		}
+		free(list);
+		if (res)
+			return res;
+	}
+
+	if (!(statement->aliases = (char **) calloc(statement->num_fields, sizeof(char *)))) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+		return EMBEDDED_IO_MEMORY_ERROR;
+	}
+	query_arg = hashtbl_get(hashtbl, OPH_IOSERVER_SQ_ARG_FIELD_ALIAS);
+	if (query_arg) {
+		if (_embedded_split(handle, query_arg, &alias_list, &alias_num))
+			return EMBEDDED_IO_ERROR;
+		if (alias_num != statement->num_fields) {
+			EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MULTI_ARG_DONT_CORRESPOND);
+			free(alias_list);
+			return EMBEDDED_IO_ERROR;
+		}
+		for (i = 0; i < alias_num; i++) {
+			if (!*alias_list[i])
+				continue;
+			if (!(statement->aliases[i] = strdup(alias_list[i]))) {
+				EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+				free(alias_list);
+				return EMBEDDED_IO_MEMORY_ERROR;
+			}
+		}
+		free(alias_list);
+	}
+
+	return EMBEDDED_IO_SUCCESS;
+}
+
+static int _embedded_build_from(oph_ioserver_handler * handle, HASHTBL * hashtbl, _embedded_statement * statement)
+{
+	char **list = NULL, **alias_list = NULL;
+	int num = 0, alias_num = 0, i;
+
+	char *query_arg = hashtbl_get(hashtbl, OPH_IOSERVER_SQ_ARG_FROM);
+	if (!query_arg) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MISSING_ARG, OPH_IOSERVER_SQ_ARG_FROM);
+		return EMBEDDED_IO_ERROR;
+	}
+	if (*query_arg == OPH_IOSERVER_SQ_KEYWORD_CHAR) {
+		if (strcasecmp(query_arg, OPH_IOSERVER_SQ_KW_FUNCTION_TABLE)) {
+			EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_UNKNOWN_KEYWORD, query_arg);
+			return EMBEDDED_IO_ERROR;
+		}
+		statement->function_table = 1;
+		return EMBEDDED_IO_SUCCESS;
+	}
+
+	if (_embedded_split(handle, query_arg, &list, &num))
+		return EMBEDDED_IO_ERROR;
+	query_arg = hashtbl_get(hashtbl, OPH_IOSERVER_SQ_ARG_FROM_ALIAS);
+	if (query_arg) {
+		if (_embedded_split(handle, query_arg, &alias_list, &alias_num)) {
+			free(list);
+			return EMBEDDED_IO_ERROR;
+		}
+		if (alias_num != num) {
+			EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MULTI_ARG_DONT_CORRESPOND);
+			free(list);
+			free(alias_list);
+			return EMBEDDED_IO_ERROR;
+		}
+	}
+
+	if (!(statement->from_db = (char **) calloc(num, sizeof(char *))) || !(statement->from = (char **) calloc(num, sizeof(char *)))
+	    || !(statement->from_alias = (char **) calloc(num, sizeof(char *)))) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+		free(list);
+		if (alias_list)
+			free(alias_list);
+		return EMBEDDED_IO_MEMORY_ERROR;
+	}
+	statement->num_from = num;
+	for (i = 0; i < num; i++) {
+		if (_embedded_split_name(list[i], statement->from_db + i, statement->from + i) || (alias_list && *alias_list[i] && !(statement->from_alias[i] = strdup(alias_list[i])))) {
+			EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+			free(list);
+			if (alias_list)
+				free(alias_list);
+			return EMBEDDED_IO_MEMORY_ERROR;
+		}
+	}
+	free(list);
+	if (alias_list)
+		free(alias_list);
+
+	return EMBEDDED_IO_SUCCESS;
+}
+
+static int _embedded_build_where(oph_ioserver_handler * handle, HASHTBL * hashtbl, _embedded_statement * statement)
+{
+	char condition[OPH_IOSERVER_SQ_LEN], *query_arg;
+
+	if ((query_arg = hashtbl_get(hashtbl, OPH_IOSERVER_SQ_ARG_WHERE)))
+		snprintf(condition, OPH_IOSERVER_SQ_LEN, "%s", query_arg);
+	else if ((query_arg = hashtbl_get(hashtbl, OPH_IOSERVER_SQ_ARG_WHEREL))) {
+		//Left - condition - right parts of the filter
+		char *cond = hashtbl_get(hashtbl, OPH_IOSERVER_SQ_ARG_WHEREC), *right = cond ? hashtbl_get(hashtbl, OPH_IOSERVER_SQ_ARG_WHERER) : NULL;
+		snprintf(condition, OPH_IOSERVER_SQ_LEN, "%s %s %s", query_arg, cond ? cond : "", right ? right : "");
+	} else
+		return EMBEDDED_IO_SUCCESS;
+
+	for (query_arg = condition; isspace((unsigned char) *query_arg); query_arg++);
+	if (!*query_arg)
+		return EMBEDDED_IO_SUCCESS;
+
+	return _embedded_parse_expr(handle, statement, condition, &statement->where);
+}
+
+static int _embedded_build_clauses(oph_ioserver_handler * handle, HASHTBL * hashtbl, _embedded_statement * statement)
+{
+	char **list = NULL, *query_arg;
+	int num = 0;
+
+	if (_embedded_build_fields(handle, hashtbl, statement) || _embedded_build_from(handle, hashtbl, statement) || _embedded_build_where(handle, hashtbl, statement))
+		return EMBEDDED_IO_ERROR;
+
+	if ((query_arg = hashtbl_get(hashtbl, OPH_IOSERVER_SQ_ARG_GROUP)) && _embedded_parse_list(handle, statement, query_arg, &statement->group, &statement->num_group))
+		return EMBEDDED_IO_ERROR;
+
+	if ((query_arg = hashtbl_get(hashtbl, OPH_IOSERVER_SQ_ARG_ORDER))) {
+		if (_embedded_parse_list(handle, statement, query_arg, &statement->order, &statement->num_order))
+			return EMBEDDED_IO_ERROR;
+		query_arg = hashtbl_get(hashtbl, OPH_IOSERVER_SQ_ARG_ORDER_DIR);
+		statement->order_desc = query_arg && !strncasecmp(query_arg, "DESC", 4);
+	}
+
+	statement->limit_count = -1;
+	if ((query_arg = hashtbl_get(hashtbl, OPH_IOSERVER_SQ_ARG_LIMIT)) && *query_arg) {
+		if (_embedded_split(handle, query_arg, &list, &num))
+			return EMBEDDED_IO_ERROR;
+		if ((num < 1) || (num > 2)) {
+			EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_BAD_MULTI_ARG, query_arg);
+			free(list);
+			return EMBEDDED_IO_ERROR;
+		}
+		//As in MySQL: a single value is the number of rows, two values are offset and number of rows
+		if (num == 2) {
+			statement->limit_offset = strtoll(list[0], NULL, 10);
+			statement->limit_count = strtoll(list[1], NULL, 10);
+		} else
+			statement->limit_count = strtoll(list[0], NULL, 10);
+		free(list);
+	}
+
+	return EMBEDDED_IO_SUCCESS;
+}
+
+static int _embedded_build_default_columns(oph_ioserver_handler * handle, _embedded_statement * statement)
+{
+	char columns[] = EMBEDDED_IO_DEFAULT_COLUMNS, types[] = EMBEDDED_IO_DEFAULT_TYPES, *save_pointer = NULL, *save_pointer1 = NULL, *column, *type;
+	int i;
+
+	if (!(statement->columns = (char **) calloc(2, sizeof(char *))) || !(statement->types = (char *) calloc(3, sizeof(char)))) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+		return EMBEDDED_IO_MEMORY_ERROR;
+	}
+	column = strtok_r(columns, "|", &save_pointer);
+	type = strtok_r(types, "|", &save_pointer1);
+	for (i = 0; column && type && (i < 2); i++) {
+		if (!(statement->columns[i] = strdup(column))) {
+			EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+			return EMBEDDED_IO_MEMORY_ERROR;
+		}
+		statement->types[i] = _embedded_column_type(type);
+		statement->num_columns++;
+		column = strtok_r(NULL, "|", &save_pointer);
+		type = strtok_r(NULL, "|", &save_pointer1);
+	}
+	return EMBEDDED_IO_SUCCESS;
+}
+
+static int _embedded_build_insert(oph_ioserver_handler * handle, HASHTBL * hashtbl, _embedded_statement * statement)
+{
+	char **list = NULL;
+	int num = 0, i;
+
+	char *query_arg = hashtbl_get(hashtbl, OPH_IOSERVER_SQ_ARG_FIELD);
+	if (query_arg && *query_arg) {
+		if (_embedded_split(handle, query_arg, &list, &num))
+			return EMBEDDED_IO_ERROR;
+		if (!(statement->columns = (char **) calloc(num, sizeof(char *)))) {
+			EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+			free(list);
+			return EMBEDDED_IO_MEMORY_ERROR;
+		}
+		for (i = 0; i < num; i++) {
+			if (!(statement->columns[i] = strdup(list[i]))) {
+				EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+				free(list);
+				return EMBEDDED_IO_MEMORY_ERROR;
+			}
+			statement->num_columns++;
+		}
+		free(list);
+	}
+
+	query_arg = hashtbl_get(hashtbl, OPH_IOSERVER_SQ_ARG_VALUE);
+	if (!query_arg) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MISSING_ARG, OPH_IOSERVER_SQ_ARG_VALUE);
+		return EMBEDDED_IO_ERROR;
+	}
+	if (_embedded_split(handle, query_arg, &list, &num))
+		return EMBEDDED_IO_ERROR;
+	//Rows of multi_insert are appended with a trailing separator
+	while (num && !*list[num - 1])
+		num--;
+	if (!num || (statement->num_columns && (num % statement->num_columns))) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MULTI_ARG_DONT_CORRESPOND);
+		free(list);
+		return EMBEDDED_IO_ERROR;
+	}
+	if (!(statement->fields = (_embedded_expr **) calloc(num, sizeof(_embedded_expr *)))) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+		free(list);
+		return EMBEDDED_IO_MEMORY_ERROR;
+	}
+	for (i = 0; i < num; i++) {
+		if (_embedded_parse_expr(handle, statement, list[i], statement->fields + i)) {
+			free(list);
+			return EMBEDDED_IO_ERROR;
+		}
+		statement->num_fields++;
+		if (statement->fields[i]->has_aggregate) {
+			EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_PRIMITIVE_ERROR, statement->fields[i]->text, "aggregate primitives are not allowed in values");
+			free(list);
+			return EMBEDDED_IO_ERROR;
+		}
+	}
+	free(list);
+
+	return EMBEDDED_IO_SUCCESS;
+}
+
+static int _embedded_build_function(oph_ioserver_handler * handle, HASHTBL * hashtbl, _embedded_statement * statement)
+{
+	char **list = NULL, *name;
+	int num = 0, i;
+	size_t length;
+
+	char *query_arg = hashtbl_get(hashtbl, OPH_IOSERVER_SQ_ARG_FUNC);
+	if (!query_arg) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MISSING_ARG, OPH_IOSERVER_SQ_ARG_FUNC);
+		return EMBEDDED_IO_ERROR;
+	}
+	name = strchr(query_arg, '.') ? strchr(query_arg, '.') + 1 : query_arg;
+	if (strcasecmp(name, EMBEDDED_IO_FUNC_EXPORT) && strcasecmp(name, EMBEDDED_IO_FUNC_SIZE)) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_UNSUPPORTED_OPERATION, query_arg);
+		return EMBEDDED_IO_ERROR;
+	}
+	if (!(statement->name = strdup(name))) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+		return EMBEDDED_IO_MEMORY_ERROR;
+	}
+
+	query_arg = hashtbl_get(hashtbl, OPH_IOSERVER_SQ_ARG_ARG);
+	if (!query_arg) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MISSING_ARG, OPH_IOSERVER_SQ_ARG_ARG);
+		return EMBEDDED_IO_ERROR;
+	}
+	if (_embedded_split(handle, query_arg, &list, &num))
+		return EMBEDDED_IO_ERROR;
+	if (!num || !(statement->func_args = (char **) calloc(num, sizeof(char *)))) {
+		if (num) {
+			EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+		} else {
+			EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MISSING_ARG, OPH_IOSERVER_SQ_ARG_ARG);
+		}
+		free(list);
+		return EMBEDDED_IO_ERROR;
+	}
+	for (i = 0; i < num; i++) {
+		//Fragment names may be quoted
+		query_arg = list[i];
+		length = strlen(query_arg);
+		if ((length > 1) && ((*query_arg == '\'') || (*query_arg == '"')) && (query_arg[length - 1] == *query_arg)) {
+			query_arg++;
+			length -= 2;
+		}
+		if (!(statement->func_args[i] = strndup(query_arg, length))) {
+			EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+			free(list);
+			return EMBEDDED_IO_MEMORY_ERROR;
+		}
+		statement->num_func_args++;
+	}
+	free(list);
+
+	return EMBEDDED_IO_SUCCESS;
+}
+
+//Translate a submission query into a statement
+static int _embedded_build_statement(oph_ioserver_handler * handle, const char *query_string, _embedded_statement ** statement)
+{
+	*statement = NULL;
+
+	//Check if string has correct format
+	if (oph_ioserver_validate_query_string(handle->server_type, query_string)) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_QUERY_NOT_VALID);
+		return EMBEDDED_IO_ERROR;
+	}
+	//Count number of arguments
+	int number_arguments = 0;
+	if (oph_ioserver_count_params_query_string(handle->server_type, query_string, &number_arguments)) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_ARG_COUNT_ERROR);
+		return EMBEDDED_IO_ERROR;
+	}
+	//Create hash table for arguments
+	HASHTBL *hashtbl = NULL;
+	if (!(hashtbl = hashtbl_create(number_arguments + 1, NULL))) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_HASHTBL_ERROR);
+		return EMBEDDED_IO_ERROR;
+	}
+	//Split all arguments and load each one into hast table
+	if (oph_ioserver_load_query_string_params(handle->server_type, query_string, hashtbl)) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_LOAD_ARGS_ERROR);
+		hashtbl_destroy(hashtbl);
+		return EMBEDDED_IO_ERROR;
+	}
+	//Retrieve operation type
+	char *query_oper = hashtbl_get(hashtbl, OPH_IOSERVER_SQ_OPERATION);
+	if (!query_oper) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MISSING_ARG, OPH_IOSERVER_SQ_OPERATION);
+		hashtbl_destroy(hashtbl);
+		return EMBEDDED_IO_ERROR;
+	}
+
+	_embedded_statement *s = (_embedded_statement *) calloc(1, sizeof(_embedded_statement));
+	if (!s) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+		hashtbl_destroy(hashtbl);
+		return EMBEDDED_IO_MEMORY_ERROR;
+	}
+	s->limit_count = -1;
+
+	int res = EMBEDDED_IO_SUCCESS;
+
+	//SWITCH on operation
+	if (!strcasecmp(query_oper, OPH_IOSERVER_SQ_OP_CREATE_FRAG_SELECT) || !strcasecmp(query_oper, OPH_IOSERVER_SQ_OP_CREATE_FRAG_VIEW)) {
+		//Views are materialized
+		s->operation = EMBEDDED_IO_OP_CREATE_FRAG_SELECT;
+		res = _embedded_build_target(handle, hashtbl, OPH_IOSERVER_SQ_ARG_FRAG, s) || _embedded_build_clauses(handle, hashtbl, s);
+	} else if (!strcasecmp(query_oper, OPH_IOSERVER_SQ_OP_INSERT_SELECT)) {
+		s->operation = EMBEDDED_IO_OP_INSERT_SELECT;
+		res = _embedded_build_target(handle, hashtbl, OPH_IOSERVER_SQ_ARG_FRAG, s) || _embedded_build_clauses(handle, hashtbl, s);
+	} else if (!strcasecmp(query_oper, OPH_IOSERVER_SQ_OP_SELECT)) {
+		s->operation = EMBEDDED_IO_OP_SELECT;
+		res = _embedded_build_clauses(handle, hashtbl, s);
+	} else if (!strcasecmp(query_oper, OPH_IOSERVER_SQ_OP_INSERT) || !strcasecmp(query_oper, OPH_IOSERVER_SQ_OP_MULTI_INSERT)) {
+		s->operation = strcasecmp(query_oper, OPH_IOSERVER_SQ_OP_INSERT) ? EMBEDDED_IO_OP_MULTI_INSERT : EMBEDDED_IO_OP_INSERT;
+		res = _embedded_build_target(handle, hashtbl, OPH_IOSERVER_SQ_ARG_FRAG, s) || _embedded_build_insert(handle, hashtbl, s);
+	} else if (!strcasecmp(query_oper, OPH_IOSERVER_SQ_OP_CREATE_FRAG)) {
+		//As with MySQL plugin, fragments have the default columns
+		s->operation = EMBEDDED_IO_OP_CREATE_FRAG;
+		res = _embedded_build_target(handle, hashtbl, OPH_IOSERVER_SQ_ARG_FRAG, s) || _embedded_build_default_columns(handle, s);
+	} else if (!strcasecmp(query_oper, OPH_IOSERVER_SQ_OP_DROP_FRAG) || !strcasecmp(query_oper, OPH_IOSERVER_SQ_OP_DROP_FRAG_VIEW)) {
+		s->operation = EMBEDDED_IO_OP_DROP_FRAG;
+		res = _embedded_build_target(handle, hashtbl, OPH_IOSERVER_SQ_ARG_FRAG, s);
+	} else if (!strcasecmp(query_oper, OPH_IOSERVER_SQ_OP_CREATE_DB) || !strcasecmp(query_oper, OPH_IOSERVER_SQ_OP_DROP_DB)) {
+		s->operation = strcasecmp(query_oper, OPH_IOSERVER_SQ_OP_CREATE_DB) ? EMBEDDED_IO_OP_DROP_DB : EMBEDDED_IO_OP_CREATE_DB;
+		char *query_arg = hashtbl_get(hashtbl, OPH_IOSERVER_SQ_ARG_DB);
+		if (!query_arg) {
+			EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MISSING_ARG, OPH_IOSERVER_SQ_ARG_DB);
+			res = EMBEDDED_IO_ERROR;
+		} else if (!(s->name = strdup(query_arg))) {
+			EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+			res = EMBEDDED_IO_MEMORY_ERROR;
+		}
+	} else if (!strcasecmp(query_oper, OPH_IOSERVER_SQ_OP_FUNCTION)) {
+		s->operation = EMBEDDED_IO_OP_FUNCTION;
+		res = _embedded_build_function(handle, hashtbl, s);
+	} else if (!strcasecmp(query_oper, OPH_IOSERVER_SQ_OP_CREATE_FRAG_LINK) || !strcasecmp(query_oper, OPH_IOSERVER_SQ_OP_FILE_IMPORT)
+		   || !strcasecmp(query_oper, OPH_IOSERVER_SQ_OP_RAND_IMPORT) || !strcasecmp(query_oper, OPH_IOSERVER_SQ_OP_CREATE_FRAG_SELECT_FILE)
+		   || !strcasecmp(query_oper, OPH_IOSERVER_SQ_OP_CREATE_FRAG_SELECT_ESDM)) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_UNSUPPORTED_OPERATION, query_oper);
+		res = EMBEDDED_IO_ERROR;
+	} else {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_UNKNOWN_OPERATION, query_oper);
+		res = EMBEDDED_IO_ERROR;
+	}
+
+	hashtbl_destroy(hashtbl);
+
+	if (res) {
+		_embedded_statement_free(s);
+		return EMBEDDED_IO_ERROR;
+	}
+	*statement = s;
+
+	return EMBEDDED_IO_SUCCESS;
+}
+
+/*
+ * Evaluation
+ */
+
+/**
+ * \brief             State of the evaluation of a statement
+ * \param handle      Dynamic server plugin handle
+ * \param tables      Source fragments
+ * \param aliases     Names the source fragments are referred with
+ * \param num_tables  Number of source fragments
+ * \param rows        Current row of each source fragment (NULL if all its values are NULL)
+ * \param args        Arguments bound to the placeholders
+ */
+typedef struct {
+	oph_ioserver_handler *handle;
+	_embedded_table **tables;
+	char **aliases;
+	int num_tables;
+	_embedded_value **rows;
+	oph_ioserver_query_arg **args;
+} _embedded_context;
+
+typedef enum { EMBEDDED_IO_PHASE_CLEAR, EMBEDDED_IO_PHASE_ADD, EMBEDDED_IO_PHASE_FINAL } _embedded_phase;
+
+//Bind the columns referred in an expression to the source fragments
+static int _embedded_expr_resolve(_embedded_context * context, _embedded_expr * expr)
+{
+	int i, t;
+	unsigned int j;
+
+	for (i = 0; i < expr->num_args; i++)
+		if (_embedded_expr_resolve(context, expr->args[i]))
+			return EMBEDDED_IO_ERROR;
+	if (expr->kind != EMBEDDED_IO_EXPR_COLUMN)
+		return EMBEDDED_IO_SUCCESS;
+
+	expr->table = expr->column = -1;
+	for (t = 0; (t < context->num_tables) && (expr->table < 0); t++) {
+		if (expr->qualifier && strcmp(expr->qualifier, context->aliases[t]))
+			continue;
+		for (j = 0; j < context->tables[t]->num_columns; j++)
+			if (!strcasecmp(expr->name, context->tables[t]->columns[j])) {
+				expr->table = t;
+				expr->column = j;
+				break;
+			}
+	}
+	if (expr->table < 0) {
+		EMBEDDED_IO_LOG(context->handle, OPH_IOSERVER_LOG_EMBEDDED_UNKNOWN_COLUMN, expr->text);
+		return EMBEDDED_IO_ERROR;
+	}
+
+	return EMBEDDED_IO_SUCCESS;
+}
+
+//Static type of an expression
+static char _embedded_expr_type(_embedded_context * context, _embedded_expr * expr)
+{
+	char left, right;
+
+	switch (expr->kind) {
+		case EMBEDDED_IO_EXPR_LITERAL:
+			return expr->value.type ? expr->value.type : EMBEDDED_IO_VALUE_STRING;
+		case EMBEDDED_IO_EXPR_PARAM:
+			if (!context->args || !context->args[expr->param])
+				return EMBEDDED_IO_VALUE_STRING;
+			switch (context->args[expr->param]->arg_type) {
+				case OPH_IOSERVER_TYPE_LONG:
+				case OPH_IOSERVER_TYPE_LONGLONG:
+					return EMBEDDED_IO_VALUE_INT;
+				case OPH_IOSERVER_TYPE_FLOAT:
+				case OPH_IOSERVER_TYPE_DOUBLE:
+					return EMBEDDED_IO_VALUE_REAL;
+				case OPH_IOSERVER_TYPE_DECIMAL:
+					return EMBEDDED_IO_VALUE_DECIMAL;
+				default:
+					return EMBEDDED_IO_VALUE_STRING;
+			}
+		case EMBEDDED_IO_EXPR_COLUMN:
+			left = EMBEDDED_IO_COLUMN_TYPE(context->tables[expr->table], expr->column);
+			return left ? left : EMBEDDED_IO_VALUE_STRING;
+		case EMBEDDED_IO_EXPR_FUNC:
+			//Return types of mysql.func
+			switch (expr->primitive->ret) {
+				case REAL_RESULT:
+					return EMBEDDED_IO_VALUE_REAL;
+				case INT_RESULT:
+					return EMBEDDED_IO_VALUE_INT;
+				case DECIMAL_RESULT:
+					return EMBEDDED_IO_VALUE_DECIMAL;
+				default:
+					return EMBEDDED_IO_VALUE_STRING;
+			}
+		case EMBEDDED_IO_EXPR_UNARY:
+			if (expr->op == EMBEDDED_IO_TOKEN_NOT)
+				return EMBEDDED_IO_VALUE_INT;
+			return _embedded_expr_type(context, expr->args[0]) == EMBEDDED_IO_VALUE_INT ? EMBEDDED_IO_VALUE_INT : EMBEDDED_IO_VALUE_REAL;
+		case EMBEDDED_IO_EXPR_BINARY:
+			switch (expr->op) {
+				case EMBEDDED_IO_TOKEN_PLUS:
+				case EMBEDDED_IO_TOKEN_MINUS:
+				case EMBEDDED_IO_TOKEN_STAR:
+				case EMBEDDED_IO_TOKEN_PERCENT:
+					left = _embedded_expr_type(context, expr->args[0]);
+					right = _embedded_expr_type(context, expr->args[1]);
+					return (left == EMBEDDED_IO_VALUE_INT) && (right == EMBEDDED_IO_VALUE_INT) ? EMBEDDED_IO_VALUE_INT : EMBEDDED_IO_VALUE_REAL;
+				case EMBEDDED_IO_TOKEN_SLASH:
+					return EMBEDDED_IO_VALUE_REAL;
+				default:
+					return EMBEDDED_IO_VALUE_INT;
+			}
+		default:
+			return EMBEDDED_IO_VALUE_INT;
+	}
+}
+
+//Value bound to a placeholder (strings are borrowed)
+static int _embedded_param_value(_embedded_context * context, int param, _embedded_value * value)
+{
+	memset(value, 0, sizeof(_embedded_value));
+	oph_ioserver_query_arg *arg = context->args ? context->args[param] : NULL;
+	if (!arg || arg->arg_is_null || !arg->arg || (arg->arg_type == OPH_IOSERVER_TYPE_NULL))
+		return EMBEDDED_IO_SUCCESS;
+
+	switch (arg->arg_type) {
+		case OPH_IOSERVER_TYPE_LONG:
+			_embedded_value_set_int(value, *((int *) arg->arg));
+			break;
+		case OPH_IOSERVER_TYPE_LONGLONG:
+			_embedded_value_set_int(value, *((long long *) arg->arg));
+			break;
+		case OPH_IOSERVER_TYPE_FLOAT:
+			_embedded_value_set_real(value, *((float *) arg->arg));
+			break;
+		case OPH_IOSERVER_TYPE_DOUBLE:
+			_embedded_value_set_real(value, *((double *) arg->arg));
+			break;
+		case OPH_IOSERVER_TYPE_DECIMAL:
+			value->type = EMBEDDED_IO_VALUE_DECIMAL;
+			value->s = (char *) arg->arg;
+			value->length = arg->arg_length;
+			break;
+		default:
+			value->type = EMBEDDED_IO_VALUE_STRING;
+			value->s = (char *) arg->arg;
+			value->length = arg->arg_length;
+	}
+
+	return EMBEDDED_IO_SUCCESS;
+}
+
+static int _embedded_eval(_embedded_context * context, _embedded_expr * expr, _embedded_value * value);
+
+//Set an argument of a primitive (the value must stay valid until the primitive is called)
+static void _embedded_udf_bind(_embedded_expr * expr, int i, _embedded_value * value)
+{
+	UDF_ARGS *args = &expr->udf_args;
+
+	if (value->type == EMBEDDED_IO_VALUE_NULL) {
+		args->args[i] = NULL;
+		args->lengths[i] = 0;
+		return;
+	}
+	switch (args->arg_type[i]) {
+		case INT_RESULT:
+			expr->udf_l[i] = _embedded_value_to_long(value);
+			args->args[i] = (char *) (expr->udf_l + i);
+			args->lengths[i] = sizeof(long long);
+			break;
+		case REAL_RESULT:
+			expr->udf_d[i] = _embedded_value_to_double(value);
+			args->args[i] = (char *) (expr->udf_d + i);
+			args->lengths[i] = sizeof(double);
+			break;
+		default:
+			if (EMBEDDED_IO_IS_TEXT(value)) {
+				args->args[i] = value->s;
+				args->lengths[i] = value->length;
+			} else {
+				args->lengths[i] = _embedded_value_format(value, expr->udf_buf[i]);
+				args->args[i] = expr->udf_buf[i];
+			}
+	}
+}
+
+static enum Item_result _embedded_udf_type(char type)
+{
+	switch (type) {
+		case EMBEDDED_IO_VALUE_INT:
+			return INT_RESULT;
+		case EMBEDDED_IO_VALUE_REAL:
+			return REAL_RESULT;
+		case EMBEDDED_IO_VALUE_DECIMAL:
+			return DECIMAL_RESULT;
+		default:
+			return STRING_RESULT;
+	}
+}
+
+//Initialize the primitives of an expression (children first); constant arguments are available to init functions
+static int _embedded_udf_init(_embedded_context * context, _embedded_expr * expr)
+{
+	int i;
+	_embedded_value *values = NULL;
+
+	for (i = 0; i < expr->num_args; i++)
+		if (_embedded_udf_init(context, expr->args[i]))
+			return EMBEDDED_IO_ERROR;
+	if ((expr->kind != EMBEDDED_IO_EXPR_FUNC) || expr->initialized)
+		return EMBEDDED_IO_SUCCESS;
+
+	UDF_ARGS *args = &expr->udf_args;
+	if (!args->arg_type && expr->num_args) {
+		if (!(args->arg_type = (enum Item_result *) calloc(expr->num_args, sizeof(enum Item_result))) || !(args->args = (char **) calloc(expr->num_args, sizeof(char *)))
+		    || !(args->lengths = (unsigned long *) calloc(expr->num_args, sizeof(unsigned long))) || !(args->maybe_null = (char *) calloc(expr->num_args, sizeof(char)))
+		    || !(args->attributes = (char **) calloc(expr->num_args, sizeof(char *)))
+		    || !(args->attribute_lengths = (unsigned long *) calloc(expr->num_args, sizeof(unsigned long)))
+		    || !(expr->udf_l = (long long *) calloc(expr->num_args, sizeof(long long))) || !(expr->udf_d = (double *) calloc(expr->num_args, sizeof(double)))
+		    || !(expr->udf_buf = (char (*)[EMBEDDED_IO_NUM_LEN]) calloc(expr->num_args, EMBEDDED_IO_NUM_LEN))) {
+			EMBEDDED_IO_LOG(context->handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+			return EMBEDDED_IO_MEMORY_ERROR;
+		}
+	}
+	if (!expr->result && !(expr->result = (char *) malloc(EMBEDDED_IO_UDF_RESULT_LEN))) {
+		EMBEDDED_IO_LOG(context->handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+		return EMBEDDED_IO_MEMORY_ERROR;
+	}
+	if (expr->num_args && !(values = (_embedded_value *) calloc(expr->num_args, sizeof(_embedded_value)))) {
+		EMBEDDED_IO_LOG(context->handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+		return EMBEDDED_IO_MEMORY_ERROR;
+	}
+
+	args->arg_count = expr->num_args;
+	for (i = 0; i < expr->num_args; i++) {
+		args->arg_type[i] = _embedded_udf_type(_embedded_expr_type(context, expr->args[i]));
+		args->attributes[i] = expr->args[i]->text;
+		args->attribute_lengths[i] = strlen(expr->args[i]->text);
+		args->maybe_null[i] = 1;
+		args->args[i] = NULL;
+		args->lengths[i] = 0;
+		if (expr->args[i]->is_const && _embedded_eval(context, expr->args[i], values + i)) {
+			free(values);
+			return EMBEDDED_IO_ERROR;
+		}
+	}
+	for (i = 0; i < expr->num_args; i++)
+		_embedded_udf_bind(expr, i, values + i);
+
+	char message[EMBEDDED_IO_UDF_MESSAGE_LEN] = { '\0' };
+	memset(&expr->initid, 0, sizeof(UDF_INIT));
+	expr->initid.maybe_null = 1;
+	expr->initid.decimals = 31;
+	expr->initid.max_length = EMBEDDED_IO_UDF_RESULT_LEN;
+	if (expr->primitive->init && expr->primitive->init(&expr->initid, args, message)) {
+		EMBEDDED_IO_LOG(context->handle, OPH_IOSERVER_LOG_EMBEDDED_PRIMITIVE_ERROR, expr->name, message);
+		free(values);
+		return EMBEDDED_IO_ERROR;
+	}
+	expr->initialized = 1;
+
+	//Init functions may have changed the types of the arguments
+	for (i = 0; i < expr->num_args; i++)
+		if (expr->args[i]->is_const)
+			_embedded_udf_bind(expr, i, values + i);
+	if (values)
+		free(values);
+
+	return EMBEDDED_IO_SUCCESS;
+}
+
+static void _embedded_udf_deinit(_embedded_expr * expr)
+{
+	int i;
+
+	if (!expr)
+		return;
+	for (i = 0; i < expr->num_args; i++)
+		_embedded_udf_deinit(expr->args[i]);
+	if ((expr->kind == EMBEDDED_IO_EXPR_FUNC) && expr->initialized) {
+		if (expr->primitive->deinit)
+			expr->primitive->deinit(&expr->initid);
+		expr->initialized = 0;
+	}
+	if (expr->kind != EMBEDDED_IO_EXPR_LITERAL)
+		memset(&expr->value, 0, sizeof(_embedded_value));
+	expr->computed = 0;
+}
+
+//Bind the non-constant arguments of a primitive
+static int _embedded_udf_args(_embedded_context * context, _embedded_expr * expr, _embedded_value * values)
+{
+	int i;
+
+	for (i = 0; i < expr->num_args; i++) {
+		if (expr->args[i]->is_const)
+			continue;
+		if (_embedded_eval(context, expr->args[i], values + i))
+			return EMBEDDED_IO_ERROR;
+		_embedded_udf_bind(expr, i, values + i);
+	}
+	return EMBEDDED_IO_SUCCESS;
+}
+
+typedef double (*_embedded_udf_real) (UDF_INIT *, UDF_ARGS *, char *, char *);
+typedef long long (*_embedded_udf_int) (UDF_INIT *, UDF_ARGS *, char *, char *);
+typedef char *(*_embedded_udf_string) (UDF_INIT *, UDF_ARGS *, char *, unsigned long *, char *, char *);
+
+//Call the main function of a primitive; strings are borrowed from the primitive
+static int _embedded_udf_call(_embedded_context * context, _embedded_expr * expr, _embedded_value * value)
+{
+	char is_null = 0, error = 0;
+	unsigned long length = 0;
+	char *s;
+
+	memset(value, 0, sizeof(_embedded_value));
+	switch (expr->primitive->ret) {
+		case REAL_RESULT:{
+				double d = ((_embedded_udf_real) expr->primitive->func) (&expr->initid, &expr->udf_args, &is_null, &error);
+				if (!is_null && !error)
+					_embedded_value_set_real(value, d);
+				break;
+			}
+		case INT_RESULT:{
+				long long l = ((_embedded_udf_int) expr->primitive->func) (&expr->initid, &expr->udf_args, &is_null, &error);
+				if (!is_null && !error)
+					_embedded_value_set_int(value, l);
+				break;
+			}
+		default:
+			s = ((_embedded_udf_string) expr->primitive->func) (&expr->initid, &expr->udf_args, expr->result, &length, &is_null, &error);
+			if (!is_null && !error && s) {
+				value->type = expr->primitive->ret == DECIMAL_RESULT ? EMBEDDED_IO_VALUE_DECIMAL : EMBEDDED_IO_VALUE_STRING;
+				value->s = s;
+				value->length = length;
+			}
+	}
+	if (error) {
+		pmesg(LOG_WARNING, __FILE__, __LINE__, "Primitive '%s' failed: the outcome is NULL\n", expr->name);
+		logging_server(LOG_WARNING, __FILE__, __LINE__, context->handle->server_type, "Primitive '%s' failed: the outcome is NULL\n", expr->name);
+	}
+
+	return EMBEDDED_IO_SUCCESS;
+}
+
+//Run a phase of the aggregate primitives of an expression on the current rows
+static int _embedded_aggregate(_embedded_context * context, _embedded_expr * expr, _embedded_phase phase)
+{
+	int i, res = EMBEDDED_IO_SUCCESS;
+	char is_null = 0, error = 0;
+
+	if (!expr->has_aggregate)
+		return EMBEDDED_IO_SUCCESS;
+	if ((expr->kind != EMBEDDED_IO_EXPR_FUNC) || !expr->primitive->aggregate) {
+		for (i = 0; i < expr->num_args; i++)
+			if (_embedded_aggregate(context, expr->args[i], phase))
+				return EMBEDDED_IO_ERROR;
+		return EMBEDDED_IO_SUCCESS;
+	}
+
+	switch (phase) {
+		case EMBEDDED_IO_PHASE_CLEAR:
+			expr->computed = 0;
+			memset(&expr->value, 0, sizeof(_embedded_value));
+			expr->primitive->clear(&expr->initid, &is_null, &error);
+			break;
+		case EMBEDDED_IO_PHASE_ADD:{
+				_embedded_value *values = NULL;
+				if (expr->num_args && !(values = (_embedded_value *) calloc(expr->num_args, sizeof(_embedded_value)))) {
+					EMBEDDED_IO_LOG(context->handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+					return EMBEDDED_IO_MEMORY_ERROR;
+				}
+				if (!(res = _embedded_udf_args(context, expr, values)))
+					expr->primitive->add(&expr->initid, &expr->udf_args, &is_null, &error);
+				if (values)
+					free(values);
+				break;
+			}
+		default:
+			res = _embedded_udf_call(context, expr, &expr->value);
+			expr->computed = 1;
+	}
+
+	return res;
+}
+
+static int _embedded_eval_compare(int op, int compare)
+{
+	switch (op) {
+		case EMBEDDED_IO_TOKEN_EQ:
+			return !compare;
+		case EMBEDDED_IO_TOKEN_NE:
+			return compare != 0;
+		case EMBEDDED_IO_TOKEN_LT:
+			return compare < 0;
+		case EMBEDDED_IO_TOKEN_LE:
+			return compare <= 0;
+		case EMBEDDED_IO_TOKEN_GT:
+			return compare > 0;
+		default:
+			return compare >= 0;
+	}
+}
+
+static int _embedded_eval_arithmetic(int op, const _embedded_value * a, const _embedded_value * b, _embedded_value * value)
+{
+	if ((a->type == EMBEDDED_IO_VALUE_INT) && (b->type == EMBEDDED_IO_VALUE_INT) && (op != EMBEDDED_IO_TOKEN_SLASH)) {
+		switch (op) {
+			case EMBEDDED_IO_TOKEN_PLUS:
+				_embedded_value_set_int(value, a->l + b->l);
+				break;
+			case EMBEDDED_IO_TOKEN_MINUS:
+				_embedded_value_set_int(value, a->l - b->l);
+				break;
+			case EMBEDDED_IO_TOKEN_STAR:
+				_embedded_value_set_int(value, a->l * b->l);
+				break;
+			default:
+				//Division by zero is NULL
+				if (b->l)
+					_embedded_value_set_int(value, op == EMBEDDED_IO_TOKEN_PERCENT ? a->l % b->l : a->l / b->l);
+		}
+		return EMBEDDED_IO_SUCCESS;
+	}
+
+	double x = _embedded_value_to_double(a), y = _embedded_value_to_double(b);
+	switch (op) {
+		case EMBEDDED_IO_TOKEN_PLUS:
+			_embedded_value_set_real(value, x + y);
+			break;
+		case EMBEDDED_IO_TOKEN_MINUS:
+			_embedded_value_set_real(value, x - y);
+			break;
+		case EMBEDDED_IO_TOKEN_STAR:
+			_embedded_value_set_real(value, x * y);
+			break;
+		case EMBEDDED_IO_TOKEN_SLASH:
+			if (y != 0)
+				_embedded_value_set_real(value, x / y);
+			break;
+		case EMBEDDED_IO_TOKEN_PERCENT:
+			if (y != 0)
+				_embedded_value_set_real(value, fmod(x, y));
+			break;
+		default:
+			if (y != 0)
+				_embedded_value_set_int(value, (long long) (x / y));
+	}
+	return EMBEDDED_IO_SUCCESS;
+}
+
+//Evaluate an expression on the current rows; strings of the outcome are borrowed
+static int _embedded_eval(_embedded_context * context, _embedded_expr * expr, _embedded_value * value)
+{
+	_embedded_value a, b, c;
+	int i, truth, res;
+
+	memset(value, 0, sizeof(_embedded_value));
+
+	switch (expr->kind) {
+		case EMBEDDED_IO_EXPR_LITERAL:
+			*value = expr->value;
+			value->owned = 0;
+			return EMBEDDED_IO_SUCCESS;
+		case EMBEDDED_IO_EXPR_PARAM:
+			return _embedded_param_value(context, expr->param, value);
+		case EMBEDDED_IO_EXPR_COLUMN:
+			if (context->rows[expr->table]) {
+				*value = context->rows[expr->table][expr->column];
+				value->owned = 0;
+			}
+			return EMBEDDED_IO_SUCCESS;
+		case EMBEDDED_IO_EXPR_FUNC:
+			if (expr->primitive->aggregate) {
+				if (expr->computed) {
+					*value = expr->value;
+					value->owned = 0;
+				}
+				return EMBEDDED_IO_SUCCESS;
+			} else {
+				_embedded_value *values = NULL;
+				if (expr->num_args && !(values = (_embedded_value *) calloc(expr->num_args, sizeof(_embedded_value)))) {
+					EMBEDDED_IO_LOG(context->handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+					return EMBEDDED_IO_MEMORY_ERROR;
+				}
+				if (!(res = _embedded_udf_args(context, expr, values)))
+					res = _embedded_udf_call(context, expr, value);
+				if (values)
+					free(values);
+				return res;
+			}
+		case EMBEDDED_IO_EXPR_UNARY:
+			if (_embedded_eval(context, expr->args[0], &a))
+				return EMBEDDED_IO_ERROR;
+			if (a.type == EMBEDDED_IO_VALUE_NULL)
+				return EMBEDDED_IO_SUCCESS;
+			if (expr->op == EMBEDDED_IO_TOKEN_NOT)
+				_embedded_value_set_int(value, !_embedded_value_truth(&a));
+			else if (a.type == EMBEDDED_IO_VALUE_INT)
+				_embedded_value_set_int(value, -a.l);
+			else
+				_embedded_value_set_real(value, -_embedded_value_to_double(&a));
+			return EMBEDDED_IO_SUCCESS;
+		case EMBEDDED_IO_EXPR_BINARY:
+			if (_embedded_eval(context, expr->args[0], &a))
+				return EMBEDDED_IO_ERROR;
+			//Three-valued logic with short circuit
+			if ((expr->op == EMBEDDED_IO_TOKEN_AND) || (expr->op == EMBEDDED_IO_TOKEN_OR)) {
+				truth = _embedded_value_truth(&a);
+				if ((expr->op == EMBEDDED_IO_TOKEN_AND) && !truth) {
+					_embedded_value_set_int(value, 0);
+					return EMBEDDED_IO_SUCCESS;
+				}
+				if ((expr->op == EMBEDDED_IO_TOKEN_OR) && (truth > 0)) {
+					_embedded_value_set_int(value, 1);
+					return EMBEDDED_IO_SUCCESS;
+				}
+				if (_embedded_eval(context, expr->args[1], &b))
+					return EMBEDDED_IO_ERROR;
+				i = _embedded_value_truth(&b);
+				if (expr->op == EMBEDDED_IO_TOKEN_AND) {
+					if (!i)
+						_embedded_value_set_int(value, 0);
+					else if ((truth > 0) && (i > 0))
+						_embedded_value_set_int(value, 1);
+				} else {
+					if (i > 0)
+						_embedded_value_set_int(value, 1);
+					else if (!truth && !i)
+						_embedded_value_set_int(value, 0);
+				}
+				return EMBEDDED_IO_SUCCESS;
+			}
+			if (_embedded_eval(context, expr->args[1], &b))
+				return EMBEDDED_IO_ERROR;
+			if ((a.type == EMBEDDED_IO_VALUE_NULL) || (b.type == EMBEDDED_IO_VALUE_NULL))
+				return EMBEDDED_IO_SUCCESS;
+			switch (expr->op) {
+				case EMBEDDED_IO_TOKEN_EQ:
+				case EMBEDDED_IO_TOKEN_NE:
+				case EMBEDDED_IO_TOKEN_LT:
+				case EMBEDDED_IO_TOKEN_LE:
+				case EMBEDDED_IO_TOKEN_GT:
+				case EMBEDDED_IO_TOKEN_GE:
+					_embedded_value_set_int(value, _embedded_eval_compare(expr->op, _embedded_value_compare(&a, &b)));
+					return EMBEDDED_IO_SUCCESS;
+				default:
+					return _embedded_eval_arithmetic(expr->op, &a, &b, value);
+			}
+		case EMBEDDED_IO_EXPR_BETWEEN:
+			if (_embedded_eval(context, expr->args[0], &a) || _embedded_eval(context, expr->args[1], &b) || _embedded_eval(context, expr->args[2], &c))
+				return EMBEDDED_IO_ERROR;
+			if ((a.type == EMBEDDED_IO_VALUE_NULL) || (b.type == EMBEDDED_IO_VALUE_NULL) || (c.type == EMBEDDED_IO_VALUE_NULL))
+				return EMBEDDED_IO_SUCCESS;
+			truth = (_embedded_value_compare(&a, &b) >= 0) && (_embedded_value_compare(&a, &c) <= 0);
+			_embedded_value_set_int(value, expr->op ? !truth : truth);
+			return EMBEDDED_IO_SUCCESS;
+		case EMBEDDED_IO_EXPR_IN:
+			if (_embedded_eval(context, expr->args[0], &a))
+				return EMBEDDED_IO_ERROR;
+			if (a.type == EMBEDDED_IO_VALUE_NULL)
+				return EMBEDDED_IO_SUCCESS;
+			truth = 0;
+			for (i = 1; i < expr->num_args; i++) {
+				if (_embedded_eval(context, expr->args[i], &b))
+					return EMBEDDED_IO_ERROR;
+				if (b.type == EMBEDDED_IO_VALUE_NULL)
+					truth = -1;
+				else if (!_embedded_value_compare(&a, &b)) {
+					truth = 1;
+					break;
+				}
+			}
+			if (truth >= 0)
+				_embedded_value_set_int(value, expr->op ? !truth : truth);
+			return EMBEDDED_IO_SUCCESS;
+		case EMBEDDED_IO_EXPR_LIKE:{
+				char buffer_a[EMBEDDED_IO_NUM_LEN], buffer_b[EMBEDDED_IO_NUM_LEN];
+				if (_embedded_eval(context, expr->args[0], &a) || _embedded_eval(context, expr->args[1], &b))
+					return EMBEDDED_IO_ERROR;
+				if ((a.type == EMBEDDED_IO_VALUE_NULL) || (b.type == EMBEDDED_IO_VALUE_NULL))
+					return EMBEDDED_IO_SUCCESS;
+				if (!EMBEDDED_IO_IS_TEXT(&a)) {
+					a.length = _embedded_value_format(&a, buffer_a);
+					a.s = buffer_a;
+				}
+				if (!EMBEDDED_IO_IS_TEXT(&b)) {
+					b.length = _embedded_value_format(&b, buffer_b);
+					b.s = buffer_b;
+				}
+				truth = _embedded_like(a.s, a.length, b.s, b.length);
+				_embedded_value_set_int(value, expr->op ? !truth : truth);
+				return EMBEDDED_IO_SUCCESS;
+			}
+		case EMBEDDED_IO_EXPR_IS_NULL:
+			if (_embedded_eval(context, expr->args[0], &a))
+				return EMBEDDED_IO_ERROR;
+			truth = a.type == EMBEDDED_IO_VALUE_NULL;
+			_embedded_value_set_int(value, expr->op ? !truth : truth);
+			return EMBEDDED_IO_SUCCESS;
+		default:
+			return EMBEDDED_IO_ERROR;
+	}
+}
+
+/*
+ * Scan, join and grouping
+ */
+
+/**
+ * \brief              Rows produced by a selection
+ * \param values       Selected values (row-major order); values of columns are borrowed from the fragments
+ * \param keys         Ordering keys (row-major order)
+ * \param num_rows     Number of rows
+ * \param max_rows     Number of rows allocated
+ * \param num_fields   Number of selected values per row
+ * \param num_keys     Number of ordering keys per row
+ * \param key_fields   Selected value used as ordering key (negative if the key is evaluated)
+ * \param group_fields Selected expression used as grouping key (negative if the key is evaluated)
+ */
+typedef struct {
+	_embedded_value *values;
+	_embedded_value *keys;
+	unsigned long long num_rows;
+	unsigned long long max_rows;
+	int num_fields;
+	int num_keys;
+	int *key_fields;
+	int *group_fields;
+} _embedded_output;
+
+/**
+ * \brief              Equi-join on a fragment
+ * \param column       Column of the fragment used as index (negative if rows are scanned)
+ * \param probe_table  Fragment (scanned before) providing the values to be looked up
+ * \param probe_column Column of the fragment providing the values
+ * \param index        Rows of the fragment sorted by the values of the column
+ */
+typedef struct {
+	int column;
+	int probe_table;
+	int probe_column;
+	unsigned long long *index;
+} _embedded_join;
+
+/**
+ * \brief              State of the scan of the source fragments
+ * \param context      Evaluation state
+ * \param statement    Statement to be executed
+ * \param joins        Equi-joins of the fragments
+ * \param output       Rows produced
+ * \param tuples       Rows of the fragments matching the filter (only when rows are grouped)
+ * \param group_keys   Grouping keys of the tuples
+ * \param num_tuples   Number of tuples
+ * \param max_tuples   Number of tuples allocated
+ * \param grouped      Flag set if rows are grouped
+ * \param stop_after   Number of rows to be produced before the scan can be stopped (negative if all rows are needed)
+ */
+typedef struct {
+	_embedded_context *context;
+	_embedded_statement *statement;
+	_embedded_join *joins;
+	_embedded_output *output;
+	_embedded_value **tuples;
+	_embedded_value *group_keys;
+	unsigned long long num_tuples;
+	unsigned long long max_tuples;
+	char grouped;
+	long long stop_after;
+} _embedded_scan_state;
+
+static void _embedded_output_free(_embedded_output * output)
+{
+	unsigned long long i;
+
+	if (output->values) {
+		for (i = 0; i < output->num_rows * output->num_fields; i++)
+			_embedded_value_free(output->values + i);
+		free(output->values);
+	}
+	if (output->keys) {
+		for (i = 0; i < output->num_rows * output->num_keys; i++)
+			_embedded_value_free(output->keys + i);
+		free(output->keys);
+	}
+	if (output->key_fields)
+		free(output->key_fields);
+	if (output->group_fields)
+		free(output->group_fields);
+	memset(output, 0, sizeof(_embedded_output));
+}
+
+//Index of the selected expression whose alias is the name of a column expression (negative if none)
+static int _embedded_alias_field(_embedded_statement * statement, _embedded_expr * expr)
+{
+	int i;
+
+	if ((expr->kind != EMBEDDED_IO_EXPR_COLUMN) || expr->qualifier)
+		return -1;
+	for (i = 0; i < statement->num_fields; i++)
+		if (statement->aliases && statement->aliases[i] && !strcasecmp(statement->aliases[i], expr->name))
+			return i;
+	return -1;
+}
+
+static int _embedded_column_exists(_embedded_context * context, _embedded_expr * expr)
+{
+	int t;
+	unsigned int j;
+
+	for (t = 0; t < context->num_tables; t++) {
+		if (expr->qualifier && strcmp(expr->qualifier, context->aliases[t]))
+			continue;
+		for (j = 0; j < context->tables[t]->num_columns; j++)
+			if (!strcasecmp(expr->name, context->tables[t]->columns[j]))
+				return 1;
+	}
+	return 0;
+}
+
+//Emit a row: values of columns are borrowed, the other values are copied
+static int _embedded_output_emit(_embedded_scan_state * state)
+{
+	_embedded_context *context = state->context;
+	_embedded_statement *statement = state->statement;
+	_embedded_output *output = state->output;
+	int i;
+
+	if (output->num_rows == output->max_rows) {
+		unsigned long long max_rows = output->max_rows ? 2 * output->max_rows : EMBEDDED_IO_MIN_ROWS;
+		_embedded_value *values = (_embedded_value *) realloc(output->values, max_rows * output->num_fields * sizeof(_embedded_value));
+		if (!values) {
+			EMBEDDED_IO_LOG(context->handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+			return EMBEDDED_IO_MEMORY_ERROR;
+		}
+		output->values = values;
+		if (output->num_keys) {
+			_embedded_value *keys = (_embedded_value *) realloc(output->keys, max_rows * output->num_keys * sizeof(_embedded_value));
+			if (!keys) {
+				EMBEDDED_IO_LOG(context->handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+				return EMBEDDED_IO_MEMORY_ERROR;
+			}
+			output->keys = keys;
+		}
+		output->max_rows = max_rows;
+	}
+
+	_embedded_value *values = output->values + output->num_rows * output->num_fields, *keys = output->keys + output->num_rows * output->num_keys;
+	memset(values, 0, output->num_fields * sizeof(_embedded_value));
+	if (output->num_keys)
+		memset(keys, 0, output->num_keys * sizeof(_embedded_value));
+	//The row is accounted immediately, so that its values are freed on error
+	output->num_rows++;
+
+	for (i = 0; i < output->num_fields; i++) {
+		if (_embedded_eval(context, statement->fields[i], values + i))
+			return EMBEDDED_IO_ERROR;
+		if ((statement->fields[i]->kind != EMBEDDED_IO_EXPR_COLUMN) && _embedded_value_own(values + i)) {
+			EMBEDDED_IO_LOG(context->handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+			return EMBEDDED_IO_MEMORY_ERROR;
+		}
+	}
+	for (i = 0; i < output->num_keys; i++) {
+		if (output->key_fields[i] >= 0) {
+			keys[i] = values[output->key_fields[i]];
+			keys[i].owned = 0;
+			continue;
+		}
+		if (_embedded_eval(context, statement->order[i], keys + i))
+			return EMBEDDED_IO_ERROR;
+		if (_embedded_value_own(keys + i)) {
+			EMBEDDED_IO_LOG(context->handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+			return EMBEDDED_IO_MEMORY_ERROR;
+		}
+	}
+
+	return EMBEDDED_IO_SUCCESS;
+}
+
+//Store the rows matching the filter, together with their grouping keys
+static int _embedded_tuple_add(_embedded_scan_state * state)
+{
+	_embedded_context *context = state->context;
+	_embedded_statement *statement = state->statement;
+	int i;
+
+	if (state->num_tuples == state->max_tuples) {
+		unsigned long long max_tuples = state->max_tuples ? 2 * state->max_tuples : EMBEDDED_IO_MIN_ROWS;
+		_embedded_value **tuples = (_embedded_value **) realloc(state->tuples, max_tuples * (context->num_tables ? context->num_tables : 1) * sizeof(_embedded_value *));
+		if (!tuples) {
+			EMBEDDED_IO_LOG(context->handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+			return EMBEDDED_IO_MEMORY_ERROR;
+		}
+		state->tuples = tuples;
+		if (statement->num_group) {
+			_embedded_value *group_keys = (_embedded_value *) realloc(state->group_keys, max_tuples * statement->num_group * sizeof(_embedded_value));
+			if (!group_keys) {
+				EMBEDDED_IO_LOG(context->handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+				return EMBEDDED_IO_MEMORY_ERROR;
+			}
+			state->group_keys = group_keys;
+		}
+		state->max_tuples = max_tuples;
+	}
+
+	_embedded_value *keys = state->group_keys + state->num_tuples * statement->num_group;
+	if (context->num_tables)
+		memcpy(state->tuples + state->num_tuples * context->num_tables, context->rows, context->num_tables * sizeof(_embedded_value *));
+	if (statement->num_group)
+		memset(keys, 0, statement->num_group * sizeof(_embedded_value));
+	state->num_tuples++;
+
+	for (i = 0; i < statement->num_group; i++) {
+		_embedded_expr *expr = state->output->group_fields[i] >= 0 ? statement->fields[state->output->group_fields[i]] : statement->group[i];
+		if (_embedded_eval(context, expr, keys + i))
+			return EMBEDDED_IO_ERROR;
+		if (_embedded_value_own(keys + i)) {
+			EMBEDDED_IO_LOG(context->handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+			return EMBEDDED_IO_MEMORY_ERROR;
+		}
+	}
+
+	return EMBEDDED_IO_SUCCESS;
+}
+
+static int _embedded_scan_leaf(_embedded_scan_state * state)
+{
+	_embedded_value value;
+
+	if (state->statement->where) {
+		if (_embedded_eval(state->context, state->statement->where, &value))
+			return EMBEDDED_IO_ERROR;
+		if (_embedded_value_truth(&value) <= 0)
+			return EMBEDDED_IO_SUCCESS;
+	}
+	if (state->grouped)
+		return _embedded_tuple_add(state);
+	if (_embedded_output_emit(state))
+		return EMBEDDED_IO_ERROR;
+	//Early stop for LIMIT
+	if ((state->stop_after >= 0) && (state->output->num_rows >= (unsigned long long) state->stop_after))
+		return EMBEDDED_IO_STOP;
+	return EMBEDDED_IO_SUCCESS;
+}
+
+//Nested loop on the fragments; joined fragments are looked up by index
+static int _embedded_scan(_embedded_scan_state * state, int level)
+{
+	_embedded_context *context = state->context;
+	unsigned long long i, low, high, middle;
+	int res;
+
+	if (level == context->num_tables)
+		return _embedded_scan_leaf(state);
+
+	_embedded_table *table = context->tables[level];
+	_embedded_join *join = state->joins + level;
+
+	if (join->column < 0) {
+		for (i = 0; i < table->num_rows; i++) {
+			context->rows[level] = table->cells + i * table->num_columns;
+			if ((res = _embedded_scan(state, level + 1)))
+				return res;
+		}
+		return EMBEDDED_IO_SUCCESS;
+	}
+
+	_embedded_value *probe = context->rows[join->probe_table] + join->probe_column;
+	if (probe->type == EMBEDDED_IO_VALUE_NULL)
+		return EMBEDDED_IO_SUCCESS;
+	//Lower bound
+	for (low = 0, high = table->num_rows; low < high;) {
+		middle = low + (high - low) / 2;
+		if (_embedded_value_sort_compare(table->cells + join->index[middle] * table->num_columns + join->column, probe) < 0)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	for (i = low; i < table->num_rows; i++) {
+		context->rows[level] = table->cells + join->index[i] * table->num_columns;
+		if (_embedded_value_compare(context->rows[level] + join->column, probe))
+			break;
+		if ((res = _embedded_scan(state, level + 1)))
+			return res;
+	}
+
+	return EMBEDDED_IO_SUCCESS;
+}
+
+typedef struct {
+	_embedded_table *table;
+	int column;
+} _embedded_index_arg;
+
+static int _embedded_index_compare(const void *a, const void *b, void *arg)
+{
+	_embedded_index_arg *index_arg = (_embedded_index_arg *) arg;
+	unsigned long long i = *((const unsigned long long *) a), j = *((const unsigned long long *) b);
+	_embedded_table *table = index_arg->table;
+	int res = _embedded_value_sort_compare(table->cells + i * table->num_columns + index_arg->column, table->cells + j * table->num_columns + index_arg->column);
+	return res ? res : (i < j ? -1 : i > j);
+}
+
+//Look for equality conditions between columns of different fragments in the conjunction of the filter
+static void _embedded_join_find(_embedded_context * context, _embedded_expr * expr, _embedded_join * joins)
+{
+	if (!expr || (expr->kind != EMBEDDED_IO_EXPR_BINARY))
+		return;
+	if (expr->op == EMBEDDED_IO_TOKEN_AND) {
+		_embedded_join_find(context, expr->args[0], joins);
+		_embedded_join_find(context, expr->args[1], joins);
+		return;
+	}
+	if ((expr->op != EMBEDDED_IO_TOKEN_EQ) || (expr->args[0]->kind != EMBEDDED_IO_EXPR_COLUMN) || (expr->args[1]->kind != EMBEDDED_IO_EXPR_COLUMN))
+		return;
+
+	_embedded_expr *a = expr->args[0], *b = expr->args[1], *tmp;
+	if (a->table == b->table)
+		return;
+	if (a->table < b->table) {
+		tmp = a;
+		a = b;
+		b = tmp;
+	}
+	//Values are compared by the index in the same way as by the filter only if columns have the same type
+	char type = EMBEDDED_IO_COLUMN_TYPE(context->tables[a->table], a->column);
+	if (!type || (type != EMBEDDED_IO_COLUMN_TYPE(context->tables[b->table], b->column)) || (joins[a->table].column >= 0))
+		return;
+	joins[a->table].column = a->column;
+	joins[a->table].probe_table = b->table;
+	joins[a->table].probe_column = b->column;
+}
+
+static int _embedded_join_build(_embedded_context * context, _embedded_expr * where, _embedded_join * joins)
+{
+	int t;
+	unsigned long long i;
+	_embedded_index_arg arg;
+
+	for (t = 0; t < context->num_tables; t++)
+		joins[t].column = -1;
+	_embedded_join_find(context, where, joins);
+
+	for (t = 1; t < context->num_tables; t++) {
+		if (joins[t].column < 0)
+			continue;
+		if (context->tables[t]->num_rows && !(joins[t].index = (unsigned long long *) malloc(context->tables[t]->num_rows * sizeof(unsigned long long)))) {
+			EMBEDDED_IO_LOG(context->handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+			return EMBEDDED_IO_MEMORY_ERROR;
+		}
+		for (i = 0; i < context->tables[t]->num_rows; i++)
+			joins[t].index[i] = i;
+		arg.table = context->tables[t];
+		arg.column = joins[t].column;
+		qsort_r(joins[t].index, context->tables[t]->num_rows, sizeof(unsigned long long), _embedded_index_compare, &arg);
+	}
+
+	return EMBEDDED_IO_SUCCESS;
+}
+
+typedef struct {
+	_embedded_value *keys;
+	int num_keys;
+	char desc;
+} _embedded_sort_arg;
+
+static int _embedded_rows_compare(const void *a, const void *b, void *arg)
+{
+	_embedded_sort_arg *sort_arg = (_embedded_sort_arg *) arg;
+	unsigned long long i = *((const unsigned long long *) a), j = *((const unsigned long long *) b);
+	int k, res;
+
+	for (k = 0; k < sort_arg->num_keys; k++)
+		if ((res = _embedded_value_sort_compare(sort_arg->keys + i * sort_arg->num_keys + k, sort_arg->keys + j * sort_arg->num_keys + k)))
+			return sort_arg->desc ? -res : res;
+	//Stable sort
+	return i < j ? -1 : i > j;
+}
+
+//Stable permutation of rows sorted by their keys
+static int _embedded_sort(_embedded_context * context, _embedded_value * keys, int num_keys, unsigned long long num_rows, char desc, unsigned long long **permutation)
+{
+	unsigned long long i;
+	_embedded_sort_arg arg;
+
+	*permutation = NULL;
+	if (!num_rows)
+		return EMBEDDED_IO_SUCCESS;
+	if (!(*permutation = (unsigned long long *) malloc(num_rows * sizeof(unsigned long long)))) {
+		EMBEDDED_IO_LOG(context->handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+		return EMBEDDED_IO_MEMORY_ERROR;
+	}
+	for (i = 0; i < num_rows; i++)
+		(*permutation)[i] = i;
+	arg.keys = keys;
+	arg.num_keys = num_keys;
+	arg.desc = desc;
+	qsort_r(*permutation, num_rows, sizeof(unsigned long long), _embedded_rows_compare, &arg);
+
+	return EMBEDDED_IO_SUCCESS;
+}
+
+static int _embedded_aggregate_all(_embedded_scan_state * state, _embedded_phase phase)
+{
+	_embedded_statement *statement = state->statement;
+	int i;
+
+	for (i = 0; i < statement->num_fields; i++)
+		if (_embedded_aggregate(state->context, statement->fields[i], phase))
+			return EMBEDDED_IO_ERROR;
+	for (i = 0; i < statement->num_order; i++)
+		if ((state->output->key_fields[i] < 0) && _embedded_aggregate(state->context, statement->order[i], phase))
+			return EMBEDDED_IO_ERROR;
+	return EMBEDDED_IO_SUCCESS;
+}
+
+//Compute the aggregates of each group of tuples and emit a row per group
+static int _embedded_group(_embedded_scan_state * state)
+{
+	_embedded_context *context = state->context;
+	_embedded_statement *statement = state->statement;
+	unsigned long long *permutation = NULL, i, j, first;
+	int res = EMBEDDED_IO_SUCCESS, t;
+
+	if (!state->num_tuples) {
+		//Aggregates without grouping produce a row even on empty input
+		if (statement->num_group)
+			return EMBEDDED_IO_SUCCESS;
+		for (t = 0; t < context->num_tables; t++)
+			context->rows[t] = NULL;
+		if (_embedded_aggregate_all(state, EMBEDDED_IO_PHASE_CLEAR) || _embedded_aggregate_all(state, EMBEDDED_IO_PHASE_FINAL))
+			return EMBEDDED_IO_ERROR;
+		return _embedded_output_emit(state);
+	}
+
+	if (statement->num_group && _embedded_sort(context, state->group_keys, statement->num_group, state->num_tuples, 0, &permutation))
+		return EMBEDDED_IO_ERROR;
+
+	for (i = 0; !res && (i < state->num_tuples); i = j) {
+		first = permutation ? permutation[i] : i;
+		for (j = i + 1; j < state->num_tuples; j++) {
+			unsigned long long next = permutation ? permutation[j] : j;
+			int k, different = 0;
+			for (k = 0; !different && (k < statement->num_group); k++)
+				different = _embedded_value_sort_compare(state->group_keys + first * statement->num_group + k, state->group_keys + next * statement->num_group + k);
+			if (different)
+				break;
+		}
+		if (context->num_tables)
+			memcpy(context->rows, state->tuples + first * context->num_tables, context->num_tables * sizeof(_embedded_value *));
+		if ((res = _embedded_aggregate_all(state, EMBEDDED_IO_PHASE_CLEAR)))
+			break;
+		for (first = i; first < j; first++) {
+			if (context->num_tables)
+				memcpy(context->rows, state->tuples + (permutation ? permutation[first] : first) * context->num_tables, context->num_tables * sizeof(_embedded_value *));
+			if ((res = _embedded_aggregate_all(state, EMBEDDED_IO_PHASE_ADD)))
+				break;
+		}
+		if (res)
+			break;
+		//Non-aggregated expressions are evaluated on the first tuple of the group
+		first = permutation ? permutation[i] : i;
+		if (context->num_tables)
+			memcpy(context->rows, state->tuples + first * context->num_tables, context->num_tables * sizeof(_embedded_value *));
+		if (!(res = _embedded_aggregate_all(state, EMBEDDED_IO_PHASE_FINAL)))
+			res = _embedded_output_emit(state);
+	}
+
+	if (permutation)
+		free(permutation);
+
+	return res;
+}
+
+//Apply ORDER BY and LIMIT to the output (values are moved into a new array)
+static int _embedded_output_finalize(_embedded_context * context, _embedded_statement * statement, _embedded_output * output)
+{
+	unsigned long long *permutation = NULL, i, first, last;
+
+	if (output->num_keys && _embedded_sort(context, output->keys, output->num_keys, output->num_rows, statement->order_desc, &permutation))
+		return EMBEDDED_IO_ERROR;
+
+	if (output->keys) {
+		for (i = 0; i < output->num_rows * output->num_keys; i++)
+			_embedded_value_free(output->keys + i);
+		free(output->keys);
+		output->keys = NULL;
+		output->num_keys = 0;
+	}
+
+	first = statement->limit_offset > 0 ? (unsigned long long) statement->limit_offset : 0;
+	if (first > output->num_rows)
+		first = output->num_rows;
+	last = output->num_rows;
+	if ((statement->limit_count >= 0) && (first + statement->limit_count < last))
+		last = first + statement->limit_count;
+
+	if (!permutation && !first && (last == output->num_rows))
+		return EMBEDDED_IO_SUCCESS;
+
+	_embedded_value *values = NULL;
+	if ((last > first) && !(values = (_embedded_value *) malloc((last - first) * output->num_fields * sizeof(_embedded_value)))) {
+		EMBEDDED_IO_LOG(context->handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+		if (permutation)
+			free(permutation);
+		return EMBEDDED_IO_MEMORY_ERROR;
+	}
+	for (i = 0; i < output->num_rows; i++) {
+		unsigned long long row = permutation ? permutation[i] : i;
+		_embedded_value *source = output->values + row * output->num_fields;
+		if ((i >= first) && (i < last))
+			memcpy(values + (i - first) * output->num_fields, source, output->num_fields * sizeof(_embedded_value));
+		else {
+			int k;
+			for (k = 0; k < output->num_fields; k++)
+				_embedded_value_free(source + k);
+		}
+	}
+	if (permutation)
+		free(permutation);
+	free(output->values);
+	output->values = values;
+	output->num_rows = output->max_rows = last - first;
+
+	return EMBEDDED_IO_SUCCESS;
+}
+
+/*
+ * Execution
+ */
+
+static void _embedded_result_set_free(oph_ioserver_handler * handle, _embedded_result_set * result_set)
+{
+	unsigned long long i;
+	int t;
+
+	if (!result_set)
+		return;
+	if (result_set->values) {
+		for (i = 0; i < result_set->num_rows * result_set->num_fields; i++)
+			_embedded_value_free(result_set->values + i);
+		free(result_set->values);
+	}
+	if (result_set->tables) {
+		for (t = 0; t < result_set->num_tables; t++)
+			_embedded_cache_release(handle, result_set->tables[t]);
+		free(result_set->tables);
+	}
+	if (result_set->row)
+		free(result_set->row);
+	if (result_set->lengths)
+		free(result_set->lengths);
+	if (result_set->scratch)
+		free(result_set->scratch);
+	free(result_set);
+}
+
+//Wrap rows into a result set; values and references to the fragments are moved into it
+static int _embedded_result_set_new(oph_ioserver_handler * handle, unsigned int num_fields, unsigned long long num_rows, _embedded_value ** values, _embedded_table *** tables, int *num_tables,
+				    _embedded_result_set ** result_set)
+{
+	_embedded_result_set *r = (_embedded_result_set *) calloc(1, sizeof(_embedded_result_set));
+	if (!r || !(r->row = (char **) calloc(num_fields + 1, sizeof(char *))) || !(r->lengths = (unsigned long *) calloc(num_fields + 1, sizeof(unsigned long)))
+	    || !(r->scratch = (char *) malloc((num_fields + 1) * EMBEDDED_IO_NUM_LEN))) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+		if (r) {
+			if (r->row)
+				free(r->row);
+			if (r->lengths)
+				free(r->lengths);
+			free(r);
+		}
+		return EMBEDDED_IO_MEMORY_ERROR;
+	}
+	r->num_fields = num_fields;
+	r->num_rows = num_rows;
+	r->values = *values;
+	*values = NULL;
+	if (tables) {
+		r->tables = *tables;
+		r->num_tables = *num_tables;
+		*tables = NULL;
+		*num_tables = 0;
+	}
+	*result_set = r;
+
+	return EMBEDDED_IO_SUCCESS;
+}
+
+static void _embedded_tables_release(oph_ioserver_handler * handle, _embedded_table ** tables, int num_tables)
+{
+	int t;
+
+	if (!tables)
+		return;
+	for (t = 0; t < num_tables; t++)
+		_embedded_cache_release(handle, tables[t]);
+	free(tables);
+}
+
+static int _embedded_expr_resolve_all(_embedded_context * context, _embedded_statement * statement, _embedded_output * output)
+{
+	int i;
+
+	for (i = 0; i < statement->num_fields; i++)
+		if (_embedded_expr_resolve(context, statement->fields[i]))
+			return EMBEDDED_IO_ERROR;
+	if (statement->where && _embedded_expr_resolve(context, statement->where))
+		return EMBEDDED_IO_ERROR;
+	for (i = 0; i < statement->num_group; i++)
+		if ((output->group_fields[i] < 0) && _embedded_expr_resolve(context, statement->group[i]))
+			return EMBEDDED_IO_ERROR;
+	for (i = 0; i < statement->num_order; i++)
+		if ((output->key_fields[i] < 0) && _embedded_expr_resolve(context, statement->order[i]))
+			return EMBEDDED_IO_ERROR;
+	return EMBEDDED_IO_SUCCESS;
+}
+
+static int _embedded_udf_init_all(_embedded_context * context, _embedded_statement * statement, _embedded_output * output)
+{
+	int i;
+
+	for (i = 0; i < statement->num_fields; i++)
+		if (_embedded_udf_init(context, statement->fields[i]))
+			return EMBEDDED_IO_ERROR;
+	if (statement->where && _embedded_udf_init(context, statement->where))
+		return EMBEDDED_IO_ERROR;
+	for (i = 0; i < statement->num_group; i++)
+		if ((output->group_fields[i] < 0) && _embedded_udf_init(context, statement->group[i]))
+			return EMBEDDED_IO_ERROR;
+	for (i = 0; i < statement->num_order; i++)
+		if ((output->key_fields[i] < 0) && _embedded_udf_init(context, statement->order[i]))
+			return EMBEDDED_IO_ERROR;
+	return EMBEDDED_IO_SUCCESS;
+}
+
+static void _embedded_udf_deinit_all(_embedded_statement * statement)
+{
+	int i;
+
+	for (i = 0; i < statement->num_fields; i++)
+		_embedded_udf_deinit(statement->fields[i]);
+	_embedded_udf_deinit(statement->where);
+	for (i = 0; i < statement->num_group; i++)
+		_embedded_udf_deinit(statement->group[i]);
+	for (i = 0; i < statement->num_order; i++)
+		_embedded_udf_deinit(statement->order[i]);
+}
+
+//Run the selection of a statement: the fragments are read-locked only while rows are produced
+static int _embedded_select(oph_ioserver_handler * handle, _embedded_connection * connection, _embedded_statement * statement, _embedded_table *** tables, int *num_tables,
+			    _embedded_output * output)
+{
+	_embedded_context context;
+	_embedded_scan_state state;
+	int num = statement->function_table ? 1 : statement->num_from, i, t, locked = 0, res = EMBEDDED_IO_ERROR;
+	unsigned long long k;
+
+	*tables = NULL;
+	*num_tables = 0;
+	memset(output, 0, sizeof(_embedded_output));
+	memset(&context, 0, sizeof(_embedded_context));
+	memset(&state, 0, sizeof(_embedded_scan_state));
+	context.handle = handle;
+	context.args = statement->args;
+
+	if (!(context.tables = (_embedded_table **) calloc(num, sizeof(_embedded_table *))) || !(context.aliases = (char **) calloc(num, sizeof(char *)))
+	    || !(context.rows = (_embedded_value **) calloc(num, sizeof(_embedded_value *))) || !(state.joins = (_embedded_join *) calloc(num, sizeof(_embedded_join)))
+	    || (statement->num_order && !(output->key_fields = (int *) calloc(statement->num_order, sizeof(int))))
+	    || (statement->num_group && !(output->group_fields = (int *) calloc(statement->num_group, sizeof(int))))) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+		goto cleanup;
+	}
+
+	//Take references to the fragments
+	if (statement->function_table) {
+		if (_embedded_function_table(context.tables)) {
+			EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+			goto cleanup;
+		}
+		context.aliases[0] = context.tables[0]->name;
+		context.num_tables = 1;
+	} else
+		for (t = 0; t < num; t++) {
+			if (_embedded_cache_acquire(handle, statement->from_db[t] ? statement->from_db[t] : connection->db, statement->from[t], 1, context.tables + t))
+				goto cleanup;
+			context.aliases[t] = statement->from_alias[t] ? statement->from_alias[t] : statement->from[t];
+			context.num_tables++;
+		}
+	for (t = 0; t < context.num_tables; t++)
+		pthread_rwlock_rdlock(&context.tables[t]->lock);
+	locked = 1;
+
+	//ORDER BY refers to aliases first, GROUP BY to columns first
+	output->num_fields = statement->num_fields;
+	output->num_keys = statement->num_order;
+	for (i = 0; i < statement->num_order; i++)
+		output->key_fields[i] = _embedded_alias_field(statement, statement->order[i]);
+	for (i = 0; i < statement->num_group; i++) {
+		output->group_fields[i] = _embedded_column_exists(&context, statement->group[i]) ? -1 : _embedded_alias_field(statement, statement->group[i]);
+		if ((output->group_fields[i] >= 0) && statement->fields[output->group_fields[i]]->has_aggregate) {
+			EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_PRIMITIVE_ERROR, statement->group[i]->text, "aggregate primitives are not allowed in GROUP BY");
+			goto cleanup;
+		}
+	}
+
+	if (_embedded_expr_resolve_all(&context, statement, output) || _embedded_udf_init_all(&context, statement, output) || _embedded_join_build(&context, statement->where, state.joins))
+		goto cleanup;
+
+	state.context = &context;
+	state.statement = statement;
+	state.output = output;
+	state.grouped = statement->num_group || statement->has_aggregate;
+	state.stop_after = !state.grouped && !statement->num_order && (statement->limit_count >= 0) ? (statement->limit_offset > 0 ? statement->limit_offset : 0) + statement->limit_count : -1;
+
+	res = state.stop_after ? _embedded_scan(&state, 0) : EMBEDDED_IO_SUCCESS;
+	if (res == EMBEDDED_IO_STOP)
+		res = EMBEDDED_IO_SUCCESS;
+	if (!res && state.grouped)
+		res = _embedded_group(&state);
+	if (!res)
+		res = _embedded_output_finalize(&context, statement, output);
+
+      cleanup:
+	if (state.group_keys) {
+		for (k = 0; k < state.num_tuples * statement->num_group; k++)
+			_embedded_value_free(state.group_keys + k);
+		free(state.group_keys);
+	}
+	if (state.tuples)
+		free(state.tuples);
+	if (state.joins) {
+		for (t = 0; t < num; t++)
+			if (state.joins[t].index)
+				free(state.joins[t].index);
+		free(state.joins);
+	}
+	_embedded_udf_deinit_all(statement);
+	if (locked)
+		for (t = 0; t < context.num_tables; t++)
+			pthread_rwlock_unlock(&context.tables[t]->lock);
+	if (context.aliases)
+		free(context.aliases);
+	if (context.rows)
+		free(context.rows);
+
+	if (res) {
+		_embedded_output_free(output);
+		_embedded_tables_release(handle, context.tables, context.num_tables);
+		return EMBEDDED_IO_ERROR;
+	}
+	*tables = context.tables;
+	*num_tables = context.num_tables;
+
+	return EMBEDDED_IO_SUCCESS;
+}
+
+//Move the rows of the output into a fragment; map gives the column of each field (negative to discard it)
+static int _embedded_output_store(oph_ioserver_handler * handle, _embedded_output * output, _embedded_table * table, int *map)
+{
+	unsigned long long i;
+	int f, res = EMBEDDED_IO_SUCCESS;
+	unsigned int j;
+
+	_embedded_value *row = (_embedded_value *) calloc(table->num_columns, sizeof(_embedded_value));
+	if (!row) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+		return EMBEDDED_IO_MEMORY_ERROR;
+	}
+
+	pthread_rwlock_wrlock(&table->lock);
+	for (i = 0; i < output->num_rows; i++) {
+		_embedded_value *values = output->values + i * output->num_fields;
+		for (f = 0; f < output->num_fields; f++)
+			if (map[f] >= 0) {
+				_embedded_value_free(row + map[f]);
+				row[map[f]] = values[f];
+				memset(values + f, 0, sizeof(_embedded_value));
+			}
+		if (_embedded_table_append(table, row)) {
+			EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+			res = EMBEDDED_IO_MEMORY_ERROR;
+			break;
+		}
+	}
+	pthread_rwlock_unlock(&table->lock);
+
+	for (j = 0; j < table->num_columns; j++)
+		_embedded_value_free(row + j);
+	free(row);
+
+	return res;
+}
+
+static int _embedded_exec_select(oph_ioserver_handler * handle, _embedded_connection * connection, _embedded_statement * statement)
+{
+	_embedded_table **tables = NULL;
+	int num_tables = 0;
+	_embedded_output output;
+
+	if (_embedded_select(handle, connection, statement, &tables, &num_tables, &output))
+		return EMBEDDED_IO_ERROR;
+
+	//Values of columns keep pointing into the fragments: references are released with the result set
+	if (_embedded_result_set_new(handle, output.num_fields, output.num_rows, &output.values, &tables, &num_tables, &connection->pending)) {
+		_embedded_output_free(&output);
+		_embedded_tables_release(handle, tables, num_tables);
+		return EMBEDDED_IO_ERROR;
+	}
+	output.num_rows = 0;
+	_embedded_output_free(&output);
+
+	return EMBEDDED_IO_SUCCESS;
+}
+
+static int _embedded_exec_create_frag_select(oph_ioserver_handler * handle, _embedded_connection * connection, _embedded_statement * statement)
+{
+	_embedded_table **tables = NULL, *target = NULL;
+	int num_tables = 0, i, j, num_columns = 0, *map = NULL, res = EMBEDDED_IO_ERROR;
+	char **columns = NULL, *types = NULL, *name;
+	_embedded_output output;
+
+	if (_embedded_select(handle, connection, statement, &tables, &num_tables, &output))
+		return EMBEDDED_IO_ERROR;
+
+	if (!(map = (int *) calloc(statement->num_fields + 1, sizeof(int))) || !(columns = (char **) calloc(statement->num_fields + 2, sizeof(char *)))
+	    || !(types = (char *) calloc(statement->num_fields + 3, sizeof(char)))) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+		goto cleanup;
+	}
+	//As with MySQL plugin, the fragment has the default columns plus the selected ones with other names
+	columns[num_columns] = EMBEDDED_IO_FUNC_ID;
+	types[num_columns++] = EMBEDDED_IO_VALUE_INT;
+	columns[num_columns] = EMBEDDED_IO_FUNC_MEASURE;
+	types[num_columns++] = EMBEDDED_IO_VALUE_STRING;
+	for (i = 0; i < statement->num_fields; i++) {
+		_embedded_expr *field = statement->fields[i];
+		name = statement->aliases[i] ? statement->aliases[i] : (field->kind == EMBEDDED_IO_EXPR_COLUMN ? field->name : field->text);
+		for (j = 0; (j < num_columns) && strcasecmp(columns[j], name); j++);
+		if (j == num_columns) {
+			columns[num_columns] = name;
+			types[num_columns++] = field->kind == EMBEDDED_IO_EXPR_COLUMN ? EMBEDDED_IO_COLUMN_TYPE(tables[field->table], field->column) : 0;
+		}
+		map[i] = j;
+	}
+
+	if (_embedded_cache_create(handle, statement->db ? statement->db : connection->db, statement->name, num_columns, columns, types, &target))
+		goto cleanup;
+	res = _embedded_output_store(handle, &output, target, map);
+	_embedded_cache_release(handle, target);
+
+      cleanup:
+	if (map)
+		free(map);
+	if (columns)
+		free(columns);
+	if (types)
+		free(types);
+	_embedded_output_free(&output);
+	_embedded_tables_release(handle, tables, num_tables);
+	if (res && target)
+		_embedded_cache_drop(handle, statement->db ? statement->db : connection->db, statement->name);
+
+	return res;
+}
+
+static int _embedded_exec_insert_select(oph_ioserver_handler * handle, _embedded_connection * connection, _embedded_statement * statement)
+{
+	_embedded_table **tables = NULL, *target = NULL;
+	int num_tables = 0, i, *map = NULL, res = EMBEDDED_IO_ERROR;
+	const char *db = statement->db ? statement->db : connection->db;
+	_embedded_output output;
+
+	//Rows are appended while the sources are not locked
+	for (i = 0; i < statement->num_from; i++)
+		if (!strcmp(statement->from[i], statement->name) && db && !strcmp(statement->from_db[i] ? statement->from_db[i] : (connection->db ? connection->db : ""), db)) {
+			EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_UNSUPPORTED_OPERATION, "insert_select into a source fragment");
+			return EMBEDDED_IO_ERROR;
+		}
+
+	if (_embedded_select(handle, connection, statement, &tables, &num_tables, &output))
+		return EMBEDDED_IO_ERROR;
+
+	if (_embedded_cache_acquire(handle, db, statement->name, 1, &target))
+		goto cleanup;
+	if ((unsigned int) statement->num_fields != target->num_columns) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_COLUMN_COUNT_ERROR, statement->name);
+		goto cleanup;
+	}
+	if (!(map = (int *) calloc(statement->num_fields + 1, sizeof(int)))) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+		goto cleanup;
+	}
+	for (i = 0; i < statement->num_fields; i++)
+		map[i] = i;
+	res = _embedded_output_store(handle, &output, target, map);
+
+      cleanup:
+	if (map)
+		free(map);
+	_embedded_cache_release(handle, target);
+	_embedded_output_free(&output);
+	_embedded_tables_release(handle, tables, num_tables);
+
+	return res;
+}
+
+static int _embedded_exec_insert(oph_ioserver_handler * handle, _embedded_connection * connection, _embedded_statement * statement)
+{
+	_embedded_table *target = NULL;
+	_embedded_context context;
+	_embedded_output output;
+	int i, width, *map = NULL, res = EMBEDDED_IO_ERROR;
+	unsigned int j;
+
+	memset(&context, 0, sizeof(_embedded_context));
+	memset(&output, 0, sizeof(_embedded_output));
+	context.handle = handle;
+	context.args = statement->args;
+
+	if (_embedded_cache_acquire(handle, statement->db ? statement->db : connection->db, statement->name, 1, &target))
+		return EMBEDDED_IO_ERROR;
+
+	width = statement->num_columns ? statement->num_columns : (int) target->num_columns;
+	if (!width || (statement->num_fields % width)) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_COLUMN_COUNT_ERROR, statement->name);
+		goto cleanup;
+	}
+	if (!(map = (int *) calloc(width, sizeof(int)))) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+		goto cleanup;
+	}
+	for (i = 0; i < width; i++) {
+		if (!statement->num_columns) {
+			map[i] = i;
+			continue;
+		}
+		for (j = 0; (j < target->num_columns) && strcasecmp(target->columns[j], statement->columns[i]); j++);
+		if (j == target->num_columns) {
+			EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_UNKNOWN_COLUMN, statement->columns[i]);
+			goto cleanup;
+		}
+		map[i] = j;
+	}
+
+	//Values are computed before the fragment is locked
+	output.num_fields = width;
+	output.num_rows = output.max_rows = statement->num_fields / width;
+	if (!(output.values = (_embedded_value *) calloc(statement->num_fields, sizeof(_embedded_value)))) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+		goto cleanup;
+	}
+	for (i = 0; i < statement->num_fields; i++) {
+		if (_embedded_expr_resolve(&context, statement->fields[i]) || _embedded_udf_init(&context, statement->fields[i]) || _embedded_eval(&context, statement->fields[i], output.values + i))
+			break;
+		if (_embedded_value_own(output.values + i)) {
+			EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+			break;
+		}
+	}
+	for (j = 0; j < (unsigned int) statement->num_fields; j++)
+		_embedded_udf_deinit(statement->fields[j]);
+	if (i == statement->num_fields)
+		res = _embedded_output_store(handle, &output, target, map);
+
+      cleanup:
+	if (map)
+		free(map);
+	_embedded_output_free(&output);
+	_embedded_cache_release(handle, target);
+
+	return res;
+}
+
+//Rows of a fragment ordered by id_dim; values are not copied
+static int _embedded_exec_export(oph_ioserver_handler * handle, _embedded_connection * connection, _embedded_statement * statement)
+{
+	_embedded_table *table = NULL;
+	_embedded_value *values = NULL;
+	unsigned long long i, num_rows, *permutation = NULL;
+	int id = -1, measure = -1, sorted = 1, num_tables = 1;
+	unsigned int j;
+	char *db, *name;
+
+	if (_embedded_split_name(statement->func_args[0], &db, &name)) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+		return EMBEDDED_IO_MEMORY_ERROR;
+	}
+	int res = _embedded_cache_acquire(handle, db ? db : connection->db, name, 1, &table);
+	if (db)
+		free(db);
+	free(name);
+	if (res)
+		return EMBEDDED_IO_ERROR;
+
+	pthread_rwlock_rdlock(&table->lock);
+	for (j = 0; j < table->num_columns; j++) {
+		if (!strcasecmp(table->columns[j], EMBEDDED_IO_FUNC_ID))
+			id = j;
+		else if (!strcasecmp(table->columns[j], EMBEDDED_IO_FUNC_MEASURE))
+			measure = j;
+	}
+	if ((id < 0) || (measure < 0)) {
+		pthread_rwlock_unlock(&table->lock);
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_UNKNOWN_COLUMN, id < 0 ? EMBEDDED_IO_FUNC_ID : EMBEDDED_IO_FUNC_MEASURE);
+		_embedded_cache_release(handle, table);
+		return EMBEDDED_IO_ERROR;
+	}
+
+	num_rows = table->num_rows;
+	for (i = 1; sorted && (i < num_rows); i++)
+		sorted = _embedded_value_sort_compare(table->cells + (i - 1) * table->num_columns + id, table->cells + i * table->num_columns + id) <= 0;
+	if (!sorted) {
+		_embedded_index_arg arg;
+		if ((permutation = (unsigned long long *) malloc(num_rows * sizeof(unsigned long long)))) {
+			for (i = 0; i < num_rows; i++)
+				permutation[i] = i;
+			arg.table = table;
+			arg.column = id;
+			qsort_r(permutation, num_rows, sizeof(unsigned long long), _embedded_index_compare, &arg);
+		}
+	}
+	if ((!sorted && !permutation) || (num_rows && !(values = (_embedded_value *) malloc(2 * num_rows * sizeof(_embedded_value))))) {
+		pthread_rwlock_unlock(&table->lock);
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+		if (permutation)
+			free(permutation);
+		_embedded_cache_release(handle, table);
+		return EMBEDDED_IO_MEMORY_ERROR;
+	}
+	for (i = 0; i < num_rows; i++) {
+		_embedded_value *row = table->cells + (permutation ? permutation[i] : i) * table->num_columns;
+		values[2 * i] = row[id];
+		values[2 * i].owned = 0;
+		values[2 * i + 1] = row[measure];
+		values[2 * i + 1].owned = 0;
+	}
+	pthread_rwlock_unlock(&table->lock);
+	if (permutation)
+		free(permutation);
+
+	_embedded_table **tables = (_embedded_table **) malloc(sizeof(_embedded_table *));
+	if (!tables || _embedded_result_set_new(handle, 2, num_rows, &values, &tables, &num_tables, &connection->pending)) {
+		if (!tables) {
+			EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+		} else
+			free(tables);
+		if (values)
+			free(values);
+		_embedded_cache_release(handle, table);
+		return EMBEDDED_IO_ERROR;
+	}
+	connection->pending->tables[0] = table;
+
+	return EMBEDDED_IO_SUCCESS;
+}
+
+//Memory used by the data of the fragments (it may differ from the size reported by the MySQL plugin)
+static int _embedded_exec_size(oph_ioserver_handler * handle, _embedded_connection * connection, _embedded_statement * statement)
+{
+	_embedded_table *table;
+	_embedded_value *values;
+	unsigned long long i, size = 0;
+	int a;
+	char *db, *name;
+
+	for (a = 0; a < statement->num_func_args; a++) {
+		if (_embedded_split_name(statement->func_args[a], &db, &name)) {
+			EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+			return EMBEDDED_IO_MEMORY_ERROR;
+		}
+		int res = _embedded_cache_acquire(handle, db ? db : connection->db, name, 0, &table);
+		if (db)
+			free(db);
+		free(name);
+		if (res)
+			return EMBEDDED_IO_ERROR;
+		if (!table)
+			continue;
+		pthread_rwlock_rdlock(&table->lock);
+		for (i = 0; i < table->num_rows * table->num_columns; i++)
+			size += EMBEDDED_IO_IS_TEXT(table->cells + i) ? table->cells[i].length : sizeof(int64_t);
+		pthread_rwlock_unlock(&table->lock);
+		_embedded_cache_release(handle, table);
+	}
+
+	if (!(values = (_embedded_value *) malloc(sizeof(_embedded_value)))) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+		return EMBEDDED_IO_MEMORY_ERROR;
+	}
+	_embedded_value_set_int(values, (long long) size);
+	if (_embedded_result_set_new(handle, 1, 1, &values, NULL, NULL, &connection->pending)) {
+		free(values);
+		return EMBEDDED_IO_ERROR;
+	}
+
+	return EMBEDDED_IO_SUCCESS;
+}
+
+static int _embedded_exec_statement(oph_ioserver_handler * handle, _embedded_connection * connection, _embedded_statement * statement)
+{
+	_embedded_table *table = NULL;
+	const char *db = statement->db ? statement->db : connection->db;
+
+	switch (statement->operation) {
+		case EMBEDDED_IO_OP_SELECT:
+			return _embedded_exec_select(handle, connection, statement);
+		case EMBEDDED_IO_OP_CREATE_FRAG_SELECT:
+			return _embedded_exec_create_frag_select(handle, connection, statement);
+		case EMBEDDED_IO_OP_INSERT_SELECT:
+			return _embedded_exec_insert_select(handle, connection, statement);
+		case EMBEDDED_IO_OP_INSERT:
+		case EMBEDDED_IO_OP_MULTI_INSERT:
+			return _embedded_exec_insert(handle, connection, statement);
+		case EMBEDDED_IO_OP_CREATE_FRAG:
+			if (_embedded_cache_create(handle, db, statement->name, statement->num_columns, statement->columns, statement->types, &table))
+				return EMBEDDED_IO_ERROR;
+			_embedded_cache_release(handle, table);
+			return EMBEDDED_IO_SUCCESS;
+		case EMBEDDED_IO_OP_DROP_FRAG:
+			return _embedded_cache_drop(handle, db, statement->name);
+		case EMBEDDED_IO_OP_CREATE_DB:
+			return _embedded_database_create(handle, statement->name);
+		case EMBEDDED_IO_OP_DROP_DB:
+			return _embedded_database_drop(handle, statement->name);
+		case EMBEDDED_IO_OP_FUNCTION:
+			if (!strcasecmp(statement->name, EMBEDDED_IO_FUNC_EXPORT))
+				return _embedded_exec_export(handle, connection, statement);
+			return _embedded_exec_size(handle, connection, statement);
+		default:
+			EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_UNKNOWN_OPERATION, "");
+			return EMBEDDED_IO_ERROR;
+	}
+}
+
+static int _embedded_exec(oph_ioserver_handler * handle, _embedded_connection * connection, _embedded_statement * statement)
+{
+	const char *db = statement->db ? statement->db : connection->db;
+
+	int res = _embedded_exec_statement(handle, connection, statement);
+
+	//Remember the changed fragment: it is saved once all the runs of the query have been executed
+	switch (statement->operation) {
+		case EMBEDDED_IO_OP_CREATE_FRAG_SELECT:
+		case EMBEDDED_IO_OP_INSERT_SELECT:
+		case EMBEDDED_IO_OP_INSERT:
+		case EMBEDDED_IO_OP_MULTI_INSERT:
+		case EMBEDDED_IO_OP_CREATE_FRAG:
+			if (!res && db && !statement->changed_db && !(statement->changed_db = strdup(db))) {
+				EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+				res = EMBEDDED_IO_MEMORY_ERROR;
+			}
+			break;
+		default:
+			break;
+	}
+
+	return res;
+}
+
+/*
+ * Plugin interface
+ */
+
+//Create a directory and its parents
+static int _embedded_mkdir(const char *path)
+{
+	char tmp[EMBEDDED_IO_PATH_LEN], *p;
+
+	snprintf(tmp, EMBEDDED_IO_PATH_LEN, "%s", path);
+	for (p = tmp + 1; *p; p++)
+		if (*p == '/') {
+			*p = '\0';
+			if (mkdir(tmp, 0755) && (errno != EEXIST))
+				return EMBEDDED_IO_ERROR;
+			*p = '/';
+		}
+	if (mkdir(tmp, 0755) && (errno != EEXIST))
+		return EMBEDDED_IO_ERROR;
+	return EMBEDDED_IO_SUCCESS;
+}
+
+//Initialize storage server plugin
+int _embedded_setup(oph_ioserver_handler * handle)
+{
+	if (!handle) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_LOG_EMBEDDED_NULL_INPUT_PARAM);
+		return EMBEDDED_IO_NULL_PARAM;
+	}
+
+	char primitives[EMBEDDED_IO_PATH_LEN], *value;
+	int res = EMBEDDED_IO_SUCCESS;
+
+	//Storage is shared by all the handles of the process
+	pthread_mutex_lock(&_embedded_lock);
+	if (!_embedded_users) {
+		if ((value = getenv(EMBEDDED_IO_PATH_ENV)) && *value)
+			snprintf(_embedded_root, EMBEDDED_IO_PATH_LEN, "%s", value);
+		else
+			snprintf(_embedded_root, EMBEDDED_IO_PATH_LEN, EMBEDDED_IO_DEFAULT_PATH, OPH_ANALYTICS_LOCATION);
+		if ((value = getenv(EMBEDDED_IO_PRIMITIVES_ENV)) && *value)
+			snprintf(primitives, EMBEDDED_IO_PATH_LEN, "%s", value);
+		else
+			snprintf(primitives, EMBEDDED_IO_PATH_LEN, EMBEDDED_IO_DEFAULT_PRIMITIVES, OPH_ANALYTICS_LOCATION);
+		long long size = (value = getenv(EMBEDDED_IO_CACHE_SIZE_ENV)) ? strtoll(value, NULL, 10) : 0;
+		_embedded_cache_limit = (size_t) (size > 0 ? size : EMBEDDED_IO_DEFAULT_CACHE_SIZE) * 1048576;
+
+		if (_embedded_mkdir(_embedded_root)) {
+			pthread_mutex_unlock(&_embedded_lock);
+			EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_SETUP_ERROR, _embedded_root);
+			return EMBEDDED_IO_ERROR;
+		}
+		pmesg(LOG_DEBUG, __FILE__, __LINE__, "Embedded I/O server storage in '%s' with a cache of %zu bytes\n", _embedded_root, _embedded_cache_limit);
+		res = _embedded_primitives_load(handle, primitives);
+	}
+	if (!res)
+		_embedded_users++;
+	pthread_mutex_unlock(&_embedded_lock);
+
+	return res;
+}
+
+//Connect or reconnect to storage server
+int _embedded_connect(oph_ioserver_handler * handle, oph_ioserver_params * conn_params, void **connection)
+{
+	if (!connection || !conn_params) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_NULL_INPUT_PARAM);
+		return EMBEDDED_IO_NULL_PARAM;
+	}
+
+	//The server runs in process: an established connection is always valid
+	if (*connection)
+		return EMBEDDED_IO_SUCCESS;
+
+	_embedded_connection *conn = (_embedded_connection *) calloc(1, sizeof(_embedded_connection));
+	if (!conn) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+		return EMBEDDED_IO_MEMORY_ERROR;
+	}
+	*connection = (void *) conn;
+
+	if (conn_params->db_name && *conn_params->db_name && _embedded_use_db(handle, conn_params->db_name, *connection)) {
+		_embedded_close(handle, connection);
+		return EMBEDDED_IO_ERROR;
+	}
+
+	return EMBEDDED_IO_SUCCESS;
+}
+
+int _embedded_use_db(oph_ioserver_handler * handle, const char *db_name, void *connection)
+{
+	if (!connection || !db_name) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_NULL_INPUT_PARAM);
+		return EMBEDDED_IO_NULL_PARAM;
+	}
+
+	_embedded_connection *conn = (_embedded_connection *) connection;
+	char path[EMBEDDED_IO_PATH_LEN];
+	struct stat st;
+
+	if (_embedded_path(path, db_name, NULL) || stat(path, &st) || !S_ISDIR(st.st_mode)) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_USE_DB_ERROR, db_name);
+		return EMBEDDED_IO_ERROR;
+	}
+
+	char *db = strdup(db_name);
+	if (!db) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+		return EMBEDDED_IO_MEMORY_ERROR;
+	}
+	if (conn->db)
+		free(conn->db);
+	conn->db = db;
+
+	return EMBEDDED_IO_SUCCESS;
+}
+
+//Execute operation in storage server
+int _embedded_execute_query(oph_ioserver_handler * handle, void *connection, oph_ioserver_query * query)
+{
+	if (!connection || !query || !query->statement) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_NULL_INPUT_PARAM);
+		return EMBEDDED_IO_NULL_PARAM;
+	}
+
+	_embedded_connection *conn = (_embedded_connection *) connection;
+	_embedded_statement *statement = (_embedded_statement *) query->statement;
+	int i;
+
+	//Rows not retrieved are discarded
+	if (conn->pending) {
+		_embedded_result_set_free(handle, conn->pending);
+		conn->pending = NULL;
+	}
+
+	//Arguments are read at each run
+	for (i = 0; i < statement->num_params; i++)
+		if (!statement->args || !statement->args[i]) {
+			EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_BIND_ERROR, i);
+			return EMBEDDED_IO_ERROR;
+		}
+
+	if (_embedded_exec(handle, conn, statement)) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_EXEC_QUERY_ERROR);
+		return EMBEDDED_IO_ERROR;
+	}
+
+	return EMBEDDED_IO_SUCCESS;
+}
+
+//Setup the query structure with given operation and array argument
+int _embedded_setup_query(oph_ioserver_handler * handle, void *connection, const char *operation, unsigned long long tot_run, oph_ioserver_query_arg ** args, oph_ioserver_query ** query)
+{
+	UNUSED(tot_run);
+
+	if (!connection || !operation || !query) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_NULL_INPUT_PARAM);
+		return EMBEDDED_IO_NULL_PARAM;
+	}
+
+	_embedded_statement *statement = NULL;
+	int arg_count = 0;
+
+	if (_embedded_build_statement(handle, operation, &statement)) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_QUERY_NOT_VALID);
+		return EMBEDDED_IO_ERROR;
+	}
+
+	if (args)
+		while (args[arg_count])
+			arg_count++;
+	if (arg_count != statement->num_params) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_ARG_COUNT_ERROR);
+		_embedded_statement_free(statement);
+		return EMBEDDED_IO_ERROR;
+	}
+	statement->args = args;
+
+	if (!(*query = (oph_ioserver_query *) malloc(sizeof(oph_ioserver_query)))) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+		_embedded_statement_free(statement);
+		return EMBEDDED_IO_MEMORY_ERROR;
+	}
+	(*query)->type = args ? OPH_IOSERVER_STMT_BINARY : OPH_IOSERVER_STMT_SIMPLE;
+	(*query)->statement = (void *) statement;
+
+	return EMBEDDED_IO_SUCCESS;
+}
+
+//Release resources allocated for query
+int _embedded_free_query(oph_ioserver_handler * handle, oph_ioserver_query * query)
+{
+	if (!query || !query->statement) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_NULL_INPUT_PARAM);
+		return EMBEDDED_IO_NULL_PARAM;
+	}
+
+	//Changes are made persistent when the query is completed
+	_embedded_statement *statement = (_embedded_statement *) query->statement;
+	int res = statement->changed_db ? _embedded_cache_commit(handle, statement->changed_db, statement->name) : EMBEDDED_IO_SUCCESS;
+
+	_embedded_statement_free(statement);
+	free(query);
+
+	return res;
+}
+
+//Close connection to storage server
+int _embedded_close(oph_ioserver_handler * handle, void **connection)
+{
+	if (!connection || !(*connection)) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_NULL_INPUT_PARAM);
+		return EMBEDDED_IO_NULL_PARAM;
+	}
+
+	_embedded_connection *conn = (_embedded_connection *) (*connection);
+	int res;
+
+	if (conn->pending)
+		_embedded_result_set_free(handle, conn->pending);
+	//Changes left in memory (e.g. by queries not released) are made persistent when a connection is closed
+	res = _embedded_cache_flush(handle);
+	if (conn->db)
+		free(conn->db);
+	free(conn);
+	*connection = NULL;
+
+	return res;
+}
+
+//Finalize storage server plugin
+int _embedded_cleanup(oph_ioserver_handler * handle)
+{
+	if (!handle) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_LOG_EMBEDDED_NULL_INPUT_PARAM);
+		return EMBEDDED_IO_NULL_PARAM;
+	}
+
+	_embedded_table *table, *next;
+	int res = EMBEDDED_IO_SUCCESS;
+
+	if (_embedded_cache_flush(handle))
+		res = EMBEDDED_IO_ERROR;
+
+	pthread_mutex_lock(&_embedded_lock);
+	if (_embedded_users && !--_embedded_users) {
+		for (table = _embedded_cache_head; table; table = next) {
+			next = table->next;
+			_embedded_cache_unlink(table);
+			//Fragments still referenced by result sets are freed when they are released
+			if (table->refcount)
+				table->dropped = 1;
+			else
+				_embedded_table_free(table);
+		}
+		_embedded_primitives_free();
+	}
+	pthread_mutex_unlock(&_embedded_lock);
+
+	return res;
+}
+
+int _embedded_get_result(oph_ioserver_handler * handle, void *connection, oph_ioserver_result ** result)
+{
+	if (!connection || !result) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_NULL_INPUT_PARAM);
+		return EMBEDDED_IO_NULL_PARAM;
+	}
+
+	if (*result != NULL) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_NOT_NULL_INPUT_PARAM);
+		return EMBEDDED_IO_ERROR;
+	}
+
+	_embedded_connection *conn = (_embedded_connection *) connection;
+	_embedded_result_set *result_set = conn->pending;
+	_embedded_value *values = NULL;
+	char buffer[EMBEDDED_IO_NUM_LEN];
+	unsigned long long i, length;
+	unsigned int j;
+
+	//As with MySQL plugin, statements without rows give an empty result set
+	if (!result_set && _embedded_result_set_new(handle, 0, 0, &values, NULL, NULL, &result_set)) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_GET_RESULT_ERROR);
+		return EMBEDDED_IO_ERROR;
+	}
+	conn->pending = NULL;
+
+	if (!(*result = (oph_ioserver_result *) calloc(1, sizeof(oph_ioserver_result)))
+	    || !((*result)->max_field_length = (unsigned long long *) calloc(result_set->num_fields + 1, sizeof(unsigned long long)))
+	    || !((*result)->current_row = (oph_ioserver_row *) calloc(1, sizeof(oph_ioserver_row)))) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR);
+		_embedded_result_set_free(handle, result_set);
+		if (*result) {
+			if ((*result)->max_field_length)
+				free((*result)->max_field_length);
+			free(*result);
+			*result = NULL;
+		}
+		return EMBEDDED_IO_MEMORY_ERROR;
+	}
+	(*result)->result_set = (void *) result_set;
+	(*result)->num_rows = result_set->num_rows;
+	(*result)->num_fields = result_set->num_fields;
+	for (i = 0; i < result_set->num_rows; i++)
+		for (j = 0; j < result_set->num_fields; j++) {
+			_embedded_value *value = result_set->values + i * result_set->num_fields + j;
+			if (value->type == EMBEDDED_IO_VALUE_NULL)
+				continue;
+			length = EMBEDDED_IO_IS_TEXT(value) ? value->length : (unsigned long long) _embedded_value_format(value, buffer);
+			if (length > (*result)->max_field_length[j])
+				(*result)->max_field_length[j] = length;
+		}
+
+	return EMBEDDED_IO_SUCCESS;
+}
+
+//Get the next row; values of the fragments are not copied
+int _embedded_fetch_row(oph_ioserver_handler * handle, oph_ioserver_result * result, oph_ioserver_row ** current_row)
+{
+	if (!result || !current_row) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_NULL_INPUT_PARAM);
+		_embedded_free_result(handle, result);
+		return EMBEDDED_IO_NULL_PARAM;
+	}
+	if (result->result_set == NULL || result->current_row == NULL) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_NULL_INPUT_PARAM);
+		_embedded_free_result(handle, result);
+		return EMBEDDED_IO_NULL_PARAM;
+	}
+
+	_embedded_result_set *result_set = (_embedded_result_set *) result->result_set;
+	unsigned int j;
+
+	if (result_set->current >= result_set->num_rows) {
+		result->current_row->row = NULL;
+		result->current_row->field_lengths = NULL;
+	} else {
+		_embedded_value *values = result_set->values + result_set->current * result_set->num_fields;
+		for (j = 0; j < result_set->num_fields; j++) {
+			if (values[j].type == EMBEDDED_IO_VALUE_NULL) {
+				result_set->row[j] = NULL;
+				result_set->lengths[j] = 0;
+			} else if (EMBEDDED_IO_IS_TEXT(values + j)) {
+				result_set->row[j] = values[j].s;
+				result_set->lengths[j] = values[j].length;
+			} else {
+				result_set->row[j] = result_set->scratch + j * EMBEDDED_IO_NUM_LEN;
+				result_set->lengths[j] = _embedded_value_format(values + j, result_set->row[j]);
+			}
+		}
+		result_set->current++;
+		result->current_row->row = result_set->row;
+		result->current_row->field_lengths = result_set->lengths;
+	}
+
+	*current_row = result->current_row;
+
+	return EMBEDDED_IO_SUCCESS;
+}
+
+//Release result set resources
+int _embedded_free_result(oph_ioserver_handler * handle, oph_ioserver_result * result)
+{
+	if (!result) {
+		EMBEDDED_IO_LOG(handle, OPH_IOSERVER_LOG_EMBEDDED_NULL_INPUT_PARAM);
+		return EMBEDDED_IO_NULL_PARAM;
+	}
+	_embedded_result_set_free(handle, (_embedded_result_set *) result->result_set);
+	if (result->max_field_length) {
+		free(result->max_field_length);
+		result->max_field_length = NULL;
+	}
+	if (result->current_row) {
+		free(result->current_row);
+		result->current_row = NULL;
+	}
+	free(result);
+
+	return EMBEDDED_IO_SUCCESS;
+}
@@ -0,0 +1,446 @@
+/*
+    Ophidia Analytics Framework
+    Copyright (C) 2012-2024 CMCC Foundation
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __EMBEDDED_IOSERVER_H
+#define __EMBEDDED_IOSERVER_H
+
+#include <pthread.h>
+#include <sys/types.h>
+#include <time.h>
+
+/* MySQL headers (only for the calling convention of the primitives) */
+#include <mysql.h>
+#if MYSQL_VERSION_ID >= 80001 && MYSQL_VERSION_ID != 80002
+typedef bool my_bool;
+#endif
+
+#include "oph_ioserver_library.h"
+
+#define EMBEDDED_IO_ERROR -1
+#define EMBEDDED_IO_SUCCESS 0
+#define EMBEDDED_IO_NULL_PARAM -2
+#define EMBEDDED_IO_MEMORY_ERROR -3
+
+//Environment variables
+#define EMBEDDED_IO_PATH_ENV		"OPH_EMBEDDED_IOSERVER_PATH"
+#define EMBEDDED_IO_PRIMITIVES_ENV	"OPH_EMBEDDED_IOSERVER_PRIMITIVES"
+#define EMBEDDED_IO_CACHE_SIZE_ENV	"OPH_EMBEDDED_IOSERVER_CACHE_SIZE"
+
+//Default values
+#define EMBEDDED_IO_DEFAULT_PATH	"%s/var/embedded_ioserver"
+#define EMBEDDED_IO_DEFAULT_PRIMITIVES	"%s/etc/oph_embedded_primitives"
+#define EMBEDDED_IO_DEFAULT_CACHE_SIZE	1024
+#define EMBEDDED_IO_PLUGIN_DIR		"PLUGIN_DIR="
+
+//Fragment files
+#define EMBEDDED_IO_FILE_MAGIC		"OPHEMB1\n"
+#define EMBEDDED_IO_FILE_MAGIC_LEN	8
+#define EMBEDDED_IO_FILE_BYTE_ORDER	0x01020304
+#define EMBEDDED_IO_FILE_VERSION	1
+#define EMBEDDED_IO_FILE_TMP		"%s.tmp.%d.%lu"
+
+//Fixed sizes
+#define EMBEDDED_IO_PATH_LEN		1024
+#define EMBEDDED_IO_NUM_LEN		64
+#define EMBEDDED_IO_UDF_RESULT_LEN	766
+#define EMBEDDED_IO_UDF_MESSAGE_LEN	512
+
+//Columns created by default with create_frag_select (as with MySQL plugin)
+#define EMBEDDED_IO_DEFAULT_COLUMNS	"id_dim|measure"
+#define EMBEDDED_IO_DEFAULT_TYPES	"long|blob"
+
+//Native functions
+#define EMBEDDED_IO_FUNC_EXPORT		"oph_export"
+#define EMBEDDED_IO_FUNC_SIZE		"oph_size"
+#define EMBEDDED_IO_FUNC_ID		"id_dim"
+#define EMBEDDED_IO_FUNC_MEASURE	"measure"
+
+//Columns of the virtual table of primitives
+#define EMBEDDED_IO_FUNC_TABLE_COLUMNS	"name|ret|dl|type"
+#define EMBEDDED_IO_FUNC_TYPE_AGGREGATE	"aggregate"
+
+/**
+ * \brief Types of the values handled by the engine (the same of the primitives, plus NULL)
+ */
+typedef enum { EMBEDDED_IO_VALUE_NULL = 0, EMBEDDED_IO_VALUE_INT, EMBEDDED_IO_VALUE_REAL, EMBEDDED_IO_VALUE_DECIMAL, EMBEDDED_IO_VALUE_STRING
+} _embedded_value_type;
+
+/**
+ * \brief Operations of the submission query language
+ */
+typedef enum { EMBEDDED_IO_OP_SELECT, EMBEDDED_IO_OP_CREATE_FRAG_SELECT, EMBEDDED_IO_OP_INSERT_SELECT, EMBEDDED_IO_OP_CREATE_FRAG, EMBEDDED_IO_OP_DROP_FRAG,
+	EMBEDDED_IO_OP_INSERT, EMBEDDED_IO_OP_MULTI_INSERT, EMBEDDED_IO_OP_CREATE_DB, EMBEDDED_IO_OP_DROP_DB, EMBEDDED_IO_OP_FUNCTION
+} _embedded_operation;
+
+/**
+ * \brief Kinds of the nodes of an expression
+ */
+typedef enum { EMBEDDED_IO_EXPR_LITERAL, EMBEDDED_IO_EXPR_PARAM, EMBEDDED_IO_EXPR_COLUMN, EMBEDDED_IO_EXPR_FUNC, EMBEDDED_IO_EXPR_UNARY, EMBEDDED_IO_EXPR_BINARY,
+	EMBEDDED_IO_EXPR_BETWEEN, EMBEDDED_IO_EXPR_IN, EMBEDDED_IO_EXPR_LIKE, EMBEDDED_IO_EXPR_IS_NULL
+} _embedded_expr_kind;
+
+/**
+ * \brief Tokens of the expressions
+ */
+typedef enum { EMBEDDED_IO_TOKEN_END, EMBEDDED_IO_TOKEN_IDENT, EMBEDDED_IO_TOKEN_INT, EMBEDDED_IO_TOKEN_DECIMAL, EMBEDDED_IO_TOKEN_REAL, EMBEDDED_IO_TOKEN_STRING,
+	EMBEDDED_IO_TOKEN_PARAM, EMBEDDED_IO_TOKEN_LPAREN, EMBEDDED_IO_TOKEN_RPAREN, EMBEDDED_IO_TOKEN_COMMA, EMBEDDED_IO_TOKEN_DOT, EMBEDDED_IO_TOKEN_PLUS, EMBEDDED_IO_TOKEN_MINUS,
+	EMBEDDED_IO_TOKEN_STAR, EMBEDDED_IO_TOKEN_SLASH, EMBEDDED_IO_TOKEN_PERCENT, EMBEDDED_IO_TOKEN_DIV, EMBEDDED_IO_TOKEN_EQ, EMBEDDED_IO_TOKEN_NE, EMBEDDED_IO_TOKEN_LT,
+	EMBEDDED_IO_TOKEN_LE, EMBEDDED_IO_TOKEN_GT, EMBEDDED_IO_TOKEN_GE, EMBEDDED_IO_TOKEN_AND, EMBEDDED_IO_TOKEN_OR, EMBEDDED_IO_TOKEN_NOT, EMBEDDED_IO_TOKEN_BETWEEN,
+	EMBEDDED_IO_TOKEN_IN, EMBEDDED_IO_TOKEN_LIKE, EMBEDDED_IO_TOKEN_IS, EMBEDDED_IO_TOKEN_NULL, EMBEDDED_IO_TOKEN_ERROR
+} _embedded_token;
+
+/**
+ * \brief           Struct of a value (a cell of a table or the outcome of an expression)
+ * \param type      Type of the value
+ * \param owned     Flag set if the string has to be freed with the value
+ * \param length    Length of the string
+ * \param l         Integer value
+ * \param d         Real value
+ * \param s         String value (binary safe)
+ */
+typedef struct {
+	char type;
+	char owned;
+	unsigned long length;
+	long long l;
+	double d;
+	char *s;
+} _embedded_value;
+
+/**
+ * \brief             Struct of a fragment cached in memory
+ * \param db          Name of the database
+ * \param name        Name of the fragment
+ * \param num_columns Number of columns
+ * \param columns     Names of the columns
+ * \param types       Types the values are converted to before being stored (NULL for any type)
+ * \param num_rows    Number of rows
+ * \param max_rows    Number of rows allocated
+ * \param cells       Values (row-major order)
+ * \param map         Memory map of the fragment file; strings loaded from the file point into it
+ * \param map_size    Size of the memory map
+ * \param ino         Inode of the file when it has been loaded or saved
+ * \param mtime       Modification time of the file when it has been loaded or saved
+ * \param size        Size of the file when it has been loaded or saved
+ * \param mem_size    Memory used by the fragment
+ * \param dirty       Flag set if the fragment has to be saved
+ * \param dropped     Flag set if the fragment has been dropped while still in use
+ * \param saving      Flag set while the fragment is being saved
+ * \param refcount    Number of users of the fragment
+ * \param lock        Lock protecting the values
+ * \param prev        Previous fragment in the cache (more recently used)
+ * \param next        Next fragment in the cache (less recently used)
+ */
+typedef struct _embedded_table {
+	char *db;
+	char *name;
+	unsigned int num_columns;
+	char **columns;
+	char *types;
+	unsigned long long num_rows;
+	unsigned long long max_rows;
+	_embedded_value *cells;
+	void *map;
+	size_t map_size;
+	ino_t ino;
+	time_t mtime;
+	off_t size;
+	size_t mem_size;
+	char dirty;
+	char dropped;
+	char saving;
+	int refcount;
+	pthread_rwlock_t lock;
+	struct _embedded_table *prev;
+	struct _embedded_table *next;
+} _embedded_table;
+
+/**
+ * \brief             Struct of a primitive (user-defined function) listed in the primitives file
+ * \param name        Name of the primitive
+ * \param ret         Type of the return value (as in mysql.func)
+ * \param dl          Shared library implementing the primitive
+ * \param type        Type of the primitive ('function' or 'aggregate')
+ * \param aggregate   Flag set for aggregate primitives
+ * \param loaded      Flag set when the library has been loaded (negative on error)
+ * \param dlh         Handle of the library
+ * \param func        Main function
+ * \param init        Initialization function
+ * \param deinit      Finalization function
+ * \param clear       Function resetting the state of an aggregate primitive
+ * \param add         Function adding a row to an aggregate primitive
+ */
+typedef struct {
+	char *name;
+	int ret;
+	char *dl;
+	char *type;
+	char aggregate;
+	char loaded;
+	void *dlh;
+	void *func;
+	my_bool(*init) (UDF_INIT *, UDF_ARGS *, char *);
+	void (*deinit) (UDF_INIT *);
+	void (*clear) (UDF_INIT *, char *, char *);
+	void (*add) (UDF_INIT *, UDF_ARGS *, char *, char *);
+} _embedded_primitive;
+
+/**
+ * \brief               Struct of a node of an expression
+ * \param kind          Kind of the node
+ * \param op            Operator (token) of unary and binary nodes; negation flag of BETWEEN, IN, LIKE and IS NULL
+ * \param text          Text of the expression (used as attribute of the arguments of primitives and as column name)
+ * \param name          Name of the column or of the primitive
+ * \param qualifier     Table alias of the column
+ * \param param         Index of the placeholder
+ * \param table         Index of the table of the column, resolved at execution time
+ * \param column        Index of the column, resolved at execution time
+ * \param value         Literal value or outcome of the last evaluation
+ * \param args          Children of the node
+ * \param num_args      Number of children
+ * \param is_const      Flag set if the expression does not depend on columns
+ * \param has_aggregate Flag set if an aggregate primitive is in the expression
+ * \param primitive     Primitive called by the node
+ * \param initid        State of the primitive
+ * \param udf_args      Arguments of the primitive
+ * \param udf_l         Storage of integer arguments
+ * \param udf_d         Storage of real arguments
+ * \param udf_buf       Storage of the text representation of numeric arguments
+ * \param result        Buffer for string results of the primitive
+ * \param initialized   Flag set when the primitive has been initialized
+ * \param computed      Flag set when the final value of an aggregate primitive has been computed
+ */
+typedef struct _embedded_expr {
+	_embedded_expr_kind kind;
+	int op;
+	char *text;
+	char *name;
+	char *qualifier;
+	int param;
+	int table;
+	int column;
+	_embedded_value value;
+	struct _embedded_expr **args;
+	int num_args;
+	char is_const;
+	char has_aggregate;
+	_embedded_primitive *primitive;
+	UDF_INIT initid;
+	UDF_ARGS udf_args;
+	long long *udf_l;
+	double *udf_d;
+	char (*udf_buf)[EMBEDDED_IO_NUM_LEN];
+	char *result;
+	char initialized;
+	char computed;
+} _embedded_expr;
+
+/**
+ * \brief                 Struct of a statement built from a submission query
+ * \param operation       Operation to be executed
+ * \param db              Database of the target fragment (NULL for the default one)
+ * \param name            Name of the target fragment or of the database
+ * \param fields          Selected expressions or inserted values
+ * \param aliases         Names of the selected expressions (NULL if not given)
+ * \param num_fields      Number of expressions in fields
+ * \param columns         Target columns of create_frag and insert operations
+ * \param types           Types of the columns of create_frag operation
+ * \param num_columns     Number of target columns
+ * \param from_db         Databases of the source fragments (NULL for the default one)
+ * \param from            Names of the source fragments
+ * \param from_alias      Aliases of the source fragments (NULL if not given)
+ * \param num_from        Number of source fragments
+ * \param function_table  Flag set if the primitives are selected
+ * \param where           Filter (NULL if not given)
+ * \param group           Grouping expressions
+ * \param num_group       Number of grouping expressions
+ * \param order           Ordering expressions
+ * \param num_order       Number of ordering expressions
+ * \param order_desc      Flag set for descending order
+ * \param limit_offset    Number of rows to be skipped
+ * \param limit_count     Maximum number of rows to be returned (negative if not limited)
+ * \param has_aggregate   Flag set if an aggregate primitive is in the selected expressions
+ * \param params          Placeholders in the order they appear in the query
+ * \param num_params      Number of placeholders
+ * \param args            Arguments bound to the placeholders
+ * \param func_args       Arguments of the native functions
+ * \param num_func_args   Number of arguments of the native functions
+ * \param changed_db      Database of the fragment changed by the query, saved when the query is released (NULL if nothing has been changed)
+ */
+typedef struct {
+	_embedded_operation operation;
+	char *db;
+	char *name;
+	_embedded_expr **fields;
+	char **aliases;
+	int num_fields;
+	char **columns;
+	char *types;
+	int num_columns;
+	char **from_db;
+	char **from;
+	char **from_alias;
+	int num_from;
+	char function_table;
+	_embedded_expr *where;
+	_embedded_expr **group;
+	int num_group;
+	_embedded_expr **order;
+	int num_order;
+	char order_desc;
+	long long limit_offset;
+	long long limit_count;
+	char has_aggregate;
+	_embedded_expr **params;
+	int num_params;
+	oph_ioserver_query_arg **args;
+	char **func_args;
+	int num_func_args;
+	char *changed_db;
+} _embedded_statement;
+
+/**
+ * \brief             Struct of a result set; strings of the rows may point into the cells of the fragments they have been read from
+ * \param num_fields  Number of fields
+ * \param num_rows    Number of rows
+ * \param current     Index of the next row to be fetched
+ * \param values      Values (row-major order)
+ * \param tables      Fragments the values may point into
+ * \param num_tables  Number of fragments
+ * \param row         Pointers to the values of the current row
+ * \param lengths     Lengths of the values of the current row
+ * \param scratch     Buffer for the text representation of numeric values of the current row
+ */
+typedef struct {
+	unsigned int num_fields;
+	unsigned long long num_rows;
+	unsigned long long current;
+	_embedded_value *values;
+	_embedded_table **tables;
+	int num_tables;
+	char **row;
+	unsigned long *lengths;
+	char *scratch;
+} _embedded_result_set;
+
+/**
+ * \brief           Struct of a connection to the embedded server
+ * \param db        Default database
+ * \param pending   Result set of the last query, to be retrieved with get_result
+ */
+typedef struct {
+	char *db;
+	_embedded_result_set *pending;
+} _embedded_connection;
+
+/**
+ * \brief               Function to initialize data store server library.
+ * \param handle        Address to pointer for dynamic server plugin handle
+ * \return              0 if successfull, non-0 otherwise
+ */
+int _embedded_setup(oph_ioserver_handler * handle);
+
+/**
+ * \brief               Function to connect or reconnect to data store server.
+ * \param handle        Dynamic server plugin handle
+ * \param conn_params   Struct with connection params to server
+ * \param connection    Adress of pointer to server-specific connection structure
+ * \return              0 if successfull, non-0 otherwise
+ */
+int _embedded_connect(oph_ioserver_handler * handle, oph_ioserver_params * conn_params, void **connection);
+
+/**
+ * \brief               Function to set default database for specified server.
+ * \param handle        Dynamic server plugin handle
+ * \param db_name       Name of database to be used
+ * \param connection    Pointer to server-specific connection structure
+ * \return              0 if successfull, non-0 otherwise
+ */
+int _embedded_use_db(oph_ioserver_handler * handle, const char *db_name, void *connection);
+
+/**
+ * \brief               Function to execute an operation on data stored into server.
+ * \param handle        Dynamic server plugin handle
+ * \param connection    Pointer to server-specific connection structure
+ * \param query         Pointer to query to be executed
+ * \return              0 if successfull, non-0 otherwise
+ */
+int _embedded_execute_query(oph_ioserver_handler * handle, void *connection, oph_ioserver_query * query);
+
+/**
+ * \brief               Function to setup the query structure with given operation and array argument
+ * \param handle        Dynamic server plugin handle
+ * \param connection    Pointer to server-specific connection structure
+ * \param operation     String with operation to be performed
+ * \param tot_run       Total number of runs the given operation will be executed
+ * \param args          Array of arguments to be binded to the query (can be NULL)
+ * \param query         Pointer to query to be built
+ * \return              0 if successfull, non-0 otherwise
+ */
+int _embedded_setup_query(oph_ioserver_handler * handle, void *connection, const char *operation, unsigned long long tot_run, oph_ioserver_query_arg ** args, oph_ioserver_query ** query);
+
+/**
+ * \brief               Function to release resources allocated for query
+ * \param handle        Dynamic server plugin handle
+ * \param query         Pointer to query to be executed
+ * \return              0 if successfull, non-0 otherwise
+ */
+int _embedded_free_query(oph_ioserver_handler * handle, oph_ioserver_query * query);
+
+/**
+ * \brief               Function to close connection established towards data store server.
+ * \param handle        Dynamic server plugin handle
+ * \param connection    Pointer to server-specific connection structure
+ * \return              0 if successfull, non-0 otherwise
+ */
+int _embedded_close(oph_ioserver_handler * handle, void **connection);
+
+/**
+ * \brief               Function to finalize library of data store server and release all dynamic loading resources.
+ * \param handle        Dynamic server plugin handle
+ * \return              0 if successfull, non-0 otherwise
+ */
+int _embedded_cleanup(oph_ioserver_handler * handle);
+
+/**
+ * \brief               Function to get result set after executing a query.
+ * \param handle        Dynamic server plugin handle
+ * \param connection    Pointer to server-specific connection structure
+ * \param result        Pointer to the result set structure to be filled
+ * \return              0 if successfull, non-0 otherwise
+ */
+int _embedded_get_result(oph_ioserver_handler * handle, void *connection, oph_ioserver_result ** result);
+
+/**
+ * \brief               Function to fetch the next row in a result set.
+ * \param handle        Dynamic server plugin handle
+ * \param result        Pointer to the result set structure to scan
+ * \param current_row	Pointer to the next row structure in the result set
+ * \return              0 if successfull, non-0 otherwise
+ */
+int _embedded_fetch_row(oph_ioserver_handler * handle, oph_ioserver_result * result, oph_ioserver_row ** current_row);
+
+/**
+ * \brief               Function to free the allocated result set.
+ * \param handle        Dynamic server plugin handle
+ * \param result        Pointer to the result set structure to free
+ * \return              0 if successfull, non-0 otherwise
+ */
+int _embedded_free_result(oph_ioserver_handler * handle, oph_ioserver_result * result);
+
+#endif				//__EMBEDDED_IOSERVER_H
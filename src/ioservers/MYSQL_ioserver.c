@@ -25,11 +25,16 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <pthread.h>
 #include "oph_ioserver_plugins_log_error_codes.h"
 #include "oph_ioserver_submission_query.h"
 #include "oph_ioserver_parser_library.h"
 #include "hashtbl.h"
 
+pthread_mutex_t _mysql_stmt_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+_mysql_stmt_cache *_mysql_stmt_caches = NULL;
+unsigned long long _mysql_stmt_cache_hits = 0, _mysql_stmt_cache_misses = 0;
+
 int oph_map_keyword(oph_ioserver_handler * handle, char *keyword, char (*argument)[OPH_IOSERVER_SQ_LEN])
 {
 	if (!keyword || !argument) {
@@ -875,11 +880,14 @@ int oph_query_parser(oph_ioserver_handler * handle, const char *query_string, ch
 	int n = 0;
 
 	//SWITCH on operation
-	if (strncasecmp(query_oper, OPH_IOSERVER_SQ_OP_CREATE_FRAG_SELECT, STRLEN_MAX(query_oper, OPH_IOSERVER_SQ_OP_CREATE_FRAG_SELECT)) == 0) {
+	if ((strncasecmp(query_oper, OPH_IOSERVER_SQ_OP_CREATE_FRAG_SELECT, STRLEN_MAX(query_oper, OPH_IOSERVER_SQ_OP_CREATE_FRAG_SELECT)) == 0)
+	    || (strncasecmp(query_oper, OPH_IOSERVER_SQ_OP_CREATE_FRAG_VIEW, STRLEN_MAX(query_oper, OPH_IOSERVER_SQ_OP_CREATE_FRAG_VIEW)) == 0)) {
 		//Compose query by selecting fields in the right order 
 
-		//First part of query + new table name
-		if (oph_first_block(handle, hashtbl, MYSQL_IO_QUERY_CREATE_FRAG_SELECT, OPH_IOSERVER_SQ_ARG_FRAG, &n, &query)) {
+		//First part of query + new table (or view) name
+		if (oph_first_block
+		    (handle, hashtbl, strncasecmp(query_oper, OPH_IOSERVER_SQ_OP_CREATE_FRAG_VIEW, STRLEN_MAX(query_oper, OPH_IOSERVER_SQ_OP_CREATE_FRAG_VIEW)) ? MYSQL_IO_QUERY_CREATE_FRAG_SELECT :
+		     MYSQL_IO_QUERY_CREATE_FRAG_VIEW, OPH_IOSERVER_SQ_ARG_FRAG, &n, &query)) {
 			pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_LOG_MYSQL_ARG_EVAL_ERROR, "FRAG NAME");
 			logging_server(LOG_ERROR, __FILE__, __LINE__, handle->server_type, OPH_IOSERVER_LOG_MYSQL_ARG_EVAL_ERROR, "FRAG NAME");
 			hashtbl_destroy(hashtbl);
@@ -1066,6 +1074,54 @@ int oph_query_parser(oph_ioserver_handler * handle, const char *query_string, ch
 			return MYSQL_IO_ERROR;
 		}
 
+	} else if (strncasecmp(query_oper, OPH_IOSERVER_SQ_OP_CREATE_FRAG_LINK, STRLEN_MAX(query_oper, OPH_IOSERVER_SQ_OP_CREATE_FRAG_LINK)) == 0) {
+		//Compose query by selecting fields in the right order
+
+		//The link is a FEDERATED table: rows are streamed from the remote server each time the table is read
+
+		//First part of query + new table name
+		if (oph_first_block(handle, hashtbl, MYSQL_IO_QUERY_CREATE_FRAG_LINK, OPH_IOSERVER_SQ_ARG_FRAG, &n, &query)) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_LOG_MYSQL_ARG_EVAL_ERROR, "FRAG NAME");
+			logging_server(LOG_ERROR, __FILE__, __LINE__, handle->server_type, OPH_IOSERVER_LOG_MYSQL_ARG_EVAL_ERROR, "FRAG NAME");
+			hashtbl_destroy(hashtbl);
+			return MYSQL_IO_ERROR;
+		}
+		//Connection string of the remote fragment, in the form server_name/table_name
+		if (oph_first_block(handle, hashtbl, MYSQL_IO_QUERY_CONNECTION, OPH_IOSERVER_SQ_ARG_PATH, &n, &query)) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_LOG_MYSQL_ARG_EVAL_ERROR, "SOURCE PATH");
+			logging_server(LOG_ERROR, __FILE__, __LINE__, handle->server_type, OPH_IOSERVER_LOG_MYSQL_ARG_EVAL_ERROR, "SOURCE PATH");
+			hashtbl_destroy(hashtbl);
+			return MYSQL_IO_ERROR;
+		}
+
+	} else if (strncasecmp(query_oper, OPH_IOSERVER_SQ_OP_CREATE_SERVER, STRLEN_MAX(query_oper, OPH_IOSERVER_SQ_OP_CREATE_SERVER)) == 0) {
+		//Compose query by selecting fields in the right order
+
+		//Credentials of a remote server are stored by MySQL until the server is dropped, so that links do not have to embed them
+		const char *server_parts[] = { MYSQL_IO_QUERY_CREATE_SERVER, MYSQL_IO_QUERY_SERVER_HOST, MYSQL_IO_QUERY_SERVER_PORT, MYSQL_IO_QUERY_SERVER_USER, MYSQL_IO_QUERY_SERVER_PASSWORD,
+			MYSQL_IO_QUERY_SERVER_DB
+		};
+		const char *server_args[] = { OPH_IOSERVER_SQ_ARG_SERVER, OPH_IOSERVER_SQ_ARG_HOST, OPH_IOSERVER_SQ_ARG_PORT, OPH_IOSERVER_SQ_ARG_USER, OPH_IOSERVER_SQ_ARG_PASSWORD, OPH_IOSERVER_SQ_ARG_DB };
+		int k;
+		for (k = 0; k < (int) (sizeof(server_args) / sizeof(server_args[0])); k++)
+			if (oph_first_block(handle, hashtbl, server_parts[k], server_args[k], &n, &query)) {
+				pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_LOG_MYSQL_ARG_EVAL_ERROR, server_args[k]);
+				logging_server(LOG_ERROR, __FILE__, __LINE__, handle->server_type, OPH_IOSERVER_LOG_MYSQL_ARG_EVAL_ERROR, server_args[k]);
+				hashtbl_destroy(hashtbl);
+				return MYSQL_IO_ERROR;
+			}
+
+	} else if (strncasecmp(query_oper, OPH_IOSERVER_SQ_OP_DROP_SERVER, STRLEN_MAX(query_oper, OPH_IOSERVER_SQ_OP_DROP_SERVER)) == 0) {
+		//Compose query by selecting fields in the right order
+
+		//First part of query + server name
+		if (oph_first_block(handle, hashtbl, MYSQL_IO_QUERY_DROP_SERVER, OPH_IOSERVER_SQ_ARG_SERVER, &n, &query)) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_LOG_MYSQL_ARG_EVAL_ERROR, "SERVER NAME");
+			logging_server(LOG_ERROR, __FILE__, __LINE__, handle->server_type, OPH_IOSERVER_LOG_MYSQL_ARG_EVAL_ERROR, "SERVER NAME");
+			hashtbl_destroy(hashtbl);
+			return MYSQL_IO_ERROR;
+		}
+
 	} else if (strncasecmp(query_oper, OPH_IOSERVER_SQ_OP_FUNCTION, STRLEN_MAX(query_oper, OPH_IOSERVER_SQ_OP_FUNCTION)) == 0) {
 		//Compose query by selecting fields in the right order 
 
@@ -1113,11 +1169,14 @@ int oph_query_parser(oph_ioserver_handler * handle, const char *query_string, ch
 				return MYSQL_IO_ERROR;
 			}
 		}
-	} else if (strncasecmp(query_oper, OPH_IOSERVER_SQ_OP_DROP_FRAG, STRLEN_MAX(query_oper, OPH_IOSERVER_SQ_OP_DROP_FRAG)) == 0) {
+	} else if ((strncasecmp(query_oper, OPH_IOSERVER_SQ_OP_DROP_FRAG, STRLEN_MAX(query_oper, OPH_IOSERVER_SQ_OP_DROP_FRAG)) == 0)
+		   || (strncasecmp(query_oper, OPH_IOSERVER_SQ_OP_DROP_FRAG_VIEW, STRLEN_MAX(query_oper, OPH_IOSERVER_SQ_OP_DROP_FRAG_VIEW)) == 0)) {
 		//Compose query by selecting fields in the right order 
 
-		//First part of query + new table name
-		if (oph_first_block(handle, hashtbl, MYSQL_IO_QUERY_DROP_FRAG, OPH_IOSERVER_SQ_ARG_FRAG, &n, &query)) {
+		//First part of query + new table (or view) name
+		if (oph_first_block
+		    (handle, hashtbl, strncasecmp(query_oper, OPH_IOSERVER_SQ_OP_DROP_FRAG_VIEW, STRLEN_MAX(query_oper, OPH_IOSERVER_SQ_OP_DROP_FRAG_VIEW)) ? MYSQL_IO_QUERY_DROP_FRAG :
+		     MYSQL_IO_QUERY_DROP_FRAG_VIEW, OPH_IOSERVER_SQ_ARG_FRAG, &n, &query)) {
 			pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_LOG_MYSQL_ARG_EVAL_ERROR, "FRAG NAME");
 			logging_server(LOG_ERROR, __FILE__, __LINE__, handle->server_type, OPH_IOSERVER_LOG_MYSQL_ARG_EVAL_ERROR, "FRAG NAME");
 			hashtbl_destroy(hashtbl);
@@ -1231,6 +1290,208 @@ int oph_to_mysql_type(oph_ioserver_handler * handle, oph_ioserver_arg_types oph_
 	return MYSQL_IO_SUCCESS;
 }
 
+//64-bit FNV-1a hash of a submission string
+unsigned long long _mysql_stmt_cache_hash(const char *operation)
+{
+	unsigned long long hash = 14695981039346656037ULL;
+	for (; *operation; operation++) {
+		hash ^= (unsigned char) *operation;
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+void _mysql_stmt_cache_entry_free(_mysql_stmt_cache_entry * entry)
+{
+	if (!entry)
+		return;
+	if (entry->query.stmt)
+		mysql_stmt_close(entry->query.stmt);
+	if (entry->query.bind)
+		free(entry->query.bind);
+	if (entry->operation)
+		free(entry->operation);
+	free(entry);
+}
+
+//Unlink an entry from the LRU list of its cache; call it with _mysql_stmt_cache_lock held
+void _mysql_stmt_cache_unlink(_mysql_stmt_cache_entry * entry)
+{
+	_mysql_stmt_cache *cache = entry->cache;
+	if (entry->prev)
+		entry->prev->next = entry->next;
+	else
+		cache->head = entry->next;
+	if (entry->next)
+		entry->next->prev = entry->prev;
+	else
+		cache->tail = entry->prev;
+	entry->prev = entry->next = NULL;
+	cache->size--;
+}
+
+//Insert an entry as the most recently used one; call it with _mysql_stmt_cache_lock held
+void _mysql_stmt_cache_push(_mysql_stmt_cache * cache, _mysql_stmt_cache_entry * entry)
+{
+	entry->cache = cache;
+	entry->prev = NULL;
+	entry->next = cache->head;
+	if (cache->head)
+		cache->head->prev = entry;
+	else
+		cache->tail = entry;
+	cache->head = entry;
+	cache->size++;
+}
+
+//Get the cache of a connection, creating it if needed; call it with _mysql_stmt_cache_lock held
+_mysql_stmt_cache *_mysql_stmt_cache_get(MYSQL * connection, char create)
+{
+	_mysql_stmt_cache *cache;
+	for (cache = _mysql_stmt_caches; cache; cache = cache->next)
+		if (cache->connection == connection)
+			return cache;
+	if (!create || !(cache = (_mysql_stmt_cache *) calloc(1, sizeof(_mysql_stmt_cache))))
+		return NULL;
+	cache->connection = connection;
+	cache->next = _mysql_stmt_caches;
+	_mysql_stmt_caches = cache;
+	return cache;
+}
+
+//Look for an idle statement prepared for the same submission string and lease it
+_mysql_stmt_cache_entry *_mysql_stmt_cache_lease(MYSQL * connection, const char *operation, unsigned long long hash)
+{
+	_mysql_stmt_cache_entry *entry = NULL;
+
+	pthread_mutex_lock(&_mysql_stmt_cache_lock);
+	_mysql_stmt_cache *cache = _mysql_stmt_cache_get(connection, 0);
+	if (cache)
+		for (entry = cache->head; entry; entry = entry->next)
+			if (!entry->in_use && entry->valid && (entry->hash == hash) && !strcmp(entry->operation, operation))
+				break;
+	if (entry) {
+		_mysql_stmt_cache_unlink(entry);
+		_mysql_stmt_cache_push(cache, entry);
+		entry->in_use = 1;
+		cache->hits++;
+		_mysql_stmt_cache_hits++;
+	}
+	pthread_mutex_unlock(&_mysql_stmt_cache_lock);
+
+	return entry;
+}
+
+//Add a leased statement to the cache of a connection, evicting the least recently used idle statements; return 1 if the statement has been cached
+int _mysql_stmt_cache_add(MYSQL * connection, _mysql_stmt_cache_entry * entry)
+{
+	_mysql_stmt_cache_entry *evicted = NULL, *current, *prev;
+
+	pthread_mutex_lock(&_mysql_stmt_cache_lock);
+	_mysql_stmt_cache *cache = _mysql_stmt_cache_get(connection, 1);
+	if (!cache) {
+		pthread_mutex_unlock(&_mysql_stmt_cache_lock);
+		return 0;
+	}
+	cache->misses++;
+	_mysql_stmt_cache_misses++;
+	entry->in_use = 1;
+	_mysql_stmt_cache_push(cache, entry);
+	for (current = cache->tail; current && (cache->size > MYSQL_IO_STMT_CACHE_SIZE); current = prev) {
+		prev = current->prev;
+		if (current->in_use)
+			continue;
+		_mysql_stmt_cache_unlink(current);
+		current->next = evicted;
+		evicted = current;
+	}
+	pthread_mutex_unlock(&_mysql_stmt_cache_lock);
+
+	for (; evicted; evicted = current) {
+		current = evicted->next;
+		_mysql_stmt_cache_entry_free(evicted);
+	}
+
+	return 1;
+}
+
+//Give back a leased statement to the cache; statements no longer valid or belonging to closed connections are released
+void _mysql_stmt_cache_release(_mysql_stmt_cache_entry * entry)
+{
+	char to_be_freed = 0;
+
+	pthread_mutex_lock(&_mysql_stmt_cache_lock);
+	entry->in_use = 0;
+	if (!entry->cache)
+		to_be_freed = 1;
+	else if (!entry->valid) {
+		_mysql_stmt_cache_unlink(entry);
+		to_be_freed = 1;
+	}
+	pthread_mutex_unlock(&_mysql_stmt_cache_lock);
+
+	if (to_be_freed)
+		_mysql_stmt_cache_entry_free(entry);
+}
+
+//Release the statements cached for a connection; it has to be called before closing the connection
+void _mysql_stmt_cache_clear(oph_ioserver_handler * handle, MYSQL * connection)
+{
+	_mysql_stmt_cache *cache, *prev = NULL;
+	_mysql_stmt_cache_entry *entry, *next, *idle = NULL;
+
+	pthread_mutex_lock(&_mysql_stmt_cache_lock);
+	for (cache = _mysql_stmt_caches; cache; prev = cache, cache = cache->next)
+		if (cache->connection == connection)
+			break;
+	if (!cache) {
+		pthread_mutex_unlock(&_mysql_stmt_cache_lock);
+		return;
+	}
+	if (prev)
+		prev->next = cache->next;
+	else
+		_mysql_stmt_caches = cache->next;
+	for (entry = cache->head; entry; entry = next) {
+		next = entry->next;
+		entry->prev = entry->next = NULL;
+		entry->cache = NULL;
+		//Statements still in use will be released by _mysql_free_query
+		if (!entry->in_use) {
+			entry->next = idle;
+			idle = entry;
+		}
+	}
+	pthread_mutex_unlock(&_mysql_stmt_cache_lock);
+
+	for (; idle; idle = next) {
+		next = idle->next;
+		_mysql_stmt_cache_entry_free(idle);
+	}
+	pmesg(LOG_DEBUG, __FILE__, __LINE__, OPH_IOSERVER_LOG_MYSQL_STMT_CACHE_STATS, cache->hits, cache->misses);
+	if (handle)
+		logging_server(LOG_DEBUG, __FILE__, __LINE__, handle->server_type, OPH_IOSERVER_LOG_MYSQL_STMT_CACHE_STATS, cache->hits, cache->misses);
+	free(cache);
+}
+
+//Fill the bind buffers of a statement with the arguments of the query
+void _mysql_bind_args(oph_ioserver_handler * handle, MYSQL_BIND * bind, int param_count, oph_ioserver_query_arg ** args)
+{
+	enum enum_field_types mysql_tmp_type;
+	int arg_count;
+
+	memset(bind, 0, param_count * sizeof(MYSQL_BIND));
+	for (arg_count = 0; arg_count < param_count; arg_count++) {
+		bind[arg_count].buffer_length = args[arg_count]->arg_length;
+		oph_to_mysql_type(handle, args[arg_count]->arg_type, &mysql_tmp_type);
+		bind[arg_count].buffer_type = mysql_tmp_type;
+		bind[arg_count].length = (args[arg_count]->arg ? &(args[arg_count]->arg_length) : 0);
+		bind[arg_count].is_null = (my_bool *) (args[arg_count]->arg_is_null ? 0 : &(args[arg_count]->arg_is_null));
+		bind[arg_count].is_unsigned = 0;
+		bind[arg_count].buffer = args[arg_count]->arg;
+	}
+}
+
 //Initialize storage server plugin
 int _mysql_setup(oph_ioserver_handler * handle)
 {
@@ -1276,6 +1537,7 @@ int _mysql_connect(oph_ioserver_handler * handle, oph_ioserver_params * conn_par
 			pmesg(LOG_WARNING, __FILE__, __LINE__, OPH_IOSERVER_LOG_MYSQL_LOST_CONN);
 			logging_server(LOG_ERROR, __FILE__, __LINE__, handle->server_type, OPH_IOSERVER_LOG_MYSQL_LOST_CONN);
 
+			_mysql_stmt_cache_clear(handle, (MYSQL *) * connection);
 			mysql_close((MYSQL *) * connection);	// Flush any data related to previuos connection 
 
 			if (!(*connection = (void *) mysql_init(NULL))) {
@@ -1335,14 +1597,20 @@ int _mysql_execute_query(oph_ioserver_handler * handle, void *connection, oph_io
 			{
 				MYSQL_STMT *tmp_stmt = (MYSQL_STMT *) ((_mysql_query_struct *) query->statement)->stmt;
 				MYSQL_BIND *tmp_bind = (MYSQL_BIND *) ((_mysql_query_struct *) query->statement)->bind;
+				_mysql_stmt_cache_entry *tmp_entry = ((_mysql_query_struct *) query->statement)->entry;
 				if (mysql_stmt_bind_param(tmp_stmt, tmp_bind) && mysql_stmt_errno(tmp_stmt)) {
 					pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_LOG_MYSQL_BINDING_ERROR, mysql_stmt_error(tmp_stmt));
 					logging_server(LOG_ERROR, __FILE__, __LINE__, handle->server_type, OPH_IOSERVER_LOG_MYSQL_BINDING_ERROR, mysql_stmt_error(tmp_stmt));
+					if (tmp_entry)
+						tmp_entry->valid = 0;
 					return MYSQL_IO_ERROR;
 				}
 				if (mysql_stmt_execute(tmp_stmt) && mysql_stmt_errno(tmp_stmt)) {
 					pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_LOG_MYSQL_STMT_EXEC_ERROR, mysql_stmt_error(tmp_stmt));
 					logging_server(LOG_ERROR, __FILE__, __LINE__, handle->server_type, OPH_IOSERVER_LOG_MYSQL_STMT_EXEC_ERROR, mysql_stmt_error(tmp_stmt));
+					//The statement is prepared again by next queries (e.g. in case the table has been dropped)
+					if (tmp_entry)
+						tmp_entry->valid = 0;
 					return MYSQL_IO_ERROR;
 				}
 			}
@@ -1356,10 +1624,9 @@ int _mysql_execute_query(oph_ioserver_handler * handle, void *connection, oph_io
 	return MYSQL_IO_SUCCESS;
 }
 
-//Setup the query structure with given operation and array argument
-int _mysql_setup_query(oph_ioserver_handler * handle, void *connection, const char *operation, unsigned long long tot_run, oph_ioserver_query_arg ** args, oph_ioserver_query ** query)
+//Setup the query structure with given operation (submission string or SQL statement) and array argument
+int _mysql_prepare_query(oph_ioserver_handler * handle, void *connection, const char *operation, char is_sql, oph_ioserver_query_arg ** args, oph_ioserver_query ** query)
 {
-	UNUSED(tot_run);	// TODO Handle tot number of runs
 	if (!connection || !operation || !query) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_LOG_MYSQL_NULL_INPUT_PARAM);
 		logging_server(LOG_ERROR, __FILE__, __LINE__, handle->server_type, OPH_IOSERVER_LOG_MYSQL_NULL_INPUT_PARAM);
@@ -1376,8 +1643,40 @@ int _mysql_setup_query(oph_ioserver_handler * handle, void *connection, const ch
 	short int is_stmt = 0;
 	oph_query_is_statement(handle, operation, &is_stmt);
 
+	//Statements prepared for the same operation are reused without parsing it again
+	int arg_count = 0;
+	unsigned long long hash = 0;
+	if (args && is_stmt) {
+		while (args[arg_count])
+			arg_count++;
+		hash = _mysql_stmt_cache_hash(operation);
+		_mysql_stmt_cache_entry *entry = _mysql_stmt_cache_lease((MYSQL *) connection, operation, hash);
+		if (entry) {
+			if (entry->param_count != arg_count) {
+				pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_LOG_MYSQL_STMT_ERROR, mysql_stmt_error(entry->query.stmt));
+				logging_server(LOG_ERROR, __FILE__, __LINE__, handle->server_type, OPH_IOSERVER_LOG_MYSQL_STMT_ERROR, mysql_stmt_error(entry->query.stmt));
+				_mysql_stmt_cache_release(entry);
+				free(*query);
+				*query = NULL;
+				return MYSQL_IO_ERROR;
+			}
+			_mysql_bind_args(handle, entry->query.bind, arg_count, args);
+			(*query)->type = OPH_IOSERVER_STMT_BINARY;
+			(*query)->statement = (void *) &(entry->query);
+			return MYSQL_IO_SUCCESS;
+		}
+	}
+
 	char *sql_query = NULL;
-	if (oph_query_parser(handle, operation, &sql_query)) {
+	if (is_sql) {
+		if (!(sql_query = strdup(operation))) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_LOG_MYSQL_MEMORY_ERROR);
+			logging_server(LOG_ERROR, __FILE__, __LINE__, handle->server_type, OPH_IOSERVER_LOG_MYSQL_MEMORY_ERROR);
+			free(*query);
+			*query = NULL;
+			return MYSQL_IO_ERROR;
+		}
+	} else if (oph_query_parser(handle, operation, &sql_query)) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_LOG_MYSQL_ERROR_PARSING);
 		logging_server(LOG_ERROR, __FILE__, __LINE__, handle->server_type, OPH_IOSERVER_LOG_MYSQL_ERROR_PARSING);
 		free(*query);
@@ -1423,15 +1722,6 @@ int _mysql_setup_query(oph_ioserver_handler * handle, void *connection, const ch
 		}
 		free(sql_query);
 
-		int arg_count = 0;
-		oph_ioserver_query_arg *arg_ptr = args[arg_count++];
-		//Reach null-termination
-		while (arg_ptr)
-			arg_ptr = args[arg_count++];
-
-		//Remove NULL arg from count
-		arg_count -= 1;
-
 		int param_count = mysql_stmt_param_count(stmt);
 
 		if (param_count != arg_count) {
@@ -1452,16 +1742,25 @@ int _mysql_setup_query(oph_ioserver_handler * handle, void *connection, const ch
 			return MYSQL_IO_ERROR;
 		}
 
-		enum enum_field_types mysql_tmp_type;
-		for (arg_count = 0; arg_count < param_count; arg_count++) {
-			bind[arg_count].buffer_length = args[arg_count]->arg_length;
-			oph_to_mysql_type(handle, args[arg_count]->arg_type, &mysql_tmp_type);
-			bind[arg_count].buffer_type = mysql_tmp_type;
-			bind[arg_count].length = (args[arg_count]->arg ? &(args[arg_count]->arg_length) : 0);
-			bind[arg_count].is_null = (my_bool *) (args[arg_count]->arg_is_null ? 0 : &(args[arg_count]->arg_is_null));
-			bind[arg_count].is_unsigned = 0;
-			bind[arg_count].buffer = args[arg_count]->arg;
+		_mysql_bind_args(handle, bind, param_count, args);
+
+		//Cache the statement for next queries with the same operation
+		_mysql_stmt_cache_entry *entry = (_mysql_stmt_cache_entry *) calloc(1, sizeof(_mysql_stmt_cache_entry));
+		if (entry && (entry->operation = strdup(operation))) {
+			entry->hash = hash;
+			entry->param_count = param_count;
+			entry->valid = 1;
+			entry->query.stmt = stmt;
+			entry->query.bind = bind;
+			entry->query.entry = entry;
+			if (_mysql_stmt_cache_add((MYSQL *) connection, entry)) {
+				(*query)->statement = (void *) &(entry->query);
+				return MYSQL_IO_SUCCESS;
+			}
+			entry->query.stmt = NULL;
+			entry->query.bind = NULL;
 		}
+		_mysql_stmt_cache_entry_free(entry);
 
 		(*query)->statement = (void *) malloc(1 * sizeof(_mysql_query_struct));
 		if (!(*query)->statement) {
@@ -1475,6 +1774,40 @@ int _mysql_setup_query(oph_ioserver_handler * handle, void *connection, const ch
 		}
 		((_mysql_query_struct *) (*query)->statement)->stmt = stmt;
 		((_mysql_query_struct *) (*query)->statement)->bind = bind;
+		((_mysql_query_struct *) (*query)->statement)->entry = NULL;
+	}
+
+	return MYSQL_IO_SUCCESS;
+}
+
+//Setup the query structure with given operation and array argument
+int _mysql_setup_query(oph_ioserver_handler * handle, void *connection, const char *operation, unsigned long long tot_run, oph_ioserver_query_arg ** args, oph_ioserver_query ** query)
+{
+	UNUSED(tot_run);	// TODO Handle tot number of runs
+	return _mysql_prepare_query(handle, connection, operation, 0, args, query);
+}
+
+//Setup the query structure with given SQL statement and array argument
+int _mysql_setup_native_query(oph_ioserver_handler * handle, void *connection, const char *operation, unsigned long long tot_run, oph_ioserver_query_arg ** args, oph_ioserver_query ** query)
+{
+	UNUSED(tot_run);	// TODO Handle tot number of runs
+	return _mysql_prepare_query(handle, connection, operation, 1, args, query);
+}
+
+//Translate a submission string into SQL
+int _mysql_translate_query(oph_ioserver_handler * handle, const char *operation, char **translated)
+{
+	if (!operation || !translated) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_LOG_MYSQL_NULL_INPUT_PARAM);
+		logging_server(LOG_ERROR, __FILE__, __LINE__, handle->server_type, OPH_IOSERVER_LOG_MYSQL_NULL_INPUT_PARAM);
+		return MYSQL_IO_NULL_PARAM;
+	}
+
+	*translated = NULL;
+	if (oph_query_parser(handle, operation, translated)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_LOG_MYSQL_ERROR_PARSING);
+		logging_server(LOG_ERROR, __FILE__, __LINE__, handle->server_type, OPH_IOSERVER_LOG_MYSQL_ERROR_PARSING);
+		return MYSQL_IO_ERROR;
 	}
 
 	return MYSQL_IO_SUCCESS;
@@ -1494,6 +1827,10 @@ int _mysql_free_query(oph_ioserver_handler * handle, oph_ioserver_query * query)
 			free((char *) query->statement);
 			break;
 		case OPH_IOSERVER_STMT_BINARY:
+			if (((_mysql_query_struct *) query->statement)->entry) {
+				_mysql_stmt_cache_release(((_mysql_query_struct *) query->statement)->entry);
+				break;
+			}
 			mysql_stmt_close((MYSQL_STMT *) ((_mysql_query_struct *) query->statement)->stmt);
 			free((MYSQL_BIND *) ((_mysql_query_struct *) query->statement)->bind);
 			free((_mysql_query_struct *) query->statement);
@@ -1519,6 +1856,7 @@ int _mysql_close(oph_ioserver_handler * handle, void **connection)
 	}
 
 	if (*connection) {
+		_mysql_stmt_cache_clear(handle, (MYSQL *) (*connection));
 		mysql_close((MYSQL *) (*connection));
 		*connection = NULL;
 	}
@@ -1538,6 +1876,21 @@ int _mysql_cleanup(oph_ioserver_handler * handle)
 	return MYSQL_IO_SUCCESS;
 }
 
+//Get usage counters of the statement cache
+int _mysql_get_query_cache_stats(oph_ioserver_handler * handle, unsigned long long *hits, unsigned long long *misses)
+{
+	UNUSED(handle);
+
+	pthread_mutex_lock(&_mysql_stmt_cache_lock);
+	if (hits)
+		*hits = _mysql_stmt_cache_hits;
+	if (misses)
+		*misses = _mysql_stmt_cache_misses;
+	pthread_mutex_unlock(&_mysql_stmt_cache_lock);
+
+	return MYSQL_IO_SUCCESS;
+}
+
 //Get the result set
 int _mysql_get_result(oph_ioserver_handler * handle, void *connection, oph_ioserver_result ** result)
 {
@@ -1592,6 +1945,54 @@ int _mysql_get_result(oph_ioserver_handler * handle, void *connection, oph_ioser
 	return MYSQL_IO_SUCCESS;
 }
 
+//Get the result set without storing rows on client side
+int _mysql_get_result_stream(oph_ioserver_handler * handle, void *connection, oph_ioserver_result ** result)
+{
+	if (!connection || !result) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_LOG_MYSQL_NULL_INPUT_PARAM);
+		logging_server(LOG_ERROR, __FILE__, __LINE__, handle->server_type, OPH_IOSERVER_LOG_MYSQL_NULL_INPUT_PARAM);
+		return MYSQL_IO_NULL_PARAM;
+	}
+
+	if (*result == NULL) {
+		*result = (oph_ioserver_result *) malloc(sizeof(oph_ioserver_result));
+		if (!(*result)) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_LOG_MYSQL_MEMORY_ERROR);
+			logging_server(LOG_ERROR, __FILE__, __LINE__, handle->server_type, OPH_IOSERVER_LOG_MYSQL_MEMORY_ERROR);
+			return MYSQL_IO_MEMORY_ERROR;
+		}
+		(*result)->result_set = NULL;
+		(*result)->max_field_length = NULL;
+		(*result)->current_row = NULL;
+	} else {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_LOG_MYSQL_NOT_NULL_INPUT_PARAM);
+		logging_server(LOG_ERROR, __FILE__, __LINE__, handle->server_type, OPH_IOSERVER_LOG_MYSQL_NOT_NULL_INPUT_PARAM);
+		return MYSQL_IO_ERROR;
+	}
+
+	if (!((*result)->result_set = (void *) mysql_use_result((MYSQL *) connection)) && mysql_errno((MYSQL *) connection)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_LOG_MYSQL_STORE_ERROR, mysql_error((MYSQL *) connection));
+		logging_server(LOG_ERROR, __FILE__, __LINE__, handle->server_type, OPH_IOSERVER_LOG_MYSQL_STORE_ERROR, mysql_error((MYSQL *) connection));
+		_mysql_free_result(handle, *result);
+		return MYSQL_IO_ERROR;
+	}
+	//Rows are read from the connection while they are fetched, so their number and lengths are unknown
+	(*result)->num_rows = 0;
+	(*result)->num_fields = mysql_num_fields((*result)->result_set);
+	(*result)->current_row = (oph_ioserver_row *) malloc(sizeof(oph_ioserver_row));
+	(*result)->max_field_length = (unsigned long long *) calloc((*result)->num_fields, sizeof(unsigned long long));
+	if (!(*result)->current_row || !(*result)->max_field_length) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_LOG_MYSQL_MEMORY_ERROR);
+		logging_server(LOG_ERROR, __FILE__, __LINE__, handle->server_type, OPH_IOSERVER_LOG_MYSQL_MEMORY_ERROR);
+		_mysql_free_result(handle, *result);
+		return MYSQL_IO_MEMORY_ERROR;
+	}
+	(*result)->current_row->field_lengths = NULL;
+	(*result)->current_row->row = NULL;
+
+	return MYSQL_IO_SUCCESS;
+}
+
 //Get the next row
 int _mysql_fetch_row(oph_ioserver_handler * handle, oph_ioserver_result * result, oph_ioserver_row ** current_row)
 {
@@ -1609,6 +2010,13 @@ int _mysql_fetch_row(oph_ioserver_handler * handle, oph_ioserver_result * result
 	}
 
 	MYSQL_ROW mysql_row = mysql_fetch_row((MYSQL_RES *) (result->result_set));
+	//In case of streamed result sets (num_rows is 0) a NULL row could be due to a connection error
+	if (!mysql_row && !result->num_rows && handle->connection && mysql_errno((MYSQL *) handle->connection)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_LOG_MYSQL_FETCH_ERROR, mysql_error((MYSQL *) handle->connection));
+		logging_server(LOG_ERROR, __FILE__, __LINE__, handle->server_type, OPH_IOSERVER_LOG_MYSQL_FETCH_ERROR, mysql_error((MYSQL *) handle->connection));
+		//The result set is released by the caller
+		return MYSQL_IO_ERROR;
+	}
 	result->current_row->row = (char **) mysql_row;
 	result->current_row->field_lengths = mysql_fetch_lengths((MYSQL_RES *) (result->result_set));
 
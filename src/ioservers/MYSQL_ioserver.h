@@ -39,8 +39,13 @@ typedef bool my_bool;
 #define MYSQL_IO_QUERY_SELECT             "SELECT"
 #define MYSQL_IO_QUERY_INSERT             "INSERT INTO %s"
 #define MYSQL_IO_QUERY_CREATE_FRAG        "CREATE TABLE %s (id_dim integer, measure longblob) ENGINE=MyISAM DEFAULT CHARSET=latin1"
+#define MYSQL_IO_QUERY_CREATE_FRAG_LINK   "CREATE TABLE %s (id_dim integer, measure longblob) ENGINE=FEDERATED DEFAULT CHARSET=latin1"
+#define MYSQL_IO_QUERY_CREATE_SERVER      "CREATE SERVER %s FOREIGN DATA WRAPPER mysql OPTIONS ("
+#define MYSQL_IO_QUERY_DROP_SERVER        "DROP SERVER IF EXISTS %s"
 #define MYSQL_IO_QUERY_FUNC               "CALL %s ("
 #define MYSQL_IO_QUERY_DROP_FRAG          "DROP TABLE IF EXISTS %s"
+#define MYSQL_IO_QUERY_CREATE_FRAG_VIEW   "CREATE VIEW %s AS SELECT"
+#define MYSQL_IO_QUERY_DROP_FRAG_VIEW     "DROP VIEW IF EXISTS %s"
 #define MYSQL_IO_QUERY_CREATE_DB          "CREATE DATABASE IF NOT EXISTS %s DEFAULT CHARACTER SET latin1 COLLATE latin1_swedish_ci"
 #define MYSQL_IO_QUERY_DROP_DB            "DROP DATABASE IF EXISTS %s"
 
@@ -56,22 +61,77 @@ typedef bool my_bool;
 #define MYSQL_IO_QUERY_WHERE  " WHERE %s"
 #define MYSQL_IO_QUERY_FROM   " FROM %s"
 #define MYSQL_IO_QUERY_AS     " AS %s"
+#define MYSQL_IO_QUERY_CONNECTION " CONNECTION='%s'"
+#define MYSQL_IO_QUERY_SERVER_HOST "HOST '%s'"
+#define MYSQL_IO_QUERY_SERVER_PORT ", PORT %s"
+#define MYSQL_IO_QUERY_SERVER_USER ", USER '%s'"
+#define MYSQL_IO_QUERY_SERVER_PASSWORD ", PASSWORD '%s'"
+#define MYSQL_IO_QUERY_SERVER_DB ", DATABASE '%s')"
 #define MYSQL_IO_QUERY_ORDER  " ORDER BY %s"
 #define MYSQL_IO_QUERY_GROUP  " GROUP BY %s"
 #define MYSQL_IO_QUERY_VALUES " VALUES ("
 #define MYSQL_IO_QUERY_VALUES_MULTI " VALUES "
 #define MYSQL_IO_QUERY_CLOSE_BRACKET  " )"
 #define MYSQL_IO_QUERY_OPEN_BRACKET   " ("
+//Maximum number of prepared statements cached for each connection
+#define MYSQL_IO_STMT_CACHE_SIZE	32
+
 /**
  * \brief        Struct to contain reference to prepared statement structures
  * \param stmt   Pointer to mysql statement struct
  * \param bind   Pointer to mysql bind struct
+ * \param entry  Pointer to the cache entry owning the statement (NULL if the statement is not cached)
  */
 typedef struct {
 	MYSQL_STMT *stmt;
 	MYSQL_BIND *bind;
+	struct _mysql_stmt_cache_entry *entry;
 } _mysql_query_struct;
 
+/**
+ * \brief             Struct of a prepared statement cached for a connection
+ * \param operation   Submission string used to build the statement
+ * \param hash        Hash of the submission string
+ * \param query       Statement and bind buffers reused by every execution
+ * \param param_count Number of parameters of the statement
+ * \param in_use      Flag set while the statement is used by a query
+ * \param valid       Flag reset in case the statement has to be prepared again (e.g. after an execution error)
+ * \param cache       Pointer to the cache of the connection (NULL if the connection has been closed)
+ * \param prev        Previous (more recently used) entry
+ * \param next        Next (less recently used) entry
+ */
+typedef struct _mysql_stmt_cache_entry {
+	char *operation;
+	unsigned long long hash;
+	_mysql_query_struct query;
+	int param_count;
+	char in_use;
+	char valid;
+	struct _mysql_stmt_cache *cache;
+	struct _mysql_stmt_cache_entry *prev;
+	struct _mysql_stmt_cache_entry *next;
+} _mysql_stmt_cache_entry;
+
+/**
+ * \brief             Struct of the LRU cache of prepared statements of a connection
+ * \param connection  Pointer to the connection
+ * \param head        Most recently used entry
+ * \param tail        Least recently used entry
+ * \param size        Number of entries
+ * \param hits        Number of statements reused
+ * \param misses      Number of statements prepared
+ * \param next        Cache of the next connection
+ */
+typedef struct _mysql_stmt_cache {
+	MYSQL *connection;
+	_mysql_stmt_cache_entry *head;
+	_mysql_stmt_cache_entry *tail;
+	unsigned int size;
+	unsigned long long hits;
+	unsigned long long misses;
+	struct _mysql_stmt_cache *next;
+} _mysql_stmt_cache;
+
 
 /**
  * \brief               Function to initialize data store server library.
@@ -119,6 +179,27 @@ int _mysql_execute_query(oph_ioserver_handler * handle, void *connection, oph_io
  */
 int _mysql_setup_query(oph_ioserver_handler * handle, void *connection, const char *operation, unsigned long long tot_run, oph_ioserver_query_arg ** args, oph_ioserver_query ** query);
 
+/**
+ * \brief               Function to setup the query structure with given SQL statement and array argument. The submission string parser is bypassed.
+ * \param handle        Dynamic server plugin handle
+ * \param connection    Pointer to server-specific connection structure
+ * \param operation     String with SQL statement to be performed
+ * \param tot_run       Total number of runs the given operation will be executed
+ * \param args          Array of arguments to be binded to the query (can be NULL)
+ * \param query         Pointer to query to be built
+ * \return              0 if successfull, non-0 otherwise
+ */
+int _mysql_setup_native_query(oph_ioserver_handler * handle, void *connection, const char *operation, unsigned long long tot_run, oph_ioserver_query_arg ** args, oph_ioserver_query ** query);
+
+/**
+ * \brief               Function to translate a submission string into the equivalent SQL statement
+ * \param handle        Dynamic server plugin handle
+ * \param operation     Submission string to be translated
+ * \param translated    Pointer to the SQL statement (it has to be freed)
+ * \return              0 if successfull, non-0 otherwise
+ */
+int _mysql_translate_query(oph_ioserver_handler * handle, const char *operation, char **translated);
+
 /**
  * \brief               Function to release resources allocated for query
  * \param handle        Dynamic server plugin handle
@@ -151,6 +232,15 @@ int _mysql_cleanup(oph_ioserver_handler * handle);
  */
 int _mysql_get_result(oph_ioserver_handler * handle, void *connection, oph_ioserver_result ** result);
 
+/**
+ * \brief               Function to get result set after executing a query. Rows are retrieved from the server while they are fetched, so the number of rows and the maximum field lengths are set to 0.
+ * \param handle        Dynamic server plugin handle
+ * \param connection    Pointer to server-specific connection structure
+ * \param result        Pointer to the result set structure to be filled
+ * \return              0 if successfull, non-0 otherwise
+ */
+int _mysql_get_result_stream(oph_ioserver_handler * handle, void *connection, oph_ioserver_result ** result);
+
 /**
  * \brief               Function to fetch the next row in a result set.
  * \param handle        Dynamic server plugin handle
@@ -160,6 +250,15 @@ int _mysql_get_result(oph_ioserver_handler * handle, void *connection, oph_ioser
  */
 int _mysql_fetch_row(oph_ioserver_handler * handle, oph_ioserver_result * result, oph_ioserver_row ** current_row);
 
+/**
+ * \brief               Function to get the usage counters of the cache of prepared statements, summed over all the connections.
+ * \param handle        Dynamic server plugin handle
+ * \param hits          Pointer to the number of statements reused (can be NULL)
+ * \param misses        Pointer to the number of statements prepared (can be NULL)
+ * \return              0 if successfull, non-0 otherwise
+ */
+int _mysql_get_query_cache_stats(oph_ioserver_handler * handle, unsigned long long *hits, unsigned long long *misses);
+
 /**
  * \brief               Function to free the allocated result set.
  * \param handle        Dynamic server plugin handle
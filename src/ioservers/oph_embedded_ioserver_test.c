@@ -0,0 +1,194 @@
+/*
+    Ophidia Analytics Framework
+    Copyright (C) 2012-2024 CMCC Foundation
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#define _GNU_SOURCE
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "EMBEDDED_ioserver.h"
+#include "debug.h"
+
+#define OPH_EMBEDDED_TEST_TEMPLATE "/tmp/oph_embedded_test_XXXXXX"
+#define OPH_EMBEDDED_TEST_DB "oph_test"
+#define OPH_EMBEDDED_TEST_ROWS 50
+#define OPH_EMBEDDED_TEST_MEASURE_LEN 24
+#define OPH_EMBEDDED_TEST_FIRST 10
+#define OPH_EMBEDDED_TEST_LAST 19
+
+#define OPH_EMBEDDED_TEST_CHECK(condition, message) if (!(condition)) { fprintf(stderr, "FAILED: %s\n", message); return 1; }
+
+int msglevel = LOG_ERROR;
+
+char oph_embedded_test_type[] = "embedded_memory";
+oph_ioserver_handler oph_embedded_test_handle = { oph_embedded_test_type, NULL, NULL, NULL, 0, NULL, NULL, NULL };
+void *oph_embedded_test_connection = NULL;
+char oph_embedded_test_root[] = OPH_EMBEDDED_TEST_TEMPLATE;
+
+//Measures are binary and include zero bytes, so that lengths are checked too
+static void _oph_embedded_test_measure(long long id, char *measure)
+{
+	int i;
+	for (i = 0; i < OPH_EMBEDDED_TEST_MEASURE_LEN; i++)
+		measure[i] = (char) ((id * 7 + i) % 5 ? id + i : 0);
+}
+
+static int _oph_embedded_test_run(const char *operation, oph_ioserver_query_arg ** args, unsigned long long tot_run, oph_ioserver_result ** result)
+{
+	oph_ioserver_query *query = NULL;
+	unsigned long long i;
+
+	if (_embedded_setup_query(&oph_embedded_test_handle, oph_embedded_test_connection, operation, tot_run, args, &query))
+		return 1;
+	for (i = 0; i < tot_run; i++) {
+		//Arguments are updated by the caller before each run
+		if (args && (i > 0)) {
+			long long *id = (long long *) args[0]->arg;
+			(*id)++;
+			_oph_embedded_test_measure(*id, (char *) args[1]->arg);
+		}
+		if (_embedded_execute_query(&oph_embedded_test_handle, oph_embedded_test_connection, query)) {
+			_embedded_free_query(&oph_embedded_test_handle, query);
+			return 1;
+		}
+	}
+	if (result && _embedded_get_result(&oph_embedded_test_handle, oph_embedded_test_connection, result)) {
+		_embedded_free_query(&oph_embedded_test_handle, query);
+		return 1;
+	}
+
+	return _embedded_free_query(&oph_embedded_test_handle, query);
+}
+
+//Check that rows with id_dim from first to last are returned in order with the expected measures
+static int _oph_embedded_test_check_rows(const char *operation, long long first, long long last)
+{
+	oph_ioserver_result *result = NULL;
+	oph_ioserver_row *row = NULL;
+	char measure[OPH_EMBEDDED_TEST_MEASURE_LEN], message[OPH_EMBEDDED_TEST_MEASURE_LEN * 4];
+	long long id;
+
+	snprintf(message, sizeof(message), "unable to read rows %lld-%lld", first, last);
+	OPH_EMBEDDED_TEST_CHECK(!_oph_embedded_test_run(operation, NULL, 1, &result), message);
+	OPH_EMBEDDED_TEST_CHECK(result->num_rows == (unsigned long long) (last - first + 1), "wrong number of rows");
+	OPH_EMBEDDED_TEST_CHECK(result->num_fields == 2, "wrong number of fields");
+
+	for (id = first; id <= last; id++) {
+		if (_embedded_fetch_row(&oph_embedded_test_handle, result, &row) || !row->row) {
+			_embedded_free_result(&oph_embedded_test_handle, result);
+			OPH_EMBEDDED_TEST_CHECK(0, "unable to fetch a row");
+		}
+		_oph_embedded_test_measure(id, measure);
+		if ((strtoll(row->row[0], NULL, 10) != id) || (row->field_lengths[1] != OPH_EMBEDDED_TEST_MEASURE_LEN) || memcmp(row->row[1], measure, OPH_EMBEDDED_TEST_MEASURE_LEN)) {
+			_embedded_free_result(&oph_embedded_test_handle, result);
+			snprintf(message, sizeof(message), "wrong row %lld", id);
+			OPH_EMBEDDED_TEST_CHECK(0, message);
+		}
+	}
+	_embedded_free_result(&oph_embedded_test_handle, result);
+
+	return 0;
+}
+
+static int _oph_embedded_test_open()
+{
+	oph_ioserver_params params;
+	memset(&params, 0, sizeof(oph_ioserver_params));
+
+	OPH_EMBEDDED_TEST_CHECK(!_embedded_setup(&oph_embedded_test_handle), "unable to setup the plugin");
+	OPH_EMBEDDED_TEST_CHECK(!_embedded_connect(&oph_embedded_test_handle, &params, &oph_embedded_test_connection), "unable to connect");
+
+	return 0;
+}
+
+static int _oph_embedded_test_close()
+{
+	OPH_EMBEDDED_TEST_CHECK(!_embedded_close(&oph_embedded_test_handle, &oph_embedded_test_connection), "unable to close the connection");
+	OPH_EMBEDDED_TEST_CHECK(!_embedded_cleanup(&oph_embedded_test_handle), "unable to cleanup the plugin");
+
+	return 0;
+}
+
+static int _oph_embedded_test()
+{
+	char path[EMBEDDED_IO_PATH_LEN], measure[OPH_EMBEDDED_TEST_MEASURE_LEN];
+	struct stat st;
+	long long id = 1;
+
+	oph_ioserver_query_arg id_arg = { OPH_IOSERVER_TYPE_LONGLONG, sizeof(long long), 0, &id };
+	oph_ioserver_query_arg measure_arg = { OPH_IOSERVER_TYPE_BLOB, OPH_EMBEDDED_TEST_MEASURE_LEN, 0, measure };
+	oph_ioserver_query_arg *args[] = { &id_arg, &measure_arg, NULL };
+
+	if (_oph_embedded_test_open())
+		return 1;
+
+	//Create a database with a fragment
+	OPH_EMBEDDED_TEST_CHECK(!_oph_embedded_test_run("operation=create_database;db_name=" OPH_EMBEDDED_TEST_DB ";", NULL, 1, NULL), "unable to create the database");
+	OPH_EMBEDDED_TEST_CHECK(!_embedded_use_db(&oph_embedded_test_handle, OPH_EMBEDDED_TEST_DB, oph_embedded_test_connection), "unable to use the database");
+	OPH_EMBEDDED_TEST_CHECK(!_oph_embedded_test_run("operation=create_frag;frag_name=frag1;column_name=id_dim|measure;column_type=long|blob;", NULL, 1, NULL), "unable to create the fragment");
+
+	//Insert rows with binary arguments: the fragment is saved once the query is completed
+	_oph_embedded_test_measure(id, measure);
+	OPH_EMBEDDED_TEST_CHECK(!_oph_embedded_test_run("operation=insert;frag_name=frag1;field=id_dim|measure;value=?|?;", args, OPH_EMBEDDED_TEST_ROWS, NULL), "unable to insert rows");
+	snprintf(path, EMBEDDED_IO_PATH_LEN, "%s/%s/frag1", oph_embedded_test_root, OPH_EMBEDDED_TEST_DB);
+	OPH_EMBEDDED_TEST_CHECK(!stat(path, &st) && (st.st_size > OPH_EMBEDDED_TEST_ROWS * OPH_EMBEDDED_TEST_MEASURE_LEN), "inserted rows have not been saved");
+
+	//Read a range of rows
+	if (_oph_embedded_test_check_rows("operation=select;field=id_dim|measure;from=frag1;where=id_dim BETWEEN 10 AND 19;order=id_dim;", OPH_EMBEDDED_TEST_FIRST, OPH_EMBEDDED_TEST_LAST))
+		return 1;
+
+	//Create a fragment from a selection and drop the source
+	OPH_EMBEDDED_TEST_CHECK(!_oph_embedded_test_run("operation=create_frag_select;frag_name=frag2;field=id_dim|measure;from=frag1;where=id_dim>=10 AND id_dim<=19;", NULL, 1, NULL),
+				"unable to create a fragment from a selection");
+	OPH_EMBEDDED_TEST_CHECK(!_oph_embedded_test_run("operation=drop_frag;frag_name=frag1;", NULL, 1, NULL), "unable to drop the fragment");
+	OPH_EMBEDDED_TEST_CHECK(stat(path, &st), "dropped fragment is still on disk");
+	OPH_EMBEDDED_TEST_CHECK(_oph_embedded_test_run("operation=select;field=id_dim;from=frag1;", NULL, 1, NULL), "dropped fragment can be read");
+
+	//Data have to be read from disk after the plugin is restarted
+	if (_oph_embedded_test_close() || _oph_embedded_test_open())
+		return 1;
+	OPH_EMBEDDED_TEST_CHECK(!_embedded_use_db(&oph_embedded_test_handle, OPH_EMBEDDED_TEST_DB, oph_embedded_test_connection), "unable to use the database after restart");
+	if (_oph_embedded_test_check_rows("operation=select;field=id_dim|measure;from=frag2;order=id_dim;", OPH_EMBEDDED_TEST_FIRST, OPH_EMBEDDED_TEST_LAST))
+		return 1;
+	OPH_EMBEDDED_TEST_CHECK(_oph_embedded_test_run("operation=select;field=id_dim;from=frag1;", NULL, 1, NULL), "dropped fragment can be read after restart");
+
+	OPH_EMBEDDED_TEST_CHECK(!_oph_embedded_test_run("operation=drop_database;db_name=" OPH_EMBEDDED_TEST_DB ";", NULL, 1, NULL), "unable to drop the database");
+
+	return _oph_embedded_test_close();
+}
+
+int main()
+{
+	//Use a private storage and no primitive
+	if (!mkdtemp(oph_embedded_test_root)) {
+		fprintf(stderr, "Unable to create directory '%s'\n", oph_embedded_test_root);
+		return 1;
+	}
+	setenv(EMBEDDED_IO_PATH_ENV, oph_embedded_test_root, 1);
+	setenv(EMBEDDED_IO_PRIMITIVES_ENV, "/dev/null", 1);
+
+	int res = _oph_embedded_test();
+	rmdir(oph_embedded_test_root);
+	if (!res)
+		fprintf(stdout, "Embedded I/O server round trip passed\n");
+
+	return res;
+}
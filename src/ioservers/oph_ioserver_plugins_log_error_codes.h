@@ -29,6 +29,7 @@
 #define OPH_IOSERVER_LOG_MYSQL_EXEC_QUERY_ERROR "MySQL execute query error: %s\n"
 #define OPH_IOSERVER_LOG_MYSQL_NOT_NULL_INPUT_PARAM   "Not null input parameter\n"
 #define OPH_IOSERVER_LOG_MYSQL_STORE_ERROR      "Store result error: %s\n"
+#define OPH_IOSERVER_LOG_MYSQL_FETCH_ERROR      "Fetch row error: %s\n"
 #define OPH_IOSERVER_LOG_MYSQL_MEMORY_ERROR	"Memory allocation error\n"
 #define OPH_IOSERVER_LOG_MYSQL_EXEC_QUERY_TYPE_ERROR "MySQL query type not defined\n"
 #define OPH_IOSERVER_LOG_MYSQL_STMT_ERROR       "MySQL statement error: %s\n"
@@ -48,6 +49,7 @@
 #define OPH_IOSERVER_LOG_MYSQL_BAD_MULTI_ARG    "Bad multi-value argument '%s'\n"
 #define OPH_IOSERVER_LOG_MYSQL_MULTI_ARG_DONT_CORRESPOND  "Multi-value argument numbers do not correspond'\n"
 #define OPH_IOSERVER_LOG_MYSQL_MULTI_ARG_TOO_BIG "Multi-value argument number too big\n"
+#define OPH_IOSERVER_LOG_MYSQL_STMT_CACHE_STATS "Statement cache: %llu hits, %llu misses\n"
 
 #define OPH_IOSERVER_LOG_OPHIDIAIO_NULL_INPUT_PARAM OPH_IOSERVER_LOG_MYSQL_NULL_INPUT_PARAM
 #define OPH_IOSERVER_LOG_OPHIDIAIO_CONN_ERROR       "OPHIDIAIO connection error\n"
@@ -61,4 +63,34 @@
 #define OPH_IOSERVER_LOG_OPHIDIAIO_FETCH_ROW_ERROR  "OPHIDIAIO fetch row error\n"
 #define OPH_IOSERVER_LOG_OPHIDIAIO_EXEC_QUERY_TYPE_ERROR "MySQL query type not defined\n"
 
+/*EMBEDDED IOSERVER LOG ERRORS*/
+#define OPH_IOSERVER_LOG_EMBEDDED_NULL_INPUT_PARAM OPH_IOSERVER_LOG_MYSQL_NULL_INPUT_PARAM
+#define OPH_IOSERVER_LOG_EMBEDDED_NOT_NULL_INPUT_PARAM OPH_IOSERVER_LOG_MYSQL_NOT_NULL_INPUT_PARAM
+#define OPH_IOSERVER_LOG_EMBEDDED_MEMORY_ERROR	"Memory allocation error\n"
+#define OPH_IOSERVER_LOG_EMBEDDED_SETUP_ERROR   "EMBEDDED setup error: %s\n"
+#define OPH_IOSERVER_LOG_EMBEDDED_USE_DB_ERROR  "EMBEDDED use DB error: %s\n"
+#define OPH_IOSERVER_LOG_EMBEDDED_NO_DB         "No database selected\n"
+#define OPH_IOSERVER_LOG_EMBEDDED_QUERY_NOT_VALID OPH_IOSERVER_LOG_MYSQL_QUERY_NOT_VALID
+#define OPH_IOSERVER_LOG_EMBEDDED_ARG_COUNT_ERROR OPH_IOSERVER_LOG_MYSQL_ARG_COUNT_ERROR
+#define OPH_IOSERVER_LOG_EMBEDDED_HASHTBL_ERROR OPH_IOSERVER_LOG_MYSQL_HASHTBL_ERROR
+#define OPH_IOSERVER_LOG_EMBEDDED_LOAD_ARGS_ERROR OPH_IOSERVER_LOG_MYSQL_LOAD_ARGS_ERROR
+#define OPH_IOSERVER_LOG_EMBEDDED_MISSING_ARG   OPH_IOSERVER_LOG_MYSQL_MISSING_ARG
+#define OPH_IOSERVER_LOG_EMBEDDED_BAD_MULTI_ARG OPH_IOSERVER_LOG_MYSQL_BAD_MULTI_ARG
+#define OPH_IOSERVER_LOG_EMBEDDED_MULTI_ARG_DONT_CORRESPOND OPH_IOSERVER_LOG_MYSQL_MULTI_ARG_DONT_CORRESPOND
+#define OPH_IOSERVER_LOG_EMBEDDED_UNKNOWN_KEYWORD OPH_IOSERVER_LOG_MYSQL_UNKNOWN_KEYWORD
+#define OPH_IOSERVER_LOG_EMBEDDED_UNKNOWN_OPERATION OPH_IOSERVER_LOG_MYSQL_UNKNOWN_OPERATION
+#define OPH_IOSERVER_LOG_EMBEDDED_UNSUPPORTED_OPERATION "Operation '%s' is not supported by EMBEDDED server\n"
+#define OPH_IOSERVER_LOG_EMBEDDED_SYNTAX_ERROR  "Syntax error in '%s' near '%s'\n"
+#define OPH_IOSERVER_LOG_EMBEDDED_UNKNOWN_PRIMITIVE "Unknown primitive '%s'\n"
+#define OPH_IOSERVER_LOG_EMBEDDED_PRIMITIVE_ERROR "Primitive '%s' error: %s\n"
+#define OPH_IOSERVER_LOG_EMBEDDED_UNKNOWN_COLUMN "Unknown column '%s'\n"
+#define OPH_IOSERVER_LOG_EMBEDDED_TABLE_NOT_FOUND "Fragment '%s' does not exist\n"
+#define OPH_IOSERVER_LOG_EMBEDDED_TABLE_EXISTS  "Fragment '%s' already exists\n"
+#define OPH_IOSERVER_LOG_EMBEDDED_COLUMN_COUNT_ERROR "Column count of fragment '%s' does not match value count\n"
+#define OPH_IOSERVER_LOG_EMBEDDED_STORAGE_ERROR "EMBEDDED storage error on '%s': %s\n"
+#define OPH_IOSERVER_LOG_EMBEDDED_BIND_ERROR    "Argument %d is not bound\n"
+#define OPH_IOSERVER_LOG_EMBEDDED_EXEC_QUERY_ERROR "EMBEDDED execute query error\n"
+#define OPH_IOSERVER_LOG_EMBEDDED_GET_RESULT_ERROR "EMBEDDED get result error\n"
+#define OPH_IOSERVER_LOG_EMBEDDED_CACHE_STATS   "EMBEDDED fragment cache: %d fragments, %zu bytes\n"
+
 #endif				//__OPH_IOSERVER_LOG_ERROR_CODES_H
@@ -30,11 +30,12 @@
 #include "oph_input_parameters.h"
 #include "oph_json_library.h"
 #include "oph_pid_library.h"
+#include "oph_trace_library.h"
 
 #include "debug.h"
 #include <mpi.h>
 
-#if defined(OPH_TIME_DEBUG_1) || defined(OPH_TIME_DEBUG_2) || defined(BENCHMARK)
+#ifdef BENCHMARK
 #include "clients/taketime.h"
 #endif
 
@@ -43,6 +44,20 @@
 
 extern int msglevel;
 
+char oph_af_trace_file[OPH_COMMON_BUFFER_LEN];
+
+//Release the resources shared by all the tasks, unless the process is resident
+void _oph_af_release_env()
+{
+	oph_odb_cache_clear();
+	if (oph_is_resident_mode())
+		return;
+	oph_tp_clear_cache();
+	oph_odb_pool_clear();
+	mysql_library_end();
+	oph_pid_free();
+}
+
 int oph_save_json_response(const char *output_json, const char *output_path, const char *output_name)
 {
 	if (!output_json || !output_path || !output_name)
@@ -146,6 +161,8 @@ int oph_af_write_json(oph_json * oper_json, char **jstring, char *backtrace, con
 
 	char filename[OPH_COMMON_BUFFER_LEN];
 	snprintf(filename, OPH_COMMON_BUFFER_LEN, OPH_FRAMEWORK_JSON_PATH, oph_pid_path()? oph_pid_path() : OPH_PREFIX_CLUSTER, session_code, marker_code);
+	if (oph_trace_is_enabled())
+		snprintf(oph_af_trace_file, OPH_COMMON_BUFFER_LEN, OPH_FRAMEWORK_TRACE_PATH, oph_pid_path()? oph_pid_path() : OPH_PREFIX_CLUSTER, session_code, marker_code);
 	if (_oph_json_to_json_file(oper_json, filename, jstring)) {
 		oph_json_free(oper_json);
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "JSON file creation failed.\n");
@@ -263,15 +280,11 @@ int _oph_af_execute_framework(oph_operator_struct * handle, char *task_string, i
 	*notify_sessionid = 0;
 #endif
 
-#ifdef OPH_TIME_DEBUG_1
-	/*Partial Exec time evaluate */ struct timeval stime, etime, ttime;
-
-	if (task_rank == 0)
-		gettimeofday(&stime, NULL);
-#elif OPH_TIME_DEBUG_2
-	/*Partial Exec time evaluate */ struct timeval stime, etime, ttime;
-	gettimeofday(&stime, NULL);
-#endif
+	//Phases are traced for each process
+	oph_trace_span phase;
+	*oph_af_trace_file = 0;
+	oph_trace_init(MPI_COMM_WORLD);
+	oph_trace_begin(&phase);
 
 	char *backtrace = NULL;
 	if (!task_rank)
@@ -414,8 +427,7 @@ int _oph_af_execute_framework(oph_operator_struct * handle, char *task_string, i
 /* gSOAP notification end */
 #endif
 		}
-		mysql_library_end();
-		oph_pid_free();
+		_oph_af_release_env();
 		return OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
 	}
 #ifndef OPH_STANDALONE_MODE
@@ -455,8 +467,7 @@ int _oph_af_execute_framework(oph_operator_struct * handle, char *task_string, i
 			}
 /* gSOAP notification end */
 		}
-		mysql_library_end();
-		oph_pid_free();
+		_oph_af_release_env();
 		return OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
 	}
 	hashtbl_insert(task_tbl, OPH_ARG_WORKFLOWID, tmp_value);
@@ -491,8 +502,7 @@ int _oph_af_execute_framework(oph_operator_struct * handle, char *task_string, i
 			}
 /* gSOAP notification end */
 		}
-		mysql_library_end();
-		oph_pid_free();
+		_oph_af_release_env();
 		return OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
 	}
 	hashtbl_insert(task_tbl, OPH_ARG_MARKERID, tmp_value);
@@ -528,8 +538,7 @@ int _oph_af_execute_framework(oph_operator_struct * handle, char *task_string, i
 /* gSOAP notification end */
 #endif
 		}
-		mysql_library_end();
-		oph_pid_free();
+		_oph_af_release_env();
 		return OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
 	}
 	hashtbl_insert(task_tbl, OPH_ARG_USERNAME, tmp_value);
@@ -565,8 +574,7 @@ int _oph_af_execute_framework(oph_operator_struct * handle, char *task_string, i
 /* gSOAP notification end */
 #endif
 		}
-		mysql_library_end();
-		oph_pid_free();
+		_oph_af_release_env();
 		return OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
 	}
 	hashtbl_insert(task_tbl, OPH_ARG_USERROLE, tmp_value);
@@ -600,8 +608,7 @@ int _oph_af_execute_framework(oph_operator_struct * handle, char *task_string, i
 				oph_soap_cleanup(&soap, &data);
 			}
 /* gSOAP notification end */
-			mysql_library_end();
-			oph_pid_free();
+			_oph_af_release_env();
 			return OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
 		}
 		if (oph_json_add_source_detail(oper_json, "Session Code", hashtbl_get(task_tbl, OPH_ARG_SESSIONID))) {
@@ -630,8 +637,7 @@ int _oph_af_execute_framework(oph_operator_struct * handle, char *task_string, i
 				oph_soap_cleanup(&soap, &data);
 			}
 /* gSOAP notification end */
-			mysql_library_end();
-			oph_pid_free();
+			_oph_af_release_env();
 			return OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
 		}
 
@@ -663,8 +669,7 @@ int _oph_af_execute_framework(oph_operator_struct * handle, char *task_string, i
 				oph_soap_cleanup(&soap, &data);
 			}
 /* gSOAP notification end */
-			mysql_library_end();
-			oph_pid_free();
+			_oph_af_release_env();
 			return OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
 		}
 
@@ -695,8 +700,7 @@ int _oph_af_execute_framework(oph_operator_struct * handle, char *task_string, i
 				oph_soap_cleanup(&soap, &data);
 			}
 /* gSOAP notification end */
-			mysql_library_end();
-			oph_pid_free();
+			_oph_af_release_env();
 			return OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
 		}
 
@@ -728,8 +732,7 @@ int _oph_af_execute_framework(oph_operator_struct * handle, char *task_string, i
 				oph_soap_cleanup(&soap, &data);
 			}
 /* gSOAP notification end */
-			mysql_library_end();
-			oph_pid_free();
+			_oph_af_release_env();
 			return OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
 		}
 		if (oph_json_add_consumer(oper_json, hashtbl_get(task_tbl, OPH_ARG_USERNAME))) {
@@ -758,8 +761,7 @@ int _oph_af_execute_framework(oph_operator_struct * handle, char *task_string, i
 				oph_soap_cleanup(&soap, &data);
 			}
 /* gSOAP notification end */
-			mysql_library_end();
-			oph_pid_free();
+			_oph_af_release_env();
 			return OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
 		}
 		//Init JSON END
@@ -797,8 +799,7 @@ int _oph_af_execute_framework(oph_operator_struct * handle, char *task_string, i
 			}
 /* gSOAP notification end */
 #endif
-			mysql_library_end();
-			oph_pid_free();
+			_oph_af_release_env();
 			return OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
 		}
 		if (oph_odb_connect_to_ophidiadb(&oDB)) {
@@ -832,8 +833,7 @@ int _oph_af_execute_framework(oph_operator_struct * handle, char *task_string, i
 			}
 /* gSOAP notification end */
 #endif
-			mysql_library_end();
-			oph_pid_free();
+			_oph_af_release_env();
 			return OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
 		}
 
@@ -860,8 +860,7 @@ int _oph_af_execute_framework(oph_operator_struct * handle, char *task_string, i
 				oph_odb_free_ophidiadb(&oDB);
 				hashtbl_destroy(task_tbl);
 				snprintf(error_message, OPH_COMMON_BUFFER_LEN, "Unable to create standalone folder.\n");
-				mysql_library_end();
-				oph_pid_free();
+				_oph_af_release_env();
 				return OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
 			}
 		}
@@ -898,8 +897,7 @@ int _oph_af_execute_framework(oph_operator_struct * handle, char *task_string, i
 				}
 /* gSOAP notification end */
 #endif
-				mysql_library_end();
-				oph_pid_free();
+				_oph_af_release_env();
 				return OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
 			}
 			//Insert idjob in hash table
@@ -933,23 +931,8 @@ int _oph_af_execute_framework(oph_operator_struct * handle, char *task_string, i
 	if (!task_rank)
 		handle->operator_json = oper_json;
 
-#ifdef OPH_TIME_DEBUG_1
-	MPI_Barrier(MPI_COMM_WORLD);
-	if (task_rank == 0) {
-		gettimeofday(&etime, NULL);
-		timeval_subtract(&ttime, &etime, &stime);
-		printf("Proc %d: Load task:\t Time %d,%06d sec\n", task_rank, (int) ttime.tv_sec, (int) ttime.tv_usec);
-	}
-
-	if (task_rank == 0)
-		gettimeofday(&stime, NULL);
-#elif OPH_TIME_DEBUG_2
-	gettimeofday(&etime, NULL);
-	timeval_subtract(&ttime, &etime, &stime);
-	printf("Proc %d: Load task:\t Time %d,%06d sec\n", task_rank, (int) ttime.tv_sec, (int) ttime.tv_usec);
-
-	gettimeofday(&stime, NULL);
-#endif
+	oph_trace_end(&phase, OPH_TRACE_CATEGORY_PHASE, "Load task", NULL);
+	oph_trace_begin(&phase);
 
 	if (!task_rank && idjob)
 		oph_odb_job_set_job_status(&oDB, idjob, OPH_ODB_JOB_STATUS_SET_ENV);
@@ -995,29 +978,13 @@ int _oph_af_execute_framework(oph_operator_struct * handle, char *task_string, i
 /* gSOAP notification end */
 #endif
 		}
-		mysql_library_end();
-		oph_pid_free();
+		_oph_af_release_env();
 		return OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
 	}
 	hashtbl_destroy(task_tbl);
 
-#ifdef OPH_TIME_DEBUG_1
-	MPI_Barrier(MPI_COMM_WORLD);
-	if (task_rank == 0) {
-		gettimeofday(&etime, NULL);
-		timeval_subtract(&ttime, &etime, &stime);
-		printf("Proc %d: Set env:\t Time %d,%06d sec\n", task_rank, (int) ttime.tv_sec, (int) ttime.tv_usec);
-	}
-
-	if (task_rank == 0)
-		gettimeofday(&stime, NULL);
-#elif OPH_TIME_DEBUG_2
-	gettimeofday(&etime, NULL);
-	timeval_subtract(&ttime, &etime, &stime);
-	printf("Proc %d: Set env:\t Time %d,%06d sec\n", task_rank, (int) ttime.tv_sec, (int) ttime.tv_usec);
-
-	gettimeofday(&stime, NULL);
-#endif
+	oph_trace_end(&phase, OPH_TRACE_CATEGORY_PHASE, "Set env", NULL);
+	oph_trace_begin(&phase);
 
 	if (!task_rank && idjob)
 		oph_odb_job_set_job_status(&oDB, idjob, OPH_ODB_JOB_STATUS_INIT);
@@ -1063,27 +1030,11 @@ int _oph_af_execute_framework(oph_operator_struct * handle, char *task_string, i
 /* gSOAP notification end */
 #endif
 		}
-		mysql_library_end();
-		oph_pid_free();
+		_oph_af_release_env();
 		return OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
 	}
-#ifdef OPH_TIME_DEBUG_1
-	MPI_Barrier(MPI_COMM_WORLD);
-	if (task_rank == 0) {
-		gettimeofday(&etime, NULL);
-		timeval_subtract(&ttime, &etime, &stime);
-		printf("Proc %d: Init task:\t Time %d,%06d sec\n", task_rank, (int) ttime.tv_sec, (int) ttime.tv_usec);
-	}
-
-	if (task_rank == 0)
-		gettimeofday(&stime, NULL);
-#elif OPH_TIME_DEBUG_2
-	gettimeofday(&etime, NULL);
-	timeval_subtract(&ttime, &etime, &stime);
-	printf("Proc %d: Init task:\t Time %d,%06d sec\n", task_rank, (int) ttime.tv_sec, (int) ttime.tv_usec);
-
-	gettimeofday(&stime, NULL);
-#endif
+	oph_trace_end(&phase, OPH_TRACE_CATEGORY_PHASE, "Init task", NULL);
+	oph_trace_begin(&phase);
 
 	if (!task_rank && idjob)
 		oph_odb_job_set_job_status(&oDB, idjob, OPH_ODB_JOB_STATUS_DISTRIBUTE);
@@ -1129,27 +1080,11 @@ int _oph_af_execute_framework(oph_operator_struct * handle, char *task_string, i
 /* gSOAP notification end */
 #endif
 		}
-		mysql_library_end();
-		oph_pid_free();
+		_oph_af_release_env();
 		return OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
 	}
-#ifdef OPH_TIME_DEBUG_1
-	MPI_Barrier(MPI_COMM_WORLD);
-	if (task_rank == 0) {
-		gettimeofday(&etime, NULL);
-		timeval_subtract(&ttime, &etime, &stime);
-		printf("Proc %d: Distribute task:\t Time %d,%06d sec\n", task_rank, (int) ttime.tv_sec, (int) ttime.tv_usec);
-	}
-
-	if (task_rank == 0)
-		gettimeofday(&stime, NULL);
-#elif OPH_TIME_DEBUG_2
-	gettimeofday(&etime, NULL);
-	timeval_subtract(&ttime, &etime, &stime);
-	printf("Proc %d: Distribute task:\t Time %d,%06d sec\n", task_rank, (int) ttime.tv_sec, (int) ttime.tv_usec);
-
-	gettimeofday(&stime, NULL);
-#endif
+	oph_trace_end(&phase, OPH_TRACE_CATEGORY_PHASE, "Distribute task", NULL);
+	oph_trace_begin(&phase);
 
 	if (!task_rank && idjob)
 		oph_odb_job_set_job_status(&oDB, idjob, OPH_ODB_JOB_STATUS_EXECUTE);
@@ -1195,27 +1130,11 @@ int _oph_af_execute_framework(oph_operator_struct * handle, char *task_string, i
 /* gSOAP notification end */
 #endif
 		}
-		mysql_library_end();
-		oph_pid_free();
+		_oph_af_release_env();
 		return OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
 	}
-#ifdef OPH_TIME_DEBUG_1
-	MPI_Barrier(MPI_COMM_WORLD);
-	if (task_rank == 0) {
-		gettimeofday(&etime, NULL);
-		timeval_subtract(&ttime, &etime, &stime);
-		printf("Proc %d: Execute task:\t Time %d,%06d sec\n", task_rank, (int) ttime.tv_sec, (int) ttime.tv_usec);
-	}
-
-	if (task_rank == 0)
-		gettimeofday(&stime, NULL);
-#elif OPH_TIME_DEBUG_2
-	gettimeofday(&etime, NULL);
-	timeval_subtract(&ttime, &etime, &stime);
-	printf("Proc %d: Execute task:\t Time %d,%06d sec\n", task_rank, (int) ttime.tv_sec, (int) ttime.tv_usec);
-
-	gettimeofday(&stime, NULL);
-#endif
+	oph_trace_end(&phase, OPH_TRACE_CATEGORY_PHASE, "Execute task", NULL);
+	oph_trace_begin(&phase);
 
 	if (!task_rank && idjob)
 		oph_odb_job_set_job_status(&oDB, idjob, OPH_ODB_JOB_STATUS_REDUCE);
@@ -1261,27 +1180,11 @@ int _oph_af_execute_framework(oph_operator_struct * handle, char *task_string, i
 /* gSOAP notification end */
 #endif
 		}
-		mysql_library_end();
-		oph_pid_free();
+		_oph_af_release_env();
 		return OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
 	}
-#ifdef OPH_TIME_DEBUG_1
-	MPI_Barrier(MPI_COMM_WORLD);
-	if (task_rank == 0) {
-		gettimeofday(&etime, NULL);
-		timeval_subtract(&ttime, &etime, &stime);
-		printf("Proc %d: Reduce task:\t Time %d,%06d sec\n", task_rank, (int) ttime.tv_sec, (int) ttime.tv_usec);
-	}
-
-	if (task_rank == 0)
-		gettimeofday(&stime, NULL);
-#elif OPH_TIME_DEBUG_2
-	gettimeofday(&etime, NULL);
-	timeval_subtract(&ttime, &etime, &stime);
-	printf("Proc %d: Reduce task:\t Time %d,%06d sec\n", task_rank, (int) ttime.tv_sec, (int) ttime.tv_usec);
-
-	gettimeofday(&stime, NULL);
-#endif
+	oph_trace_end(&phase, OPH_TRACE_CATEGORY_PHASE, "Reduce task", NULL);
+	oph_trace_begin(&phase);
 
 	if (!task_rank && idjob)
 		oph_odb_job_set_job_status(&oDB, idjob, OPH_ODB_JOB_STATUS_DESTROY);
@@ -1326,27 +1229,11 @@ int _oph_af_execute_framework(oph_operator_struct * handle, char *task_string, i
 /* gSOAP notification end */
 #endif
 		}
-		mysql_library_end();
-		oph_pid_free();
+		_oph_af_release_env();
 		return OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
 	}
-#ifdef OPH_TIME_DEBUG_1
-	MPI_Barrier(MPI_COMM_WORLD);
-	if (task_rank == 0) {
-		gettimeofday(&etime, NULL);
-		timeval_subtract(&ttime, &etime, &stime);
-		printf("Proc %d: Destroy task:\t Time %d,%06d sec\n", task_rank, (int) ttime.tv_sec, (int) ttime.tv_usec);
-	}
-
-	if (task_rank == 0)
-		gettimeofday(&stime, NULL);
-#elif OPH_TIME_DEBUG_2
-	gettimeofday(&etime, NULL);
-	timeval_subtract(&ttime, &etime, &stime);
-	printf("Proc %d: Destroy task:\t Time %d,%06d sec\n", task_rank, (int) ttime.tv_sec, (int) ttime.tv_usec);
-
-	gettimeofday(&stime, NULL);
-#endif
+	oph_trace_end(&phase, OPH_TRACE_CATEGORY_PHASE, "Destroy task", NULL);
+	oph_trace_begin(&phase);
 
 	if (!task_rank && idjob)
 		oph_odb_job_set_job_status(&oDB, idjob, OPH_ODB_JOB_STATUS_UNSET_ENV);
@@ -1389,27 +1276,11 @@ int _oph_af_execute_framework(oph_operator_struct * handle, char *task_string, i
 /* gSOAP notification end */
 #endif
 		}
-		mysql_library_end();
-		oph_pid_free();
+		_oph_af_release_env();
 		return OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
 	}
-#ifdef OPH_TIME_DEBUG_1
-	MPI_Barrier(MPI_COMM_WORLD);
-	if (task_rank == 0) {
-		gettimeofday(&etime, NULL);
-		timeval_subtract(&ttime, &etime, &stime);
-		printf("Proc %d: Unset env:\t Time %d,%06d sec\n", task_rank, (int) ttime.tv_sec, (int) ttime.tv_usec);
-	}
-
-	if (task_rank == 0)
-		gettimeofday(&stime, NULL);
-#elif OPH_TIME_DEBUG_2
-	gettimeofday(&etime, NULL);
-	timeval_subtract(&ttime, &etime, &stime);
-	printf("Proc %d: Unset env:\t Time %d,%06d sec\n", task_rank, (int) ttime.tv_sec, (int) ttime.tv_usec);
-
-	gettimeofday(&stime, NULL);
-#endif
+	oph_trace_end(&phase, OPH_TRACE_CATEGORY_PHASE, "Unset env", NULL);
+	oph_trace_begin(&phase);
 
 #ifdef BENCHMARK
 	gettimeofday(&etime_bench, NULL);
@@ -1446,6 +1317,9 @@ int _oph_af_execute_framework(oph_operator_struct * handle, char *task_string, i
 		else if (oph_af_write_json(oper_json, &handle->output_json, backtrace, notify_sessionid, marker_id))
 			return_code = -1;
 	}
+	oph_trace_end(&phase, OPH_TRACE_CATEGORY_PHASE, "Unload task", NULL);
+	if (oph_trace_is_enabled())
+		oph_trace_write(oph_trace_get_path()? oph_trace_get_path() : oph_af_trace_file, MPI_COMM_WORLD);
 #ifndef OPH_STANDALONE_MODE
 /* gSOAP notification start */
 	MPI_Barrier(MPI_COMM_WORLD);	//Barrier synchronization before successful notification
@@ -1486,32 +1360,20 @@ int _oph_af_execute_framework(oph_operator_struct * handle, char *task_string, i
 #endif
 
 	//In multi-thread code mysql_library_end must be called after executing all the threads
-	mysql_library_end();
-	oph_pid_free();
+	_oph_af_release_env();
 
 	if (return_code)
 		return OPH_ANALYTICS_OPERATOR_UTILITY_ERROR;
 
-#ifdef OPH_TIME_DEBUG_1
-	MPI_Barrier(MPI_COMM_WORLD);
-	if (task_rank == 0) {
-		gettimeofday(&etime, NULL);
-		timeval_subtract(&ttime, &etime, &stime);
-		printf("Proc %d: Unload task:\t Time %d,%06d sec\n", task_rank, (int) ttime.tv_sec, (int) ttime.tv_usec);
-	}
-#elif OPH_TIME_DEBUG_2
-	gettimeofday(&etime, NULL);
-	timeval_subtract(&ttime, &etime, &stime);
-	printf("Proc %d: Unload task:\t Time %d,%06d sec\n", task_rank, (int) ttime.tv_sec, (int) ttime.tv_usec);
-#endif
-
 	return OPH_ANALYTICS_OPERATOR_SUCCESS;
 }
 
 int oph_af_execute_framework(char *task_string, int task_number, int task_rank)
 {
 	oph_operator_struct handle;
+	logging_async_start();
 	int result = _oph_af_execute_framework(&handle, task_string, task_number, task_rank);
+	logging_async_stop();
 
 #ifndef OPH_STANDALONE_MODE
 	oph_save_json_response(handle.output_json, handle.output_path, handle.output_name);
@@ -1534,3 +1396,17 @@ int oph_af_execute_framework(char *task_string, int task_number, int task_rank)
 	}
 	return result;
 }
+
+int oph_af_set_resident_mode(char resident)
+{
+	return oph_set_resident_mode(resident);
+}
+
+int oph_af_release_resident_env()
+{
+	int res = oph_release_operator_libraries();
+	oph_set_resident_mode(0);
+	_oph_af_release_env();
+
+	return res;
+}
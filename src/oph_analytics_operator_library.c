@@ -23,6 +23,7 @@
 #include <ltdl.h>
 #include <string.h>
 #include <errno.h>
+#include <mpi.h>
 
 #include "debug.h"
 #include "oph_task_parser_library.h"
@@ -30,8 +31,34 @@
 
 extern int msglevel;
 
+/**
+ * \brief Driver library kept open in resident mode
+ * \param operator_type Name of the operator
+ * \param lib Path to driver library
+ * \param dlh Libtool handler to driver library
+ * \param next Next library
+ */
+typedef struct _oph_operator_library {
+	char *operator_type;
+	char *lib;
+	lt_dlhandle dlh;
+	struct _oph_operator_library *next;
+} oph_operator_library;
+
+static char oph_resident_mode = 0;
+static char oph_resident_dlinit = 0;
+static oph_operator_library *oph_resident_libraries = NULL;
+
 static int oph_find_operator_library(char *operator_type, char **dyn_lib);
 
+//Drop the per-task state kept by the copy of the libraries linked in the driver (if the driver uses them)
+static void _oph_reset_driver_state(lt_dlhandle dlh)
+{
+	int (*_oph_cache_clear) ();
+	if ((_oph_cache_clear = (int (*)()) lt_dlsym(dlh, OPH_ANALYTICS_OPERATOR_ODB_CACHE_CLEAR_FUNC)))
+		_oph_cache_clear();
+}
+
 int oph_operator_struct_initializer(int size, int myrank, oph_operator_struct * handle)
 {
 	if (!handle) {
@@ -83,16 +110,51 @@ int oph_set_env(HASHTBL * task_tbl, oph_operator_struct * handle)
 		return OPH_ANALYTICS_OPERATOR_MEMORY_ERR;
 	}
 
-	lt_dlinit();
-
-	if (oph_find_operator_library(handle->operator_type, &handle->lib)) {
-		pmesg(LOG_ERROR, __FILE__, __LINE__, "Driver library not found\n");
-		return OPH_ANALYTICS_OPERATOR_LIB_NOT_FOUND;
+	if (!oph_resident_dlinit) {
+		lt_dlinit();
+		oph_resident_dlinit = oph_resident_mode;
 	}
+	//In resident mode use the library loaded by previous tasks
+	oph_operator_library *library = NULL;
+	if (oph_resident_mode)
+		for (library = oph_resident_libraries; library; library = library->next)
+			if (!strcasecmp(library->operator_type, handle->operator_type)) {
+				if (!(handle->lib = strdup(library->lib))) {
+					pmesg(LOG_ERROR, __FILE__, __LINE__, "Memory allocation error\n");
+					return OPH_ANALYTICS_OPERATOR_MEMORY_ERR;
+				}
+				handle->dlh = library->dlh;
+				//A previous task could have been interrupted before releasing its state
+				_oph_reset_driver_state(handle->dlh);
+				break;
+			}
 
-	if (!(handle->dlh = (lt_dlhandle) lt_dlopen(handle->lib))) {
-		pmesg(LOG_ERROR, __FILE__, __LINE__, "lt_dlopen error: %s (library '%s')\n", lt_dlerror(), handle->lib);
-		return OPH_ANALYTICS_OPERATOR_DLOPEN_ERR;
+	if (!handle->dlh) {
+		if (oph_find_operator_library(handle->operator_type, &handle->lib)) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Driver library not found\n");
+			return OPH_ANALYTICS_OPERATOR_LIB_NOT_FOUND;
+		}
+
+		if (!(handle->dlh = (lt_dlhandle) lt_dlopen(handle->lib))) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "lt_dlopen error: %s (library '%s')\n", lt_dlerror(), handle->lib);
+			return OPH_ANALYTICS_OPERATOR_DLOPEN_ERR;
+		}
+
+		if (oph_resident_mode && (library = (oph_operator_library *) calloc(1, sizeof(oph_operator_library)))) {
+			library->operator_type = strdup(handle->operator_type);
+			library->lib = strdup(handle->lib);
+			if (library->operator_type && library->lib) {
+				library->dlh = handle->dlh;
+				library->next = oph_resident_libraries;
+				oph_resident_libraries = library;
+			} else {
+				if (library->operator_type)
+					free(library->operator_type);
+				if (library->lib)
+					free(library->lib);
+				free(library);
+			}
+		}
 	}
 
 	if (!(_oph_set_env = (int (*)(HASHTBL *, oph_operator_struct *)) lt_dlsym(handle->dlh, OPH_ANALYTICS_OPERATOR_ENV_SET_FUNC))) {
@@ -120,7 +182,14 @@ int oph_init_task(oph_operator_struct * handle)
 	if (!(_oph_init_task = (int (*)(oph_operator_struct *)) lt_dlsym(handle->dlh, OPH_ANALYTICS_OPERATOR_TASK_INIT_FUNC)))
 		return OPH_ANALYTICS_OPERATOR_SUCCESS;
 
-	return _oph_init_task(handle);
+	int res = _oph_init_task(handle);
+
+	//Share the metadata read from OphidiaDB by the root process (if the driver uses it): the call is collective, so it is done by every process even if initialization failed
+	int (*_oph_cache_bcast) (MPI_Comm, int);
+	if ((_oph_cache_bcast = (int (*)(MPI_Comm, int)) lt_dlsym(handle->dlh, OPH_ANALYTICS_OPERATOR_ODB_CACHE_BCAST_FUNC)))
+		_oph_cache_bcast(MPI_COMM_WORLD, res);
+
+	return res;
 }
 
 int oph_distribute_task(oph_operator_struct * handle)
@@ -224,11 +293,25 @@ int oph_unset_env(oph_operator_struct * handle)
 		return OPH_ANALYTICS_OPERATOR_DLSYM_ERR;
 	}
 	//Release operator resources
-	int res;
-	if ((res = _oph_unset_env(handle))) {
+	int res = _oph_unset_env(handle);
+
+	//Drop the metadata read from OphidiaDB during the task, also in case of errors, so that next tasks served by the same library start from scratch
+	_oph_reset_driver_state(handle->dlh);
+
+	if (res) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to release resources\n");
 		return res;
 	}
+
+	//Close idle connections to I/O servers and OphidiaDB (if the driver uses them), unless they are kept for next tasks
+	int (*_oph_pool_clear) ();
+	if (!oph_resident_mode) {
+		if ((_oph_pool_clear = (int (*)()) lt_dlsym(handle->dlh, OPH_ANALYTICS_OPERATOR_POOL_CLEAR_FUNC)))
+			_oph_pool_clear();
+		if ((_oph_pool_clear = (int (*)()) lt_dlsym(handle->dlh, OPH_ANALYTICS_OPERATOR_ODB_POOL_CLEAR_FUNC)))
+			_oph_pool_clear();
+	}
+
 	//Release handle resources
 	if (handle->operator_type) {
 		free(handle->operator_type);
@@ -239,7 +322,7 @@ int oph_unset_env(oph_operator_struct * handle)
 		handle->lib = NULL;
 	}
 #ifndef OPH_WITH_VALGRIND
-	if (handle->dlh && (lt_dlclose(handle->dlh))) {
+	if (handle->dlh && !oph_resident_mode && (lt_dlclose(handle->dlh))) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "lt_dlclose error: %s (library %s)\n", lt_dlerror(), handle->lib);
 		return OPH_ANALYTICS_OPERATOR_DLCLOSE_ERR;
 	}
@@ -250,6 +333,10 @@ int oph_unset_env(oph_operator_struct * handle)
 
 int oph_exit_task()
 {
+	//In resident mode libtool is finalized by oph_release_operator_libraries
+	if (oph_resident_mode)
+		return OPH_ANALYTICS_OPERATOR_SUCCESS;
+
 #ifndef OPH_WITH_VALGRIND
 	if (lt_dlexit()) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Error while executing lt_dlexit\n");
@@ -260,6 +347,56 @@ int oph_exit_task()
 	return OPH_ANALYTICS_OPERATOR_SUCCESS;
 }
 
+int oph_set_resident_mode(char resident)
+{
+	oph_resident_mode = resident ? 1 : 0;
+
+	return OPH_ANALYTICS_OPERATOR_SUCCESS;
+}
+
+char oph_is_resident_mode()
+{
+	return oph_resident_mode;
+}
+
+int oph_release_operator_libraries()
+{
+	int res = OPH_ANALYTICS_OPERATOR_SUCCESS;
+	int (*_oph_pool_clear) ();
+	oph_operator_library *library;
+
+	while ((library = oph_resident_libraries)) {
+		oph_resident_libraries = library->next;
+		if ((_oph_pool_clear = (int (*)()) lt_dlsym(library->dlh, OPH_ANALYTICS_OPERATOR_POOL_CLEAR_FUNC)))
+			_oph_pool_clear();
+		if ((_oph_pool_clear = (int (*)()) lt_dlsym(library->dlh, OPH_ANALYTICS_OPERATOR_ODB_POOL_CLEAR_FUNC)))
+			_oph_pool_clear();
+		if ((_oph_pool_clear = (int (*)()) lt_dlsym(library->dlh, OPH_ANALYTICS_OPERATOR_ODB_CACHE_CLEAR_FUNC)))
+			_oph_pool_clear();
+#ifndef OPH_WITH_VALGRIND
+		if (lt_dlclose(library->dlh)) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "lt_dlclose error: %s (library %s)\n", lt_dlerror(), library->lib);
+			res = OPH_ANALYTICS_OPERATOR_DLCLOSE_ERR;
+		}
+#endif
+		free(library->operator_type);
+		free(library->lib);
+		free(library);
+	}
+
+	if (oph_resident_dlinit) {
+		oph_resident_dlinit = 0;
+#ifndef OPH_WITH_VALGRIND
+		if (lt_dlexit()) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Error while executing lt_dlexit\n");
+			res = OPH_ANALYTICS_OPERATOR_DLEXIT_ERR;
+		}
+#endif
+	}
+
+	return res;
+}
+
 static int oph_find_operator_library(char *operator_type, char **dyn_lib)
 {
 	FILE *fp = NULL;
@@ -0,0 +1,273 @@
+/*
+    Ophidia Analytics Framework
+    Copyright (C) 2012-2024 CMCC Foundation
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "oph_coord_index_library.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "debug.h"
+
+extern int msglevel;
+
+//Compare the coordinate i with a value: return a negative number if the coordinate is lower, 0 if they are equal and a positive number otherwise
+static int _oph_coord_index_compare(oph_coord_index * index, int i, const oph_coord_index_value * value)
+{
+	if (index->long_values)
+		return index->long_values[i] < value->l ? -1 : index->long_values[i] > value->l;
+	return index->values[i] < value->d ? -1 : index->values[i] > value->d;
+}
+
+//Return 1 if the value is nearer to the coordinate lower than to the coordinate upper, assuming that the value is between them
+static int _oph_coord_index_is_nearer(oph_coord_index * index, int lower, int upper, const oph_coord_index_value * value)
+{
+	//Differences of 64-bit integers are computed as unsigned to avoid overflows
+	if (index->long_values)
+		return (unsigned long long) value->l - (unsigned long long) index->long_values[lower] < (unsigned long long) index->long_values[upper] - (unsigned long long) value->l;
+	return value->d - index->values[lower] < index->values[upper] - value->d;
+}
+
+int oph_coord_index_init(oph_coord_index * index, oph_coord_index_type type, const void *array, int size)
+{
+	if (!index || !array || (size <= 0)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_COORD_INDEX_ERROR;
+	}
+
+	index->type = type;
+	index->size = size;
+	index->order = 1;
+	index->monotonic = 1;
+	index->values = NULL;
+	index->long_values = NULL;
+
+	//64-bit integers are not converted to double, as they could not be represented exactly
+	if (type == OPH_COORD_INDEX_LONG) {
+		if (!(index->long_values = (long long *) malloc(size * sizeof(long long)))) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Error allocating memory\n");
+			return OPH_COORD_INDEX_ERROR;
+		}
+	} else if (!(index->values = (double *) malloc(size * sizeof(double)))) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Error allocating memory\n");
+		return OPH_COORD_INDEX_ERROR;
+	}
+
+	int i;
+	switch (type) {
+		case OPH_COORD_INDEX_BYTE:
+			for (i = 0; i < size; i++)
+				index->values[i] = ((const char *) array)[i];
+			break;
+		case OPH_COORD_INDEX_SHORT:
+			for (i = 0; i < size; i++)
+				index->values[i] = ((const short *) array)[i];
+			break;
+		case OPH_COORD_INDEX_INT:
+			for (i = 0; i < size; i++)
+				index->values[i] = ((const int *) array)[i];
+			break;
+		case OPH_COORD_INDEX_LONG:
+			memcpy(index->long_values, array, size * sizeof(long long));
+			break;
+		case OPH_COORD_INDEX_FLOAT:
+			for (i = 0; i < size; i++)
+				index->values[i] = ((const float *) array)[i];
+			break;
+		case OPH_COORD_INDEX_DOUBLE:
+			memcpy(index->values, array, size * sizeof(double));
+			break;
+		default:
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Type not supported\n");
+			free(index->values);
+			index->values = NULL;
+			return OPH_COORD_INDEX_ERROR;
+	}
+
+	//Check order of dimension values
+	oph_coord_index_value previous;
+	if (index->long_values)
+		previous.l = index->long_values[size - 1];
+	else
+		previous.d = index->values[size - 1];
+	if (_oph_coord_index_compare(index, 0, &previous) > 0)
+		index->order = 0;
+	for (i = 1; i < size; i++) {
+		if (index->long_values)
+			previous.l = index->long_values[i - 1];
+		else
+			previous.d = index->values[i - 1];
+		if (index->order ? _oph_coord_index_compare(index, i, &previous) < 0 : _oph_coord_index_compare(index, i, &previous) > 0) {
+			pmesg(LOG_DEBUG, __FILE__, __LINE__, "Coordinate values are not sorted: linear search will be used\n");
+			index->monotonic = 0;
+			break;
+		}
+	}
+
+	return OPH_COORD_INDEX_SUCCESS;
+}
+
+int oph_coord_index_parse_value(oph_coord_index * index, const char *value, int want_start, double offset, oph_coord_index_value * result)
+{
+	if (!index || !value || !result) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_COORD_INDEX_ERROR;
+	}
+
+	switch (index->type) {
+		case OPH_COORD_INDEX_BYTE:{
+				char value_ = (char) (strtol(value, (char **) NULL, 10));
+				if (offset)
+					value_ += (char) (want_start ? -offset : offset);
+				result->d = value_;
+				break;
+			}
+		case OPH_COORD_INDEX_SHORT:{
+				short value_ = (short) (strtol(value, (char **) NULL, 10));
+				if (offset)
+					value_ += (short) (want_start ? -offset : offset);
+				result->d = value_;
+				break;
+			}
+		case OPH_COORD_INDEX_INT:{
+				int value_ = (int) (strtol(value, (char **) NULL, 10));
+				if (offset)
+					value_ += (int) (want_start ? -offset : offset);
+				result->d = value_;
+				break;
+			}
+		case OPH_COORD_INDEX_LONG:{
+				long long value_ = (long long) (strtoll(value, (char **) NULL, 10));
+				if (offset)
+					value_ += (long long) (want_start ? -offset : offset);
+				result->l = value_;
+				break;
+			}
+		case OPH_COORD_INDEX_FLOAT:{
+				float value_ = (float) (strtof(value, NULL));
+				if (offset)
+					value_ += (float) (want_start ? -offset : offset);
+				result->d = value_;
+				break;
+			}
+		case OPH_COORD_INDEX_DOUBLE:{
+				double value_ = (double) (strtod(value, NULL));
+				if (offset)
+					value_ += want_start ? -offset : offset;
+				result->d = value_;
+				break;
+			}
+		default:
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Type not supported\n");
+			return OPH_COORD_INDEX_ERROR;
+	}
+
+	return OPH_COORD_INDEX_SUCCESS;
+}
+
+int oph_coord_index_find(oph_coord_index * index, const oph_coord_index_value * value, int want_start, char out_of_bound, int *coord_index)
+{
+	if (!index || (!index->values && !index->long_values) || !value || !coord_index) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_COORD_INDEX_ERROR;
+	}
+
+	int i, low, high, mid, size = index->size, nearest_point = want_start > 0;
+
+	if (out_of_bound) {
+		if (index->order ? (_oph_coord_index_compare(index, 0, value) > 0) || (_oph_coord_index_compare(index, size - 1, value) < 0)
+		    : (_oph_coord_index_compare(index, 0, value) < 0) || (_oph_coord_index_compare(index, size - 1, value) > 0))
+			return OPH_COORD_INDEX_BOUND_ERROR;
+	}
+
+	if (index->order) {
+		//Ascending: first value not lower than the given value
+		if (index->monotonic) {
+			low = 0;
+			high = size;
+			while (low < high) {
+				mid = low + (high - low) / 2;
+				if (_oph_coord_index_compare(index, mid, value) < 0)
+					low = mid + 1;
+				else
+					high = mid;
+			}
+			i = low;
+		} else
+			for (i = 0; (i < size) && (_oph_coord_index_compare(index, i, value) < 0); i++);
+		if ((i == size) || _oph_coord_index_compare(index, i, value)) {
+			if (nearest_point) {
+				if ((i > 0) && ((i == size) || _oph_coord_index_is_nearer(index, i - 1, i, value)))
+					i--;
+			} else if (want_start) {
+				if (i == size)
+					i--;
+			} else if (i)
+				i--;
+		}
+	} else {
+		//Descending: last value not lower than the given value
+		if (index->monotonic) {
+			low = 0;
+			high = size;
+			while (low < high) {
+				mid = low + (high - low) / 2;
+				if (_oph_coord_index_compare(index, mid, value) >= 0)
+					low = mid + 1;
+				else
+					high = mid;
+			}
+			i = low - 1;
+		} else
+			for (i = size - 1; (i >= 0) && (_oph_coord_index_compare(index, i, value) < 0); i--);
+		if ((i < 0) || _oph_coord_index_compare(index, i, value)) {
+			if (nearest_point) {
+				if ((i < size - 1) && ((i < 0) || _oph_coord_index_is_nearer(index, i + 1, i, value)))
+					i++;
+			} else if (want_start) {
+				if (i < 0)
+					i = 0;
+			} else if (i < size - 1)
+				i++;
+		}
+	}
+
+	*coord_index = i;
+
+	return OPH_COORD_INDEX_SUCCESS;
+}
+
+int oph_coord_index_free(oph_coord_index * index)
+{
+	if (!index) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_COORD_INDEX_ERROR;
+	}
+
+	if (index->values) {
+		free(index->values);
+		index->values = NULL;
+	}
+	if (index->long_values) {
+		free(index->long_values);
+		index->long_values = NULL;
+	}
+	index->size = 0;
+
+	return OPH_COORD_INDEX_SUCCESS;
+}
@@ -33,14 +33,44 @@
 
 #include "oph-lib-binary-io.h"
 #include "oph_pid_library.h"
+#include "oph_trace_library.h"
 #include "debug.h"
 
 #define OPH_DC_MAX_SIZE 100
 #define OPH_DC_MIN_SIZE 50
 #define OPH_DC_COMPLEX_DATATYPE_PREFIX "complex_"
 
+#define OPH_DC_RAND_GOLDEN 0x9E3779B97F4A7C15ULL
+#define OPH_DC_RAND_UNIT (1.0 / 9007199254740992.0)
+
+#define OPH_DC_TRANSFER_LINK 1
+#define OPH_DC_TRANSFER_COPY 2
+#define OPH_DC_TRANSFER_SERVER 4
+#define OPH_DC_TRANSFER_LINK_NAME "%s_link%d"
+#define OPH_DC_TRANSFER_COPY_NAME "%s_copy%d"
+#define OPH_DC_TRANSFER_RESERVED_CHARS "'\\;|@:/"
+#define OPH_DC_TRANSFER_SERVER_NAME "%s_server%d"
+#define OPH_DC_TRANSFER_HIDDEN_PASSWORD "***"
+
+#define OPH_DC_CACHE_KEY "%s|%s|%llu:%016llx"
+
 extern int msglevel;
 
+//Execute a query related to a fragment and record a span in case tracing is enabled
+int _oph_dc_execute_query(oph_ioserver_handler * server, oph_ioserver_query * query, const char *name, oph_odb_fragment * frag, const char *query_text, long long rows, long long bytes)
+{
+	if (!oph_trace_is_enabled())
+		return oph_ioserver_execute_query(server, query);
+
+	oph_trace_span span;
+	oph_trace_begin(&span);
+	int res = oph_ioserver_execute_query(server, query);
+	oph_trace_args trace_args = { frag ? frag->id_fragment : -1, frag && frag->db_instance && frag->db_instance->dbms_instance ? frag->db_instance->dbms_instance->hostname : NULL, query_text, rows, bytes };
+	oph_trace_end(&span, OPH_TRACE_CATEGORY_QUERY, name, &trace_args);
+
+	return res;
+}
+
 char oph_dc_typeof(char *data_type)
 {
 	if (!data_type)
@@ -136,11 +166,23 @@ int oph_dc_connect_to_dbms(oph_ioserver_handler * server, oph_odb_dbms_instance
 	conn_params.db_name = NULL;
 	conn_params.opt_flag = flag;
 
-	if (oph_ioserver_connect(server, &conn_params)) {
-		pmesg(LOG_ERROR, __FILE__, __LINE__, "Server connection error\n");
-		oph_dc_disconnect_from_dbms(server, dbms);
-		return OPH_DC_SERVER_ERROR;
-	}
+	char hit;
+	do {
+		hit = 0;
+		if (oph_ioserver_pool_lease(server, &conn_params, &hit)) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Server connection error\n");
+			oph_ioserver_close(server);
+			return OPH_DC_SERVER_ERROR;
+		}
+		//Check that the reused connection is still alive: otherwise discard it and lease another one (a new connection is opened when the pool has no other idle connections)
+		if (hit && oph_dc_check_connection_to_db(server, dbms, NULL, flag)) {
+			pmesg(LOG_DEBUG, __FILE__, __LINE__, "Idle connection to %s has been discarded\n", dbms->hostname);
+			oph_ioserver_close(server);
+			continue;
+		}
+		break;
+	} while (hit);
+
 	return OPH_DC_SUCCESS;
 }
 
@@ -204,7 +246,7 @@ int oph_dc_disconnect_from_dbms(oph_ioserver_handler * server, oph_odb_dbms_inst
 		return OPH_DC_NULL_PARAM;
 	}
 
-	oph_ioserver_close(server);
+	oph_ioserver_pool_return(server);
 	return OPH_DC_SUCCESS;
 }
 
@@ -402,7 +444,7 @@ int oph_dc_create_empty_fragment_from_name(oph_ioserver_handler * server, const
 	return OPH_DC_SUCCESS;
 }
 
-int oph_dc_delete_fragment(oph_ioserver_handler * server, oph_odb_fragment * frag)
+int _oph_dc_delete_fragment(oph_ioserver_handler * server, oph_odb_fragment * frag, char view)
 {
 	if (!frag || !server) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
@@ -413,7 +455,7 @@ int oph_dc_delete_fragment(oph_ioserver_handler * server, oph_odb_fragment * fra
 		return OPH_DC_SERVER_ERROR;
 	}
 
-	int query_buflen = 1 + snprintf(NULL, 0, OPH_DC_SQ_DELETE_FRAG, frag->fragment_name);
+	int query_buflen = 1 + snprintf(NULL, 0, view ? OPH_DC_SQ_DELETE_FRAG_VIEW : OPH_DC_SQ_DELETE_FRAG, frag->fragment_name);
 	long long max_size = QUERY_BUFLEN;
 	oph_pid_get_buffer_size(&max_size);
 	if (query_buflen >= max_size) {
@@ -421,11 +463,14 @@ int oph_dc_delete_fragment(oph_ioserver_handler * server, oph_odb_fragment * fra
 		return OPH_ODB_STR_BUFF_OVERFLOW;
 	}
 #ifdef OPH_DEBUG_MYSQL
-	printf("ORIGINAL QUERY: " MYSQL_DC_DELETE_FRAG "\n", frag->fragment_name);
+	if (view)
+		printf("ORIGINAL QUERY: " MYSQL_DC_DELETE_FRAG_VIEW "\n", frag->fragment_name);
+	else
+		printf("ORIGINAL QUERY: " MYSQL_DC_DELETE_FRAG "\n", frag->fragment_name);
 #endif
 
 	char delete_query[query_buflen];
-	int n = snprintf(delete_query, query_buflen, OPH_DC_SQ_DELETE_FRAG, frag->fragment_name);
+	int n = snprintf(delete_query, query_buflen, view ? OPH_DC_SQ_DELETE_FRAG_VIEW : OPH_DC_SQ_DELETE_FRAG, frag->fragment_name);
 	if (n >= query_buflen) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Size of query exceed query limit.\n");
 		return OPH_ODB_STR_BUFF_OVERFLOW;
@@ -448,6 +493,115 @@ int oph_dc_delete_fragment(oph_ioserver_handler * server, oph_odb_fragment * fra
 	return OPH_DC_SUCCESS;
 }
 
+int oph_dc_delete_fragment(oph_ioserver_handler * server, oph_odb_fragment * frag)
+{
+	return _oph_dc_delete_fragment(server, frag, 0);
+}
+
+int oph_dc_delete_fragment_view(oph_ioserver_handler * server, oph_odb_fragment * frag)
+{
+	return _oph_dc_delete_fragment(server, frag, 1);
+}
+
+int oph_dc_create_fragment_view_from_query(oph_ioserver_handler * server, oph_odb_fragment * old_frag, char *new_frag_name, char *operation, long long *aggregate_number)
+{
+	if (!old_frag || !new_frag_name || !operation || !server) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_DC_NULL_PARAM;
+	}
+	if (oph_dc_check_connection_to_db(server, old_frag->db_instance->dbms_instance, old_frag->db_instance, 0)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to reconnect to DB.\n");
+		return OPH_DC_SERVER_ERROR;
+	}
+
+	oph_ioserver_query *query = NULL;
+	int res;
+	if (aggregate_number) {
+#ifdef OPH_DEBUG_MYSQL
+		printf("ORIGINAL QUERY: " MYSQL_DC_APPLY_PLUGIN_VIEW_G "\n", new_frag_name, MYSQL_FRAG_ID, *aggregate_number, MYSQL_FRAG_ID, operation, MYSQL_FRAG_MEASURE, old_frag->fragment_name,
+		       MYSQL_FRAG_ID, *aggregate_number);
+#endif
+		res = oph_ioserver_setup_query_template(server, OPH_DC_SQ_APPLY_PLUGIN_VIEW_G, 1, NULL, &query, new_frag_name, MYSQL_FRAG_ID, *aggregate_number, operation, MYSQL_FRAG_ID,
+							MYSQL_FRAG_MEASURE, old_frag->fragment_name, MYSQL_FRAG_ID, *aggregate_number);
+	} else {
+#ifdef OPH_DEBUG_MYSQL
+		printf("ORIGINAL QUERY: " MYSQL_DC_APPLY_PLUGIN_VIEW "\n", new_frag_name, MYSQL_FRAG_ID, operation, MYSQL_FRAG_MEASURE, old_frag->fragment_name);
+#endif
+		res = oph_ioserver_setup_query_template(server, OPH_DC_SQ_APPLY_PLUGIN_VIEW, 1, NULL, &query, new_frag_name, MYSQL_FRAG_ID, operation, MYSQL_FRAG_MEASURE, old_frag->fragment_name);
+	}
+	if (res) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to setup query '%s'\n", operation);
+		return OPH_DC_SERVER_ERROR;
+	}
+
+	if (_oph_dc_execute_query(server, query, "create_fragment_view", old_frag, operation, -1, -1)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to execute operation '%s'\n", operation);
+		oph_ioserver_free_query(server, query);
+		return OPH_DC_SERVER_ERROR;
+	}
+
+	oph_ioserver_free_query(server, query);
+
+	return OPH_DC_SUCCESS;
+}
+
+int oph_dc_create_fragment_from_copy(oph_ioserver_handler * server, oph_odb_fragment * old_frag, char *new_frag_name, const char *source_frag_name)
+{
+	if (!old_frag || !new_frag_name || !source_frag_name || !server) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_DC_NULL_PARAM;
+	}
+	if (oph_dc_check_connection_to_db(server, old_frag->db_instance->dbms_instance, old_frag->db_instance, 0)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to reconnect to DB.\n");
+		return OPH_DC_SERVER_ERROR;
+	}
+
+	oph_ioserver_query *query = NULL;
+	if (oph_ioserver_setup_query_template(server, OPH_DC_SQ_CREATE_FRAG_COPY, 1, NULL, &query, new_frag_name, source_frag_name)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to setup query to copy fragment %s\n", source_frag_name);
+		return OPH_DC_SERVER_ERROR;
+	}
+
+	char query_text[OPH_COMMON_BUFFER_LEN];
+	snprintf(query_text, OPH_COMMON_BUFFER_LEN, OPH_DC_SQ_CREATE_FRAG_COPY, new_frag_name, source_frag_name);
+	int res = _oph_dc_execute_query(server, query, "copy_fragment", old_frag, query_text, -1, -1);
+	oph_ioserver_free_query(server, query);
+	if (res) {
+		pmesg(LOG_WARNING, __FILE__, __LINE__, "Unable to copy fragment %s\n", source_frag_name);
+		//Remove any partial copy, so that the fragment can be created again
+		oph_odb_fragment new_frag = *old_frag;
+		snprintf(new_frag.fragment_name, OPH_ODB_STGE_FRAG_NAME_SIZE + 1, "%s", new_frag_name);
+		_oph_dc_delete_fragment(server, &new_frag, 0);
+		return OPH_DC_SERVER_ERROR;
+	}
+
+	return OPH_DC_SUCCESS;
+}
+
+int oph_dc_build_cache_key(const char *operator_name, const char *operation, const char *params, unsigned long long params_size, char **key)
+{
+	if (!operator_name || !operation || !key) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_DC_NULL_PARAM;
+	}
+
+	//Parameters bound to the query are summarized with 64-bit FNV-1a
+	unsigned long long hash = 0xcbf29ce484222325ULL, i;
+	for (i = 0; params && (i < params_size); i++) {
+		hash ^= (unsigned char) params[i];
+		hash *= 0x100000001b3ULL;
+	}
+
+	int key_len = 1 + snprintf(NULL, 0, OPH_DC_CACHE_KEY, operator_name, operation, params ? params_size : 0, hash);
+	if (!(*key = (char *) malloc(key_len))) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Error allocating memory\n");
+		return OPH_DC_DATA_ERROR;
+	}
+	snprintf(*key, key_len, OPH_DC_CACHE_KEY, operator_name, operation, params ? params_size : 0, hash);
+
+	return OPH_DC_SUCCESS;
+}
+
 int oph_dc_create_fragment_from_query(oph_ioserver_handler * server, oph_odb_fragment * old_frag, char *new_frag_name, char *operation, char *where, long long *aggregate_number, long long *start_id)
 {
 	return oph_dc_create_fragment_from_query2(server, old_frag, new_frag_name, operation, where, aggregate_number, start_id, NULL);
@@ -493,7 +647,7 @@ int oph_dc_create_fragment_from_query2(oph_ioserver_handler * server, oph_odb_fr
 			return OPH_DC_SERVER_ERROR;
 		}
 
-		if (oph_ioserver_execute_query(server, query)) {
+		if (_oph_dc_execute_query(server, query, "create_fragment", old_frag, create_query, -1, -1)) {
 			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to execute operation '%s'\n", create_query);
 			oph_ioserver_free_query(server, query);
 			return OPH_DC_SERVER_ERROR;
@@ -503,38 +657,8 @@ int oph_dc_create_fragment_from_query2(oph_ioserver_handler * server, oph_odb_fr
 
 	} else {
 
-		if (where) {
-			if (aggregate_number) {
-				if (block_size) {
-					query_buflen = 1 + snprintf(NULL, 0, OPH_DC_SQ_APPLY_PLUGIN_WGB, new_frag_name, MYSQL_FRAG_ID, *aggregate_number, *block_size, operation, MYSQL_FRAG_ID,
-								    MYSQL_FRAG_MEASURE, old_frag->fragment_name, where, MYSQL_FRAG_ID, *aggregate_number, *block_size);
-				} else {
-					query_buflen = 1 + snprintf(NULL, 0, OPH_DC_SQ_APPLY_PLUGIN_WG, new_frag_name, MYSQL_FRAG_ID, *aggregate_number, operation, MYSQL_FRAG_ID,
-								    MYSQL_FRAG_MEASURE, old_frag->fragment_name, where, MYSQL_FRAG_ID, *aggregate_number);
-				}
-			} else {
-				query_buflen = 1 + snprintf(NULL, 0, OPH_DC_SQ_APPLY_PLUGIN_W, new_frag_name, operation, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE, old_frag->fragment_name, where);
-			}
-		} else {
-			if (aggregate_number) {
-				if (block_size) {
-					query_buflen = 1 + snprintf(NULL, 0, OPH_DC_SQ_APPLY_PLUGIN_GB, new_frag_name, MYSQL_FRAG_ID, *aggregate_number, *block_size, operation, MYSQL_FRAG_ID,
-								    MYSQL_FRAG_MEASURE, old_frag->fragment_name, MYSQL_FRAG_ID, *aggregate_number, *block_size);
-				} else {
-					query_buflen = 1 + snprintf(NULL, 0, OPH_DC_SQ_APPLY_PLUGIN_G, new_frag_name, MYSQL_FRAG_ID, *aggregate_number, operation, MYSQL_FRAG_ID,
-								    MYSQL_FRAG_MEASURE, old_frag->fragment_name, MYSQL_FRAG_ID, *aggregate_number);
-				}
-			} else {
-				query_buflen = 1 + snprintf(NULL, 0, OPH_DC_SQ_APPLY_PLUGIN, new_frag_name, MYSQL_FRAG_ID, operation, MYSQL_FRAG_MEASURE, old_frag->fragment_name);
-			}
-		}
-
-		if (query_buflen >= max_size) {
-			pmesg(LOG_ERROR, __FILE__, __LINE__, "Buffer size (%ld bytes) is too small.\n", max_size);
-			return OPH_DC_SERVER_ERROR;
-		}
-
-		char create_query[query_buflen];
+		oph_ioserver_query *query = NULL;
+		int res;
 
 		if (where) {
 			if (aggregate_number) {
@@ -543,22 +667,22 @@ int oph_dc_create_fragment_from_query2(oph_ioserver_handler * server, oph_odb_fr
 					printf("ORIGINAL QUERY: " MYSQL_DC_APPLY_PLUGIN_WGB "\n", new_frag_name, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE, MYSQL_FRAG_ID, *aggregate_number, *block_size,
 					       MYSQL_FRAG_ID, operation, MYSQL_FRAG_MEASURE, old_frag->fragment_name, where, MYSQL_FRAG_ID, *aggregate_number, *block_size);
 #endif
-					n = snprintf(create_query, query_buflen, OPH_DC_SQ_APPLY_PLUGIN_WGB, new_frag_name, MYSQL_FRAG_ID, *aggregate_number, *block_size, operation, MYSQL_FRAG_ID,
-						     MYSQL_FRAG_MEASURE, old_frag->fragment_name, where, MYSQL_FRAG_ID, *aggregate_number, *block_size);
+					res = oph_ioserver_setup_query_template(server, OPH_DC_SQ_APPLY_PLUGIN_WGB, 1, NULL, &query, new_frag_name, MYSQL_FRAG_ID, *aggregate_number, *block_size, operation, MYSQL_FRAG_ID,
+										MYSQL_FRAG_MEASURE, old_frag->fragment_name, where, MYSQL_FRAG_ID, *aggregate_number, *block_size);
 				} else {
 #ifdef OPH_DEBUG_MYSQL
 					printf("ORIGINAL QUERY: " MYSQL_DC_APPLY_PLUGIN_WG "\n", new_frag_name, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE, MYSQL_FRAG_ID, *aggregate_number, MYSQL_FRAG_ID,
 					       operation, MYSQL_FRAG_MEASURE, old_frag->fragment_name, where, MYSQL_FRAG_ID, *aggregate_number);
 #endif
-					n = snprintf(create_query, query_buflen, OPH_DC_SQ_APPLY_PLUGIN_WG, new_frag_name, MYSQL_FRAG_ID, *aggregate_number, operation, MYSQL_FRAG_ID,
-						     MYSQL_FRAG_MEASURE, old_frag->fragment_name, where, MYSQL_FRAG_ID, *aggregate_number);
+					res = oph_ioserver_setup_query_template(server, OPH_DC_SQ_APPLY_PLUGIN_WG, 1, NULL, &query, new_frag_name, MYSQL_FRAG_ID, *aggregate_number, operation, MYSQL_FRAG_ID,
+										MYSQL_FRAG_MEASURE, old_frag->fragment_name, where, MYSQL_FRAG_ID, *aggregate_number);
 				}
 			} else {
 #ifdef OPH_DEBUG_MYSQL
 				printf("ORIGINAL QUERY: " MYSQL_DC_APPLY_PLUGIN_W "\n", new_frag_name, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE, MYSQL_FRAG_ID, operation, MYSQL_FRAG_MEASURE,
 				       old_frag->fragment_name, where);
 #endif
-				n = snprintf(create_query, query_buflen, OPH_DC_SQ_APPLY_PLUGIN_W, new_frag_name, operation, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE, old_frag->fragment_name, where);
+				res = oph_ioserver_setup_query_template(server, OPH_DC_SQ_APPLY_PLUGIN_W, 1, NULL, &query, new_frag_name, operation, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE, old_frag->fragment_name, where);
 			}
 		} else {
 			if (aggregate_number) {
@@ -567,39 +691,33 @@ int oph_dc_create_fragment_from_query2(oph_ioserver_handler * server, oph_odb_fr
 					printf("ORIGINAL QUERY: " MYSQL_DC_APPLY_PLUGIN_GB "\n", new_frag_name, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE, MYSQL_FRAG_ID, *aggregate_number, *block_size,
 					       MYSQL_FRAG_ID, operation, MYSQL_FRAG_MEASURE, old_frag->fragment_name, MYSQL_FRAG_ID, *aggregate_number, *block_size);
 #endif
-					n = snprintf(create_query, query_buflen, OPH_DC_SQ_APPLY_PLUGIN_GB, new_frag_name, MYSQL_FRAG_ID, *aggregate_number, *block_size, operation, MYSQL_FRAG_ID,
-						     MYSQL_FRAG_MEASURE, old_frag->fragment_name, MYSQL_FRAG_ID, *aggregate_number, *block_size);
+					res = oph_ioserver_setup_query_template(server, OPH_DC_SQ_APPLY_PLUGIN_GB, 1, NULL, &query, new_frag_name, MYSQL_FRAG_ID, *aggregate_number, *block_size, operation, MYSQL_FRAG_ID,
+										MYSQL_FRAG_MEASURE, old_frag->fragment_name, MYSQL_FRAG_ID, *aggregate_number, *block_size);
 				} else {
 #ifdef OPH_DEBUG_MYSQL
 					printf("ORIGINAL QUERY: " MYSQL_DC_APPLY_PLUGIN_G "\n", new_frag_name, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE, MYSQL_FRAG_ID, *aggregate_number, MYSQL_FRAG_ID,
 					       operation, MYSQL_FRAG_MEASURE, old_frag->fragment_name, MYSQL_FRAG_ID, *aggregate_number);
 #endif
-					n = snprintf(create_query, query_buflen, OPH_DC_SQ_APPLY_PLUGIN_G, new_frag_name, MYSQL_FRAG_ID, *aggregate_number, operation, MYSQL_FRAG_ID,
-						     MYSQL_FRAG_MEASURE, old_frag->fragment_name, MYSQL_FRAG_ID, *aggregate_number);
+					res = oph_ioserver_setup_query_template(server, OPH_DC_SQ_APPLY_PLUGIN_G, 1, NULL, &query, new_frag_name, MYSQL_FRAG_ID, *aggregate_number, operation, MYSQL_FRAG_ID,
+										MYSQL_FRAG_MEASURE, old_frag->fragment_name, MYSQL_FRAG_ID, *aggregate_number);
 				}
 			} else {
 #ifdef OPH_DEBUG_MYSQL
 				printf("ORIGINAL QUERY: " MYSQL_DC_APPLY_PLUGIN "\n", new_frag_name, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE, MYSQL_FRAG_ID, operation, MYSQL_FRAG_MEASURE,
 				       old_frag->fragment_name);
 #endif
-				n = snprintf(create_query, query_buflen, OPH_DC_SQ_APPLY_PLUGIN, new_frag_name, MYSQL_FRAG_ID, operation, MYSQL_FRAG_MEASURE, old_frag->fragment_name);
+				res = oph_ioserver_setup_query_template(server, OPH_DC_SQ_APPLY_PLUGIN, 1, NULL, &query, new_frag_name, MYSQL_FRAG_ID, operation, MYSQL_FRAG_MEASURE, old_frag->fragment_name);
 			}
 
 		}
 
-		if (n >= query_buflen) {
-			pmesg(LOG_ERROR, __FILE__, __LINE__, "Size of query exceed query limit.\n");
+		if (res) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to setup query '%s'\n", operation);
 			return OPH_DC_SERVER_ERROR;
 		}
 
-		oph_ioserver_query *query = NULL;
-		if (oph_ioserver_setup_query(server, create_query, 1, NULL, &query)) {
-			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to setup query '%s'\n", create_query);
-			return OPH_DC_SERVER_ERROR;
-		}
-
-		if (oph_ioserver_execute_query(server, query)) {
-			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to execute operation '%s',\n", create_query);
+		if (_oph_dc_execute_query(server, query, "create_fragment", old_frag, operation, -1, -1)) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to execute operation '%s',\n", operation);
 			oph_ioserver_free_query(server, query);
 			return OPH_DC_SERVER_ERROR;
 		}
@@ -700,7 +818,7 @@ int oph_dc_create_fragment_from_query_with_params2(oph_ioserver_handler * server
 			return OPH_DC_SERVER_ERROR;
 		}
 
-		if (oph_ioserver_execute_query(server, query)) {
+		if (_oph_dc_execute_query(server, query, "create_fragment", old_frag, create_query, -1, -1)) {
 			pmesg(LOG_ERROR, __FILE__, __LINE__, "Cannot execute query\n");
 			for (ii = 0; ii < num; ii++)
 				if (args[ii])
@@ -718,38 +836,15 @@ int oph_dc_create_fragment_from_query_with_params2(oph_ioserver_handler * server
 
 	} else {
 
-		if (where) {
-			if (aggregate_number) {
-				if (block_size) {
-					query_buflen = 1 + snprintf(NULL, 0, OPH_DC_SQ_APPLY_PLUGIN_WGB, new_frag_name, MYSQL_FRAG_ID, *aggregate_number, *block_size, operation, MYSQL_FRAG_ID,
-								    MYSQL_FRAG_MEASURE, old_frag->fragment_name, where, MYSQL_FRAG_ID, *aggregate_number, *block_size);
-				} else {
-					query_buflen = 1 + snprintf(NULL, 0, OPH_DC_SQ_APPLY_PLUGIN_WG, new_frag_name, MYSQL_FRAG_ID, *aggregate_number, operation, MYSQL_FRAG_ID,
-								    MYSQL_FRAG_MEASURE, old_frag->fragment_name, where, MYSQL_FRAG_ID, *aggregate_number);
-				}
-			} else {
-				query_buflen = 1 + snprintf(NULL, 0, OPH_DC_SQ_APPLY_PLUGIN_W, new_frag_name, operation, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE, old_frag->fragment_name, where);
-			}
-		} else {
-			if (aggregate_number) {
-				if (block_size) {
-					query_buflen = 1 + snprintf(NULL, 0, OPH_DC_SQ_APPLY_PLUGIN_GB, new_frag_name, MYSQL_FRAG_ID, *aggregate_number, *block_size, operation, MYSQL_FRAG_ID,
-								    MYSQL_FRAG_MEASURE, old_frag->fragment_name, MYSQL_FRAG_ID, *aggregate_number, *block_size);
-				} else {
-					query_buflen = 1 + snprintf(NULL, 0, OPH_DC_SQ_APPLY_PLUGIN_G, new_frag_name, MYSQL_FRAG_ID, *aggregate_number, operation, MYSQL_FRAG_ID,
-								    MYSQL_FRAG_MEASURE, old_frag->fragment_name, MYSQL_FRAG_ID, *aggregate_number);
-				}
-			} else {
-				query_buflen = 1 + snprintf(NULL, 0, OPH_DC_SQ_APPLY_PLUGIN, new_frag_name, MYSQL_FRAG_ID, operation, MYSQL_FRAG_MEASURE, old_frag->fragment_name);
-			}
-		}
+		int res;
 
-		if (query_buflen >= max_size) {
-			pmesg(LOG_ERROR, __FILE__, __LINE__, "Buffer size (%ld bytes) is too small.\n", max_size);
-			return OPH_DC_SERVER_ERROR;
+		for (ii = 0; ii < num; ii++) {
+			args[ii]->arg_length = param_size;
+			args[ii]->arg_type = OPH_IOSERVER_TYPE_BLOB;
+			args[ii]->arg_is_null = nn;
+			args[ii]->arg = param;
 		}
 
-		char create_query[query_buflen];
 		if (where) {
 			if (aggregate_number) {
 				if (block_size) {
@@ -757,22 +852,22 @@ int oph_dc_create_fragment_from_query_with_params2(oph_ioserver_handler * server
 					printf("ORIGINAL QUERY: " MYSQL_DC_APPLY_PLUGIN_WGB "\n", new_frag_name, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE, MYSQL_FRAG_ID, *aggregate_number, *block_size,
 					       MYSQL_FRAG_ID, operation, MYSQL_FRAG_MEASURE, old_frag->fragment_name, where, MYSQL_FRAG_ID, *aggregate_number, *block_size);
 #endif
-					n = snprintf(create_query, query_buflen, OPH_DC_SQ_APPLY_PLUGIN_WGB, new_frag_name, MYSQL_FRAG_ID, *aggregate_number, *block_size, operation, MYSQL_FRAG_ID,
-						     MYSQL_FRAG_MEASURE, old_frag->fragment_name, where, MYSQL_FRAG_ID, *aggregate_number, *block_size);
+					res = oph_ioserver_setup_query_template(server, OPH_DC_SQ_APPLY_PLUGIN_WGB, 1, args, &query, new_frag_name, MYSQL_FRAG_ID, *aggregate_number, *block_size, operation, MYSQL_FRAG_ID,
+										MYSQL_FRAG_MEASURE, old_frag->fragment_name, where, MYSQL_FRAG_ID, *aggregate_number, *block_size);
 				} else {
 #ifdef OPH_DEBUG_MYSQL
 					printf("ORIGINAL QUERY: " MYSQL_DC_APPLY_PLUGIN_WG "\n", new_frag_name, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE, MYSQL_FRAG_ID, *aggregate_number, MYSQL_FRAG_ID,
 					       operation, MYSQL_FRAG_MEASURE, old_frag->fragment_name, where, MYSQL_FRAG_ID, *aggregate_number);
 #endif
-					n = snprintf(create_query, query_buflen, OPH_DC_SQ_APPLY_PLUGIN_WG, new_frag_name, MYSQL_FRAG_ID, *aggregate_number, operation, MYSQL_FRAG_ID,
-						     MYSQL_FRAG_MEASURE, old_frag->fragment_name, where, MYSQL_FRAG_ID, *aggregate_number);
+					res = oph_ioserver_setup_query_template(server, OPH_DC_SQ_APPLY_PLUGIN_WG, 1, args, &query, new_frag_name, MYSQL_FRAG_ID, *aggregate_number, operation, MYSQL_FRAG_ID,
+										MYSQL_FRAG_MEASURE, old_frag->fragment_name, where, MYSQL_FRAG_ID, *aggregate_number);
 				}
 			} else {
 #ifdef OPH_DEBUG_MYSQL
 				printf("ORIGINAL QUERY: " MYSQL_DC_APPLY_PLUGIN_W "\n", new_frag_name, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE, MYSQL_FRAG_ID, operation, MYSQL_FRAG_MEASURE,
 				       old_frag->fragment_name, where);
 #endif
-				n = snprintf(create_query, query_buflen, OPH_DC_SQ_APPLY_PLUGIN_W, new_frag_name, operation, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE, old_frag->fragment_name, where);
+				res = oph_ioserver_setup_query_template(server, OPH_DC_SQ_APPLY_PLUGIN_W, 1, args, &query, new_frag_name, operation, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE, old_frag->fragment_name, where);
 			}
 		} else {
 			if (aggregate_number) {
@@ -781,38 +876,26 @@ int oph_dc_create_fragment_from_query_with_params2(oph_ioserver_handler * server
 					printf("ORIGINAL QUERY: " MYSQL_DC_APPLY_PLUGIN_GB "\n", new_frag_name, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE, MYSQL_FRAG_ID, *aggregate_number, *block_size,
 					       MYSQL_FRAG_ID, operation, MYSQL_FRAG_MEASURE, old_frag->fragment_name, MYSQL_FRAG_ID, *aggregate_number, *block_size);
 #endif
-					n = snprintf(create_query, query_buflen, OPH_DC_SQ_APPLY_PLUGIN_GB, new_frag_name, MYSQL_FRAG_ID, *aggregate_number, *block_size, operation, MYSQL_FRAG_ID,
-						     MYSQL_FRAG_MEASURE, old_frag->fragment_name, MYSQL_FRAG_ID, *aggregate_number, *block_size);
+					res = oph_ioserver_setup_query_template(server, OPH_DC_SQ_APPLY_PLUGIN_GB, 1, args, &query, new_frag_name, MYSQL_FRAG_ID, *aggregate_number, *block_size, operation, MYSQL_FRAG_ID,
+										MYSQL_FRAG_MEASURE, old_frag->fragment_name, MYSQL_FRAG_ID, *aggregate_number, *block_size);
 				} else {
 #ifdef OPH_DEBUG_MYSQL
 					printf("ORIGINAL QUERY: " MYSQL_DC_APPLY_PLUGIN_G "\n", new_frag_name, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE, MYSQL_FRAG_ID, *aggregate_number, MYSQL_FRAG_ID,
 					       operation, MYSQL_FRAG_MEASURE, old_frag->fragment_name, MYSQL_FRAG_ID, *aggregate_number);
 #endif
-					n = snprintf(create_query, query_buflen, OPH_DC_SQ_APPLY_PLUGIN_G, new_frag_name, MYSQL_FRAG_ID, *aggregate_number, operation, MYSQL_FRAG_ID,
-						     MYSQL_FRAG_MEASURE, old_frag->fragment_name, MYSQL_FRAG_ID, *aggregate_number);
+					res = oph_ioserver_setup_query_template(server, OPH_DC_SQ_APPLY_PLUGIN_G, 1, args, &query, new_frag_name, MYSQL_FRAG_ID, *aggregate_number, operation, MYSQL_FRAG_ID,
+										MYSQL_FRAG_MEASURE, old_frag->fragment_name, MYSQL_FRAG_ID, *aggregate_number);
 				}
 			} else {
 #ifdef OPH_DEBUG_MYSQL
 				printf("ORIGINAL QUERY: " MYSQL_DC_APPLY_PLUGIN "\n", new_frag_name, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE, MYSQL_FRAG_ID, operation, MYSQL_FRAG_MEASURE,
 				       old_frag->fragment_name);
 #endif
-				n = snprintf(create_query, query_buflen, OPH_DC_SQ_APPLY_PLUGIN, new_frag_name, MYSQL_FRAG_ID, operation, MYSQL_FRAG_MEASURE, old_frag->fragment_name);
+				res = oph_ioserver_setup_query_template(server, OPH_DC_SQ_APPLY_PLUGIN, 1, args, &query, new_frag_name, MYSQL_FRAG_ID, operation, MYSQL_FRAG_MEASURE, old_frag->fragment_name);
 			}
 		}
 
-		if (n >= query_buflen) {
-			pmesg(LOG_ERROR, __FILE__, __LINE__, "Size of query exceed query limit.\n");
-			return OPH_DC_SERVER_ERROR;
-		}
-
-		for (ii = 0; ii < num; ii++) {
-			args[ii]->arg_length = param_size;
-			args[ii]->arg_type = OPH_IOSERVER_TYPE_BLOB;
-			args[ii]->arg_is_null = nn;
-			args[ii]->arg = param;
-		}
-
-		if (oph_ioserver_setup_query(server, create_query, 1, args, &query)) {
+		if (res) {
 			pmesg(LOG_ERROR, __FILE__, __LINE__, "Cannot setup query\n");
 			for (ii = 0; ii < num; ii++)
 				if (args[ii])
@@ -821,8 +904,8 @@ int oph_dc_create_fragment_from_query_with_params2(oph_ioserver_handler * server
 			return OPH_DC_SERVER_ERROR;
 		}
 
-		if (oph_ioserver_execute_query(server, query)) {
-			pmesg(LOG_ERROR, __FILE__, __LINE__, "Cannot execute query '%s'\n", create_query);
+		if (_oph_dc_execute_query(server, query, "create_fragment", old_frag, operation, -1, -1)) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Cannot execute query '%s'\n", operation);
 			for (ii = 0; ii < num; ii++)
 				if (args[ii])
 					free(args[ii]);
@@ -925,7 +1008,7 @@ int oph_dc_create_fragment_from_query_with_aggregation2(oph_ioserver_handler * s
 			return OPH_DC_SERVER_ERROR;
 		}
 
-		if (oph_ioserver_execute_query(server, query)) {
+		if (_oph_dc_execute_query(server, query, "create_fragment", old_frag, create_query, -1, -1)) {
 			pmesg(LOG_ERROR, __FILE__, __LINE__, "Cannot execute query\n");
 			for (ii = 0; ii < c_arg; ii++)
 				if (args[ii])
@@ -943,38 +1026,17 @@ int oph_dc_create_fragment_from_query_with_aggregation2(oph_ioserver_handler * s
 
 	} else {
 
-		if (where) {
-			if (aggregate_number) {
-				if (block_size) {
-					query_buflen = 1 + snprintf(NULL, 0, OPH_DC_SQ_APPLY_PLUGIN_WGB2, new_frag_name, MYSQL_FRAG_ID, *block_size, operation, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE,
-								    old_frag->fragment_name, where, MYSQL_FRAG_ID, *block_size);
-				} else {
-					query_buflen = 1 + snprintf(NULL, 0, MYSQL_DC_APPLY_PLUGIN_WG, new_frag_name, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE, MYSQL_FRAG_ID, *aggregate_number,
-								    operation, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE, old_frag->fragment_name, where, MYSQL_FRAG_ID, *aggregate_number);
-				}
-			} else {
-				query_buflen = 1 + snprintf(NULL, 0, OPH_DC_SQ_APPLY_PLUGIN_W, new_frag_name, operation, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE, old_frag->fragment_name, where);
-			}
-		} else {
-			if (aggregate_number) {
-				if (block_size) {
-					query_buflen = 1 + snprintf(NULL, 0, OPH_DC_SQ_APPLY_PLUGIN_GB2, new_frag_name, MYSQL_FRAG_ID, *block_size, operation, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE,
-								    old_frag->fragment_name, MYSQL_FRAG_ID, *block_size);
-				} else {
-					query_buflen = 1 + snprintf(NULL, 0, OPH_DC_SQ_APPLY_PLUGIN_G, new_frag_name, MYSQL_FRAG_ID, *aggregate_number, operation, MYSQL_FRAG_ID,
-								    MYSQL_FRAG_MEASURE, old_frag->fragment_name, MYSQL_FRAG_ID, *aggregate_number);
-				}
-			} else {
-				query_buflen = 1 + snprintf(NULL, 0, OPH_DC_SQ_APPLY_PLUGIN, new_frag_name, MYSQL_FRAG_ID, operation, MYSQL_FRAG_MEASURE, old_frag->fragment_name);
-			}
-		}
+		int res;
 
-		if (query_buflen >= max_size) {
-			pmesg(LOG_ERROR, __FILE__, __LINE__, "Buffer size (%ld bytes) is too small.\n", max_size);
-			return OPH_DC_SERVER_ERROR;
-		}
+		args[0]->arg_length = param_size;
+		args[0]->arg_type = OPH_IOSERVER_TYPE_BLOB;
+		args[0]->arg_is_null = !param;
+		args[0]->arg = param;
 
-		char create_query[query_buflen];
+		args[1]->arg_length = param_size;
+		args[1]->arg_type = OPH_IOSERVER_TYPE_BLOB;
+		args[1]->arg_is_null = !param;
+		args[1]->arg = param;
 
 		if (where) {
 			if (aggregate_number) {
@@ -983,22 +1045,22 @@ int oph_dc_create_fragment_from_query_with_aggregation2(oph_ioserver_handler * s
 					printf("ORIGINAL QUERY: " MYSQL_DC_APPLY_PLUGIN_WGB2 "\n", new_frag_name, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE, MYSQL_FRAG_ID, *block_size, MYSQL_FRAG_ID,
 					       operation, MYSQL_FRAG_MEASURE, old_frag->fragment_name, where, MYSQL_FRAG_ID, *block_size);
 #endif
-					n = snprintf(create_query, query_buflen, OPH_DC_SQ_APPLY_PLUGIN_WGB2, new_frag_name, MYSQL_FRAG_ID, *block_size, operation, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE,
-						     old_frag->fragment_name, where, MYSQL_FRAG_ID, *block_size);
+					res = oph_ioserver_setup_query_template(server, OPH_DC_SQ_APPLY_PLUGIN_WGB2, 1, args, &query, new_frag_name, MYSQL_FRAG_ID, *block_size, operation, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE,
+										old_frag->fragment_name, where, MYSQL_FRAG_ID, *block_size);
 				} else {
 #ifdef OPH_DEBUG_MYSQL
 					printf("ORIGINAL QUERY: " MYSQL_DC_APPLY_PLUGIN_WG "\n", new_frag_name, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE, MYSQL_FRAG_ID, *aggregate_number, MYSQL_FRAG_ID,
 					       operation, MYSQL_FRAG_MEASURE, old_frag->fragment_name, where, MYSQL_FRAG_ID, *aggregate_number);
 #endif
-					n = snprintf(create_query, query_buflen, MYSQL_DC_APPLY_PLUGIN_WG, new_frag_name, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE, MYSQL_FRAG_ID, *aggregate_number,
-						     operation, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE, old_frag->fragment_name, where, MYSQL_FRAG_ID, *aggregate_number);
+					res = oph_ioserver_setup_query_template(server, MYSQL_DC_APPLY_PLUGIN_WG, 1, args, &query, new_frag_name, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE, MYSQL_FRAG_ID, *aggregate_number,
+										operation, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE, old_frag->fragment_name, where, MYSQL_FRAG_ID, *aggregate_number);
 				}
 			} else {
 #ifdef OPH_DEBUG_MYSQL
 				printf("ORIGINAL QUERY: " MYSQL_DC_APPLY_PLUGIN_W "\n", new_frag_name, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE, MYSQL_FRAG_ID, operation, MYSQL_FRAG_MEASURE,
 				       old_frag->fragment_name, where);
 #endif
-				n = snprintf(create_query, query_buflen, OPH_DC_SQ_APPLY_PLUGIN_W, new_frag_name, operation, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE, old_frag->fragment_name, where);
+				res = oph_ioserver_setup_query_template(server, OPH_DC_SQ_APPLY_PLUGIN_W, 1, args, &query, new_frag_name, operation, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE, old_frag->fragment_name, where);
 			}
 		} else {
 			if (aggregate_number) {
@@ -1007,42 +1069,27 @@ int oph_dc_create_fragment_from_query_with_aggregation2(oph_ioserver_handler * s
 					printf("ORIGINAL QUERY: " MYSQL_DC_APPLY_PLUGIN_GB2 "\n", new_frag_name, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE, MYSQL_FRAG_ID, *block_size, MYSQL_FRAG_ID,
 					       operation, MYSQL_FRAG_MEASURE, old_frag->fragment_name, MYSQL_FRAG_ID, *block_size);
 #endif
-					n = snprintf(create_query, query_buflen, OPH_DC_SQ_APPLY_PLUGIN_GB2, new_frag_name, MYSQL_FRAG_ID, *block_size, operation, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE,
-						     old_frag->fragment_name, MYSQL_FRAG_ID, *block_size);
+					res = oph_ioserver_setup_query_template(server, OPH_DC_SQ_APPLY_PLUGIN_GB2, 1, args, &query, new_frag_name, MYSQL_FRAG_ID, *block_size, operation, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE,
+										old_frag->fragment_name, MYSQL_FRAG_ID, *block_size);
 				} else {
 #ifdef OPH_DEBUG_MYSQL
 					printf("ORIGINAL QUERY: " MYSQL_DC_APPLY_PLUGIN_G "\n", new_frag_name, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE, MYSQL_FRAG_ID, *aggregate_number, MYSQL_FRAG_ID,
 					       operation, MYSQL_FRAG_MEASURE, old_frag->fragment_name, MYSQL_FRAG_ID, *aggregate_number);
 #endif
-					n = snprintf(create_query, query_buflen, OPH_DC_SQ_APPLY_PLUGIN_G, new_frag_name, MYSQL_FRAG_ID, *aggregate_number, operation, MYSQL_FRAG_ID,
-						     MYSQL_FRAG_MEASURE, old_frag->fragment_name, MYSQL_FRAG_ID, *aggregate_number);
+					res = oph_ioserver_setup_query_template(server, OPH_DC_SQ_APPLY_PLUGIN_G, 1, args, &query, new_frag_name, MYSQL_FRAG_ID, *aggregate_number, operation, MYSQL_FRAG_ID,
+										MYSQL_FRAG_MEASURE, old_frag->fragment_name, MYSQL_FRAG_ID, *aggregate_number);
 				}
 			} else {
 #ifdef OPH_DEBUG_MYSQL
 				printf("ORIGINAL QUERY: " MYSQL_DC_APPLY_PLUGIN "\n", new_frag_name, MYSQL_FRAG_ID, MYSQL_FRAG_MEASURE, MYSQL_FRAG_ID, operation, MYSQL_FRAG_MEASURE,
 				       old_frag->fragment_name);
 #endif
-				n = snprintf(create_query, query_buflen, OPH_DC_SQ_APPLY_PLUGIN, new_frag_name, MYSQL_FRAG_ID, operation, MYSQL_FRAG_MEASURE, old_frag->fragment_name);
+				res = oph_ioserver_setup_query_template(server, OPH_DC_SQ_APPLY_PLUGIN, 1, args, &query, new_frag_name, MYSQL_FRAG_ID, operation, MYSQL_FRAG_MEASURE, old_frag->fragment_name);
 			}
 		}
 
-		if (n >= query_buflen) {
-			pmesg(LOG_ERROR, __FILE__, __LINE__, "Size of query exceed query limit.\n");
-			return OPH_DC_SERVER_ERROR;
-		}
-
-		args[0]->arg_length = param_size;
-		args[0]->arg_type = OPH_IOSERVER_TYPE_BLOB;
-		args[0]->arg_is_null = n;
-		args[0]->arg = param;
-
-		args[1]->arg_length = param_size;
-		args[1]->arg_type = OPH_IOSERVER_TYPE_BLOB;
-		args[1]->arg_is_null = n;
-		args[1]->arg = param;
-
-		if (oph_ioserver_setup_query(server, create_query, 1, args, &query)) {
-			pmesg(LOG_ERROR, __FILE__, __LINE__, "Cannot setup query '%s'\n", create_query);
+		if (res) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Cannot setup query '%s'\n", operation);
 			for (ii = 0; ii < c_arg; ii++)
 				if (args[ii])
 					free(args[ii]);
@@ -1050,8 +1097,8 @@ int oph_dc_create_fragment_from_query_with_aggregation2(oph_ioserver_handler * s
 			return OPH_DC_SERVER_ERROR;
 		}
 
-		if (oph_ioserver_execute_query(server, query)) {
-			pmesg(LOG_ERROR, __FILE__, __LINE__, "Cannot execute query '%s'\n", query);
+		if (_oph_dc_execute_query(server, query, "create_fragment", old_frag, operation, -1, -1)) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Cannot execute query '%s'\n", operation);
 			for (ii = 0; ii < c_arg; ii++)
 				if (args[ii])
 					free(args[ii]);
@@ -1071,254 +1118,80 @@ int oph_dc_create_fragment_from_query_with_aggregation2(oph_ioserver_handler * s
 	return OPH_DC_SUCCESS;
 }
 
-int _oph_dc_build_rand_row(char *binary, int array_length, char type_flag, char rand_alg)
+// Counter-based generator: each value only depends on seed, row identifier and position in the row, so that data are the same regardless of the number of processes and threads
+static inline unsigned long long _oph_dc_rand_mix(unsigned long long z)
 {
+	z += OPH_DC_RAND_GOLDEN;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
 
-	if (!binary || !array_length) {
-		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
-		return OPH_DC_NULL_PARAM;
+// Store values converted to a given type; memcpy is used since rows are not aligned
+#define OPH_DC_RAND_STORE(type) \
+	for (m = 0; m < array_length; m++) { \
+		type measure = (type) values[m]; \
+		memcpy(binary + m * sizeof(type), &measure, sizeof(type)); \
 	}
 
-	int m = 0, res = 0;
-	double rand_mes;
-
-	if (type_flag == OPH_DC_BYTE_FLAG) {
-		char measure_b;
-		if (rand_alg == 0) {
-			for (m = 0; m < array_length; m++) {
-				measure_b = (char) ceil(((float) rand() / RAND_MAX) * 1000.0);
-				res = oph_iob_bin_array_add_b(binary, &measure_b, (long long) m);
-
-				if (res) {
-					pmesg(LOG_ERROR, __FILE__, __LINE__, "Error in binary array filling: %d\n", res);
-					return OPH_DC_SERVER_ERROR;
-				}
-			}
-		} else {
-			rand_mes = ((float) rand() / RAND_MAX) * 40.0 - 5.0;
-			measure_b = (char) ceil(rand_mes);
-			res = oph_iob_bin_array_add_b(binary, &measure_b, (long long) 0);
-
-			if (res) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Error in binary array filling: %d\n", res);
-				return OPH_DC_SERVER_ERROR;
-			}
-
-			for (m = 1; m < array_length; m++) {
-				rand_mes = rand_mes * 0.9 + 0.1 * (((float) rand() / RAND_MAX) * 40.0 - 5.0);
-				measure_b = (char) ceil(rand_mes);
-				res = oph_iob_bin_array_add_b(binary, &measure_b, (long long) m);
-
-				if (res) {
-					pmesg(LOG_ERROR, __FILE__, __LINE__, "Error in binary array filling: %d\n", res);
-					return OPH_DC_SERVER_ERROR;
-				}
-			}
-		}
-	} else if (type_flag == OPH_DC_SHORT_FLAG) {
-		short measure_s;
-		if (rand_alg == 0) {
-			for (m = 0; m < array_length; m++) {
-				measure_s = (short) ceil(((float) rand() / RAND_MAX) * 1000.0);
-				res = oph_iob_bin_array_add_s(binary, &measure_s, (long long) m);
-
-				if (res) {
-					pmesg(LOG_ERROR, __FILE__, __LINE__, "Error in binary array filling: %d\n", res);
-					return OPH_DC_SERVER_ERROR;
-				}
-			}
-		} else {
-			rand_mes = ((float) rand() / RAND_MAX) * 40.0 - 5.0;
-			measure_s = (short) ceil(rand_mes);
-			res = oph_iob_bin_array_add_s(binary, &measure_s, (long long) 0);
-
-			if (res) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Error in binary array filling: %d\n", res);
-				return OPH_DC_SERVER_ERROR;
-			}
-
-			for (m = 1; m < array_length; m++) {
-				rand_mes = rand_mes * 0.9 + 0.1 * (((float) rand() / RAND_MAX) * 40.0 - 5.0);
-				measure_s = (short) ceil(rand_mes);
-				res = oph_iob_bin_array_add_s(binary, &measure_s, (long long) m);
-
-				if (res) {
-					pmesg(LOG_ERROR, __FILE__, __LINE__, "Error in binary array filling: %d\n", res);
-					return OPH_DC_SERVER_ERROR;
-				}
-			}
-		}
-	} else if (type_flag == OPH_DC_INT_FLAG) {
-		int measure_i;
-		if (rand_alg == 0) {
-			for (m = 0; m < array_length; m++) {
-				measure_i = (int) ceil(((float) rand() / RAND_MAX) * 1000.0);
-				res = oph_iob_bin_array_add_i(binary, &measure_i, (long long) m);
-
-				if (res) {
-					pmesg(LOG_ERROR, __FILE__, __LINE__, "Error in binary array filling: %d\n", res);
-					return OPH_DC_SERVER_ERROR;
-				}
-			}
-		} else {
-			rand_mes = ((float) rand() / RAND_MAX) * 40.0 - 5.0;
-			measure_i = (int) ceil(rand_mes);
-			res = oph_iob_bin_array_add_i(binary, &measure_i, (long long) 0);
-
-			if (res) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Error in binary array filling: %d\n", res);
-				return OPH_DC_SERVER_ERROR;
-			}
-
-			for (m = 1; m < array_length; m++) {
-				rand_mes = rand_mes * 0.9 + 0.1 * (((float) rand() / RAND_MAX) * 40.0 - 5.0);
-				measure_i = (int) ceil(rand_mes);
-				res = oph_iob_bin_array_add_i(binary, &measure_i, (long long) m);
-
-				if (res) {
-					pmesg(LOG_ERROR, __FILE__, __LINE__, "Error in binary array filling: %d\n", res);
-					return OPH_DC_SERVER_ERROR;
-				}
-			}
-		}
-	} else if (type_flag == OPH_DC_LONG_FLAG) {
-		long long measure_l;
-		if (rand_alg == 0) {
-			for (m = 0; m < array_length; m++) {
-				measure_l = (long long) ceil(((double) rand() / RAND_MAX) * 1000.0);
-				res = oph_iob_bin_array_add_l(binary, &measure_l, (long long) m);
-
-				if (res) {
-					pmesg(LOG_ERROR, __FILE__, __LINE__, "Error in binary array filling: %d\n", res);
-					return OPH_DC_SERVER_ERROR;
-				}
-			}
-		} else {
-			rand_mes = ((float) rand() / RAND_MAX) * 40.0 - 5.0;
-			measure_l = (long long) ceil(rand_mes);
-			res = oph_iob_bin_array_add_l(binary, &measure_l, (long long) 0);
-
-			if (res) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Error in binary array filling: %d\n", res);
-				return OPH_DC_SERVER_ERROR;
-			}
-
-			for (m = 1; m < array_length; m++) {
-				rand_mes = rand_mes * 0.9 + 0.1 * (((float) rand() / RAND_MAX) * 40.0 - 5.0);
-				measure_l = (long long) ceil(rand_mes);
-				res = oph_iob_bin_array_add_l(binary, &measure_l, (long long) m);
-
-				if (res) {
-					pmesg(LOG_ERROR, __FILE__, __LINE__, "Error in binary array filling: %d\n", res);
-					return OPH_DC_SERVER_ERROR;
-				}
-			}
-		}
-	} else if (type_flag == OPH_DC_FLOAT_FLAG) {
-		float measure_f;
-		if (rand_alg == 0) {
-			for (m = 0; m < array_length; m++) {
-				measure_f = ((float) rand() / RAND_MAX) * 1000.0;
-				res = oph_iob_bin_array_add_f(binary, &measure_f, (long long) m);
-
-				if (res) {
-					pmesg(LOG_ERROR, __FILE__, __LINE__, "Error in binary array filling: %d\n", res);
-					return OPH_DC_SERVER_ERROR;
-				}
-			}
-		} else {
-			rand_mes = ((float) rand() / RAND_MAX) * 40.0 - 5.0;
-			measure_f = (float) rand_mes;
-			res = oph_iob_bin_array_add_f(binary, &measure_f, (long long) 0);
-
-			if (res) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Error in binary array filling: %d\n", res);
-				return OPH_DC_SERVER_ERROR;
-			}
-
-			for (m = 1; m < array_length; m++) {
-				rand_mes = rand_mes * 0.9 + 0.1 * (((float) rand() / RAND_MAX) * 40.0 - 5.0);
-				measure_f = (float) rand_mes;
-				res = oph_iob_bin_array_add_f(binary, &measure_f, (long long) m);
-
-				if (res) {
-					pmesg(LOG_ERROR, __FILE__, __LINE__, "Error in binary array filling: %d\n", res);
-					return OPH_DC_SERVER_ERROR;
-				}
-			}
-		}
-	} else if (type_flag == OPH_DC_DOUBLE_FLAG) {
-		double measure_d;
-		if (rand_alg == 0) {
-			for (m = 0; m < array_length; m++) {
-				measure_d = ((double) rand() / RAND_MAX) * 1000.0;
-				res = oph_iob_bin_array_add_d(binary, &measure_d, (long long) m);
-
-				if (res) {
-					pmesg(LOG_ERROR, __FILE__, __LINE__, "Error in binary array filling: %d\n", res);
-					return OPH_DC_SERVER_ERROR;
-				}
-			}
-		} else {
-			rand_mes = ((double) rand() / RAND_MAX) * 40.0 - 5.0;
-			measure_d = rand_mes;
-			res = oph_iob_bin_array_add_d(binary, &measure_d, (long long) 0);
-
-			if (res) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Error in binary array filling: %d\n", res);
-				return OPH_DC_SERVER_ERROR;
-			}
-
-			for (m = 1; m < array_length; m++) {
-				rand_mes = rand_mes * 0.9 + 0.1 * (((double) rand() / RAND_MAX) * 40.0 - 5.0);
-				measure_d = rand_mes;
-				res = oph_iob_bin_array_add_d(binary, &measure_d, (long long) m);
+int _oph_dc_build_rand_row(char *binary, int array_length, char type_flag, char rand_alg, unsigned long long seed, unsigned long long row_id, double *values)
+{
 
-				if (res) {
-					pmesg(LOG_ERROR, __FILE__, __LINE__, "Error in binary array filling: %d\n", res);
-					return OPH_DC_SERVER_ERROR;
-				}
-			}
-		}
-	} else if (type_flag == OPH_DC_BIT_FLAG) {
-		char measure_c;
-		if (rand_alg == 0) {
-			for (m = 0; m < array_length; m++) {
-				measure_c = (char) ceil(((float) rand() / RAND_MAX) * 1000.0);
-				res = oph_iob_bin_array_add_c(binary, &measure_c, (long long) m);
+	if (!binary || !array_length || !values) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_DC_NULL_PARAM;
+	}
 
-				if (res) {
-					pmesg(LOG_ERROR, __FILE__, __LINE__, "Error in binary array filling: %d\n", res);
-					return OPH_DC_SERVER_ERROR;
-				}
-			}
-		} else {
-			rand_mes = ((float) rand() / RAND_MAX) * 40.0 - 5.0;
-			measure_c = (char) ceil(rand_mes);
-			res = oph_iob_bin_array_add_c(binary, &measure_c, (long long) 0);
+	int m = 0;
+	char integer = (type_flag != OPH_DC_FLOAT_FLAG) && (type_flag != OPH_DC_DOUBLE_FLAG);
+	unsigned long long key = _oph_dc_rand_mix(seed ^ _oph_dc_rand_mix(row_id));
 
-			if (res) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Error in binary array filling: %d\n", res);
-				return OPH_DC_SERVER_ERROR;
-			}
+	//Uniform values in [0, 1)
+	for (m = 0; m < array_length; m++)
+		values[m] = (_oph_dc_rand_mix(key + m * OPH_DC_RAND_GOLDEN) >> 11) * OPH_DC_RAND_UNIT;
 
-			for (m = 1; m < array_length; m++) {
-				rand_mes = rand_mes * 0.9 + 0.1 * (((float) rand() / RAND_MAX) * 40.0 - 5.0);
-				measure_c = (char) ceil(rand_mes);
-				res = oph_iob_bin_array_add_c(binary, &measure_c, (long long) m);
+	if (rand_alg == 0) {
+		for (m = 0; m < array_length; m++)
+			values[m] *= 1000.0;
+	} else {
+		//First order auto-regressive model
+		values[0] = values[0] * 40.0 - 5.0;
+		for (m = 1; m < array_length; m++)
+			values[m] = values[m - 1] * 0.9 + 0.1 * (values[m] * 40.0 - 5.0);
+	}
+	if (integer)
+		for (m = 0; m < array_length; m++)
+			values[m] = ceil(values[m]);
 
-				if (res) {
-					pmesg(LOG_ERROR, __FILE__, __LINE__, "Error in binary array filling: %d\n", res);
-					return OPH_DC_SERVER_ERROR;
-				}
-			}
-		}
+	switch (type_flag) {
+		case OPH_DC_BYTE_FLAG:
+		case OPH_DC_BIT_FLAG:
+			OPH_DC_RAND_STORE(char)
+			    break;
+		case OPH_DC_SHORT_FLAG:
+			OPH_DC_RAND_STORE(short)
+			    break;
+		case OPH_DC_INT_FLAG:
+			OPH_DC_RAND_STORE(int)
+			    break;
+		case OPH_DC_LONG_FLAG:
+			OPH_DC_RAND_STORE(long long)
+			    break;
+		case OPH_DC_FLOAT_FLAG:
+			OPH_DC_RAND_STORE(float)
+			    break;
+		case OPH_DC_DOUBLE_FLAG:
+			OPH_DC_RAND_STORE(double)
+			    break;
+		default:
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Type not supported\n");
+			return OPH_DC_DATA_ERROR;
 	}
 
 	return OPH_DC_SUCCESS;
 }
 
-int oph_dc_populate_fragment_with_rand_data(oph_ioserver_handler * server, oph_odb_fragment * frag, unsigned long long tuple_number, int array_length, char *data_type, int compressed, char *algorithm)
+int oph_dc_populate_fragment_with_rand_data(oph_ioserver_handler * server, oph_odb_fragment * frag, unsigned long long tuple_number, int array_length, char *data_type, int compressed, char *algorithm, unsigned long long seed)
 {
 	if (!frag || !data_type || !server || !algorithm) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
@@ -1461,6 +1334,15 @@ int oph_dc_populate_fragment_with_rand_data(oph_ioserver_handler * server, oph_o
 		free(idDim);
 		return OPH_DC_DATA_ERROR;
 	}
+	//Values of a row before conversion to the data type
+	double *values = (double *) malloc(array_length * sizeof(double));
+	if (!values) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Error allocating memory\n");
+		free(binary);
+		free(query_string);
+		free(idDim);
+		return OPH_DC_DATA_ERROR;
+	}
 
 	unsigned long long c_arg = regular_rows * 2;
 	oph_ioserver_query *query = NULL;
@@ -1469,6 +1351,7 @@ int oph_dc_populate_fragment_with_rand_data(oph_ioserver_handler * server, oph_o
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Error allocating memory\n");
 		free(query_string);
 		free(binary);
+		free(values);
 		free(idDim);
 		return OPH_DC_DATA_ERROR;
 	}
@@ -1480,6 +1363,7 @@ int oph_dc_populate_fragment_with_rand_data(oph_ioserver_handler * server, oph_o
 			free(query_string);
 			free(idDim);
 			free(binary);
+			free(values);
 			for (i = 0; i < c_arg; i++)
 				if (args[i])
 					free(args[i]);
@@ -1508,6 +1392,7 @@ int oph_dc_populate_fragment_with_rand_data(oph_ioserver_handler * server, oph_o
 		free(query_string);
 		free(idDim);
 		free(binary);
+		free(values);
 		for (i = 0; i < c_arg; i++)
 			if (args[i])
 				free(args[i]);
@@ -1515,18 +1400,22 @@ int oph_dc_populate_fragment_with_rand_data(oph_ioserver_handler * server, oph_o
 		return OPH_DC_DATA_ERROR;
 	}
 
-	struct timeval time;
-	gettimeofday(&time, NULL);
-	srand(time.tv_sec * 1000000 + time.tv_usec);
+	struct timeval start_time, end_time;
+	double generation_time = 0.0;
+	oph_trace_span span;
+	oph_trace_args trace_args = { frag->id_fragment, NULL, NULL, (long long) regular_rows, (long long) (regular_rows * sizeof_var) };
 
-	//Fill array
+	//Fill array: rows are identified by their keys, so values do not depend on fragmentation
 	for (k = 0; k < regular_times; k++) {
+		oph_trace_begin(&span);
+		gettimeofday(&start_time, NULL);
 		for (j = 0; j < regular_rows; j++) {
-			if (_oph_dc_build_rand_row(binary + j * sizeof_var, array_length, type_flag, rand_alg)) {
+			if (_oph_dc_build_rand_row(binary + j * sizeof_var, array_length, type_flag, rand_alg, seed, idDim[j], values)) {
 				pmesg(LOG_ERROR, __FILE__, __LINE__, "Error in binary array filling: %d\n", res);
 				free(query_string);
 				free(idDim);
 				free(binary);
+				free(values);
 				for (i = 0; i < c_arg; i++)
 					if (args[i])
 						free(args[i]);
@@ -1535,12 +1424,16 @@ int oph_dc_populate_fragment_with_rand_data(oph_ioserver_handler * server, oph_o
 				return OPH_DC_SERVER_ERROR;
 			}
 		}
+		gettimeofday(&end_time, NULL);
+		generation_time += (end_time.tv_sec - start_time.tv_sec) + (end_time.tv_usec - start_time.tv_usec) / 1000000.0;
+		oph_trace_end(&span, OPH_TRACE_CATEGORY_PHASE, "generate_rows", &trace_args);
 
-		if (oph_ioserver_execute_query(server, query)) {
+		if (_oph_dc_execute_query(server, query, "populate_fragment", frag, query_string, (long long) regular_rows, (long long) (regular_rows * sizeof_var))) {
 			pmesg(LOG_ERROR, __FILE__, __LINE__, "Cannot execute query\n");
 			free(query_string);
 			free(idDim);
 			free(binary);
+			free(values);
 			for (i = 0; i < c_arg; i++)
 				if (args[i])
 					free(args[i]);
@@ -1568,6 +1461,7 @@ int oph_dc_populate_fragment_with_rand_data(oph_ioserver_handler * server, oph_o
 			free(query_string);
 			free(idDim);
 			free(binary);
+			free(values);
 			for (i = 0; i < c_arg; i++)
 				if (args[i])
 					free(args[i]);
@@ -1609,6 +1503,7 @@ int oph_dc_populate_fragment_with_rand_data(oph_ioserver_handler * server, oph_o
 			free(query_string);
 			free(idDim);
 			free(binary);
+			free(values);
 			for (i = 0; i < c_arg; i++)
 				if (args[i])
 					free(args[i]);
@@ -1616,12 +1511,17 @@ int oph_dc_populate_fragment_with_rand_data(oph_ioserver_handler * server, oph_o
 			return OPH_DC_DATA_ERROR;
 		}
 
+		trace_args.rows = (long long) remainder_rows;
+		trace_args.bytes = (long long) (remainder_rows * sizeof_var);
+		oph_trace_begin(&span);
+		gettimeofday(&start_time, NULL);
 		for (j = 0; j < remainder_rows; j++) {
-			if (_oph_dc_build_rand_row(binary + j * sizeof_var, array_length, type_flag, rand_alg)) {
+			if (_oph_dc_build_rand_row(binary + j * sizeof_var, array_length, type_flag, rand_alg, seed, idDim[j], values)) {
 				pmesg(LOG_ERROR, __FILE__, __LINE__, "Error in binary array filling: %d\n", res);
 				free(query_string);
 				free(idDim);
 				free(binary);
+				free(values);
 				for (i = 0; i < c_arg; i++)
 					if (args[i])
 						free(args[i]);
@@ -1630,12 +1530,16 @@ int oph_dc_populate_fragment_with_rand_data(oph_ioserver_handler * server, oph_o
 				return OPH_DC_SERVER_ERROR;
 			}
 		}
+		gettimeofday(&end_time, NULL);
+		generation_time += (end_time.tv_sec - start_time.tv_sec) + (end_time.tv_usec - start_time.tv_usec) / 1000000.0;
+		oph_trace_end(&span, OPH_TRACE_CATEGORY_PHASE, "generate_rows", &trace_args);
 
-		if (oph_ioserver_execute_query(server, query)) {
+		if (_oph_dc_execute_query(server, query, "populate_fragment", frag, query_string, (long long) remainder_rows, (long long) (remainder_rows * sizeof_var))) {
 			pmesg(LOG_ERROR, __FILE__, __LINE__, "Cannot execute query\n");
 			free(query_string);
 			free(idDim);
 			free(binary);
+			free(values);
 			for (i = 0; i < c_arg; i++)
 				if (args[i])
 					free(args[i]);
@@ -1647,10 +1551,14 @@ int oph_dc_populate_fragment_with_rand_data(oph_ioserver_handler * server, oph_o
 		oph_ioserver_free_query(server, query);
 	}
 
+	pmesg(LOG_DEBUG, __FILE__, __LINE__, "Generated %llu bytes of random data in %.6f s (%.3f GB/s)\n", tuple_number * sizeof_var, generation_time,
+	      generation_time > 0.0 ? tuple_number * sizeof_var / generation_time / 1000000000.0 : 0.0);
+
 	if (query_string)
 		free(query_string);
 	free(idDim);
 	free(binary);
+	free(values);
 	for (i = 0; i < c_arg; i++)
 		if (args[i])
 			free(args[i]);
@@ -1709,7 +1617,7 @@ int oph_dc_populate_fragment_with_rand_data2(oph_ioserver_handler * server, oph_
 		return OPH_DC_SERVER_ERROR;
 	}
 
-	if (oph_ioserver_execute_query(server, query)) {
+	if (_oph_dc_execute_query(server, query, "populate_fragment", frag, query_string, (long long) tuple_number, -1)) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to execute operation.\n");
 		free(query_string);
 		oph_ioserver_free_query(server, query);
@@ -1722,6 +1630,31 @@ int oph_dc_populate_fragment_with_rand_data2(oph_ioserver_handler * server, oph_
 	return OPH_DC_SUCCESS;
 }
 
+int _oph_dc_enlarge_blob_arg(oph_ioserver_handler * server, const char *operation, unsigned long long tot_rows, oph_ioserver_query_arg ** args, int index, unsigned long long size,
+			     oph_ioserver_query ** query)
+{
+	char *binary = (char *) realloc(args[index]->arg, size);
+	if (!binary) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Cannot allocate data buffers\n");
+		return OPH_DC_DATA_ERROR;
+	}
+	args[index]->arg = binary;
+	args[index]->arg_length = size;
+
+	//Bindings refer to the old buffer, so the query has to be set up again
+	if (*query) {
+		oph_ioserver_free_query(server, *query);
+		*query = NULL;
+	}
+	if (oph_ioserver_setup_query(server, operation, tot_rows, args, query)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Cannot setup query\n");
+		*query = NULL;
+		return OPH_DC_SERVER_ERROR;
+	}
+
+	return OPH_DC_SUCCESS;
+}
+
 int oph_dc_append_fragment_to_fragment(oph_ioserver_handler * input_server, oph_ioserver_handler * output_server, unsigned long long tot_rows, short int exec_flag, oph_odb_fragment * new_frag,
 				       oph_odb_fragment * old_frag, long long *first_id, long long *last_id, oph_ioserver_query ** exec_query, oph_ioserver_query_arg *** exec_args)
 {
@@ -1768,7 +1701,7 @@ int oph_dc_append_fragment_to_fragment(oph_ioserver_handler * input_server, oph_
 		return OPH_DC_SERVER_ERROR;
 	}
 
-	if (oph_ioserver_execute_query(input_server, query)) {
+	if (_oph_dc_execute_query(input_server, query, "read_fragment", old_frag, read_query, -1, -1)) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to execute operation.\n");
 		oph_ioserver_free_query(input_server, query);
 		return OPH_DC_SERVER_ERROR;
@@ -1779,7 +1712,9 @@ int oph_dc_append_fragment_to_fragment(oph_ioserver_handler * input_server, oph_
 	// Init res 
 	oph_ioserver_result *old_result = NULL;
 
-	if (oph_ioserver_get_result(input_server, &old_result)) {
+	//Rows are streamed only in case they are inserted by means of another connection
+	char stream = input_server != output_server;
+	if (stream ? oph_ioserver_get_result_stream(input_server, &old_result) : oph_ioserver_get_result(input_server, &old_result)) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to store result.\n");
 		oph_ioserver_free_result(input_server, old_result);
 		return OPH_DC_SERVER_ERROR;
@@ -1791,7 +1726,17 @@ int oph_dc_append_fragment_to_fragment(oph_ioserver_handler * input_server, oph_
 	}
 
 	unsigned long long l, rows = old_result->num_rows;
-	sizeof_var = old_result->max_field_length[old_result->num_fields - 1];
+	oph_ioserver_row *curr_row = NULL;
+	if (stream) {
+		//Max row length is unknown: buffers are sized on the first row and enlarged when needed
+		if (oph_ioserver_fetch_row(input_server, old_result, &curr_row)) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to fetch row\n");
+			oph_ioserver_free_result(input_server, old_result);
+			return OPH_DC_SERVER_ERROR;
+		}
+		sizeof_var = curr_row->row ? curr_row->field_lengths[old_result->num_fields - 1] : 0;
+	} else
+		sizeof_var = old_result->max_field_length[old_result->num_fields - 1];
 	//Get max row length of input table
 	if (!sizeof_var) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Fragment is empty\n");
@@ -1799,6 +1744,25 @@ int oph_dc_append_fragment_to_fragment(oph_ioserver_handler * input_server, oph_
 		return OPH_DC_SERVER_ERROR;
 	}
 
+#ifdef OPH_DEBUG_MYSQL
+	printf("ORIGINAL QUERY: " MYSQL_DC_INSERT_FRAG "\n", new_frag->fragment_name);
+#endif
+
+	query_buflen = 1 + snprintf(NULL, 0, OPH_DC_SQ_INSERT_FRAG, new_frag->fragment_name);
+	if (query_buflen >= max_size) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Buffer size (%ld bytes) is too small.\n", max_size);
+		oph_ioserver_free_result(input_server, old_result);
+		return OPH_DC_SERVER_ERROR;
+	}
+
+	char insert_query[query_buflen];
+	n = snprintf(insert_query, query_buflen, OPH_DC_SQ_INSERT_FRAG, new_frag->fragment_name);
+	if (n >= query_buflen) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Size of query exceed query limit.\n");
+		oph_ioserver_free_result(input_server, old_result);
+		return OPH_DC_SERVER_ERROR;
+	}
+
 	unsigned long long actual_size = 0;
 	unsigned long long *id_dim = NULL;
 	char *binary = NULL;
@@ -1876,25 +1840,6 @@ int oph_dc_append_fragment_to_fragment(oph_ioserver_handler * input_server, oph_
 		*exec_query = NULL;
 
 		//If first or only execution
-#ifdef OPH_DEBUG_MYSQL
-		printf("ORIGINAL QUERY: " MYSQL_DC_INSERT_FRAG "\n", new_frag->fragment_name);
-#endif
-
-		query_buflen = 1 + snprintf(NULL, 0, OPH_DC_SQ_INSERT_FRAG, new_frag->fragment_name);
-		if (query_buflen >= max_size) {
-			pmesg(LOG_ERROR, __FILE__, __LINE__, "Buffer size (%ld bytes) is too small.\n", max_size);
-			oph_ioserver_free_result(input_server, old_result);
-			return OPH_DC_SERVER_ERROR;
-		}
-
-		char insert_query[query_buflen];
-		n = snprintf(insert_query, query_buflen, OPH_DC_SQ_INSERT_FRAG, new_frag->fragment_name);
-		if (n >= query_buflen) {
-			pmesg(LOG_ERROR, __FILE__, __LINE__, "Size of query exceed query limit.\n");
-			oph_ioserver_free_result(input_server, old_result);
-			return OPH_DC_SERVER_ERROR;
-		}
-
 		binary = (char *) calloc(sizeof_var, sizeof(char));
 		if (!binary) {
 			pmesg(LOG_ERROR, __FILE__, __LINE__, "Cannot allocate data buffers\n");
@@ -1968,11 +1913,10 @@ int oph_dc_append_fragment_to_fragment(oph_ioserver_handler * input_server, oph_
 		}
 	}
 
-	oph_ioserver_row *curr_row = NULL;
 	long long tmp_first_id = 0, tmp_last_id = 0;
-	for (l = 0; l < rows; l++) {
-		//Read data     
-		if (oph_ioserver_fetch_row(input_server, old_result, &curr_row)) {
+	for (l = 0; stream || (l < rows); l++) {
+		//Read data (the first row of a streamed result set has been already fetched)
+		if ((!stream || l) && oph_ioserver_fetch_row(input_server, old_result, &curr_row)) {
 			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to fetch row\n");
 			oph_ioserver_free_result(input_server, old_result);
 			oph_ioserver_free_query(output_server, query);
@@ -1989,7 +1933,35 @@ int oph_dc_append_fragment_to_fragment(oph_ioserver_handler * input_server, oph_
 			return OPH_DC_SERVER_ERROR;
 		}
 
+		if (stream && !curr_row->row)
+			break;
+
 		actual_size = curr_row->field_lengths[1];
+		if (actual_size > sizeof_var) {
+			if (actual_size > args[1]->arg_length) {
+				if (_oph_dc_enlarge_blob_arg(output_server, insert_query, tot_rows, args, 1, actual_size, &query)) {
+					pmesg(LOG_ERROR, __FILE__, __LINE__, "Cannot enlarge data buffers\n");
+					oph_ioserver_free_result(input_server, old_result);
+					if (query)
+						oph_ioserver_free_query(output_server, query);
+					for (ii = 0; ii < c_arg; ii++) {
+						if (args[ii]) {
+							if (args[ii]->arg)
+								free(args[ii]->arg);
+							free(args[ii]);
+						}
+					}
+					free(args);
+					*exec_args = NULL;
+					*exec_query = NULL;
+					return OPH_DC_SERVER_ERROR;
+				}
+				if (*exec_query)
+					*exec_query = query;
+				binary = args[1]->arg;
+			}
+			sizeof_var = actual_size;
+		}
 		*id_dim = (unsigned long long) strtoll(curr_row->row[0], NULL, 10);
 		if (l == 0)
 			tmp_first_id = *id_dim;
@@ -2038,6 +2010,196 @@ int oph_dc_append_fragment_to_fragment(oph_ioserver_handler * input_server, oph_
 	return OPH_DC_SUCCESS;
 }
 
+//The trace reports trace_text in place of query_text, so that secrets can be hidden
+static int _oph_dc_run_hidden_query(oph_ioserver_handler * server, oph_odb_fragment * frag, const char *name, const char *query_text, const char *trace_text)
+{
+	oph_ioserver_query *query = NULL;
+	if (oph_ioserver_setup_query(server, query_text, 1, NULL, &query)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to setup query.\n");
+		return OPH_DC_SERVER_ERROR;
+	}
+
+	int res = _oph_dc_execute_query(server, query, name, frag, trace_text, -1, -1);
+	oph_ioserver_free_query(server, query);
+
+	return res ? OPH_DC_SERVER_ERROR : OPH_DC_SUCCESS;
+}
+
+int _oph_dc_run_query(oph_ioserver_handler * server, oph_odb_fragment * frag, const char *name, const char *query_text)
+{
+	return _oph_dc_run_hidden_query(server, frag, name, query_text, query_text);
+}
+
+//Store the credentials of the server hosting remote_frag on the I/O server of frag, so that links only refer to server_name
+//The definition is named after the output fragment, so it is owned by a single task and can be dropped as soon as the copy is done
+static int _oph_dc_define_transfer_server(oph_ioserver_handler * server, oph_odb_fragment * frag, oph_odb_fragment * remote_frag, const char *server_name)
+{
+	oph_odb_dbms_instance *remote = remote_frag->db_instance->dbms_instance;
+
+	char server_query[OPH_COMMON_BUFFER_LEN], trace_text[OPH_COMMON_BUFFER_LEN];
+	if (snprintf(server_query, OPH_COMMON_BUFFER_LEN, OPH_DC_SQ_CREATE_SERVER, server_name, remote->hostname, remote->port, remote->login, remote->pwd, remote_frag->db_instance->db_name) >=
+	    OPH_COMMON_BUFFER_LEN)
+		return OPH_DC_DATA_ERROR;
+	snprintf(trace_text, OPH_COMMON_BUFFER_LEN, OPH_DC_SQ_CREATE_SERVER, server_name, remote->hostname, remote->port, remote->login, OPH_DC_TRANSFER_HIDDEN_PASSWORD,
+		 remote_frag->db_instance->db_name);
+
+	return _oph_dc_run_hidden_query(server, frag, "define_server", server_query, trace_text);
+}
+
+//Drop the link to a remote fragment and the server definition it is based on
+static void _oph_dc_drop_transfer_link(oph_ioserver_handler * server, oph_odb_fragment * frag, const char *frag_name, int ll, char *transferred)
+{
+	char name[OPH_COMMON_BUFFER_LEN], delete_query[OPH_COMMON_BUFFER_LEN];
+
+	if (transferred[ll] & OPH_DC_TRANSFER_LINK) {
+		snprintf(name, OPH_COMMON_BUFFER_LEN, OPH_DC_TRANSFER_LINK_NAME, frag_name, ll);
+		snprintf(delete_query, OPH_COMMON_BUFFER_LEN, OPH_DC_SQ_DELETE_FRAG, name);
+		if (_oph_dc_run_query(server, frag, "drop_fragment", delete_query))
+			pmesg(LOG_WARNING, __FILE__, __LINE__, "Unable to drop temporary table %s\n", name);
+	}
+	if (transferred[ll] & OPH_DC_TRANSFER_SERVER) {
+		snprintf(name, OPH_COMMON_BUFFER_LEN, OPH_DC_TRANSFER_SERVER_NAME, frag_name, ll);
+		snprintf(delete_query, OPH_COMMON_BUFFER_LEN, OPH_DC_SQ_DROP_SERVER, name);
+		if (_oph_dc_run_query(server, frag, "drop_server", delete_query))
+			pmesg(LOG_WARNING, __FILE__, __LINE__, "Unable to drop temporary server definition %s\n", name);
+	}
+	transferred[ll] &= ~(OPH_DC_TRANSFER_LINK | OPH_DC_TRANSFER_SERVER);
+}
+
+//Drop links, server definitions and copies of remote fragments created by _oph_dc_process_fragments_in_place
+void _oph_dc_drop_transferred_fragments(oph_ioserver_handler * server, oph_odb_fragment * frag, int cubes_num, const char *frag_name, char *transferred)
+{
+	int ll;
+	char table_name[OPH_COMMON_BUFFER_LEN], delete_query[OPH_COMMON_BUFFER_LEN];
+
+	for (ll = 1; ll < cubes_num; ll++) {
+		_oph_dc_drop_transfer_link(server, frag, frag_name, ll, transferred);
+		if (transferred[ll] & OPH_DC_TRANSFER_COPY) {
+			snprintf(table_name, OPH_COMMON_BUFFER_LEN, OPH_DC_TRANSFER_COPY_NAME, frag_name, ll);
+			snprintf(delete_query, OPH_COMMON_BUFFER_LEN, OPH_DC_SQ_DELETE_FRAG, table_name);
+			if (_oph_dc_run_query(server, frag, "drop_fragment", delete_query))
+				pmesg(LOG_WARNING, __FILE__, __LINE__, "Unable to drop temporary table %s\n", table_name);
+		}
+		transferred[ll] = 0;
+	}
+}
+
+//Apply a binary primitive on the I/O server of the first fragment: the other fragments are moved there server-to-server
+//The resulting value of each row is value_prefix followed by the list of input measures and value_suffix
+//In case fallback is set on error, the output fragment has not been changed and rows can be processed by the framework
+int _oph_dc_process_fragments_in_place(int cubes_num, oph_ioserver_handler ** servers, oph_odb_fragment ** old_frags, const char *frag_name, int compressed, const char *value_prefix,
+				       const char *value_suffix, char *fallback)
+{
+	*fallback = 1;
+	if (cubes_num < 2)
+		return OPH_DC_DATA_ERROR;
+
+	oph_odb_dbms_instance *dbms = old_frags[0]->db_instance->dbms_instance, *remote;
+	int ll;
+
+	//Links are based on MySQL FEDERATED tables, so check servers and credentials
+	if (strcmp(dbms->io_server_type, OPH_IOSERVER_MYSQL_TYPE))
+		return OPH_DC_DATA_ERROR;
+	for (ll = 1; ll < cubes_num; ll++) {
+		remote = old_frags[ll]->db_instance->dbms_instance;
+		if (remote->id_dbms == dbms->id_dbms)
+			continue;
+		if (strcmp(remote->io_server_type, OPH_IOSERVER_MYSQL_TYPE) || strpbrk(remote->hostname, OPH_DC_TRANSFER_RESERVED_CHARS) || strpbrk(remote->login, OPH_DC_TRANSFER_RESERVED_CHARS)
+		    || strpbrk(remote->pwd, OPH_DC_TRANSFER_RESERVED_CHARS)) {
+			pmesg(LOG_DEBUG, __FILE__, __LINE__, "Fragment %s cannot be linked to server %s\n", old_frags[ll]->fragment_name, dbms->hostname);
+			return OPH_DC_DATA_ERROR;
+		}
+	}
+
+	if (oph_dc_check_connection_to_db(servers[0], dbms, old_frags[0]->db_instance, 0)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to reconnect to DB.\n");
+		return OPH_DC_SERVER_ERROR;
+	}
+
+	char transferred[cubes_num];
+	memset(transferred, 0, cubes_num);
+
+	char source[OPH_COMMON_BUFFER_LEN], link_name[OPH_COMMON_BUFFER_LEN], server_name[OPH_COMMON_BUFFER_LEN], transfer_query[OPH_COMMON_BUFFER_LEN];
+	char operand[OPH_COMMON_BUFFER_LEN], operands[OPH_COMMON_BUFFER_LEN];
+	char from[OPH_COMMON_BUFFER_LEN], froms[OPH_COMMON_BUFFER_LEN];
+	char alias[OPH_COMMON_BUFFER_LEN], aliases[OPH_COMMON_BUFFER_LEN];
+	char where[OPH_COMMON_BUFFER_LEN], wheres[OPH_COMMON_BUFFER_LEN];
+	*operands = *froms = *aliases = *wheres = 0;
+
+	int res = OPH_DC_SUCCESS, n;
+	for (ll = 0; ll < cubes_num; ll++) {
+		remote = old_frags[ll]->db_instance->dbms_instance;
+		if (ll && (remote->id_dbms != dbms->id_dbms)) {
+			//Link the remote fragment and copy it next to the first one: rows flow directly between I/O servers
+			//In case the server definition cannot be created (e.g. missing privileges) rows are moved by the framework
+			snprintf(server_name, OPH_COMMON_BUFFER_LEN, OPH_DC_TRANSFER_SERVER_NAME, frag_name, ll);
+			if ((res = _oph_dc_define_transfer_server(servers[0], old_frags[0], old_frags[ll], server_name))) {
+				res = OPH_DC_SERVER_ERROR;
+				break;
+			}
+			transferred[ll] |= OPH_DC_TRANSFER_SERVER;
+
+			snprintf(link_name, OPH_COMMON_BUFFER_LEN, OPH_DC_TRANSFER_LINK_NAME, frag_name, ll);
+			n = snprintf(transfer_query, OPH_COMMON_BUFFER_LEN, OPH_DC_SQ_CREATE_FRAG_LINK, link_name, server_name, old_frags[ll]->fragment_name);
+			if ((n >= OPH_COMMON_BUFFER_LEN) || (res = _oph_dc_run_query(servers[0], old_frags[ll], "link_fragment", transfer_query))) {
+				res = OPH_DC_SERVER_ERROR;
+				break;
+			}
+			transferred[ll] |= OPH_DC_TRANSFER_LINK;
+
+			snprintf(source, OPH_COMMON_BUFFER_LEN, OPH_DC_TRANSFER_COPY_NAME, frag_name, ll);
+			n = snprintf(transfer_query, OPH_COMMON_BUFFER_LEN, OPH_DC_SQ_CREATE_FRAG_COPY, source, link_name);
+			if ((n >= OPH_COMMON_BUFFER_LEN) || (res = _oph_dc_run_query(servers[0], old_frags[ll], "transfer_fragment", transfer_query))) {
+				res = OPH_DC_SERVER_ERROR;
+				break;
+			}
+			transferred[ll] |= OPH_DC_TRANSFER_COPY;
+
+			//Credentials are no longer needed once rows have been copied
+			_oph_dc_drop_transfer_link(servers[0], old_frags[0], frag_name, ll, transferred);
+		} else
+			snprintf(source, OPH_COMMON_BUFFER_LEN, "%s.%s", old_frags[ll]->db_instance->db_name, old_frags[ll]->fragment_name);
+
+		snprintf(operand, OPH_COMMON_BUFFER_LEN, "%s%sfrag%d.measure%s", ll ? "," : "", compressed ? "oph_uncompress('',''," : "", ll + 1, compressed ? ")" : "");
+		strncat(operands, operand, OPH_COMMON_BUFFER_LEN - strlen(operands) - 1);
+		snprintf(from, OPH_COMMON_BUFFER_LEN, "%s%s", ll ? "|" : "", source);
+		strncat(froms, from, OPH_COMMON_BUFFER_LEN - strlen(froms) - 1);
+		snprintf(alias, OPH_COMMON_BUFFER_LEN, "%sfrag%d", ll ? "|" : "", ll + 1);
+		strncat(aliases, alias, OPH_COMMON_BUFFER_LEN - strlen(aliases) - 1);
+		if (ll) {
+			snprintf(where, OPH_COMMON_BUFFER_LEN, "%sfrag1.id_dim=frag%d.id_dim", ll > 1 ? " AND " : "", ll + 1);
+			strncat(wheres, where, OPH_COMMON_BUFFER_LEN - strlen(wheres) - 1);
+		}
+	}
+
+	if (!res) {
+		long long max_size = QUERY_BUFLEN;
+		oph_pid_get_buffer_size(&max_size);
+
+		char value[strlen(value_prefix) + strlen(operands) + strlen(value_suffix) + OPH_DC_MIN_SIZE];
+		snprintf(value, sizeof(value), "%s%s%s%s%s", compressed ? "oph_compress('',''," : "", value_prefix, operands, value_suffix, compressed ? ")" : "");
+
+		int query_buflen = 1 + snprintf(NULL, 0, OPH_DC_SQ_INSERT_SELECT_FRAG2, frag_name, value, froms, aliases, wheres);
+		if ((query_buflen >= max_size) || (strlen(operands) >= OPH_COMMON_BUFFER_LEN - 1) || (strlen(froms) >= OPH_COMMON_BUFFER_LEN - 1)
+		    || (strlen(aliases) >= OPH_COMMON_BUFFER_LEN - 1) || (strlen(wheres) >= OPH_COMMON_BUFFER_LEN - 1)) {
+			pmesg(LOG_DEBUG, __FILE__, __LINE__, "Query to process fragments on server %s is too long\n", dbms->hostname);
+			res = OPH_DC_DATA_ERROR;
+		} else {
+			char insert_query[query_buflen];
+			snprintf(insert_query, query_buflen, OPH_DC_SQ_INSERT_SELECT_FRAG2, frag_name, value, froms, aliases, wheres);
+			if ((res = _oph_dc_run_query(servers[0], old_frags[0], "process_fragment", insert_query))) {
+				pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to process fragments on server %s\n", dbms->hostname);
+				//Some rows could have been already inserted
+				*fallback = 0;
+			}
+		}
+	}
+
+	_oph_dc_drop_transferred_fragments(servers[0], old_frags[0], cubes_num, frag_name, transferred);
+
+	return res;
+}
+
 int oph_dc_copy_and_process_fragment2(int cubes_num, oph_ioserver_handler ** servers, unsigned long long tot_rows, oph_odb_fragment ** old_frags, const char *frag_name, int compressed,
 				      const char *operation, const char *measure_type, const char *missingvalue)
 {
@@ -2046,6 +2208,27 @@ int oph_dc_copy_and_process_fragment2(int cubes_num, oph_ioserver_handler ** ser
 		return OPH_DC_NULL_PARAM;
 	}
 
+	int ii;
+	char _datatype[QUERY_BUFLEN], _datatypes[QUERY_BUFLEN];
+	char _measure[QUERY_BUFLEN], _measures[QUERY_BUFLEN];
+	*_datatypes = *_measures = 0;
+	for (ii = 0; ii < cubes_num; ii++) {
+		snprintf(_datatype, OPH_COMMON_BUFFER_LEN, "%soph_%s", ii ? "|" : "", measure_type);
+		strncat(_datatypes, _datatype, QUERY_BUFLEN - strlen(_datatypes));
+		snprintf(_measure, OPH_COMMON_BUFFER_LEN, "%s?", ii ? "," : "");
+		strncat(_measures, _measure, QUERY_BUFLEN - strlen(_measures));
+	}
+
+	//Try to process fragments on the first I/O server, so that rows do not pass through the framework
+	char fallback = 1, value_prefix[strlen(_datatypes) + strlen(measure_type) + OPH_DC_MIN_SIZE], value_suffix[strlen(operation) + strlen(missingvalue) + OPH_DC_MIN_SIZE];
+	snprintf(value_prefix, sizeof(value_prefix), "oph_operation_array('%s','oph_%s',", _datatypes, measure_type);
+	snprintf(value_suffix, sizeof(value_suffix), ",'oph_%s',%s)", operation, missingvalue);
+	if (!_oph_dc_process_fragments_in_place(cubes_num, servers, old_frags, frag_name, compressed, value_prefix, value_suffix, &fallback))
+		return OPH_DC_SUCCESS;
+	if (!fallback)
+		return OPH_DC_SERVER_ERROR;
+	pmesg(LOG_DEBUG, __FILE__, __LINE__, "Rows of fragments will be transferred by the framework\n");
+
 	unsigned long long sizeof_var = 0;
 
 	// Init res 
@@ -2054,9 +2237,18 @@ int oph_dc_copy_and_process_fragment2(int cubes_num, oph_ioserver_handler ** ser
 	long long max_size = QUERY_BUFLEN;
 	oph_pid_get_buffer_size(&max_size);
 
-	int ll, query_buflen, n;
+	int ll, jj, query_buflen, n;
 	oph_ioserver_query *query = NULL;
 
+	//Rows of the first fragment are stored, since its connection is used to insert the output rows; the others are streamed unless their connection is shared
+	char stream[cubes_num];
+	for (ll = 0; ll < cubes_num; ll++) {
+		stream[ll] = ll > 0;
+		for (jj = 0; stream[ll] && (jj < cubes_num); jj++)
+			if ((jj != ll) && (servers[jj] == servers[ll]))
+				stream[ll] = 0;
+	}
+
 	for (ll = 0; ll < cubes_num; ll++) {
 		old_result[ll] = NULL;
 
@@ -2084,14 +2276,14 @@ int oph_dc_copy_and_process_fragment2(int cubes_num, oph_ioserver_handler ** ser
 			return OPH_DC_SERVER_ERROR;
 		}
 
-		if (oph_ioserver_execute_query(servers[ll], query)) {
+		if (_oph_dc_execute_query(servers[ll], query, "read_fragment", old_frags[ll], read_query, -1, -1)) {
 			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to execute operation.\n");
 			oph_ioserver_free_query(servers[ll], query);
 			return OPH_DC_SERVER_ERROR;
 		}
 		oph_ioserver_free_query(servers[ll], query);
 
-		if (oph_ioserver_get_result(servers[ll], &old_result[ll])) {
+		if (stream[ll] ? oph_ioserver_get_result_stream(servers[ll], &old_result[ll]) : oph_ioserver_get_result(servers[ll], &old_result[ll])) {
 			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to store result.\n");
 			for (; ll >= 0; ll--)
 				oph_ioserver_free_result(servers[ll], old_result[ll]);
@@ -2112,7 +2304,7 @@ int oph_dc_copy_and_process_fragment2(int cubes_num, oph_ioserver_handler ** ser
 				oph_ioserver_free_result(servers[0], old_result[0]);
 				return OPH_DC_SERVER_ERROR;
 			}
-		} else {
+		} else if (!stream[ll]) {
 			if (sizeof_var != old_result[ll]->max_field_length[old_result[ll]->num_fields - 1]) {
 				pmesg(LOG_ERROR, __FILE__, __LINE__, "Fragments are not comparable\n");
 				for (; ll >= 0; ll--)
@@ -2123,17 +2315,7 @@ int oph_dc_copy_and_process_fragment2(int cubes_num, oph_ioserver_handler ** ser
 	}
 
 	unsigned long long actual_size = 0;
-	int c_arg = 1 + cubes_num, ii;
-
-	char _datatype[QUERY_BUFLEN], _datatypes[QUERY_BUFLEN];
-	char _measure[QUERY_BUFLEN], _measures[QUERY_BUFLEN];
-	*_datatypes = *_measures = 0;
-	for (ii = 0; ii < cubes_num; ii++) {
-		snprintf(_datatype, OPH_COMMON_BUFFER_LEN, "%soph_%s", ii ? "|" : "", measure_type);
-		strncat(_datatypes, _datatype, QUERY_BUFLEN - strlen(_datatypes));
-		snprintf(_measure, OPH_COMMON_BUFFER_LEN, "%s?", ii ? "," : "");
-		strncat(_measures, _measure, QUERY_BUFLEN - strlen(_measures));
-	}
+	int c_arg = 1 + cubes_num;
 
 	query_buflen = 1 + snprintf(NULL, 0, OPH_DC_SQ_INSERT_FRAG3, frag_name, compressed ? "oph_compress(" : "", _datatypes, measure_type, _measures, operation, missingvalue, compressed ? ")" : "");
 	if (query_buflen >= max_size) {
@@ -2258,6 +2440,26 @@ int oph_dc_copy_and_process_fragment2(int cubes_num, oph_ioserver_handler ** ser
 			}
 		}
 
+		//Row lengths of streamed fragments are checked while rows are read
+		for (ll = 1; ll < cubes_num; ll++)
+			if (stream[ll] && (!curr_row[ll]->row || (curr_row[ll]->field_lengths[1] > sizeof_var)))
+				break;
+		if (ll < cubes_num) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Fragments are not comparable\n");
+			for (ll = 0; ll < cubes_num; ll++)
+				oph_ioserver_free_result(servers[ll], old_result[ll]);
+			oph_ioserver_free_query(first_server, query);
+			for (ii = 0; ii < c_arg; ii++) {
+				if (args[ii]) {
+					if (args[ii]->arg)
+						free(args[ii]->arg);
+					free(args[ii]);
+				}
+			}
+			free(args);
+			return OPH_DC_SERVER_ERROR;
+		}
+
 		*id_dim = (unsigned long long) strtoll(curr_row[0]->row[0], NULL, 10);
 		for (ll = 0; ll < cubes_num; ll++) {
 			actual_size = curr_row[ll]->field_lengths[1];
@@ -2307,6 +2509,17 @@ int oph_dc_copy_and_process_fragment(oph_ioserver_handler * first_server, oph_io
 		return OPH_DC_NULL_PARAM;
 	}
 
+	//Try to process fragments on the first I/O server, so that rows do not pass through the framework
+	oph_ioserver_handler *servers[2] = { first_server, second_server };
+	oph_odb_fragment *old_frags[2] = { old_frag1, old_frag2 };
+	char fallback = 1, value_prefix[strlen(operation) + 3 * strlen(measure_type) + OPH_DC_MIN_SIZE];
+	snprintf(value_prefix, sizeof(value_prefix), "%s('oph_%s|oph_%s','oph_%s',", operation, measure_type, measure_type, measure_type);
+	if (!_oph_dc_process_fragments_in_place(2, servers, old_frags, frag_name, compressed, value_prefix, ")", &fallback))
+		return OPH_DC_SUCCESS;
+	if (!fallback)
+		return OPH_DC_SERVER_ERROR;
+	pmesg(LOG_DEBUG, __FILE__, __LINE__, "Rows of fragments will be transferred by the framework\n");
+
 	unsigned long long sizeof_var = 0;
 
 	// Init res 
@@ -2340,7 +2553,7 @@ int oph_dc_copy_and_process_fragment(oph_ioserver_handler * first_server, oph_io
 		return OPH_DC_SERVER_ERROR;
 	}
 
-	if (oph_ioserver_execute_query(first_server, query)) {
+	if (_oph_dc_execute_query(first_server, query, "read_fragment", old_frag1, read_query, -1, -1)) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to execute operation.\n");
 		oph_ioserver_free_query(first_server, query);
 		return OPH_DC_SERVER_ERROR;
@@ -2394,7 +2607,7 @@ int oph_dc_copy_and_process_fragment(oph_ioserver_handler * first_server, oph_io
 		return OPH_DC_SERVER_ERROR;
 	}
 
-	if (oph_ioserver_execute_query(second_server, query)) {
+	if (_oph_dc_execute_query(second_server, query, "read_fragment", old_frag2, read_query2, -1, -1)) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to execute operation.\n");
 		oph_ioserver_free_result(first_server, old_result1);
 		oph_ioserver_free_query(second_server, query);
@@ -2605,8 +2818,8 @@ int oph_dc_copy_and_process_fragment(oph_ioserver_handler * first_server, oph_io
 	return OPH_DC_SUCCESS;
 }
 
-int oph_dc_read_fragment_data(oph_ioserver_handler * server, oph_odb_fragment * frag, char *data_type, int compressed, char *id_clause, char *array_clause, char *where_clause, int limit,
-			      int raw_format, oph_ioserver_result ** frag_rows)
+int _oph_dc_read_fragment_data(oph_ioserver_handler * server, oph_odb_fragment * frag, char *data_type, int compressed, char *id_clause, char *array_clause, char *where_clause, int limit,
+			       int raw_format, char stream, oph_ioserver_result ** frag_rows)
 {
 	if (!frag || !frag_rows || !server) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
@@ -2909,12 +3122,16 @@ int oph_dc_read_fragment_data(oph_ioserver_handler * server, oph_odb_fragment *
 	oph_ioserver_query *query = NULL;
 	if (oph_ioserver_setup_query(server, read_query, 1, NULL, &query)) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to setup query '%s'\n", read_query);
+		free(read_query);
 		return OPH_DC_SERVER_ERROR;
 	}
-	free(read_query);
+
+	oph_trace_span span;
+	oph_trace_begin(&span);
 
 	if (oph_ioserver_execute_query(server, query)) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to execute operation '%s'\n", read_query);
+		free(read_query);
 		oph_ioserver_free_query(server, query);
 		return OPH_DC_SERVER_ERROR;
 	}
@@ -2922,15 +3139,35 @@ int oph_dc_read_fragment_data(oph_ioserver_handler * server, oph_odb_fragment *
 	oph_ioserver_free_query(server, query);
 
 	// Init res 
-	if (oph_ioserver_get_result(server, frag_rows)) {
+	if (stream ? oph_ioserver_get_result_stream(server, frag_rows) : oph_ioserver_get_result(server, frag_rows)) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to store result.\n");
+		free(read_query);
 		oph_ioserver_free_result(server, *frag_rows);
 		return OPH_DC_SERVER_ERROR;
 	}
 
+	if (oph_trace_is_enabled()) {
+		//Rows of streamed result sets are not known in advance
+		oph_trace_args trace_args = { frag->id_fragment, frag->db_instance->dbms_instance->hostname, read_query, stream || !*frag_rows ? -1 : (long long) (*frag_rows)->num_rows, -1 };
+		oph_trace_end(&span, OPH_TRACE_CATEGORY_QUERY, "read_fragment_data", &trace_args);
+	}
+	free(read_query);
+
 	return OPH_DC_SUCCESS;
 }
 
+int oph_dc_read_fragment_data(oph_ioserver_handler * server, oph_odb_fragment * frag, char *data_type, int compressed, char *id_clause, char *array_clause, char *where_clause, int limit,
+			      int raw_format, oph_ioserver_result ** frag_rows)
+{
+	return _oph_dc_read_fragment_data(server, frag, data_type, compressed, id_clause, array_clause, where_clause, limit, raw_format, 0, frag_rows);
+}
+
+int oph_dc_read_fragment_data_stream(oph_ioserver_handler * server, oph_odb_fragment * frag, char *data_type, int compressed, char *id_clause, char *array_clause, char *where_clause, int limit,
+				     int raw_format, oph_ioserver_result ** frag_rows)
+{
+	return _oph_dc_read_fragment_data(server, frag, data_type, compressed, id_clause, array_clause, where_clause, limit, raw_format, 1, frag_rows);
+}
+
 int oph_dc_get_total_number_of_elements_in_fragment(oph_ioserver_handler * server, oph_odb_fragment * frag, char *data_type, int compressed, long long *count)
 {
 	if (!frag || !data_type || !count || !server) {
@@ -37,6 +37,13 @@
 
 #include <ctype.h>
 #include <mysql.h>
+#include <openssl/opensslv.h>
+#include <openssl/evp.h>
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+//EVP_MD_CTX_new and EVP_MD_CTX_free are available since OpenSSL 1.1.0
+#define EVP_MD_CTX_new EVP_MD_CTX_create
+#define EVP_MD_CTX_free EVP_MD_CTX_destroy
+#endif
 #if MYSQL_VERSION_ID >= 80001 && MYSQL_VERSION_ID != 80002
 typedef bool my_bool;
 #endif
@@ -47,6 +54,14 @@ typedef bool my_bool;
 #define OPH_DIM_DATA_FORMAT_CHECK1 OPH_DIM_DATA_FORMAT_CHECK
 #define OPH_DIM_DATA_FORMAT_CHECK2 'T'
 
+#define OPH_DIM_CALENDAR_GREGORIAN 1
+#define OPH_DIM_CALENDAR_PGREGORIAN 2
+#define OPH_DIM_CALENDAR_JULIAN 3
+#define OPH_DIM_CALENDAR_360_DAY 4
+#define OPH_DIM_CALENDAR_365_DAY 5
+#define OPH_DIM_CALENDAR_366_DAY 6
+#define OPH_DIM_CALENDAR_USER_DEFINED 7
+
 extern int msglevel;
 
 char oph_dim_typeof(char *dimension_type)
@@ -175,6 +190,28 @@ int oph_dim_set_double_value_of(char *dim_row, unsigned int kk, const char *dime
 	return OPH_DIM_SUCCESS;
 }
 
+// Return the code of the calendar of a dimension (0 if unknown)
+char _oph_dim_calendar_of(oph_odb_dimension * dim)
+{
+	if (!strncmp(dim->calendar, OPH_DIM_TIME_CALENDAR_GREGORIAN, OPH_ODB_DIM_TIME_SIZE) || !strncmp(dim->calendar, OPH_DIM_TIME_CALENDAR_STANDARD, OPH_ODB_DIM_TIME_SIZE))
+		return OPH_DIM_CALENDAR_GREGORIAN;
+	if (!strncmp(dim->calendar, OPH_DIM_TIME_CALENDAR_PGREGORIAN, OPH_ODB_DIM_TIME_SIZE) || !strncmp(dim->calendar, OPH_DIM_TIME_CALENDAR_PGREGORIAN2, OPH_ODB_DIM_TIME_SIZE))
+		return OPH_DIM_CALENDAR_PGREGORIAN;
+	if (!strncmp(dim->calendar, OPH_DIM_TIME_CALENDAR_JULIAN, OPH_ODB_DIM_TIME_SIZE))
+		return OPH_DIM_CALENDAR_JULIAN;
+	if (!strncmp(dim->calendar, OPH_DIM_TIME_CALENDAR_360_DAY, OPH_ODB_DIM_TIME_SIZE) || !strncmp(dim->calendar, OPH_DIM_TIME_CALENDAR_360DAY, OPH_ODB_DIM_TIME_SIZE))
+		return OPH_DIM_CALENDAR_360_DAY;
+	if (!strncmp(dim->calendar, OPH_DIM_TIME_CALENDAR_NO_LEAP, OPH_ODB_DIM_TIME_SIZE) || !strncmp(dim->calendar, OPH_DIM_TIME_CALENDAR_NOLEAP, OPH_ODB_DIM_TIME_SIZE)
+	    || !strncmp(dim->calendar, OPH_DIM_TIME_CALENDAR_365_DAY, OPH_ODB_DIM_TIME_SIZE) || !strncmp(dim->calendar, OPH_DIM_TIME_CALENDAR_365DAY, OPH_ODB_DIM_TIME_SIZE))
+		return OPH_DIM_CALENDAR_365_DAY;
+	if (!strncmp(dim->calendar, OPH_DIM_TIME_CALENDAR_ALL_LEAP, OPH_ODB_DIM_TIME_SIZE) || !strncmp(dim->calendar, OPH_DIM_TIME_CALENDAR_ALLLEAP, OPH_ODB_DIM_TIME_SIZE)
+	    || !strncmp(dim->calendar, OPH_DIM_TIME_CALENDAR_366_DAY, OPH_ODB_DIM_TIME_SIZE) || !strncmp(dim->calendar, OPH_DIM_TIME_CALENDAR_366DAY, OPH_ODB_DIM_TIME_SIZE))
+		return OPH_DIM_CALENDAR_366_DAY;
+	if (!strncmp(dim->calendar, OPH_DIM_TIME_CALENDAR_USER_DEFINED, OPH_ODB_DIM_TIME_SIZE))
+		return OPH_DIM_CALENDAR_USER_DEFINED;
+	return 0;
+}
+
 int oph_date_to_day(int y, int m, int d, long long *g, oph_odb_dimension * dim)
 {
 	if (!g || !dim)
@@ -230,15 +267,11 @@ int oph_date_to_day(int y, int m, int d, long long *g, oph_odb_dimension * dim)
 	return OPH_DIM_SUCCESS;
 }
 
-int oph_day_to_date(long long g, int *yy, int *mm, int *dd, int *wd, int *yd, oph_odb_dimension * dim)
+// Convert a day number into a date of a given calendar
+static inline int _oph_day_to_date(long long g, int *yy, int *mm, int *dd, char calendar, oph_odb_dimension * dim)
 {
-	if (!yy || !mm || !dd || !dim)
-		return OPH_DIM_NULL_PARAM;
-	if (!dim->calendar || !strlen(dim->calendar))
-		return OPH_DIM_TIME_PARSING_ERROR;
-
 	long long y, mi, ddd;
-	if (!strncmp(dim->calendar, OPH_DIM_TIME_CALENDAR_GREGORIAN, OPH_ODB_DIM_TIME_SIZE) || !strncmp(dim->calendar, OPH_DIM_TIME_CALENDAR_STANDARD, OPH_ODB_DIM_TIME_SIZE)) {
+	if (calendar == OPH_DIM_CALENDAR_GREGORIAN) {
 		int offset = g >= 578041 ? 0 : 2;
 		g += offset;
 		y = !offset ? (10000 * g + 14780) / 3652425 : 100 * g / 36525;
@@ -251,7 +284,7 @@ int oph_day_to_date(long long g, int *yy, int *mm, int *dd, int *wd, int *yd, op
 		*mm = (mi + 2) % 12 + 1;
 		*yy = y + (mi + 2) / 12;
 		*dd = ddd - (mi * 306 + 5) / 10 + 1;
-	} else if (!strncmp(dim->calendar, OPH_DIM_TIME_CALENDAR_PGREGORIAN, OPH_ODB_DIM_TIME_SIZE) || !strncmp(dim->calendar, OPH_DIM_TIME_CALENDAR_PGREGORIAN2, OPH_ODB_DIM_TIME_SIZE)) {
+	} else if (calendar == OPH_DIM_CALENDAR_PGREGORIAN) {
 		y = (10000 * g + 14780) / 3652425;
 		ddd = g - (365 * y + y / 4 - y / 100 + y / 400);
 		if (ddd < 0) {
@@ -262,7 +295,7 @@ int oph_day_to_date(long long g, int *yy, int *mm, int *dd, int *wd, int *yd, op
 		*mm = (mi + 2) % 12 + 1;
 		*yy = y + (mi + 2) / 12;
 		*dd = ddd - (mi * 306 + 5) / 10 + 1;
-	} else if (!strncmp(dim->calendar, OPH_DIM_TIME_CALENDAR_JULIAN, OPH_ODB_DIM_TIME_SIZE)) {
+	} else if (calendar == OPH_DIM_CALENDAR_JULIAN) {
 		y = 100 * g / 36525;
 		ddd = g - (365 * y + y / 4);
 		if (ddd < 0) {
@@ -273,14 +306,13 @@ int oph_day_to_date(long long g, int *yy, int *mm, int *dd, int *wd, int *yd, op
 		*mm = (mi + 2) % 12 + 1;
 		*yy = y + (mi + 2) / 12;
 		*dd = ddd - (mi * 306 + 5) / 10 + 1;
-	} else if (!strncmp(dim->calendar, OPH_DIM_TIME_CALENDAR_360_DAY, OPH_ODB_DIM_TIME_SIZE) || !strncmp(dim->calendar, OPH_DIM_TIME_CALENDAR_360DAY, OPH_ODB_DIM_TIME_SIZE)) {
+	} else if (calendar == OPH_DIM_CALENDAR_360_DAY) {
 		*dd = g % OPH_ODB_DIM_DAY_NUMBER + 1;
 		g /= OPH_ODB_DIM_DAY_NUMBER;
 		*mm = g % OPH_ODB_DIM_MONTH_NUMBER + 1;
 		g /= OPH_ODB_DIM_MONTH_NUMBER;
 		*yy = g;
-	} else if (!strncmp(dim->calendar, OPH_DIM_TIME_CALENDAR_NO_LEAP, OPH_ODB_DIM_TIME_SIZE) || !strncmp(dim->calendar, OPH_DIM_TIME_CALENDAR_NOLEAP, OPH_ODB_DIM_TIME_SIZE)
-		   || !strncmp(dim->calendar, OPH_DIM_TIME_CALENDAR_365_DAY, OPH_ODB_DIM_TIME_SIZE) || !strncmp(dim->calendar, OPH_DIM_TIME_CALENDAR_365DAY, OPH_ODB_DIM_TIME_SIZE)) {
+	} else if (calendar == OPH_DIM_CALENDAR_365_DAY) {
 		y = g / 365;
 		ddd = g - 365 * y;
 		if (ddd < 0) {
@@ -291,8 +323,7 @@ int oph_day_to_date(long long g, int *yy, int *mm, int *dd, int *wd, int *yd, op
 		*mm = (mi + 2) % 12 + 1;
 		*yy = y + (mi + 2) / 12;
 		*dd = ddd - (mi * 306 + 5) / 10 + 1;
-	} else if (!strncmp(dim->calendar, OPH_DIM_TIME_CALENDAR_ALL_LEAP, OPH_ODB_DIM_TIME_SIZE) || !strncmp(dim->calendar, OPH_DIM_TIME_CALENDAR_ALLLEAP, OPH_ODB_DIM_TIME_SIZE)
-		   || !strncmp(dim->calendar, OPH_DIM_TIME_CALENDAR_366_DAY, OPH_ODB_DIM_TIME_SIZE) || !strncmp(dim->calendar, OPH_DIM_TIME_CALENDAR_366DAY, OPH_ODB_DIM_TIME_SIZE)) {
+	} else if (calendar == OPH_DIM_CALENDAR_366_DAY) {
 		y = g / 366;
 		ddd = g - 366 * y;
 		if (ddd < 0) {
@@ -303,8 +334,7 @@ int oph_day_to_date(long long g, int *yy, int *mm, int *dd, int *wd, int *yd, op
 		*mm = (mi + 2) % 12 + 1;
 		*yy = y + (mi + 2) / 12;
 		*dd = ddd - (mi * 306 + 5) / 10 + 1;
-	} else if (!strncmp(dim->calendar, OPH_DIM_TIME_CALENDAR_USER_DEFINED, OPH_ODB_DIM_TIME_SIZE)) {
-		pmesg(LOG_WARNING, __FILE__, __LINE__, "This option is not well supported\n");
+	} else if (calendar == OPH_DIM_CALENDAR_USER_DEFINED) {
 		int i;
 		long long days = 0, pdays = 0;
 		for (i = 0; i < OPH_ODB_DIM_MONTH_NUMBER; ++i) {
@@ -325,6 +355,22 @@ int oph_day_to_date(long long g, int *yy, int *mm, int *dd, int *wd, int *yd, op
 	} else
 		return OPH_DIM_DATA_ERROR;
 
+	return OPH_DIM_SUCCESS;
+}
+
+int oph_day_to_date(long long g, int *yy, int *mm, int *dd, int *wd, int *yd, oph_odb_dimension * dim)
+{
+	if (!yy || !mm || !dd || !dim)
+		return OPH_DIM_NULL_PARAM;
+	if (!dim->calendar || !strlen(dim->calendar))
+		return OPH_DIM_TIME_PARSING_ERROR;
+
+	char calendar = _oph_dim_calendar_of(dim);
+	if (calendar == OPH_DIM_CALENDAR_USER_DEFINED)
+		pmesg(LOG_WARNING, __FILE__, __LINE__, "This option is not well supported\n");
+	if (_oph_day_to_date(g, yy, mm, dd, calendar, dim))
+		return OPH_DIM_DATA_ERROR;
+
 	if (wd || yd) {
 		time_t rawtime;
 		time(&rawtime);
@@ -344,6 +390,32 @@ int oph_day_to_date(long long g, int *yy, int *mm, int *dd, int *wd, int *yd, op
 	return OPH_DIM_SUCCESS;
 }
 
+// Convert a time offset into seconds; steps are the same used in the inverse conversion
+int _oph_dim_units_to_seconds(char units, double *value)
+{
+	switch (units) {
+		case 'd':
+			*value *= 4.0;
+		case '6':
+			*value *= 2.0;
+		case '3':
+			*value *= 3.0;
+		case 'h':
+			*value *= 4.0;
+		case 'Q':
+			*value *= 3.0;
+		case 'v':
+			*value *= 5.0;
+		case 'm':
+			*value *= 60.0;
+		case 's':
+			break;
+		default:
+			return OPH_DIM_DATA_ERROR;
+	}
+	return OPH_DIM_SUCCESS;
+}
+
 int oph_dim_get_time_value_of(char *dim_row, unsigned int kk, oph_odb_dimension * dim, struct tm *tm_base, long long *base_time, long long *raw_value)
 {
 	if (!dim_row || !dim || !tm_base) {
@@ -359,26 +431,8 @@ int oph_dim_get_time_value_of(char *dim_row, unsigned int kk, oph_odb_dimension
 		return OPH_DIM_DATA_ERROR;
 
 	// Convert to "seconds"
-	switch (dim->units[0]) {
-		case 'd':
-			_value *= 4.0;
-		case '6':
-			_value *= 2.0;
-		case '3':
-			_value *= 3.0;
-		case 'h':
-			_value *= 4.0;
-		case 'Q':
-			_value *= 3.0;
-		case 'v':
-			_value *= 5.0;
-		case 'm':
-			_value *= 60.0;
-		case 's':
-			break;
-		default:
-			pmesg(LOG_WARNING, __FILE__, __LINE__, "Unrecognized or unsupported units\n");
-	}
+	if (_oph_dim_units_to_seconds(dim->units[0], &_value))
+		pmesg(LOG_WARNING, __FILE__, __LINE__, "Unrecognized or unsupported units\n");
 
 	// Add the base
 	long long _base_time = 0, *base_time_ = base_time ? base_time : &_base_time;
@@ -576,20 +630,12 @@ int oph_dim_get_month_size_of(struct tm *tm_time, oph_odb_dimension * dim)
 	return 0;
 }
 
-int oph_dim_is_in_time_group_of(char *dim_row, unsigned int kk, oph_odb_dimension * dim, char concept_level_out, struct tm *tm_prev, int midnight, int centroid, int *res)
+// Compare the calendar fields of dim_row[kk] (tm_value) with the ones of the previous element
+int _oph_dim_is_in_time_group_of(char *dim_row, unsigned int kk, oph_odb_dimension * dim, char concept_level_out, struct tm *tm_prev, struct tm *tm_value, long long base_time, int midnight,
+				 int centroid, int *res)
 {
-	if (!dim_row || !dim || !tm_prev || !res) {
-		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
-		return OPH_DIM_NULL_PARAM;
-	}
-	if (!dim->calendar || !strlen(dim->calendar))
-		return OPH_DIM_TIME_PARSING_ERROR;
-	*res = 0;
-
 	struct tm tm_base;
-	long long base_time;
-	if (oph_dim_get_time_value_of(dim_row, kk, dim, &tm_base, &base_time, NULL))
-		return OPH_DIM_DATA_ERROR;
+	memcpy(&tm_base, tm_value, sizeof(struct tm));
 	int msize, prev_week, base_week;
 
 	// Check for group
@@ -799,6 +845,136 @@ int oph_dim_is_in_time_group_of(char *dim_row, unsigned int kk, oph_odb_dimensio
 	return OPH_DIM_SUCCESS;
 }
 
+int oph_dim_is_in_time_group_of(char *dim_row, unsigned int kk, oph_odb_dimension * dim, char concept_level_out, struct tm *tm_prev, int midnight, int centroid, int *res)
+{
+	if (!dim_row || !dim || !tm_prev || !res) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_DIM_NULL_PARAM;
+	}
+	if (!dim->calendar || !strlen(dim->calendar))
+		return OPH_DIM_TIME_PARSING_ERROR;
+	*res = 0;
+
+	struct tm tm_base;
+	long long base_time;
+	if (oph_dim_get_time_value_of(dim_row, kk, dim, &tm_base, &base_time, NULL))
+		return OPH_DIM_DATA_ERROR;
+
+	return _oph_dim_is_in_time_group_of(dim_row, kk, dim, concept_level_out, tm_prev, &tm_base, base_time, midnight, centroid, res);
+}
+
+// Number of days from 1970-01-01 to a date of the proleptic Gregorian calendar (days exceeding the month length are carried over, as done by mktime)
+long long _oph_dim_days_from_civil(long long y, int m, int d)
+{
+	y -= m <= 2;
+	long long era = (y >= 0 ? y : y - 399) / 400;
+	long long yoe = y - era * 400;
+	long long doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+	return era * 146097 + yoe * 365 + yoe / 4 - yoe / 100 + doy - 719468;
+}
+
+int oph_dim_time_index_create(char *dim_row, unsigned int size, oph_odb_dimension * dim, oph_dim_time_index * index)
+{
+	if (!dim_row || !dim || !index) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_DIM_NULL_PARAM;
+	}
+	index->size = 0;
+	index->base_time = 0;
+	index->values = NULL;
+	if (!dim->calendar || !strlen(dim->calendar))
+		return OPH_DIM_TIME_PARSING_ERROR;
+
+	char calendar = _oph_dim_calendar_of(dim);
+	if (!calendar) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unrecognized calendar type '%s'\n", dim->calendar);
+		return OPH_DIM_DATA_ERROR;
+	}
+	if (calendar == OPH_DIM_CALENDAR_USER_DEFINED)
+		pmesg(LOG_WARNING, __FILE__, __LINE__, "This option is not well supported\n");
+
+	// Base time is parsed only once
+	if (oph_dim_get_base_time(dim, &index->base_time))
+		return OPH_DIM_DATA_ERROR;
+
+	double value = 0.0;
+	if (_oph_dim_units_to_seconds(dim->units[0], &value))
+		pmesg(LOG_WARNING, __FILE__, __LINE__, "Unrecognized or unsupported units\n");
+
+	if (size && !(index->values = (struct tm *) calloc(size, sizeof(struct tm)))) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Error allocating memory\n");
+		return OPH_DIM_SYSTEM_ERROR;
+	}
+
+	unsigned int kk;
+	long long days, first, next;
+	struct tm *tm_value;
+	for (kk = 0; kk < size; ++kk) {
+		if (oph_dim_get_double_value_of(dim_row, kk, dim->dimension_type, &value)) {
+			oph_dim_time_index_free(index);
+			return OPH_DIM_DATA_ERROR;
+		}
+		_oph_dim_units_to_seconds(dim->units[0], &value);
+		tm_value = index->values + kk;
+
+		// Same steps of oph_dim_get_time_value_of
+		days = (long long) value + index->base_time;
+		tm_value->tm_sec = days % OPH_ODB_DIM_SECOND_NUMBER;
+		days /= OPH_ODB_DIM_SECOND_NUMBER;
+		tm_value->tm_min = days % OPH_ODB_DIM_MINUTE_NUMBER;
+		days /= OPH_ODB_DIM_MINUTE_NUMBER;
+		tm_value->tm_hour = days % OPH_ODB_DIM_HOUR_NUMBER;
+		days /= OPH_ODB_DIM_HOUR_NUMBER;
+		if (_oph_day_to_date(days, &tm_value->tm_year, &tm_value->tm_mon, &tm_value->tm_mday, calendar, dim)) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unrecognized calendar type '%s'\n", dim->calendar);
+			oph_dim_time_index_free(index);
+			return OPH_DIM_DATA_ERROR;
+		}
+
+		// Week day and year day are evaluated on the proleptic Gregorian calendar as done by mktime in oph_day_to_date
+		days = _oph_dim_days_from_civil(tm_value->tm_year, tm_value->tm_mon, tm_value->tm_mday);
+		first = _oph_dim_days_from_civil(tm_value->tm_year, 1, 1);
+		next = _oph_dim_days_from_civil(tm_value->tm_year + 1, 1, 1);
+		if (days >= next)
+			first = next;
+		tm_value->tm_yday = days - first;
+		tm_value->tm_wday = ((days + 4) % OPH_ODB_DIM_WEEK_NUMBER + OPH_ODB_DIM_WEEK_NUMBER) % OPH_ODB_DIM_WEEK_NUMBER;
+		tm_value->tm_wday = (tm_value->tm_wday ? tm_value->tm_wday : OPH_ODB_DIM_WEEK_NUMBER) - 1;	// Sunday will be marked with the last index
+	}
+	index->size = size;
+
+	return OPH_DIM_SUCCESS;
+}
+
+int oph_dim_time_index_is_in_group_of(oph_dim_time_index * index, char *dim_row, unsigned int kk, oph_odb_dimension * dim, char concept_level_out, struct tm *tm_prev, int midnight,
+				      int evaluate_centroid, int *res)
+{
+	if (!index || !dim_row || !dim || !tm_prev || !res) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_DIM_NULL_PARAM;
+	}
+	if (kk >= index->size) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Index %u out of time axis\n", kk);
+		return OPH_DIM_DATA_ERROR;
+	}
+	*res = 0;
+
+	return _oph_dim_is_in_time_group_of(dim_row, kk, dim, concept_level_out, tm_prev, index->values + kk, index->base_time, midnight, evaluate_centroid, res);
+}
+
+int oph_dim_time_index_free(oph_dim_time_index * index)
+{
+	if (!index)
+		return OPH_DIM_NULL_PARAM;
+	if (index->values) {
+		free(index->values);
+		index->values = NULL;
+	}
+	index->size = 0;
+
+	return OPH_DIM_SUCCESS;
+}
+
 int oph_dim_update_value(char *dim_row, const char *dimension_type, unsigned int first, unsigned int last)
 {
 	if (!dim_row || !dimension_type) {
@@ -1436,6 +1612,62 @@ int oph_dim_retrieve_dimension(oph_odb_db_instance * db, char *dimension_table_n
 	return OPH_DIM_SUCCESS;
 }
 
+//Hash of the values of a dimension: it covers the size of the elements, the number of elements and the values
+static int _oph_dim_hash(size_t sizeof_type, long long dim_size, const char *dim_row, char hash[OPH_DIM_HASH_SIZE + 1])
+{
+	unsigned char digest[EVP_MAX_MD_SIZE];
+	unsigned int i, digest_len = 0;
+	unsigned long long header[2] = { (unsigned long long) sizeof_type, (unsigned long long) dim_size };
+
+	*hash = 0;
+	EVP_MD_CTX *ctx = EVP_MD_CTX_new();
+	if (!ctx) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Error allocating memory\n");
+		return OPH_DIM_SYSTEM_ERROR;
+	}
+	if (!EVP_DigestInit_ex(ctx, EVP_sha256(), NULL) || !EVP_DigestUpdate(ctx, header, sizeof(header)) || !EVP_DigestUpdate(ctx, dim_row, sizeof_type * dim_size)
+	    || !EVP_DigestFinal_ex(ctx, digest, &digest_len) || (2 * digest_len > OPH_DIM_HASH_SIZE)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to compute dimension hash\n");
+		EVP_MD_CTX_free(ctx);
+		return OPH_DIM_SYSTEM_ERROR;
+	}
+	EVP_MD_CTX_free(ctx);
+
+	for (i = 0; i < digest_len; i++)
+		snprintf(hash + 2 * i, 3, "%02x", digest[i]);
+
+	return OPH_DIM_SUCCESS;
+}
+
+//Run a query returning a single value; value is empty if no row is found, if it is NULL or if the query fails (e.g. for tables without hashes)
+static int _oph_dim_query_hash_table(oph_odb_db_instance * db, const char *query, char *value, size_t value_size)
+{
+	*value = 0;
+
+	if (mysql_query(db->dbms_instance->conn, query)) {
+		pmesg(LOG_DEBUG, __FILE__, __LINE__, "Dimension hashes are not available: %s\n", mysql_error(db->dbms_instance->conn));
+		return OPH_DIM_SUCCESS;
+	}
+
+	MYSQL_RES *res = mysql_store_result(db->dbms_instance->conn);
+	if (!res) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "MySQL query error: %s\n", mysql_error(db->dbms_instance->conn));
+		return OPH_DIM_MYSQL_ERROR;
+	}
+	MYSQL_ROW row;
+	if ((mysql_num_rows(res) == 1) && (row = mysql_fetch_row(res)) && row[0])
+		snprintf(value, value_size, "%s", row[0]);
+	mysql_free_result(res);
+
+	return OPH_DIM_SUCCESS;
+}
+
+static int _oph_dim_hash_confirm()
+{
+	char *value = getenv(OPH_DIM_HASH_CONFIRM_ENV);
+	return value && (!strcasecmp(value, "yes") || !strcmp(value, "1"));
+}
+
 int oph_dim_compare_dimension(oph_odb_db_instance * db, char *dimension_table_name, char *dim_type, long long dim_size, char *dim_row, int dimension_id, int *match)
 {
 	return oph_dim_compare_dimension2(db, dimension_table_name, dim_type, dim_size, 0, dim_row, dimension_id, match);
@@ -1460,7 +1692,30 @@ int oph_dim_compare_dimension2(oph_odb_db_instance * db, char *dimension_table_n
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Error in reading data type\n");
 		return OPH_DIM_DATA_ERROR;
 	}
-	//Insert into fragment
+	//Compare the hashes of the values, unless the stored values have to be transformed
+	if (!apply_clause && dim_row) {
+		char hash[OPH_DIM_HASH_SIZE + 1], stored_hash[OPH_DIM_HASH_SIZE + 1], hash_query[MYSQL_BUFLEN];
+		int n = snprintf(hash_query, MYSQL_BUFLEN, MYSQL_DIM_GET_DIMENSION_HASH, dimension_table_name, dimension_id);
+		if (n >= MYSQL_BUFLEN) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Size of query exceed query limit.\n");
+			return OPH_DIM_MYSQL_ERROR;
+		}
+		if (_oph_dim_query_hash_table(db, hash_query, stored_hash, OPH_DIM_HASH_SIZE + 1))
+			return OPH_DIM_MYSQL_ERROR;
+		if (*stored_hash) {
+			if (_oph_dim_hash(oph_dim_sizeof(type_flag), dim_size, dim_row, hash))
+				return OPH_DIM_SYSTEM_ERROR;
+			if (strcmp(hash, stored_hash)) {
+				*match = 1;
+				return OPH_DIM_SUCCESS;
+			}
+			if (!_oph_dim_hash_confirm()) {
+				*match = 0;
+				return OPH_DIM_SUCCESS;
+			}
+		}
+	}
+	//Compare the values on the server
 	MYSQL_STMT *stmt = mysql_stmt_init(db->dbms_instance->conn);
 	if (!stmt) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "MySQL statement error: %s\n", mysql_error(db->dbms_instance->conn));
@@ -1599,6 +1854,34 @@ int oph_dim_insert_into_dimension_table(oph_odb_db_instance * db, char *dimensio
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Error in reading data type\n");
 		return OPH_DIM_DATA_ERROR;
 	}
+
+	int n;
+	char hash[OPH_DIM_HASH_SIZE + 1];
+	*hash = 0;
+	if (dim_row) {
+		//Reuse the stored dimension with the same values, if any
+		char hash_query[MYSQL_BUFLEN], stored_id[OPH_DIM_BUFFER_LEN];
+		if (_oph_dim_hash(oph_dim_sizeof(type_flag), dim_size, dim_row, hash))
+			return OPH_DIM_SYSTEM_ERROR;
+		n = snprintf(hash_query, MYSQL_BUFLEN, MYSQL_DIM_FIND_DIMENSION_BY_HASH, dimension_table_name, hash);
+		if (n >= MYSQL_BUFLEN) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Size of query exceed query limit.\n");
+			return OPH_DIM_MYSQL_ERROR;
+		}
+		if (_oph_dim_query_hash_table(db, hash_query, stored_id, OPH_DIM_BUFFER_LEN))
+			return OPH_DIM_MYSQL_ERROR;
+		if (*stored_id) {
+			int match = 0;
+			if (_oph_dim_hash_confirm()
+			    && oph_dim_compare_dimension2(db, dimension_table_name, dimension_type, dim_size, MYSQL_DIMENSION, dim_row, (int) strtol(stored_id, NULL, 10), &match))
+				return OPH_DIM_MYSQL_ERROR;
+			if (!match) {
+				*dimension_id = (int) strtol(stored_id, NULL, 10);
+				pmesg(LOG_DEBUG, __FILE__, __LINE__, "Dimension %d of table '%s' is reused\n", *dimension_id, dimension_table_name);
+				return OPH_DIM_SUCCESS;
+			}
+		}
+	}
 	//Insert into fragment
 	MYSQL_STMT *stmt = mysql_stmt_init(db->dbms_instance->conn);
 	if (!stmt) {
@@ -1606,24 +1889,39 @@ int oph_dim_insert_into_dimension_table(oph_odb_db_instance * db, char *dimensio
 		return OPH_DIM_MYSQL_ERROR;
 	}
 
-	int query_buflen = 1 + snprintf(NULL, 0, MYSQL_DIM_INSERT_TABLE, dimension_table_name);
+	int query_buflen = 1 + snprintf(NULL, 0, MYSQL_DIM_INSERT_TABLE_WITH_HASH, dimension_table_name, hash);
 	long long max_size = QUERY_BUFLEN;
 	oph_pid_get_buffer_size(&max_size);
 	if (query_buflen >= max_size) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Buffer size (%ld bytes) is too small.\n", max_size);
+		mysql_stmt_close(stmt);
 		return OPH_DIM_MYSQL_ERROR;
 	}
 
 	char select_query[max_size];
-	int n = snprintf(select_query, max_size, MYSQL_DIM_INSERT_TABLE, dimension_table_name);
+	if (*hash)
+		n = snprintf(select_query, max_size, MYSQL_DIM_INSERT_TABLE_WITH_HASH, dimension_table_name, hash);
+	else
+		n = snprintf(select_query, max_size, MYSQL_DIM_INSERT_TABLE, dimension_table_name);
 	if (n >= max_size) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Size of query exceed query limit.\n");
+		mysql_stmt_close(stmt);
 		return OPH_DIM_MYSQL_ERROR;
 	}
 	if (mysql_stmt_prepare(stmt, select_query, strlen(select_query))) {
-		pmesg(LOG_ERROR, __FILE__, __LINE__, "MySQL statement error: %u: %s\n", mysql_stmt_errno(stmt), mysql_stmt_error(stmt));
-		mysql_stmt_close(stmt);
-		return OPH_DIM_MYSQL_ERROR;
+		//Tables created by previous versions do not store hashes
+		if (!*hash) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "MySQL statement error: %u: %s\n", mysql_stmt_errno(stmt), mysql_stmt_error(stmt));
+			mysql_stmt_close(stmt);
+			return OPH_DIM_MYSQL_ERROR;
+		}
+		pmesg(LOG_DEBUG, __FILE__, __LINE__, "Dimension hash will not be stored: %s\n", mysql_stmt_error(stmt));
+		n = snprintf(select_query, max_size, MYSQL_DIM_INSERT_TABLE, dimension_table_name);
+		if ((n >= max_size) || mysql_stmt_prepare(stmt, select_query, strlen(select_query))) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "MySQL statement error: %u: %s\n", mysql_stmt_errno(stmt), mysql_stmt_error(stmt));
+			mysql_stmt_close(stmt);
+			return OPH_DIM_MYSQL_ERROR;
+		}
 	}
 
 	int param_count = mysql_stmt_param_count(stmt);
@@ -48,6 +48,7 @@ struct _thread_struct_dproc {
 	oph_odb_dbms_instance_list *dbmss;
 	int *datacubexdb_number;
 	char no_frag;
+	char lazy;
 };
 typedef struct _thread_struct_dproc thread_struct_dproc;
 
@@ -65,6 +66,7 @@ void *exec_thread_dproc(void *ts)
 	int *datacubexdb_number = ((thread_struct_dproc *) ts)->datacubexdb_number;
 
 	char no_frag = ((thread_struct_dproc *) ts)->no_frag;
+	char lazy = ((thread_struct_dproc *) ts)->lazy;
 
 	oph_ioserver_handler *server = NULL;
 
@@ -179,8 +181,8 @@ void *exec_thread_dproc(void *ts)
 
 						frag_count++;
 
-						//Delete fragment
-						if (oph_dc_delete_fragment(server, &(frags->value[k]))) {
+						//Delete fragment (fragments of lazy datacubes are views)
+						if (lazy ? oph_dc_delete_fragment_view(server, &(frags->value[k])) : oph_dc_delete_fragment(server, &(frags->value[k]))) {
 							pmesg(LOG_ERROR, __FILE__, __LINE__, "Error while dropping table.\n");
 							logging(LOG_ERROR, __FILE__, __LINE__, id_container, OPH_LOG_OPH_DELETE_DROP_FRAGMENT_ERROR, (frags->value[j]).fragment_name);
 							res = OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
@@ -326,6 +328,19 @@ int oph_dproc_delete_data(int id_datacube, int id_container, char *fragment_ids,
 
 	free(id_dbs);
 
+	int lazy = 0;
+	if (oph_odb_cube_is_lazy(&oDB_slave, id_datacube, &lazy)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to check if datacube is lazy.\n");
+		logging(LOG_ERROR, __FILE__, __LINE__, id_container, "Unable to check if datacube is lazy.\n");
+		oph_odb_stge_free_fragment_list(&frags);
+		oph_odb_stge_free_db_list(&dbs);
+		oph_odb_stge_free_dbms_list(&dbmss);
+		oph_odb_free_ophidiadb_thread(&oDB_slave);
+		mysql_thread_end();
+		free(datacubexdb_number);
+		return OPH_ANALYTICS_OPERATOR_MYSQL_ERROR;
+	}
+
 	pthread_t threads[thread_number];
 	pthread_attr_t attr;
 	pthread_attr_init(&attr);
@@ -343,6 +358,7 @@ int oph_dproc_delete_data(int id_datacube, int id_container, char *fragment_ids,
 		ts[l].dbmss = &dbmss;
 		ts[l].datacubexdb_number = datacubexdb_number;
 		ts[l].no_frag = no_frag;
+		ts[l].lazy = lazy ? 1 : 0;
 
 		rc = pthread_create(&threads[l], &attr, exec_thread_dproc, (void *) &(ts[l]));
 		if (rc) {
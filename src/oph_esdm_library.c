@@ -30,6 +30,8 @@
 
 #include "oph_dimension_library.h"
 #include "oph-lib-binary-io.h"
+#include "oph_reorder_library.h"
+#include "oph_coord_index_library.h"
 #include "debug.h"
 
 #include "oph_log_error_codes.h"
@@ -523,42 +525,45 @@ int oph_esdm_get_dim_array(int id_container, esdm_dataset_t * dataset, int dim_i
 	return OPH_ESDM_SUCCESS;
 }
 
-int oph_esdm_index_by_value(int id_container, ESDM_var * measure, int dim_id, esdm_type_t dim_type, int dim_size, char *value, int want_start, double offset, int *valorder, int *coord_index,
-			    char out_of_bound)
+int oph_esdm_coord_index_init(int id_container, ESDM_var * measure, int dim_id, esdm_type_t dim_type, int dim_size, oph_coord_index * index)
 {
-	if (!dim_size || !value || !coord_index || !valorder) {
+	if (!measure || !dim_size || !index) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
 		return OPH_ESDM_ERROR;
 	}
 
-	void *binary_dim = NULL;
-	int nearest_point = want_start > 0;
-	//I need to evaluate the order of the dimension values: ascending or descending
-	int order = 1;		//Default is ascending
-	int exact_value = 0;	//If I find the exact value
-	int i, end_dim_size = dim_size - 1;
-
-	if (dim_type == SMD_DTYPE_INT8)
-		binary_dim = (void *) malloc(sizeof(char) * dim_size);
-	else if (dim_type == SMD_DTYPE_INT16)
-		binary_dim = (void *) malloc(sizeof(short) * dim_size);
-	else if (dim_type == SMD_DTYPE_INT32)
-		binary_dim = (void *) malloc(sizeof(int) * dim_size);
-	else if (dim_type == SMD_DTYPE_INT64)
-		binary_dim = (void *) malloc(sizeof(long long) * dim_size);
-	else if (dim_type == SMD_DTYPE_FLOAT)
-		binary_dim = (void *) malloc(sizeof(float) * dim_size);
-	else if (dim_type == SMD_DTYPE_DOUBLE)
-		binary_dim = (void *) malloc(sizeof(double) * dim_size);
-	else {
+	oph_coord_index_type type;
+	size_t type_size;
+	if (dim_type == SMD_DTYPE_INT8) {
+		type = OPH_COORD_INDEX_BYTE;
+		type_size = sizeof(char);
+	} else if (dim_type == SMD_DTYPE_INT16) {
+		type = OPH_COORD_INDEX_SHORT;
+		type_size = sizeof(short);
+	} else if (dim_type == SMD_DTYPE_INT32) {
+		type = OPH_COORD_INDEX_INT;
+		type_size = sizeof(int);
+	} else if (dim_type == SMD_DTYPE_INT64) {
+		type = OPH_COORD_INDEX_LONG;
+		type_size = sizeof(long long);
+	} else if (dim_type == SMD_DTYPE_FLOAT) {
+		type = OPH_COORD_INDEX_FLOAT;
+		type_size = sizeof(float);
+	} else if (dim_type == SMD_DTYPE_DOUBLE) {
+		type = OPH_COORD_INDEX_DOUBLE;
+		type_size = sizeof(double);
+	} else {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Data type not supported\n");
 		return OPH_ESDM_ERROR;
 	}
+
+	void *binary_dim = (void *) malloc(type_size * dim_size);
 	if (!binary_dim) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Memory error\n");
 		return OPH_ESDM_ERROR;
 	}
 
+	int i;
 	int64_t const *size = esdm_dataset_get_actual_size(measure->dim_dataset[dim_id]);
 	for (i = 0; i < measure->dim_dspace[dim_id]->dims; i++)
 		if (!measure->dim_dspace[dim_id]->size[i])
@@ -571,374 +576,67 @@ int oph_esdm_index_by_value(int id_container, ESDM_var * measure, int dim_id, es
 		return OPH_ESDM_ERROR;
 	}
 
-	if (dim_type == SMD_DTYPE_INT8) {
+	i = oph_coord_index_init(index, type, binary_dim, dim_size);
+	free(binary_dim);
+	if (i) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to index dimension values\n");
+		return OPH_ESDM_ERROR;
+	}
 
-		char *array_val = binary_dim, value_ = (char) (strtol(value, (char **) NULL, 10));
-		if (offset)
-			value_ += (char) (want_start ? -offset : offset);
-		//Check order of dimension values
-		if (array_val[0] > array_val[end_dim_size]) {	//Descending
-			order = 0;
-			if (out_of_bound && (value_ <= array_val[0]) && (value_ >= array_val[end_dim_size]))
-				out_of_bound = 0;
-		} else if (out_of_bound && (value_ >= array_val[0]) && (value_ <= array_val[end_dim_size]))
-			out_of_bound = 0;
-		if (out_of_bound) {
-			pmesg(LOG_ERROR, __FILE__, __LINE__, "Value %d out of the boundaries [%d, %d]\n", value_, array_val[0], array_val[end_dim_size]);
-			logging(LOG_ERROR, __FILE__, __LINE__, id_container, "Value %d out of the boundaries [%d, %d]\n", value_, array_val[0], array_val[end_dim_size]);
-			free(binary_dim);
-			return OPH_ESDM_BOUND_ERROR;
-		}
-		if (order) {
-			//Ascending
-			for (i = 0; i < dim_size; i++) {
-				if (array_val[i] >= value_) {
-					if (array_val[i] == value_)
-						exact_value = 1;
-					break;
-				}
-			}
-			if (!exact_value) {
-				if (nearest_point) {
-					if ((i > 0) && ((i == dim_size) || (value_ - array_val[i - 1] < array_val[i] - value_)))
-						i--;
-				} else if (want_start) {
-					if (i == dim_size)
-						i--;
-				} else if (i)
-					i--;
-			}
-		}		//End if(order)
-		else {
-			//Descending
-			for (i = dim_size - 1; i >= 0; i--) {
-				if (array_val[i] >= value_) {
-					if (array_val[i] == value_)
-						exact_value = 1;
-					break;
-				}
-			}
-			if (!exact_value) {
-				if (nearest_point) {
-					if ((i < dim_size - 1) && ((i < 0) || (value_ - array_val[i + 1] < array_val[i] - value_)))
-						i++;
-				} else if (want_start) {
-					if (i < 0)
-						i = 0;
-				} else if (i < dim_size - 1)
-					i++;
-			}
-		}		//End else if(order)
-	}			//End if(dim_type == NC_BYTE){
-	else if (dim_type == SMD_DTYPE_INT16) {
-
-		short *array_val = binary_dim, value_ = (short) (strtol(value, (char **) NULL, 10));
-		if (offset)
-			value_ += (short) (want_start ? -offset : offset);
-		//Check order of dimension values
-		if (array_val[0] > array_val[end_dim_size]) {	//Descending
-			order = 0;
-			if (out_of_bound && (value_ <= array_val[0]) && (value_ >= array_val[end_dim_size]))
-				out_of_bound = 0;
-		} else if (out_of_bound && (value_ >= array_val[0]) && (value_ <= array_val[end_dim_size]))
-			out_of_bound = 0;
-		if (out_of_bound) {
-			pmesg(LOG_ERROR, __FILE__, __LINE__, "Value %d out of the boundaries [%d, %d]\n", value_, array_val[0], array_val[end_dim_size]);
-			logging(LOG_ERROR, __FILE__, __LINE__, id_container, "Value %d out of the boundaries [%d, %d]\n", value_, array_val[0], array_val[end_dim_size]);
-			free(binary_dim);
-			return OPH_ESDM_BOUND_ERROR;
-		}
-		if (order) {
-			//Ascending
-			for (i = 0; i < dim_size; i++) {
-				if (array_val[i] >= value_) {
-					if (array_val[i] == value_)
-						exact_value = 1;
-					break;
-				}
-			}
-			if (!exact_value) {
-				if (nearest_point) {
-					if ((i > 0) && ((i == dim_size) || (value_ - array_val[i - 1] < array_val[i] - value_)))
-						i--;
-				} else if (want_start) {
-					if (i == dim_size)
-						i--;
-				} else if (i)
-					i--;
-			}
-		}		//End if(order)
-		else {
-			//Descending
-			for (i = dim_size - 1; i >= 0; i--) {
-				if (array_val[i] >= value_) {
-					if (array_val[i] == value_)
-						exact_value = 1;
-					break;
-				}
-			}
-			if (!exact_value) {
-				if (nearest_point) {
-					if ((i < dim_size - 1) && ((i < 0) || (value_ - array_val[i + 1] < array_val[i] - value_)))
-						i++;
-				} else if (want_start) {
-					if (i < 0)
-						i = 0;
-				} else if (i < dim_size - 1)
-					i++;
-			}
-		}		//End else if(order)
-	}			//End if(dim_type == NC_SHORT){
-	else if (dim_type == SMD_DTYPE_INT32) {
-
-		int *array_val = binary_dim, value_ = (int) (strtol(value, (char **) NULL, 10));
-		if (offset)
-			value_ += (int) (want_start ? -offset : offset);
-		//Check order of dimension values
-		if (array_val[0] > array_val[end_dim_size]) {	//Descending
-			order = 0;
-			if (out_of_bound && (value_ <= array_val[0]) && (value_ >= array_val[end_dim_size]))
-				out_of_bound = 0;
-		} else if (out_of_bound && (value_ >= array_val[0]) && (value_ <= array_val[end_dim_size]))
-			out_of_bound = 0;
-		if (out_of_bound) {
-			pmesg(LOG_ERROR, __FILE__, __LINE__, "Value %d out of the boundaries [%d, %d]\n", value_, array_val[0], array_val[end_dim_size]);
-			logging(LOG_ERROR, __FILE__, __LINE__, id_container, "Value %d out of the boundaries [%d, %d]\n", value_, array_val[0], array_val[end_dim_size]);
-			free(binary_dim);
-			return OPH_ESDM_BOUND_ERROR;
-		}
-		if (order) {
-			//Ascending
-			for (i = 0; i < dim_size; i++) {
-				if (array_val[i] >= value_) {
-					if (array_val[i] == value_)
-						exact_value = 1;
-					break;
-				}
-			}
-			if (!exact_value) {
-				if (nearest_point) {
-					if ((i > 0) && ((i == dim_size) || (value_ - array_val[i - 1] < array_val[i] - value_)))
-						i--;
-				} else if (want_start) {
-					if (i == dim_size)
-						i--;
-				} else if (i)
-					i--;
-			}
-		}		//End if(order)
-		else {
-			//Descending
-			for (i = dim_size - 1; i >= 0; i--) {
-				if (array_val[i] >= value_) {
-					if (array_val[i] == value_)
-						exact_value = 1;
-					break;
-				}
-			}
-			if (!exact_value) {
-				if (nearest_point) {
-					if ((i < dim_size - 1) && ((i < 0) || (value_ - array_val[i + 1] < array_val[i] - value_)))
-						i++;
-				} else if (want_start) {
-					if (i < 0)
-						i = 0;
-				} else if (i < dim_size - 1)
-					i++;
-			}
-		}		//End else if(order)
-	}			//End if(dim_type == NC_INT){
-	else if (dim_type == SMD_DTYPE_INT64) {
-
-		long long *array_val = binary_dim, value_ = (long long) (strtoll(value, (char **) NULL, 10));
-		if (offset)
-			value_ += (long long) (want_start ? -offset : offset);
-		//Check order of dimension values
-		if (array_val[0] > array_val[end_dim_size]) {	//Descending
-			order = 0;
-			if (out_of_bound && (value_ <= array_val[0]) && (value_ >= array_val[end_dim_size]))
-				out_of_bound = 0;
-		} else if (out_of_bound && (value_ >= array_val[0]) && (value_ <= array_val[end_dim_size]))
-			out_of_bound = 0;
-		if (out_of_bound) {
-			pmesg(LOG_ERROR, __FILE__, __LINE__, "Value %lld out of the boundaries [%lld, %lld]\n", value_, array_val[0], array_val[end_dim_size]);
-			logging(LOG_ERROR, __FILE__, __LINE__, id_container, "Value %lld out of the boundaries [%lld, %lld]\n", value_, array_val[0], array_val[end_dim_size]);
-			free(binary_dim);
-			return OPH_ESDM_BOUND_ERROR;
-		}
-		if (order) {
-			//Ascending
-			for (i = 0; i < dim_size; i++) {
-				if (array_val[i] >= value_) {
-					if (array_val[i] == value_)
-						exact_value = 1;
-					break;
-				}
-			}
-			if (!exact_value) {
-				if (nearest_point) {
-					if ((i > 0) && ((i == dim_size) || (value_ - array_val[i - 1] < array_val[i] - value_)))
-						i--;
-				} else if (want_start) {
-					if (i == dim_size)
-						i--;
-				} else if (i)
-					i--;
-			}
-		}		//End if(order)
-		else {
-			//Descending
-			for (i = dim_size - 1; i >= 0; i--) {
-				if (array_val[i] >= value_) {
-					if (array_val[i] == value_)
-						exact_value = 1;
-					break;
-				}
-			}
-			if (!exact_value) {
-				if (nearest_point) {
-					if ((i < dim_size - 1) && ((i < 0) || (value_ - array_val[i + 1] < array_val[i] - value_)))
-						i++;
-				} else if (want_start) {
-					if (i < 0)
-						i = 0;
-				} else if (i < dim_size - 1)
-					i++;
-			}
-		}		//End else if(order)
-	}			//End if(dim_type == NC_INT64){
-	else if (dim_type == SMD_DTYPE_FLOAT) {
-
-		float *array_val = binary_dim, value_ = (float) (strtof(value, NULL));
-		if (offset)
-			value_ += (float) (want_start ? -offset : offset);
-		//Check order of dimension values
-		if (array_val[0] > array_val[end_dim_size]) {	//Descending
-			order = 0;
-			if (out_of_bound && (value_ <= array_val[0]) && (value_ >= array_val[end_dim_size]))
-				out_of_bound = 0;
-		} else if (out_of_bound && (value_ >= array_val[0]) && (value_ <= array_val[end_dim_size]))
-			out_of_bound = 0;
-		if (out_of_bound) {
-			pmesg(LOG_ERROR, __FILE__, __LINE__, "Value %f out of the boundaries [%f, %f]\n", value_, array_val[0], array_val[end_dim_size]);
-			logging(LOG_ERROR, __FILE__, __LINE__, id_container, "Value %f out of the boundaries [%f, %f]\n", value_, array_val[0], array_val[end_dim_size]);
-			free(binary_dim);
-			return OPH_ESDM_BOUND_ERROR;
-		}
-		if (order) {
-			//Ascending
-			for (i = 0; i < dim_size; i++) {
-				if (array_val[i] >= value_) {
-					if (array_val[i] == value_)
-						exact_value = 1;
-					break;
-				}
-			}
-			if (!exact_value) {
-				if (nearest_point) {
-					if ((i > 0) && ((i == dim_size) || (value_ - array_val[i - 1] < array_val[i] - value_)))
-						i--;
-				} else if (want_start) {
-					if (i == dim_size)
-						i--;
-				} else if (i)
-					i--;
-			}
-		}		//End if(order)
-		else {
-			//Descending
-			for (i = dim_size - 1; i >= 0; i--) {
-				if (array_val[i] >= value_) {
-					if (array_val[i] == value_)
-						exact_value = 1;
-					break;
-				}
-			}
-			if (!exact_value) {
-				if (nearest_point) {
-					if ((i < dim_size - 1) && ((i < 0) || (value_ - array_val[i + 1] < array_val[i] - value_)))
-						i++;
-				} else if (want_start) {
-					if (i < 0)
-						i = 0;
-				} else if (i < dim_size - 1)
-					i++;
+	return OPH_ESDM_SUCCESS;
+}
+
+int oph_esdm_index_by_value2(int id_container, oph_coord_index * index, char *value, int want_start, double offset, int *valorder, int *coord_index, char out_of_bound)
+{
+	if (!index || !value || !coord_index || !valorder) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_ESDM_ERROR;
+	}
+
+	oph_coord_index_value value_;
+	if (oph_coord_index_parse_value(index, value, want_start, offset, &value_)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to parse value '%s'\n", value);
+		return OPH_ESDM_ERROR;
+	}
+
+	switch (oph_coord_index_find(index, &value_, want_start, out_of_bound, coord_index)) {
+		case OPH_COORD_INDEX_SUCCESS:
+			break;
+		case OPH_COORD_INDEX_BOUND_ERROR:
+			if (index->long_values) {
+				pmesg(LOG_ERROR, __FILE__, __LINE__, "Value %lld out of the boundaries [%lld, %lld]\n", value_.l, index->long_values[0], index->long_values[index->size - 1]);
+				logging(LOG_ERROR, __FILE__, __LINE__, id_container, "Value %lld out of the boundaries [%lld, %lld]\n", value_.l, index->long_values[0], index->long_values[index->size - 1]);
+			} else {
+				pmesg(LOG_ERROR, __FILE__, __LINE__, "Value %g out of the boundaries [%g, %g]\n", value_.d, index->values[0], index->values[index->size - 1]);
+				logging(LOG_ERROR, __FILE__, __LINE__, id_container, "Value %g out of the boundaries [%g, %g]\n", value_.d, index->values[0], index->values[index->size - 1]);
 			}
-		}		//End else if(order)
-	}			//End if(dim_type == NC_FLOAT){
-	else if (dim_type == SMD_DTYPE_DOUBLE) {
-
-		double *array_val = binary_dim, value_ = (double) (strtod(value, NULL));
-		if (offset)
-			value_ += want_start ? -offset : offset;
-		//Check order of dimension values
-		if (array_val[0] > array_val[end_dim_size]) {	//Descending
-			order = 0;
-			if (out_of_bound && (value_ <= array_val[0]) && (value_ >= array_val[end_dim_size]))
-				out_of_bound = 0;
-		} else if (out_of_bound && (value_ >= array_val[0]) && (value_ <= array_val[end_dim_size]))
-			out_of_bound = 0;
-		if (out_of_bound) {
-			pmesg(LOG_ERROR, __FILE__, __LINE__, "Value %f out of the boundaries [%f, %f]\n", value_, array_val[0], array_val[end_dim_size]);
-			logging(LOG_ERROR, __FILE__, __LINE__, id_container, "Value %f out of the boundaries [%f, %f]\n", value_, array_val[0], array_val[end_dim_size]);
-			free(binary_dim);
 			return OPH_ESDM_BOUND_ERROR;
-		}
-		if (order) {
-			//Ascending
-			for (i = 0; i < dim_size; i++) {
-				if (array_val[i] >= value_) {
-					if (array_val[i] == value_) {
-						exact_value = 1;
-					}
-					break;
-				}
-			}
-			if (!exact_value) {
-				if (nearest_point) {
-					if ((i > 0) && ((i == dim_size) || (value_ - array_val[i - 1] < array_val[i] - value_)))
-						i--;
-				} else if (want_start) {
-					if (i == dim_size)
-						i--;
-				} else if (i)
-					i--;
-			}
-		}		//End if(order)
-		else {
-			//Descending
-			for (i = dim_size - 1; i >= 0; i--) {
-				if (array_val[i] >= value_) {
-					if (array_val[i] == value_)
-						exact_value = 1;
-					break;
-				}
-			}
-			if (!exact_value) {
-				if (nearest_point) {
-					if ((i < dim_size - 1) && ((i < 0) || (value_ - array_val[i + 1] < array_val[i] - value_)))
-						i++;
-				} else if (want_start) {
-					if (i < 0)
-						i = 0;
-				} else if (i < dim_size - 1)
-					i++;
-			}
-		}		//End else if(order)
-	}			//End if(dim_type == NC_DOUBLE){
-	else {
-		pmesg(LOG_ERROR, __FILE__, __LINE__, "Variable type not supported\n");
-		logging(LOG_ERROR, __FILE__, __LINE__, id_container, OPH_LOG_GENERIC_VAR_TYPE_NOT_SUPPORTED, dim_type);
-		free(binary_dim);
-		return OPH_ESDM_ERROR;
+		default:
+			return OPH_ESDM_ERROR;
 	}
+	*valorder = index->order;
 
-	free(binary_dim);
-	*coord_index = i;
-	*valorder = order;
 	return OPH_ESDM_SUCCESS;
 }
 
+int oph_esdm_index_by_value(int id_container, ESDM_var * measure, int dim_id, esdm_type_t dim_type, int dim_size, char *value, int want_start, double offset, int *valorder, int *coord_index,
+			    char out_of_bound)
+{
+	if (!dim_size || !value || !coord_index || !valorder) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_ESDM_ERROR;
+	}
+
+	oph_coord_index index;
+	int res;
+	if ((res = oph_esdm_coord_index_init(id_container, measure, dim_id, dim_type, dim_size, &index)))
+		return res;
+	res = oph_esdm_index_by_value2(id_container, &index, value, want_start, offset, valorder, coord_index, out_of_bound);
+	oph_coord_index_free(&index);
+
+	return res;
+}
+
 int oph_esdm_check_subset_string(char *curfilter, int i, ESDM_var * measure, int is_index, double offset, char out_of_bound)
 {
 	int ii, error = 0;
@@ -1106,20 +804,29 @@ int oph_esdm_check_subset_string(char *curfilter, int i, ESDM_var * measure, int
 				return OPH_ESDM_ERROR;
 			}
 
+			//Coordinate values are read once for both the bounds of the interval
+			oph_coord_index index;
+			if ((error = oph_esdm_coord_index_init(OPH_GENERIC_CONTAINER_ID, measure, i, measure->dim_dspace[i]->type, measure->dims_length[i], &index))) {
+				pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to read dimension information\n");
+				logging(LOG_ERROR, __FILE__, __LINE__, OPH_GENERIC_CONTAINER_ID, OPH_LOG_OPH_IMPORTESDM_INVALID_INPUT_STRING, "");
+				return error;
+			}
+
 			int coord_index = -1;
 			int want_start = -1;
 			int order = 1;	//It will be changed by the following function (1 ascending, 0 descending)
 			//Extract index of the point given the dimension value
-			if ((error = oph_esdm_index_by_value
-			     (OPH_GENERIC_CONTAINER_ID, measure, i, measure->dim_dspace[i]->type, measure->dims_length[i], startfilter, want_start, offset, &order, &coord_index, out_of_bound))) {
+			if ((error = oph_esdm_index_by_value2(OPH_GENERIC_CONTAINER_ID, &index, startfilter, want_start, offset, &order, &coord_index, out_of_bound))) {
 				pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to read dimension information\n");
 				logging(LOG_ERROR, __FILE__, __LINE__, OPH_GENERIC_CONTAINER_ID, OPH_LOG_OPH_IMPORTESDM_INVALID_INPUT_STRING, "");
+				oph_coord_index_free(&index);
 				return error;
 			}
 			//Value too big
 			if (coord_index >= (int) measure->dims_length[i]) {
 				pmesg(LOG_ERROR, __FILE__, __LINE__, "Values exceed dimensions bound\n");
 				logging(LOG_ERROR, __FILE__, __LINE__, OPH_GENERIC_CONTAINER_ID, OPH_LOG_OPH_IMPORTESDM_INVALID_INPUT_STRING);
+				oph_coord_index_free(&index);
 				return OPH_ESDM_BOUND_ERROR;
 			}
 			measure->dims_start_index[i] = coord_index;
@@ -1128,8 +835,9 @@ int oph_esdm_check_subset_string(char *curfilter, int i, ESDM_var * measure, int
 			want_start = 0;
 			order = 1;	//It will be changed by the following function (1 ascending, 0 descending)
 			//Extract index of the point given the dimension value
-			if ((error = oph_esdm_index_by_value
-			     (OPH_GENERIC_CONTAINER_ID, measure, i, measure->dim_dspace[i]->type, measure->dims_length[i], endfilter, want_start, offset, &order, &coord_index, out_of_bound))) {
+			error = oph_esdm_index_by_value2(OPH_GENERIC_CONTAINER_ID, &index, endfilter, want_start, offset, &order, &coord_index, out_of_bound);
+			oph_coord_index_free(&index);
+			if (error) {
 				pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to read dimension information\n");
 				logging(LOG_ERROR, __FILE__, __LINE__, OPH_GENERIC_CONTAINER_ID, OPH_LOG_OPH_IMPORTESDM_INVALID_INPUT_STRING);
 				return error;
@@ -1154,41 +862,9 @@ int oph_esdm_check_subset_string(char *curfilter, int i, ESDM_var * measure, int
 	return OPH_ESDM_SUCCESS;
 }
 
-int _oph_esdm_cache_to_buffer(short int tot_dim_number, short int curr_dim, unsigned int *counters, unsigned int *limits, unsigned int *products, long long *index, char *binary_cache,
-			      char *binary_insert, size_t sizeof_var)
-{
-	int i = 0;
-	long long addr = 0;
-
-	if (tot_dim_number > curr_dim) {
-
-		if (curr_dim != 0)
-			counters[curr_dim] = 0;
-		while (counters[curr_dim] < limits[curr_dim]) {
-			_oph_esdm_cache_to_buffer(tot_dim_number, curr_dim + 1, counters, limits, products, index, binary_cache, binary_insert, sizeof_var);
-			counters[curr_dim]++;
-		}
-		return OPH_ESDM_SUCCESS;
-	}
-
-	if (tot_dim_number == curr_dim) {
-		addr = 0;
-		for (i = 0; i < tot_dim_number; i++) {
-			addr += counters[i] * products[i];
-		}
-
-		memcpy(binary_insert + (*index) * sizeof_var, binary_cache + addr * sizeof_var, sizeof_var);
-		(*index)++;
-		return OPH_ESDM_SUCCESS;
-	}
-
-	return OPH_ESDM_SUCCESS;
-}
-
 int oph_esdm_cache_to_buffer(short int tot_dim_number, unsigned int *counters, unsigned int *limits, unsigned int *products, char *binary_cache, char *binary_insert, size_t sizeof_var)
 {
-	long long index = 0;
-	return _oph_esdm_cache_to_buffer(tot_dim_number, 0, counters, limits, products, &index, binary_cache, binary_insert, sizeof_var);
+	return oph_reorder_cache_to_buffer(tot_dim_number, counters, limits, products, binary_cache, binary_insert, sizeof_var) ? OPH_ESDM_ERROR : OPH_ESDM_SUCCESS;
 }
 
 int oph_esdm_populate_fragment2(oph_ioserver_handler * server, oph_odb_fragment * frag, int tuplexfrag_number, int array_length, int compressed, ESDM_var * measure)
@@ -28,6 +28,7 @@
 #include <math.h>
 
 #include "oph-lib-binary-io.h"
+#include "oph_reorder_library.h"
 #include "debug.h"
 
 #include "oph_log_error_codes.h"
@@ -49,42 +50,9 @@ struct timeval *res, *x, *y;
 
 extern int msglevel;
 
-int _oph_fits_cache_to_buffer(short int tot_dim_number, short int curr_dim, unsigned int *counters, unsigned int *limits, unsigned int *products, long long *index, char *binary_cache,
-			      char *binary_insert, size_t sizeof_var)
-{
-	int i = 0;
-	long long addr = 0;
-
-
-	if (tot_dim_number > curr_dim) {
-
-		if (curr_dim != 0)
-			counters[curr_dim] = 0;
-		while (counters[curr_dim] < limits[curr_dim]) {
-			_oph_fits_cache_to_buffer(tot_dim_number, curr_dim + 1, counters, limits, products, index, binary_cache, binary_insert, sizeof_var);
-			counters[curr_dim]++;
-		}
-		return 0;
-	}
-
-	if (tot_dim_number == curr_dim) {
-		addr = 0;
-		for (i = 0; i < tot_dim_number; i++) {
-			addr += counters[i] * products[i];
-		}
-
-		memcpy(binary_insert + (*index) * sizeof_var, binary_cache + addr * sizeof_var, sizeof_var);
-		(*index)++;
-		return 0;
-	}
-
-	return 0;
-}
-
 int oph_fits_cache_to_buffer(short int tot_dim_number, unsigned int *counters, unsigned int *limits, unsigned int *products, char *binary_cache, char *binary_insert, size_t sizeof_var)
 {
-	long long index = 0;
-	return _oph_fits_cache_to_buffer(tot_dim_number, 0, counters, limits, products, &index, binary_cache, binary_insert, sizeof_var);
+	return oph_reorder_cache_to_buffer(tot_dim_number, counters, limits, products, binary_cache, binary_insert, sizeof_var) ? OPH_FITS_ERROR : OPH_FITS_SUCCESS;
 }
 
 int oph_fits_populate_fragment_from_fits2(oph_ioserver_handler * server, oph_odb_fragment * frag, fitsfile * fptr, int tuplexfrag_number, int array_length, int compressed, FITS_var * measure)
@@ -22,6 +22,8 @@
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
+#include <ctype.h>
+#include <limits.h>
 
 #include "debug.h"
 
@@ -35,94 +37,21 @@ int oph_ids_get_id_from_string(char *string, int position, int *id)
 		return OPH_IDS_ERROR;
 	}
 
-	int res;
-	if (oph_ids_count_number_of_ids(string, &res)) {
+	oph_ids_set set, subset;
+	if (oph_ids_set_parse(string, &set)) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to check ID string\n");
 		return OPH_IDS_ERROR;
 	}
-
-	if (position >= res) {
+	if (oph_ids_set_subset(&set, position, 1, &subset)) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Specified position is out of string range\n");
+		oph_ids_set_free(&set);
 		return OPH_IDS_ERROR;
 	}
+	*id = subset.intervals[0].first;
 
-	int count = 0;
-	int a, b;
-
-	char *hyphen;
-	char *semicolon;
-	char *start;
-	char buffer[OPH_IDS_LONGLEN], buffer2[OPH_IDS_LONGLEN];
-
-	start = string;
-	while (count <= position) {
-		hyphen = strchr(start, OPH_IDS_HYPHEN_CHAR);
-		semicolon = strchr(start, OPH_IDS_SEMICOLON_CHAR);
-		if (hyphen == NULL && semicolon == NULL) {
-			if (count == position) {
-				a = (int) strtol(start, NULL, 10);
-				if (a == 0) {
-					pmesg(LOG_ERROR, __FILE__, __LINE__, "Error while converting ASCII to INT\n");
-					return OPH_IDS_ERROR;
-				}
-				*id = a;
-			}
-			count++;
-		} else if (hyphen != NULL && (semicolon == NULL || hyphen < semicolon)) {
-			if ((hyphen - start) >= OPH_IDS_LONGLEN) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "String to be copied is too long. Max length is :%d\n", OPH_IDS_LONGLEN);
-				return OPH_IDS_ERROR;
-			}
-			strncpy(buffer, start, (hyphen - start));
-			buffer[(hyphen - start)] = '\0';
-
-			if (semicolon == NULL) {
-				if (strlen(hyphen + 1) + 1 >= OPH_IDS_LONGLEN) {
-					pmesg(LOG_ERROR, __FILE__, __LINE__, "String to be copied is too long. Max length is :%d\n", OPH_IDS_LONGLEN);
-					return OPH_IDS_ERROR;
-				}
-				strncpy(buffer2, hyphen + 1, strlen(hyphen + 1) + 1);
-				buffer[strlen(start) + 1] = '\0';
-			} else {
-				if ((semicolon - hyphen) >= OPH_IDS_LONGLEN) {
-					pmesg(LOG_ERROR, __FILE__, __LINE__, "String to be copied is too long. Max length is :%d\n", OPH_IDS_LONGLEN);
-					return OPH_IDS_ERROR;
-				}
-				strncpy(buffer2, hyphen + 1, (semicolon - hyphen));
-				buffer[(semicolon - hyphen)] = '\0';
-			}
-			a = (int) strtol(buffer, NULL, 10);
-			b = (int) strtol(buffer2, NULL, 10);
-			if (a == 0 || b == 0) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Error while converting ASCII to INT\n");
-				return OPH_IDS_ERROR;
-			}
+	oph_ids_set_free(&subset);
+	oph_ids_set_free(&set);
 
-			if (count + (b - a + 1) > position)
-				*id = (a + position - count);
-			count += (b - a + 1);
-		} else {
-			if (count == position) {
-				if ((semicolon - start) >= OPH_IDS_LONGLEN) {
-					pmesg(LOG_ERROR, __FILE__, __LINE__, "String to be copied is too long. Max length is :%d\n", OPH_IDS_LONGLEN);
-					return OPH_IDS_ERROR;
-				}
-				strncpy(buffer, start, (semicolon - start));
-				buffer[(semicolon - start)] = '\0';
-				a = (int) strtol(buffer, NULL, 10);
-				if (a == 0) {
-					pmesg(LOG_ERROR, __FILE__, __LINE__, "Error while converting ASCII to INT\n");
-					return OPH_IDS_ERROR;
-				}
-				*id = a;
-			}
-			count++;
-		}
-		start = semicolon;
-		if (start == NULL)
-			break;
-		start++;
-	}
 	return OPH_IDS_SUCCESS;
 }
 
@@ -134,226 +63,44 @@ int oph_ids_get_substring_from_string(char *string, int position, int number, ch
 		return OPH_IDS_ERROR;
 	}
 
-	int res;
-	if (oph_ids_count_number_of_ids(string, &res)) {
+	oph_ids_set set, subset;
+	if (oph_ids_set_parse(string, &set)) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to check ID string\n");
 		return OPH_IDS_ERROR;
 	}
-
-	if (position >= res || position + number > res || number < 1) {
-		pmesg(LOG_ERROR, __FILE__, __LINE__, "Position or number parameter are invlalid or out of string range. Position must be < %d, Number > 0 and Position + Number <= %d\n", res, res);
+	if (oph_ids_set_subset(&set, position, number, &subset)) {
+		oph_ids_set_free(&set);
 		return OPH_IDS_ERROR;
 	}
+	oph_ids_set_free(&set);
 
-	int count = 0;
-	int a, b;
-
-	char *hyphen;
-	char *semicolon;
-	char *start;
-	char buffer[OPH_IDS_LONGLEN], buffer2[OPH_IDS_LONGLEN];
-
-	char *ptr1, *ptr2;
-	ptr1 = ptr2 = NULL;
-	int p1 = 0, p2 = 0;
-	int p1_flag, p2_flag;
-	p1_flag = p2_flag = 0;
-
-	start = string;
-	while (count < position + number) {
-		hyphen = strchr(start, OPH_IDS_HYPHEN_CHAR);
-		semicolon = strchr(start, OPH_IDS_SEMICOLON_CHAR);
-		//If ID is like ...A
-		if (hyphen == NULL && semicolon == NULL) {
-			//If first element
-			if (count == position && !p1_flag) {
-				a = (int) strtol(start, NULL, 10);
-				if (a == 0) {
-					pmesg(LOG_ERROR, __FILE__, __LINE__, "Error while converting ASCII to INT\n");
-					return OPH_IDS_ERROR;
-				}
-				p1 = a;
-				ptr1 = semicolon;
-				p1_flag = 1;
-			}
-			//If last element
-			else if (count == position + number - 1 && !p2_flag && p1_flag) {
-				a = (int) strtol(start, NULL, 10);
-				if (a == 0) {
-					pmesg(LOG_ERROR, __FILE__, __LINE__, "Error while converting ASCII to INT\n");
-					return OPH_IDS_ERROR;
-				}
-				p2 = a;
-				ptr2 = start;
-				p2_flag = 1;
-			}
-			count++;
-		}
-		//If ID is like ...A-B
-		else if (hyphen != NULL && (semicolon == NULL || hyphen < semicolon)) {
-			if ((hyphen - start) >= OPH_IDS_LONGLEN) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "String to be copied is too long. Max length is :%d\n", OPH_IDS_LONGLEN);
-				return OPH_IDS_ERROR;
-			}
-			strncpy(buffer, start, (hyphen - start));
-			buffer[(hyphen - start)] = '\0';
-
-			if (semicolon == NULL) {
-				if (strlen(hyphen + 1) + 1 >= OPH_IDS_LONGLEN) {
-					pmesg(LOG_ERROR, __FILE__, __LINE__, "String to be copied is too long. Max length is :%d\n", OPH_IDS_LONGLEN);
-					return OPH_IDS_ERROR;
-				}
-				strncpy(buffer2, hyphen + 1, strlen(hyphen + 1) + 1);
-				buffer[strlen(start) + 1] = '\0';
-			} else {
-				if ((semicolon - hyphen) >= OPH_IDS_LONGLEN) {
-					pmesg(LOG_ERROR, __FILE__, __LINE__, "String to be copied is too long. Max length is :%d\n", OPH_IDS_LONGLEN);
-					return OPH_IDS_ERROR;
-				}
-				strncpy(buffer2, hyphen + 1, (semicolon - hyphen));
-				buffer[(semicolon - hyphen)] = '\0';
-			}
-			a = (int) strtol(buffer, NULL, 10);
-			b = (int) strtol(buffer2, NULL, 10);
-			if (a == 0 || b == 0) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Error while converting ASCII to INT\n");
-				return OPH_IDS_ERROR;
-			}
-			//If first element (not B)
-			if (count + (b - a) > position && !p1_flag) {
-				p1 = (a + position - count);
-				ptr1 = hyphen;
-				p1_flag = 1;
-			}
-			//If first element (is B)
-			else if (count + (b - a) == position && !p1_flag) {
-				p1 = b;
-				ptr1 = semicolon;
-				p1_flag = 1;
-			}
-			//If last element (is A)
-			if (count == position + number - 1 && !p2_flag && p1_flag) {
-				p2 = a;
-				ptr2 = start;
-				p2_flag = 1;
-			}
-			//If last element (not A)
-			else if (count + (b - a + 1) > position + number - 1 && !p2_flag && p1_flag) {
-				p2 = (a + position + number - 1 - count);
-				ptr2 = hyphen + 1;
-				p2_flag = 1;
-			}
-			count += (b - a + 1);
-		}
-		//If ID is like ...A;...
-		else {
-			//If first element
-			if (count == position && !p1_flag) {
-				if ((semicolon - start) >= OPH_IDS_LONGLEN) {
-					pmesg(LOG_ERROR, __FILE__, __LINE__, "String to be copied is too long. Max length is :%d\n", OPH_IDS_LONGLEN);
-					return OPH_IDS_ERROR;
-				}
-				strncpy(buffer, start, (semicolon - start));
-				buffer[(semicolon - start)] = '\0';
-				a = (int) strtol(buffer, NULL, 10);
-				if (a == 0) {
-					pmesg(LOG_ERROR, __FILE__, __LINE__, "Error while converting ASCII to INT\n");
-					return OPH_IDS_ERROR;
-				}
-				p1 = a;
-				ptr1 = semicolon;
-				p1_flag = 1;
-			}
-			//If last element
-			else if (count == position + number - 1 && !p2_flag && p1_flag) {
-				if ((semicolon - start) >= OPH_IDS_LONGLEN) {
-					pmesg(LOG_ERROR, __FILE__, __LINE__, "String to be copied is too long. Max length is :%d\n", OPH_IDS_LONGLEN);
-					return OPH_IDS_ERROR;
-				}
-				strncpy(buffer, start, (semicolon - start));
-				buffer[(semicolon - start)] = '\0';
-				a = (int) strtol(buffer, NULL, 10);
-				if (a == 0) {
-					pmesg(LOG_ERROR, __FILE__, __LINE__, "Error while converting ASCII to INT\n");
-					return OPH_IDS_ERROR;
-				}
-				p2 = a;
-				ptr2 = start;
-				p2_flag = 1;
-			}
-			count++;
-		}
-		start = semicolon;
-		if (start == NULL)
-			break;
-		start++;
+	//The new string is never longer than the corresponding part of the original one
+	char *tmp = NULL;
+	if (oph_ids_set_to_string(&subset, &tmp)) {
+		oph_ids_set_free(&subset);
+		return OPH_IDS_ERROR;
 	}
+	strcpy(*new_string, tmp);
+
+	free(tmp);
+	oph_ids_set_free(&subset);
 
-	//Set new ID string
-	if (!ptr2 || !ptr1 || number == 1)
-		snprintf(*new_string, (floor(log10(abs(p1))) + 1) + 1, "%d", p1);
-	else {
-		if ((ptr2 - ptr1) >= OPH_IDS_LONGLEN) {
-			pmesg(LOG_ERROR, __FILE__, __LINE__, "String to be copied is too long. Max length is :%d\n", OPH_IDS_LONGLEN);
-			return OPH_IDS_ERROR;
-		}
-		strncpy(buffer, ptr1, (ptr2 - ptr1));
-		buffer[(ptr2 - ptr1)] = '\0';
-		snprintf(*new_string, (floor(log10(abs(p1))) + 1) + (ptr2 - ptr1) + (floor(log10(abs(p2))) + 1) + 1, "%d%s%d", p1, buffer, p2);
-	}
 	return OPH_IDS_SUCCESS;
 }
 
 int oph_ids_count_number_of_ids(char *string, int *res)
 {
-
-	char *start, *end, *hyphen;
-	char buffer[OPH_IDS_LONGLEN];
-	int a, b;
-	int count = 0;
-
 	if (!string || !res) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameters\n");
 		return OPH_IDS_ERROR;
 	}
 
-	start = string;
-	do {
-		//Fetch till ; or fetch all string
-		end = strchr(start, OPH_IDS_SEMICOLON_CHAR);
-		if (end != NULL) {
-			if ((end - start) >= OPH_IDS_LONGLEN) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "String to be copied is too long. Max length is :%d\n", OPH_IDS_LONGLEN);
-				return OPH_IDS_ERROR;
-			}
-			strncpy(buffer, start, (end - start));
-			buffer[(end - start)] = '\0';
-		} else {
-			if ((strlen(start) + 1) >= OPH_IDS_LONGLEN) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "String to be copied is too long. Max length is :%d\n", OPH_IDS_LONGLEN);
-				return OPH_IDS_ERROR;
-			}
-			strncpy(buffer, start, (strlen(start) + 1));
-		}
-
-		//Check if single value or range
-		hyphen = strchr(buffer, OPH_IDS_HYPHEN_CHAR);
-		if (hyphen == NULL) {
-			count++;
-		} else {
-			*hyphen = '\0';
-			a = (int) strtol(buffer, NULL, 10);
-			b = (int) strtol(hyphen + 1, NULL, 10);
-			if (a == 0 || b == 0) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Error while converting ASCII to INT\n");
-				return OPH_IDS_ERROR;
-			}
-			count += b - a + 1;
-		}
-		start = end + 1;
-	} while (end != NULL);
+	oph_ids_set set;
+	if (oph_ids_set_parse(string, &set))
+		return OPH_IDS_ERROR;
+	oph_ids_set_count(&set, res);
+	oph_ids_set_free(&set);
 
-	*res = count;
 	return OPH_IDS_SUCCESS;
 }
 
@@ -675,3 +422,246 @@ int oph_ids_create_new_id_string(char **string, int string_len, int first_id, in
 
 	return OPH_IDS_SUCCESS;
 }
+
+int oph_ids_set_init(oph_ids_set * set)
+{
+	if (!set) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameters\n");
+		return OPH_IDS_ERROR;
+	}
+
+	set->intervals = NULL;
+	set->size = 0;
+	set->capacity = 0;
+
+	return OPH_IDS_SUCCESS;
+}
+
+int oph_ids_set_free(oph_ids_set * set)
+{
+	if (!set) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameters\n");
+		return OPH_IDS_ERROR;
+	}
+
+	if (set->intervals) {
+		free(set->intervals);
+		set->intervals = NULL;
+	}
+	set->size = 0;
+	set->capacity = 0;
+
+	return OPH_IDS_SUCCESS;
+}
+
+int oph_ids_set_add(oph_ids_set * set, int first_id, int last_id)
+{
+	if (!set) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameters\n");
+		return OPH_IDS_ERROR;
+	}
+	if (first_id > last_id) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "First ID is bigger than Last ID\n");
+		return OPH_IDS_ERROR;
+	}
+	//Extend the last interval if the new one follows it
+	if (set->size && (set->intervals[set->size - 1].last + 1 == first_id)) {
+		set->intervals[set->size - 1].last = last_id;
+		return OPH_IDS_SUCCESS;
+	}
+
+	if (set->size == set->capacity) {
+		int capacity = set->capacity ? 2 * set->capacity : OPH_IDS_SET_CAPACITY;
+		oph_ids_interval *intervals = (oph_ids_interval *) realloc(set->intervals, capacity * sizeof(oph_ids_interval));
+		if (!intervals) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Memory allocating error\n");
+			return OPH_IDS_ERROR;
+		}
+		set->intervals = intervals;
+		set->capacity = capacity;
+	}
+	set->intervals[set->size].first = first_id;
+	set->intervals[set->size].last = last_id;
+	set->size++;
+
+	return OPH_IDS_SUCCESS;
+}
+
+int oph_ids_set_parse(const char *string, oph_ids_set * set)
+{
+	if (!string || !set) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameters\n");
+		return OPH_IDS_ERROR;
+	}
+	oph_ids_set_init(set);
+
+	const char *start = string;
+	char *end;
+	long a, b;
+
+	while (1) {
+		a = strtol(start, &end, 10);
+		if ((end == start) || (a <= 0) || (a > INT_MAX)) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Error while converting ASCII to INT\n");
+			oph_ids_set_free(set);
+			return OPH_IDS_ERROR;
+		}
+		b = a;
+		if (*end == OPH_IDS_HYPHEN_CHAR) {
+			start = end + 1;
+			b = strtol(start, &end, 10);
+			if ((end == start) || (b < a) || (b > INT_MAX)) {
+				pmesg(LOG_ERROR, __FILE__, __LINE__, "Error while converting ASCII to INT\n");
+				oph_ids_set_free(set);
+				return OPH_IDS_ERROR;
+			}
+		}
+		if (oph_ids_set_add(set, (int) a, (int) b)) {
+			oph_ids_set_free(set);
+			return OPH_IDS_ERROR;
+		}
+		while (isspace(*end))
+			end++;
+		if (*end == OPH_IDS_SEMICOLON_CHAR)
+			start = end + 1;
+		else if (!*end)
+			break;
+		else {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unexpected character '%c' in ID string\n", *end);
+			oph_ids_set_free(set);
+			return OPH_IDS_ERROR;
+		}
+	}
+
+	return OPH_IDS_SUCCESS;
+}
+
+int oph_ids_set_to_string(oph_ids_set * set, char **string)
+{
+	if (!set || !string) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameters\n");
+		return OPH_IDS_ERROR;
+	}
+	*string = NULL;
+
+	int i;
+	size_t len = 1, n = 0;
+	for (i = 0; i < set->size; i++) {
+		if (set->intervals[i].first == set->intervals[i].last)
+			len += snprintf(NULL, 0, "%d;", set->intervals[i].first);
+		else
+			len += snprintf(NULL, 0, "%d-%d;", set->intervals[i].first, set->intervals[i].last);
+	}
+
+	if (!(*string = (char *) malloc(len * sizeof(char)))) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Memory allocating error\n");
+		return OPH_IDS_ERROR;
+	}
+	**string = '\0';
+	for (i = 0; i < set->size; i++) {
+		if (set->intervals[i].first == set->intervals[i].last)
+			n += snprintf(*string + n, len - n, i ? ";%d" : "%d", set->intervals[i].first);
+		else
+			n += snprintf(*string + n, len - n, i ? ";%d-%d" : "%d-%d", set->intervals[i].first, set->intervals[i].last);
+	}
+
+	return OPH_IDS_SUCCESS;
+}
+
+int oph_ids_set_count(oph_ids_set * set, int *count)
+{
+	if (!set || !count) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameters\n");
+		return OPH_IDS_ERROR;
+	}
+
+	int i;
+	*count = 0;
+	for (i = 0; i < set->size; i++)
+		*count += set->intervals[i].last - set->intervals[i].first + 1;
+
+	return OPH_IDS_SUCCESS;
+}
+
+static int _oph_ids_interval_compare(const void *a, const void *b)
+{
+	const oph_ids_interval *ia = (const oph_ids_interval *) a, *ib = (const oph_ids_interval *) b;
+	return ia->first < ib->first ? -1 : ia->first > ib->first;
+}
+
+//Sort the intervals of a set and merge those overlapping or adjacent
+static void _oph_ids_set_normalize(oph_ids_set * set)
+{
+	if (set->size < 2)
+		return;
+
+	int i, j = 0;
+	qsort(set->intervals, set->size, sizeof(oph_ids_interval), _oph_ids_interval_compare);
+	for (i = 1; i < set->size; i++) {
+		if ((long) set->intervals[i].first <= (long) set->intervals[j].last + 1) {
+			if (set->intervals[i].last > set->intervals[j].last)
+				set->intervals[j].last = set->intervals[i].last;
+		} else
+			set->intervals[++j] = set->intervals[i];
+	}
+	set->size = j + 1;
+}
+
+int oph_ids_set_union(oph_ids_set * set1, oph_ids_set * set2, oph_ids_set * result)
+{
+	if (!set1 || !set2 || !result) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameters\n");
+		return OPH_IDS_ERROR;
+	}
+	oph_ids_set_init(result);
+
+	int i;
+	for (i = 0; i < set1->size; i++)
+		if (oph_ids_set_add(result, set1->intervals[i].first, set1->intervals[i].last)) {
+			oph_ids_set_free(result);
+			return OPH_IDS_ERROR;
+		}
+	for (i = 0; i < set2->size; i++)
+		if (oph_ids_set_add(result, set2->intervals[i].first, set2->intervals[i].last)) {
+			oph_ids_set_free(result);
+			return OPH_IDS_ERROR;
+		}
+	_oph_ids_set_normalize(result);
+
+	return OPH_IDS_SUCCESS;
+}
+
+int oph_ids_set_subset(oph_ids_set * set, int position, int number, oph_ids_set * result)
+{
+	if (!set || !result) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameters\n");
+		return OPH_IDS_ERROR;
+	}
+	oph_ids_set_init(result);
+
+	int count;
+	oph_ids_set_count(set, &count);
+	if (position < 0 || position >= count || position + number > count || number < 1) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Position or number parameter are invlalid or out of string range. Position must be < %d, Number > 0 and Position + Number <= %d\n", count, count);
+		return OPH_IDS_ERROR;
+	}
+
+	int i, first, last, size;
+	for (i = 0; (i < set->size) && number; i++) {
+		size = set->intervals[i].last - set->intervals[i].first + 1;
+		if (position >= size) {
+			position -= size;
+			continue;
+		}
+		first = set->intervals[i].first + position;
+		last = number < size - position ? first + number - 1 : set->intervals[i].last;
+		if (oph_ids_set_add(result, first, last)) {
+			oph_ids_set_free(result);
+			return OPH_IDS_ERROR;
+		}
+		number -= last - first + 1;
+		position = 0;
+	}
+
+	return OPH_IDS_SUCCESS;
+}
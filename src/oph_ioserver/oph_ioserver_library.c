@@ -23,15 +23,95 @@
 #include <ltdl.h>
 #include <string.h>
 #include <errno.h>
+#include <stdarg.h>
+#include <ctype.h>
 
 #include "debug.h"
 #include "oph_ioserver_log_error_codes.h"
+#include "oph_ioserver_submission_query.h"
 
 #include <pthread.h>
 
 pthread_mutex_t libtool_lock = PTHREAD_MUTEX_INITIALIZER;
 extern int msglevel;
 
+/**
+ * \brief               Entry of the connection pool
+ * \param server_type   Name of server plugin used to open the connection
+ * \param host          Hostname of instance
+ * \param user          Username used to access instance
+ * \param port          Port of instance
+ * \param opt_flag      Connection flags
+ * \param connection    Pointer to (void) structure for server connection
+ * \param next          Next idle entry
+ */
+typedef struct _oph_ioserver_pool_entry {
+	char *server_type;
+	char *host;
+	char *user;
+	unsigned int port;
+	unsigned long opt_flag;
+	void *connection;
+	struct _oph_ioserver_pool_entry *next;
+} oph_ioserver_pool_entry;
+
+/**
+ * \brief               Handler used by the pool to close idle connections of a given server type
+ * \param handle        Dynamic server plugin handle
+ * \param next          Next handler
+ */
+typedef struct _oph_ioserver_pool_handler {
+	oph_ioserver_handler *handle;
+	struct _oph_ioserver_pool_handler *next;
+} oph_ioserver_pool_handler;
+
+#define OPH_IOSERVER_TEMPLATE_STRING		's'
+#define OPH_IOSERVER_TEMPLATE_INT		'i'
+#define OPH_IOSERVER_TEMPLATE_LONG		'l'
+#define OPH_IOSERVER_TEMPLATE_LONG_LONG		'L'
+#define OPH_IOSERVER_TEMPLATE_UINT		'u'
+#define OPH_IOSERVER_TEMPLATE_ULONG		'k'
+#define OPH_IOSERVER_TEMPLATE_ULONG_LONG	'K'
+#define OPH_IOSERVER_TEMPLATE_DOUBLE		'f'
+
+/**
+ * \brief               Submission string template compiled for a handle
+ * \param format        Submission string template
+ * \param slot_num      Number of slots of the template (-1 in case the template cannot be compiled)
+ * \param slot_conv     Conversion specification of each slot
+ * \param slot_type     Type of the value of each slot
+ * \param slot_quoted   Flag set for slots enclosed by string delimiters
+ * \param native        Flag set in case the template has been translated into the native language of the server
+ * \param translated    Native query where slots are referenced by markers
+ * \param part_num      Number of slot references within the native query
+ * \param part_offset   Offset of each literal part of the native query
+ * \param part_len      Length of each literal part of the native query
+ * \param part_slot     Slot referenced after each literal part
+ * \param setup_native  Plugin function used to setup native queries
+ * \param next          Next template
+ */
+typedef struct _oph_ioserver_template {
+	char *format;
+	int slot_num;
+	char slot_conv[OPH_IOSERVER_TEMPLATE_MAX_SLOTS][OPH_IOSERVER_TEMPLATE_CONV_LEN];
+	char slot_type[OPH_IOSERVER_TEMPLATE_MAX_SLOTS];
+	char slot_quoted[OPH_IOSERVER_TEMPLATE_MAX_SLOTS];
+	char native;
+	char *translated;
+	int part_num;
+	size_t part_offset[OPH_IOSERVER_TEMPLATE_MAX_SLOTS + 1];
+	size_t part_len[OPH_IOSERVER_TEMPLATE_MAX_SLOTS + 1];
+	int part_slot[OPH_IOSERVER_TEMPLATE_MAX_SLOTS];
+	int (*setup_native) (oph_ioserver_handler *, void *, const char *, unsigned long long, oph_ioserver_query_arg **, oph_ioserver_query **);
+	struct _oph_ioserver_template *next;
+} oph_ioserver_template;
+
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static oph_ioserver_pool_entry *pool_idle = NULL;
+static oph_ioserver_pool_handler *pool_handlers = NULL;
+static unsigned int pool_idle_number = 0;
+static unsigned long long pool_hits = 0, pool_misses = 0;
+
 int (*_SERVER_setup) (oph_ioserver_handler * handle);
 int (*_SERVER_connect) (oph_ioserver_handler * handle, oph_ioserver_params * conn_params, void **connection);
 int (*_SERVER_use_db) (oph_ioserver_handler * handle, const char *db_name, void *connection);
@@ -41,10 +121,16 @@ int (*_SERVER_setup_query) (oph_ioserver_handler * handle, void *connection, con
 int (*_SERVER_execute_query) (oph_ioserver_handler * handle, void *connection, oph_ioserver_query * query);
 int (*_SERVER_free_query) (oph_ioserver_handler * handle, oph_ioserver_query * query);
 int (*_SERVER_get_result) (oph_ioserver_handler * handle, void *connection, oph_ioserver_result ** result);
+int (*_SERVER_get_result_stream) (oph_ioserver_handler * handle, void *connection, oph_ioserver_result ** result);
 int (*_SERVER_fetch_row) (oph_ioserver_handler * handle, oph_ioserver_result * result, oph_ioserver_row ** current_row);
 int (*_SERVER_free_result) (oph_ioserver_handler * handle, oph_ioserver_result * result);
+int (*_SERVER_get_query_cache_stats) (oph_ioserver_handler * handle, unsigned long long *hits, unsigned long long *misses);
+int (*_SERVER_translate_query) (oph_ioserver_handler * handle, const char *operation, char **translated);
+int (*_SERVER_setup_native_query) (oph_ioserver_handler * handle, void *connection, const char *operation, unsigned long long tot_run, oph_ioserver_query_arg ** args, oph_ioserver_query ** query);
 
 static int oph_find_server_plugin(const char *server_type, char **dyn_lib);
+static void _oph_ioserver_pool_free_entry(oph_ioserver_pool_entry * entry);
+static void _oph_ioserver_template_free(oph_ioserver_template * template);
 
 //Parse IO server name SERVER_STORAGE
 static int oph_parse_server_name(const char *server_name, char **server_type, char **server_subtype)
@@ -103,6 +189,8 @@ int oph_ioserver_setup(const char *server_type, oph_ioserver_handler ** handle,
 	internal_handle->dlh = NULL;
 	internal_handle->is_thread = 0;
 	internal_handle->connection = NULL;
+	internal_handle->pool_entry = NULL;
+	internal_handle->templates = NULL;
 
 	if (is_thread != 0)
 		internal_handle->is_thread = 1;
@@ -329,6 +417,10 @@ int oph_ioserver_close(oph_ioserver_handler * handle)
 	}
 	pthread_mutex_unlock(&libtool_lock);
 
+	//The connection will not be given back to the pool
+	_oph_ioserver_pool_free_entry((oph_ioserver_pool_entry *) handle->pool_entry);
+	handle->pool_entry = NULL;
+
 	return _SERVER_close(handle, &(handle->connection));
 }
 
@@ -366,6 +458,10 @@ int oph_ioserver_cleanup(oph_ioserver_handler * handle)
 		return res;
 	}
 	//Release handle resources
+	_oph_ioserver_pool_free_entry((oph_ioserver_pool_entry *) handle->pool_entry);
+	handle->pool_entry = NULL;
+	_oph_ioserver_template_free((oph_ioserver_template *) handle->templates);
+	handle->templates = NULL;
 	if (handle->server_type) {
 		free(handle->server_type);
 		handle->server_type = NULL;
@@ -433,6 +529,35 @@ int oph_ioserver_get_result(oph_ioserver_handler * handle, oph_ioserver_result *
 	return _SERVER_get_result(handle, handle->connection, result);
 }
 
+int oph_ioserver_get_result_stream(oph_ioserver_handler * handle, oph_ioserver_result ** result)
+{
+	if (!handle) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_LOG_NULL_HANDLE);
+		logging_server(LOG_ERROR, __FILE__, __LINE__, handle->server_type, OPH_IOSERVER_LOG_NULL_HANDLE);
+		return OPH_IOSERVER_NULL_HANDLE;
+	}
+
+	if (!handle->dlh || !handle->server_type) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_LOG_LOAD_SERV_ERROR);
+		logging_server(LOG_ERROR, __FILE__, __LINE__, handle->server_type, OPH_IOSERVER_LOG_LOAD_SERV_ERROR);
+		return OPH_IOSERVER_DLOPEN_ERR;
+	}
+
+	char func_name[OPH_IOSERVER_BUFLEN] = { '\0' };
+	snprintf(func_name, OPH_IOSERVER_BUFLEN, OPH_IOSERVER_GET_RESULT_STREAM_FUNC, handle->server_type);
+
+	pthread_mutex_lock(&libtool_lock);
+	if (!(_SERVER_get_result_stream = (int (*)(oph_ioserver_handler *, void *, oph_ioserver_result **)) lt_dlsym(handle->dlh, func_name))) {
+		pthread_mutex_unlock(&libtool_lock);
+		//Streaming mode is optional: the whole result set is retrieved
+		pmesg(LOG_DEBUG, __FILE__, __LINE__, OPH_IOSERVER_LOG_STREAM_NOT_SUPPORTED, handle->server_type);
+		return oph_ioserver_get_result(handle, result);
+	}
+	pthread_mutex_unlock(&libtool_lock);
+
+	return _SERVER_get_result_stream(handle, handle->connection, result);
+}
+
 int oph_ioserver_fetch_row(oph_ioserver_handler * handle, oph_ioserver_result * result, oph_ioserver_row ** current_row)
 {
 	if (!handle) {
@@ -491,6 +616,573 @@ int oph_ioserver_free_result(oph_ioserver_handler * handle, oph_ioserver_result
 	return _SERVER_free_result(handle, result);
 }
 
+int oph_ioserver_get_query_cache_stats(oph_ioserver_handler * handle, unsigned long long *hits, unsigned long long *misses)
+{
+	if (!handle) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_LOG_NULL_HANDLE);
+		logging_server(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_COMMON_LOG, OPH_IOSERVER_LOG_NULL_HANDLE);
+		return OPH_IOSERVER_NULL_HANDLE;
+	}
+	if (hits)
+		*hits = 0;
+	if (misses)
+		*misses = 0;
+
+	if (!handle->dlh || !handle->server_type) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_LOG_LOAD_SERV_ERROR);
+		logging_server(LOG_ERROR, __FILE__, __LINE__, handle->server_type, OPH_IOSERVER_LOG_LOAD_SERV_ERROR);
+		return OPH_IOSERVER_DLOPEN_ERR;
+	}
+
+	char func_name[OPH_IOSERVER_BUFLEN] = { '\0' };
+	snprintf(func_name, OPH_IOSERVER_BUFLEN, OPH_IOSERVER_GET_QUERY_CACHE_STATS_FUNC, handle->server_type);
+
+	pthread_mutex_lock(&libtool_lock);
+	if (!(_SERVER_get_query_cache_stats = (int (*)(oph_ioserver_handler *, unsigned long long *, unsigned long long *)) lt_dlsym(handle->dlh, func_name))) {
+		pthread_mutex_unlock(&libtool_lock);
+		//The cache of prepared statements is optional
+		return OPH_IOSERVER_SUCCESS;
+	}
+	pthread_mutex_unlock(&libtool_lock);
+
+	return _SERVER_get_query_cache_stats(handle, hits, misses);
+}
+
+//Parse the conversion specification following '%' and return its length (0 if the conversion is not supported)
+static size_t _oph_ioserver_template_conv(const char *conv, char *type)
+{
+	size_t i = 0;
+	int longs = 0;
+
+	while (conv[i] && strchr("-+ #0", conv[i]))
+		i++;
+	while (isdigit((unsigned char) conv[i]))
+		i++;
+	if (conv[i] == '.') {
+		i++;
+		while (isdigit((unsigned char) conv[i]))
+			i++;
+	}
+	while (conv[i] == 'l' && longs < 2) {
+		longs++;
+		i++;
+	}
+
+	switch (conv[i]) {
+		case 'd':
+		case 'i':
+		case 'c':
+			*type = longs > 1 ? OPH_IOSERVER_TEMPLATE_LONG_LONG : (longs ? OPH_IOSERVER_TEMPLATE_LONG : OPH_IOSERVER_TEMPLATE_INT);
+			break;
+		case 'u':
+		case 'o':
+		case 'x':
+		case 'X':
+			*type = longs > 1 ? OPH_IOSERVER_TEMPLATE_ULONG_LONG : (longs ? OPH_IOSERVER_TEMPLATE_ULONG : OPH_IOSERVER_TEMPLATE_UINT);
+			break;
+		case 'f':
+		case 'e':
+		case 'E':
+		case 'g':
+		case 'G':
+			if (longs > 1)
+				return 0;
+			*type = OPH_IOSERVER_TEMPLATE_DOUBLE;
+			break;
+		case 's':
+			//Width and precision of strings are not supported
+			if (i)
+				return 0;
+			*type = OPH_IOSERVER_TEMPLATE_STRING;
+			break;
+		default:
+			return 0;
+	}
+
+	return i + 1;
+}
+
+//Release a list of templates
+static void _oph_ioserver_template_free(oph_ioserver_template * template)
+{
+	oph_ioserver_template *next;
+	for (; template; template = next) {
+		next = template->next;
+		if (template->format)
+			free(template->format);
+		if (template->translated)
+			free(template->translated);
+		free(template);
+	}
+}
+
+//Split the native query into literal parts and slot references; return 0 if each slot is referenced exactly once
+static int _oph_ioserver_template_split(oph_ioserver_template * template)
+{
+	int i, slot, count[OPH_IOSERVER_TEMPLATE_MAX_SLOTS];
+	char *ptr, *end;
+
+	for (i = 0; i < template->slot_num; i++)
+		count[i] = 0;
+
+	template->part_num = 0;
+	template->part_offset[0] = 0;
+	for (ptr = template->translated; *ptr; ptr++) {
+		if (*ptr == OPH_IOSERVER_TEMPLATE_SLOT_END)
+			return 1;
+		if (*ptr != OPH_IOSERVER_TEMPLATE_SLOT_BEGIN)
+			continue;
+		if (template->part_num >= template->slot_num)
+			return 1;
+		slot = (int) strtol(ptr + 1, &end, 10);
+		if (end == ptr + 1 || *end != OPH_IOSERVER_TEMPLATE_SLOT_END || slot < 0 || slot >= template->slot_num)
+			return 1;
+		count[slot]++;
+		template->part_len[template->part_num] = (ptr - template->translated) - template->part_offset[template->part_num];
+		template->part_slot[template->part_num] = slot;
+		template->part_num++;
+		template->part_offset[template->part_num] = end + 1 - template->translated;
+		ptr = end;
+	}
+	template->part_len[template->part_num] = strlen(template->translated) - template->part_offset[template->part_num];
+
+	for (i = 0; i < template->slot_num; i++)
+		if (count[i] != 1)
+			return 1;
+
+	return 0;
+}
+
+//Compile a submission string template: slots are collected and, if possible, the template is translated by the plugin
+static oph_ioserver_template *_oph_ioserver_template_compile(oph_ioserver_handler * handle, const char *format)
+{
+	oph_ioserver_template *template = (oph_ioserver_template *) calloc(1, sizeof(oph_ioserver_template));
+	if (!template || !(template->format = strdup(format))) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_LOG_MEMORY_ERROR);
+		logging_server(LOG_ERROR, __FILE__, __LINE__, handle->server_type, OPH_IOSERVER_LOG_MEMORY_ERROR);
+		if (template)
+			free(template);
+		return NULL;
+	}
+
+	//Replace each slot with a marker; slots within keys or within blocks interpreted by the plugin prevent the translation
+	char marked[OPH_IOSERVER_SQ_LEN];
+	const char *ptr, *key = format;
+	size_t len = 0, conv_len;
+	char in_key = 1, in_string = 0, in_restricted = 0, native = 1, type;
+	int slot_num = 0;
+
+	for (ptr = format; *ptr; ptr++) {
+		if (*ptr == '%') {
+			if (ptr[1] == '%') {
+				ptr++;
+			} else {
+				if (slot_num >= OPH_IOSERVER_TEMPLATE_MAX_SLOTS || !(conv_len = _oph_ioserver_template_conv(ptr + 1, &type)) || conv_len + 1 >= OPH_IOSERVER_TEMPLATE_CONV_LEN) {
+					//Template values will be formatted by vsnprintf
+					template->slot_num = -1;
+					return template;
+				}
+				strncpy(template->slot_conv[slot_num], ptr, conv_len + 1);
+				template->slot_conv[slot_num][conv_len + 1] = 0;
+				template->slot_type[slot_num] = type;
+				template->slot_quoted[slot_num] = in_string;
+				if (in_key || in_restricted)
+					native = 0;
+				len += snprintf(marked + len, len < OPH_IOSERVER_SQ_LEN ? OPH_IOSERVER_SQ_LEN - len : 0, "%c%d%c", OPH_IOSERVER_TEMPLATE_SLOT_BEGIN, slot_num, OPH_IOSERVER_TEMPLATE_SLOT_END);
+				slot_num++;
+				ptr += conv_len;
+				continue;
+			}
+		} else if (*ptr == OPH_IOSERVER_SQ_PARAM_SEPARATOR) {
+			in_key = 1;
+			in_restricted = 0;
+			key = ptr + 1;
+		} else if (*ptr == OPH_IOSERVER_SQ_VALUE_SEPARATOR && in_key) {
+			in_key = 0;
+			in_restricted = ((ptr - key == strlen(OPH_IOSERVER_SQ_OPERATION) && !strncmp(key, OPH_IOSERVER_SQ_OPERATION, ptr - key))
+					 || (ptr - key == strlen(OPH_IOSERVER_SQ_ARG_FUNC) && !strncmp(key, OPH_IOSERVER_SQ_ARG_FUNC, ptr - key))
+					 || (ptr - key == strlen(OPH_IOSERVER_SQ_ARG_FINAL_STATEMENT) && !strncmp(key, OPH_IOSERVER_SQ_ARG_FINAL_STATEMENT, ptr - key)));
+		} else if (*ptr == OPH_IOSERVER_SQ_STRING_DELIMITER)
+			in_string = !in_string;
+		if (len < OPH_IOSERVER_SQ_LEN)
+			marked[len] = *ptr;
+		len++;
+	}
+	template->slot_num = slot_num;
+	if (!native || len >= OPH_IOSERVER_SQ_LEN)
+		return template;
+	marked[len] = 0;
+
+	//Translation is optional for plugins
+	char func_name[OPH_IOSERVER_BUFLEN] = { '\0' };
+	pthread_mutex_lock(&libtool_lock);
+	snprintf(func_name, OPH_IOSERVER_BUFLEN, OPH_IOSERVER_TRANSLATE_QUERY_FUNC, handle->server_type);
+	_SERVER_translate_query = (int (*)(oph_ioserver_handler *, const char *, char **)) lt_dlsym(handle->dlh, func_name);
+	snprintf(func_name, OPH_IOSERVER_BUFLEN, OPH_IOSERVER_SETUP_NATIVE_QUERY_FUNC, handle->server_type);
+	_SERVER_setup_native_query =
+	    (int (*)(oph_ioserver_handler *, void *, const char *, unsigned long long, oph_ioserver_query_arg **, oph_ioserver_query **)) lt_dlsym(handle->dlh, func_name);
+	int (*translate) (oph_ioserver_handler *, const char *, char **) = _SERVER_translate_query;
+	template->setup_native = _SERVER_setup_native_query;
+	pthread_mutex_unlock(&libtool_lock);
+	if (!translate || !template->setup_native)
+		return template;
+
+	if (translate(handle, marked, &template->translated) || !template->translated || _oph_ioserver_template_split(template)) {
+		pmesg(LOG_DEBUG, __FILE__, __LINE__, OPH_IOSERVER_LOG_TEMPLATE_NOT_TRANSLATED, handle->server_type);
+		if (template->translated) {
+			free(template->translated);
+			template->translated = NULL;
+		}
+		return template;
+	}
+	template->native = 1;
+
+	return template;
+}
+
+//Check that a slot value cannot change the structure of the submission string
+static int _oph_ioserver_template_is_opaque(const char *value, char quoted)
+{
+	if (!value || !*value || *value == OPH_IOSERVER_SQ_KEYWORD_CHAR)
+		return 0;
+
+	char in_string = 0;
+	for (; *value; value++) {
+		switch (*value) {
+			case OPH_IOSERVER_SQ_PARAM_SEPARATOR:
+			case OPH_IOSERVER_TEMPLATE_SLOT_BEGIN:
+			case OPH_IOSERVER_TEMPLATE_SLOT_END:
+				return 0;
+			case OPH_IOSERVER_SQ_STRING_DELIMITER:
+				if (quoted)
+					return 0;
+				in_string = !in_string;
+				break;
+			case OPH_IOSERVER_SQ_MULTI_VALUE_SEPARATOR:
+				if (!quoted && !in_string)
+					return 0;
+				break;
+		}
+	}
+
+	return !in_string;
+}
+
+int oph_ioserver_setup_query_template(oph_ioserver_handler * handle, const char *format, unsigned long long tot_run, oph_ioserver_query_arg ** args, oph_ioserver_query ** query, ...)
+{
+	if (!handle) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_LOG_NULL_HANDLE);
+		logging_server(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_COMMON_LOG, OPH_IOSERVER_LOG_NULL_HANDLE);
+		return OPH_IOSERVER_NULL_HANDLE;
+	}
+
+	if (!handle->dlh || !handle->server_type) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_LOG_LOAD_SERV_ERROR);
+		logging_server(LOG_ERROR, __FILE__, __LINE__, handle->server_type, OPH_IOSERVER_LOG_LOAD_SERV_ERROR);
+		return OPH_IOSERVER_DLOPEN_ERR;
+	}
+
+	if (!format || !query) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_LOG_NULL_INPUT_PARAM);
+		logging_server(LOG_ERROR, __FILE__, __LINE__, handle->server_type, OPH_IOSERVER_LOG_NULL_INPUT_PARAM);
+		return OPH_IOSERVER_NULL_PARAM;
+	}
+
+	oph_ioserver_template *template;
+	for (template = (oph_ioserver_template *) handle->templates; template; template = template->next)
+		if (template->format == format || !strcmp(template->format, format))
+			break;
+	if (!template) {
+		if (!(template = _oph_ioserver_template_compile(handle, format)))
+			return OPH_IOSERVER_MEMORY_ERR;
+		template->next = (oph_ioserver_template *) handle->templates;
+		handle->templates = template;
+	}
+
+	va_list ap;
+	int i;
+
+	//Fill the native query directly
+	if (template->native) {
+		const char *value[OPH_IOSERVER_TEMPLATE_MAX_SLOTS];
+		char number[OPH_IOSERVER_TEMPLATE_MAX_SLOTS][OPH_IOSERVER_TEMPLATE_NUM_LEN];
+		size_t value_len[OPH_IOSERVER_TEMPLATE_MAX_SLOTS];
+
+		va_start(ap, query);
+		for (i = 0; i < template->slot_num; i++) {
+			value[i] = number[i];
+			switch (template->slot_type[i]) {
+				case OPH_IOSERVER_TEMPLATE_STRING:
+					value[i] = va_arg(ap, const char *);
+					break;
+				case OPH_IOSERVER_TEMPLATE_INT:
+					snprintf(number[i], OPH_IOSERVER_TEMPLATE_NUM_LEN, template->slot_conv[i], va_arg(ap, int));
+					break;
+				case OPH_IOSERVER_TEMPLATE_LONG:
+					snprintf(number[i], OPH_IOSERVER_TEMPLATE_NUM_LEN, template->slot_conv[i], va_arg(ap, long));
+					break;
+				case OPH_IOSERVER_TEMPLATE_LONG_LONG:
+					snprintf(number[i], OPH_IOSERVER_TEMPLATE_NUM_LEN, template->slot_conv[i], va_arg(ap, long long));
+					break;
+				case OPH_IOSERVER_TEMPLATE_UINT:
+					snprintf(number[i], OPH_IOSERVER_TEMPLATE_NUM_LEN, template->slot_conv[i], va_arg(ap, unsigned int));
+					break;
+				case OPH_IOSERVER_TEMPLATE_ULONG:
+					snprintf(number[i], OPH_IOSERVER_TEMPLATE_NUM_LEN, template->slot_conv[i], va_arg(ap, unsigned long));
+					break;
+				case OPH_IOSERVER_TEMPLATE_ULONG_LONG:
+					snprintf(number[i], OPH_IOSERVER_TEMPLATE_NUM_LEN, template->slot_conv[i], va_arg(ap, unsigned long long));
+					break;
+				default:
+					snprintf(number[i], OPH_IOSERVER_TEMPLATE_NUM_LEN, template->slot_conv[i], va_arg(ap, double));
+			}
+		}
+		va_end(ap);
+
+		size_t sql_len = 0;
+		char opaque = 1;
+		for (i = 0; i < template->slot_num && opaque; i++) {
+			if ((opaque = _oph_ioserver_template_is_opaque(value[i], template->slot_quoted[i]))) {
+				value_len[i] = strlen(value[i]);
+				sql_len += value_len[i];
+			}
+		}
+		for (i = 0; i <= template->part_num; i++)
+			sql_len += template->part_len[i];
+
+		if (opaque && sql_len < OPH_IOSERVER_SQ_LEN) {
+			char sql[sql_len + 1], *ptr = sql;
+			for (i = 0; i < template->part_num; i++) {
+				memcpy(ptr, template->translated + template->part_offset[i], template->part_len[i]);
+				ptr += template->part_len[i];
+				memcpy(ptr, value[template->part_slot[i]], value_len[template->part_slot[i]]);
+				ptr += value_len[template->part_slot[i]];
+			}
+			memcpy(ptr, template->translated + template->part_offset[i], template->part_len[i]);
+			ptr[template->part_len[i]] = 0;
+
+			return template->setup_native(handle, handle->connection, sql, tot_run, args, query);
+		}
+	}
+	//Build the submission string
+	va_start(ap, query);
+	int n = vsnprintf(NULL, 0, format, ap);
+	va_end(ap);
+	if (n < 0) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_LOG_VALID_ERROR);
+		logging_server(LOG_ERROR, __FILE__, __LINE__, handle->server_type, OPH_IOSERVER_LOG_VALID_ERROR);
+		return OPH_IOSERVER_VALID_ERROR;
+	}
+
+	char *operation = (char *) malloc(n + 1);
+	if (!operation) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_LOG_MEMORY_ERROR);
+		logging_server(LOG_ERROR, __FILE__, __LINE__, handle->server_type, OPH_IOSERVER_LOG_MEMORY_ERROR);
+		return OPH_IOSERVER_MEMORY_ERR;
+	}
+	va_start(ap, query);
+	vsnprintf(operation, n + 1, format, ap);
+	va_end(ap);
+
+	int res = oph_ioserver_setup_query(handle, operation, tot_run, args, query);
+	free(operation);
+
+	return res;
+}
+
+//Compare two optional strings
+static int _oph_ioserver_pool_strcmp(const char *a, const char *b)
+{
+	return strcmp(a ? a : "", b ? b : "");
+}
+
+static void _oph_ioserver_pool_free_entry(oph_ioserver_pool_entry * entry)
+{
+	if (!entry)
+		return;
+	if (entry->server_type)
+		free(entry->server_type);
+	if (entry->host)
+		free(entry->host);
+	if (entry->user)
+		free(entry->user);
+	free(entry);
+}
+
+//Get (or create) the handler used to close idle connections of a server type; call it with pool_lock held
+static oph_ioserver_handler *_oph_ioserver_pool_get_handler(oph_ioserver_handler * handle)
+{
+	oph_ioserver_pool_handler *ph;
+	for (ph = pool_handlers; ph; ph = ph->next)
+		if (!strcmp(ph->handle->server_type, handle->server_type))
+			return ph->handle;
+
+	char server_name[OPH_IOSERVER_BUFLEN];
+	snprintf(server_name, OPH_IOSERVER_BUFLEN, "%s%c%s", handle->server_type, OPH_IOSERVER_SEPARATOR, handle->server_subtype);
+
+	if (!(ph = (oph_ioserver_pool_handler *) malloc(sizeof(oph_ioserver_pool_handler)))) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_LOG_MEMORY_ERROR);
+		logging_server(LOG_ERROR, __FILE__, __LINE__, handle->server_type, OPH_IOSERVER_LOG_MEMORY_ERROR);
+		return NULL;
+	}
+	ph->handle = NULL;
+	if (oph_ioserver_setup(server_name, &(ph->handle), 1)) {
+		pmesg(LOG_WARNING, __FILE__, __LINE__, OPH_IOSERVER_LOG_POOL_HANDLE_ERROR, server_name);
+		logging_server(LOG_WARNING, __FILE__, __LINE__, handle->server_type, OPH_IOSERVER_LOG_POOL_HANDLE_ERROR, server_name);
+		free(ph);
+		return NULL;
+	}
+	ph->next = pool_handlers;
+	pool_handlers = ph;
+
+	return ph->handle;
+}
+
+int oph_ioserver_pool_lease(oph_ioserver_handler * handle, oph_ioserver_params * conn_params, char *hit)
+{
+	if (!handle || !conn_params) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_LOG_NULL_INPUT_PARAM);
+		logging_server(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_COMMON_LOG, OPH_IOSERVER_LOG_NULL_INPUT_PARAM);
+		return OPH_IOSERVER_NULL_PARAM;
+	}
+	if (hit)
+		*hit = 0;
+
+	if (!handle->dlh || !handle->server_type) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_LOG_LOAD_SERV_ERROR);
+		logging_server(LOG_ERROR, __FILE__, __LINE__, handle->server_type, OPH_IOSERVER_LOG_LOAD_SERV_ERROR);
+		return OPH_IOSERVER_DLOPEN_ERR;
+	}
+	//Handler is already connected: simply check the connection
+	if (handle->connection)
+		return oph_ioserver_connect(handle, conn_params);
+
+	oph_ioserver_pool_entry *entry, *prev = NULL;
+
+	//The default database is not part of the key, since it is selected with oph_ioserver_use_db after the lease
+	pthread_mutex_lock(&pool_lock);
+	for (entry = pool_idle; entry; prev = entry, entry = entry->next)
+		if ((entry->port == conn_params->port) && (entry->opt_flag == conn_params->opt_flag) && !strcmp(entry->server_type, handle->server_type) && !_oph_ioserver_pool_strcmp(entry->host, conn_params->host)
+		    && !_oph_ioserver_pool_strcmp(entry->user, conn_params->user))
+			break;
+	if (entry) {
+		if (prev)
+			prev->next = entry->next;
+		else
+			pool_idle = entry->next;
+		pool_idle_number--;
+		pool_hits++;
+	} else
+		pool_misses++;
+	pthread_mutex_unlock(&pool_lock);
+
+	if (entry) {
+		handle->connection = entry->connection;
+		entry->connection = NULL;
+		entry->next = NULL;
+		handle->pool_entry = entry;
+		if (hit)
+			*hit = 1;
+		return OPH_IOSERVER_SUCCESS;
+	}
+
+	int res;
+	if ((res = oph_ioserver_connect(handle, conn_params)))
+		return res;
+
+	//Track the new connection so that it can be given back to the pool
+	if (!(entry = (oph_ioserver_pool_entry *) calloc(1, sizeof(oph_ioserver_pool_entry)))) {
+		pmesg(LOG_WARNING, __FILE__, __LINE__, OPH_IOSERVER_LOG_MEMORY_ERROR);
+		return OPH_IOSERVER_SUCCESS;
+	}
+	entry->server_type = strdup(handle->server_type);
+	entry->host = conn_params->host ? strdup(conn_params->host) : NULL;
+	entry->user = conn_params->user ? strdup(conn_params->user) : NULL;
+	entry->port = conn_params->port;
+	entry->opt_flag = conn_params->opt_flag;
+	if (!entry->server_type || (conn_params->host && !entry->host) || (conn_params->user && !entry->user)) {
+		pmesg(LOG_WARNING, __FILE__, __LINE__, OPH_IOSERVER_LOG_MEMORY_ERROR);
+		_oph_ioserver_pool_free_entry(entry);
+		return OPH_IOSERVER_SUCCESS;
+	}
+	handle->pool_entry = entry;
+
+	return OPH_IOSERVER_SUCCESS;
+}
+
+int oph_ioserver_pool_return(oph_ioserver_handler * handle)
+{
+	if (!handle) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_LOG_NULL_HANDLE);
+		logging_server(LOG_ERROR, __FILE__, __LINE__, OPH_IOSERVER_COMMON_LOG, OPH_IOSERVER_LOG_NULL_HANDLE);
+		return OPH_IOSERVER_NULL_HANDLE;
+	}
+
+	oph_ioserver_pool_entry *entry = (oph_ioserver_pool_entry *) handle->pool_entry;
+	if (!entry || !handle->connection)
+		return oph_ioserver_close(handle);
+
+	pthread_mutex_lock(&pool_lock);
+	if ((pool_idle_number >= OPH_IOSERVER_POOL_MAX_IDLE) || !_oph_ioserver_pool_get_handler(handle)) {
+		pthread_mutex_unlock(&pool_lock);
+		return oph_ioserver_close(handle);
+	}
+	entry->connection = handle->connection;
+	entry->next = pool_idle;
+	pool_idle = entry;
+	pool_idle_number++;
+	pthread_mutex_unlock(&pool_lock);
+
+	handle->connection = NULL;
+	handle->pool_entry = NULL;
+
+	return OPH_IOSERVER_SUCCESS;
+}
+
+int oph_ioserver_pool_clear()
+{
+	oph_ioserver_pool_entry *entry, *next_entry;
+	oph_ioserver_pool_handler *ph, *next_ph;
+
+	pthread_mutex_lock(&pool_lock);
+	for (entry = pool_idle; entry; entry = next_entry) {
+		next_entry = entry->next;
+		for (ph = pool_handlers; ph; ph = ph->next)
+			if (!strcmp(ph->handle->server_type, entry->server_type))
+				break;
+		if (ph && entry->connection) {
+			ph->handle->connection = entry->connection;
+			oph_ioserver_close(ph->handle);
+		}
+		_oph_ioserver_pool_free_entry(entry);
+	}
+	pool_idle = NULL;
+	pool_idle_number = 0;
+	for (ph = pool_handlers; ph; ph = next_ph) {
+		next_ph = ph->next;
+		oph_ioserver_cleanup(ph->handle);
+		free(ph);
+	}
+	pool_handlers = NULL;
+	if (pool_hits || pool_misses)
+		pmesg(LOG_DEBUG, __FILE__, __LINE__, OPH_IOSERVER_LOG_POOL_STATS, pool_hits, pool_misses);
+	pthread_mutex_unlock(&pool_lock);
+
+	return OPH_IOSERVER_SUCCESS;
+}
+
+int oph_ioserver_pool_get_stats(unsigned long long *hits, unsigned long long *misses)
+{
+	pthread_mutex_lock(&pool_lock);
+	if (hits)
+		*hits = pool_hits;
+	if (misses)
+		*misses = pool_misses;
+	pthread_mutex_unlock(&pool_lock);
+
+	return OPH_IOSERVER_SUCCESS;
+}
+
 static int oph_find_server_plugin(const char *server_type, char **dyn_lib)
 {
 	FILE *fp = NULL;
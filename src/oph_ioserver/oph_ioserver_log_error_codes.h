@@ -40,5 +40,10 @@
 
 #define OPH_IOSERVER_LOG_VALID_ERROR       "Submission query not valid\n"
 
+#define OPH_IOSERVER_LOG_POOL_HANDLE_ERROR "Unable to setup pool handler for server %s\n"
+#define OPH_IOSERVER_LOG_POOL_STATS        "Connection pool: %llu hits, %llu misses\n"
+#define OPH_IOSERVER_LOG_STREAM_NOT_SUPPORTED "IO server %s does not support streaming of result sets: the whole result set will be retrieved\n"
+#define OPH_IOSERVER_LOG_TEMPLATE_NOT_TRANSLATED "Query template not translated by IO server %s: submission strings will be used\n"
+
 
 #endif				//__OPH_IOSERVER_LOG_ERROR_CODES_H
@@ -33,6 +33,8 @@
 
 #include "oph_dimension_library.h"
 #include "oph-lib-binary-io.h"
+#include "oph_reorder_library.h"
+#include "oph_coord_index_library.h"
 #include "debug.h"
 
 #include "oph_log_error_codes.h"
@@ -91,75 +93,13 @@ void oph_nc_dlclose(void *handle)
 
 int oph_nc_cache_to_buffer2(short int tot_dim_number, unsigned int *counters, unsigned int *limits, unsigned int *products, char *binary_cache, char *binary_insert, size_t sizeof_var)
 {
-	short int i = 0;
-	long long addr = 0;
-	long long index = 0;
-	long long total_iter = 1;
-
-	for (i = 0; i < tot_dim_number; i++) {
-		if (i != 0)
-			counters[i] = 0;
-		total_iter *= (limits[i] - counters[i]);
-	}
-
-	for (index = 0; index < total_iter; index++) {
-		addr = 0;
-		for (i = 0; i < tot_dim_number; i++) {
-			addr += counters[i] * products[i];
-		}
-		memcpy(binary_insert + index * sizeof_var, binary_cache + addr * sizeof_var, sizeof_var);
-
-		//Increase counters starting from most rapidly varying dimension
-		for (i = tot_dim_number - 1; i >= 0; i--) {
-			counters[i]++;
-			if (counters[i] < limits[i]) {
-				break;
-			} else {
-				counters[i] = 0;
-			}
-		}
-	}
-
-	return 0;
+	return oph_reorder_cache_to_buffer(tot_dim_number, counters, limits, products, binary_cache, binary_insert, sizeof_var) ? OPH_NC_ERROR : OPH_NC_SUCCESS;
 }
 
 
-int _oph_nc_cache_to_buffer(short int tot_dim_number, short int curr_dim, unsigned int *counters, unsigned int *limits, unsigned int *products, long long *index, char *binary_cache,
-			    char *binary_insert, size_t sizeof_var)
-{
-	int i = 0;
-	long long addr = 0;
-
-
-	if (tot_dim_number > curr_dim) {
-
-		if (curr_dim != 0)
-			counters[curr_dim] = 0;
-		while (counters[curr_dim] < limits[curr_dim]) {
-			_oph_nc_cache_to_buffer(tot_dim_number, curr_dim + 1, counters, limits, products, index, binary_cache, binary_insert, sizeof_var);
-			counters[curr_dim]++;
-		}
-		return 0;
-	}
-
-	if (tot_dim_number == curr_dim) {
-		addr = 0;
-		for (i = 0; i < tot_dim_number; i++) {
-			addr += counters[i] * products[i];
-		}
-
-		memcpy(binary_insert + (*index) * sizeof_var, binary_cache + addr * sizeof_var, sizeof_var);
-		(*index)++;
-		return 0;
-	}
-
-	return 0;
-}
-
 int oph_nc_cache_to_buffer(short int tot_dim_number, unsigned int *counters, unsigned int *limits, unsigned int *products, char *binary_cache, char *binary_insert, size_t sizeof_var)
 {
-	long long index = 0;
-	return _oph_nc_cache_to_buffer(tot_dim_number, 0, counters, limits, products, &index, binary_cache, binary_insert, sizeof_var);
+	return oph_reorder_cache_to_buffer(tot_dim_number, counters, limits, products, binary_cache, binary_insert, sizeof_var) ? OPH_NC_ERROR : OPH_NC_SUCCESS;
 }
 
 int oph_nc_populate_fragment_from_nc(oph_ioserver_handler * server, oph_odb_fragment * frag, int ncid, int tuplexfrag_number, int array_length, int compressed, NETCDF_var * measure)
@@ -5758,429 +5698,136 @@ int oph_nc_get_dim_array(int id_container, int ncid, int dim_id, const char dim_
 Original meaning of want_start was different: 0 for the end index, <>0 for the start index.
 Now it means: 0 for the end index, <0 for the start index, >0 for the nearest index.
 */
-int oph_nc_index_by_value(int id_container, int ncid, int dim_id, nc_type dim_type, int dim_size, char *value, int want_start, double offset, int *valorder, int *coord_index, char out_of_bound)
+int oph_nc_coord_index_init(int id_container, int ncid, int dim_id, nc_type dim_type, int dim_size, oph_coord_index * index)
 {
-	if (!ncid || !dim_size || !value || !coord_index || !valorder) {
+	if (!ncid || !dim_size || !index) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
 		return OPH_NC_ERROR;
 	}
 
-	void *binary_dim = NULL;
-	int retval = 0, nearest_point = want_start > 0;
-	//I need to evaluate the order of the dimension values: ascending or descending
-	int order = 1;		//Default is ascending
-	int exact_value = 0;	//If I find the exact value
-	int i, end_dim_size = dim_size - 1;
+	oph_coord_index_type type;
+	size_t type_size;
+	switch (dim_type) {
+		case NC_BYTE:
+		case NC_CHAR:
+			type = OPH_COORD_INDEX_BYTE;
+			type_size = sizeof(char);
+			break;
+		case NC_SHORT:
+			type = OPH_COORD_INDEX_SHORT;
+			type_size = sizeof(short);
+			break;
+		case NC_INT:
+			type = OPH_COORD_INDEX_INT;
+			type_size = sizeof(int);
+			break;
+		case NC_INT64:
+			type = OPH_COORD_INDEX_LONG;
+			type_size = sizeof(long long);
+			break;
+		case NC_FLOAT:
+			type = OPH_COORD_INDEX_FLOAT;
+			type_size = sizeof(float);
+			break;
+		case NC_DOUBLE:
+			type = OPH_COORD_INDEX_DOUBLE;
+			type_size = sizeof(double);
+			break;
+		default:
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Variable type not supported\n");
+			logging(LOG_ERROR, __FILE__, __LINE__, id_container, OPH_LOG_GENERIC_VAR_TYPE_NOT_SUPPORTED, dim_type);
+			return OPH_NC_ERROR;
+	}
 
-	if (dim_type == NC_INT) {
-		binary_dim = (void *) malloc(sizeof(int) * dim_size);
+	void *binary_dim = (void *) malloc(type_size * dim_size);
+	if (!binary_dim) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Error allocating memory\n");
+		return OPH_NC_ERROR;
+	}
 
-		if ((retval = nc_get_var_int(ncid, dim_id, (int *) binary_dim))) {
-			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to read dimension information: %s\n", nc_strerror(retval));
-			logging(LOG_ERROR, __FILE__, __LINE__, id_container, OPH_LOG_GENERIC_DIM_READ_ERROR, nc_strerror(retval));
-			free(binary_dim);
-			return OPH_NC_ERROR;
-		}
-		int *array_val = binary_dim, value_ = (int) (strtol(value, (char **) NULL, 10));
-		if (offset)
-			value_ += (int) (want_start ? -offset : offset);
-		//Check order of dimension values
-		if (array_val[0] > array_val[end_dim_size]) {	//Descending
-			order = 0;
-			if (out_of_bound && (value_ <= array_val[0]) && (value_ >= array_val[end_dim_size]))
-				out_of_bound = 0;
-		} else if (out_of_bound && (value_ >= array_val[0]) && (value_ <= array_val[end_dim_size]))
-			out_of_bound = 0;
-		if (out_of_bound) {
-			pmesg(LOG_ERROR, __FILE__, __LINE__, "Value out of the boundaries\n");
-			logging(LOG_ERROR, __FILE__, __LINE__, id_container, "Value out of the boundaries\n");
-			free(binary_dim);
-			return OPH_NC_BOUND_ERROR;
-		}
-		if (order) {
-			//Ascending
-			for (i = 0; i < dim_size; i++) {
-				if (array_val[i] >= value_) {
-					if (array_val[i] == value_)
-						exact_value = 1;
-					break;
-				}
-			}
-			if (!exact_value) {
-				if (nearest_point) {
-					if ((i > 0) && ((i == dim_size) || (value_ - array_val[i - 1] < array_val[i] - value_)))
-						i--;
-				} else if (want_start) {
-					if (i == dim_size)
-						i--;
-				} else if (i)
-					i--;
-			}
-		}		//End if(order)
-		else {
-			//Descending
-			for (i = dim_size - 1; i >= 0; i--) {
-				if (array_val[i] >= value_) {
-					if (array_val[i] == value_)
-						exact_value = 1;
-					break;
-				}
-			}
-			if (!exact_value) {
-				if (nearest_point) {
-					if ((i < dim_size - 1) && ((i < 0) || (value_ - array_val[i + 1] < array_val[i] - value_)))
-						i++;
-				} else if (want_start) {
-					if (i < 0)
-						i = 0;
-				} else if (i < dim_size - 1)
-					i++;
-			}
-		}		//End else if(order)
-	}			//End if(dim_type == NC_INT){
-	else if (dim_type == NC_BYTE || dim_type == NC_CHAR) {
-		binary_dim = (void *) malloc(sizeof(char) * dim_size);
+	int retval = 0;
+	switch (type) {
+		case OPH_COORD_INDEX_BYTE:
+			retval = nc_get_var_uchar(ncid, dim_id, (unsigned char *) binary_dim);
+			break;
+		case OPH_COORD_INDEX_SHORT:
+			retval = nc_get_var_short(ncid, dim_id, (short *) binary_dim);
+			break;
+		case OPH_COORD_INDEX_INT:
+			retval = nc_get_var_int(ncid, dim_id, (int *) binary_dim);
+			break;
+		case OPH_COORD_INDEX_LONG:
+			retval = nc_get_var_longlong(ncid, dim_id, (long long *) binary_dim);
+			break;
+		case OPH_COORD_INDEX_FLOAT:
+			retval = nc_get_var_float(ncid, dim_id, (float *) binary_dim);
+			break;
+		case OPH_COORD_INDEX_DOUBLE:
+			retval = nc_get_var_double(ncid, dim_id, (double *) binary_dim);
+			break;
+	}
+	if (retval) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to read dimension information: %s\n", nc_strerror(retval));
+		logging(LOG_ERROR, __FILE__, __LINE__, id_container, OPH_LOG_GENERIC_DIM_READ_ERROR, nc_strerror(retval));
+		free(binary_dim);
+		return OPH_NC_ERROR;
+	}
 
-		if ((retval = nc_get_var_uchar(ncid, dim_id, (unsigned char *) binary_dim))) {
-			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to read dimension information: %s\n", nc_strerror(retval));
-			logging(LOG_ERROR, __FILE__, __LINE__, id_container, OPH_LOG_GENERIC_DIM_READ_ERROR, nc_strerror(retval));
-			free(binary_dim);
-			return OPH_NC_ERROR;
-		}
-		char *array_val = binary_dim, value_ = (char) (strtol(value, (char **) NULL, 10));
-		if (offset)
-			value_ += (char) (want_start ? -offset : offset);
-		//Check order of dimension values
-		if (array_val[0] > array_val[end_dim_size]) {	//Descending
-			order = 0;
-			if (out_of_bound && (value_ <= array_val[0]) && (value_ >= array_val[end_dim_size]))
-				out_of_bound = 0;
-		} else if (out_of_bound && (value_ >= array_val[0]) && (value_ <= array_val[end_dim_size]))
-			out_of_bound = 0;
-		if (out_of_bound) {
-			pmesg(LOG_ERROR, __FILE__, __LINE__, "Value out of the boundaries\n");
-			logging(LOG_ERROR, __FILE__, __LINE__, id_container, "Value out of the boundaries\n");
-			free(binary_dim);
-			return OPH_NC_BOUND_ERROR;
-		}
-		if (order) {
-			//Ascending
-			for (i = 0; i < dim_size; i++) {
-				if (array_val[i] >= value_) {
-					if (array_val[i] == value_)
-						exact_value = 1;
-					break;
-				}
-			}
-			if (!exact_value) {
-				if (nearest_point) {
-					if ((i > 0) && ((i == dim_size) || (value_ - array_val[i - 1] < array_val[i] - value_)))
-						i--;
-				} else if (want_start) {
-					if (i == dim_size)
-						i--;
-				} else if (i)
-					i--;
-			}
-		}		//End if(order)
-		else {
-			//Descending
-			for (i = dim_size - 1; i >= 0; i--) {
-				if (array_val[i] >= value_) {
-					if (array_val[i] == value_)
-						exact_value = 1;
-					break;
-				}
-			}
-			if (!exact_value) {
-				if (nearest_point) {
-					if ((i < dim_size - 1) && ((i < 0) || (value_ - array_val[i + 1] < array_val[i] - value_)))
-						i++;
-				} else if (want_start) {
-					if (i < 0)
-						i = 0;
-				} else if (i < dim_size - 1)
-					i++;
-			}
-		}		//End else if(order)
-	}			//End if(dim_type == NC_BYTE){
-	else if (dim_type == NC_SHORT) {
-		binary_dim = (void *) malloc(sizeof(short) * dim_size);
+	retval = oph_coord_index_init(index, type, binary_dim, dim_size);
+	free(binary_dim);
+	if (retval) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to index dimension values\n");
+		return OPH_NC_ERROR;
+	}
 
-		if ((retval = nc_get_var_short(ncid, dim_id, (short *) binary_dim))) {
-			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to read dimension information: %s\n", nc_strerror(retval));
-			logging(LOG_ERROR, __FILE__, __LINE__, id_container, OPH_LOG_GENERIC_DIM_READ_ERROR, nc_strerror(retval));
-			free(binary_dim);
-			return OPH_NC_ERROR;
-		}
-		short *array_val = binary_dim, value_ = (short) (strtol(value, (char **) NULL, 10));
-		if (offset)
-			value_ += (short) (want_start ? -offset : offset);
-		//Check order of dimension values
-		if (array_val[0] > array_val[end_dim_size]) {	//Descending
-			order = 0;
-			if (out_of_bound && (value_ <= array_val[0]) && (value_ >= array_val[end_dim_size]))
-				out_of_bound = 0;
-		} else if (out_of_bound && (value_ >= array_val[0]) && (value_ <= array_val[end_dim_size]))
-			out_of_bound = 0;
-		if (out_of_bound) {
-			pmesg(LOG_ERROR, __FILE__, __LINE__, "Value out of the boundaries\n");
-			logging(LOG_ERROR, __FILE__, __LINE__, id_container, "Value out of the boundaries\n");
-			free(binary_dim);
-			return OPH_NC_BOUND_ERROR;
-		}
-		if (order) {
-			//Ascending
-			for (i = 0; i < dim_size; i++) {
-				if (array_val[i] >= value_) {
-					if (array_val[i] == value_)
-						exact_value = 1;
-					break;
-				}
-			}
-			if (!exact_value) {
-				if (nearest_point) {
-					if ((i > 0) && ((i == dim_size) || (value_ - array_val[i - 1] < array_val[i] - value_)))
-						i--;
-				} else if (want_start) {
-					if (i == dim_size)
-						i--;
-				} else if (i)
-					i--;
-			}
-		}		//End if(order)
-		else {
-			//Descending
-			for (i = dim_size - 1; i >= 0; i--) {
-				if (array_val[i] >= value_) {
-					if (array_val[i] == value_)
-						exact_value = 1;
-					break;
-				}
-			}
-			if (!exact_value) {
-				if (nearest_point) {
-					if ((i < dim_size - 1) && ((i < 0) || (value_ - array_val[i + 1] < array_val[i] - value_)))
-						i++;
-				} else if (want_start) {
-					if (i < 0)
-						i = 0;
-				} else if (i < dim_size - 1)
-					i++;
-			}
-		}		//End else if(order)
-	}			//End if(dim_type == NC_SHORT){
-	else if (dim_type == NC_FLOAT) {
-		binary_dim = (void *) malloc(sizeof(float) * dim_size);
+	return OPH_NC_SUCCESS;
+}
 
-		if ((retval = nc_get_var_float(ncid, dim_id, (float *) binary_dim))) {
-			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to read dimension information: %s\n", nc_strerror(retval));
-			logging(LOG_ERROR, __FILE__, __LINE__, id_container, OPH_LOG_GENERIC_DIM_READ_ERROR, nc_strerror(retval));
-			free(binary_dim);
-			return OPH_NC_ERROR;
-		}
-		float *array_val = binary_dim, value_ = (float) (strtof(value, NULL));
-		if (offset)
-			value_ += (float) (want_start ? -offset : offset);
-		//Check order of dimension values
-		if (array_val[0] > array_val[end_dim_size]) {	//Descending
-			order = 0;
-			if (out_of_bound && (value_ <= array_val[0]) && (value_ >= array_val[end_dim_size]))
-				out_of_bound = 0;
-		} else if (out_of_bound && (value_ >= array_val[0]) && (value_ <= array_val[end_dim_size]))
-			out_of_bound = 0;
-		if (out_of_bound) {
-			pmesg(LOG_ERROR, __FILE__, __LINE__, "Value out of the boundaries\n");
-			logging(LOG_ERROR, __FILE__, __LINE__, id_container, "Value out of the boundaries\n");
-			free(binary_dim);
-			return OPH_NC_BOUND_ERROR;
-		}
-		if (order) {
-			//Ascending
-			for (i = 0; i < dim_size; i++) {
-				if (array_val[i] >= value_) {
-					if (array_val[i] == value_)
-						exact_value = 1;
-					break;
-				}
-			}
-			if (!exact_value) {
-				if (nearest_point) {
-					if ((i > 0) && ((i == dim_size) || (value_ - array_val[i - 1] < array_val[i] - value_)))
-						i--;
-				} else if (want_start) {
-					if (i == dim_size)
-						i--;
-				} else if (i)
-					i--;
-			}
-		}		//End if(order)
-		else {
-			//Descending
-			for (i = dim_size - 1; i >= 0; i--) {
-				if (array_val[i] >= value_) {
-					if (array_val[i] == value_)
-						exact_value = 1;
-					break;
-				}
-			}
-			if (!exact_value) {
-				if (nearest_point) {
-					if ((i < dim_size - 1) && ((i < 0) || (value_ - array_val[i + 1] < array_val[i] - value_)))
-						i++;
-				} else if (want_start) {
-					if (i < 0)
-						i = 0;
-				} else if (i < dim_size - 1)
-					i++;
-			}
-		}		//End else if(order)
-	}			//End if(dim_type == NC_FLOAT){
-	else if (dim_type == NC_DOUBLE) {
-		binary_dim = (void *) malloc(sizeof(double) * dim_size);
+int oph_nc_index_by_value2(int id_container, oph_coord_index * index, char *value, int want_start, double offset, int *valorder, int *coord_index, char out_of_bound)
+{
+	if (!index || !value || !coord_index || !valorder) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_NC_ERROR;
+	}
 
-		if ((retval = nc_get_var_double(ncid, dim_id, (double *) binary_dim))) {
-			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to read dimension information: %s\n", nc_strerror(retval));
-			logging(LOG_ERROR, __FILE__, __LINE__, id_container, OPH_LOG_GENERIC_DIM_READ_ERROR, nc_strerror(retval));
-			free(binary_dim);
-			return OPH_NC_ERROR;
-		}
-		double *array_val = binary_dim, value_ = (double) (strtod(value, NULL));
-		if (offset)
-			value_ += want_start ? -offset : offset;
-		//Check order of dimension values
-		if (array_val[0] > array_val[end_dim_size]) {	//Descending
-			order = 0;
-			if (out_of_bound && (value_ <= array_val[0]) && (value_ >= array_val[end_dim_size]))
-				out_of_bound = 0;
-		} else if (out_of_bound && (value_ >= array_val[0]) && (value_ <= array_val[end_dim_size]))
-			out_of_bound = 0;
-		if (out_of_bound) {
-			pmesg(LOG_ERROR, __FILE__, __LINE__, "Value out of the boundaries\n");
-			logging(LOG_ERROR, __FILE__, __LINE__, id_container, "Value out of the boundaries\n");
-			free(binary_dim);
-			return OPH_NC_BOUND_ERROR;
-		}
-		if (order) {
-			//Ascending
-			for (i = 0; i < dim_size; i++) {
-				if (array_val[i] >= value_) {
-					if (array_val[i] == value_) {
-						exact_value = 1;
-					}
-					break;
-				}
-			}
-			if (!exact_value) {
-				if (nearest_point) {
-					if ((i > 0) && ((i == dim_size) || (value_ - array_val[i - 1] < array_val[i] - value_)))
-						i--;
-				} else if (want_start) {
-					if (i == dim_size)
-						i--;
-				} else if (i)
-					i--;
-			}
-		}		//End if(order)
-		else {
-			//Descending
-			for (i = dim_size - 1; i >= 0; i--) {
-				if (array_val[i] >= value_) {
-					if (array_val[i] == value_)
-						exact_value = 1;
-					break;
-				}
-			}
-			if (!exact_value) {
-				if (nearest_point) {
-					if ((i < dim_size - 1) && ((i < 0) || (value_ - array_val[i + 1] < array_val[i] - value_)))
-						i++;
-				} else if (want_start) {
-					if (i < 0)
-						i = 0;
-				} else if (i < dim_size - 1)
-					i++;
-			}
-		}		//End else if(order)
-	}			//End if(dim_type == NC_DOUBLE){
-	else if (dim_type == NC_INT64) {
-		binary_dim = (void *) malloc(sizeof(long long) * dim_size);
+	oph_coord_index_value value_;
+	if (oph_coord_index_parse_value(index, value, want_start, offset, &value_)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to parse value '%s'\n", value);
+		return OPH_NC_ERROR;
+	}
 
-		if ((retval = nc_get_var_longlong(ncid, dim_id, (long long *) binary_dim))) {
-			pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to read dimension information: %s\n", nc_strerror(retval));
-			logging(LOG_ERROR, __FILE__, __LINE__, id_container, OPH_LOG_GENERIC_DIM_READ_ERROR, nc_strerror(retval));
-			free(binary_dim);
-			return OPH_NC_ERROR;
-		}
-		long long *array_val = binary_dim, value_ = (long long) (strtoll(value, (char **) NULL, 10));
-		if (offset)
-			value_ += (long long) (want_start ? -offset : offset);
-		//Check order of dimension values
-		if (array_val[0] > array_val[end_dim_size]) {	//Descending
-			order = 0;
-			if (out_of_bound && (value_ <= array_val[0]) && (value_ >= array_val[end_dim_size]))
-				out_of_bound = 0;
-		} else if (out_of_bound && (value_ >= array_val[0]) && (value_ <= array_val[end_dim_size]))
-			out_of_bound = 0;
-		if (out_of_bound) {
+	switch (oph_coord_index_find(index, &value_, want_start, out_of_bound, coord_index)) {
+		case OPH_COORD_INDEX_SUCCESS:
+			break;
+		case OPH_COORD_INDEX_BOUND_ERROR:
 			pmesg(LOG_ERROR, __FILE__, __LINE__, "Value out of the boundaries\n");
 			logging(LOG_ERROR, __FILE__, __LINE__, id_container, "Value out of the boundaries\n");
-			free(binary_dim);
 			return OPH_NC_BOUND_ERROR;
-		}
-		if (order) {
-			//Ascending
-			for (i = 0; i < dim_size; i++) {
-				if (array_val[i] >= value_) {
-					if (array_val[i] == value_)
-						exact_value = 1;
-					break;
-				}
-			}
-			if (!exact_value) {
-				if (nearest_point) {
-					if ((i > 0) && ((i == dim_size) || (value_ - array_val[i - 1] < array_val[i] - value_)))
-						i--;
-				} else if (want_start) {
-					if (i == dim_size)
-						i--;
-				} else if (i)
-					i--;
-			}
-		}		//End if(order)
-		else {
-			//Descending
-			for (i = dim_size - 1; i >= 0; i--) {
-				if (array_val[i] >= value_) {
-					if (array_val[i] == value_)
-						exact_value = 1;
-					break;
-				}
-			}
-			if (!exact_value) {
-				if (nearest_point) {
-					if ((i < dim_size - 1) && ((i < 0) || (value_ - array_val[i + 1] < array_val[i] - value_)))
-						i++;
-				} else if (want_start) {
-					if (i < 0)
-						i = 0;
-				} else if (i < dim_size - 1)
-					i++;
-			}
-		}		//End else if(order)
-	}			//End if(dim_type == NC_INT64){
-	else {
-		pmesg(LOG_ERROR, __FILE__, __LINE__, "Variable type not supported\n");
-		logging(LOG_ERROR, __FILE__, __LINE__, id_container, OPH_LOG_GENERIC_VAR_TYPE_NOT_SUPPORTED, dim_type);
-		free(binary_dim);
-		return OPH_NC_ERROR;
+		default:
+			return OPH_NC_ERROR;
 	}
-	free(binary_dim);
-	*coord_index = i;
-	*valorder = order;
+	*valorder = index->order;
+
 	return OPH_NC_SUCCESS;
 }
 
+int oph_nc_index_by_value(int id_container, int ncid, int dim_id, nc_type dim_type, int dim_size, char *value, int want_start, double offset, int *valorder, int *coord_index, char out_of_bound)
+{
+	if (!ncid || !dim_size || !value || !coord_index || !valorder) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_NC_ERROR;
+	}
+
+	oph_coord_index index;
+	int res;
+	if ((res = oph_nc_coord_index_init(id_container, ncid, dim_id, dim_type, dim_size, &index)))
+		return res;
+	res = oph_nc_index_by_value2(id_container, &index, value, want_start, offset, valorder, coord_index, out_of_bound);
+	oph_coord_index_free(&index);
+
+	return res;
+}
+
 int oph_nc_compare_nc_c_types(int id_container, nc_type var_type, const char dim_type[OPH_ODB_DIM_DIMENSION_TYPE_SIZE])
 {
 	if (!var_type || !dim_type) {
@@ -6623,20 +6270,29 @@ int oph_nc_check_subset_string(char *curfilter, int i, NETCDF_var * measure, int
 				return OPH_NC_ERROR;
 			}
 
+			//Coordinate values are read once for both the bounds of the interval
+			oph_coord_index index;
+			if ((error = oph_nc_coord_index_init(OPH_GENERIC_CONTAINER_ID, ncid, tmp_var.varid, tmp_var.vartype, measure->dims_length[i], &index))) {
+				pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to read dimension information\n");
+				logging(LOG_ERROR, __FILE__, __LINE__, OPH_GENERIC_CONTAINER_ID, OPH_LOG_OPH_IMPORTNC_INVALID_INPUT_STRING);
+				return error;
+			}
+
 			int coord_index = -1;
 			int want_start = -1;
 			int order = 1;	//It will be changed by the following function (1 ascending, 0 descending)
 			//Extract index of the point given the dimension value
-			if ((error = oph_nc_index_by_value
-			     (OPH_GENERIC_CONTAINER_ID, ncid, tmp_var.varid, tmp_var.vartype, measure->dims_length[i], startfilter, want_start, offset, &order, &coord_index, out_of_bound))) {
+			if ((error = oph_nc_index_by_value2(OPH_GENERIC_CONTAINER_ID, &index, startfilter, want_start, offset, &order, &coord_index, out_of_bound))) {
 				pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to read dimension information\n");
 				logging(LOG_ERROR, __FILE__, __LINE__, OPH_GENERIC_CONTAINER_ID, OPH_LOG_OPH_IMPORTNC_INVALID_INPUT_STRING, nc_strerror(retval));
+				oph_coord_index_free(&index);
 				return error;
 			}
 			//Value too big
 			if (coord_index >= (int) measure->dims_length[i]) {
 				pmesg(LOG_ERROR, __FILE__, __LINE__, "Values exceed dimensions bound\n");
 				logging(LOG_ERROR, __FILE__, __LINE__, OPH_GENERIC_CONTAINER_ID, OPH_LOG_OPH_IMPORTNC_INVALID_INPUT_STRING);
+				oph_coord_index_free(&index);
 				return OPH_NC_BOUND_ERROR;
 			}
 			measure->dims_start_index[i] = coord_index;
@@ -6645,8 +6301,9 @@ int oph_nc_check_subset_string(char *curfilter, int i, NETCDF_var * measure, int
 			want_start = 0;
 			order = 1;	//It will be changed by the following function (1 ascending, 0 descending)
 			//Extract index of the point given the dimension value
-			if ((error = oph_nc_index_by_value
-			     (OPH_GENERIC_CONTAINER_ID, ncid, tmp_var.varid, tmp_var.vartype, measure->dims_length[i], endfilter, want_start, offset, &order, &coord_index, out_of_bound))) {
+			error = oph_nc_index_by_value2(OPH_GENERIC_CONTAINER_ID, &index, endfilter, want_start, offset, &order, &coord_index, out_of_bound);
+			oph_coord_index_free(&index);
+			if (error) {
 				pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to read dimension information\n");
 				logging(LOG_ERROR, __FILE__, __LINE__, OPH_GENERIC_CONTAINER_ID, OPH_LOG_OPH_IMPORTNC_INVALID_INPUT_STRING);
 				return error;
@@ -0,0 +1,182 @@
+/*
+    Ophidia Analytics Framework
+    Copyright (C) 2012-2024 CMCC Foundation
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "oph_reorder_library.h"
+
+#include <string.h>
+
+#include "debug.h"
+
+extern int msglevel;
+
+// Kernels are defined for each element size, so that the compiler can translate memcpy into single moves and vectorize the loops
+
+// Copy n elements whose input stride is src_stride (in elements)
+#define OPH_REORDER_ROW_KERNEL(name, size_expr) \
+static void name(char *dst, const char *src, size_t n, size_t src_stride, size_t _size) \
+{ \
+	const size_t size = size_expr; \
+	size_t i, step = src_stride * size; \
+	(void) _size; \
+	for (i = 0; i < n; i++, dst += size, src += step) \
+		memcpy(dst, src, size); \
+}
+
+// Transpose a rows x cols block: row r is contiguous in input, column c is contiguous in output
+#define OPH_REORDER_TILE_KERNEL(name, size_expr) \
+static void name(char *dst, const char *src, size_t rows, size_t cols, size_t dst_stride, size_t src_stride, size_t _size) \
+{ \
+	const size_t size = size_expr; \
+	size_t r, c, rb, cb, r_end, c_end; \
+	(void) _size; \
+	for (rb = 0; rb < rows; rb += OPH_REORDER_BLOCK_SIZE) { \
+		r_end = rb + OPH_REORDER_BLOCK_SIZE < rows ? rb + OPH_REORDER_BLOCK_SIZE : rows; \
+		for (cb = 0; cb < cols; cb += OPH_REORDER_BLOCK_SIZE) { \
+			c_end = cb + OPH_REORDER_BLOCK_SIZE < cols ? cb + OPH_REORDER_BLOCK_SIZE : cols; \
+			for (r = rb; r < r_end; r++) { \
+				char *d = dst + (r * dst_stride + cb) * size; \
+				const char *s = src + (r + cb * src_stride) * size; \
+				for (c = cb; c < c_end; c++, d += size, s += src_stride * size) \
+					memcpy(d, s, size); \
+			} \
+		} \
+	} \
+}
+
+OPH_REORDER_ROW_KERNEL(_oph_reorder_row_1, 1)
+OPH_REORDER_ROW_KERNEL(_oph_reorder_row_2, 2)
+OPH_REORDER_ROW_KERNEL(_oph_reorder_row_4, 4)
+OPH_REORDER_ROW_KERNEL(_oph_reorder_row_8, 8)
+OPH_REORDER_ROW_KERNEL(_oph_reorder_row_n, _size)
+
+OPH_REORDER_TILE_KERNEL(_oph_reorder_tile_1, 1)
+OPH_REORDER_TILE_KERNEL(_oph_reorder_tile_2, 2)
+OPH_REORDER_TILE_KERNEL(_oph_reorder_tile_4, 4)
+OPH_REORDER_TILE_KERNEL(_oph_reorder_tile_8, 8)
+OPH_REORDER_TILE_KERNEL(_oph_reorder_tile_n, _size)
+
+int oph_reorder_cache_to_buffer(short int tot_dim_number, unsigned int *counters, unsigned int *limits, unsigned int *products, char *binary_cache, char *binary_insert, size_t sizeof_var)
+{
+	if (tot_dim_number <= 0 || !counters || !limits || !products || !binary_cache || !binary_insert || !sizeof_var) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_REORDER_NULL_PARAM;
+	}
+
+	short int i;
+	int m = 0, k, t, inner, tile = -1, outer_number = 0;
+	size_t extent[tot_dim_number], stride[tot_dim_number], out_stride[tot_dim_number], index[tot_dim_number];
+	int outer[tot_dim_number];
+	const char *src = binary_cache + (size_t) counters[0] * products[0] * sizeof_var;
+
+	// Drop dimensions with a single value and merge the ones adjacent in both layouts
+	for (i = 0; i < tot_dim_number; i++) {
+		size_t first = i ? 0 : counters[0];
+		size_t count = limits[i] > first ? limits[i] - first : 0;
+		if (!count) {
+			m = -1;
+			break;
+		}
+		if (count == 1)
+			continue;
+		if (m && (stride[m - 1] == count * products[i])) {
+			extent[m - 1] *= count;
+			stride[m - 1] = products[i];
+		} else {
+			extent[m] = count;
+			stride[m] = products[i];
+			m++;
+		}
+	}
+	for (i = 0; i < tot_dim_number; i++)
+		counters[i] = limits[i];
+	if (m < 0)
+		return OPH_REORDER_SUCCESS;
+	if (!m) {
+		memcpy(binary_insert, src, sizeof_var);
+		return OPH_REORDER_SUCCESS;
+	}
+
+	inner = m - 1;
+	out_stride[inner] = 1;
+	for (k = inner - 1; k >= 0; k--)
+		out_stride[k] = out_stride[k + 1] * extent[k + 1];
+
+	// A transposition is needed when the innermost output dimension is not contiguous in input, but another one is
+	if (stride[inner] != 1)
+		for (k = 0; k < inner; k++)
+			if (stride[k] == 1) {
+				tile = k;
+				break;
+			}
+
+	for (k = 0; k < inner; k++)
+		if (k != tile) {
+			outer[outer_number++] = k;
+			index[k] = 0;
+		}
+
+	void (*row_kernel) (char *, const char *, size_t, size_t, size_t) = NULL;
+	void (*tile_kernel) (char *, const char *, size_t, size_t, size_t, size_t, size_t) = NULL;
+	switch (sizeof_var) {
+		case 1:
+			row_kernel = _oph_reorder_row_1;
+			tile_kernel = _oph_reorder_tile_1;
+			break;
+		case 2:
+			row_kernel = _oph_reorder_row_2;
+			tile_kernel = _oph_reorder_tile_2;
+			break;
+		case 4:
+			row_kernel = _oph_reorder_row_4;
+			tile_kernel = _oph_reorder_tile_4;
+			break;
+		case 8:
+			row_kernel = _oph_reorder_row_8;
+			tile_kernel = _oph_reorder_tile_8;
+			break;
+		default:
+			row_kernel = _oph_reorder_row_n;
+			tile_kernel = _oph_reorder_tile_n;
+	}
+
+	size_t src_offset = 0, dst_offset = 0;
+	do {
+		if (tile >= 0)
+			tile_kernel(binary_insert + dst_offset * sizeof_var, src + src_offset * sizeof_var, extent[tile], extent[inner], out_stride[tile], stride[inner], sizeof_var);
+		else if (stride[inner] == 1)
+			memcpy(binary_insert + dst_offset * sizeof_var, src + src_offset * sizeof_var, extent[inner] * sizeof_var);
+		else
+			row_kernel(binary_insert + dst_offset * sizeof_var, src + src_offset * sizeof_var, extent[inner], stride[inner], sizeof_var);
+
+		// Move to next block starting from most rapidly varying dimension
+		for (t = outer_number - 1; t >= 0; t--) {
+			k = outer[t];
+			index[k]++;
+			src_offset += stride[k];
+			dst_offset += out_stride[k];
+			if (index[k] < extent[k])
+				break;
+			src_offset -= extent[k] * stride[k];
+			dst_offset -= extent[k] * out_stride[k];
+			index[k] = 0;
+		}
+	}
+	while (t >= 0);
+
+	return OPH_REORDER_SUCCESS;
+}
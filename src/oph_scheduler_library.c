@@ -0,0 +1,190 @@
+/*
+    Ophidia Analytics Framework
+    Copyright (C) 2012-2024 CMCC Foundation
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "oph_scheduler_library.h"
+
+#include <string.h>
+#include <stdlib.h>
+
+#include "debug.h"
+
+extern int msglevel;
+
+int _oph_sched_alloc(oph_sched * sched, int item_number, int thread_number, int capacity)
+{
+	int i;
+
+	memset(sched, 0, sizeof(oph_sched));
+	sched->item_number = item_number;
+	sched->thread_number = thread_number;
+	sched->capacity = capacity > 0 ? capacity : 1;
+
+	if (!(sched->deque = (oph_sched_deque *) calloc(thread_number, sizeof(oph_sched_deque)))) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Error allocating memory\n");
+		return OPH_SCHED_MEMORY_ERROR;
+	}
+	for (i = 0; i < thread_number; i++) {
+		if (!(sched->deque[i].item = (int *) malloc(sched->capacity * sizeof(int)))) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Error allocating memory\n");
+			for (i--; i >= 0; i--) {
+				free(sched->deque[i].item);
+				pthread_mutex_destroy(&(sched->deque[i].mutex));
+			}
+			free(sched->deque);
+			sched->deque = NULL;
+			return OPH_SCHED_MEMORY_ERROR;
+		}
+		pthread_mutex_init(&(sched->deque[i].mutex), NULL);
+	}
+	pthread_mutex_init(&(sched->stat_mutex), NULL);
+
+	return OPH_SCHED_SUCCESS;
+}
+
+int oph_sched_init(oph_sched * sched, int item_number, int thread_number, char steal)
+{
+	if (!sched || item_number < 0 || thread_number <= 0) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_SCHED_NULL_PARAM;
+	}
+
+	int itemxthread = item_number / thread_number;
+	int remainder = item_number % thread_number;
+
+	if (_oph_sched_alloc(sched, item_number, thread_number, itemxthread + (remainder ? 1 : 0)))
+		return OPH_SCHED_MEMORY_ERROR;
+	sched->steal = steal;
+
+	// Initial assignment is the same linear block distribution used by static scheduling
+	int i, j, first = 0;
+	for (i = 0; i < thread_number; i++) {
+		sched->deque[i].head = 0;
+		sched->deque[i].tail = itemxthread + (i < remainder ? 1 : 0);
+		for (j = 0; j < sched->deque[i].tail; j++)
+			sched->deque[i].item[j] = first + j;
+		first += sched->deque[i].tail;
+	}
+
+	return OPH_SCHED_SUCCESS;
+}
+
+int _oph_sched_steal(oph_sched * sched, int thread_id)
+{
+	int i, victim = -1, available, max_available = 0;
+
+	// Look for the most loaded thread
+	for (i = 0; i < sched->thread_number; i++) {
+		if (i == thread_id)
+			continue;
+		pthread_mutex_lock(&(sched->deque[i].mutex));
+		available = sched->deque[i].tail - sched->deque[i].head;
+		pthread_mutex_unlock(&(sched->deque[i].mutex));
+		if (available > max_available) {
+			max_available = available;
+			victim = i;
+		}
+	}
+	if (victim < 0)
+		return OPH_SCHED_EMPTY;
+
+	oph_sched_deque *thief = &(sched->deque[thread_id]), *target = &(sched->deque[victim]);
+
+	// Lock in index order to avoid deadlocks among concurrent thieves
+	if (thread_id < victim) {
+		pthread_mutex_lock(&(thief->mutex));
+		pthread_mutex_lock(&(target->mutex));
+	} else {
+		pthread_mutex_lock(&(target->mutex));
+		pthread_mutex_lock(&(thief->mutex));
+	}
+
+	// Take the second half of remaining items, leaving the victim the ones it will process next
+	available = target->tail - target->head;
+	int count = (available + 1) / 2;
+	if (count > sched->capacity)
+		count = sched->capacity;
+	if (count > 0) {
+		memcpy(thief->item, target->item + target->tail - count, count * sizeof(int));
+		thief->head = 0;
+		thief->tail = count;
+		target->tail -= count;
+	}
+
+	pthread_mutex_unlock(&(target->mutex));
+	pthread_mutex_unlock(&(thief->mutex));
+
+	if (!count)
+		return OPH_SCHED_EMPTY;
+
+	pthread_mutex_lock(&(sched->stat_mutex));
+	sched->steals++;
+	pthread_mutex_unlock(&(sched->stat_mutex));
+	pmesg(LOG_DEBUG, __FILE__, __LINE__, "Thread %d stole %d items from thread %d\n", thread_id, count, victim);
+
+	return OPH_SCHED_SUCCESS;
+}
+
+int oph_sched_next(oph_sched * sched, int thread_id, int *item)
+{
+	if (!sched || !sched->deque || !item || thread_id < 0 || thread_id >= sched->thread_number) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_SCHED_NULL_PARAM;
+	}
+
+	oph_sched_deque *deque = &(sched->deque[thread_id]);
+
+	while (1) {
+		pthread_mutex_lock(&(deque->mutex));
+		if (deque->head < deque->tail) {
+			*item = deque->item[deque->head++];
+			pthread_mutex_unlock(&(deque->mutex));
+			return OPH_SCHED_SUCCESS;
+		}
+		pthread_mutex_unlock(&(deque->mutex));
+
+		if (!sched->steal || _oph_sched_steal(sched, thread_id))
+			break;
+	}
+
+	return OPH_SCHED_EMPTY;
+}
+
+int oph_sched_free(oph_sched * sched)
+{
+	if (!sched) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_SCHED_NULL_PARAM;
+	}
+
+	int i;
+	if (sched->deque) {
+		for (i = 0; i < sched->thread_number; i++) {
+			if (sched->deque[i].item)
+				free(sched->deque[i].item);
+			pthread_mutex_destroy(&(sched->deque[i].mutex));
+		}
+		free(sched->deque);
+		sched->deque = NULL;
+		pthread_mutex_destroy(&(sched->stat_mutex));
+	}
+
+	if (sched->steals)
+		pmesg(LOG_DEBUG, __FILE__, __LINE__, "%d steals performed to balance %d items among %d threads\n", sched->steals, sched->item_number, sched->thread_number);
+
+	return OPH_SCHED_SUCCESS;
+}
@@ -450,6 +450,154 @@ unsigned long long oph_subset_id_to_index2(unsigned long long id, unsigned long
 	return 1 + (((id - 1) / block_size) % max);
 }
 
+int oph_subset_filter_compile(oph_subset * subset, unsigned long long size, unsigned long long block_size, oph_subset_filter * filter)
+{
+	if (!subset || !filter) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null pointer\n");
+		return OPH_SUBSET_LIB_NULL_POINTER_ERR;
+	}
+	memset(filter, 0, sizeof(oph_subset_filter));
+	if (!size || !block_size) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Wrong input data: dimension size is not correctly set\n");
+		return OPH_SUBSET_LIB_DATA_ERR;
+	}
+	filter->size = size;
+	filter->block_size = block_size;
+
+	if (!(filter->bitmap = (unsigned char *) calloc((size + 7) >> 3, sizeof(unsigned char)))) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Error in allocating oph_subset_filter\n");
+		return OPH_SUBSET_LIB_SYSTEM_ERR;
+	}
+
+	unsigned int i;
+	unsigned long long j, end;
+	for (i = 0; i < subset->number; ++i) {
+		end = subset->end[i] < size ? subset->end[i] : size;
+		for (j = subset->start[i]; j <= end; j += subset->stride[i])	// It is not C-like indexing
+			filter->bitmap[(j - 1) >> 3] |= 1 << ((j - 1) & 7);
+	}
+
+	// Intervals are extracted from the bitmap, so that they are sorted and merged
+	for (j = 1; j <= size; ++j)
+		if (oph_subset_filter_index_is_in(filter, j) && ((j == 1) || !oph_subset_filter_index_is_in(filter, j - 1)))
+			filter->number++;
+	if (filter->number) {
+		filter->start = (unsigned long long *) malloc(filter->number * sizeof(unsigned long long));
+		filter->end = (unsigned long long *) malloc(filter->number * sizeof(unsigned long long));
+		if (!filter->start || !filter->end) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Error in allocating oph_subset_filter\n");
+			oph_subset_filter_free(filter);
+			return OPH_SUBSET_LIB_SYSTEM_ERR;
+		}
+		filter->number = 0;
+		for (j = 1; j <= size; ++j)
+			if (oph_subset_filter_index_is_in(filter, j)) {
+				if ((j == 1) || !oph_subset_filter_index_is_in(filter, j - 1))
+					filter->start[filter->number++] = j;
+				filter->end[filter->number - 1] = j;
+			}
+	}
+
+	return OPH_SUBSET_LIB_OK;
+}
+
+int oph_subset_filter_index_is_in(oph_subset_filter * filter, unsigned long long index)
+{
+	if (!index || (index > filter->size))
+		return 0;
+	index--;		// It is not C-like indexing
+	return (filter->bitmap[index >> 3] >> (index & 7)) & 1;
+}
+
+int oph_subset_filter_id_is_in(oph_subset_filter * filter, unsigned long long id)
+{
+	return oph_subset_filter_index_is_in(filter, oph_subset_id_to_index2(id, filter->block_size, filter->size));
+}
+
+int oph_subset_filter_id_ranges(oph_subset_filter * filter, unsigned long long max_id, unsigned long long max_number, unsigned long long **id_start, unsigned long long **id_end,
+				unsigned long long *number)
+{
+	if (!filter || !id_start || !id_end || !number) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null pointer\n");
+		return OPH_SUBSET_LIB_NULL_POINTER_ERR;
+	}
+	*id_start = *id_end = NULL;
+	*number = 0;
+
+	unsigned long long period = filter->block_size * filter->size, repetitions = (max_id + period - 1) / period, offset, first, last, previous, r, k;
+	unsigned long long i;
+	int pass;
+	if (!filter->number || !repetitions)
+		return OPH_SUBSET_LIB_OK;
+
+	// Ranges of slower dimensions are repeated every 'period' ids; the first range of a repetition is merged with the last one of the previous repetition when they are adjacent
+	// Ranges are counted in the first pass, so that at most max_number ranges are allocated and filled in the second one
+	for (pass = 0; pass < 2; ++pass) {
+		for (r = k = previous = 0; (r < repetitions) && (pass || (k <= max_number)); ++r) {
+			offset = r * period;
+			for (i = 0; i < filter->number; ++i) {
+				first = offset + (filter->start[i] - 1) * filter->block_size + 1;
+				if (first > max_id)
+					break;
+				last = offset + filter->end[i] * filter->block_size;
+				if (last > max_id)
+					last = max_id;
+				if (k && (previous + 1 == first)) {
+					if (pass)
+						(*id_end)[k - 1] = last;
+				} else {
+					if (pass) {
+						(*id_start)[k] = first;
+						(*id_end)[k] = last;
+					}
+					k++;
+				}
+				previous = last;
+			}
+		}
+		if (pass)
+			break;
+		if (k > max_number) {
+			pmesg(LOG_DEBUG, __FILE__, __LINE__, "Too many id ranges: at most %llu are allowed\n", max_number);
+			return OPH_SUBSET_LIB_DATA_ERR;
+		}
+		*id_start = (unsigned long long *) malloc(k * sizeof(unsigned long long));
+		*id_end = (unsigned long long *) malloc(k * sizeof(unsigned long long));
+		if (!*id_start || !*id_end) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Error in allocating id ranges\n");
+			if (*id_start)
+				free(*id_start);
+			if (*id_end)
+				free(*id_end);
+			*id_start = *id_end = NULL;
+			return OPH_SUBSET_LIB_SYSTEM_ERR;
+		}
+	}
+	*number = k;
+
+	return OPH_SUBSET_LIB_OK;
+}
+
+int oph_subset_filter_free(oph_subset_filter * filter)
+{
+	if (filter) {
+		if (filter->start) {
+			free(filter->start);
+			filter->start = NULL;
+		}
+		if (filter->end) {
+			free(filter->end);
+			filter->end = NULL;
+		}
+		if (filter->bitmap) {
+			free(filter->bitmap);
+			filter->bitmap = NULL;
+		}
+		filter->number = 0;
+	}
+	return OPH_SUBSET_LIB_OK;
+}
+
 int oph_subset_free(oph_subset * subset)
 {
 	if (subset) {
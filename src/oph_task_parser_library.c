@@ -28,6 +28,7 @@
 #include <ctype.h>
 
 #include <dirent.h>
+#include <unistd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 
@@ -42,6 +43,52 @@
 
 extern int msglevel;
 
+/**
+ * \brief Description of an argument of an operator, as reported in its XML document
+ * \param name Name of the argument
+ * \param type Value of attribute "type" (NULL if not given)
+ * \param mandatory Value of attribute "mandatory" (NULL if not given)
+ * \param default_value Value of attribute "default" (NULL if not given)
+ * \param minvalue Value of attribute "minvalue" (NULL if not given)
+ * \param maxvalue Value of attribute "maxvalue" (NULL if not given)
+ * \param values Value of attribute "values" (NULL if not given)
+ */
+typedef struct {
+	char *name;
+	char *type;
+	char *mandatory;
+	char *default_value;
+	char *minvalue;
+	char *maxvalue;
+	char *values;
+} oph_tp_xml_argument;
+
+/**
+ * \brief Arguments of an operator extracted from a version of its XML document
+ * \param operator_name Name of the operator (upper case)
+ * \param version Version of the XML document
+ * \param latest 1 if the document is the latest version of the operator
+ * \param filename Name of the XML document
+ * \param mtime Modification time of the XML document
+ * \param argument_number Number of arguments
+ * \param arguments Array of arguments
+ * \param next Next operator
+ */
+typedef struct _oph_tp_xml_schema {
+	char *operator_name;
+	char *version;
+	char latest;
+	char *filename;
+	long long mtime;
+	int argument_number;
+	oph_tp_xml_argument *arguments;
+	struct _oph_tp_xml_schema *next;
+} oph_tp_xml_schema;
+
+static oph_tp_xml_schema *oph_tp_schema_cache = NULL;
+static long long oph_tp_schema_cache_mtime = -1;
+static char oph_tp_schema_cache_loaded = 0;
+
 int oph_tp_retrieve_function_xml_file(const char *function_name, const char *function_version, short int function_type_code, char (*xml_filename)[OPH_TP_BUFLEN])
 {
 	DIR *dir;
@@ -450,12 +497,12 @@ int oph_tp_match_value_in_xml_value_list(const char *value, const xmlChar * valu
 	return OPH_TP_TASK_PARSER_ERROR;
 }
 
-int oph_tp_validate_task_string_param(const char *task_string, xmlNodePtr xml_node, const char *param, char *value)
+int oph_tp_validate_task_string_param(const char *task_string, oph_tp_xml_argument * argument, char *value)
 {
-	if (!task_string || !param || !value || !xml_node)
+	if (!task_string || !argument || !argument->name || !value)
 		return OPH_TP_TASK_PARSER_ERROR;
 
-	xmlChar *attribute_type, *attribute_mandatory, *attribute_minvalue, *attribute_maxvalue, *attribute_default, *attribute_values;
+	const char *param = argument->name;
 	char *tmp_value = strdup(task_string);
 	if (!tmp_value) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Memory error\n");
@@ -465,21 +512,16 @@ int oph_tp_validate_task_string_param(const char *task_string, xmlNodePtr xml_no
 	if (oph_tp_find_param_in_task_string(task_string, param, tmp_value)) {
 
 		//Check if the parameter is mandatory
-		attribute_mandatory = xmlGetProp(xml_node, (const xmlChar *) OPH_TP_XML_ATTRIBUTE_MANDATORY);
-		if (attribute_mandatory != NULL && !xmlStrcmp((const xmlChar *) "no", attribute_mandatory)) {
-			xmlFree(attribute_mandatory);
-			attribute_default = xmlGetProp(xml_node, (const xmlChar *) OPH_TP_XML_ATTRIBUTE_DEFAULT);
-			if (attribute_default != NULL) {
-				strncpy(value, (char *) attribute_default, xmlStrlen(attribute_default));
-				value[xmlStrlen(attribute_default)] = 0;
-				xmlFree(attribute_default);
+		if (argument->mandatory != NULL && !strcmp("no", argument->mandatory)) {
+			if (argument->default_value != NULL) {
+				strncpy(value, argument->default_value, strlen(argument->default_value));
+				value[strlen(argument->default_value)] = 0;
 			} else {
 				pmesg(LOG_ERROR, __FILE__, __LINE__, "Default value for param '%s' not given\n", param);
 				free(tmp_value);
 				return OPH_TP_TASK_PARSER_ERROR;
 			}
 		} else {
-			xmlFree(attribute_mandatory);
 			pmesg(LOG_ERROR, __FILE__, __LINE__, "The param '%s' is mandatory\n", param);
 			free(tmp_value);
 			return OPH_TP_TASK_PARSER_ERROR;
@@ -487,19 +529,14 @@ int oph_tp_validate_task_string_param(const char *task_string, xmlNodePtr xml_no
 	} else {
 
 		//Other checks
-		attribute_type = xmlGetProp(xml_node, (const xmlChar *) OPH_TP_XML_ATTRIBUTE_TYPE);
-		if (attribute_type != NULL) {
-			if (!xmlStrcmp(attribute_type, (const xmlChar *) OPH_TP_INT_TYPE)) {
+		if (argument->type != NULL) {
+			if (!strcmp(argument->type, OPH_TP_INT_TYPE)) {
 				int numeric_value = (int) strtol(tmp_value, NULL, 10);
 
-				attribute_minvalue = xmlGetProp(xml_node, (const xmlChar *) OPH_TP_XML_ATTRIBUTE_MINVALUE);
-				attribute_maxvalue = xmlGetProp(xml_node, (const xmlChar *) OPH_TP_XML_ATTRIBUTE_MAXVALUE);
 				int min_value = 0, max_value = 0;
-				if (attribute_minvalue != NULL && attribute_maxvalue != NULL) {
-					min_value = (int) strtol((char *) attribute_minvalue, NULL, 10);
-					max_value = (int) strtol((char *) attribute_maxvalue, NULL, 10);
-					xmlFree(attribute_minvalue);
-					xmlFree(attribute_maxvalue);
+				if (argument->minvalue != NULL && argument->maxvalue != NULL) {
+					min_value = (int) strtol(argument->minvalue, NULL, 10);
+					max_value = (int) strtol(argument->maxvalue, NULL, 10);
 					if (min_value == max_value) {
 						sprintf(tmp_value, "%d", min_value);
 						if (min_value < numeric_value) {
@@ -509,47 +546,37 @@ int oph_tp_validate_task_string_param(const char *task_string, xmlNodePtr xml_no
 					} else {
 						if (numeric_value < min_value) {
 							pmesg(LOG_ERROR, __FILE__, __LINE__, "Param '%s' is smaller than minvalue %d\n", param, min_value);
-							xmlFree(attribute_type);
 							free(tmp_value);
 							return OPH_TP_TASK_PARSER_ERROR;
 						}
 						if (numeric_value > max_value) {
 							pmesg(LOG_ERROR, __FILE__, __LINE__, "Param '%s' is bigger than maxvalue %d\n", param, max_value);
-							xmlFree(attribute_type);
 							free(tmp_value);
 							return OPH_TP_TASK_PARSER_ERROR;
 						}
 					}
-				} else if (attribute_minvalue != NULL) {
-					min_value = (int) strtol((char *) attribute_minvalue, NULL, 10);
-					xmlFree(attribute_minvalue);
+				} else if (argument->minvalue != NULL) {
+					min_value = (int) strtol(argument->minvalue, NULL, 10);
 					if (numeric_value < min_value) {
-						xmlFree(attribute_type);
 						pmesg(LOG_ERROR, __FILE__, __LINE__, "Param '%s' is smaller than minvalue %d\n", param, min_value);
 						free(tmp_value);
 						return OPH_TP_TASK_PARSER_ERROR;
 					}
-				} else if (attribute_maxvalue != NULL) {
-					max_value = (int) strtol((char *) attribute_maxvalue, NULL, 10);
-					xmlFree(attribute_maxvalue);
+				} else if (argument->maxvalue != NULL) {
+					max_value = (int) strtol(argument->maxvalue, NULL, 10);
 					if (numeric_value > max_value) {
-						xmlFree(attribute_type);
 						pmesg(LOG_ERROR, __FILE__, __LINE__, "Param '%s' is bigger than maxvalue %d\n", param, max_value);
 						free(tmp_value);
 						return OPH_TP_TASK_PARSER_ERROR;
 					}
 				}
-			} else if (!xmlStrcmp(attribute_type, (const xmlChar *) OPH_TP_REAL_TYPE)) {
+			} else if (!strcmp(argument->type, OPH_TP_REAL_TYPE)) {
 				double numeric_value = strtod(tmp_value, NULL);
 
-				attribute_minvalue = xmlGetProp(xml_node, (const xmlChar *) OPH_TP_XML_ATTRIBUTE_MINVALUE);
-				attribute_maxvalue = xmlGetProp(xml_node, (const xmlChar *) OPH_TP_XML_ATTRIBUTE_MAXVALUE);
 				double min_value = 0, max_value = 0;
-				if (attribute_minvalue != NULL && attribute_maxvalue != NULL) {
-					min_value = strtod((char *) attribute_minvalue, NULL);
-					max_value = strtod((char *) attribute_maxvalue, NULL);
-					xmlFree(attribute_minvalue);
-					xmlFree(attribute_maxvalue);
+				if (argument->minvalue != NULL && argument->maxvalue != NULL) {
+					min_value = strtod(argument->minvalue, NULL);
+					max_value = strtod(argument->maxvalue, NULL);
 					if (min_value == max_value) {
 						sprintf(tmp_value, "%f", min_value);
 						if (min_value < numeric_value) {
@@ -559,31 +586,25 @@ int oph_tp_validate_task_string_param(const char *task_string, xmlNodePtr xml_no
 					} else {
 						if (numeric_value < min_value) {
 							pmesg(LOG_ERROR, __FILE__, __LINE__, "Param '%s' is smaller than minvalue %f\n", param, min_value);
-							xmlFree(attribute_type);
 							free(tmp_value);
 							return OPH_TP_TASK_PARSER_ERROR;
 						}
 						if (numeric_value > max_value) {
 							pmesg(LOG_ERROR, __FILE__, __LINE__, "Param '%s' is bigger than maxvalue %f\n", param, max_value);
-							xmlFree(attribute_type);
 							free(tmp_value);
 							return OPH_TP_TASK_PARSER_ERROR;
 						}
 					}
-				} else if (attribute_minvalue != NULL) {
-					min_value = strtod((char *) attribute_minvalue, NULL);
-					xmlFree(attribute_minvalue);
+				} else if (argument->minvalue != NULL) {
+					min_value = strtod(argument->minvalue, NULL);
 					if (numeric_value < min_value) {
-						xmlFree(attribute_type);
 						pmesg(LOG_ERROR, __FILE__, __LINE__, "Param '%s' is smaller than minvalue %f\n", param, min_value);
 						free(tmp_value);
 						return OPH_TP_TASK_PARSER_ERROR;
 					}
-				} else if (attribute_maxvalue != NULL) {
-					max_value = strtod((char *) attribute_maxvalue, NULL);
-					xmlFree(attribute_maxvalue);
+				} else if (argument->maxvalue != NULL) {
+					max_value = strtod(argument->maxvalue, NULL);
 					if (numeric_value > max_value) {
-						xmlFree(attribute_type);
 						pmesg(LOG_ERROR, __FILE__, __LINE__, "Param '%s' is bigger than maxvalue %f\n", param, max_value);
 						free(tmp_value);
 						return OPH_TP_TASK_PARSER_ERROR;
@@ -591,8 +612,7 @@ int oph_tp_validate_task_string_param(const char *task_string, xmlNodePtr xml_no
 				}
 			}
 
-			attribute_values = xmlGetProp(xml_node, (const xmlChar *) OPH_TP_XML_ATTRIBUTE_VALUES);
-			if (attribute_values != NULL) {
+			if (argument->values != NULL) {
 				char **values = NULL;
 				int value_number = 0;
 				//If tmp_value is  not multiple-field value, check single value
@@ -600,9 +620,7 @@ int oph_tp_validate_task_string_param(const char *task_string, xmlNodePtr xml_no
 					oph_tp_free_multiple_value_param_list(values, value_number);
 
 					//Check if the value is in the set of specified values
-					if (oph_tp_match_value_in_xml_value_list(tmp_value, attribute_values)) {
-						xmlFree(attribute_type);
-						xmlFree(attribute_values);
+					if (oph_tp_match_value_in_xml_value_list(tmp_value, (const xmlChar *) argument->values)) {
 						pmesg(LOG_ERROR, __FILE__, __LINE__, "Param '%s' value doesn't appear in value list\n", param);
 						free(tmp_value);
 						return OPH_TP_TASK_PARSER_ERROR;
@@ -611,10 +629,8 @@ int oph_tp_validate_task_string_param(const char *task_string, xmlNodePtr xml_no
 					int i = 0;
 					for (i = 0; i < value_number; i++) {
 						//Check if the value is in the set of specified values
-						if (oph_tp_match_value_in_xml_value_list(values[i], attribute_values)) {
+						if (oph_tp_match_value_in_xml_value_list(values[i], (const xmlChar *) argument->values)) {
 							oph_tp_free_multiple_value_param_list(values, value_number);
-							xmlFree(attribute_type);
-							xmlFree(attribute_values);
 							pmesg(LOG_ERROR, __FILE__, __LINE__, "Param '%s' value doesn't appear in value list\n", param);
 							free(tmp_value);
 							return OPH_TP_TASK_PARSER_ERROR;
@@ -622,12 +638,10 @@ int oph_tp_validate_task_string_param(const char *task_string, xmlNodePtr xml_no
 					}
 					oph_tp_free_multiple_value_param_list(values, value_number);
 				}
-				xmlFree(attribute_values);
 			}
 
 			strncpy(value, tmp_value, strlen(tmp_value));
 			value[strlen(tmp_value)] = 0;
-			xmlFree(attribute_type);
 		}
 	}
 
@@ -648,41 +662,89 @@ int oph_tp_end_xml_parser()
 	return 0;
 }
 
-int oph_tp_task_params_parser(char *task_string, HASHTBL ** hashtbl)
+//Get modification time of a file (in nanoseconds)
+static long long _oph_tp_mtime(const char *path)
 {
-	if (!task_string || !hashtbl)
-		return OPH_TP_TASK_PARSER_ERROR;
+	struct stat file_stat;
+	if (stat(path, &file_stat))
+		return -1;
+	return (long long) file_stat.st_mtim.tv_sec * 1000000000LL + file_stat.st_mtim.tv_nsec;
+}
 
-	//Check if string has correct format
-	if (oph_tp_validate_task_string(task_string)) {
-		pmesg(LOG_ERROR, __FILE__, __LINE__, "Submission string is not valid!\n");
-		return OPH_TP_TASK_PARSER_ERROR;
+static void _oph_tp_free_schema(oph_tp_xml_schema * schema)
+{
+	if (!schema)
+		return;
+	int i;
+	if (schema->arguments) {
+		for (i = 0; i < schema->argument_number; i++) {
+			if (schema->arguments[i].name)
+				free(schema->arguments[i].name);
+			if (schema->arguments[i].type)
+				free(schema->arguments[i].type);
+			if (schema->arguments[i].mandatory)
+				free(schema->arguments[i].mandatory);
+			if (schema->arguments[i].default_value)
+				free(schema->arguments[i].default_value);
+			if (schema->arguments[i].minvalue)
+				free(schema->arguments[i].minvalue);
+			if (schema->arguments[i].maxvalue)
+				free(schema->arguments[i].maxvalue);
+			if (schema->arguments[i].values)
+				free(schema->arguments[i].values);
+		}
+		free(schema->arguments);
 	}
+	if (schema->operator_name)
+		free(schema->operator_name);
+	if (schema->version)
+		free(schema->version);
+	if (schema->filename)
+		free(schema->filename);
+	free(schema);
+}
 
-	char *op, operator[OPH_TP_TASKLEN] = { '\0' };
-
-	//Find operator name in task string
-	if (oph_tp_find_param_in_task_string(task_string, OPH_IN_PARAM_OPERATOR_NAME, operator)) {
-		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to find operator name in the string\n");
-		return OPH_TP_TASK_PARSER_ERROR;
+int oph_tp_clear_cache()
+{
+	oph_tp_xml_schema *schema;
+	while ((schema = oph_tp_schema_cache)) {
+		oph_tp_schema_cache = schema->next;
+		_oph_tp_free_schema(schema);
 	}
+	oph_tp_schema_cache_loaded = 0;
+	oph_tp_schema_cache_mtime = -1;
+
+	return OPH_TP_TASK_PARSER_SUCCESS;
+}
+
+//Copy an XML attribute into a string allocated with malloc
+static int _oph_tp_get_prop(xmlNodePtr node, const char *name, char **value)
+{
+	xmlChar *prop = xmlGetProp(node, (const xmlChar *) name);
+	*value = NULL;
+	if (!prop)
+		return OPH_TP_TASK_PARSER_SUCCESS;
+	*value = strdup((char *) prop);
+	xmlFree(prop);
+	return *value ? OPH_TP_TASK_PARSER_SUCCESS : OPH_TP_TASK_PARSER_ERROR;
+}
 
+//Extract the version from the name of the XML document of an operator
+static char *_oph_tp_get_version(const char *operator_name, const char *filename)
+{
+	size_t prefix = strlen(operator_name) + strlen(OPH_TP_XML_OPERATOR_TYPE) + 2, suffix = strlen(OPH_TP_VERSION_EXTENSION), length = strlen(filename);
+	if (length < prefix + suffix)
+		return NULL;
+	return strndup(filename + prefix, length - prefix - suffix);
+}
+
+//Parse and validate the XML document of an operator and extract the description of its arguments
+static int _oph_tp_load_schema(const char *operator_name, const char *filename, const char *path_file, oph_tp_xml_schema ** schema)
+{
 	xmlDocPtr document;
 	xmlNodePtr root, node, subnode;
 
-	//Select the correct XML file
-	char path_file[OPH_TP_XML_PATH_LENGTH] = { '\0' };
-	char filename[OPH_TP_XML_PATH_LENGTH] = { '\0' };
-	char operator_name[OPH_TP_TASKLEN] = { '\0' };
-	strcpy(operator_name, operator);
-	for (op = operator_name; op && (*op != '\0'); op++)
-		*op = toupper((unsigned char) *op);
-
-	if (oph_tp_retrieve_function_xml_file((const char *) operator_name, NULL, OPH_TP_XML_OPERATOR_TYPE_CODE, &filename)) {
-		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to find xml\n");
-		return OPH_TP_TASK_PARSER_ERROR;
-	}
-	snprintf(path_file, sizeof(path_file), OPH_TP_XML_OPERATOR_FILE, OPH_ANALYTICS_LOCATION, filename);
+	*schema = NULL;
 
 	//Open document
 	document = xmlParseFile(path_file);
@@ -704,50 +766,54 @@ int oph_tp_task_params_parser(char *task_string, HASHTBL ** hashtbl)
 		return OPH_TP_TASK_PARSER_ERROR;
 	}
 
-	xmlChar *content;
+	oph_tp_xml_schema *new_schema = (oph_tp_xml_schema *) calloc(1, sizeof(oph_tp_xml_schema));
+	if (!new_schema || !(new_schema->operator_name = strdup(operator_name)) || !(new_schema->version = _oph_tp_get_version(operator_name, filename))
+	    || !(new_schema->filename = strdup(filename))) {
+		_oph_tp_free_schema(new_schema);
+		xmlFreeDoc(document);
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Memory error\n");
+		return OPH_TP_TASK_PARSER_ERROR;
+	}
+	new_schema->mtime = _oph_tp_mtime(path_file);
 
 	//Parse till args section
-	long number_arguments = 0;
-	char *value1 = NULL;
+	xmlChar *content;
 	node = root->children;
 	while (node != NULL) {
 		if (!xmlStrcmp(node->name, (const xmlChar *) OPH_TP_XML_ARGS)) {
 			//Count number of elements
-			number_arguments = xmlChildElementCount(node);
-
-			if (!(*hashtbl = hashtbl_create(number_arguments + 1, NULL))) {
+			long number_arguments = xmlChildElementCount(node);
+			if (number_arguments && !(new_schema->arguments = (oph_tp_xml_argument *) calloc(number_arguments, sizeof(oph_tp_xml_argument)))) {
+				_oph_tp_free_schema(new_schema);
 				xmlFreeDoc(document);
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to create hash table\n");
+				pmesg(LOG_ERROR, __FILE__, __LINE__, "Memory error\n");
 				return OPH_TP_TASK_PARSER_ERROR;
 			}
 			//For each argument read content and attributes
 			subnode = node->xmlChildrenNode;
-			while (subnode != NULL) {
+			while (subnode != NULL && new_schema->argument_number < number_arguments) {
 				if ((!xmlStrcmp(subnode->name, (const xmlChar *) OPH_TP_XML_ARGUMENT))) {
 					//Look for param names (xml content)
 					content = xmlNodeGetContent(subnode->xmlChildrenNode);
 					if (content) {
-						value1 = strdup(task_string);
-						if (!value1) {
-							xmlFree(content);
-							xmlFreeDoc(document);
-							return OPH_TP_TASK_PARSER_ERROR;
-						}
-						//Get and check value for parameter
-						if (oph_tp_validate_task_string_param(task_string, subnode, (char *) content, value1)) {
-							xmlFree(content);
+						oph_tp_xml_argument *argument = new_schema->arguments + new_schema->argument_number++;
+						argument->name = strdup((char *) content);
+						xmlFree(content);
+						if (!argument->name || _oph_tp_get_prop(subnode, OPH_TP_XML_ATTRIBUTE_TYPE, &argument->type)
+						    || _oph_tp_get_prop(subnode, OPH_TP_XML_ATTRIBUTE_MANDATORY, &argument->mandatory)
+						    || _oph_tp_get_prop(subnode, OPH_TP_XML_ATTRIBUTE_DEFAULT, &argument->default_value)
+						    || _oph_tp_get_prop(subnode, OPH_TP_XML_ATTRIBUTE_MINVALUE, &argument->minvalue)
+						    || _oph_tp_get_prop(subnode, OPH_TP_XML_ATTRIBUTE_MAXVALUE, &argument->maxvalue)
+						    || _oph_tp_get_prop(subnode, OPH_TP_XML_ATTRIBUTE_VALUES, &argument->values)) {
+							_oph_tp_free_schema(new_schema);
 							xmlFreeDoc(document);
-							free(value1);
+							pmesg(LOG_ERROR, __FILE__, __LINE__, "Memory error\n");
 							return OPH_TP_TASK_PARSER_ERROR;
 						}
-						hashtbl_insert(*hashtbl, (char *) content, (void *) value1);
-						free(value1);
-						xmlFree(content);
 					}
 				}
 				subnode = subnode->next;
 			}
-			hashtbl_insert(*hashtbl, OPH_IN_PARAM_OPERATOR_NAME, (void *) operator);
 			break;
 		}
 		node = node->next;
@@ -755,9 +821,262 @@ int oph_tp_task_params_parser(char *task_string, HASHTBL ** hashtbl)
 	// free up the parser context
 	xmlFreeDoc(document);
 
+	*schema = new_schema;
+
 	return OPH_TP_TASK_PARSER_SUCCESS;
 }
 
+static int _oph_tp_write_string(FILE * fp, const char *string)
+{
+	int length = string ? (int) strlen(string) : -1;
+	if (fwrite(&length, sizeof(int), 1, fp) != 1)
+		return OPH_TP_TASK_PARSER_ERROR;
+	if ((length > 0) && (fwrite(string, 1, length, fp) != (size_t) length))
+		return OPH_TP_TASK_PARSER_ERROR;
+	return OPH_TP_TASK_PARSER_SUCCESS;
+}
+
+static int _oph_tp_read_string(FILE * fp, char **string)
+{
+	int length;
+	*string = NULL;
+	if ((fread(&length, sizeof(int), 1, fp) != 1) || (length > OPH_TP_XML_CACHE_MAX_STRING))
+		return OPH_TP_TASK_PARSER_ERROR;
+	if (length < 0)
+		return OPH_TP_TASK_PARSER_SUCCESS;
+	if (!(*string = (char *) malloc(length + 1)))
+		return OPH_TP_TASK_PARSER_ERROR;
+	if (length && (fread(*string, 1, length, fp) != (size_t) length)) {
+		free(*string);
+		*string = NULL;
+		return OPH_TP_TASK_PARSER_ERROR;
+	}
+	(*string)[length] = 0;
+	return OPH_TP_TASK_PARSER_SUCCESS;
+}
+
+//Load the index saved by previous processes; it is discarded in case the XML folder has been changed
+static int _oph_tp_load_cache_file(long long folder_mtime)
+{
+	char cache_file[OPH_TP_XML_PATH_LENGTH];
+	snprintf(cache_file, sizeof(cache_file), OPH_TP_XML_CACHE_FILE, OPH_ANALYTICS_LOCATION);
+	FILE *fp = fopen(cache_file, "r");
+	if (!fp)
+		return OPH_TP_TASK_PARSER_ERROR;
+
+	char magic[sizeof(OPH_TP_XML_CACHE_MAGIC)];
+	long long mtime;
+	int i, schema_number;
+	if ((fread(magic, 1, sizeof(magic), fp) != sizeof(magic)) || memcmp(magic, OPH_TP_XML_CACHE_MAGIC, sizeof(magic)) || (fread(&mtime, sizeof(long long), 1, fp) != 1) || (mtime != folder_mtime)
+	    || (fread(&schema_number, sizeof(int), 1, fp) != 1)) {
+		fclose(fp);
+		return OPH_TP_TASK_PARSER_ERROR;
+	}
+
+	oph_tp_xml_schema *schema;
+	for (i = 0; i < schema_number; i++) {
+		if (!(schema = (oph_tp_xml_schema *) calloc(1, sizeof(oph_tp_xml_schema))))
+			break;
+		if (_oph_tp_read_string(fp, &schema->operator_name) || _oph_tp_read_string(fp, &schema->version) || (fread(&schema->latest, sizeof(char), 1, fp) != 1)
+		    || _oph_tp_read_string(fp, &schema->filename) || !schema->operator_name || !schema->version || !schema->filename || (fread(&schema->mtime, sizeof(long long), 1, fp) != 1) || (fread(&schema->argument_number, sizeof(int), 1, fp) != 1) || (schema->argument_number < 0)
+		    || (schema->argument_number > OPH_TP_XML_CACHE_MAX_STRING)) {
+			schema->argument_number = 0;
+			_oph_tp_free_schema(schema);
+			break;
+		}
+		if (schema->argument_number && !(schema->arguments = (oph_tp_xml_argument *) calloc(schema->argument_number, sizeof(oph_tp_xml_argument)))) {
+			schema->argument_number = 0;
+			_oph_tp_free_schema(schema);
+			break;
+		}
+		int j;
+		for (j = 0; j < schema->argument_number; j++) {
+			oph_tp_xml_argument *argument = schema->arguments + j;
+			if (_oph_tp_read_string(fp, &argument->name) || !argument->name || _oph_tp_read_string(fp, &argument->type) || _oph_tp_read_string(fp, &argument->mandatory)
+			    || _oph_tp_read_string(fp, &argument->default_value) || _oph_tp_read_string(fp, &argument->minvalue) || _oph_tp_read_string(fp, &argument->maxvalue)
+			    || _oph_tp_read_string(fp, &argument->values))
+				break;
+		}
+		if (j < schema->argument_number) {
+			_oph_tp_free_schema(schema);
+			break;
+		}
+		schema->next = oph_tp_schema_cache;
+		oph_tp_schema_cache = schema;
+	}
+	fclose(fp);
+
+	if (i < schema_number) {
+		pmesg(LOG_WARNING, __FILE__, __LINE__, "Cache of XML documents is corrupted: it will be rebuilt\n");
+		oph_tp_clear_cache();
+		return OPH_TP_TASK_PARSER_ERROR;
+	}
+
+	return OPH_TP_TASK_PARSER_SUCCESS;
+}
+
+//Save the index into a temporary file, then replace the old one atomically
+static int _oph_tp_save_cache_file(long long folder_mtime)
+{
+	char cache_file[OPH_TP_XML_PATH_LENGTH], tmp_file[OPH_TP_XML_PATH_LENGTH];
+	snprintf(cache_file, sizeof(cache_file), OPH_TP_XML_CACHE_FILE, OPH_ANALYTICS_LOCATION);
+	snprintf(tmp_file, sizeof(tmp_file), "%s.XXXXXX", cache_file);
+	int fd = mkstemp(tmp_file);
+	if (fd < 0) {
+		pmesg(LOG_DEBUG, __FILE__, __LINE__, "Unable to save cache of XML documents in %s\n", cache_file);
+		return OPH_TP_TASK_PARSER_ERROR;
+	}
+	//The cache is read by the processes of other users too
+	fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+	FILE *fp = fdopen(fd, "w");
+	if (!fp) {
+		pmesg(LOG_DEBUG, __FILE__, __LINE__, "Unable to save cache of XML documents in %s\n", cache_file);
+		close(fd);
+		unlink(tmp_file);
+		return OPH_TP_TASK_PARSER_ERROR;
+	}
+
+	oph_tp_xml_schema *schema;
+	int i, schema_number = 0, res = 0;
+	for (schema = oph_tp_schema_cache; schema; schema = schema->next)
+		schema_number++;
+
+	res = (fwrite(OPH_TP_XML_CACHE_MAGIC, 1, sizeof(OPH_TP_XML_CACHE_MAGIC), fp) != sizeof(OPH_TP_XML_CACHE_MAGIC)) || (fwrite(&folder_mtime, sizeof(long long), 1, fp) != 1)
+	    || (fwrite(&schema_number, sizeof(int), 1, fp) != 1);
+	for (schema = oph_tp_schema_cache; schema && !res; schema = schema->next) {
+		res = _oph_tp_write_string(fp, schema->operator_name) || _oph_tp_write_string(fp, schema->version) || (fwrite(&schema->latest, sizeof(char), 1, fp) != 1)
+		    || _oph_tp_write_string(fp, schema->filename) || (fwrite(&schema->mtime, sizeof(long long), 1, fp) != 1)
+		    || (fwrite(&schema->argument_number, sizeof(int), 1, fp) != 1);
+		for (i = 0; (i < schema->argument_number) && !res; i++) {
+			oph_tp_xml_argument *argument = schema->arguments + i;
+			res = _oph_tp_write_string(fp, argument->name) || _oph_tp_write_string(fp, argument->type) || _oph_tp_write_string(fp, argument->mandatory)
+			    || _oph_tp_write_string(fp, argument->default_value) || _oph_tp_write_string(fp, argument->minvalue) || _oph_tp_write_string(fp, argument->maxvalue)
+			    || _oph_tp_write_string(fp, argument->values);
+		}
+	}
+	if (fclose(fp))
+		res = 1;
+
+	if (res || rename(tmp_file, cache_file)) {
+		pmesg(LOG_DEBUG, __FILE__, __LINE__, "Unable to save cache of XML documents in %s\n", cache_file);
+		unlink(tmp_file);
+		return OPH_TP_TASK_PARSER_ERROR;
+	}
+
+	return OPH_TP_TASK_PARSER_SUCCESS;
+}
+
+//Get the description of operator arguments from the cache, or load it from the XML document of the given version (the latest one if version is NULL)
+static int _oph_tp_get_schema(const char *operator_name, const char *version, oph_tp_xml_schema ** schema)
+{
+	char folder[OPH_TP_XML_PATH_LENGTH];
+	char path_file[OPH_TP_XML_PATH_LENGTH] = { '\0' };
+	char filename[OPH_TP_XML_PATH_LENGTH] = { '\0' };
+
+	*schema = NULL;
+
+	//Files added or removed change the modification time of the folder and the latest versions of the documents
+	snprintf(folder, sizeof(folder), OPH_FRAMEWORK_OPERATOR_XML_FOLDER_PATH, OPH_ANALYTICS_LOCATION);
+	long long folder_mtime = _oph_tp_mtime(folder);
+	if (!oph_tp_schema_cache_loaded || (folder_mtime != oph_tp_schema_cache_mtime)) {
+		oph_tp_clear_cache();
+		if (folder_mtime >= 0)
+			_oph_tp_load_cache_file(folder_mtime);
+		oph_tp_schema_cache_loaded = 1;
+		oph_tp_schema_cache_mtime = folder_mtime;
+	}
+
+	oph_tp_xml_schema *current, *prev = NULL;
+	for (current = oph_tp_schema_cache; current; prev = current, current = current->next)
+		if (!strcmp(current->operator_name, operator_name) && (version ? !strcmp(current->version, version) : current->latest))
+			break;
+	if (current) {
+		snprintf(path_file, sizeof(path_file), OPH_TP_XML_OPERATOR_FILE, OPH_ANALYTICS_LOCATION, current->filename);
+		if ((current->mtime >= 0) && (_oph_tp_mtime(path_file) == current->mtime)) {
+			*schema = current;
+			return OPH_TP_TASK_PARSER_SUCCESS;
+		}
+		//The document has been changed
+		if (prev)
+			prev->next = current->next;
+		else
+			oph_tp_schema_cache = current->next;
+		_oph_tp_free_schema(current);
+	}
+
+	if (oph_tp_retrieve_function_xml_file(operator_name, version, OPH_TP_XML_OPERATOR_TYPE_CODE, &filename)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to find xml\n");
+		return OPH_TP_TASK_PARSER_ERROR;
+	}
+	snprintf(path_file, sizeof(path_file), OPH_TP_XML_OPERATOR_FILE, OPH_ANALYTICS_LOCATION, filename);
+
+	if (_oph_tp_load_schema(operator_name, filename, path_file, &current))
+		return OPH_TP_TASK_PARSER_ERROR;
+	current->latest = !version;
+	current->next = oph_tp_schema_cache;
+	oph_tp_schema_cache = current;
+
+	if (folder_mtime >= 0)
+		_oph_tp_save_cache_file(folder_mtime);
+
+	*schema = current;
+
+	return OPH_TP_TASK_PARSER_SUCCESS;
+}
+
+int oph_tp_task_params_parser(char *task_string, HASHTBL ** hashtbl)
+{
+	if (!task_string || !hashtbl)
+		return OPH_TP_TASK_PARSER_ERROR;
+
+	//Check if string has correct format
+	if (oph_tp_validate_task_string(task_string)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Submission string is not valid!\n");
+		return OPH_TP_TASK_PARSER_ERROR;
+	}
+
+	char *op, operator[OPH_TP_TASKLEN] = { '\0' };
+
+	//Find operator name in task string
+	if (oph_tp_find_param_in_task_string(task_string, OPH_IN_PARAM_OPERATOR_NAME, operator)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to find operator name in the string\n");
+		return OPH_TP_TASK_PARSER_ERROR;
+	}
+
+	//Select the correct XML file
+	char operator_name[OPH_TP_TASKLEN] = { '\0' };
+	strcpy(operator_name, operator);
+	for (op = operator_name; op && (*op != '\0'); op++)
+		*op = toupper((unsigned char) *op);
+
+	oph_tp_xml_schema *schema = NULL;
+	if (_oph_tp_get_schema(operator_name, NULL, &schema))
+		return OPH_TP_TASK_PARSER_ERROR;
+
+	if (!(*hashtbl = hashtbl_create(schema->argument_number + 1, NULL))) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to create hash table\n");
+		return OPH_TP_TASK_PARSER_ERROR;
+	}
+	//For each argument get and check the value
+	int i;
+	char *value1 = NULL;
+	for (i = 0; i < schema->argument_number; i++) {
+		value1 = strdup(task_string);
+		if (!value1)
+			return OPH_TP_TASK_PARSER_ERROR;
+		if (oph_tp_validate_task_string_param(task_string, schema->arguments + i, value1)) {
+			free(value1);
+			return OPH_TP_TASK_PARSER_ERROR;
+		}
+		hashtbl_insert(*hashtbl, schema->arguments[i].name, (void *) value1);
+		free(value1);
+	}
+	hashtbl_insert(*hashtbl, OPH_IN_PARAM_OPERATOR_NAME, (void *) operator);
+
+	return OPH_TP_TASK_PARSER_SUCCESS;
+}
+
+
 int oph_tp_parse_multiple_value_param(char *values, char ***value_list, int *value_num)
 {
 	if (!values || !value_list || !value_num)
@@ -0,0 +1,276 @@
+/*
+    Ophidia Analytics Framework
+    Copyright (C) 2012-2024 CMCC Foundation
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#define _GNU_SOURCE
+
+#include "oph_trace_library.h"
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+
+#include "debug.h"
+
+extern int msglevel;
+
+static pthread_mutex_t oph_trace_lock = PTHREAD_MUTEX_INITIALIZER;
+static char oph_trace_enabled = 0;
+static int oph_trace_rank = 0;
+static char *oph_trace_path = NULL;
+static char *oph_trace_buffer = NULL;
+static size_t oph_trace_length = 0;
+static size_t oph_trace_capacity = 0;
+static unsigned long long oph_trace_dropped = 0;
+
+static double _oph_trace_now()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_REALTIME, &now);
+	return now.tv_sec * 1000000.0 + now.tv_nsec / 1000.0;
+}
+
+//64-bit FNV-1a hash, used to group spans of the same query without saving its text
+static unsigned long long _oph_trace_hash(const char *string)
+{
+	unsigned long long hash = 14695981039346656037ULL;
+	for (; *string; string++) {
+		hash ^= (unsigned char) *string;
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+//Copy a string into a JSON string value
+static void _oph_trace_escape(char *out, size_t size, const char *in)
+{
+	size_t i = 0;
+	for (; in && *in && (i + 2 < size); in++) {
+		if ((*in == '"') || (*in == '\\'))
+			out[i++] = '\\';
+		out[i++] = ((unsigned char) *in < 0x20) ? ' ' : *in;
+	}
+	out[i] = 0;
+}
+
+static int _oph_trace_append(const char *event, size_t length)
+{
+	if (oph_trace_length + length > oph_trace_capacity) {
+		if (oph_trace_length + length > OPH_TRACE_MAX_BUFFER) {
+			oph_trace_dropped++;
+			return OPH_TRACE_MEMORY_ERROR;
+		}
+		size_t capacity = oph_trace_capacity ? 2 * oph_trace_capacity : OPH_TRACE_MIN_BUFFER;
+		while (capacity < oph_trace_length + length)
+			capacity *= 2;
+		if (capacity > OPH_TRACE_MAX_BUFFER)
+			capacity = OPH_TRACE_MAX_BUFFER;
+		char *buffer = (char *) realloc(oph_trace_buffer, capacity);
+		if (!buffer) {
+			oph_trace_dropped++;
+			return OPH_TRACE_MEMORY_ERROR;
+		}
+		oph_trace_buffer = buffer;
+		oph_trace_capacity = capacity;
+	}
+	memcpy(oph_trace_buffer + oph_trace_length, event, length);
+	oph_trace_length += length;
+
+	return OPH_TRACE_SUCCESS;
+}
+
+int oph_trace_init(MPI_Comm comm)
+{
+	oph_trace_free();
+
+	MPI_Comm_rank(comm, &oph_trace_rank);
+
+	char enabled = 0;
+	if (!oph_trace_rank) {
+		const char *value = getenv(OPH_TRACE_ENV);
+		if (oph_trace_path) {
+			free(oph_trace_path);
+			oph_trace_path = NULL;
+		}
+		if (value && *value && strcmp(value, "0")) {
+			enabled = 1;
+			if (strcmp(value, OPH_TRACE_ENV_DEFAULT))
+				oph_trace_path = strdup(value);
+		}
+	}
+	if (MPI_Bcast(&enabled, 1, MPI_CHAR, 0, comm) != MPI_SUCCESS) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to broadcast tracing flag\n");
+		oph_trace_enabled = 0;
+		return OPH_TRACE_MPI_ERROR;
+	}
+	oph_trace_enabled = enabled;
+
+	return OPH_TRACE_SUCCESS;
+}
+
+char oph_trace_is_enabled()
+{
+	return oph_trace_enabled;
+}
+
+const char *oph_trace_get_path()
+{
+	return oph_trace_path;
+}
+
+void oph_trace_begin(oph_trace_span * span)
+{
+	if (span)
+		span->start = oph_trace_enabled ? _oph_trace_now() : 0.0;
+}
+
+void oph_trace_end(oph_trace_span * span, const char *category, const char *name, oph_trace_args * args)
+{
+	if (!oph_trace_enabled || !span || !span->start || !name)
+		return;
+
+	double end = _oph_trace_now();
+	char event[OPH_TRACE_EVENT_LEN], attributes[OPH_TRACE_EVENT_LEN], escaped[OPH_TRACE_EVENT_LEN / 4];
+	int n = 0;
+
+	*attributes = 0;
+	if (args) {
+		if (args->fragment_id >= 0)
+			n += snprintf(attributes + n, OPH_TRACE_EVENT_LEN - n, ",\"fragment\":%lld", args->fragment_id);
+		if (args->host && (n < OPH_TRACE_EVENT_LEN)) {
+			_oph_trace_escape(escaped, sizeof(escaped), args->host);
+			n += snprintf(attributes + n, OPH_TRACE_EVENT_LEN - n, ",\"host\":\"%s\"", escaped);
+		}
+		if (args->query && (n < OPH_TRACE_EVENT_LEN))
+			n += snprintf(attributes + n, OPH_TRACE_EVENT_LEN - n, ",\"query_hash\":\"%016llx\"", _oph_trace_hash(args->query));
+		if ((args->rows >= 0) && (n < OPH_TRACE_EVENT_LEN))
+			n += snprintf(attributes + n, OPH_TRACE_EVENT_LEN - n, ",\"rows\":%lld", args->rows);
+		if ((args->bytes >= 0) && (n < OPH_TRACE_EVENT_LEN))
+			n += snprintf(attributes + n, OPH_TRACE_EVENT_LEN - n, ",\"bytes\":%lld", args->bytes);
+		if (n >= OPH_TRACE_EVENT_LEN)
+			*attributes = 0;
+	}
+
+	_oph_trace_escape(escaped, sizeof(escaped), name);
+	n = snprintf(event, OPH_TRACE_EVENT_LEN, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%ld,\"args\":{\"rank\":%d%s}}", escaped,
+		     category ? category : "", span->start, end - span->start, oph_trace_rank, (long) syscall(SYS_gettid), oph_trace_rank, attributes);
+	if ((n <= 0) || (n >= OPH_TRACE_EVENT_LEN))
+		return;
+
+	pthread_mutex_lock(&oph_trace_lock);
+	_oph_trace_append(event, n);
+	pthread_mutex_unlock(&oph_trace_lock);
+}
+
+int oph_trace_write(const char *filename, MPI_Comm comm)
+{
+	if (!oph_trace_enabled)
+		return OPH_TRACE_SUCCESS;
+
+	int i, rank = 0, size = 1, length = (int) oph_trace_length;
+	MPI_Comm_rank(comm, &rank);
+	MPI_Comm_size(comm, &size);
+
+	if (oph_trace_dropped)
+		pmesg(LOG_WARNING, __FILE__, __LINE__, "%llu trace events have been dropped\n", oph_trace_dropped);
+
+	int *lengths = NULL, *displs = NULL;
+	char *events = NULL;
+	if (!rank) {
+		lengths = (int *) calloc(size, sizeof(int));
+		displs = (int *) calloc(size, sizeof(int));
+		if (!lengths || !displs) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Error allocating memory\n");
+			size = 0;
+		}
+	}
+	//Every process has to be notified in case of errors before exchanging data
+	if (MPI_Bcast(&size, 1, MPI_INT, 0, comm) != MPI_SUCCESS || !size) {
+		if (lengths)
+			free(lengths);
+		if (displs)
+			free(displs);
+		oph_trace_free();
+		return OPH_TRACE_MEMORY_ERROR;
+	}
+	MPI_Gather(&length, 1, MPI_INT, lengths, 1, MPI_INT, 0, comm);
+
+	long long total = 0;
+	if (!rank) {
+		for (i = 0; i < size; i++) {
+			displs[i] = (int) total;
+			total += lengths[i];
+		}
+		if ((total > OPH_TRACE_MAX_BUFFER * 4LL) || !(events = (char *) malloc(total + 1))) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Error allocating memory\n");
+			total = -1;
+		}
+	}
+	MPI_Bcast(&total, 1, MPI_LONG_LONG, 0, comm);
+	if (total < 0) {
+		free(lengths);
+		free(displs);
+		oph_trace_free();
+		return OPH_TRACE_MEMORY_ERROR;
+	}
+	MPI_Gatherv(oph_trace_buffer, length, MPI_CHAR, events, lengths, displs, MPI_CHAR, 0, comm);
+	oph_trace_free();
+
+	int res = OPH_TRACE_SUCCESS;
+	if (!rank) {
+		FILE *fp = filename ? fopen(filename, "w") : NULL;
+		if (fp) {
+			//Metadata events are used to name processes after the ranks, so that every event can be preceded by a comma
+			fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+			for (i = 0; i < size; i++)
+				fprintf(fp, "%s{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"Rank %d\"}}", i ? ",\n" : "", i, i);
+			if (total && (fwrite(events, 1, total, fp) != (size_t) total))
+				res = OPH_TRACE_IO_ERROR;
+			fprintf(fp, "\n]}\n");
+			if (fclose(fp))
+				res = OPH_TRACE_IO_ERROR;
+		} else
+			res = OPH_TRACE_IO_ERROR;
+		if (res)
+			pmesg(LOG_WARNING, __FILE__, __LINE__, "Unable to save trace file '%s'\n", filename ? filename : "");
+		else
+			pmesg(LOG_DEBUG, __FILE__, __LINE__, "Trace saved in '%s'\n", filename);
+		free(events);
+		free(lengths);
+		free(displs);
+	}
+
+	return res;
+}
+
+int oph_trace_free()
+{
+	pthread_mutex_lock(&oph_trace_lock);
+	if (oph_trace_buffer) {
+		free(oph_trace_buffer);
+		oph_trace_buffer = NULL;
+	}
+	oph_trace_length = oph_trace_capacity = 0;
+	oph_trace_dropped = 0;
+	pthread_mutex_unlock(&oph_trace_lock);
+
+	return OPH_TRACE_SUCCESS;
+}
@@ -0,0 +1,290 @@
+/*
+    Ophidia Analytics Framework
+    Copyright (C) 2012-2024 CMCC Foundation
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#define _GNU_SOURCE
+#include "oph_odb_cache_library.h"
+
+/* Standard C99 headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <pthread.h>
+
+#include "debug.h"
+
+extern int msglevel;
+
+/**
+ * \brief Object read from OphidiaDB
+ * \param type Type of the object
+ * \param id Id of the object
+ * \param id_datacube Id of the datacube the object has been read for
+ * \param size Size of the object
+ * \param next Next object in the same bucket
+ * \param data Serialized object
+ */
+typedef struct _oph_odb_cache_entry {
+	int type;
+	int id;
+	int id_datacube;
+	size_t size;
+	struct _oph_odb_cache_entry *next;
+	char data[];
+} oph_odb_cache_entry;
+
+/**
+ * \brief Header of an object sent by oph_odb_cache_bcast
+ */
+typedef struct {
+	int type;
+	int id;
+	int id_datacube;
+	size_t size;
+} oph_odb_cache_header;
+
+static pthread_mutex_t oph_odb_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static oph_odb_cache_entry *oph_odb_cache_buckets[OPH_ODB_CACHE_BUCKETS];
+static char oph_odb_cache_enabled = -1;
+
+//Call it with oph_odb_cache_lock held
+static int _oph_odb_cache_is_enabled()
+{
+	if (oph_odb_cache_enabled < 0) {
+		char *value = getenv(OPH_ODB_CACHE_ENV);
+		oph_odb_cache_enabled = value && (!strcasecmp(value, "no") || !strcmp(value, "0")) ? 0 : 1;
+	}
+	return oph_odb_cache_enabled;
+}
+
+static unsigned int _oph_odb_cache_bucket(int type, int id, int id_datacube)
+{
+	return ((unsigned int) id * 31U + (unsigned int) id_datacube * 7U + (unsigned int) type) % OPH_ODB_CACHE_BUCKETS;
+}
+
+//Call it with oph_odb_cache_lock held
+static oph_odb_cache_entry *_oph_odb_cache_find(int type, int id, int id_datacube)
+{
+	oph_odb_cache_entry *entry;
+	for (entry = oph_odb_cache_buckets[_oph_odb_cache_bucket(type, id, id_datacube)]; entry; entry = entry->next)
+		if ((entry->type == (int) type) && (entry->id == id) && (entry->id_datacube == id_datacube))
+			return entry;
+	return NULL;
+}
+
+//Call it with oph_odb_cache_lock held
+static int _oph_odb_cache_put(int type, int id, int id_datacube, const void *data, size_t size)
+{
+	oph_odb_cache_entry *entry, *prev = NULL, *new_entry;
+	unsigned int bucket = _oph_odb_cache_bucket(type, id, id_datacube);
+
+	if (!(new_entry = (oph_odb_cache_entry *) malloc(sizeof(oph_odb_cache_entry) + size))) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Error allocating memory\n");
+		return OPH_ODB_MEMORY_ERROR;
+	}
+	new_entry->type = type;
+	new_entry->id = id;
+	new_entry->id_datacube = id_datacube;
+	new_entry->size = size;
+	if (size)
+		memcpy(new_entry->data, data, size);
+
+	//Replace the old version of the object, if any
+	for (entry = oph_odb_cache_buckets[bucket]; entry; prev = entry, entry = entry->next)
+		if ((entry->type == type) && (entry->id == id) && (entry->id_datacube == id_datacube)) {
+			if (prev)
+				prev->next = entry->next;
+			else
+				oph_odb_cache_buckets[bucket] = entry->next;
+			free(entry);
+			break;
+		}
+	new_entry->next = oph_odb_cache_buckets[bucket];
+	oph_odb_cache_buckets[bucket] = new_entry;
+
+	return OPH_ODB_SUCCESS;
+}
+
+//Call it with oph_odb_cache_lock held
+static void _oph_odb_cache_clear()
+{
+	int i;
+	oph_odb_cache_entry *entry;
+	for (i = 0; i < OPH_ODB_CACHE_BUCKETS; i++)
+		while ((entry = oph_odb_cache_buckets[i])) {
+			oph_odb_cache_buckets[i] = entry->next;
+			free(entry);
+		}
+}
+
+int oph_odb_cache_get(oph_odb_cache_type type, int id, int id_datacube, void *data, size_t size)
+{
+	if (!data)
+		return OPH_ODB_NULL_PARAM;
+
+	int res = OPH_ODB_NO_ROW_FOUND;
+	oph_odb_cache_entry *entry;
+
+	pthread_mutex_lock(&oph_odb_cache_lock);
+	if (_oph_odb_cache_is_enabled() && (entry = _oph_odb_cache_find(type, id, id_datacube)) && (entry->size == size)) {
+		memcpy(data, entry->data, size);
+		res = OPH_ODB_SUCCESS;
+	}
+	pthread_mutex_unlock(&oph_odb_cache_lock);
+
+	return res;
+}
+
+int oph_odb_cache_get_alloc(oph_odb_cache_type type, int id, int id_datacube, char **data, size_t *size)
+{
+	if (!data || !size)
+		return OPH_ODB_NULL_PARAM;
+	*data = NULL;
+	*size = 0;
+
+	int res = OPH_ODB_NO_ROW_FOUND;
+	oph_odb_cache_entry *entry;
+
+	pthread_mutex_lock(&oph_odb_cache_lock);
+	if (_oph_odb_cache_is_enabled() && (entry = _oph_odb_cache_find(type, id, id_datacube)) && entry->size) {
+		if ((*data = (char *) malloc(entry->size))) {
+			memcpy(*data, entry->data, entry->size);
+			*size = entry->size;
+			res = OPH_ODB_SUCCESS;
+		} else
+			res = OPH_ODB_MEMORY_ERROR;
+	}
+	pthread_mutex_unlock(&oph_odb_cache_lock);
+
+	return res;
+}
+
+int oph_odb_cache_put(oph_odb_cache_type type, int id, int id_datacube, const void *data, size_t size)
+{
+	if (!data && size)
+		return OPH_ODB_NULL_PARAM;
+
+	int res = OPH_ODB_SUCCESS;
+
+	pthread_mutex_lock(&oph_odb_cache_lock);
+	if (_oph_odb_cache_is_enabled())
+		res = _oph_odb_cache_put(type, id, id_datacube, data, size);
+	pthread_mutex_unlock(&oph_odb_cache_lock);
+
+	return res;
+}
+
+int oph_odb_cache_invalidate()
+{
+	pthread_mutex_lock(&oph_odb_cache_lock);
+	_oph_odb_cache_clear();
+	pthread_mutex_unlock(&oph_odb_cache_lock);
+
+	return OPH_ODB_SUCCESS;
+}
+
+int oph_odb_cache_clear()
+{
+	return oph_odb_cache_invalidate();
+}
+
+int oph_odb_cache_bcast(MPI_Comm comm, int status)
+{
+	int initialized = 0, rank = 0, size = 1;
+	MPI_Initialized(&initialized);
+	if (!initialized)
+		return OPH_ODB_SUCCESS;
+	MPI_Comm_rank(comm, &rank);
+	MPI_Comm_size(comm, &size);
+	if (size < 2)
+		return OPH_ODB_SUCCESS;
+
+	//The objects are shared only if the task has been initialized by every process
+	int success = status ? 0 : 1, all_success = 0;
+	MPI_Allreduce(&success, &all_success, 1, MPI_INT, MPI_MIN, comm);
+	if (!all_success)
+		return OPH_ODB_SUCCESS;
+
+	int i, buffer_size = 0;
+	size_t total_size = 0;
+	char *buffer = NULL, *pointer;
+	oph_odb_cache_entry *entry;
+	oph_odb_cache_header header;
+
+	//Serialize the objects cached by the root process
+	pthread_mutex_lock(&oph_odb_cache_lock);
+	if ((rank == OPH_ODB_CACHE_ROOT) && _oph_odb_cache_is_enabled()) {
+		for (i = 0; i < OPH_ODB_CACHE_BUCKETS; i++)
+			for (entry = oph_odb_cache_buckets[i]; entry; entry = entry->next)
+				total_size += sizeof(oph_odb_cache_header) + entry->size;
+		if (total_size > OPH_ODB_CACHE_BCAST_MAX_SIZE)
+			pmesg(LOG_DEBUG, __FILE__, __LINE__, "Metadata cache is too large to be shared\n");
+		else if (total_size && (buffer = (char *) malloc(total_size))) {
+			pointer = buffer;
+			for (i = 0; i < OPH_ODB_CACHE_BUCKETS; i++)
+				for (entry = oph_odb_cache_buckets[i]; entry; entry = entry->next) {
+					header.type = entry->type;
+					header.id = entry->id;
+					header.id_datacube = entry->id_datacube;
+					header.size = entry->size;
+					memcpy(pointer, &header, sizeof(oph_odb_cache_header));
+					pointer += sizeof(oph_odb_cache_header);
+					memcpy(pointer, entry->data, entry->size);
+					pointer += entry->size;
+				}
+			buffer_size = (int) total_size;
+		}
+	}
+	pthread_mutex_unlock(&oph_odb_cache_lock);
+
+	MPI_Bcast(&buffer_size, 1, MPI_INT, OPH_ODB_CACHE_ROOT, comm);
+	if (!buffer_size)
+		return OPH_ODB_SUCCESS;
+
+	//The objects are sent only if every process is able to receive them
+	int allocated = 1, all_allocated = 0;
+	if ((rank != OPH_ODB_CACHE_ROOT) && !(buffer = (char *) malloc(buffer_size)))
+		allocated = 0;
+	MPI_Allreduce(&allocated, &all_allocated, 1, MPI_INT, MPI_MIN, comm);
+	if (!all_allocated) {
+		pmesg(LOG_WARNING, __FILE__, __LINE__, "Error allocating memory: metadata cache will not be shared\n");
+		if (buffer)
+			free(buffer);
+		return allocated ? OPH_ODB_SUCCESS : OPH_ODB_MEMORY_ERROR;
+	}
+	MPI_Bcast(buffer, buffer_size, MPI_CHAR, OPH_ODB_CACHE_ROOT, comm);
+
+	//Load the objects
+	int res = OPH_ODB_SUCCESS;
+	if (rank != OPH_ODB_CACHE_ROOT) {
+		pthread_mutex_lock(&oph_odb_cache_lock);
+		if (_oph_odb_cache_is_enabled())
+			for (pointer = buffer; !res && (pointer + sizeof(oph_odb_cache_header) <= buffer + buffer_size);) {
+				memcpy(&header, pointer, sizeof(oph_odb_cache_header));
+				pointer += sizeof(oph_odb_cache_header);
+				if (pointer + header.size > buffer + buffer_size)
+					break;
+				res = _oph_odb_cache_put(header.type, header.id, header.id_datacube, pointer, header.size);
+				pointer += header.size;
+			}
+		pthread_mutex_unlock(&oph_odb_cache_lock);
+	}
+	free(buffer);
+
+	return res;
+}
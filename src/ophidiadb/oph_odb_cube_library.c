@@ -31,6 +31,7 @@
 
 #include "oph_pid_library.h"
 #include "oph_odb_metadata_library.h"
+#include "oph_odb_cache_library.h"
 
 extern int msglevel;
 
@@ -227,6 +228,8 @@ int oph_odb_cube_set_datacube_num_elements(ophidiadb * oDB, int id_datacube, lon
 		return OPH_ODB_MYSQL_ERROR;
 	}
 
+	oph_odb_cache_invalidate();
+
 	char insertQuery[MYSQL_BUFLEN];
 	int n = snprintf(insertQuery, MYSQL_BUFLEN, MYSQL_QUERY_CUBE_UPDATE_DATACUBE_ELEMENTS, num_elements, id_datacube);
 	if (n >= MYSQL_BUFLEN) {
@@ -254,6 +257,8 @@ int oph_odb_cube_set_datacube_size(ophidiadb * oDB, int id_datacube, long long i
 		return OPH_ODB_MYSQL_ERROR;
 	}
 
+	oph_odb_cache_invalidate();
+
 	char insertQuery[MYSQL_BUFLEN];
 	int n = snprintf(insertQuery, MYSQL_BUFLEN, MYSQL_QUERY_CUBE_UPDATE_DATACUBE_SIZE, size, id_datacube);
 	if (n >= MYSQL_BUFLEN) {
@@ -320,6 +325,50 @@ int oph_odb_cube_retrieve_source(ophidiadb * oDB, int id_src, oph_odb_source * s
 	return OPH_ODB_SUCCESS;
 }
 
+static int _oph_odb_cube_load_datacube(int id_datacube, oph_odb_datacube * cube, int partition_mode)
+{
+	char *data = NULL;
+	size_t size = 0;
+	if (oph_odb_cache_get_alloc(partition_mode ? OPH_ODB_CACHE_DATACUBE : OPH_ODB_CACHE_DATACUBE_ORDERED, id_datacube, 0, &data, &size))
+		return OPH_ODB_NO_ROW_FOUND;
+	if ((size < sizeof(oph_odb_datacube)) || ((size - sizeof(oph_odb_datacube)) % sizeof(int))) {
+		free(data);
+		return OPH_ODB_NO_ROW_FOUND;
+	}
+
+	oph_odb_datacube tmp;
+	memcpy(&tmp, data, sizeof(oph_odb_datacube));
+	tmp.id_db = NULL;
+	if (tmp.db_number && !(tmp.id_db = (int *) malloc(tmp.db_number * sizeof(int)))) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Error allocating memory\n");
+		free(data);
+		return OPH_ODB_MEMORY_ERROR;
+	}
+	if (tmp.db_number)
+		memcpy(tmp.id_db, data + sizeof(oph_odb_datacube), tmp.db_number * sizeof(int));
+	free(data);
+
+	//The description is not retrieved from OphidiaDB
+	memcpy(tmp.description, cube->description, OPH_ODB_CUBE_DESCRIPTION_SIZE + 1);
+	memcpy(cube, &tmp, sizeof(oph_odb_datacube));
+
+	return OPH_ODB_SUCCESS;
+}
+
+static int _oph_odb_cube_save_datacube(oph_odb_datacube * cube, int partition_mode)
+{
+	size_t size = sizeof(oph_odb_datacube) + cube->db_number * sizeof(int);
+	char *data = (char *) malloc(size);
+	if (!data)
+		return OPH_ODB_MEMORY_ERROR;
+	memcpy(data, cube, sizeof(oph_odb_datacube));
+	if (cube->db_number)
+		memcpy(data + sizeof(oph_odb_datacube), cube->id_db, cube->db_number * sizeof(int));
+	int res = oph_odb_cache_put(partition_mode ? OPH_ODB_CACHE_DATACUBE : OPH_ODB_CACHE_DATACUBE_ORDERED, cube->id_datacube, 0, data, size);
+	free(data);
+	return res;
+}
+
 int _oph_odb_cube_retrieve_datacube(ophidiadb * oDB, int id_datacube, oph_odb_datacube * cube, int partition_mode)
 {
 	if (!oDB || !id_datacube || !cube) {
@@ -327,6 +376,10 @@ int _oph_odb_cube_retrieve_datacube(ophidiadb * oDB, int id_datacube, oph_odb_da
 		return OPH_ODB_NULL_PARAM;
 	}
 
+	int n = _oph_odb_cube_load_datacube(id_datacube, cube, partition_mode);
+	if (n != OPH_ODB_NO_ROW_FOUND)
+		return n;
+
 	if (oph_odb_check_connection_to_ophidiadb(oDB)) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to reconnect to OphidiaDB.\n");
 		return OPH_ODB_MYSQL_ERROR;
@@ -334,7 +387,7 @@ int _oph_odb_cube_retrieve_datacube(ophidiadb * oDB, int id_datacube, oph_odb_da
 
 	char query[MYSQL_BUFLEN];
 
-	int n = snprintf(query, MYSQL_BUFLEN, MYSQL_QUERY_CUBE_RETRIEVE_CUBE, id_datacube);
+	n = snprintf(query, MYSQL_BUFLEN, MYSQL_QUERY_CUBE_RETRIEVE_CUBE, id_datacube);
 	if (n >= MYSQL_BUFLEN) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Size of query exceed query limit.\n");
 		return OPH_ODB_STR_BUFF_OVERFLOW;
@@ -414,6 +467,9 @@ int _oph_odb_cube_retrieve_datacube(ophidiadb * oDB, int id_datacube, oph_odb_da
 	}
 
 	mysql_free_result(res);
+
+	_oph_odb_cube_save_datacube(cube, partition_mode);
+
 	return OPH_ODB_SUCCESS;
 }
 
@@ -494,6 +550,14 @@ int oph_odb_cube_retrieve_cubehasdim_list(ophidiadb * oDB, int id_datacube, oph_
 		return OPH_ODB_NULL_PARAM;
 	}
 
+	size_t size = 0;
+	int n = oph_odb_cache_get_alloc(OPH_ODB_CACHE_CUBEHASDIM, id_datacube, 0, (char **) cubedims, &size);
+	if (!n) {
+		*dim_num = size / sizeof(oph_odb_cubehasdim);
+		return OPH_ODB_SUCCESS;
+	} else if (n != OPH_ODB_NO_ROW_FOUND)
+		return n;
+
 	if (oph_odb_check_connection_to_ophidiadb(oDB)) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to reconnect to OphidiaDB.\n");
 		return OPH_ODB_MYSQL_ERROR;
@@ -501,7 +565,7 @@ int oph_odb_cube_retrieve_cubehasdim_list(ophidiadb * oDB, int id_datacube, oph_
 
 	char query[MYSQL_BUFLEN];
 
-	int n = snprintf(query, MYSQL_BUFLEN, MYSQL_QUERY_CUBE_RETRIEVE_CUBEHASDIM, id_datacube);
+	n = snprintf(query, MYSQL_BUFLEN, MYSQL_QUERY_CUBE_RETRIEVE_CUBEHASDIM, id_datacube);
 	if (n >= MYSQL_BUFLEN) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Size of query exceed query limit.\n");
 		return OPH_ODB_STR_BUFF_OVERFLOW;
@@ -547,6 +611,9 @@ int oph_odb_cube_retrieve_cubehasdim_list(ophidiadb * oDB, int id_datacube, oph_
 		i++;
 	}
 	mysql_free_result(res);
+
+	oph_odb_cache_put(OPH_ODB_CACHE_CUBEHASDIM, id_datacube, 0, *cubedims, number_of_dims * sizeof(oph_odb_cubehasdim));
+
 	return OPH_ODB_SUCCESS;
 }
 
@@ -828,6 +895,8 @@ int oph_odb_cube_insert_into_datacube_partitioned_tables(ophidiadb * oDB, oph_od
 		return OPH_ODB_MYSQL_ERROR;
 	}
 
+	oph_odb_cache_invalidate();
+
 	char insertQuery[MYSQL_BUFLEN];
 	int n;
 	if (cube->id_source) {
@@ -974,6 +1043,8 @@ int oph_odb_cube_insert_into_cubehasdim_table(ophidiadb * oDB, oph_odb_cubehasdi
 		return OPH_ODB_MYSQL_ERROR;
 	}
 
+	oph_odb_cache_invalidate();
+
 	char insertQuery[MYSQL_BUFLEN];
 	int n = snprintf(insertQuery, MYSQL_BUFLEN, MYSQL_QUERY_CUBE_UPDATE_OPHIDIADB_CUBEHASDIM, cubedim->id_dimensioninst, cubedim->id_datacube, cubedim->explicit_dim, cubedim->level);
 	if (n >= MYSQL_BUFLEN) {
@@ -996,6 +1067,50 @@ int oph_odb_cube_insert_into_cubehasdim_table(ophidiadb * oDB, oph_odb_cubehasdi
 	return OPH_ODB_SUCCESS;
 }
 
+int oph_odb_cube_insert_into_cubehasdim_table2(ophidiadb * oDB, oph_odb_cubehasdim * cubedim, int cubedim_num)
+{
+	if (!oDB || !cubedim || (cubedim_num <= 0)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_ODB_NULL_PARAM;
+	}
+
+	if (oph_odb_check_connection_to_ophidiadb(oDB)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to reconnect to OphidiaDB.\n");
+		return OPH_ODB_MYSQL_ERROR;
+	}
+
+	oph_odb_cache_invalidate();
+
+	oph_odb_batch batch;
+	oph_odb_batch_init(&batch, MYSQL_QUERY_CUBE_UPDATE_OPHIDIADB_CUBEHASDIM2);
+
+	int i, res = OPH_ODB_SUCCESS;
+	for (i = 0; i < cubedim_num; i++)
+		if ((res = oph_odb_batch_add(&batch, "(%d, %d, %d, %d)", cubedim[i].id_dimensioninst, cubedim[i].id_datacube, cubedim[i].explicit_dim, cubedim[i].level)))
+			break;
+	//Relations are few, so that a single statement is expected
+	if (!res && batch.query_number) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Size of query exceed query limit.\n");
+		res = OPH_ODB_STR_BUFF_OVERFLOW;
+	}
+	if (!res)
+		res = oph_odb_batch_query(oDB, &batch);
+	oph_odb_batch_free(&batch);
+	if (res)
+		return res;
+
+	//Identifiers generated by a multi-row statement are consecutive
+	int first_id = mysql_insert_id(oDB->conn);
+	if (!first_id) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to find last inserted cubehasdim id\n");
+		return OPH_ODB_TOO_MANY_ROWS;
+	}
+	for (i = 0; i < cubedim_num; i++)
+		cubedim[i].id_cubehasdim = first_id + i;
+
+	return OPH_ODB_SUCCESS;
+}
+
 int oph_odb_cube_update_level_in_cubehasdim_table(ophidiadb * oDB, int level, int id_cubehasdim)
 {
 	if (!oDB || !id_cubehasdim) {
@@ -1008,6 +1123,8 @@ int oph_odb_cube_update_level_in_cubehasdim_table(ophidiadb * oDB, int level, in
 		return OPH_ODB_MYSQL_ERROR;
 	}
 
+	oph_odb_cache_invalidate();
+
 	char updateQuery[MYSQL_BUFLEN];
 	int n = snprintf(updateQuery, MYSQL_BUFLEN, MYSQL_QUERY_CUBE_UPDATE_LEVEL_OF_CUBEHASDIM, level, id_cubehasdim);
 	if (n >= MYSQL_BUFLEN) {
@@ -1035,6 +1152,8 @@ int oph_odb_cube_delete_from_datacube_table(ophidiadb * oDB, int id_datacube)
 		return OPH_ODB_MYSQL_ERROR;
 	}
 
+	oph_odb_cache_invalidate();
+
 	char deleteQuery[MYSQL_BUFLEN];
 	int n = snprintf(deleteQuery, MYSQL_BUFLEN, MYSQL_QUERY_CUBE_DELETE_OPHIDIADB_CUBE, id_datacube);
 	if (n >= MYSQL_BUFLEN) {
@@ -1326,6 +1445,8 @@ int oph_odb_cube_update_tuplexfragment(ophidiadb * oDB, int id_datacube, int tup
 		return OPH_ODB_MYSQL_ERROR;
 	}
 
+	oph_odb_cache_invalidate();
+
 	char deleteQuery[MYSQL_BUFLEN];
 	int n = snprintf(deleteQuery, MYSQL_BUFLEN, MYSQL_QUERY_CUBE_UPDATE_OPHIDIADB_TUPLEXFRAGMENT, tuplexfragment, id_datacube);
 	if (n >= MYSQL_BUFLEN) {
@@ -1353,6 +1474,8 @@ int oph_odb_cube_update_missingvalue(ophidiadb * oDB, int id_datacube, int idmis
 		return OPH_ODB_MYSQL_ERROR;
 	}
 
+	oph_odb_cache_invalidate();
+
 	char deleteQuery[MYSQL_BUFLEN];
 	int n = snprintf(deleteQuery, MYSQL_BUFLEN, MYSQL_QUERY_CUBE_UPDATE_OPHIDIADB_CUBE_MS, idmissingvalue, id_datacube);
 	if (n >= MYSQL_BUFLEN) {
@@ -1435,3 +1558,136 @@ int oph_odb_cube_order_by(ophidiadb * oDB, int order, int *id_datacube, int id_d
 
 	return OPH_ODB_SUCCESS;
 }
+
+int oph_odb_cube_insert_into_lazydatacube_table(ophidiadb * oDB, int id_datacube, int id_input)
+{
+	if (!oDB || !id_datacube || !id_input) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_ODB_NULL_PARAM;
+	}
+
+	if (oph_odb_check_connection_to_ophidiadb(oDB)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to reconnect to OphidiaDB.\n");
+		return OPH_ODB_MYSQL_ERROR;
+	}
+
+	char insertQuery[MYSQL_BUFLEN];
+	int n = snprintf(insertQuery, MYSQL_BUFLEN, MYSQL_QUERY_CUBE_UPDATE_OPHIDIADB_LAZY_CUBE, id_datacube, id_input);
+	if (n >= MYSQL_BUFLEN) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Size of query exceed query limit.\n");
+		return OPH_ODB_STR_BUFF_OVERFLOW;
+	}
+
+	if (mysql_query(oDB->conn, insertQuery)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "MySQL query error: %s\n", mysql_error(oDB->conn));
+		return OPH_ODB_MYSQL_ERROR;
+	}
+
+	return OPH_ODB_SUCCESS;
+}
+
+int _oph_odb_cube_count(ophidiadb * oDB, const char *query, int *count)
+{
+	if (mysql_query(oDB->conn, query)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "MySQL query error: %s\n", mysql_error(oDB->conn));
+		return OPH_ODB_MYSQL_ERROR;
+	}
+
+	MYSQL_RES *res;
+	MYSQL_ROW row;
+	res = mysql_store_result(oDB->conn);
+
+	if (mysql_num_rows(res) != 1) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "No/more than one row found by query\n");
+		mysql_free_result(res);
+		return OPH_ODB_TOO_MANY_ROWS;
+	}
+
+	if (mysql_field_count(oDB->conn) != 1) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Not enough fields found by query\n");
+		mysql_free_result(res);
+		return OPH_ODB_TOO_MANY_ROWS;
+	}
+
+	*count = 0;
+	if ((row = mysql_fetch_row(res)) && row[0])
+		*count = (int) strtol(row[0], NULL, 10);
+	mysql_free_result(res);
+
+	return OPH_ODB_SUCCESS;
+}
+
+int oph_odb_cube_is_lazy(ophidiadb * oDB, int id_datacube, int *lazy)
+{
+	if (!oDB || !id_datacube || !lazy) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_ODB_NULL_PARAM;
+	}
+
+	if (oph_odb_check_connection_to_ophidiadb(oDB)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to reconnect to OphidiaDB.\n");
+		return OPH_ODB_MYSQL_ERROR;
+	}
+
+	char query[MYSQL_BUFLEN];
+	int n = snprintf(query, MYSQL_BUFLEN, MYSQL_QUERY_CUBE_CHECK_LAZY_CUBE, id_datacube);
+	if (n >= MYSQL_BUFLEN) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Size of query exceed query limit.\n");
+		return OPH_ODB_STR_BUFF_OVERFLOW;
+	}
+
+	return _oph_odb_cube_count(oDB, query, lazy);
+}
+
+int oph_odb_cube_count_lazy_datacubes(ophidiadb * oDB, int id_datacube, int id_container, int *number)
+{
+	if (!oDB || (!id_datacube && !id_container) || !number) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_ODB_NULL_PARAM;
+	}
+
+	if (oph_odb_check_connection_to_ophidiadb(oDB)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to reconnect to OphidiaDB.\n");
+		return OPH_ODB_MYSQL_ERROR;
+	}
+
+	char query[MYSQL_BUFLEN];
+	int n;
+	if (id_datacube)
+		n = snprintf(query, MYSQL_BUFLEN, MYSQL_QUERY_CUBE_COUNT_LAZY_CUBES, id_datacube);
+	else
+		n = snprintf(query, MYSQL_BUFLEN, MYSQL_QUERY_CUBE_COUNT_LAZY_CUBES_OF_CONTAINER, id_container, id_container);
+	if (n >= MYSQL_BUFLEN) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Size of query exceed query limit.\n");
+		return OPH_ODB_STR_BUFF_OVERFLOW;
+	}
+
+	return _oph_odb_cube_count(oDB, query, number);
+}
+
+int oph_odb_cube_check_lazy_support(ophidiadb * oDB, int id_datacube, int *supported)
+{
+	if (!oDB || !id_datacube || !supported) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_ODB_NULL_PARAM;
+	}
+
+	if (oph_odb_check_connection_to_ophidiadb(oDB)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to reconnect to OphidiaDB.\n");
+		return OPH_ODB_MYSQL_ERROR;
+	}
+
+	char query[MYSQL_BUFLEN];
+	int n = snprintf(query, MYSQL_BUFLEN, MYSQL_QUERY_CUBE_COUNT_LAZY_UNSUPPORTED_DBMS, id_datacube);
+	if (n >= MYSQL_BUFLEN) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Size of query exceed query limit.\n");
+		return OPH_ODB_STR_BUFF_OVERFLOW;
+	}
+
+	int unsupported = 0;
+	if (_oph_odb_cube_count(oDB, query, &unsupported))
+		return OPH_ODB_MYSQL_ERROR;
+	*supported = !unsupported;
+
+	return OPH_ODB_SUCCESS;
+}
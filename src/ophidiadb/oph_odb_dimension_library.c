@@ -31,6 +31,7 @@
 
 #include "oph_odb_metadata_library.h"
 #include "oph_hierarchy_library.h"
+#include "oph_odb_cache_library.h"
 
 #define OPH_ODB_DIM_BASETIME_FORMAT_CHECK '%'
 
@@ -376,7 +377,19 @@ int oph_odb_dim_retrieve_dimension2(ophidiadb * oDB, int id_dimension, oph_odb_d
 
 int oph_odb_dim_retrieve_dimension(ophidiadb * oDB, int id_dimension, oph_odb_dimension * dim, int id_datacube)
 {
-	return oph_odb_dim_retrieve_dimension2(oDB, id_dimension, dim, id_datacube, 1);
+	if (!oDB || !dim || !id_dimension) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_ODB_NULL_PARAM;
+	}
+
+	if (!oph_odb_cache_get(OPH_ODB_CACHE_DIMENSION, id_dimension, id_datacube, dim, sizeof(oph_odb_dimension)))
+		return OPH_ODB_SUCCESS;
+
+	int res = oph_odb_dim_retrieve_dimension2(oDB, id_dimension, dim, id_datacube, 1);
+	if (!res)
+		oph_odb_cache_put(OPH_ODB_CACHE_DIMENSION, id_dimension, id_datacube, dim, sizeof(oph_odb_dimension));
+
+	return res;
 }
 
 int oph_odb_dim_retrieve_dimension_name_from_instance_id(ophidiadb * oDB, int id_dimensioninst, char **dimension_name)
@@ -714,7 +727,7 @@ int oph_odb_dim_retrieve_dimension_instance_id2(ophidiadb * oDB, int id_datacube
 	return OPH_ODB_SUCCESS;
 }
 
-int oph_odb_dim_retrieve_dimension_instance(ophidiadb * oDB, int id_dimensioninst, oph_odb_dimension_instance * dim_inst, int id_datacube)
+static int _oph_odb_dim_retrieve_dimension_instance(ophidiadb * oDB, int id_dimensioninst, oph_odb_dimension_instance * dim_inst, int id_datacube)
 {
 	if (!oDB || !dim_inst || !id_dimensioninst) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
@@ -805,6 +818,23 @@ int oph_odb_dim_retrieve_dimension_instance(ophidiadb * oDB, int id_dimensionins
 	return OPH_ODB_SUCCESS;
 }
 
+int oph_odb_dim_retrieve_dimension_instance(ophidiadb * oDB, int id_dimensioninst, oph_odb_dimension_instance * dim_inst, int id_datacube)
+{
+	if (!oDB || !dim_inst || !id_dimensioninst) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_ODB_NULL_PARAM;
+	}
+
+	if (!oph_odb_cache_get(OPH_ODB_CACHE_DIMENSION_INSTANCE, id_dimensioninst, id_datacube, dim_inst, sizeof(oph_odb_dimension_instance)))
+		return OPH_ODB_SUCCESS;
+
+	int res = _oph_odb_dim_retrieve_dimension_instance(oDB, id_dimensioninst, dim_inst, id_datacube);
+	if (!res)
+		oph_odb_cache_put(OPH_ODB_CACHE_DIMENSION_INSTANCE, id_dimensioninst, id_datacube, dim_inst, sizeof(oph_odb_dimension_instance));
+
+	return res;
+}
+
 int oph_odb_dim_retrieve_dimension_list_from_container(ophidiadb * oDB, int id_container, oph_odb_dimension ** dims, int *dim_num)
 {
 	if (!oDB || !id_container || !dims || !dim_num) {
@@ -1233,6 +1263,8 @@ int oph_odb_dim_insert_into_dimension_table(ophidiadb * oDB, oph_odb_dimension *
 		return OPH_ODB_MYSQL_ERROR;
 	}
 
+	oph_odb_cache_invalidate();
+
 	int n;
 	char insertQuery[MYSQL_BUFLEN];
 
@@ -1338,6 +1370,8 @@ int oph_odb_dim_insert_into_dimensioninstance_table(ophidiadb * oDB, oph_odb_dim
 		return OPH_ODB_MYSQL_ERROR;
 	}
 
+	oph_odb_cache_invalidate();
+
 	char insertQuery[MYSQL_BUFLEN];
 	int n;
 	if (dim_inst->id_grid)
@@ -1388,6 +1422,8 @@ int oph_odb_dim_delete_dimensioninstance(ophidiadb * oDB, int id_dimensioninst)
 		return OPH_ODB_MYSQL_ERROR;
 	}
 
+	oph_odb_cache_invalidate();
+
 	char deleteQuery[MYSQL_BUFLEN];
 	int n = snprintf(deleteQuery, MYSQL_BUFLEN, MYSQL_DELETE_OPHIDIADB_DIMENSION_INSTANCE, id_dimensioninst);
 	if (n >= MYSQL_BUFLEN) {
@@ -1666,6 +1702,8 @@ int oph_odb_dim_set_time_dimension(ophidiadb * oDB, int id_datacube, char *dimen
 		return OPH_ODB_NULL_PARAM;
 	}
 
+	oph_odb_cache_invalidate();
+
 	oph_odb_dimension dim;
 	if (oph_odb_dim_retrieve_hierarchy_id(oDB, OPH_COMMON_TIME_HIERARCHY, &dim.id_hierarchy)) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "MySQL query error: %s\n", mysql_error(oDB->conn));
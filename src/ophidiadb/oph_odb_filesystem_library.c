@@ -29,6 +29,8 @@
 #include <mysql.h>
 #include "debug.h"
 
+#include "oph_odb_cache_library.h"
+
 extern int msglevel;
 
 static char oph_odb_fs_chars[OPH_ODB_FS_CHARS_NUM] = { '\'', '\"', '?', '|', '\\', '/', ':', ';', ',', '<', '>', '*', '=', '!' };
@@ -448,6 +450,14 @@ int oph_odb_fs_build_path(int folder_id, ophidiadb * oDB, char (*out_path)[MYSQL
 	}
 
 	int n;
+	char *path = NULL;
+	size_t size = 0;
+	if (!oph_odb_cache_get_alloc(OPH_ODB_CACHE_FOLDER_PATH, folder_id, 0, &path, &size)) {
+		snprintf(*out_path, MYSQL_BUFLEN, "%s", path);
+		free(path);
+		return OPH_ODB_SUCCESS;
+	}
+
 	char query[MYSQL_BUFLEN];
 
 	MYSQL_RES *res;
@@ -500,6 +510,8 @@ int oph_odb_fs_build_path(int folder_id, ophidiadb * oDB, char (*out_path)[MYSQL
 	}
 	snprintf(*out_path, MYSQL_BUFLEN, OPH_ODB_FS_ROOT "%s", tmp_out_path);
 
+	oph_odb_cache_put(OPH_ODB_CACHE_FOLDER_PATH, folder_id, 0, *out_path, strlen(*out_path) + 1);
+
 	return OPH_ODB_SUCCESS;
 }
 
@@ -856,6 +868,8 @@ int oph_odb_fs_insert_into_folder_table(ophidiadb * oDB, int parent_folder_id, c
 		return OPH_ODB_MYSQL_ERROR;
 	}
 
+	oph_odb_cache_invalidate();
+
 	char insertQuery[MYSQL_BUFLEN];
 	int n;
 
@@ -890,6 +904,8 @@ int oph_odb_fs_delete_from_folder_table(ophidiadb * oDB, int folderid)
 		return OPH_ODB_MYSQL_ERROR;
 	}
 
+	oph_odb_cache_invalidate();
+
 	char deleteQuery[MYSQL_BUFLEN];
 	int n = snprintf(deleteQuery, MYSQL_BUFLEN, MYSQL_QUERY_FS_RMDIR, folderid);
 	if (n >= MYSQL_BUFLEN) {
@@ -917,6 +933,8 @@ int oph_odb_fs_update_folder_table(ophidiadb * oDB, int old_folder_id, int new_p
 		return OPH_ODB_MYSQL_ERROR;
 	}
 
+	oph_odb_cache_invalidate();
+
 	char insertQuery[MYSQL_BUFLEN];
 	int n = snprintf(insertQuery, MYSQL_BUFLEN, MYSQL_QUERY_FS_MVDIR, new_parent_folder_id, new_child_folder, old_folder_id);
 
@@ -31,6 +31,7 @@
 
 #include "oph_odb_cube_library.h"
 #include "oph_pid_library.h"
+#include "oph_odb_cache_library.h"
 
 extern int msglevel;
 
@@ -84,6 +85,9 @@ int oph_odb_meta_insert_into_metadatainstance_manage_tables(ophidiadb * oDB, con
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to reconnect to OphidiaDB.\n");
 		return OPH_ODB_MYSQL_ERROR;
 	}
+
+	oph_odb_cache_invalidate();
+
 	//escape value
 	int n = strlen(value);
 	char *escaped_value = (char *) malloc(2 * n + 1);
@@ -483,6 +487,9 @@ int oph_odb_meta_insert_into_metadatainstance_table(ophidiadb * oDB, int id_data
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to reconnect to OphidiaDB.\n");
 		return OPH_ODB_MYSQL_ERROR;
 	}
+
+	oph_odb_cache_invalidate();
+
 	//escape value
 	int n = strlen(metadata_value);
 	char *escaped_value = (char *) malloc(2 * n + 1);
@@ -669,6 +676,9 @@ int oph_odb_meta_update_metadatainstance_table(ophidiadb * oDB, int id_metadatai
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to reconnect to OphidiaDB.\n");
 		return OPH_ODB_MYSQL_ERROR;
 	}
+
+	oph_odb_cache_invalidate();
+
 	//escape value
 	n = strlen(metadata_value);
 	char *escaped_value = (char *) malloc(2 * n + 1);
@@ -760,6 +770,8 @@ int oph_odb_meta_delete_from_metadatainstance_table(ophidiadb * oDB, int id_data
 		return OPH_ODB_MYSQL_ERROR;
 	}
 
+	oph_odb_cache_invalidate();
+
 	if (id_metadatainstance)
 		n = snprintf(query, MYSQL_BUFLEN, MYSQL_QUERY_META_DELETE_INSTANCE, id_metadatainstance, id_datacube);
 	else
@@ -789,6 +801,8 @@ int oph_odb_meta_copy_from_cube_to_cube(ophidiadb * oDB, int id_datacube_input,
 		return OPH_ODB_MYSQL_ERROR;
 	}
 
+	oph_odb_cache_invalidate();
+
 	char insertQuery[MYSQL_BUFLEN];
 	int n;
 
@@ -1004,6 +1018,8 @@ int oph_odb_meta_put(ophidiadb * oDB, int id_datacube, const char *variable, con
 		return OPH_ODB_MYSQL_ERROR;
 	}
 
+	oph_odb_cache_invalidate();
+
 	char query[MYSQL_BUFLEN];
 	int n = 0;
 	if (id_metadata_instance)	// update the metadata
@@ -1178,6 +1194,8 @@ int oph_odb_meta_update_metadatakeys2(ophidiadb * oDB, int id_datacube, const ch
 		return OPH_ODB_MYSQL_ERROR;
 	}
 
+	oph_odb_cache_invalidate();
+
 	char selectQuery[MYSQL_BUFLEN];
 	int n;
 	if (new_type)
@@ -30,6 +30,7 @@
 #include "debug.h"
 
 #include "oph_idstring_library.h"
+#include "oph_odb_cache_library.h"
 
 extern int msglevel;
 
@@ -435,6 +436,66 @@ int oph_odb_stge_fetch_dbms_connection_string(ophidiadb * oDB, int id_datacube,
 	return OPH_ODB_SUCCESS;
 }
 
+//Translate a set of relative fragment IDs into a condition with a BETWEEN predicate for each range and a single IN predicate for isolated IDs
+static int _oph_odb_stge_build_fragment_condition(char *fragrelindexset, char **condition)
+{
+	*condition = NULL;
+
+	oph_ids_set set, empty, sorted;
+	if (oph_ids_set_parse(fragrelindexset, &set)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Error converting ASCII to INT\n");
+		return OPH_ODB_ERROR;
+	}
+	oph_ids_set_init(&empty);
+	if (oph_ids_set_union(&set, &empty, &sorted)) {
+		oph_ids_set_free(&set);
+		return OPH_ODB_MEMORY_ERROR;
+	}
+	oph_ids_set_free(&set);
+
+	int i, singles = 0;
+	size_t len = 1, n = 0;
+	for (i = 0; i < sorted.size; i++) {
+		if (sorted.intervals[i].first == sorted.intervals[i].last) {
+			len += snprintf(NULL, 0, "%d,", sorted.intervals[i].first);
+			singles++;
+		} else
+			len += snprintf(NULL, 0, MYSQL_STGE_FRAGMENT_RELATIVE_INDEX_COND2 " OR ", sorted.intervals[i].first, sorted.intervals[i].last);
+	}
+	//Room for the predicate on isolated IDs
+	len += strlen(" OR " MYSQL_STGE_FRAGMENT_RELATIVE_INDEX_COND3);
+
+	char *cond = (char *) malloc(len * sizeof(char)), *ids = NULL;
+	if (!cond || (singles > 1 && !(ids = (char *) malloc(len * sizeof(char))))) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Error allocating memory\n");
+		if (cond)
+			free(cond);
+		oph_ids_set_free(&sorted);
+		return OPH_ODB_MEMORY_ERROR;
+	}
+	*cond = 0;
+
+	size_t m = 0;
+	for (i = 0; i < sorted.size; i++) {
+		if (sorted.intervals[i].first != sorted.intervals[i].last)
+			n += snprintf(cond + n, len - n, n ? " OR " MYSQL_STGE_FRAGMENT_RELATIVE_INDEX_COND2 : MYSQL_STGE_FRAGMENT_RELATIVE_INDEX_COND2, sorted.intervals[i].first,
+				      sorted.intervals[i].last);
+		else if (singles == 1)
+			n += snprintf(cond + n, len - n, n ? " OR " MYSQL_STGE_FRAGMENT_RELATIVE_INDEX_COND1 : MYSQL_STGE_FRAGMENT_RELATIVE_INDEX_COND1, sorted.intervals[i].first);
+		else
+			m += snprintf(ids + m, len - m, m ? ",%d" : "%d", sorted.intervals[i].first);
+	}
+	if (ids) {
+		snprintf(cond + n, len - n, n ? " OR " MYSQL_STGE_FRAGMENT_RELATIVE_INDEX_COND3 : MYSQL_STGE_FRAGMENT_RELATIVE_INDEX_COND3, ids);
+		free(ids);
+	}
+	oph_ids_set_free(&sorted);
+
+	*condition = cond;
+
+	return OPH_ODB_SUCCESS;
+}
+
 int oph_odb_stge_fetch_fragment_connection_string(ophidiadb * oDB, int id_datacube, char *fragrelindexset, oph_odb_fragment_list * frags, oph_odb_db_instance_list * dbs,
 						  oph_odb_dbms_instance_list * dbmss)
 {
@@ -446,77 +507,15 @@ int oph_odb_stge_fetch_fragment_connection_string(ophidiadb * oDB, int id_datacu
 	dbs->size = 0;
 	dbmss->size = 0;
 
-	char query[MYSQL_BUFLEN];
-	char condition[MYSQL_BUFLEN];
-	memset(condition, 0, MYSQL_BUFLEN);
-
 	//Prepare query statement
-	char *start, *end, *hyphen, *cond_ptr;
-	char buffer[10];
-	int a, b, len, total_len = 0;
-
-	start = fragrelindexset;
-	cond_ptr = condition;
-	do {
-		len = 0;
-		//Fetch till ; or fetch all string
-		end = strchr(start, OPH_IDS_SEMICOLON_CHAR);
-		if (end != NULL) {
-			strncpy(buffer, start, (end - start));
-			buffer[(end - start)] = '\0';
-		} else {
-			strncpy(buffer, start, (strlen(start) + 1));
-		}
-
-		//Check if single value or range
-		hyphen = strchr(buffer, OPH_IDS_HYPHEN_CHAR);
-		if (hyphen == NULL) {
-			a = (int) strtol(buffer, NULL, 10);
-			if (a == 0) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Error converting ASCII to INT\n");
-				return OPH_ODB_ERROR;
-			}
-			//Do k = a
-			len = snprintf(NULL, 0, MYSQL_STGE_FRAGMENT_RELATIVE_INDEX_COND1, a);
-			total_len += len;
-			if (total_len >= MYSQL_BUFLEN) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Length of substring exceed limit.\n");
-				return OPH_ODB_STR_BUFF_OVERFLOW;
-			}
-			snprintf(cond_ptr, len + 1, MYSQL_STGE_FRAGMENT_RELATIVE_INDEX_COND1, a);
-		} else {
-			*hyphen = '\0';
-			a = (int) strtol(buffer, NULL, 10);
-			b = (int) strtol(hyphen + 1, NULL, 10);
-			if (a == 0 || b == 0) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Error converting ASCII to INT\n");
-				return OPH_ODB_ERROR;
-			}
-			//Do k >= a AND k<= b
-			len = snprintf(NULL, 0, MYSQL_STGE_FRAGMENT_RELATIVE_INDEX_COND2, a, b);
-			total_len += len;
-			if (total_len >= MYSQL_BUFLEN) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Length of substring exceed limit.\n");
-				return OPH_ODB_STR_BUFF_OVERFLOW;
-			}
-			snprintf(cond_ptr, len + 1, MYSQL_STGE_FRAGMENT_RELATIVE_INDEX_COND2, a, b);
-		}
-		start = end + 1;
-		cond_ptr += len;
-		if (end) {
-			//Add OR
-			total_len += 4;
-			if (total_len >= MYSQL_BUFLEN) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Length of substring exceed limit.\n");
-				return OPH_ODB_STR_BUFF_OVERFLOW;
-			}
-			snprintf(cond_ptr, 5, " OR ");
-			cond_ptr += 4;
-		}
-	} while (end);
+	char *condition = NULL;
+	int res_cond = _oph_odb_stge_build_fragment_condition(fragrelindexset, &condition);
+	if (res_cond)
+		return res_cond;
 
 	if (oph_odb_check_connection_to_ophidiadb(oDB)) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to reconnect to OphidiaDB.\n");
+		free(condition);
 		return OPH_ODB_MYSQL_ERROR;
 	}
 	//Initialize structures
@@ -525,16 +524,22 @@ int oph_odb_stge_fetch_fragment_connection_string(ophidiadb * oDB, int id_datacu
 	oph_odb_stge_init_dbms_list(dbmss);
 
 	//Execute query
-	int n = snprintf(query, MYSQL_BUFLEN, MYSQL_QUERY_STGE_RETRIEVE_FRAG_CONNECTION, condition, id_datacube);
-	if (n >= MYSQL_BUFLEN) {
-		pmesg(LOG_ERROR, __FILE__, __LINE__, "Size of query exceed query limit.\n");
-		return OPH_ODB_STR_BUFF_OVERFLOW;
+	int n = snprintf(NULL, 0, MYSQL_QUERY_STGE_RETRIEVE_FRAG_CONNECTION, condition, id_datacube) + 1;
+	char *query = (char *) malloc(n * sizeof(char));
+	if (!query) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Error allocating memory\n");
+		free(condition);
+		return OPH_ODB_MEMORY_ERROR;
 	}
+	snprintf(query, n, MYSQL_QUERY_STGE_RETRIEVE_FRAG_CONNECTION, condition, id_datacube);
+	free(condition);
 
 	if (mysql_query(oDB->conn, query)) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "MySQL query error: %s\n", mysql_error(oDB->conn));
+		free(query);
 		return OPH_ODB_MYSQL_ERROR;
 	}
+	free(query);
 	// Init res
 	MYSQL_RES *res;
 	MYSQL_ROW row;
@@ -660,77 +665,15 @@ int oph_odb_stge_fetch_fragment_connection_string_for_deletion(ophidiadb * oDB,
 	dbs->size = 0;
 	dbmss->size = 0;
 
-	char query[MYSQL_BUFLEN];
-	char condition[MYSQL_BUFLEN];
-	memset(condition, 0, MYSQL_BUFLEN);
-
 	//Prepare query statement
-	char *start, *end, *hyphen, *cond_ptr;
-	char buffer[10];
-	int a, b, len, total_len = 0;
-
-	start = fragrelindexset;
-	cond_ptr = condition;
-	do {
-		len = 0;
-		//Fetch till ; or fetch all string
-		end = strchr(start, OPH_IDS_SEMICOLON_CHAR);
-		if (end != NULL) {
-			strncpy(buffer, start, (end - start));
-			buffer[(end - start)] = '\0';
-		} else {
-			strncpy(buffer, start, (strlen(start) + 1));
-		}
-
-		//Check if single value or range
-		hyphen = strchr(buffer, OPH_IDS_HYPHEN_CHAR);
-		if (hyphen == NULL) {
-			a = (int) strtol(buffer, NULL, 10);
-			if (a == 0) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Error converting ASCII to INT\n");
-				return OPH_ODB_ERROR;
-			}
-			//Do k = a
-			len = snprintf(NULL, 0, MYSQL_STGE_FRAGMENT_RELATIVE_INDEX_COND1, a);
-			total_len += len;
-			if (total_len >= MYSQL_BUFLEN) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Length of substring exceed limit.\n");
-				return OPH_ODB_STR_BUFF_OVERFLOW;
-			}
-			snprintf(cond_ptr, len + 1, MYSQL_STGE_FRAGMENT_RELATIVE_INDEX_COND1, a);
-		} else {
-			*hyphen = '\0';
-			a = (int) strtol(buffer, NULL, 10);
-			b = (int) strtol(hyphen + 1, NULL, 10);
-			if (a == 0 || b == 0) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Error converting ASCII to INT\n");
-				return OPH_ODB_ERROR;
-			}
-			//Do k >= a AND k<= b
-			len = snprintf(NULL, 0, MYSQL_STGE_FRAGMENT_RELATIVE_INDEX_COND2, a, b);
-			total_len += len;
-			if (total_len >= MYSQL_BUFLEN) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Length of substring exceed limit.\n");
-				return OPH_ODB_STR_BUFF_OVERFLOW;
-			}
-			snprintf(cond_ptr, len + 1, MYSQL_STGE_FRAGMENT_RELATIVE_INDEX_COND2, a, b);
-		}
-		start = end + 1;
-		cond_ptr += len;
-		if (end) {
-			//Add OR
-			total_len += 4;
-			if (total_len >= MYSQL_BUFLEN) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Length of substring exceed limit.\n");
-				return OPH_ODB_STR_BUFF_OVERFLOW;
-			}
-			snprintf(cond_ptr, 5, " OR ");
-			cond_ptr += 4;
-		}
-	} while (end);
+	char *condition = NULL;
+	int res_cond = _oph_odb_stge_build_fragment_condition(fragrelindexset, &condition);
+	if (res_cond)
+		return res_cond;
 
 	if (oph_odb_check_connection_to_ophidiadb(oDB)) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to reconnect to OphidiaDB.\n");
+		free(condition);
 		return OPH_ODB_MYSQL_ERROR;
 	}
 	//Initialize structures
@@ -739,16 +682,22 @@ int oph_odb_stge_fetch_fragment_connection_string_for_deletion(ophidiadb * oDB,
 	oph_odb_stge_init_dbms_list(dbmss);
 
 	//Execute query
-	int n = snprintf(query, MYSQL_BUFLEN, MYSQL_QUERY_STGE_RETRIEVE_FRAG_CONNECTION, condition, id_datacube);
-	if (n >= MYSQL_BUFLEN) {
-		pmesg(LOG_ERROR, __FILE__, __LINE__, "Size of query exceed query limit.\n");
-		return OPH_ODB_STR_BUFF_OVERFLOW;
+	int n = snprintf(NULL, 0, MYSQL_QUERY_STGE_RETRIEVE_FRAG_CONNECTION, condition, id_datacube) + 1;
+	char *query = (char *) malloc(n * sizeof(char));
+	if (!query) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Error allocating memory\n");
+		free(condition);
+		return OPH_ODB_MEMORY_ERROR;
 	}
+	snprintf(query, n, MYSQL_QUERY_STGE_RETRIEVE_FRAG_CONNECTION, condition, id_datacube);
+	free(condition);
 
 	if (mysql_query(oDB->conn, query)) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "MySQL query error: %s\n", mysql_error(oDB->conn));
+		free(query);
 		return OPH_ODB_MYSQL_ERROR;
 	}
+	free(query);
 	// Init res
 	MYSQL_RES *res;
 	MYSQL_ROW row;
@@ -1556,41 +1505,171 @@ int oph_odb_stge_insert_into_fragment_table2(ophidiadb * oDB, oph_odb_fragment *
 		return OPH_ODB_NULL_PARAM;
 	}
 
+	oph_odb_batch batch;
+	oph_odb_batch_init(&batch, MYSQL_QUERY_STGE_UPDATE_OPHIDIADB_FRAG2);
+
+	int l = 0, res = OPH_ODB_SUCCESS;
+	for (l = 0; l < frag_num; l++)
+		if ((fragment[l]).id_datacube && (res = oph_odb_stge_add_fragment_to_batch(&batch, fragment + l)))
+			break;
+
+	if (!res)
+		res = oph_odb_batch_execute(oDB, &batch);
+	oph_odb_batch_free(&batch);
+
+	return res;
+}
+
+int oph_odb_stge_retrieve_cached_fragments(ophidiadb * oDB, int id_datacube, const char *key, oph_odb_fragment_list * frags, char ***cached)
+{
+	if (!oDB || !id_datacube || !key || !frags || !cached) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_ODB_NULL_PARAM;
+	}
+	*cached = NULL;
+
 	if (oph_odb_check_connection_to_ophidiadb(oDB)) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to reconnect to OphidiaDB.\n");
 		return OPH_ODB_MYSQL_ERROR;
 	}
+	//escape key
+	int n = strlen(key);
+	char *escaped_key = (char *) malloc(2 * n + 1);
+	if (!escaped_key) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Error allocating memory for escaped key\n");
+		return OPH_ODB_MEMORY_ERROR;
+	}
+	mysql_real_escape_string(oDB->conn, escaped_key, key, n);
 
-	char insertQuery[MYSQL_BUFLEN], buffer[MYSQL_BUFLEN];
-	int l = 0, n = 0;
+	int query_buflen = 1 + snprintf(NULL, 0, MYSQL_QUERY_STGE_RETRIEVE_CACHED_FRAG, id_datacube, escaped_key);
+	char *query = (char *) malloc(query_buflen);
+	if (!query) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Error allocating memory for query\n");
+		free(escaped_key);
+		return OPH_ODB_MEMORY_ERROR;
+	}
+	snprintf(query, query_buflen, MYSQL_QUERY_STGE_RETRIEVE_CACHED_FRAG, id_datacube, escaped_key);
+	free(escaped_key);
 
-	//Setup full query for multi-insert statement
-	for (l = 0; l < frag_num; l++) {
-		if ((fragment[l]).id_datacube != 0) {
-			n += snprintf(buffer + n, MYSQL_BUFLEN - n, "(%d, %d, %d, '%s', %d, %d),", (fragment[l]).id_db, (fragment[l]).id_datacube, (fragment[l]).frag_relative_index,
-				      (fragment[l]).fragment_name, (fragment[l]).key_start, (fragment[l]).key_end);
-			if (n >= MYSQL_BUFLEN) {
-				pmesg(LOG_ERROR, __FILE__, __LINE__, "Size of query exceed query limit.\n");
-				return OPH_ODB_STR_BUFF_OVERFLOW;
+	if (mysql_query(oDB->conn, query)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "MySQL query error: %s\n", mysql_error(oDB->conn));
+		free(query);
+		return OPH_ODB_MYSQL_ERROR;
+	}
+	free(query);
+
+	MYSQL_RES *res;
+	MYSQL_ROW row;
+	res = mysql_store_result(oDB->conn);
+
+	if (!mysql_num_rows(res)) {
+		// Cache miss
+		mysql_free_result(res);
+		return OPH_ODB_SUCCESS;
+	}
+
+	if (mysql_field_count(oDB->conn) != 2) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Not enough fields found by query\n");
+		mysql_free_result(res);
+		return OPH_ODB_TOO_MANY_ROWS;
+	}
+
+	if (!(*cached = (char **) calloc(frags->size, sizeof(char *)))) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Error allocating memory\n");
+		mysql_free_result(res);
+		return OPH_ODB_MEMORY_ERROR;
+	}
+
+	int i, id_fragment;
+	while ((row = mysql_fetch_row(res))) {
+		if (!row[0] || !row[1])
+			continue;
+		id_fragment = (int) strtol(row[0], NULL, 10);
+		for (i = 0; i < frags->size; i++)
+			if (frags->value[i].id_fragment == id_fragment) {
+				if (!(*cached)[i] && !((*cached)[i] = strdup(row[1]))) {
+					pmesg(LOG_ERROR, __FILE__, __LINE__, "Error allocating memory\n");
+					mysql_free_result(res);
+					oph_odb_stge_free_cached_fragments(*cached, frags->size);
+					*cached = NULL;
+					return OPH_ODB_MEMORY_ERROR;
+				}
+				break;
 			}
-		}
 	}
-	buffer[n - 1] = ';';
+	mysql_free_result(res);
 
-	n = snprintf(insertQuery, MYSQL_BUFLEN, MYSQL_QUERY_STGE_UPDATE_OPHIDIADB_FRAG2, buffer);
-	if (n >= MYSQL_BUFLEN) {
-		pmesg(LOG_ERROR, __FILE__, __LINE__, "Size of query exceed query limit.\n");
-		return OPH_ODB_STR_BUFF_OVERFLOW;
+	return OPH_ODB_SUCCESS;
+}
+
+int oph_odb_stge_free_cached_fragments(char **cached, int size)
+{
+	if (!cached)
+		return OPH_ODB_SUCCESS;
+
+	int i;
+	for (i = 0; i < size; i++)
+		if (cached[i])
+			free(cached[i]);
+	free(cached);
+
+	return OPH_ODB_SUCCESS;
+}
+
+int oph_odb_stge_insert_into_fragmentcache_table(ophidiadb * oDB, int id_input_datacube, int id_output_datacube, const char *key, int first_index, int last_index)
+{
+	if (!oDB || !id_input_datacube || !id_output_datacube || !key) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_ODB_NULL_PARAM;
+	}
+
+	if (oph_odb_check_connection_to_ophidiadb(oDB)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to reconnect to OphidiaDB.\n");
+		return OPH_ODB_MYSQL_ERROR;
+	}
+	//escape key
+	int n = strlen(key);
+	char *escaped_key = (char *) malloc(2 * n + 1);
+	if (!escaped_key) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Error allocating memory for escaped key\n");
+		return OPH_ODB_MEMORY_ERROR;
+	}
+	mysql_real_escape_string(oDB->conn, escaped_key, key, n);
+
+	int query_buflen = 1 + snprintf(NULL, 0, MYSQL_QUERY_STGE_UPDATE_OPHIDIADB_CACHED_FRAG, escaped_key, id_input_datacube, id_output_datacube, first_index, last_index);
+	char *insertQuery = (char *) malloc(query_buflen);
+	if (!insertQuery) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Error allocating memory for query\n");
+		free(escaped_key);
+		return OPH_ODB_MEMORY_ERROR;
 	}
+	snprintf(insertQuery, query_buflen, MYSQL_QUERY_STGE_UPDATE_OPHIDIADB_CACHED_FRAG, escaped_key, id_input_datacube, id_output_datacube, first_index, last_index);
+	free(escaped_key);
 
 	if (mysql_query(oDB->conn, insertQuery)) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "MySQL query error: %s\n", mysql_error(oDB->conn));
+		free(insertQuery);
 		return OPH_ODB_MYSQL_ERROR;
 	}
+	free(insertQuery);
 
 	return OPH_ODB_SUCCESS;
 }
 
+int oph_odb_stge_add_fragment_to_batch(oph_odb_batch * batch, oph_odb_fragment * fragment)
+{
+	if (!batch || !fragment) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_ODB_NULL_PARAM;
+	}
+
+	if (!batch->statement)
+		oph_odb_batch_init(batch, MYSQL_QUERY_STGE_UPDATE_OPHIDIADB_FRAG2);
+
+	return oph_odb_batch_add(batch, "(%d, %d, %d, '%s', %d, %d)", fragment->id_db, fragment->id_datacube, fragment->frag_relative_index, fragment->fragment_name, fragment->key_start,
+				 fragment->key_end);
+}
+
 int oph_odb_stge_retrieve_container_id_from_fragment_name(ophidiadb * oDB, char *frag_name, int *id_container)
 {
 	if (!oDB || !frag_name || !id_container) {
@@ -2112,6 +2191,8 @@ int oph_odb_stge_insert_into_dbinstance_partitioned_tables(ophidiadb * oDB, oph_
 		return OPH_ODB_MYSQL_ERROR;
 	}
 
+	oph_odb_cache_invalidate();
+
 	char insertQuery[MYSQL_BUFLEN];
 	int n = snprintf(insertQuery, MYSQL_BUFLEN, MYSQL_QUERY_STGE_UPDATE_OPHIDIADB_DB, db->id_dbms, db->db_name);
 	if (n >= MYSQL_BUFLEN) {
@@ -2170,6 +2251,111 @@ int oph_odb_stge_insert_into_dbinstance_partitioned_tables(ophidiadb * oDB, oph_
 	return OPH_ODB_SUCCESS;
 }
 
+int oph_odb_stge_insert_into_dbinstance_partitioned_tables2(ophidiadb * oDB, oph_odb_db_instance * db, int db_num, int id_datacube)
+{
+	if (!oDB || !db || (db_num <= 0)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_ODB_NULL_PARAM;
+	}
+
+	if (oph_odb_check_connection_to_ophidiadb(oDB)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to reconnect to OphidiaDB.\n");
+		return OPH_ODB_MYSQL_ERROR;
+	}
+
+	oph_odb_cache_invalidate();
+
+	int i, n, res = OPH_ODB_SUCCESS;
+	size_t bsize = db_num * (OPH_ODB_STGE_DB_NAME_SIZE + 4) + 1, qsize = bsize + strlen(MYSQL_QUERY_STGE_RETRIEVE_DB_IDS);
+	char *buffer = (char *) malloc(bsize), *selectQuery = (char *) malloc(qsize);
+	if (!buffer || !selectQuery) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Error allocating memory\n");
+		if (buffer)
+			free(buffer);
+		if (selectQuery)
+			free(selectQuery);
+		return OPH_ODB_MEMORY_ERROR;
+	}
+	for (i = n = 0; i < db_num; i++)
+		n += snprintf(buffer + n, bsize - n, "%s'%s'", i ? "," : "", db[i].db_name);
+	snprintf(selectQuery, qsize, MYSQL_QUERY_STGE_RETRIEVE_DB_IDS, buffer);
+	free(buffer);
+
+	oph_odb_batch db_batch;
+	oph_odb_batch_init(&db_batch, MYSQL_QUERY_STGE_UPDATE_OPHIDIADB_DB2);
+	for (i = 0; i < db_num; i++)
+		if ((res = oph_odb_batch_add(&db_batch, "(%d, '%s')", db[i].id_dbms, db[i].db_name)))
+			break;
+	if (res) {
+		oph_odb_batch_free(&db_batch);
+		free(selectQuery);
+		return res;
+	}
+
+	oph_odb_batch part_batch;
+	oph_odb_batch_init(&part_batch, MYSQL_QUERY_STGE_UPDATE_OPHIDIADB_PART2);
+
+	MYSQL_RES *result;
+	MYSQL_ROW row;
+	short runs = 1;
+	do {
+		if ((res = oph_odb_start_transaction(oDB)))
+			break;
+
+		if (!(res = oph_odb_batch_query(oDB, &db_batch))) {
+			//Retrieve the identifiers of the new db instances
+			if (mysql_query(oDB->conn, selectQuery)) {
+				pmesg(LOG_ERROR, __FILE__, __LINE__, "MySQL query error: %s\n", mysql_error(oDB->conn));
+				res = OPH_ODB_MYSQL_ERROR;
+			} else if (!(result = mysql_store_result(oDB->conn)) || ((int) mysql_num_rows(result) != db_num) || (mysql_field_count(oDB->conn) != 2)) {
+				pmesg(LOG_ERROR, __FILE__, __LINE__, "No/more than one row found by query\n");
+				if (result)
+					mysql_free_result(result);
+				oph_odb_end_transaction(oDB, 0);
+				res = OPH_ODB_TOO_MANY_ROWS;
+				break;
+			} else {
+				while ((row = mysql_fetch_row(result)))
+					for (i = 0; i < db_num; i++)
+						if (!strcmp(db[i].db_name, row[1])) {
+							db[i].id_db = (int) strtol(row[0], NULL, 10);
+							break;
+						}
+				mysql_free_result(result);
+
+				//If database_instance update partition table
+				if (id_datacube && !part_batch.row_number)
+					for (i = 0; i < db_num; i++)
+						if ((res = oph_odb_batch_add(&part_batch, "(%d, %d)", db[i].id_db, id_datacube)))
+							break;
+				if (!res && id_datacube)
+					res = oph_odb_batch_query(oDB, &part_batch);
+			}
+		}
+		if (!res && !(res = oph_odb_end_transaction(oDB, 1)))
+			break;
+
+		if ((res == OPH_ODB_MYSQL_ERROR) && oph_odb_is_lock_error(oDB) && (runs < OPH_ODB_MAX_ATTEMPTS)) {
+			oph_odb_end_transaction(oDB, 0);
+			//Identifiers change when the transaction is retried
+			oph_odb_batch_free(&part_batch);
+			pmesg(LOG_WARNING, __FILE__, __LINE__, "Retry the transaction\n");
+			sleep(OPH_ODB_WAITING_TIME);
+			runs++;
+			continue;
+		}
+		oph_odb_end_transaction(oDB, 0);
+		break;
+
+	} while (runs <= OPH_ODB_MAX_ATTEMPTS);	// Useless
+
+	oph_odb_batch_free(&db_batch);
+	oph_odb_batch_free(&part_batch);
+	free(selectQuery);
+
+	return res;
+}
+
 int oph_odb_stge_add_hostpartition(ophidiadb * oDB, const char *name, int id_user, char reserved, int hosts, int *id_hostpartition)
 {
 	if (!oDB || !name || !id_user || !id_hostpartition) {
@@ -25,21 +25,56 @@
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
+#include <stdarg.h>
 
 #include <unistd.h>
 #include <ctype.h>
 #include <mysql.h>
+#include <pthread.h>
 #include "debug.h"
 
 extern int msglevel;
 
-int oph_odb_read_ophidiadb_config_file(ophidiadb * oDB)
+/**
+ * \brief Idle connection to OphidiaDB
+ * \param oDB Parameters used to open the connection
+ * \param next Next idle connection
+ */
+typedef struct _oph_odb_pool_entry {
+	ophidiadb oDB;
+	struct _oph_odb_pool_entry *next;
+} oph_odb_pool_entry;
+
+static pthread_mutex_t oph_odb_pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static oph_odb_pool_entry *oph_odb_pool_idle = NULL;
+static unsigned int oph_odb_pool_idle_number = 0;
+static ophidiadb oph_odb_config_cache = { NULL, NULL, 0, NULL, NULL, NULL };
+static char oph_odb_config_cached = 0;
+
+//Compare two optional strings
+static int _oph_odb_strcmp(const char *a, const char *b)
 {
-	if (!oDB) {
-		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
-		return OPH_ODB_NULL_PARAM;
+	return strcmp(a ? a : "", b ? b : "");
+}
+
+//Copy parameters cached from configuration file; call it with oph_odb_pool_lock held
+static int _oph_odb_copy_config(ophidiadb * oDB)
+{
+	oDB->name = oph_odb_config_cache.name ? strdup(oph_odb_config_cache.name) : NULL;
+	oDB->hostname = oph_odb_config_cache.hostname ? strdup(oph_odb_config_cache.hostname) : NULL;
+	oDB->server_port = oph_odb_config_cache.server_port;
+	oDB->username = oph_odb_config_cache.username ? strdup(oph_odb_config_cache.username) : NULL;
+	oDB->pwd = oph_odb_config_cache.pwd ? strdup(oph_odb_config_cache.pwd) : NULL;
+	if ((oph_odb_config_cache.name && !oDB->name) || (oph_odb_config_cache.hostname && !oDB->hostname) || (oph_odb_config_cache.username && !oDB->username)
+	    || (oph_odb_config_cache.pwd && !oDB->pwd)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to alloc memory for configuration argument\n");
+		return OPH_ODB_MEMORY_ERROR;
 	}
+	return OPH_ODB_SUCCESS;
+}
 
+int _oph_odb_read_ophidiadb_config_file(ophidiadb * oDB)
+{
 	char config[OPH_ODB_PATH_LEN];
 	snprintf(config, sizeof(config), OPH_ODB_DBMS_CONFIGURATION, OPH_ANALYTICS_LOCATION);
 	FILE *file = fopen(config, "r");
@@ -136,6 +171,30 @@ int oph_odb_read_ophidiadb_config_file(ophidiadb * oDB)
 	return OPH_ODB_SUCCESS;
 }
 
+int oph_odb_read_ophidiadb_config_file(ophidiadb * oDB)
+{
+	if (!oDB) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_ODB_NULL_PARAM;
+	}
+
+	int res = OPH_ODB_SUCCESS;
+
+	//The configuration file is parsed only once by each process
+	pthread_mutex_lock(&oph_odb_pool_lock);
+	if (!oph_odb_config_cached) {
+		if ((res = _oph_odb_read_ophidiadb_config_file(&oph_odb_config_cache)))
+			oph_odb_free_ophidiadb_thread(&oph_odb_config_cache);
+		else
+			oph_odb_config_cached = 1;
+	}
+	if (!res)
+		res = _oph_odb_copy_config(oDB);
+	pthread_mutex_unlock(&oph_odb_pool_lock);
+
+	return res;
+}
+
 int oph_odb_init_ophidiadb(ophidiadb * oDB)
 {
 	/*if (mysql_library_init(0, NULL, NULL)) {
@@ -176,6 +235,10 @@ int oph_odb_free_ophidiadb_thread(ophidiadb * oDB)
 		return OPH_ODB_NULL_PARAM;
 	}
 
+	if (oDB->conn) {
+		oph_odb_disconnect_from_ophidiadb(oDB);
+		oDB->conn = NULL;
+	}
 	if (oDB->name) {
 		free(oDB->name);
 		oDB->name = NULL;
@@ -192,10 +255,6 @@ int oph_odb_free_ophidiadb_thread(ophidiadb * oDB)
 		free(oDB->pwd);
 		oDB->pwd = NULL;
 	}
-	if (oDB->conn) {
-		oph_odb_disconnect_from_ophidiadb(oDB);
-		oDB->conn = NULL;
-	}
 
 	return OPH_ODB_SUCCESS;
 }
@@ -208,16 +267,44 @@ int oph_odb_connect_to_ophidiadb(ophidiadb * oDB)
 	}
 
 	oDB->conn = NULL;
+
+	//Reuse an idle connection opened with the same parameters
+	oph_odb_pool_entry *entry, *prev = NULL;
+	pthread_mutex_lock(&oph_odb_pool_lock);
+	for (entry = oph_odb_pool_idle; entry; prev = entry, entry = entry->next)
+		if ((entry->oDB.server_port == oDB->server_port) && !_oph_odb_strcmp(entry->oDB.hostname, oDB->hostname) && !_oph_odb_strcmp(entry->oDB.username, oDB->username)
+		    && !_oph_odb_strcmp(entry->oDB.pwd, oDB->pwd) && !_oph_odb_strcmp(entry->oDB.name, oDB->name))
+			break;
+	if (entry) {
+		if (prev)
+			prev->next = entry->next;
+		else
+			oph_odb_pool_idle = entry->next;
+		oph_odb_pool_idle_number--;
+	}
+	pthread_mutex_unlock(&oph_odb_pool_lock);
+
+	if (entry) {
+		oDB->conn = entry->oDB.conn;
+		entry->oDB.conn = NULL;
+		oph_odb_free_ophidiadb_thread(&(entry->oDB));
+		free(entry);
+		if (!mysql_ping(oDB->conn))
+			return OPH_ODB_SUCCESS;
+		mysql_close(oDB->conn);
+		oDB->conn = NULL;
+	}
+
 	if (!(oDB->conn = mysql_init(NULL))) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "MySQL initialization error: %s\n", mysql_error(oDB->conn));
-		oph_odb_disconnect_from_ophidiadb(oDB);
 		return OPH_ODB_MYSQL_ERROR;
 	}
 
 	/* Connect to database */
 	if (!mysql_real_connect(oDB->conn, oDB->hostname, oDB->username, oDB->pwd, oDB->name, oDB->server_port, NULL, 0)) {
 		pmesg(LOG_ERROR, __FILE__, __LINE__, "MySQL connection error: %s\n", mysql_error(oDB->conn));
-		oph_odb_disconnect_from_ophidiadb(oDB);
+		mysql_close(oDB->conn);
+		oDB->conn = NULL;
 		return OPH_ODB_MYSQL_ERROR;
 	}
 	return OPH_ODB_SUCCESS;
@@ -255,10 +342,54 @@ int oph_odb_disconnect_from_ophidiadb(ophidiadb * oDB)
 		return OPH_ODB_NULL_PARAM;
 	}
 
-	if (oDB->conn) {
+	if (!oDB->conn)
+		return OPH_ODB_SUCCESS;
+
+	//Park the connection, so that it can be reused by next connections
+	oph_odb_pool_entry *entry = NULL;
+	pthread_mutex_lock(&oph_odb_pool_lock);
+	if ((oph_odb_pool_idle_number < OPH_ODB_POOL_MAX_IDLE) && (entry = (oph_odb_pool_entry *) calloc(1, sizeof(oph_odb_pool_entry)))) {
+		entry->oDB.name = oDB->name ? strdup(oDB->name) : NULL;
+		entry->oDB.hostname = oDB->hostname ? strdup(oDB->hostname) : NULL;
+		entry->oDB.server_port = oDB->server_port;
+		entry->oDB.username = oDB->username ? strdup(oDB->username) : NULL;
+		entry->oDB.pwd = oDB->pwd ? strdup(oDB->pwd) : NULL;
+		if ((oDB->name && !entry->oDB.name) || (oDB->hostname && !entry->oDB.hostname) || (oDB->username && !entry->oDB.username) || (oDB->pwd && !entry->oDB.pwd)) {
+			oph_odb_free_ophidiadb_thread(&(entry->oDB));
+			free(entry);
+			entry = NULL;
+		} else {
+			entry->oDB.conn = oDB->conn;
+			entry->next = oph_odb_pool_idle;
+			oph_odb_pool_idle = entry;
+			oph_odb_pool_idle_number++;
+		}
+	}
+	pthread_mutex_unlock(&oph_odb_pool_lock);
+
+	if (!entry)
 		mysql_close(oDB->conn);
-		oDB->conn = NULL;
+	oDB->conn = NULL;
+
+	return OPH_ODB_SUCCESS;
+}
+
+int oph_odb_pool_clear()
+{
+	oph_odb_pool_entry *entry;
+
+	pthread_mutex_lock(&oph_odb_pool_lock);
+	while ((entry = oph_odb_pool_idle)) {
+		oph_odb_pool_idle = entry->next;
+		if (entry->oDB.conn) {
+			mysql_close(entry->oDB.conn);
+			entry->oDB.conn = NULL;
+		}
+		oph_odb_free_ophidiadb_thread(&(entry->oDB));
+		free(entry);
 	}
+	oph_odb_pool_idle_number = 0;
+	pthread_mutex_unlock(&oph_odb_pool_lock);
 
 	return OPH_ODB_SUCCESS;
 }
@@ -291,3 +422,208 @@ int oph_odb_query_ophidiadb(ophidiadb * oDB, char *query)
 
 	return OPH_ODB_SUCCESS;
 }
+
+int oph_odb_batch_init(oph_odb_batch * batch, const char *statement)
+{
+	if (!batch || !statement) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_ODB_NULL_PARAM;
+	}
+
+	memset(batch, 0, sizeof(oph_odb_batch));
+	batch->statement = statement;
+
+	return OPH_ODB_SUCCESS;
+}
+
+//Move the rows collected so far into a new statement
+int _oph_odb_batch_close(oph_odb_batch * batch)
+{
+	if (!batch->length)
+		return OPH_ODB_SUCCESS;
+
+	char **queries = (char **) realloc(batch->queries, (batch->query_number + 1) * sizeof(char *));
+	if (!queries) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Error allocating memory\n");
+		return OPH_ODB_MEMORY_ERROR;
+	}
+	batch->queries = queries;
+
+	size_t size = strlen(batch->statement) + batch->length + 1;
+	if (!(queries[batch->query_number] = (char *) malloc(size))) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Error allocating memory\n");
+		return OPH_ODB_MEMORY_ERROR;
+	}
+	snprintf(queries[batch->query_number], size, batch->statement, batch->rows);
+	batch->query_number++;
+	batch->length = 0;
+
+	return OPH_ODB_SUCCESS;
+}
+
+int oph_odb_batch_add(oph_odb_batch * batch, const char *format, ...)
+{
+	if (!batch || !batch->statement || !format) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_ODB_NULL_PARAM;
+	}
+
+	va_list ap;
+	char row[MYSQL_BUFLEN];
+	va_start(ap, format);
+	int n = vsnprintf(row, MYSQL_BUFLEN, format, ap);
+	va_end(ap);
+	if ((n < 0) || (n >= MYSQL_BUFLEN)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Size of query exceed query limit.\n");
+		return OPH_ODB_STR_BUFF_OVERFLOW;
+	}
+
+	if (batch->length && (strlen(batch->statement) + batch->length + n + 1 > OPH_ODB_BATCH_MAX_SIZE) && _oph_odb_batch_close(batch))
+		return OPH_ODB_MEMORY_ERROR;
+
+	if (batch->length + n + 2 > batch->capacity) {
+		size_t capacity = batch->capacity ? 2 * batch->capacity : OPH_ODB_BATCH_MIN_SIZE;
+		while (capacity < batch->length + n + 2)
+			capacity *= 2;
+		char *rows = (char *) realloc(batch->rows, capacity);
+		if (!rows) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "Error allocating memory\n");
+			return OPH_ODB_MEMORY_ERROR;
+		}
+		batch->rows = rows;
+		batch->capacity = capacity;
+	}
+	if (batch->length)
+		batch->rows[batch->length++] = ',';
+	memcpy(batch->rows + batch->length, row, n + 1);
+	batch->length += n;
+	batch->row_number++;
+
+	return OPH_ODB_SUCCESS;
+}
+
+int oph_odb_batch_query(ophidiadb * oDB, oph_odb_batch * batch)
+{
+	if (!oDB || !batch) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_ODB_NULL_PARAM;
+	}
+
+	if (_oph_odb_batch_close(batch))
+		return OPH_ODB_MEMORY_ERROR;
+
+	int i;
+	for (i = 0; i < batch->query_number; i++)
+		if (mysql_query(oDB->conn, batch->queries[i])) {
+			pmesg(LOG_ERROR, __FILE__, __LINE__, "MySQL query error: %s\n", mysql_error(oDB->conn));
+			return OPH_ODB_MYSQL_ERROR;
+		}
+
+	return OPH_ODB_SUCCESS;
+}
+
+int oph_odb_batch_execute(ophidiadb * oDB, oph_odb_batch * batch)
+{
+	if (!oDB || !batch) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_ODB_NULL_PARAM;
+	}
+
+	if (!batch->row_number)
+		return OPH_ODB_SUCCESS;
+
+	if (oph_odb_check_connection_to_ophidiadb(oDB)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Unable to reconnect to OphidiaDB.\n");
+		return OPH_ODB_MYSQL_ERROR;
+	}
+
+	short runs = 1;
+	int res = OPH_ODB_SUCCESS;
+	do {
+		if (oph_odb_start_transaction(oDB))
+			return OPH_ODB_MYSQL_ERROR;
+		if (!(res = oph_odb_batch_query(oDB, batch)))
+			res = oph_odb_end_transaction(oDB, 1);
+		if (!res)
+			break;
+		if ((res == OPH_ODB_MYSQL_ERROR) && oph_odb_is_lock_error(oDB) && (runs < OPH_ODB_MAX_ATTEMPTS)) {
+			oph_odb_end_transaction(oDB, 0);
+			pmesg(LOG_WARNING, __FILE__, __LINE__, "Retry the transaction\n");
+			sleep(OPH_ODB_WAITING_TIME);
+			runs++;
+			continue;
+		}
+		oph_odb_end_transaction(oDB, 0);
+		return res;
+
+	} while (runs <= OPH_ODB_MAX_ATTEMPTS);	// Useless
+
+	pmesg(LOG_DEBUG, __FILE__, __LINE__, "%d rows inserted with %d statements\n", batch->row_number, batch->query_number);
+
+	return OPH_ODB_SUCCESS;
+}
+
+int oph_odb_batch_free(oph_odb_batch * batch)
+{
+	if (!batch) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_ODB_NULL_PARAM;
+	}
+
+	int i;
+	for (i = 0; i < batch->query_number; i++)
+		free(batch->queries[i]);
+	if (batch->queries)
+		free(batch->queries);
+	if (batch->rows)
+		free(batch->rows);
+	oph_odb_batch_init(batch, batch->statement ? batch->statement : "");
+
+	return OPH_ODB_SUCCESS;
+}
+
+int oph_odb_start_transaction(ophidiadb * oDB)
+{
+	if (!oDB || !oDB->conn) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_ODB_NULL_PARAM;
+	}
+
+	if (mysql_autocommit(oDB->conn, 0)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "MySQL query error: %s\n", mysql_error(oDB->conn));
+		return OPH_ODB_MYSQL_ERROR;
+	}
+
+	return OPH_ODB_SUCCESS;
+}
+
+int oph_odb_end_transaction(ophidiadb * oDB, int commit)
+{
+	if (!oDB || !oDB->conn) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "Null input parameter\n");
+		return OPH_ODB_NULL_PARAM;
+	}
+
+	int res = OPH_ODB_SUCCESS;
+	if (commit ? mysql_commit(oDB->conn) : mysql_rollback(oDB->conn)) {
+		pmesg(commit ? LOG_ERROR : LOG_WARNING, __FILE__, __LINE__, "MySQL query error: %s\n", mysql_error(oDB->conn));
+		res = OPH_ODB_MYSQL_ERROR;
+	}
+	//The connection could be reused by other tasks, so that autocommit has to be restored anyway
+	if (mysql_autocommit(oDB->conn, 1)) {
+		pmesg(LOG_ERROR, __FILE__, __LINE__, "MySQL query error: %s\n", mysql_error(oDB->conn));
+		res = OPH_ODB_MYSQL_ERROR;
+	}
+
+	return res;
+}
+
+int oph_odb_is_lock_error(ophidiadb * oDB)
+{
+	if (!oDB || !oDB->conn)
+		return 0;
+
+	int mysql_code = mysql_errno(oDB->conn);
+
+	return (mysql_code == OPH_ODB_LOCK_ERROR) || (mysql_code == OPH_ODB_LOCK_WAIT_ERROR);
+}